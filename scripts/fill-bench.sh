@@ -0,0 +1,62 @@
+#!/bin/sh
+
+# Compare the interaction matrix fill time of two xnec2c builds.
+#
+# Each deck is swept in batch mode, in process (-j 0), under --profile-json,
+# and the "fill" stage is read back from the profile.  The best of <runs>
+# sweeps is kept for each build, as the min_ms of a sweep is already the
+# fastest of its steps.  Batch mode opens a window, so run this where a
+# display is available, e.g. under xvfb-run.
+
+usage()
+{
+	echo "usage: $0 [-n runs] <xnec2c> <baseline xnec2c> [deck...]"
+	echo "  decks default to examples/*.nec"
+	exit 1
+}
+
+runs=3
+if [ "$1" = "-n" ]; then
+	[ -n "$2" ] || usage
+	runs=$2
+	shift 2
+fi
+
+[ $# -ge 2 ] || usage
+new=$1
+old=$2
+shift 2
+
+[ $# -gt 0 ] || set -- examples/*.nec
+
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+# Best fill min_ms of <runs> sweeps of deck $2 by build $1, or "-"
+fill_ms()
+{
+	best=-
+	i=0
+	while [ $i -lt "$runs" ]; do
+		rm -f "$tmp/profile.json"
+		"$1" --batch -j 0 --profile-json "$tmp/profile.json" "$2" \
+			>/dev/null 2>&1
+		ms=$(sed -n 's/.*"fill": { "count": [1-9][0-9]*, "min_ms": \([0-9.]*\),.*/\1/p' \
+			"$tmp/profile.json" 2>/dev/null)
+		if [ -n "$ms" ]; then
+			best=$(echo "$best $ms" | awk '{ print ($1 == "-" || $2 < $1) ? $2 : $1 }')
+		fi
+		i=$((i + 1))
+	done
+	echo "$best"
+}
+
+printf "%-40s %12s %12s %8s\n" "deck" "baseline ms" "new ms" "speedup"
+for deck in "$@"; do
+	b=$(fill_ms "$old" "$deck")
+	n=$(fill_ms "$new" "$deck")
+	echo "$(basename "$deck") $b $n" | awk '{
+		s = ($2 != "-" && $3 != "-" && $3 > 0) ? sprintf("%.3f", $2 / $3) : "-"
+		printf "%-40s %12s %12s %8s\n", $1, $2, $3, s
+	}'
+done
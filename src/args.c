@@ -19,6 +19,7 @@
 
 #include "args.h"
 #include "mathlib.h"
+#include "optimizers/opt_journal.h"
 #include "rc_config.h"
 #include "validation_dump.h"
 
@@ -79,12 +80,26 @@ enum XNEC2C_OPTS {
 	OPT_WRITE_CURRENTS,
 	OPT_WRITE_GNUPLOT_STRUCTURE,
 	OPT_WRITE_PATCH_CURRENTS,
+	OPT_WRITE_RDPAT_NPY,
+	OPT_WRITE_CURRENTS_NPY,
 	OPT_SKIP_VERIFY,
 	OPT_FORCE_VERIFY,
+	OPT_MODEL_CACHE,
+	OPT_SWEEP_ARCHIVE,
+	OPT_LU_UPDATE,
+	OPT_NETWORK,
+	OPT_NETWORK_DEEMBED,
 	OPT_MEM_REPORT,
+	OPT_MEM_SAMPLE,
+	OPT_PROFILE,
+	OPT_PROFILE_JSON,
+	OPT_OPT_JOURNAL,
+	OPT_STUDY,
 	OPT_WRITE_VALIDATION_DIR,
+	OPT_VALIDATION_REFERENCE,
 	OPT_WRITE_RDPAT_PNG,
 	OPT_RDPAT_PNG_FORMAT,
+	OPT_WRITE_SENSITIVITY,
 	OPT_FREQ_SELECT,
 
 	OPT_MAX_OPTS
@@ -99,13 +114,16 @@ static void apply_config_file(const usage_entry_t *entry, char *arg);
 static void apply_flag(const usage_entry_t *entry, char *arg);
 static void apply_threads(const usage_entry_t *entry, char *arg);
 static void apply_jobs(const usage_entry_t *entry, char *arg);
+static void apply_mem_sample(const usage_entry_t *entry, char *arg);
 static void apply_verbose(const usage_entry_t *entry, char *arg);
 static void apply_debug(const usage_entry_t *entry, char *arg);
 static void apply_quiet(const usage_entry_t *entry, char *arg);
 static void apply_help(const usage_entry_t *entry, char *arg);
 static void apply_version(const usage_entry_t *entry, char *arg);
 static void apply_optimize(const usage_entry_t *entry, char *arg);
+static void apply_opt_journal(const usage_entry_t *entry, char *arg);
 static void apply_validation_dir(const usage_entry_t *entry, char *arg);
+static void apply_validation_reference(const usage_entry_t *entry, char *arg);
 static void apply_rdpat_png_format(const usage_entry_t *entry, char *arg);
 static void apply_freq_select(const usage_entry_t *entry, char *arg);
 
@@ -165,20 +183,70 @@ static const usage_entry_t usage_entries[] = {
 	{ .name = "optimize",                               .id = OPT_ENABLE_OPTIMIZE,
 	  .text = N_("activate the optimizer immediately"),
 	  .apply = apply_optimize },
+	{ .name = "opt-journal",                            .id = OPT_OPT_JOURNAL,
+	  .metavar = "<journal-file>",
+	  .text = N_("print the fitness convergence of an optimizer journal as "
+	  "gnuplot data and exit"),
+	  .apply = apply_opt_journal },
+	{ .name = "study",                                  .id = OPT_STUDY,
+	  .metavar = "<study-file>",
+	  .text = N_("evaluate the SY variable grid or Latin hypercube of a study "
+	  "file in one process, write a row per point and frequency, and exit"),
+	  .target = &rc_config.filename_study,              .apply = apply_string_ref },
 	{ .name = "skip-verify",                            .id = OPT_SKIP_VERIFY,
 	  .text = N_("skip geometry verification checks"),
 	  .target = &rc_config.skip_verify_segments,        .apply = apply_flag,
 	  .notice = N_("verify segments check disabled\n") },
 	{ .name = "force-verify",                           .id = OPT_FORCE_VERIFY,
-	  .text = N_("force overlap check on large models (>1000 segments)"),
+	  .text = N_("force overlap check on large models (>1000 segments) "
+	  "and recheck unchanged geometry"),
 	  .target = &rc_config.force_verify_segments,       .apply = apply_flag,
 	  .notice = N_("forcing overlap check on large models\n") },
+	{ .name = "model-cache",                            .id = OPT_MODEL_CACHE,
+	  .text = N_("load the expanded geometry from <input-file-name>.bin when "
+	  "it matches the deck, and write it there after a full parse"),
+	  .target = &rc_config.model_cache,                 .apply = apply_flag,
+	  .notice = N_("binary model cache enabled\n") },
+	{ .name = "sweep-archive",                          .id = OPT_SWEEP_ARCHIVE,
+	  .text = N_("keep solved frequency steps in <input-file-name>.sweep and "
+	  "reload them instead of solving them again"),
+	  .target = &rc_config.sweep_archive,               .apply = apply_flag,
+	  .notice = N_("sweep archive enabled\n") },
+	{ .name = "lu-update",                              .id = OPT_LU_UPDATE,
+	  .text = N_("re-solve a model whose segment loads alone changed by a "
+	  "low-rank update of the kept matrix factors instead of a full fill"),
+	  .target = &rc_config.lu_update,                   .apply = apply_flag,
+	  .notice = N_("low-rank LU update enabled\n") },
+	{ .name = "network",                                .id = OPT_NETWORK,
+	  .metavar = "<filename.s2p>",
+	  .text = N_("cascade a Touchstone two-port between the source and the "
+	  "feedpoint: port 1 faces the source, port 2 the feedpoint"),
+	  .target = &rc_config.filename_network,            .apply = apply_string_ref },
+	{ .name = "network-deembed",                        .id = OPT_NETWORK_DEEMBED,
+	  .text = N_("remove the --network two-port from the feedpoint instead, "
+	  "for a model that includes it"),
+	  .target = &rc_config.network_deembed,             .apply = apply_flag,
+	  .notice = N_("network de-embedding enabled\n") },
 	{ .name = "mem-report",                             .id = OPT_MEM_REPORT,
 	  .text = N_("report managed allocator live bytes per call site"),
 	  .target = &rc_config.mem_report_enabled,          .apply = apply_flag,
 	  .notice = N_("managed allocator leak report enabled\n"),
 	  // Match the floor to the pr_info level used by mem_report().
 	  .min_verbose = PR_INFO },
+	{ .name = "mem-sample",                             .id = OPT_MEM_SAMPLE,
+	  .metavar = "<N>",
+	  .text = N_("track one managed allocation in N and report the sampled "
+	  "live set at exit"),
+	  .target = &rc_config.mem_sample_period,           .apply = apply_mem_sample,
+	  .min_verbose = PR_INFO },
+	{ .name = "profile",                                .id = OPT_PROFILE,
+	  .text = N_("print per-stage timings (min/mean/p95) after each sweep"),
+	  .target = &rc_config.profile_enabled,             .apply = apply_flag,
+	  .notice = N_("sweep stage profiling enabled\n") },
+	{ .name = "profile-json",                           .id = OPT_PROFILE_JSON,
+	  .metavar = "<filename>",
+	  .text = N_("write per-stage sweep timings as JSON after each sweep"),
+	  .target = &rc_config.filename_profile_json,       .apply = apply_string_ref },
 	{ 0 },
 
 	{ .text = N_("The following arguments write to an output file after the frequency "
@@ -219,10 +287,22 @@ static const usage_entry_t usage_entries[] = {
 	  .metavar = "<filename>",
 	  .text = N_("write CSV of patch surface currents"),
 	  .target = &rc_config.filename_patch_currents,     .apply = apply_string_ref },
+	{ .name = "write-rdpat-npy",                        .id = OPT_WRITE_RDPAT_NPY,
+	  .metavar = "<filename>",
+	  .text = N_("write NumPy .npy of the radiation pattern of every step"),
+	  .target = &rc_config.filename_rdpat_npy,          .apply = apply_string_ref },
+	{ .name = "write-currents-npy",                     .id = OPT_WRITE_CURRENTS_NPY,
+	  .metavar = "<filename>",
+	  .text = N_("write NumPy .npy of the currents of every step"),
+	  .target = &rc_config.filename_currents_npy,       .apply = apply_string_ref },
 	{ .name = "write-validation-dir",                   .id = OPT_WRITE_VALIDATION_DIR,
 	  .metavar = "<directory>",
 	  .text = N_("write full validation data tree"),
 	  .apply = apply_validation_dir },
+	{ .name = "validation-reference",                   .id = OPT_VALIDATION_REFERENCE,
+	  .metavar = "<directory>",
+	  .text = N_("write only the validation files that differ from this tree"),
+	  .apply = apply_validation_reference },
 	{ .name = "write-rdpat-png",                        .id = OPT_WRITE_RDPAT_PNG,
 	  .metavar = "<filename>",
 	  .text = N_("write PNG of the radiation pattern"),
@@ -232,6 +312,11 @@ static const usage_entry_t usage_entries[] = {
 	  .text = N_("x, y, z, iso, or quad views"),
 	  .default_arg = "iso",
 	  .target = &rc_config.rdpat_png_formats,           .apply = apply_rdpat_png_format },
+	{ .name = "write-sensitivity",                      .id = OPT_WRITE_SENSITIVITY,
+	  .metavar = "<filename>",
+	  .text = N_("write CSV of the derivatives of each measurement with respect "
+	  "to the SY variables flagged for optimization (requires --batch)"),
+	  .target = &rc_config.filename_sensitivity,        .apply = apply_string_ref },
 	{ 0 },
 
 	{ .name = "freq-select",                            .id = OPT_FREQ_SELECT,
@@ -918,6 +1003,24 @@ static void apply_jobs(const usage_entry_t *entry, char *arg)
 		pr_notice("Forking disabled!\n");
 }
 
+/**
+ * apply_mem_sample() - Select the sampling tier of allocator tracking
+ * @entry: option row naming the sample period
+ * @arg: requested period, one tracked allocation per this many
+ *
+ * --mem-report takes precedence: it tracks every allocation.
+ */
+static void apply_mem_sample(const usage_entry_t *entry, char *arg)
+{
+	*(int *)entry->target = parse_count(entry, arg, 1);
+
+#ifdef MEM_TRACK_DISABLE
+	pr_notice("allocator tracking compiled out, --%s ignored\n", entry->name);
+#else
+	pr_notice("managed allocator sampling 1 in %d\n", *(int *)entry->target);
+#endif
+}
+
 /**
  * apply_verbose() - Raise the console verbosity by one level
  * @_entry: unused, the verbosity is a single well-known field
@@ -982,6 +1085,16 @@ static void apply_optimize(const usage_entry_t *_entry, char *_arg)
 	SetFlag( SUPPRESS_INTERMEDIATE_REDRAWS );
 }
 
+/**
+ * apply_opt_journal() - Print the convergence of an optimizer journal and exit
+ * @_entry: unused, the data goes to stdout
+ * @arg: journal file, such as the .optjournal beside a deck
+ */
+static void apply_opt_journal(const usage_entry_t *_entry, char *arg)
+{
+	exit( opt_journal_write_convergence(arg, stdout) == 0 ? 0 : 1 );
+}
+
 /**
  * apply_validation_dir() - Aim the validation dump tree at a directory
  * @_entry: unused, the dump directory owns its own storage
@@ -992,6 +1105,16 @@ static void apply_validation_dir(const usage_entry_t *_entry, char *arg)
 	validation_dump_set_dir(arg);
 }
 
+/**
+ * apply_validation_reference() - Compare the validation dump against a tree
+ * @_entry: unused, the dump directory owns its own storage
+ * @arg: directory of an earlier validation tree
+ */
+static void apply_validation_reference(const usage_entry_t *_entry, char *arg)
+{
+	validation_dump_set_reference(arg);
+}
+
 /**
  * apply_rdpat_png_format() - Replace the radiation-pattern PNG format list
  * @entry: option row naming the format list
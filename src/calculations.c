@@ -58,7 +58,7 @@ tbf( int i, int icap )
   segj.jsno=0;
   pp=0.0;
   ix = i-1;
-  jcox= data.segments[ix].icon1;
+  jcox= data.con[ix].icon1;
 
   if( jcox > PCHCON)
     jcox= i;
@@ -83,7 +83,7 @@ tbf( int i, int icap )
       segj.jsno++;
       jsnox = segj.jsno-1;
       segj.jco[jsnox]= jcox;
-      d= M_PI* data.segments[jcoxx].si;
+      d= M_PI* data.obs[jcoxx].si;
       sdh= sin( d);
       cdh= cos( d);
       sd=2.0* sdh* cdh;
@@ -95,7 +95,7 @@ tbf( int i, int icap )
       }
       else omc=1.0- cdh* cdh+ sdh* sdh;
 
-      aj=1.0/( log(1.0/( M_PI* data.segments[jcoxx].bi))-.577215664);
+      aj=1.0/( log(1.0/( M_PI* data.obs[jcoxx].bi))-.577215664);
       pp= pp- omc/ sd* aj;
       segj.ax[jsnox]= aj/ sd* sig;
       segj.bx[jsnox]= aj/(2.0* cdh);
@@ -104,9 +104,9 @@ tbf( int i, int icap )
       if( jcox != i)
       {
         if( jend == 1)
-          jcox= data.segments[jcoxx].icon2;
+          jcox= data.con[jcoxx].icon2;
         else
-          jcox= data.segments[jcoxx].icon1;
+          jcox= data.con[jcoxx].icon1;
 
         if( abs(jcox) != i )
         {
@@ -130,7 +130,7 @@ tbf( int i, int icap )
     pp=0.0;
     njun1= segj.jsno;
 
-    jcox= data.segments[ix].icon2;
+    jcox= data.con[ix].icon2;
     if( jcox > PCHCON)
       jcox= i;
 
@@ -144,7 +144,7 @@ tbf( int i, int icap )
   njun2= segj.jsno- njun1;
   jsnop= segj.jsno;
   segj.jco[jsnop]= i;
-  d= M_PI* data.segments[ix].si;
+  d= M_PI* data.obs[ix].si;
   sdh= sin( d);
   cdh= cos( d);
   sd=2.0* sdh* cdh;
@@ -157,7 +157,7 @@ tbf( int i, int icap )
   }
   else omc=1.0- cd;
 
-  ap=1.0/( log(1.0/( M_PI* data.segments[ix].bi))-.577215664);
+  ap=1.0/( log(1.0/( M_PI* data.obs[ix].bi))-.577215664);
   aj= ap;
 
   if( njun1 == 0)
@@ -170,7 +170,7 @@ tbf( int i, int icap )
         xxi=0.0;
       else
       {
-        qp= M_PI* data.segments[ix].bi;
+        qp= M_PI* data.obs[ix].bi;
         xxi= qp* qp;
         xxi= qp*(1.0-.5* xxi)/(1.0- xxi);
       }
@@ -185,7 +185,7 @@ tbf( int i, int icap )
     if( icap == 0) xxi=0.0;
     else
     {
-      qp= M_PI* data.segments[ix].bi;
+      qp= M_PI* data.obs[ix].bi;
       xxi= qp* qp;
       xxi= qp*(1.0-.5* xxi)/(1.0- xxi);
     }
@@ -214,7 +214,7 @@ tbf( int i, int icap )
       xxi=0.0;
     else
     {
-      qm= M_PI* data.segments[ix].bi;
+      qm= M_PI* data.obs[ix].bi;
       xxi= qm* qm;
       xxi= qm*(1.0-.5* xxi)/(1.0- xxi);
     }
@@ -274,12 +274,12 @@ void qdsrc( int is, complex double v, complex double *e )
   complex double curd, etk, ets, etc;
 
   is--;
-  i= data.segments[is].icon1;
-  data.segments[is].icon1=0;
+  i= data.con[is].icon1;
+  data.con[is].icon1=0;
   tbf( is+1,0);
-  data.segments[is].icon1 = i;
-  dataj.s= data.segments[is].si*.5;
-  curd= CCJ * v/(( log(2.0 * dataj.s/ data.segments[is].bi)-1.0) *
+  data.con[is].icon1 = i;
+  dataj.s= data.obs[is].si*.5;
+  curd= CCJ * v/(( log(2.0 * dataj.s/ data.obs[is].bi)-1.0) *
                  ( segj.bx[segj.jsno-1] * cos( M_2PI* dataj.s) +
                   segj.cx[segj.jsno-1] * sin( M_2PI* dataj.s))* data.wlam);
   vsorc.vqds[vsorc.nqds]= v;
@@ -290,32 +290,32 @@ void qdsrc( int is, complex double v, complex double *e )
   {
     j= segj.jco[jx]-1;
     jp1 = j+1;
-    dataj.s= data.segments[j].si;
-    dataj.b= data.segments[j].bi;
-    dataj.xj= data.segments[j].x;
-    dataj.yj= data.segments[j].y;
-    dataj.zj= data.segments[j].z;
-    dataj.cabj= data.segments[j].cab;
-    dataj.sabj= data.segments[j].sab;
-    dataj.salpj= data.segments[j].salp;
+    dataj.s= data.obs[j].si;
+    dataj.b= data.obs[j].bi;
+    dataj.xj= data.obs[j].x;
+    dataj.yj= data.obs[j].y;
+    dataj.zj= data.obs[j].z;
+    dataj.cabj= data.obs[j].cab;
+    dataj.sabj= data.obs[j].sab;
+    dataj.salpj= data.obs[j].salp;
 
     if( dataj.iexk != 0)
     {
-      ipr= data.segments[j].icon1;
+      ipr= data.con[j].icon1;
 
       if (ipr > PCHCON) dataj.ind1=2;
       else if( ipr < 0 )
       {
         ipr= -ipr;
         ipr--;
-        if( -data.segments[ipr - 1].icon1 != jp1 )
+        if( -data.con[ipr - 1].icon1 != jp1 )
           dataj.ind1=2;
         else
         {
-          xi= fabs( dataj.cabj* data.segments[ipr].cab + dataj.sabj*
-                   data.segments[ipr].sab + dataj.salpj* data.segments[ipr].salp);
+          xi= fabs( dataj.cabj* data.obs[ipr].cab + dataj.sabj*
+                   data.obs[ipr].sab + dataj.salpj* data.obs[ipr].salp);
           if( (xi < 0.999999) ||
-              (fabs(data.segments[ipr].bi/dataj.b-1.0) > 1.0e-6) )
+              (fabs(data.obs[ipr].bi/dataj.b-1.0) > 1.0e-6) )
             dataj.ind1=2;
           else
             dataj.ind1=0;
@@ -328,14 +328,14 @@ void qdsrc( int is, complex double v, complex double *e )
         ipr--;
         if( ipr != j )
         {
-          if(data.segments[ipr].icon2 != jp1)
+          if(data.con[ipr].icon2 != jp1)
             dataj.ind1=2;
           else
           {
-            xi= fabs( dataj.cabj* data.segments[ipr].cab + dataj.sabj*
-                     data.segments[ipr].sab + dataj.salpj* data.segments[ipr].salp);
+            xi= fabs( dataj.cabj* data.obs[ipr].cab + dataj.sabj*
+                     data.obs[ipr].sab + dataj.salpj* data.obs[ipr].salp);
             if( (xi < 0.999999) ||
-                (fabs(data.segments[ipr].bi/dataj.b-1.0) > 1.0e-6) )
+                (fabs(data.obs[ipr].bi/dataj.b-1.0) > 1.0e-6) )
               dataj.ind1=2;
             else
               dataj.ind1=0;
@@ -350,20 +350,20 @@ void qdsrc( int is, complex double v, complex double *e )
         }
       } /* else */
 
-      ipr= data.segments[j].icon2;
+      ipr= data.con[j].icon2;
       if (ipr > PCHCON) dataj.ind2=2;
       else if( ipr < 0 )
       {
         ipr = -ipr;
         ipr--;
-        if( -data.segments[ipr].icon2 != jp1 )
+        if( -data.con[ipr].icon2 != jp1 )
           dataj.ind1=2;
         else
         {
-          xi= fabs( dataj.cabj* data.segments[ipr].cab + dataj.sabj *
-                   data.segments[ipr].sab + dataj.salpj* data.segments[ipr].salp);
+          xi= fabs( dataj.cabj* data.obs[ipr].cab + dataj.sabj *
+                   data.obs[ipr].sab + dataj.salpj* data.obs[ipr].salp);
           if( (xi < 0.999999) ||
-              (fabs(data.segments[ipr].bi/dataj.b-1.0) > 1.0e-6) )
+              (fabs(data.obs[ipr].bi/dataj.b-1.0) > 1.0e-6) )
             dataj.ind1=2;
           else
             dataj.ind1=0;
@@ -376,14 +376,14 @@ void qdsrc( int is, complex double v, complex double *e )
         ipr--;
         if( ipr != j )
         {
-          if(data.segments[ipr].icon1 != jp1)
+          if(data.con[ipr].icon1 != jp1)
             dataj.ind2=2;
           else
           {
-            xi= fabs( dataj.cabj* data.segments[ipr].cab + dataj.sabj*
-                     data.segments[ipr].sab + dataj.salpj* data.segments[ipr].salp);
+            xi= fabs( dataj.cabj* data.obs[ipr].cab + dataj.sabj*
+                     data.obs[ipr].sab + dataj.salpj* data.obs[ipr].salp);
             if( (xi < 0.9999990) ||
-                (fabs(data.segments[ipr].bi/dataj.b-1.0) > 1.0e-6) )
+                (fabs(data.obs[ipr].bi/dataj.b-1.0) > 1.0e-6) )
               dataj.ind2=2;
             else
               dataj.ind2=0;
@@ -402,15 +402,17 @@ void qdsrc( int is, complex double v, complex double *e )
 
     for( i = 0; i < data.n; i++ )
     {
+      const wire_obs_t *ob = &data.obs[i];
+
       ij= i- j;
-      xi= data.segments[i].x;
-      yi= data.segments[i].y;
-      zi= data.segments[i].z;
-      ai= data.segments[i].bi;
+      xi= ob->x;
+      yi= ob->y;
+      zi= ob->z;
+      ai= ob->bi;
       efld( xi, yi, zi, ai, ij);
-      cabi= data.segments[i].cab;
-      sabi= data.segments[i].sab;
-      salpi= data.segments[i].salp;
+      cabi= ob->cab;
+      sabi= ob->sab;
+      salpi= ob->salp;
       etk= dataj.exk* cabi+ dataj.eyk* sabi+ dataj.ezk* salpi;
       ets= dataj.exs* cabi+ dataj.eys* sabi+ dataj.ezs* salpi;
       etc= dataj.exc* cabi+ dataj.eyc* sabi+ dataj.ezc* salpi;
@@ -505,12 +507,12 @@ void cabc( complex double *curx)
       for( is = 0; is < vsorc.nqds; is++ )
       {
         i= vsorc.iqds[is]-1;
-        jx= data.segments[i].icon1;
-        data.segments[i].icon1=0;
+        jx= data.con[i].icon1;
+        data.con[i].icon1=0;
         tbf(i+1,0);
-        data.segments[i].icon1 = jx;
-        sh= data.segments[i].si*.5;
-        curd= CCJ* vsorc.vqds[is]/( (log(2.0* sh/ data.segments[i].bi)-1.0) *
+        data.con[i].icon1 = jx;
+        sh= data.obs[i].si*.5;
+        curd= CCJ* vsorc.vqds[is]/( (log(2.0* sh/ data.obs[i].bi)-1.0) *
                                    (segj.bx[segj.jsno-1]* cos(M_2PI* sh)+ segj.cx[segj.jsno-1] *
                                     sin(M_2PI* sh))* data.wlam );
         ar= creal( curd);
@@ -1013,7 +1015,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
   pp=0.0;
   ix=i-1;
 
-  jcox= data.segments[ix].icon1;
+  jcox= data.con[ix].icon1;
   if( jcox > PCHCON)
     jcox= i;
 
@@ -1035,7 +1037,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
 
       jcoxx = jcox-1;
       jsno++;
-      d= M_PI* data.segments[jcoxx].si;
+      d= M_PI* data.obs[jcoxx].si;
       sdh= sin( d);
       cdh= cos( d);
       sd=2.0* sdh* cdh;
@@ -1047,7 +1049,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
       }
       else omc=1.0- cdh* cdh+ sdh* sdh;
 
-      aj=1.0/( log(1.0/( M_PI* data.segments[jcoxx].bi))-.577215664);
+      aj=1.0/( log(1.0/( M_PI* data.obs[jcoxx].bi))-.577215664);
       pp -= omc/ sd* aj;
 
       if( jcox == is)
@@ -1061,9 +1063,9 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
       if( jcox != i )
       {
         if( jend != 1)
-          jcox= data.segments[jcoxx].icon1;
+          jcox= data.con[jcoxx].icon1;
         else
-          jcox= data.segments[jcoxx].icon2;
+          jcox= data.con[jcoxx].icon2;
 
         if( abs(jcox) != i )
         {
@@ -1087,7 +1089,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
     pp=0.0;
     njun1= jsno;
 
-    jcox= data.segments[ix].icon2;
+    jcox= data.con[ix].icon2;
     if( jcox > PCHCON)
       jcox= i;
 
@@ -1099,7 +1101,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
   while( jcox != 0 );
 
   njun2= jsno- njun1;
-  d= M_PI* data.segments[ix].si;
+  d= M_PI* data.obs[ix].si;
   sdh= sin( d);
   cdh= cos( d);
   sd=2.0* sdh* cdh;
@@ -1112,7 +1114,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
   }
   else omc=1.0- cd;
 
-  ap=1.0/( log(1.0/( M_PI* data.segments[ix].bi)) -.577215664);
+  ap=1.0/( log(1.0/( M_PI* data.obs[ix].bi)) -.577215664);
   aj= ap;
 
   if( njun1 == 0)
@@ -1120,14 +1122,14 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
     if( njun2 == 0)
     {
       *aa =-1.0;
-      qp= M_PI* data.segments[ix].bi;
+      qp= M_PI* data.obs[ix].bi;
       xxi= qp* qp;
       xxi= qp*(1.0-.5* xxi)/(1.0- xxi);
       *cc=1.0/( cdh- xxi* sdh);
       return;
     }
 
-    qp= M_PI* data.segments[ix].bi;
+    qp= M_PI* data.obs[ix].bi;
     xxi= qp* qp;
     xxi= qp*(1.0-.5* xxi)/(1.0- xxi);
     qp=-( omc+ xxi* sd)/( sd*( ap+ xxi* pp)+ cd*( xxi* ap- pp));
@@ -1151,7 +1153,7 @@ sbf( int i, int is, double *aa, double *bb, double *cc )
 
   if( njun2 == 0)
   {
-    qm= M_PI* data.segments[ix].bi;
+    qm= M_PI* data.obs[ix].bi;
     xxi= qm* qm;
     xxi= qm*(1.0-.5* xxi)/(1.0- xxi);
     qm=( omc+ xxi* sd)/( sd*( aj- xxi* pm)+ cd*( pm+ xxi* aj));
@@ -1214,7 +1216,7 @@ trio( int j )
 
   segj.jsno=0;
   jx = j-1;
-  jcox= data.segments[jx].icon1;
+  jcox= data.con[jx].icon1;
 
   if( jcox <= PCHCON)
   {
@@ -1224,7 +1226,7 @@ trio( int j )
 
   if( (jcox == 0) || (jcox > PCHCON) )
   {
-    jcox= data.segments[jx].icon2;
+    jcox= data.con[jx].icon2;
 
     if( jcox <= PCHCON)
     {
@@ -1281,9 +1283,9 @@ trio( int j )
       segj.jco[jsnox]= jcox;
 
       if( jend != 1)
-        jcox= data.segments[jcoxx].icon1;
+        jcox= data.con[jcoxx].icon1;
       else
-        jcox= data.segments[jcoxx].icon2;
+        jcox= data.con[jcoxx].icon2;
 
       if( jcox == 0 )
       {
@@ -1297,7 +1299,7 @@ trio( int j )
     if( iend == 1)
       break;
 
-    jcox= data.segments[jx].icon2;
+    jcox= data.con[jx].icon2;
 
     if( jcox > PCHCON)
       break;
@@ -30,6 +30,8 @@
 
 #include "sy_expr.h"
 #include "optimizers/opt_session.h"
+#include "optimizers/opt_sensitivity.h"
+#include "optimizers/opt_study.h"
 
 /*-----------------------------------------------------------------------*/
 
@@ -641,6 +643,13 @@ Nec2_Apply_Checkbutton( void )
 engine_buffers_free( void )
 {
   /* Free the per-frequency model caches owned by parent and child alike. */
+  freq_spec_cache_clear();
+  sweep_archive_close();
+
+  /* Partial optimizer files of an unfinished sweep belong to the parent */
+  if( !CHILD )
+    optimizer_stream_abort();
+
   free_rdpattern_buffers();
   Free_Nearfield_Fstep_Buffers();
   free_crnt_fstep_buffers();
@@ -659,10 +668,11 @@ engine_buffers_free( void )
   somnec_data_free();
   matrix_data_free();
   calc_scratch_free();
+  mem_arena_release();
   gnuplot_data_free();
 
-  /* Free the symbol table now that every reader has stopped. */
-  sy_cleanup();
+  /* Free the symbol table and compiled expressions now that every reader has stopped. */
+  sy_release();
 
   /* child_procs is inherited across fork(); both processes free their copy. */
   child_procs_free();
@@ -670,7 +680,7 @@ engine_buffers_free( void )
   mem_free( &orig_numeric_locale );
 
   /* Emit the report now; an empty registry makes any survivor an ownership bug. */
-  if( rc_config.mem_report_enabled )
+  if( mem_track_tier() != MEM_TRACK_OFF )
     mem_report("exit");
 
 } /* engine_buffers_free() */
@@ -689,8 +699,11 @@ parent_cleanup( void )
   /* Stop both optimizers before any structure they read is torn down:
    * opt_shutdown cancels and joins the built-in simplex/PSO worker;
    * optimizer_output_stop signals the external inotify watcher's run flag
-   * and joins it. */
+   * and joins it.  A parameter study or sensitivity run is joined the same
+   * way. */
   opt_shutdown();
+  opt_study_shutdown();
+  opt_sensitivity_shutdown();
   optimizer_output_stop();
 
   /* Join the frequency driver before the state its steps write is freed. */
@@ -28,6 +28,7 @@
 #include "structure_ui.h"
 #include "config_hooks.h"
 #include "rc_config.h"
+#include "touchstone.h"
 #include "cairo/cairo_frame.h"
 #include "cairo/cairo_fit.h"
 #include <pthread.h>
@@ -493,6 +494,47 @@ on_optimizer_output_toggled(
 }
 
 
+  void
+on_main_sweep_profile_activate(
+    GtkMenuItem     *menuitem,
+    gpointer         user_data)
+{
+  GtkWidget *dialog, *scroll, *view;
+  GtkTextBuffer *buffer;
+  gchar *text = freq_profile_text();
+
+  if( text == NULL )
+  {
+    Notice( GTK_BUTTONS_OK, _("Sweep Profile"),
+        _("No sweep has been profiled yet.") );
+    return;
+  }
+
+  /* The table is column-aligned, so show it in a fixed-width view the
+   * user can scroll and copy from; the dialog stays open beside the
+   * plots and closes itself */
+  dialog = gtk_dialog_new_with_buttons( _("Sweep Profile"),
+      GTK_WINDOW(main_window), GTK_DIALOG_DESTROY_WITH_PARENT,
+      _("_Close"), GTK_RESPONSE_CLOSE, NULL );
+  gtk_window_set_default_size( GTK_WINDOW(dialog), 640, 400 );
+  g_signal_connect( dialog, "response", G_CALLBACK(gtk_widget_destroy), NULL );
+
+  view = gtk_text_view_new();
+  gtk_text_view_set_editable( GTK_TEXT_VIEW(view), FALSE );
+  gtk_text_view_set_monospace( GTK_TEXT_VIEW(view), TRUE );
+  buffer = gtk_text_view_get_buffer( GTK_TEXT_VIEW(view) );
+  gtk_text_buffer_set_text( buffer, text, -1 );
+  g_free( text );
+
+  scroll = gtk_scrolled_window_new( NULL, NULL );
+  gtk_container_add( GTK_CONTAINER(scroll), view );
+  gtk_box_pack_start( GTK_BOX(gtk_dialog_get_content_area(GTK_DIALOG(dialog))),
+      scroll, TRUE, TRUE, 0 );
+
+  gtk_widget_show_all( dialog );
+}
+
+
   void
 on_quit_activate(
     GtkMenuItem     *menuitem,
@@ -1116,6 +1158,46 @@ on_freqplots_save_as_s2p_viewer_gain_activate(
       rc_config.working_dir );
 }
 
+/* freqplots_network_load()
+ *
+ * Makes the chosen .s2p file the active network and redraws the
+ * plots from the solved steps
+ */
+  static void
+freqplots_network_load( char *filename )
+{
+  if( !touchstone_network_load(filename) )
+  {
+    Notice( GTK_BUTTONS_OK, _("Load Network"),
+        _("Cannot read the Touchstone two-port file; see the console for the reason") );
+    return;
+  }
+
+  hook_freqplots_redraw();
+}
+
+  void
+on_freqplots_load_network_activate(
+    GtkMenuItem     *menuitem,
+    gpointer         user_data)
+{
+  /* Open file chooser to read a network */
+  mem_new(&filechooser_callback);
+  filechooser_callback->callback = freqplots_network_load;
+  filechooser_callback->extension = ".s2p";
+  file_chooser = Open_Filechooser( GTK_FILE_CHOOSER_ACTION_OPEN,
+      "*.s2p", NULL, NULL, rc_config.working_dir );
+}
+
+  void
+on_freqplots_remove_network_activate(
+    GtkMenuItem     *menuitem,
+    gpointer         user_data)
+{
+  touchstone_network_load( NULL );
+  hook_freqplots_redraw();
+}
+
   void
 on_freqplots_save_as_csv_activate(
     GtkMenuItem     *menuitem,
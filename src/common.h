@@ -50,6 +50,7 @@
 #include "branch_hints.h"
 
 #include "mem/mem.h"
+#include "mem/mem_arena.h"
 #include "i18n.h"
 #include "view/view_core.h"
 #include "render/render_canvas.h"
@@ -236,6 +237,10 @@ static inline int dl_feq_eps(double a, double b, double eps) { return fabs(a - b
 /* SY optimizer evaluation in progress — suppresses inotify reload */
 #define SY_OPTIMIZER_ACTIVE 0x0200000000000000ll
 
+/* Optimizer reparse and sweep running off the GTK thread: the parser and
+ * sweep finalize must not touch widgets or raise dialogs */
+#define HEADLESS_EVAL       0x0400000000000000ll
+
 #define ALL_FLAGS           0xFFFFFFFFFFFFFFFFll
 
 /* Type of near field data requested */
@@ -401,12 +406,29 @@ typedef struct
   /* if true, exit after the first frequency loop iteration */
   int batch_mode;
 
+  /* Parameter study spec (--study): evaluate its points, then exit */
+  char *filename_study;
+
   /* true to skip verify_segments check */
   int skip_verify_segments;
 
   /* force overlap check for large models */
   int force_verify_segments;
 
+  /* Load and write the expanded geometry as model.nec.bin (--model-cache) */
+  int model_cache;
+
+  /* Keep solved steps in model.nec.sweep and reload them (--sweep-archive) */
+  int sweep_archive;
+
+  /* Re-solve load changes by a low-rank update of kept factors (--lu-update) */
+  int lu_update;
+
+  /* Touchstone .s2p network cascaded onto the feedpoint (--network),
+   * or removed from it when network_deembed is set (--network-deembed) */
+  char *filename_network;
+  int network_deembed;
+
   /* verbose and debug levels, see console.h */
   int verbose, debug;
 
@@ -414,6 +436,19 @@ typedef struct
    * checkpoints (--mem-report); global allocator diagnostics */
   int mem_report_enabled;
 
+  /* Track one managed allocation in this many (--mem-sample) when full
+   * reporting is off; 0 leaves the allocator untracked */
+  int mem_sample_period;
+
+  /* Frequencies pre-solved around a green-line selection by idle
+   * workers; 0 disables speculation */
+  int freq_spec_steps;
+
+  /* Print per-stage sweep timings after each sweep (--profile), and
+   * write them as JSON to filename_profile_json (--profile-json) */
+  int profile_enabled;
+  char *filename_profile_json;
+
   /* true if ~/.xnec2c/xnec2c.conf does not exist, false otherwise */
   int first_run;
 
@@ -437,8 +472,11 @@ typedef struct
   char *filename_currents;
   char *filename_gnuplot_structure;
   char *filename_patch_currents;
+  char *filename_rdpat_npy;
+  char *filename_currents_npy;
   char *filename_rdpat_png;
   rdpat_png_format_spec_t *rdpat_png_formats;
+  char *filename_sensitivity;
   freq_select_mode_t freq_select_mode;   /* zero = FREQ_SELECT_NONE */
   double freq_select_mhz;                /* set iff mode == FREQ_SELECT_MHZ */
 
@@ -606,6 +644,14 @@ enum POL_TYPE
   NUM_POL
 };
 
+/* Parts of a frequency step a reduced sweep leaves out; see
+ * freq_loop_run_reduced().  A calc_data.solve_skip of 0 solves them all. */
+enum SOLVE_SKIP
+{
+  SOLVE_SKIP_RDPAT  = 1 << 0,  /* Far-field pattern, and every gain from it */
+  SOLVE_SKIP_NEAREH = 1 << 1   /* Near electric and magnetic fields */
+};
+
 /** gl_draw_batch_t - Self-contained vertex batch for a single glDrawArrays call
  * @vertices: owned vertex allocation (caller manages lifetime)
  * @vertex_count: number of vertices to draw
@@ -700,6 +746,30 @@ typedef struct
   int itag;                 /* Tag number */
 } wire_segment_t;
 
+/* Per-wire-segment observation record: the fields the O(n^2) fill and
+ * coupling loops read for each observation segment, packed into exactly one
+ * 64-byte cache line.  wire_segment_t spreads the same fields over two lines
+ * of a 136-byte stride.  Rebuilt from data.segments[] by
+ * geometry_pack_segments() at each frequency; read-only everywhere else. */
+typedef struct
+{
+  double x, y, z;          /* Segment center coordinates */
+  double bi;                /* Radius */
+  double cab, sab, salp;   /* Direction cosines */
+  double si;                /* Length */
+} wire_obs_t;
+
+_Static_assert(sizeof(wire_obs_t) == 64, "wire_obs_t must fill one cache line");
+
+/* Per-wire-segment end connectivity, packed eight to a cache line for the
+ * basis-function walks of trio(), sbf() and tbf(), which hop from segment
+ * to connected segment.  Rebuilt beside the observation records; qdsrc()
+ * and cabc() open an end here for one tbf() call and put it back. */
+typedef struct
+{
+  int icon1, icon2;         /* End connectivity */
+} wire_con_t;
+
 /* Per-surface-patch geometry and orientation */
 typedef struct
 {
@@ -770,6 +840,13 @@ typedef struct
   wire_segment_t *segments;
   surface_patch_t *patches;
 
+  /* Packed, frequency-scaled copy of the segments[] hot fields; the
+   * managed allocator aligns every entry to a cache line */
+  wire_obs_t *obs;
+
+  /* Packed copy of the segments[] connectivity */
+  wire_con_t *con;
+
 } data_t;
 
 /* common  /dataj/ */
@@ -1266,6 +1343,9 @@ typedef struct
     fmhz_save,  /* Saved value of frequency clicked on by user in plots window */
     freq_mhz;   /* Current Frequency in MHz, moved from save_t */
 
+  int
+    solve_skip; /* SOLVE_SKIP_* parts the last sweep left out of its steps */
+
   freq_loop_data_t *freq_loop_data;
 
 } calc_data_t;
@@ -1321,6 +1401,37 @@ typedef struct
 
 } near_field_t;
 
+/* Timed stages of one frequency step, in execution order.  The engine
+ * stages are measured by whichever process solves the step; XFER and
+ * PUBLISH are measured by the parent. */
+typedef enum
+{
+  FREQ_PROF_SCALE = 0,   /* Frequency_Scale_Geometry */
+  FREQ_PROF_LOAD,        /* Structure_Impedance_Loading */
+  FREQ_PROF_GROUND,      /* Ground_Parameters */
+  FREQ_PROF_FILL,        /* Interaction matrix fill */
+  FREQ_PROF_FACTOR,      /* Interaction matrix factor */
+  FREQ_PROF_EXCITE,      /* Set_Excitation */
+  FREQ_PROF_SOLVE,       /* Set_Network_Data, network and solve */
+  FREQ_PROF_POWER,       /* Power_Loss */
+  FREQ_PROF_PATTERN,     /* Radiation_Pattern */
+  FREQ_PROF_NEAR,        /* Near_Field_Pattern */
+  FREQ_PROF_PRERENDER,   /* Noise temperature and structure color fill */
+  FREQ_PROF_XFER,        /* Result transfer from the forked child */
+  FREQ_PROF_PUBLISH,     /* UI update on the GTK thread */
+  FREQ_PROF_STAGES
+} freq_prof_stage_t;
+
+/* Stage times of one step in seconds, with the solver scratch slices the
+ * arena absorbed and the managed blocks the step still took; crosses the
+ * child pipe whole */
+typedef struct
+{
+  double sec[FREQ_PROF_STAGES];
+  int    arena_allocs;
+  int    mem_blocks;
+} freq_prof_step_t;
+
 /* Child process descriptor */
 typedef struct
 {
@@ -1384,6 +1495,7 @@ void xnec2c_quit(gpointer user_data);
 gboolean xnec2c_quit_if_pending(void);
 void input_data_free(void);
 void geometry_data_free(void);
+void geometry_pack_segments(void);
 void ggrid_free(void);
 void calc_data_free(void);
 void matrix_data_free(void);
@@ -1400,6 +1512,7 @@ void Draw_Colorcode(cairo_t *cr);
 void draw_colorcode_projected(cairo_t *cr);
 void Gtk_Widget_Destroy(GtkWidget **widget);
 /* callbacks.c */
+char *get_nec_filename_stem(char *dst, char *newext, size_t maxlen);
 void on_main_window_destroy(GObject *object, gpointer user_data);
 gboolean on_main_window_delete_event(GtkWidget *widget, GdkEvent *event, gpointer user_data);
 gboolean on_main_window_key_press_event(GtkWidget *widget, GdkEventKey *event, gpointer user_data);
@@ -1409,6 +1522,7 @@ void on_main_save_activate(GtkMenuItem *menuitem, gpointer user_data);
 void on_main_save_as_activate(GtkMenuItem *menuitem, gpointer user_data);
 void on_struct_save_as_gnuplot_activate(GtkMenuItem *menuitem, gpointer user_data);
 void on_optimizer_output_toggled(GtkMenuItem *menuitem, gpointer user_data);
+void on_main_sweep_profile_activate(GtkMenuItem *menuitem, gpointer user_data);
 void on_quit_activate(GtkMenuItem *menuitem, gpointer user_data);
 void on_main_rdpattern_activate(GtkMenuItem *menuitem, gpointer user_data);
 void on_main_freqplots_activate(GtkMenuItem *menuitem, gpointer user_data);
@@ -1783,6 +1897,32 @@ void unere(double xob, double yob, double zob);
 /* fork.c */
 void Child_Process(int num_child);
 int Get_Freq_Data(int idx, int fstep);
+size_t Freq_Data_Size(void);
+int Get_Freq_Blob(int idx, char *blob);
+void Put_Freq_Blob(const char *blob, int fstep);
+void Pack_Freq_Blob(int fstep, char *blob);
+/* freq_spec.c */
+void freq_spec_reset(void);
+void freq_spec_cancel(void);
+gboolean freq_spec_cancelled(void);
+void freq_spec_cache_clear(void);
+unsigned freq_spec_cache_generation(void);
+void freq_spec_cache_store(double fmhz, unsigned generation, char **blob, size_t len);
+gboolean freq_spec_cache_restore(double fmhz, int fstep);
+int freq_spec_plan(double fmhz, double quantum, double *freqs, int max);
+
+/* freq_profile.c */
+void freq_profile_sweep_begin(void);
+void freq_profile_step_begin(void);
+void freq_profile_mark(freq_prof_stage_t stage);
+void freq_profile_lap(void);
+void freq_profile_allocs(int arena_allocs, uint64_t mem_blocks);
+freq_prof_step_t *freq_profile_step(void);
+void freq_profile_commit(double xfer_sec);
+void freq_profile_add(freq_prof_stage_t stage, double sec);
+void freq_profile_report(void);
+gchar *freq_profile_text(void);
+
 /* geom_edit.c */
 void Wire_Editor(int action);
 void Patch_Editor(int action);
@@ -1818,6 +1958,8 @@ void Save_RadPattern_CSV(char *filename);
 void Save_Struct_Gnuplot_Data(char *filename);
 void Save_Currents_CSV(char *filename);
 void Save_Patch_Currents_CSV(char *filename);
+void Save_RadPattern_NPY(char *filename);
+void Save_Currents_NPY(char *filename);
 /* ground.c */
 void rom2(double a, double b, complex double *sum, double dmin);
 void sflds(double t, complex double *e);
@@ -1825,6 +1967,7 @@ void sflds(double t, complex double *e);
 gboolean Read_Comments(void);
 gboolean Read_Geometry(void);
 gboolean Read_Commands(void);
+void Set_Input_Overrides(const char *text);
 gboolean readmn(char *mn, int *i1, int *i2, int *i3, int *i4, double *f1, double *f2, double *f3, double *f4, double *f5, double *f6);
 gboolean readgm(char *gm, int *i1, int *i2, double *x1, double *y1, double *z1, double *x2, double *y2, double *z2, double *rad);
 /* interface.c */
@@ -1863,9 +2006,15 @@ GtkWidget *create_ground2_command(GtkBuilder **builder);
 GtkWidget *create_gend_editor(GtkBuilder **builder);
 GtkWidget *create_aboutdialog(GtkBuilder **builder);
 GtkWidget *create_nec2_save_dialog(GtkBuilder **builder);
+/* lu_update.c */
+gboolean lu_update_restore(void);
+void lu_update_keep(void);
+void lu_update_apply(const complex double *a, complex double *b, int neq, int nrh);
+void lu_update_free(void);
 /* main.c */
 int main(int argc, char *argv[]);
 gboolean Open_Input_File(gpointer udata);
+gboolean Reparse_Input_Deck(const char *deck, size_t len, const char *sy_text);
 gboolean isChild(void);
 /* matrix.c */
 void cmset(int nrow, complex double *cmx, double rkhx, int iexkx);
@@ -1878,6 +2027,10 @@ void fblock(int nrow, int ncol, int imax, int ipsym);
 int solve(int n, complex double *a, int *ip, complex double *b, int ndim);
 int solve_gauss_elim( int n, complex double *a, int *ip, complex double *b, int ndim );
 void solves(complex double *a, int *ip, complex double *b, int neq, int nrh, int np, int n, int mp, int m);
+/* model_cache.c */
+#define MODEL_CACHE_KEY_LEN 32
+gboolean model_cache_load(const char *path, const guint8 *key);
+void model_cache_save(const char *path, const guint8 *key);
 /* nec2_model.c */
 void Zero_Store(GtkListStore *store, GtkTreeIter *iter, int ncols, int start_idx, int stop_idx);
 void Nec2_Input_File_Treeview(int action);
@@ -1892,6 +2045,9 @@ void *Optimizer_Output(void *arg);
 void optimizer_output_start(void);
 void optimizer_output_stop(void);
 int opt_have_files_to_save(void);
+void optimizer_stream_abort(void);
+void optimizer_stream_begin(void);
+void optimizer_stream_steps(void);
 /* freqplots */
 void Plot_Frequency_Data(freqplots_view_t *view, cairo_t *cr);
 void Plots_Window_Killed(void);
@@ -1925,7 +2081,15 @@ gboolean Save_Config(void);
 /* somnec.c */
 void somnec(double epr, double sig, double fmhz);
 void fbar(complex double p, complex double *fbar);
+/* sweep_archive.c */
+void sweep_archive_model(FILE *fp);
+void sweep_archive_begin(void);
+gboolean sweep_archive_restore(double fmhz, int fstep);
+void sweep_archive_append(int fstep);
+void sweep_archive_close(void);
 /* utils.c */
+void ui_thread_init(void);
+gboolean ui_thread_is_self(void);
 int Stop(int err, const char *format, ...) __attribute__((format(printf, 2, 3)));
 int Notice(GtkButtonsType buttons, const char *title, const char *msg_fmt, ...) __attribute__((format(printf, 3, 4)));
 int Notice_Question(GtkButtonsType buttons, const char *title, const char *question, const char *msg_fmt, ...) __attribute__((format(printf, 4, 5)));
@@ -1985,6 +2149,12 @@ void New_Frequency(void);
 gboolean Frequency_Loop(gpointer udata);
 void batch_finish_no_steps(void);
 gboolean freq_loop_run_sync(void);
+gboolean freq_loop_run_reduced(const char *need, int skip);
+void freq_loop_publish_best(void);
+int freq_loop_measure_batch(const char *deck, size_t deck_len,
+    char *const *sy_texts, int num, const char *sy_restore,
+    const char *need, int skip, measurement_t *meas, int max_steps,
+    char *failed);
 gboolean Start_Frequency_Loop(void);
 gboolean Start_Frequency_Loop_Greenline(void);
 void Stop_Frequency_Loop(void);
@@ -1220,18 +1220,18 @@ nefld( double xob, double yob,
   {
     for( i = 0; i < data.n; i++ )
     {
-      dataj.xj= xob- data.segments[i].x;
-      dataj.yj= yob- data.segments[i].y;
-      dataj.zj= zob- data.segments[i].z;
-      zp= data.segments[i].cab * dataj.xj+ data.segments[i].sab *
-        dataj.yj+ data.segments[i].salp * dataj.zj;
+      dataj.xj= xob- data.obs[i].x;
+      dataj.yj= yob- data.obs[i].y;
+      dataj.zj= zob- data.obs[i].z;
+      zp= data.obs[i].cab * dataj.xj+ data.obs[i].sab *
+        dataj.yj+ data.obs[i].salp * dataj.zj;
 
-      if( fabs( zp) > 0.5001* data.segments[i].si)
+      if( fabs( zp) > 0.5001* data.obs[i].si)
         continue;
 
       zp= dataj.xj* dataj.xj+ dataj.yj* dataj.yj +
         dataj.zj* dataj.zj- zp* zp;
-      dataj.xj= data.segments[i].bi;
+      dataj.xj= data.obs[i].bi;
 
       if( zp > 0.9* dataj.xj* dataj.xj)
         continue;
@@ -1244,18 +1244,18 @@ nefld( double xob, double yob,
     for( i = 0; i < data.n; i++ )
     {
       ix = i+1;
-      dataj.s= data.segments[i].si;
-      dataj.b= data.segments[i].bi;
-      dataj.xj= data.segments[i].x;
-      dataj.yj= data.segments[i].y;
-      dataj.zj= data.segments[i].z;
-      dataj.cabj= data.segments[i].cab;
-      dataj.sabj= data.segments[i].sab;
-      dataj.salpj= data.segments[i].salp;
+      dataj.s= data.obs[i].si;
+      dataj.b= data.obs[i].bi;
+      dataj.xj= data.obs[i].x;
+      dataj.yj= data.obs[i].y;
+      dataj.zj= data.obs[i].z;
+      dataj.cabj= data.obs[i].cab;
+      dataj.sabj= data.obs[i].sab;
+      dataj.salpj= data.obs[i].salp;
 
       if( dataj.iexk != 0)
       {
-        ipr= data.segments[i].icon1;
+        ipr= data.con[i].icon1;
 
         if (ipr > PCHCON) dataj.ind1 = 2;
         else if( ipr < 0 )
@@ -1263,14 +1263,14 @@ nefld( double xob, double yob,
           ipr = -ipr;
           iprx = ipr-1;
 
-          if( -data.segments[iprx].icon1 != ix )
+          if( -data.con[iprx].icon1 != ix )
             dataj.ind1=2;
           else
           {
-            xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                     data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+            xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                     data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
             if( (xi < 0.999999) ||
-                (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+                (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
               dataj.ind1=2;
             else
               dataj.ind1=0;
@@ -1284,14 +1284,14 @@ nefld( double xob, double yob,
 
           if( ipr != ix )
           {
-            if(data.segments[iprx].icon2 != ix )
+            if(data.con[iprx].icon2 != ix )
               dataj.ind1=2;
             else
             {
-              xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                       data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+              xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                       data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
               if( (xi < 0.999999) ||
-                  (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+                  (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
                 dataj.ind1=2;
               else
                 dataj.ind1=0;
@@ -1307,7 +1307,7 @@ nefld( double xob, double yob,
           }
         } /* else */
 
-        ipr= data.segments[i].icon2;
+        ipr= data.con[i].icon2;
 
         if (ipr > PCHCON) dataj.ind2 = 2;
         else if( ipr < 0 )
@@ -1315,14 +1315,14 @@ nefld( double xob, double yob,
           ipr = -ipr;
           iprx = ipr-1;
 
-          if( -data.segments[iprx].icon2 != ix )
+          if( -data.con[iprx].icon2 != ix )
             dataj.ind1=2;
           else
           {
-            xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                     data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+            xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                     data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
             if( (xi < 0.999999) ||
-                (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+                (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
               dataj.ind1=2;
             else
               dataj.ind1=0;
@@ -1336,14 +1336,14 @@ nefld( double xob, double yob,
 
           if( ipr != ix )
           {
-            if(data.segments[iprx].icon1 != ix )
+            if(data.con[iprx].icon1 != ix )
               dataj.ind2=2;
             else
             {
-              xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                       data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+              xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                       data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
               if( (xi < 0.999999) ||
-                  (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+                  (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
                 dataj.ind2=2;
               else
                 dataj.ind2=0;
@@ -1434,18 +1434,18 @@ nhfld( double xob, double yob,
   {
     for( i = 0; i < data.n; i++ )
     {
-      dataj.xj= xob- data.segments[i].x;
-      dataj.yj= yob- data.segments[i].y;
-      dataj.zj= zob- data.segments[i].z;
-      zp= data.segments[i].cab * dataj.xj+ data.segments[i].sab *
-        dataj.yj+ data.segments[i].salp * dataj.zj;
+      dataj.xj= xob- data.obs[i].x;
+      dataj.yj= yob- data.obs[i].y;
+      dataj.zj= zob- data.obs[i].z;
+      zp= data.obs[i].cab * dataj.xj+ data.obs[i].sab *
+        dataj.yj+ data.obs[i].salp * dataj.zj;
 
-      if( fabs( zp) > 0.5001* data.segments[i].si)
+      if( fabs( zp) > 0.5001* data.obs[i].si)
         continue;
 
       zp= dataj.xj* dataj.xj+ dataj.yj* dataj.yj +
         dataj.zj* dataj.zj- zp* zp;
-      dataj.xj= data.segments[i].bi;
+      dataj.xj= data.obs[i].bi;
 
       if( zp > 0.9* dataj.xj* dataj.xj)
         continue;
@@ -1456,14 +1456,14 @@ nhfld( double xob, double yob,
 
     for( i = 0; i < data.n; i++ )
     {
-      dataj.s= data.segments[i].si;
-      dataj.b= data.segments[i].bi;
-      dataj.xj= data.segments[i].x;
-      dataj.yj= data.segments[i].y;
-      dataj.zj= data.segments[i].z;
-      dataj.cabj= data.segments[i].cab;
-      dataj.sabj= data.segments[i].sab;
-      dataj.salpj= data.segments[i].salp;
+      dataj.s= data.obs[i].si;
+      dataj.b= data.obs[i].bi;
+      dataj.xj= data.obs[i].x;
+      dataj.yj= data.obs[i].y;
+      dataj.zj= data.obs[i].z;
+      dataj.cabj= data.obs[i].cab;
+      dataj.sabj= data.obs[i].sab;
+      dataj.salpj= data.obs[i].salp;
       hsfld( xob, yob, zob, ax);
       acx= cmplx( crnt_step->air[i], crnt_step->aii[i]);
       bcx= cmplx( crnt_step->bir[i], crnt_step->bii[i]);
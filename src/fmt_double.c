@@ -0,0 +1,253 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  The official website and doumentation for xnec2c is available here:
+ *    https://www.xnec2c.org/
+ */
+
+#define _GNU_SOURCE
+
+#include <locale.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fmt_double.h"
+
+/* The CSV and Touchstone writers emit every value as "%.17g", which goes
+ * through the locale and stdio's arbitrary-precision conversion for each
+ * one.  A double is m * 2^e with a 53-bit m, so its 17 significant digits
+ * are m * 2^e * 10^k rounded to an integer for the k that leaves 17 of
+ * them.  Splitting 10^k into 2^k * 5^k keeps that product and its divisor
+ * within 128 bits for any magnitude from about 1e-16 to 1e32, where the
+ * rounding is done exactly, ties to even, as glibc does.  Zero, infinities,
+ * NaNs and values outside that range go to snprintf() under a C locale. */
+
+typedef unsigned __int128 fmt_u128;
+
+/* 5^0 .. 5^27, the powers of five that fit in 64 bits */
+static const uint64_t fmt_pow5[28] =
+{
+	1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL,
+	390625ULL, 1953125ULL, 9765625ULL, 48828125ULL, 244140625ULL,
+	1220703125ULL, 6103515625ULL, 30517578125ULL, 152587890625ULL,
+	762939453125ULL, 3814697265625ULL, 19073486328125ULL,
+	95367431640625ULL, 476837158203125ULL, 2384185791015625ULL,
+	11920928955078125ULL, 59604644775390625ULL, 298023223876953125ULL,
+	1490116119384765625ULL, 7450580596923828125ULL
+};
+
+#define FMT_POW5_MAX    54
+#define FMT_P16         10000000000000000ULL   /* 10^16 */
+#define FMT_P17         100000000000000000ULL  /* 10^17 */
+
+/* Bits needed to hold x */
+static int fmt_bits(fmt_u128 x)
+{
+	uint64_t hi = (uint64_t)(x >> 64);
+	uint64_t lo = (uint64_t)x;
+
+	if (hi != 0)
+		return 128 - __builtin_clzll(hi);
+	if (lo != 0)
+		return 64 - __builtin_clzll(lo);
+	return 0;
+}
+
+/* 5^n for n up to FMT_POW5_MAX */
+static fmt_u128 fmt_pow5_wide(int n)
+{
+	if (n <= 27)
+		return fmt_pow5[n];
+
+	return (fmt_u128)fmt_pow5[27] * fmt_pow5[n - 27];
+}
+
+/* Sets floor_q and round_q to m * 2^e * 10^k rounded down and to the
+ * nearest integer, ties to even.  Returns 0 when the operands do not fit
+ * in 128 bits. */
+static int fmt_scale(uint64_t m, int e, int k, uint64_t *floor_q, uint64_t *round_q)
+{
+	fmt_u128 num = m;
+	fmt_u128 den = 1;
+	fmt_u128 q, r;
+	int t = e + k;
+
+	if (k > 0)
+	{
+		if (k > 32)
+			return 0;
+		num *= fmt_pow5_wide(k);
+	}
+	else if (k < 0)
+	{
+		if (-k > FMT_POW5_MAX)
+			return 0;
+		den = fmt_pow5_wide(-k);
+	}
+
+	if (t > 0)
+	{
+		if (fmt_bits(num) + t > 127)
+			return 0;
+		num <<= t;
+	}
+	else if (t < 0)
+	{
+		if (fmt_bits(den) - t > 127)
+			return 0;
+		den <<= -t;
+	}
+
+	q = num / den;
+	r = num - q * den;
+
+	/* Only quotients near 10^16 .. 10^17 are of use; larger ones mean the
+	 * decimal exponent was guessed low */
+	if (q > (fmt_u128)FMT_P17 * 10)
+		q = (fmt_u128)FMT_P17 * 10;
+	*floor_q = (uint64_t)q;
+
+	if (r > den - r || (r == den - r && (q & 1)))
+		q++;
+	*round_q = (uint64_t)q;
+
+	return 1;
+}
+
+/*-----------------------------------------------------------------------*/
+
+static locale_t fmt_c_locale;
+static pthread_once_t fmt_c_locale_once = PTHREAD_ONCE_INIT;
+
+static void fmt_c_locale_init(void)
+{
+	fmt_c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+}
+
+/* snprintf("%.17g") under the C numeric locale of this thread only */
+static int fmt_g17_stdio(char *buf, double v)
+{
+	locale_t prev = (locale_t)0;
+	int len;
+
+	pthread_once(&fmt_c_locale_once, fmt_c_locale_init);
+	if (fmt_c_locale != (locale_t)0)
+		prev = uselocale(fmt_c_locale);
+
+	len = snprintf(buf, FMT_G17_LEN, "%.17g", v);
+
+	if (prev != (locale_t)0)
+		uselocale(prev);
+
+	return len;
+}
+
+/*-----------------------------------------------------------------------*/
+
+int fmt_g17(char *buf, double v)
+{
+	char digits[17];
+	char *o = buf;
+	uint64_t m, fq, q;
+	double a = fabs(v);
+	int e, x, n, i, tries;
+
+	if (!isfinite(v) || a == 0.0)
+		return fmt_g17_stdio(buf, v);
+
+	m = (uint64_t)ldexp(frexp(a, &e), 53);
+	e -= 53;
+
+	/* Decimal exponent of the leading digit, corrected against the exact
+	 * quotient when log10() lands on the wrong side of a power of ten */
+	x = (int)floor(log10(a));
+	for (tries = 0; ; tries++)
+	{
+		if (tries > 2 || !fmt_scale(m, e, 16 - x, &fq, &q))
+			return fmt_g17_stdio(buf, v);
+
+		if (fq < FMT_P16)
+			x--;
+		else if (fq >= FMT_P17)
+			x++;
+		else
+			break;
+	}
+
+	/* 9.99..95 and up rounds to the next power of ten */
+	if (q == FMT_P17)
+	{
+		q = FMT_P16;
+		x++;
+	}
+
+	for (i = 16; i >= 0; i--)
+	{
+		digits[i] = (char)('0' + q % 10);
+		q /= 10;
+	}
+
+	/* %g drops trailing zeros */
+	for (n = 17; n > 1 && digits[n - 1] == '0'; n--);
+
+	if (signbit(v))
+		*o++ = '-';
+
+	if (x < -4 || x >= 17)
+	{
+		*o++ = digits[0];
+		if (n > 1)
+		{
+			*o++ = '.';
+			for (i = 1; i < n; i++)
+				*o++ = digits[i];
+		}
+
+		*o++ = 'e';
+		*o++ = (x < 0) ? '-' : '+';
+		x = abs(x);
+		if (x >= 100)
+			*o++ = (char)('0' + x / 100);
+		*o++ = (char)('0' + (x / 10) % 10);
+		*o++ = (char)('0' + x % 10);
+	}
+	else if (x >= 0)
+	{
+		for (i = 0; i <= x; i++)
+			*o++ = digits[i];
+		if (n > x + 1)
+		{
+			*o++ = '.';
+			for (; i < n; i++)
+				*o++ = digits[i];
+		}
+	}
+	else
+	{
+		*o++ = '0';
+		*o++ = '.';
+		for (i = x + 1; i < 0; i++)
+			*o++ = '0';
+		for (i = 0; i < n; i++)
+			*o++ = digits[i];
+	}
+
+	*o = '\0';
+
+	return (int)(o - buf);
+}
@@ -0,0 +1,37 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  The official website and doumentation for xnec2c is available here:
+ *    https://www.xnec2c.org/
+ */
+
+#ifndef FMT_DOUBLE_H
+#define FMT_DOUBLE_H    1
+
+/* Buffer length that holds any fmt_g17() result and its terminator */
+#define FMT_G17_LEN     32
+
+/* fmt_g17 - format a double as printf("%.17g") in the C locale
+ * @buf: output, at least FMT_G17_LEN bytes
+ * @v:   value
+ *
+ * Writes the same text as snprintf(buf, FMT_G17_LEN, "%.17g", v) under
+ * the C numeric locale, whatever the locale of the calling thread, and
+ * returns its length.  Values of the range sweep results take are
+ * converted with exact integer arithmetic instead of stdio.
+ */
+int fmt_g17(char *buf, double v);
+
+#endif
@@ -28,6 +28,8 @@
 
 /* Pipe primitives are defined below their first use in this file */
 static ssize_t Write_Pipe( int idx, char *str, ssize_t len );
+static ssize_t Read_Pipe( int idx, char *str, ssize_t len );
+static ssize_t PRead_Pipe( int idx, char *str, ssize_t len );
 
 /* Wire names of the parent/child commands, indexed by enum P2CH_COMND.
  * The row width holds every tag to FORK_CMD_LEN bytes, so a wider name
@@ -35,6 +37,8 @@ static ssize_t Write_Pipe( int idx, char *str, ssize_t len );
 static const char fork_cmd_names[NUM_FKCMNDS][FORK_CMD_LEN + 1] = {
   [INFILE]  = "inpfile",
   [FRQDATA] = "frqdata",
+  [DECK]    = "deckbuf",
+  [MEASURE] = "msrdata",
 };
 
 /* One command payload field: the address transferred and its width */
@@ -56,8 +60,11 @@ static void
 fork_fields_xfer( int idx, const fork_field_t *fields, int nfields,
                   pipe_fn_t pipe_fn )
 {
+  /* An empty field moves nothing; a zero-length read would also look like
+   * the parent's EOF to a child */
   for( int i = 0; i < nfields; i++ )
-    pipe_fn( idx, fields[i].ptr, (ssize_t)fields[i].size );
+    if( fields[i].size > 0 )
+      pipe_fn( idx, fields[i].ptr, (ssize_t)fields[i].size );
 }
 
 /* fork_xfer_infile()
@@ -78,7 +85,7 @@ fork_xfer_infile( int idx, pipe_fn_t pipe_fn )
 /* fork_xfer_frqdata()
  *
  * Transfers the FRQDATA payload in @frq over child @idx's pipe: math library
- * id, thread budget, and the frequency to solve.
+ * id, thread budget, skipped step parts, and the frequency to solve.
  */
 static void
 fork_xfer_frqdata( int idx, fork_frqdata_t *frq, pipe_fn_t pipe_fn )
@@ -86,12 +93,49 @@ fork_xfer_frqdata( int idx, fork_frqdata_t *frq, pipe_fn_t pipe_fn )
   fork_field_t fields[] = {
     { frq->mathlib_id, sizeof(frq->mathlib_id) },
     { &frq->threads,   sizeof(frq->threads)    },
+    { &frq->skip,      sizeof(frq->skip)       },
     { &frq->freq_mhz,  sizeof(frq->freq_mhz)   },
   };
 
   fork_fields_xfer( idx, fields, (int)G_N_ELEMENTS(fields), pipe_fn );
 }
 
+/* fork_xfer_deck()
+ *
+ * Transfers the DECK payload in @dk over child @idx's pipe: both lengths,
+ * then both texts.  The receiving side grows its buffers between the two
+ * walks and terminates the texts after the second.
+ */
+static void
+fork_xfer_deck( int idx, fork_deck_t *dk, pipe_fn_t pipe_fn )
+{
+  fork_field_t lens[] = {
+    { &dk->deck_len, sizeof(dk->deck_len) },
+    { &dk->sy_len,   sizeof(dk->sy_len)   },
+  };
+
+  fork_fields_xfer( idx, lens, (int)G_N_ELEMENTS(lens), pipe_fn );
+
+  if( pipe_fn == Read_Pipe )
+  {
+    mem_realloc( &dk->deck, dk->deck_len + 1 );
+    mem_realloc( &dk->sy,   dk->sy_len + 1 );
+  }
+
+  fork_field_t texts[] = {
+    { dk->deck, dk->deck_len },
+    { dk->sy,   dk->sy_len   },
+  };
+
+  fork_fields_xfer( idx, texts, (int)G_N_ELEMENTS(texts), pipe_fn );
+
+  if( pipe_fn == Read_Pipe )
+  {
+    dk->deck[dk->deck_len] = '\0';
+    dk->sy[dk->sy_len]     = '\0';
+  }
+}
+
 /* fork_send_cmd()
  *
  * Writes the wire tag of command @cmd to child @idx, ahead of its payload.
@@ -133,6 +177,67 @@ fork_send_frqdata( int idx, fork_frqdata_t *frq )
 
 /*------------------------------------------------------------------------*/
 
+/* fork_send_deck()
+ *
+ * Sends the DECK command tag and the texts in @dk to child @idx.
+ */
+  void
+fork_send_deck( int idx, fork_deck_t *dk )
+{
+  fork_send_cmd( idx, DECK );
+  fork_xfer_deck( idx, dk, Write_Pipe );
+
+} /* fork_send_deck() */
+
+/*------------------------------------------------------------------------*/
+
+/* fork_send_measure()
+ *
+ * Sends the MEASURE command tag and the payload in @frq to child @idx.
+ */
+  void
+fork_send_measure( int idx, fork_frqdata_t *frq )
+{
+  fork_send_cmd( idx, MEASURE );
+  fork_xfer_frqdata( idx, frq, Write_Pipe );
+
+} /* fork_send_measure() */
+
+/*------------------------------------------------------------------------*/
+
+/* fork_recv_deck()
+ *
+ * Reads child @idx's answer to a DECK command.  Returns 1 if the child
+ * parsed the deck, 0 if it did not, -1 if the pipe read fails.
+ */
+  int
+fork_recv_deck( int idx )
+{
+  int status = 0;
+
+  if( PRead_Pipe(idx, (char *)&status, sizeof(status)) != (ssize_t)sizeof(status) )
+    return( -1 );
+
+  return( status ? 1 : 0 );
+
+} /* fork_recv_deck() */
+
+/*------------------------------------------------------------------------*/
+
+/* fork_recv_measure()
+ *
+ * Reads child @idx's answer to a MEASURE command into @m.
+ * Returns 0 if the pipe read fails, 1 otherwise.
+ */
+  int
+fork_recv_measure( int idx, measurement_t *m )
+{
+  return( PRead_Pipe(idx, (char *)m, sizeof(*m)) == (ssize_t)sizeof(*m) );
+
+} /* fork_recv_measure() */
+
+/*------------------------------------------------------------------------*/
+
 /* Child_Input_File()
  *
  * Opens NEC2 input file for child processes
@@ -159,6 +264,40 @@ Child_Input_File( void )
 
 /*------------------------------------------------------------------------*/
 
+/* Child_Input_Deck()
+ *
+ * Parses the deck and overrides received in @dk for child processes.
+ * input_fp reads @dk's buffer for the parse alone.  Returns FALSE if the
+ * deck does not parse, as Reparse_Input_Deck() does in the parent.
+ */
+  static gboolean
+Child_Input_Deck( fork_deck_t *dk )
+{
+  gboolean ok;
+
+  Close_File( &input_fp );
+
+  input_fp = fmemopen( dk->deck, dk->deck_len, "r" );
+  if( input_fp == NULL )
+  {
+    pr_crit("Child_Input_Deck: fmemopen failed: %s\n", strerror(errno));
+    return( FALSE );
+  }
+
+  ClearFlag( ALL_FLAGS );
+  SetFlag( INPUT_PENDING );
+  Set_Input_Overrides( dk->sy );
+  ok = Read_Comments() && Read_Geometry() && Read_Commands();
+  Set_Input_Overrides( NULL );
+  Close_File( &input_fp );
+  ClearFlag( INPUT_PENDING );
+
+  return( ok );
+
+} /* Child_Input_Deck() */
+
+/*------------------------------------------------------------------------*/
+
 /* Fork_Command()
  *
  * Identifies a command string
@@ -432,6 +571,9 @@ freq_fields_xfer(int fstep, int pipe_idx, pipe_fn_t pipe_fn)
      * geometry derive in the parent at draw and never cross the pipe */
     { near_field_fstep[fstep].points,  size_nf_points, 0,                        FREQ_COND_NEAREH },
     { &near_field_fstep[fstep].r_max,  NULL,           sizeof(double),           FREQ_COND_NEAREH },
+    /* Stage timings of the solve; one record per process, not per step,
+     * since the parent commits it as soon as it lands */
+    { freq_profile_step(),             NULL,           sizeof(freq_prof_step_t), FREQ_COND_ALWAYS },
   };
 
   int nfields = (int)(sizeof(fields) / sizeof(fields[0]));
@@ -466,6 +608,35 @@ Pass_Freq_Data( void )
 
 /*------------------------------------------------------------------------*/
 
+/* Child_Solve()
+ *
+ * Solves the frequency in @frq under the library and thread budget it
+ * names, into the child's single frequency slot.
+ */
+  static void
+Child_Solve( fork_frqdata_t *frq )
+{
+  /* The budget arrives with the library it configures, so both land
+   * before this frequency is solved. */
+  mathlib_load( get_mathlib_by_id(frq->mathlib_id) );
+  mathlib_set_num_threads( current_mathlib, frq->threads );
+
+  calc_data.freq_mhz = frq->freq_mhz;
+  calc_data.solve_skip = frq->skip;
+
+  /* Frequency buffers in children are for current frequency only */
+  calc_data.freq_step = 0;
+
+  /* Set flags */
+  freq_sweep_run_begin();
+
+  /* Calculate freq data */
+  New_Frequency();
+
+} /* Child_Solve() */
+
+/*------------------------------------------------------------------------*/
+
 /* Child_Process()
  *
  * Destination of child processes, handles data
@@ -477,6 +648,9 @@ Child_Process( int num_child )
 {
   char cmnd[FORK_CMD_LEN + 1];  /* Command string received from parent */
   fork_frqdata_t frq = { 0 };   /* FRQDATA payload received from parent */
+  fork_deck_t dk = { 0 };       /* DECK payload received from parent */
+  measurement_t meas;           /* MEASURE answer to parent */
+  int status;                   /* DECK answer to parent */
 
   /* Close unwanted pipe ends */
   close( child_procs[num_child]->to_child[WRITE] );
@@ -496,25 +670,26 @@ Child_Process( int num_child )
         Child_Input_File();
         break;
 
+      case DECK: /* Parse a deck held in memory and report whether it did */
+        fork_xfer_deck( num_child, &dk, Read_Pipe );
+        status = Child_Input_Deck( &dk );
+        Write_Pipe( num_child, (char *)&status, sizeof(status) );
+        break;
+
       case FRQDATA: /* Adopt the dispatched library, calculate currents and pass on */
         fork_xfer_frqdata( num_child, &frq, Read_Pipe );
+        Child_Solve( &frq );
+        Pass_Freq_Data();
+        break;
 
-        /* The budget arrives with the library it configures, so both land
-         * before this frequency is solved. */
-        mathlib_load( get_mathlib_by_id(frq.mathlib_id) );
-        mathlib_set_num_threads( current_mathlib, frq.threads );
-
-        calc_data.freq_mhz = frq.freq_mhz;
-
-        /* Frequency buffers in children are for current frequency only */
-        calc_data.freq_step = 0;
-
-        /* Set flags */
-        freq_sweep_run_begin();
+      case MEASURE: /* As FRQDATA, but pass on the measurements alone */
+        fork_xfer_frqdata( num_child, &frq, Read_Pipe );
+        Child_Solve( &frq );
 
-        /* Calculate freq data */
-        New_Frequency();
-        Pass_Freq_Data();
+        /* meas_calc() reads the step's frequency from save.freq[] */
+        save.freq[0] = frq.freq_mhz;
+        meas_calc( &meas, 0, calc_data.ex_port );
+        Write_Pipe( num_child, (char *)&meas, sizeof(meas) );
         break;
 
       default:
@@ -599,6 +774,21 @@ static ssize_t PRead_Pipe(int idx, char *str, ssize_t len)
 
 /*------------------------------------------------------------------------*/
 
+/* freq_data_publish()
+ *
+ * Parent publication point: the child's counter never crosses the pipe,
+ * so the parent stamps its own token once the slot content is complete.
+ */
+  static void
+freq_data_publish( int fstep )
+{
+  if( isFlagSet(ENABLE_NEAREH) )
+    near_field_fstep[fstep].content_generation = ++near_field_generation;
+
+} /* freq_data_publish() */
+
+/*------------------------------------------------------------------------*/
+
 /* Get_Freq_Data()
  *
  * Gets frequency-dependent data (current, charge density,
@@ -612,13 +802,146 @@ Get_Freq_Data( int idx, int fstep )
   if (!freq_fields_xfer(fstep, idx, PRead_Pipe))
     return 0;
 
-  /* Parent publication point: the child's counter never crosses the pipe,
-   * so the parent stamps its own token once the slot content is complete */
-  if( isFlagSet(ENABLE_NEAREH) )
-    near_field_fstep[fstep].content_generation = ++near_field_generation;
+  freq_data_publish( fstep );
 
   return 1;
 } /* Get_Freq_Data() */
 
 /*------------------------------------------------------------------------*/
 
+/* In-memory image of one step's transfer.  The blob primitives below stand
+ * in for the pipe primitives under the same field walk, so a blob holds the
+ * fields of freq_fields_xfer() in wire order and at wire width.  The walk
+ * still names a slot for its field table; the extra slot at steps_total is
+ * always allocated, so the measure and receive walks name it while writing
+ * nothing there.  Every blob walk runs under freq_data_lock, which
+ * serializes this cursor. */
+static char   *freq_blob_base;
+static size_t  freq_blob_off;
+
+/* Counts a field's width without moving data */
+  static ssize_t
+freq_blob_measure( int idx, char *str, ssize_t len )
+{
+  freq_blob_off += (size_t)len;
+  return( len );
+}
+
+/* Reads a field from child @idx's pipe into the blob */
+  static ssize_t
+freq_blob_recv( int idx, char *str, ssize_t len )
+{
+  ssize_t retval = PRead_Pipe( idx, freq_blob_base + freq_blob_off, len );
+
+  if( retval > 0 )
+    freq_blob_off += (size_t)retval;
+
+  return( retval );
+}
+
+/* Copies a field from the blob into its slot buffer */
+  static ssize_t
+freq_blob_unpack( int idx, char *str, ssize_t len )
+{
+  memcpy( str, freq_blob_base + freq_blob_off, (size_t)len );
+  freq_blob_off += (size_t)len;
+  return( len );
+}
+
+/* Copies a field from its slot buffer into the blob */
+  static ssize_t
+freq_blob_pack( int idx, char *str, ssize_t len )
+{
+  memcpy( freq_blob_base + freq_blob_off, str, (size_t)len );
+  freq_blob_off += (size_t)len;
+  return( len );
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Freq_Data_Size()
+ *
+ * Returns the byte width of one step's transfer under the current model
+ * and flag state.  A blob captured under another model measures otherwise,
+ * which is how a consumer recognizes it as stale.
+ *
+ * Be sure to hold the freq_data_lock mutex when calling this function.
+ */
+  size_t
+Freq_Data_Size( void )
+{
+  freq_blob_off = 0;
+  freq_fields_xfer( calc_data.steps_total, 0, freq_blob_measure );
+
+  return( freq_blob_off );
+
+} /* Freq_Data_Size() */
+
+/*------------------------------------------------------------------------*/
+
+/* Get_Freq_Blob()
+ *
+ * Gets the frequency-dependent data of child @idx into @blob, which holds
+ * Freq_Data_Size() bytes, instead of into a step slot.  Used for solves
+ * that answer no sweep step, such as the speculative pre-solve.
+ *
+ * Be sure to hold the freq_data_lock mutex when calling this function.
+ */
+  int
+Get_Freq_Blob( int idx, char *blob )
+{
+  freq_blob_base = blob;
+  freq_blob_off  = 0;
+
+  int ok = freq_fields_xfer( calc_data.steps_total, idx, freq_blob_recv );
+
+  freq_blob_base = NULL;
+  return( ok );
+
+} /* Get_Freq_Blob() */
+
+/*------------------------------------------------------------------------*/
+
+/* Put_Freq_Blob()
+ *
+ * Unpacks a blob captured by Get_Freq_Blob() into step slot @fstep and
+ * publishes the slot exactly as Get_Freq_Data() does after a pipe read.
+ *
+ * Be sure to hold the freq_data_lock mutex when calling this function.
+ */
+  void
+Put_Freq_Blob( const char *blob, int fstep )
+{
+  freq_blob_base = (char *)blob;
+  freq_blob_off  = 0;
+
+  freq_fields_xfer( fstep, 0, freq_blob_unpack );
+  freq_data_publish( fstep );
+
+  freq_blob_base = NULL;
+
+} /* Put_Freq_Blob() */
+
+/*------------------------------------------------------------------------*/
+
+/* Pack_Freq_Blob()
+ *
+ * Packs the data of step slot @fstep into @blob, which holds
+ * Freq_Data_Size() bytes, in the layout Put_Freq_Blob() unpacks.
+ *
+ * Be sure to hold the freq_data_lock mutex when calling this function.
+ */
+  void
+Pack_Freq_Blob( int fstep, char *blob )
+{
+  freq_blob_base = blob;
+  freq_blob_off  = 0;
+
+  freq_fields_xfer( fstep, 0, freq_blob_pack );
+
+  freq_blob_base = NULL;
+
+} /* Pack_Freq_Blob() */
+
+/*------------------------------------------------------------------------*/
+
@@ -30,21 +30,45 @@ enum P2CH_COMND
 {
   INFILE = 0,
   FRQDATA,
+  DECK,
+  MEASURE,
   NUM_FKCMNDS
 };
 
 /* FRQDATA payload: the math library the child adopts, the thread budget it
- * runs that library with, and the frequency it solves.  The widest member
- * sits last so the structure closes within one cache line; the transfer
- * walks each member by its own width, so padding never reaches the wire. */
+ * runs that library with, the SOLVE_SKIP_* parts it leaves out, and the
+ * frequency it solves.  The widest member sits last so the structure closes
+ * within one cache line; the transfer walks each member by its own width, so
+ * padding never reaches the wire. */
 typedef struct
 {
   char   mathlib_id[MATHLIB_ID_LEN];
   int    threads;
+  int    skip;
   double freq_mhz;
 } fork_frqdata_t;
 
+/* MEASURE carries the FRQDATA payload; the child solves the frequency under
+ * its current deck and answers with the step's measurement_t alone. */
+
+/* DECK payload: NEC2 deck text and .sy override text the child parses in
+ * place of the input file.  The lengths travel first so the receiver can
+ * size its buffers; the text itself travels without its terminator.  The
+ * child answers with an int, nonzero if the deck parsed, which the parent
+ * reads with fork_recv_deck() before sending anything else. */
+typedef struct
+{
+  size_t  deck_len;
+  size_t  sy_len;
+  char   *deck;
+  char   *sy;
+} fork_deck_t;
+
 void fork_send_infile( int idx );
 void fork_send_frqdata( int idx, fork_frqdata_t *frq );
+void fork_send_deck( int idx, fork_deck_t *dk );
+void fork_send_measure( int idx, fork_frqdata_t *frq );
+int  fork_recv_deck( int idx );
+int  fork_recv_measure( int idx, measurement_t *m );
 
 #endif
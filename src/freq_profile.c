@@ -0,0 +1,339 @@
+#include "shared.h"
+
+/* Per-stage sweep timing.  New_Frequency() stamps the end of each engine
+ * stage into a one-step record; a forked child ships its record back with
+ * the step's results (see freq_fields_xfer()), and the parent adds the time
+ * the pipe read took before committing the record to the sweep's samples.
+ * The GTK thread adds one PUBLISH sample per UI update.  At the end of a
+ * sweep the samples reduce to min/mean/p95 per stage, printed under
+ * --profile, written as JSON under --profile-json, and shown on demand by
+ * File->Sweep Profile.  Beside the stages, each record carries the scratch
+ * slices the solver took from the arena and the managed blocks the step
+ * allocated, reported as per-step means.
+ *
+ * Timing is always on: a step costs a dozen monotonic clock reads, lost
+ * against the fill and factor of even a small model.  Samples are guarded
+ * by freq_data_lock, which the committing sweep thread and the publishing
+ * GTK thread already hold. */
+
+static const char *freq_prof_names[FREQ_PROF_STAGES] = {
+  [FREQ_PROF_SCALE]     = "scale",
+  [FREQ_PROF_LOAD]      = "loading",
+  [FREQ_PROF_GROUND]    = "ground",
+  [FREQ_PROF_FILL]      = "fill",
+  [FREQ_PROF_FACTOR]    = "factor",
+  [FREQ_PROF_EXCITE]    = "excitation",
+  [FREQ_PROF_SOLVE]     = "network/solve",
+  [FREQ_PROF_POWER]     = "power loss",
+  [FREQ_PROF_PATTERN]   = "pattern",
+  [FREQ_PROF_NEAR]      = "near field",
+  [FREQ_PROF_PRERENDER] = "prerender",
+  [FREQ_PROF_XFER]      = "fork transfer",
+  [FREQ_PROF_PUBLISH]   = "UI publish",
+};
+
+/* Record of the step being solved in this process, and the time of the
+ * last mark into it */
+static freq_prof_step_t freq_prof_rec;
+static double           freq_prof_stamp = 0.0;
+
+/* Samples of the current sweep, one managed array per stage */
+static double *freq_prof_samples[FREQ_PROF_STAGES];
+static int     freq_prof_count[FREQ_PROF_STAGES];
+static int     freq_prof_steps = 0;
+
+/* Arena slices and managed blocks summed over the sweep's steps */
+static long    freq_prof_arena_allocs = 0;
+static long    freq_prof_mem_blocks = 0;
+
+/* Reduction of one stage's samples */
+typedef struct
+{
+  int    count;
+  double min, mean, p95, total;
+} freq_prof_stat_t;
+
+/*-----------------------------------------------------------------------*/
+
+/* Returns the monotonic clock in seconds */
+  static double
+freq_prof_now( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return( ts.tv_sec + (double)ts.tv_nsec / 1e9 );
+}
+
+/* Appends one sample to a stage.  Caller holds freq_data_lock. */
+  static void
+freq_prof_push( freq_prof_stage_t stage, double sec )
+{
+  int count = freq_prof_count[stage];
+
+  mem_array_reserve( &freq_prof_samples[stage], count + 1, 64 );
+  freq_prof_samples[stage][count] = sec;
+  freq_prof_count[stage] = count + 1;
+}
+
+/* qsort() comparator for ascending doubles */
+  static int
+freq_prof_cmp( const void *a, const void *b )
+{
+  double da = *(const double *)a, db = *(const double *)b;
+
+  return( (da > db) - (da < db) );
+}
+
+/* Reduces one stage's samples; p95 is the nearest-rank percentile.
+ * Caller holds freq_data_lock. */
+  static freq_prof_stat_t
+freq_prof_stat( freq_prof_stage_t stage )
+{
+  freq_prof_stat_t st = { 0 };
+  double *sorted = NULL;
+  int n = freq_prof_count[stage];
+
+  if( n == 0 )
+    return st;
+
+  mem_array_alloc( &sorted, n );
+  memcpy( sorted, freq_prof_samples[stage], (size_t)n * sizeof(double) );
+  qsort( sorted, (size_t)n, sizeof(double), freq_prof_cmp );
+
+  for( int idx = 0; idx < n; idx++ )
+    st.total += sorted[idx];
+
+  st.count = n;
+  st.min   = sorted[0];
+  st.mean  = st.total / n;
+  st.p95   = sorted[ (int)ceil(0.95 * n) - 1 ];
+
+  mem_array_free( &sorted );
+  return st;
+}
+
+/* Appends the text table to @text.  Caller holds freq_data_lock. */
+  static void
+freq_prof_format( GString *text )
+{
+  double total = 0.0;
+
+  for( int stage = 0; stage < FREQ_PROF_STAGES; stage++ )
+    for( int idx = 0; idx < freq_prof_count[stage]; idx++ )
+      total += freq_prof_samples[stage][idx];
+
+  g_string_append_printf( text, "%d steps, %.3f s across all stages\n\n",
+      freq_prof_steps, total );
+  g_string_append_printf( text, "%-14s %6s %10s %10s %10s %9s %6s\n",
+      "stage", "count", "min ms", "mean ms", "p95 ms", "total s", "share" );
+
+  for( int stage = 0; stage < FREQ_PROF_STAGES; stage++ )
+  {
+    freq_prof_stat_t st = freq_prof_stat( stage );
+
+    g_string_append_printf( text,
+        "%-14s %6d %10.3f %10.3f %10.3f %9.3f %5.1f%%\n",
+        freq_prof_names[stage], st.count, st.min * 1e3, st.mean * 1e3,
+        st.p95 * 1e3, st.total, total > 0.0 ? 100.0 * st.total / total : 0.0 );
+  }
+
+  if( freq_prof_steps > 0 )
+    g_string_append_printf( text,
+        "\n%.1f arena slices, %.1f managed allocations per step\n",
+        (double)freq_prof_arena_allocs / freq_prof_steps,
+        (double)freq_prof_mem_blocks / freq_prof_steps );
+}
+
+/* Writes the sweep's reduction as JSON.  Caller holds freq_data_lock. */
+  static void
+freq_prof_write_json( const char *fname )
+{
+  FILE *fp = NULL;
+
+  if( !Open_File(&fp, (char *)fname, "w") )
+    return;
+
+  fprintf( fp, "{\n  \"steps\": %d,\n", freq_prof_steps );
+  fprintf( fp, "  \"arena_allocs_per_step\": %.3f,\n",
+      freq_prof_steps > 0 ? (double)freq_prof_arena_allocs / freq_prof_steps : 0.0 );
+  fprintf( fp, "  \"managed_allocs_per_step\": %.3f,\n",
+      freq_prof_steps > 0 ? (double)freq_prof_mem_blocks / freq_prof_steps : 0.0 );
+  fprintf( fp, "  \"stages\": {\n" );
+
+  for( int stage = 0; stage < FREQ_PROF_STAGES; stage++ )
+  {
+    freq_prof_stat_t st = freq_prof_stat( stage );
+
+    fprintf( fp, "    \"%s\": { \"count\": %d, \"min_ms\": %.6f, "
+        "\"mean_ms\": %.6f, \"p95_ms\": %.6f, \"total_s\": %.6f }%s\n",
+        freq_prof_names[stage], st.count, st.min * 1e3, st.mean * 1e3,
+        st.p95 * 1e3, st.total, stage + 1 < FREQ_PROF_STAGES ? "," : "" );
+  }
+
+  fprintf( fp, "  }\n}\n" );
+  Close_File( &fp );
+}
+
+/*-----------------------------------------------------------------------*/
+
+/**
+ * freq_profile_sweep_begin - discard the previous sweep's samples
+ *
+ * Called from the sweep's INIT pass, so each report covers one sweep.
+ */
+void
+freq_profile_sweep_begin( void )
+{
+  g_rec_mutex_lock(&freq_data_lock);
+
+  for( int stage = 0; stage < FREQ_PROF_STAGES; stage++ )
+    freq_prof_count[stage] = 0;
+  freq_prof_steps = 0;
+  freq_prof_arena_allocs = 0;
+  freq_prof_mem_blocks = 0;
+
+  g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/**
+ * freq_profile_step_begin - open this process's record for a new step
+ *
+ * Clears every stage and starts the clock the first mark reads.
+ */
+void
+freq_profile_step_begin( void )
+{
+  memset( &freq_prof_rec, 0, sizeof(freq_prof_rec) );
+  freq_prof_stamp = freq_prof_now();
+}
+
+/**
+ * freq_profile_mark - charge the time since the last mark to a stage
+ * @stage: the stage that just finished
+ */
+void
+freq_profile_mark( freq_prof_stage_t stage )
+{
+  double now = freq_prof_now();
+
+  freq_prof_rec.sec[stage] += now - freq_prof_stamp;
+  freq_prof_stamp = now;
+}
+
+/**
+ * freq_profile_lap - restart the clock without charging a stage
+ *
+ * For untimed work between two timed stages.
+ */
+void
+freq_profile_lap( void )
+{
+  freq_prof_stamp = freq_prof_now();
+}
+
+/**
+ * freq_profile_allocs - record the step's allocation counts
+ * @arena_allocs: scratch slices the arena handed out, mem_arena_step_allocs()
+ * @mem_blocks: managed blocks taken from posix_memalign during the step
+ */
+void
+freq_profile_allocs( int arena_allocs, uint64_t mem_blocks )
+{
+  freq_prof_rec.arena_allocs = arena_allocs;
+  freq_prof_rec.mem_blocks = (int)mem_blocks;
+}
+
+/**
+ * freq_profile_step - this process's step record
+ *
+ * The transfer schema ships it from child to parent in place.
+ *
+ * Returns: the record New_Frequency() fills
+ */
+freq_prof_step_t *
+freq_profile_step( void )
+{
+  return &freq_prof_rec;
+}
+
+/**
+ * freq_profile_commit - add the current record to the sweep's samples
+ * @xfer_sec: time the parent spent reading the step, 0 when not forked
+ *
+ * Called once per collected sweep step, after the record has arrived from
+ * the child or been filled in process.  Caller holds freq_data_lock.
+ */
+void
+freq_profile_commit( double xfer_sec )
+{
+  freq_prof_rec.sec[FREQ_PROF_XFER] = xfer_sec;
+
+  for( int stage = 0; stage < FREQ_PROF_PUBLISH; stage++ )
+    freq_prof_push( stage, freq_prof_rec.sec[stage] );
+
+  freq_prof_arena_allocs += freq_prof_rec.arena_allocs;
+  freq_prof_mem_blocks += freq_prof_rec.mem_blocks;
+  freq_prof_steps++;
+}
+
+/**
+ * freq_profile_add - add one sample to a stage measured outside a step
+ * @stage: the stage measured
+ * @sec: its duration
+ */
+void
+freq_profile_add( freq_prof_stage_t stage, double sec )
+{
+  g_rec_mutex_lock(&freq_data_lock);
+  freq_prof_push( stage, sec );
+  g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/**
+ * freq_profile_report - emit the finished sweep's profile
+ *
+ * Prints the table under --profile and writes the JSON file under
+ * --profile-json; does nothing otherwise.  Called from freq_loop_finalize().
+ */
+void
+freq_profile_report( void )
+{
+  if( !rc_config.profile_enabled && rc_config.filename_profile_json == NULL )
+    return;
+
+  g_rec_mutex_lock(&freq_data_lock);
+
+  if( rc_config.profile_enabled )
+  {
+    GString *text = g_string_new( NULL );
+
+    freq_prof_format( text );
+    pr_notice("Sweep profile: %s", text->str);
+    g_string_free( text, TRUE );
+  }
+
+  if( rc_config.filename_profile_json != NULL )
+    freq_prof_write_json( rc_config.filename_profile_json );
+
+  g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/**
+ * freq_profile_text - the last sweep's stage table as text
+ *
+ * Returns: a newly allocated string for g_free(), or NULL before the first
+ * profiled sweep
+ */
+gchar *
+freq_profile_text( void )
+{
+  GString *text = g_string_new( NULL );
+
+  g_rec_mutex_lock(&freq_data_lock);
+  if( freq_prof_steps > 0 )
+    freq_prof_format( text );
+  g_rec_mutex_unlock(&freq_data_lock);
+
+  return( g_string_free(text, text->len == 0) );
+}
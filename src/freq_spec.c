@@ -0,0 +1,289 @@
+#include "shared.h"
+#include "plot_freqdata.h"
+
+/* Speculative pre-solve cache.  After a green-line solve the idle workers
+ * solve the frequencies just around the selection, at a finer spacing than
+ * the FR grid, and park each result here as a transfer blob (see
+ * Get_Freq_Blob()).  A later selection that lands on a cached frequency is
+ * unpacked into the extra slot instead of being dispatched, so scrubbing
+ * across a resonance redraws without a solve.
+ *
+ * Entries are keyed by frequency and evicted least recently used, bounded by
+ * both a slot count and a byte budget.  Every entry is a function of the
+ * loaded model alone, so any event that invalidates the sweep steps empties
+ * the cache and bumps its generation; a solve dispatched before the bump is
+ * refused at store time.  The cache is guarded by freq_data_lock, which
+ * every caller already holds around the slot it reads or writes. */
+
+/* Slot count and byte budget of the cache */
+#define FREQ_SPEC_CACHE_SLOTS   64
+#define FREQ_SPEC_CACHE_BYTES   ((size_t)256 << 20)
+
+/* Speculative spacing as a divisor of the FR grid spacing */
+#define FREQ_SPEC_SUBDIV        4
+
+typedef struct
+{
+  double    freq_mhz;   /* Key; 0 marks a free slot */
+  uint64_t  last_use;   /* LRU stamp from freq_spec_clock */
+  char     *blob;       /* Freq_Data_Size() bytes, mem-managed */
+  size_t    len;
+} freq_spec_entry_t;
+
+static freq_spec_entry_t freq_spec_cache[FREQ_SPEC_CACHE_SLOTS];
+static size_t            freq_spec_bytes = 0;
+static uint64_t          freq_spec_clock = 0;
+static unsigned          freq_spec_generation = 0;
+
+/* Raised by Stop_Frequency_Loop() on the GTK thread, read by the sweep
+ * thread between speculative dispatches. */
+static gint freq_spec_cancel_flag = 0;
+
+/*-----------------------------------------------------------------------*/
+
+/* Releases one slot's blob and marks the slot free */
+  static void
+freq_spec_entry_drop( freq_spec_entry_t *entry )
+{
+  freq_spec_bytes -= entry->len;
+  mem_free( &entry->blob );
+  entry->len      = 0;
+  entry->freq_mhz = 0.0;
+  entry->last_use = 0;
+}
+
+/* Returns the slot holding fmhz, or NULL */
+  static freq_spec_entry_t *
+freq_spec_find( double fmhz )
+{
+  for( int idx = 0; idx < FREQ_SPEC_CACHE_SLOTS; idx++ )
+    if( freq_spec_cache[idx].blob != NULL &&
+        FREQ_EQ(freq_spec_cache[idx].freq_mhz, fmhz) )
+      return &freq_spec_cache[idx];
+
+  return NULL;
+}
+
+/* Returns the free slot or, failing that, the least recently used one */
+  static freq_spec_entry_t *
+freq_spec_victim( void )
+{
+  freq_spec_entry_t *victim = &freq_spec_cache[0];
+
+  for( int idx = 0; idx < FREQ_SPEC_CACHE_SLOTS; idx++ )
+  {
+    if( freq_spec_cache[idx].blob == NULL )
+      return &freq_spec_cache[idx];
+
+    if( freq_spec_cache[idx].last_use < victim->last_use )
+      victim = &freq_spec_cache[idx];
+  }
+
+  return victim;
+}
+
+/*-----------------------------------------------------------------------*/
+
+/**
+ * freq_spec_reset - re-arm speculation for a new sweep
+ *
+ * Called from freq_loop_begin(); a cancel raised against an earlier sweep
+ * must not suppress the speculation that follows this one.
+ */
+void
+freq_spec_reset( void )
+{
+  g_atomic_int_set( &freq_spec_cancel_flag, 0 );
+}
+
+/**
+ * freq_spec_cancel - ask an in-progress speculation to stop dispatching
+ *
+ * Speculation runs on the sweep thread after the sweep itself has retired,
+ * so the sweep state machine no longer reaches it.  Stop_Frequency_Loop()
+ * raises this before joining the thread; in-flight children are still
+ * drained so no unread result is left on a pipe.
+ */
+void
+freq_spec_cancel( void )
+{
+  g_atomic_int_set( &freq_spec_cancel_flag, 1 );
+}
+
+/**
+ * freq_spec_cancelled - report whether speculation must stop dispatching
+ */
+gboolean
+freq_spec_cancelled( void )
+{
+  return( g_atomic_int_get(&freq_spec_cancel_flag) != 0 );
+}
+
+/**
+ * freq_spec_cache_clear - drop every cached result
+ *
+ * Called wherever the model the results derive from changes: the step
+ * invalidation preceding a full sweep, the deck load, and teardown.  Bumps
+ * the generation so a solve already in flight is not stored.
+ */
+void
+freq_spec_cache_clear( void )
+{
+  g_rec_mutex_lock(&freq_data_lock);
+
+  for( int idx = 0; idx < FREQ_SPEC_CACHE_SLOTS; idx++ )
+    if( freq_spec_cache[idx].blob != NULL )
+      freq_spec_entry_drop( &freq_spec_cache[idx] );
+
+  freq_spec_generation++;
+
+  g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/**
+ * freq_spec_cache_generation - current cache generation
+ *
+ * Sampled at dispatch and passed back to freq_spec_cache_store().  Caller
+ * holds freq_data_lock.
+ */
+unsigned
+freq_spec_cache_generation( void )
+{
+  return( freq_spec_generation );
+}
+
+/**
+ * freq_spec_cache_store - insert a speculative result
+ * @fmhz: frequency the blob was solved at
+ * @generation: cache generation sampled when the solve was dispatched
+ * @blob: address of a mem-managed Get_Freq_Blob() image; ownership passes
+ *        to the cache, or the blob is freed, and *blob is NULL on return
+ * @len: byte length of the blob
+ *
+ * Evicts least recently used entries until the slot count and byte budget
+ * admit the new one.  Caller holds freq_data_lock.
+ */
+void
+freq_spec_cache_store( double fmhz, unsigned generation, char **blob, size_t len )
+{
+  freq_spec_entry_t *entry;
+
+  if( generation != freq_spec_generation || len > FREQ_SPEC_CACHE_BYTES ||
+      freq_spec_find(fmhz) != NULL )
+  {
+    mem_free( blob );
+    return;
+  }
+
+  entry = freq_spec_victim();
+  if( entry->blob != NULL )
+    freq_spec_entry_drop( entry );
+
+  while( freq_spec_bytes + len > FREQ_SPEC_CACHE_BYTES )
+    freq_spec_entry_drop( freq_spec_victim() );
+
+  entry->freq_mhz = fmhz;
+  entry->last_use = ++freq_spec_clock;
+  entry->blob     = *blob;
+  entry->len      = len;
+  freq_spec_bytes += len;
+
+  *blob = NULL;
+}
+
+/**
+ * freq_spec_cache_restore - satisfy a selection from the cache
+ * @fmhz: selected frequency
+ * @fstep: slot to unpack into, the extra slot at steps_total
+ *
+ * An entry whose length no longer matches the transfer width was captured
+ * under different flag state (a pattern or near-field request since) and is
+ * dropped rather than unpacked.  Caller holds freq_data_lock.
+ *
+ * Returns: TRUE when @fstep now holds valid data for @fmhz
+ */
+gboolean
+freq_spec_cache_restore( double fmhz, int fstep )
+{
+  freq_spec_entry_t *entry = freq_spec_find( fmhz );
+
+  if( entry == NULL )
+    return FALSE;
+
+  if( entry->len != Freq_Data_Size() )
+  {
+    freq_spec_entry_drop( entry );
+    return FALSE;
+  }
+
+  Put_Freq_Blob( entry->blob, fstep );
+  save.freq[fstep]  = fmhz;
+  save.fstep[fstep] = 1;
+
+  entry->last_use = ++freq_spec_clock;
+
+  pr_debug("speculative cache hit at %.6f MHz\n", fmhz);
+  return TRUE;
+}
+
+/**
+ * freq_spec_plan - choose the frequencies to pre-solve around a selection
+ * @fmhz: the selected frequency
+ * @quantum: step of the frequency spin button in MHz, or 0
+ * @freqs: destination, at least @max entries
+ * @max: number of frequencies wanted
+ *
+ * Walks outward from @fmhz in alternating directions at a quarter of the
+ * spacing of the FR card that owns it, so the nearest neighbours are solved
+ * first.  A multiplicative card uses its local spacing at @fmhz.  The
+ * spacing is snapped down to a whole number of @quantum steps, at least one,
+ * so stepping the spin button away from @fmhz lands on cached entries.  Skips
+ * frequencies already cached, those that coincide with a sweep step (the
+ * sweep already holds them), and those outside every card.  Frequencies are
+ * rounded to 1 Hz so a selection keyed from the spin button matches.
+ * Caller holds freq_data_lock.
+ *
+ * Returns: the number of frequencies written to @freqs
+ */
+int
+freq_spec_plan( double fmhz, double quantum, double *freqs, int max )
+{
+  freq_loop_data_t *fld;
+  double spacing;
+  int card, count = 0;
+
+  card = freqloop_card_of_fmhz( fmhz );
+  if( card < 0 || max < 1 )
+    return 0;
+
+  fld = &calc_data.freq_loop_data[card];
+  spacing = (fld->ifreq == 1)
+      ? fmhz * (fld->delta_freq - 1.0)
+      : fld->delta_freq;
+  spacing = fabs( spacing ) / FREQ_SPEC_SUBDIV;
+
+  if( quantum > FREQ_EPSILON_MHZ )
+    spacing = MAX( 1.0, floor(spacing / quantum) ) * quantum;
+
+  if( spacing < FREQ_EPSILON_MHZ )
+    return 0;
+
+  /* Bounded walk: at most FREQ_SPEC_SUBDIV misses per wanted frequency */
+  for( int k = 1; count < max && k <= max * FREQ_SPEC_SUBDIV; k++ )
+  {
+    for( int sign = 1; sign >= -1 && count < max; sign -= 2 )
+    {
+      double f = round( (fmhz + sign * k * spacing) * 1e6 ) / 1e6;
+      gboolean skip = (f <= 0.0 || freqloop_card_of_fmhz(f) < 0 ||
+          freq_spec_find(f) != NULL);
+
+      for( int idx = 0; !skip && idx < calc_data.steps_total; idx++ )
+        skip = FREQ_EQ( save.freq[idx], f );
+
+      if( !skip )
+        freqs[count++] = f;
+    }
+  }
+
+  return count;
+}
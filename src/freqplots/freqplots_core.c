@@ -355,16 +355,17 @@ void fr_plots_init(freqplots_view_t *v)
 
   for (idx = 0; idx < v->ngraph * calc_data.FR_cards; idx++)
   {
-	  if (FR_PLOT_T_IS_VALID(&v->fr_plots[idx]))
-		  continue;
-
 	  // Set the plot position
 	  v->fr_plots[idx].posn = idx / calc_data.FR_cards;
 
-	  // Point to the freq loop data
+	  // Point to the freq loop data.  Valid entries are pointed again too:
+	  // a headless reparse keeps the table while the cards are reallocated.
 	  v->fr_plots[idx].fr = idx % calc_data.FR_cards;
 	  v->fr_plots[idx].freq_loop_data = &calc_data.freq_loop_data[v->fr_plots[idx].fr];
 
+	  if (FR_PLOT_T_IS_VALID(&v->fr_plots[idx]))
+		  continue;
+
 	  // zero the plot_rect, Plot_Graph() will fill it in.
 	  memset(&v->fr_plots[idx].plot_rect, 0, sizeof(GdkRectangle));
 
@@ -79,6 +79,307 @@ points_would_connect(double x1, double y1, double z1,
 
 /*-------------------------------------------------------------------*/
 
+/* Uniform grid over the segment ends.  Cells are as wide as the largest
+ * connection threshold, so the ends within a threshold of a point lie in
+ * the cells around it, and are hashed by cell into buckets chained through
+ * next[].  End 2*i is end 1 of segment i, end 2*i+1 its end 2. */
+typedef struct
+{
+  double x0, y0, z0;  /* Grid origin, the lowest end coordinates */
+  double size;        /* Cell edge */
+  double slack;       /* Distance an end may have moved since indexed */
+  int    nbucket;
+  int   *head;        /* First end of each bucket, or -1 */
+  int   *next;        /* Next end in the same bucket, or -1 */
+  int   *found;       /* Ends returned by seg_grid_near() to conect() */
+} seg_grid_t;
+
+/* Cells spanned along one axis beyond which the grid is not used */
+#define SEG_GRID_MAX_CELLS  1.0e12
+
+/* Cell of coordinate v along one axis */
+static inline gint64
+seg_grid_cell( double v, double v0, double size )
+{
+  return( (gint64)floor((v - v0) / size) );
+}
+
+/* Bucket of a cell */
+static inline int
+seg_grid_bucket( const seg_grid_t *grid, gint64 cx, gint64 cy, gint64 cz )
+{
+  guint64 h;
+
+  h = ((guint64)cx * 73856093u) ^ ((guint64)cy * 19349663u) ^
+    ((guint64)cz * 83492791u);
+
+  return( (int)(h % (guint64)grid->nbucket) );
+}
+
+/* Coordinates of end e of segment i */
+static inline void
+seg_end( int i, int e, double *x, double *y, double *z )
+{
+  if( e == 0 )
+  {
+    *x = data.segments[i].x1;
+    *y = data.segments[i].y1;
+    *z = data.segments[i].z1;
+  }
+  else
+  {
+    *x = data.segments[i].x2;
+    *y = data.segments[i].y2;
+    *z = data.segments[i].z2;
+  }
+}
+
+/*-------------------------------------------------------------------*/
+
+/* seg_grid_free()
+ *
+ * Releases the buckets of a segment end grid
+ */
+  static void
+seg_grid_free( seg_grid_t *grid )
+{
+  mem_array_free( &grid->head );
+  mem_array_free( &grid->next );
+  mem_array_free( &grid->found );
+
+} /* seg_grid_free() */
+
+/*-------------------------------------------------------------------*/
+
+/* seg_grid_build()
+ *
+ * Indexes the ends of the data.n segments.  Returns FALSE, with nothing
+ * allocated, for a geometry the grid cannot cover: no segments, or an
+ * end that is not finite or too far out for the cell size.  Callers then
+ * scan every segment as NEC2 does.
+ */
+  static gboolean
+seg_grid_build( seg_grid_t *grid )
+{
+  double x, y, z, x1, y1, z1, slen;
+  int i, e, p, b;
+
+  memset( grid, 0, sizeof(*grid) );
+  if( data.n <= 0 )
+    return( FALSE );
+
+  grid->x0 = grid->y0 = grid->z0 = HUGE_VAL;
+  x1 = y1 = z1 = -HUGE_VAL;
+  for( i = 0; i < data.n; i++ )
+  {
+    for( e = 0; e < 2; e++ )
+    {
+      seg_end( i, e, &x, &y, &z );
+      if( !isfinite(x) || !isfinite(y) || !isfinite(z) )
+        return( FALSE );
+
+      grid->x0 = fmin( grid->x0, x );  x1 = fmax( x1, x );
+      grid->y0 = fmin( grid->y0, y );  y1 = fmax( y1, y );
+      grid->z0 = fmin( grid->z0, z );  z1 = fmax( z1, z );
+    }
+
+    slen = calc_connection_threshold(
+        data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+        data.segments[i].x2, data.segments[i].y2, data.segments[i].z2 );
+    grid->size = fmax( grid->size, slen );
+  }
+
+  /* Only coincident ends connect when every segment has zero length */
+  if( grid->size <= 0.0 )
+    grid->size = 1.0;
+
+  if( (x1 - grid->x0) / grid->size > SEG_GRID_MAX_CELLS ||
+      (y1 - grid->y0) / grid->size > SEG_GRID_MAX_CELLS ||
+      (z1 - grid->z0) / grid->size > SEG_GRID_MAX_CELLS )
+    return( FALSE );
+
+  grid->nbucket = 4 * data.n;
+  mem_array_alloc( &grid->head, grid->nbucket );
+  mem_array_alloc( &grid->next, 2 * data.n );
+  for( b = 0; b < grid->nbucket; b++ )
+    grid->head[b] = -1;
+
+  /* Chain in reverse so each bucket lists its ends in ascending order */
+  for( p = 2 * data.n - 1; p >= 0; p-- )
+  {
+    seg_end( p / 2, p % 2, &x, &y, &z );
+    b = seg_grid_bucket( grid,
+        seg_grid_cell(x, grid->x0, grid->size),
+        seg_grid_cell(y, grid->y0, grid->size),
+        seg_grid_cell(z, grid->z0, grid->size) );
+    grid->next[p] = grid->head[b];
+    grid->head[b] = p;
+  }
+
+  return( TRUE );
+} /* seg_grid_build() */
+
+/*-------------------------------------------------------------------*/
+
+/* seg_grid_near()
+ *
+ * Collects into *found the ends indexed in the cells that hold every
+ * point within r of (x, y, z) along each axis, widened by the grid slack.
+ * The caller applies the exact test; ends may repeat where two of those
+ * cells share a bucket.  Returns the number collected.  The grid is only
+ * read, so threads may query it at once, each with its own buffer.
+ */
+  static int
+seg_grid_near( const seg_grid_t *grid, double x, double y, double z,
+    double r, int **found )
+{
+  gint64 cx, cy, cz, cx1, cy1, cz1, cx2, cy2, cz2;
+  int count = 0;
+  int p;
+
+  r += grid->slack;
+  cx1 = seg_grid_cell( x - r, grid->x0, grid->size );
+  cy1 = seg_grid_cell( y - r, grid->y0, grid->size );
+  cz1 = seg_grid_cell( z - r, grid->z0, grid->size );
+  cx2 = seg_grid_cell( x + r, grid->x0, grid->size );
+  cy2 = seg_grid_cell( y + r, grid->y0, grid->size );
+  cz2 = seg_grid_cell( z + r, grid->z0, grid->size );
+
+  for( cx = cx1; cx <= cx2; cx++ )
+    for( cy = cy1; cy <= cy2; cy++ )
+      for( cz = cz1; cz <= cz2; cz++ )
+        for( p = grid->head[seg_grid_bucket(grid, cx, cy, cz)];
+            p >= 0; p = grid->next[p] )
+        {
+          mem_array_reserve( found, count + 1, 64 );
+          (*found)[count++] = p;
+        }
+
+  return( count );
+} /* seg_grid_near() */
+
+/*-------------------------------------------------------------------*/
+
+/* conect_find_end()
+ *
+ * Finds the segment end a wire end of segment i at (x, y, z) connects to:
+ * the first within slen of it scanning the other segments in cyclic order
+ * from i + 1, end 1 before end 2.  Returns the NEC2 connection number,
+ * -(ic+1) for end 1 of segment ic and (ic+1) for its end 2, negated when
+ * searching for end 2 of segment i; 0 when no end is near.  Without a grid
+ * this is the NEC2 scan; with one only the ends near (x, y, z) are tested
+ * and the first of them in scan order is kept, so the result is the same.
+ */
+  static int
+conect_find_end( seg_grid_t *grid, int i, int iend,
+    double x, double y, double z, double slen )
+{
+  double xe, ye, ze;
+  int ic, j, e, k, nfound, key, best;
+  int sign = (iend == 0) ? 1 : -1;
+
+  if( grid == NULL )
+  {
+    ic = i;
+    for( j = 1; j < data.n; j++ )
+    {
+      ic++;
+      if( ic >= data.n )
+        ic = 0;
+
+      for( e = 0; e < 2; e++ )
+      {
+        seg_end( ic, e, &xe, &ye, &ze );
+        if( points_would_connect(x, y, z, xe, ye, ze, slen) )
+          return( (e == 0 ? -(ic+1) : (ic+1)) * sign );
+      }
+    }
+
+    return( 0 );
+  }
+
+  best = -1;
+  nfound = seg_grid_near( grid, x, y, z, slen, &grid->found );
+  for( k = 0; k < nfound; k++ )
+  {
+    ic = grid->found[k] / 2;
+    e  = grid->found[k] % 2;
+    if( ic == i )
+      continue;
+
+    /* Position in the NEC2 scan */
+    key = 2 * ((ic - i + data.n) % data.n) + e;
+    if( (best >= 0) && (key >= best) )
+      continue;
+
+    seg_end( ic, e, &xe, &ye, &ze );
+    if( points_would_connect(x, y, z, xe, ye, ze, slen) )
+      best = key;
+  }
+
+  if( best < 0 )
+    return( 0 );
+
+  ic = (best / 2 + i) % data.n;
+  return( (best % 2 == 0 ? -(ic+1) : (ic+1)) * sign );
+} /* conect_find_end() */
+
+/*-------------------------------------------------------------------*/
+
+/* conect_find_patch()
+ *
+ * Finds the wire end a new patch centred at (xs, ys, zs) connects to: the
+ * first segment, end 1 before end 2, with an end within its connection
+ * threshold of the centre.  Returns 2*iseg for end 1 of segment iseg,
+ * 2*iseg+1 for its end 2, or -1.  The grid cells are as wide as the
+ * largest threshold, so no nearer end is missed.
+ */
+  static int
+conect_find_patch( seg_grid_t *grid, double xs, double ys, double zs )
+{
+  double xe, ye, ze, slen;
+  int iseg, e, k, nfound, best;
+
+  if( grid == NULL )
+  {
+    for( iseg = 0; iseg < data.n; iseg++ )
+    {
+      slen = calc_connection_threshold(
+          data.segments[iseg].x1, data.segments[iseg].y1, data.segments[iseg].z1,
+          data.segments[iseg].x2, data.segments[iseg].y2, data.segments[iseg].z2 );
+
+      for( e = 0; e < 2; e++ )
+      {
+        seg_end( iseg, e, &xe, &ye, &ze );
+        if( points_would_connect(xe, ye, ze, xs, ys, zs, slen) )
+          return( 2 * iseg + e );
+      }
+    }
+
+    return( -1 );
+  }
+
+  best = -1;
+  nfound = seg_grid_near( grid, xs, ys, zs, grid->size, &grid->found );
+  for( k = 0; k < nfound; k++ )
+  {
+    if( (best >= 0) && (grid->found[k] >= best) )
+      continue;
+
+    iseg = grid->found[k] / 2;
+    slen = calc_connection_threshold(
+        data.segments[iseg].x1, data.segments[iseg].y1, data.segments[iseg].z1,
+        data.segments[iseg].x2, data.segments[iseg].y2, data.segments[iseg].z2 );
+    seg_end( iseg, grid->found[k] % 2, &xe, &ye, &ze );
+    if( points_would_connect(xe, ye, ze, xs, ys, zs, slen) )
+      best = grid->found[k];
+  }
+
+  return( best );
+} /* conect_find_patch() */
+
+/*-------------------------------------------------------------------*/
+
 /* arc generates segment geometry data for an arc of ns segments */
   gboolean
 arc( int itg, int ns, double rada,
@@ -246,7 +547,8 @@ conect( int ignd )
 {
   int i, iz, ic, j, jx, ix, ixx, iseg, iend, jend, jump;
   double sep=0.0, xi1, yi1, zi1, xi2, yi2, zi2;
-  double slen, xa, ya, za, xs, ys, zs;
+  double slen, xa, ya, za;
+  seg_grid_t grid_data, *grid;
 
   /* Pre-allocate connection buffer based on typical wire geometry:
    * Most segments have 2 connections (previous/next), with some
@@ -283,6 +585,12 @@ conect( int ignd )
   {
     mem_array_realloc(&data.segments, (data.n + data.m));
 
+    /* Search the ends near each end, not every segment; ends snapped
+     * to the ground below move by up to their segment's threshold */
+    grid = seg_grid_build( &grid_data ) ? &grid_data : NULL;
+    if( (grid != NULL) && (ignd > 0) )
+      grid->slack = grid->size;
+
     for( i = 0; i < data.n; i++ )
     {
       data.segments[i].icon1 = data.segments[i].icon2 = 0;
@@ -301,6 +609,8 @@ conect( int ignd )
       {
         if( zi1 <= -slen)
         {
+          if( grid != NULL )
+            seg_grid_free( grid );
           pr_err("geometry data error: segment %d extends below ground\n", iz);
           Stop( ERR_OK, _("Geometry data error\n"
                 "Segment extends below ground") );
@@ -318,37 +628,16 @@ conect( int ignd )
       } /* if( ignd > 0) */
 
       if( ! jump )
-      {
-        ic= i;
-        for( j = 1; j < data.n; j++)
-        {
-          ic++;
-          if( ic >= data.n)
-            ic=0;
-
-        if (points_would_connect(xi1, yi1, zi1,
-                               data.segments[ic].x1, data.segments[ic].y1, data.segments[ic].z1,
-                               slen)) {
-          data.segments[i].icon1 = -(ic+1);
-          break;
-        }
-
-        if (points_would_connect(xi1, yi1, zi1,
-                               data.segments[ic].x2, data.segments[ic].y2, data.segments[ic].z2,
-                               slen)) {
-          data.segments[i].icon1 = (ic+1);
-          break;
-        }
-
-      } /* for( j = 1; j < data.n; j++) */
-
-      } /* if( ! jump ) */
+        data.segments[i].icon1 =
+          conect_find_end( grid, i, 0, xi1, yi1, zi1, slen );
 
       /* determine connection data for end 2 of segment. */
       if( (ignd > 0) || jump )
       {
         if( zi2 <= -slen)
         {
+          if( grid != NULL )
+            seg_grid_free( grid );
           pr_err("geometry data error: segment %d extends below ground\n", iz);
           Stop( ERR_OK, _("Geometry data error\n"
                 "Segment extends below ground") );
@@ -359,6 +648,8 @@ conect( int ignd )
         {
           if(data.segments[i].icon1 == iz )
           {
+            if( grid != NULL )
+              seg_grid_free( grid );
             pr_err("geometry data error: segment %d lies in ground plane\n", iz);
             Stop( ERR_OK, _("Geometry data error\n"
                   "Segment lies in ground plane") );
@@ -373,75 +664,46 @@ conect( int ignd )
 
       } /* if( ignd > 0) */
 
-      ic= i;
-      for( j = 1; j < data.n; j++ )
-      {
-        ic++;
-        if( ic >= data.n)
-          ic=0;
-
-        if (points_would_connect(xi2, yi2, zi2,
-                               data.segments[ic].x1, data.segments[ic].y1, data.segments[ic].z1,
-                               slen)) {
-          data.segments[i].icon2 = (ic+1);
-          break;
-        }
-
-        if (points_would_connect(xi2, yi2, zi2,
-                               data.segments[ic].x2, data.segments[ic].y2, data.segments[ic].z2,
-                               slen)) {
-          data.segments[i].icon2 = -(ic+1);
-          break;
-        }
-
-      } /* for( j = 1; j < data.n; j++ ) */
+      data.segments[i].icon2 =
+        conect_find_end( grid, i, 1, xi2, yi2, zi2, slen );
 
     } /* for( i = 0; i < data.n; i++ ) */
 
-    /* find wire-surface connections for new patches */
+    /* find wire-surface connections for new patches,
+     * with the wire ends now settled */
     if( data.m != 0)
     {
+      if( grid != NULL )
+      {
+        seg_grid_free( grid );
+        grid = seg_grid_build( &grid_data ) ? &grid_data : NULL;
+      }
+
       ix = -1;
       i = 0;
       while( ++i <= data.m )
       {
         ix++;
-        xs= data.patches[ix].px;
-        ys= data.patches[ix].py;
-        zs= data.patches[ix].pz;
-
-        for( iseg = 0; iseg < data.n; iseg++ )
-        {
-          xi1= data.segments[iseg].x1;
-          yi1= data.segments[iseg].y1;
-          zi1= data.segments[iseg].z1;
-          xi2= data.segments[iseg].x2;
-          yi2= data.segments[iseg].y2;
-          zi2= data.segments[iseg].z2;
-          slen = calc_connection_threshold(xi1, yi1, zi1, xi2, yi2, zi2);
-
-          /* for first end of segment */
-          /* connection - divide patch into 4 patches at present array loc. */
-          if (points_would_connect(xi1, yi1, zi1, xs, ys, zs, slen)) {
-            data.segments[iseg].icon1=PCHCON+ i;
-            ic=0;
-            subph( i, ic );
-            break;
-          }
-
-          if (points_would_connect(xi2, yi2, zi2, xs, ys, zs, slen)) {
-            data.segments[iseg].icon2=PCHCON+ i;
-            ic=0;
-            subph( i, ic );
-            break;
-          }
+        iseg = conect_find_patch( grid,
+            data.patches[ix].px, data.patches[ix].py, data.patches[ix].pz );
+        if( iseg < 0 )
+          continue;
 
-        } /* for( iseg = 0; iseg < data.n; iseg++ ) */
+        /* connection - divide patch into 4 patches at present array loc. */
+        if( iseg % 2 == 0 )
+          data.segments[iseg / 2].icon1 = PCHCON+ i;
+        else
+          data.segments[iseg / 2].icon2 = PCHCON+ i;
+        ic=0;
+        subph( i, ic );
 
       } /* while( ++i <= data.m ) */
 
     } /* if( data.m != 0) */
 
+    if( grid != NULL )
+      seg_grid_free( grid );
+
   } /* if( data.n != 0) */
 
   iseg=( data.n+ data.m)/( data.np+ data.mp);
@@ -599,6 +861,37 @@ conect( int ignd )
 
 /*-----------------------------------------------------------------------*/
 
+/* geometry_pack_segments()
+ *
+ * Rebuilds the packed observation and connectivity tables from
+ * data.segments[].  Frequency_Scale_Geometry() calls it once the segments
+ * are scaled, so the fill and basis-function loops read current data.
+ */
+  void
+geometry_pack_segments( void )
+{
+  int idx;
+
+  if( mem_array_count(data.obs) != (size_t)data.n )
+  {
+    mem_array_realloc( &data.obs, data.n );
+    mem_array_realloc( &data.con, data.n );
+  }
+
+  for( idx = 0; idx < data.n; idx++ )
+  {
+    const wire_segment_t *sg = &data.segments[idx];
+
+    data.obs[idx] = (wire_obs_t){
+      .x = sg->x, .y = sg->y, .z = sg->z, .bi = sg->bi,
+      .cab = sg->cab, .sab = sg->sab, .salp = sg->salp, .si = sg->si };
+    data.con[idx] = (wire_con_t){ .icon1 = sg->icon1, .icon2 = sg->icon2 };
+  }
+
+} /* geometry_pack_segments() */
+
+/*-----------------------------------------------------------------------*/
+
 /* geometry_data_free()
  *
  * Releases the geometry segment and patch arrays and the segment-connection
@@ -608,6 +901,8 @@ conect( int ignd )
 geometry_data_free( void )
 {
   mem_array_free( &data.segments );
+  mem_array_free( &data.obs );
+  mem_array_free( &data.con );
   mem_array_free( &data.patches );
   mem_array_free( &segj.jco );
   mem_array_free( &segj.ax );
@@ -1430,24 +1725,234 @@ reflc( int ix, int iy, int iz, int iti, int nop )
 
 /*-----------------------------------------------------------------------*/
 
-/* Check if any segments would connect to themselves */
+/* Segments handed to a thread at a time by verify_scan() */
+#define VERIFY_CHUNK  64
+
+/* What the pairwise checks found for one segment.  verify_scan() fills
+ * these for all segments across threads; the checks then report them in
+ * segment order, so the console reads as when they ran one by one. */
+typedef struct
+{
+  double self_sep;      /* End 1 to end 2 distance */
+  double self_slen;     /* Connection threshold */
+  int    overlap_j;     /* First segment too close to this one, or -1 */
+  double overlap_dist;
+  int    short_j;       /* First segment this one is too short beside, or -1 */
+  double seg_len;
+  double other_len;
+} seg_verify_t;
+
+/* Test segment j against segment i for verify_segment_overlaps(); returns
+ * the end 1 distance when they come too close, else a negative value */
+static double
+segment_overlap_distance(int i, int j)
+{
+  /* Check if segments connect at endpoints */
+  double slen = calc_connection_threshold(data.segments[i].x1,
+                                          data.segments[i].y1,
+                                          data.segments[i].z1,
+                                          data.segments[i].x2,
+                                          data.segments[i].y2,
+                                          data.segments[i].z2);
+  if (points_would_connect(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+                           data.segments[j].x1, data.segments[j].y1, data.segments[j].z1, slen) ||
+      points_would_connect(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+                           data.segments[j].x2, data.segments[j].y2, data.segments[j].z2, slen) ||
+      points_would_connect(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
+                           data.segments[j].x1, data.segments[j].y1, data.segments[j].z1, slen) ||
+      points_would_connect(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
+                           data.segments[j].x2, data.segments[j].y2, data.segments[j].z2, slen)) {
+    return -1.0;
+  }
+
+  /* Check if segments are too close along their length */
+  double dx = data.segments[j].x1 - data.segments[i].x1;
+  double dy = data.segments[j].y1 - data.segments[i].y1;
+  double dz = data.segments[j].z1 - data.segments[i].z1;
+  double mid_dist = sqrt(dx*dx + dy*dy + dz*dz);
+  if (mid_dist <= SMIN * mid_dist * 2)
+    return mid_dist;
+
+  return -1.0;
+}
+
+/* Test segment j against segment i of length seg_len for
+ * verify_relative_lengths(): TRUE when i is under 1% of j's length and
+ * close enough to it that connection detection may fail.  Sets *other_len
+ * to the length of j. */
 static gboolean
-verify_self_connections(void)
+segment_too_short_beside(int i, int j, double seg_len, double *other_len)
 {
-  gboolean retval = TRUE;
-  for (int i = 0; i < data.n; i++) {
-    double slen = calc_connection_threshold(data.segments[i].x1,
+  double xj = data.segments[j].x2 - data.segments[j].x1;
+  double yj = data.segments[j].y2 - data.segments[j].y1;
+  double zj = data.segments[j].z2 - data.segments[j].z1;
+  *other_len = sqrt(xj*xj + yj*yj + zj*zj);
+  if (!(seg_len < *other_len * 0.01))
+    return FALSE;
+
+  /* Calculate connection thresholds for both segments */
+  double slen_i = calc_connection_threshold(data.segments[i].x1,
                                             data.segments[i].y1,
                                             data.segments[i].z1,
                                             data.segments[i].x2,
                                             data.segments[i].y2,
                                             data.segments[i].z2);
-    double sep = calc_manhattan_distance(data.segments[i].x1,
-                                         data.segments[i].y1,
-                                         data.segments[i].z1,
-                                         data.segments[i].x2,
-                                         data.segments[i].y2,
-                                         data.segments[i].z2);
+  double slen_j = calc_connection_threshold(data.segments[j].x1,
+                                            data.segments[j].y1,
+                                            data.segments[j].z1,
+                                            data.segments[j].x2,
+                                            data.segments[j].y2,
+                                            data.segments[j].z2);
+  /* Check if any endpoint of segment i is within either threshold of any endpoint of segment j */
+  return (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+                                  data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_i) ||
+         (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+                                  data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_i) ||
+         (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
+                                  data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_i) ||
+         (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
+                                  data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_i) ||
+         (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+                                  data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_j) ||
+         (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
+                                  data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_j) ||
+         (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
+                                  data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_j) ||
+         (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
+                                  data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_j);
+}
+
+/* Run the pairwise checks for segment i.  Each keeps the first segment j
+ * in index order that fails, as a scan of every j finds it; with a grid,
+ * only the j that can fail are tested. */
+static void
+verify_scan_segment(const seg_grid_t *grid, int i, gboolean overlaps,
+                    int **found, seg_verify_t *v)
+{
+  double xi = data.segments[i].x2 - data.segments[i].x1;
+  double yi = data.segments[i].y2 - data.segments[i].y1;
+  double zi = data.segments[i].z2 - data.segments[i].z1;
+  double other_len;
+
+  v->self_slen = calc_connection_threshold(data.segments[i].x1,
+                                           data.segments[i].y1,
+                                           data.segments[i].z1,
+                                           data.segments[i].x2,
+                                           data.segments[i].y2,
+                                           data.segments[i].z2);
+  v->self_sep = calc_manhattan_distance(data.segments[i].x1,
+                                        data.segments[i].y1,
+                                        data.segments[i].z1,
+                                        data.segments[i].x2,
+                                        data.segments[i].y2,
+                                        data.segments[i].z2);
+  v->seg_len = sqrt(xi*xi + yi*yi + zi*zi);
+  v->overlap_j = v->short_j = -1;
+
+  if (grid == NULL) {
+    for (int j = 0; overlaps && j < data.n; j++) {
+      if (i == j) continue;
+
+      v->overlap_dist = segment_overlap_distance(i, j);
+      if (v->overlap_dist >= 0.0) {
+        v->overlap_j = j;
+        break;
+      }
+    }
+
+    for (int j = 0; j < data.n; j++) {
+      if (i == j) continue;
+
+      if (segment_too_short_beside(i, j, v->seg_len, &other_len)) {
+        v->short_j = j;
+        v->other_len = other_len;
+        break;
+      }
+    }
+
+    return;
+  }
+
+  /* The overlap distance test only holds within 2*SMIN of its own
+   * length, which for SMIN < 0.5 is zero: segment j is flagged only when
+   * its end 1 is the end 1 of segment i, so only ends in that cell count */
+  if (overlaps) {
+    int nfound = seg_grid_near(grid, data.segments[i].x1,
+                               data.segments[i].y1, data.segments[i].z1,
+                               0.0, found);
+
+    for (int k = 0; k < nfound; k++) {
+      int j = (*found)[k] / 2;
+      double dist;
+
+      if ((*found)[k] % 2 != 0 || j == i) continue;
+      if (v->overlap_j >= 0 && j >= v->overlap_j) continue;
+
+      dist = segment_overlap_distance(i, j);
+      if (dist >= 0.0) {
+        v->overlap_j = j;
+        v->overlap_dist = dist;
+      }
+    }
+  }
+
+  /* A segment i is too short beside j only near an end of j, within a
+   * threshold no wider than the grid cells */
+  for (int e = 0; e < 2; e++) {
+    double x, y, z;
+    int nfound;
+
+    seg_end(i, e, &x, &y, &z);
+    nfound = seg_grid_near(grid, x, y, z, grid->size, found);
+    for (int k = 0; k < nfound; k++) {
+      int j = (*found)[k] / 2;
+
+      if (j == i) continue;
+      if (v->short_j >= 0 && j >= v->short_j) continue;
+
+      if (segment_too_short_beside(i, j, v->seg_len, &other_len)) {
+        v->short_j = j;
+        v->other_len = other_len;
+      }
+    }
+  }
+}
+
+/* Run the pairwise checks for every segment, in chunks across threads */
+static void
+verify_scan(seg_verify_t *v, gboolean overlaps)
+{
+  seg_grid_t grid_data, *grid;
+
+  grid = seg_grid_build(&grid_data) ? &grid_data : NULL;
+
+#ifdef HAVE_OPENMP
+  #pragma omp parallel num_threads(xnec2c_threads_per_worker(1))
+#endif
+  {
+    int *found = NULL;
+
+#ifdef HAVE_OPENMP
+    #pragma omp for schedule(dynamic, VERIFY_CHUNK)
+#endif
+    for (int i = 0; i < data.n; i++)
+      verify_scan_segment(grid, i, overlaps, &found, &v[i]);
+
+    mem_array_free(&found);
+  }
+
+  if (grid != NULL)
+    seg_grid_free(grid);
+}
+
+/* Check if any segments would connect to themselves */
+static gboolean
+verify_self_connections(const seg_verify_t *v)
+{
+  gboolean retval = TRUE;
+  for (int i = 0; i < data.n; i++) {
+    double slen = v[i].self_slen;
+    double sep = v[i].self_sep;
     if (sep <= slen) {
       static int last_tag = -1;
       static int msg_count = 0;
@@ -1473,57 +1978,31 @@ verify_self_connections(void)
 
 /* Check for segments that are too close or overlapping */
 static gboolean
-verify_segment_overlaps(void)
+verify_segment_overlaps(const seg_verify_t *v)
 {
   gboolean retval = TRUE;
   for (int i = 0; i < data.n; i++) {
-    for (int j = 0; j < data.n; j++) {
-      if (i == j) continue;
-      
-      /* Check if segments connect at endpoints */
-      double slen = calc_connection_threshold(data.segments[i].x1,
-                                              data.segments[i].y1,
-                                              data.segments[i].z1,
-                                              data.segments[i].x2,
-                                              data.segments[i].y2,
-                                              data.segments[i].z2);
-      if (points_would_connect(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
-                               data.segments[j].x1, data.segments[j].y1, data.segments[j].z1, slen) ||
-          points_would_connect(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
-                               data.segments[j].x2, data.segments[j].y2, data.segments[j].z2, slen) ||
-          points_would_connect(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
-                               data.segments[j].x1, data.segments[j].y1, data.segments[j].z1, slen) ||
-          points_would_connect(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
-                               data.segments[j].x2, data.segments[j].y2, data.segments[j].z2, slen)) {
-        continue;
+    int j = v[i].overlap_j;
+    double mid_dist = v[i].overlap_dist;
+    if (j >= 0) {
+      static int last_tag = -1;
+      static int msg_count = 0;
+      if (data.segments[i].itag != last_tag) {
+        last_tag = data.segments[i].itag;
+        msg_count = 0;
       }
-
-      /* Check if segments are too close along their length */
-      double dx = data.segments[j].x1 - data.segments[i].x1;
-      double dy = data.segments[j].y1 - data.segments[i].y1;
-      double dz = data.segments[j].z1 - data.segments[i].z1;
-      double mid_dist = sqrt(dx*dx + dy*dy + dz*dz);
-      if (mid_dist <= SMIN * mid_dist * 2) {
-        static int last_tag = -1;
-        static int msg_count = 0;
-        if (data.segments[i].itag != last_tag) {
-          last_tag = data.segments[i].itag;
-          msg_count = 0;
+        if (msg_count < 3) {
+          pr_warn("tag=%d/seg=%d: distance=%.3e to tag=%d/seg=%d closer than 2x connection threshold %.3e; unintended connections possible\n",
+            data.segments[i].itag, i+1, mid_dist, data.segments[j].itag,
+            j+1, SMIN * mid_dist * 2);
+          msg_count++;
         }
-          if (msg_count < 3) {
-            pr_warn("tag=%d/seg=%d: distance=%.3e to tag=%d/seg=%d closer than 2x connection threshold %.3e; unintended connections possible\n",
-              data.segments[i].itag, i+1, mid_dist, data.segments[j].itag,
-              j+1, SMIN * mid_dist * 2);
-            msg_count++;
-          }
-          else if (msg_count == 3) {
-            pr_warn("tag=%d: suppressing additional overlap warnings\n",
-                    data.segments[i].itag);
-            msg_count++;
-          }
-        retval = FALSE;
-        break;
-      }
+        else if (msg_count == 3) {
+          pr_warn("tag=%d: suppressing additional overlap warnings\n",
+                  data.segments[i].itag);
+          msg_count++;
+        }
+      retval = FALSE;
     }
   }
   return retval;
@@ -1531,75 +2010,30 @@ verify_segment_overlaps(void)
 
 /* Check for segments with very different lengths that could cause connection issues */
 static gboolean
-verify_relative_lengths(void)
+verify_relative_lengths(const seg_verify_t *v)
 {
   gboolean retval = TRUE;
   for (int i = 0; i < data.n; i++) {
-    double xi = data.segments[i].x2 - data.segments[i].x1;
-    double yi = data.segments[i].y2 - data.segments[i].y1;
-    double zi = data.segments[i].z2 - data.segments[i].z1;
-    double seg_len = sqrt(xi*xi + yi*yi + zi*zi);
-    
-    for (int j = 0; j < data.n; j++) {
-      if (i == j) continue;
-      double xj = data.segments[j].x2 - data.segments[j].x1;
-      double yj = data.segments[j].y2 - data.segments[j].y1;
-      double zj = data.segments[j].z2 - data.segments[j].z1;
-      double other_len = sqrt(xj*xj + yj*yj + zj*zj);
-      if (seg_len < other_len * 0.01) {
-        /* Calculate connection thresholds for both segments */
-        double slen_i = calc_connection_threshold(data.segments[i].x1,
-                                                  data.segments[i].y1,
-                                                  data.segments[i].z1,
-                                                  data.segments[i].x2,
-                                                  data.segments[i].y2,
-                                                  data.segments[i].z2);
-        double slen_j = calc_connection_threshold(data.segments[j].x1,
-                                                  data.segments[j].y1,
-                                                  data.segments[j].z1,
-                                                  data.segments[j].x2,
-                                                  data.segments[j].y2,
-                                                  data.segments[j].z2);
-        
-        /* Check if any endpoint of segment i is within either threshold of any endpoint of segment j */
-        if ((calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
-                                     data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_i) ||
-            (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
-                                     data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_i) ||
-            (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
-                                     data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_i) ||
-            (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
-                                     data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_i) ||
-            (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
-                                     data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_j) ||
-            (calc_manhattan_distance(data.segments[i].x1, data.segments[i].y1, data.segments[i].z1,
-                                     data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_j) ||
-            (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
-                                     data.segments[j].x1, data.segments[j].y1, data.segments[j].z1) <= slen_j) ||
-            (calc_manhattan_distance(data.segments[i].x2, data.segments[i].y2, data.segments[i].z2,
-                                     data.segments[j].x2, data.segments[j].y2, data.segments[j].z2) <= slen_j)) {
-          
-          static int last_tag = -1;
-          static int msg_count = 0;
-          if (data.segments[i].itag != last_tag) {
-            last_tag = data.segments[i].itag;
-            msg_count = 0;
-          }
-          if (msg_count < 3) {
-            pr_warn("tag=%d/seg=%d: length=%.3e is too short (and close enough) to tag=%d/seg=%d length=%.3e that connection detection may fail or short\n",
-              data.segments[i].itag, i+1, seg_len, data.segments[j].itag, j+1,
-              other_len);
-            msg_count++;
-          }
-          else if (msg_count == 3) {
-            pr_warn("tag=%d: suppressing additional connection detection may fail or short warnings\n",
-                    data.segments[i].itag);
-            msg_count++;
-          }
-          retval = FALSE;
-          break;
-        }
+    int j = v[i].short_j;
+    if (j >= 0) {
+      static int last_tag = -1;
+      static int msg_count = 0;
+      if (data.segments[i].itag != last_tag) {
+        last_tag = data.segments[i].itag;
+        msg_count = 0;
+      }
+      if (msg_count < 3) {
+        pr_warn("tag=%d/seg=%d: length=%.3e is too short (and close enough) to tag=%d/seg=%d length=%.3e that connection detection may fail or short\n",
+          data.segments[i].itag, i+1, v[i].seg_len, data.segments[j].itag, j+1,
+          v[i].other_len);
+        msg_count++;
       }
+      else if (msg_count == 3) {
+        pr_warn("tag=%d: suppressing additional connection detection may fail or short warnings\n",
+                data.segments[i].itag);
+        msg_count++;
+      }
+      retval = FALSE;
     }
   }
   return retval;
@@ -1773,41 +2207,99 @@ verify_kernel_limits(void)
   return retval;
 }
 
-/* Main verification function that calls individual test functions */
+/* Result of the last verification and a digest of everything it read */
+#define VERIFY_SIG_LEN  32
+static guint8   verify_sig[VERIFY_SIG_LEN];
+static gboolean verify_sig_valid = FALSE;
+static gboolean verify_result;
+
+/* Hashes the inputs of the checks: the segment ends, radii and tags, the
+ * kernel, which checks run and the wavelength they compare against */
+static void
+verify_hash(guint8 *sig, gboolean overlaps, double wavelength)
+{
+  GChecksum *sum = g_checksum_new(G_CHECKSUM_SHA256);
+  gsize len = VERIFY_SIG_LEN;
+
+  int ihdr[] = { data.n, calc_data.iexk, overlaps, calc_data.FR_cards > 0 };
+  g_checksum_update(sum, (const guchar *)ihdr, sizeof(ihdr));
+  g_checksum_update(sum, (const guchar *)&wavelength, sizeof(wavelength));
+
+  for (int i = 0; i < data.n; i++) {
+    double seg[] = { data.segments[i].x1, data.segments[i].y1,
+                     data.segments[i].z1, data.segments[i].x2,
+                     data.segments[i].y2, data.segments[i].z2,
+                     data.segments[i].bi };
+    g_checksum_update(sum, (const guchar *)seg, sizeof(seg));
+    g_checksum_update(sum, (const guchar *)&data.segments[i].itag,
+                      sizeof(data.segments[i].itag));
+  }
+
+  g_checksum_get_digest(sum, sig, &len);
+  g_checksum_free(sum);
+}
+
+/* Main verification function that calls individual test functions.
+ * A geometry already verified as it stands returns the same result
+ * without running the checks again, unless --force-verify is given. */
   gboolean verify_segments(void)
 {
   gboolean retval = TRUE;
-  retval &= verify_self_connections();
+  gboolean overlaps;
+  guint8 sig[VERIFY_SIG_LEN];
+  seg_verify_t *v = NULL;
 
-  if (data.n > SEGMENT_OVERLAP_THRESHOLD && !rc_config.force_verify_segments) {
+  overlaps = (data.n <= SEGMENT_OVERLAP_THRESHOLD || rc_config.force_verify_segments);
+
+  /* Get shortest wavelength from highest frequency */
+  double wavelength = CVEL;
+  for (int i = 0; i < calc_data.FR_cards; i++) {
+    double max_freq = calc_data.freq_loop_data[i].max_freq;
+    if (max_freq > 0.0)
+      wavelength = fmin(wavelength, CVEL/(max_freq * 1e6));
+  }
+
+  verify_hash(sig, overlaps, wavelength);
+  if (verify_sig_valid && !rc_config.force_verify_segments &&
+      memcmp(sig, verify_sig, sizeof(sig)) == 0) {
+    pr_info("verify_segments() geometry unchanged since last verified; %s\n",
+            verify_result ? "passed" : "see the warnings reported then");
+    return verify_result;
+  }
+
+  if (data.n > 0) {
+    mem_array_alloc(&v, data.n);
+    verify_scan(v, overlaps);
+  }
+
+  retval &= verify_self_connections(v);
+
+  if (!overlaps) {
     pr_warn("Skipping overlap check for %d segments (use --force-verify to enable)\n", data.n);
   }
   else {
     if (data.n > SEGMENT_OVERLAP_THRESHOLD && rc_config.force_verify_segments) {
       pr_info("Forcing overlap check for %d segments\n", data.n);
     }
-    retval &= verify_segment_overlaps();
+    retval &= verify_segment_overlaps(v);
   }
 
-  retval &= verify_relative_lengths();
+  retval &= verify_relative_lengths(v);
+  mem_array_free(&v);
 
   /* Check kernel limits - independent of frequency */
   retval &= verify_kernel_limits();
 
   if (calc_data.FR_cards == 0) {
     pr_debug("verify_segments() skipping frequency-dependent checks - no frequency data\n");
-    return retval;
   }
-
-  /* Get shortest wavelength from highest frequency */
-  double wavelength = CVEL;
-  for (int i = 0; i < calc_data.FR_cards; i++) {
-    double max_freq = calc_data.freq_loop_data[i].max_freq;
-    if (max_freq > 0.0)
-      wavelength = fmin(wavelength, CVEL/(max_freq * 1e6));
+  else {
+    retval &= verify_wavelength_limits(wavelength);
   }
 
-  retval &= verify_wavelength_limits(wavelength);
+  memcpy(verify_sig, sig, sizeof(verify_sig));
+  verify_sig_valid = TRUE;
+  verify_result = retval;
 
   return retval;
 }
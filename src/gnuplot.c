@@ -22,6 +22,8 @@
 #include "prerender/prerender_state.h"
 #include "chroma/chroma_nearfield.h"
 #include "touchstone.h"
+#include "fmt_double.h"
+#include "npy.h"
 
 /*-----------------------------------------------------------------------*/
 
@@ -70,16 +72,135 @@ void Save_FreqPlots_Gnuplot_Data(char *filename)
 }
 
 
-static void Save_FreqPlots_Touchstone(char *filename, touchstone_type_t type)
+/*-----------------------------------------------------------------------*/
+
+/* Row writers of the sweep files.  Each writes the header of its file, or
+ * the rows of one frequency step, so the Save_* functions below can run
+ * them over a completed sweep and the optimizer can stream them as steps
+ * complete (optimizer_stream_steps()).  The caller holds freq_data_lock
+ * and selects the C numeric locale. */
+
+static void freqplots_touchstone_header(FILE *fp, int type)
 {
-	FILE *fp = NULL;
+	const touchstone_layout_t *layout = &touchstone_layouts[type];
 	time_t rawtime;
 	struct tm *info;
 	char buffer[80];
-	int idx;
 
+	time( &rawtime );
+	info = localtime( &rawtime );
+	strftime(buffer, sizeof(buffer)-1, "%c (%F %H:%M:%S)", info);
+
+	fprintf(fp, "! %s - %s\n", rc_config.input_file, buffer);
+	fprintf(fp, _("! Reference impedance Z0 = %.2f Ohm\n"), calc_data.zo);
+	fprintf(fp, "!\n");
+
+	fprintf(fp, "%s", layout->comment);
+	fprintf(fp, "# MHz S DB R %g\n", calc_data.zo);
+}
+
+static void freqplots_touchstone_step(FILE *fp, int fstep, int type)
+{
+	measurement_t meas;
+
+	meas_calc(&meas, fstep, calc_data.ex_port);
+	meas_write_format(&meas, touchstone_layouts[type].format, fp);
+}
+
+static void freqplots_csv_header(FILE *fp, int arg)
+{
+	meas_write_header(fp, ",");
+}
+
+static void freqplots_csv_step(FILE *fp, int fstep, int arg)
+{
 	measurement_t meas;
 
+	meas_calc(&meas, fstep, calc_data.ex_port);
+	meas_write_row(fp, ",", &meas, NULL, MEAS_COUNT);
+}
+
+static void radpattern_csv_header(FILE *fp, int arg)
+{
+	fprintf(fp, "mhz,phi,theta,gain_total,gain_horiz,gain_vert,gain_rhcp,gain_lhcp\n");
+}
+
+static void radpattern_csv_step(FILE *fp, int fstep, int arg)
+{
+	/* mhz, phi, theta and NUM_POL gains, with delimiters */
+	char line[(3 + NUM_POL) * (FMT_G17_LEN + 1) + 1];
+	char *o;
+	int mhz_len, idx, nph, nth, pol;
+	double theta, phi, r;
+
+	/* theta and phi step in rads */
+	double dth = (double)fpat.dth * (double)TORAD;
+	double dph = (double)fpat.dph * (double)TORAD;
+
+	if (isFlagClear(ENABLE_RDPAT))
+		return;
+
+	/* Every row of the step starts with its frequency */
+	mhz_len = snprintf(line, FMT_G17_LEN, "%.6f,", save.freq[fstep]);
+
+	// Step phi angle
+	idx = 0;
+	phi = (double)fpat.phis * (double)TORAD; // In rads
+
+	for (nph = 0; nph < fpat.nph; nph++)
+	{
+		theta = (double) fpat.thets * (double) TORAD;	// In rads
+
+		// Step theta angle
+		for (nth = 0; nth < fpat.nth; nth++)
+		{
+			// Distance of pattern point from the xyz origin
+			r = rad_pattern[fstep].gtot[idx];
+
+			// mhz,phi,theta
+			o = line + mhz_len;
+			o += fmt_g17(o, phi * TODEG);
+			*o++ = ',';
+			o += fmt_g17(o, theta * TODEG);
+
+			// POL_TOTAL, POL_HORIZ, POL_VERT, POL_RHCP, POL_LHCP
+			for (pol = 0; pol < NUM_POL; pol++)
+			{
+				*o++ = ',';
+				o += fmt_g17(o, r + Polarization_Factor(pol, fstep, idx));
+			}
+			*o++ = '\n';
+
+			fwrite(line, 1, o - line, fp);
+
+			// Step theta in rads
+			theta += dth;
+			idx++;
+		} // for( nth = 0; nth < fpat.nth; nth++ )
+
+		// Step phi in rads
+		phi += dph;
+	} // for( nph = 0; nph < fpat.nph; nph++ )
+}
+
+const sweep_writer_t sweep_writer_csv =
+	{ freqplots_csv_header, freqplots_csv_step, 0, FALSE };
+const sweep_writer_t sweep_writer_s1p =
+	{ freqplots_touchstone_header, freqplots_touchstone_step, TOUCHSTONE_S1P, TRUE };
+const sweep_writer_t sweep_writer_s2p_max_gain =
+	{ freqplots_touchstone_header, freqplots_touchstone_step, TOUCHSTONE_S2P_MAXGAIN, TRUE };
+const sweep_writer_t sweep_writer_s2p_viewer_gain =
+	{ freqplots_touchstone_header, freqplots_touchstone_step, TOUCHSTONE_S2P_VIEWERGAIN, TRUE };
+const sweep_writer_t sweep_writer_rdpat =
+	{ radpattern_csv_header, radpattern_csv_step, 0, FALSE };
+
+/*-----------------------------------------------------------------------*/
+
+static void Save_FreqPlots_Touchstone(char *filename, touchstone_type_t type)
+{
+	FILE *fp = NULL;
+	int idx;
+
 	if (type < 0 || type >= TOUCHSTONE_COUNT)
 	{
 		BUG("This should never happen. touchstone type=%d\n", type);
@@ -104,30 +225,15 @@ static void Save_FreqPlots_Touchstone(char *filename, touchstone_type_t type)
 		return;
 	}
 
-	const touchstone_layout_t *layout = &touchstone_layouts[type];
-
 	// Open gplot file, abort on error
 	if (!Open_File(&fp, filename, "w"))
 		return;
 	setlocale(LC_NUMERIC, "C");
 
-	time( &rawtime );
-	info = localtime( &rawtime );
-	strftime(buffer, sizeof(buffer)-1, "%c (%F %H:%M:%S)", info);
-
-	fprintf(fp, "! %s - %s\n", rc_config.input_file, buffer);
-	fprintf(fp, _("! Reference impedance Z0 = %.2f Ohm\n"), calc_data.zo);
-	fprintf(fp, "!\n");
-
-	fprintf(fp, "%s", layout->comment);
-	fprintf(fp, "# MHz S DB R %g\n", calc_data.zo);
-
 	g_rec_mutex_lock(&freq_data_lock);
+	freqplots_touchstone_header(fp, type);
 	for (idx = 0; idx < calc_data.steps_total; idx++)
-	{
-		meas_calc(&meas, idx, calc_data.ex_port);
-		meas_write_format(&meas, layout->format, fp);
-	}
+		freqplots_touchstone_step(fp, idx, type);
 	g_rec_mutex_unlock(&freq_data_lock);
 
 	fclose(fp);
@@ -154,6 +260,7 @@ void Save_FreqPlots_CSV(char *filename)
 {
 	/* Open Optimizer csv file */
 	FILE *fp = NULL;
+	int idx;
 
 	// Abort if plot data not available
 	if (!freq_sweep_complete())
@@ -166,8 +273,9 @@ void Save_FreqPlots_CSV(char *filename)
 		return;
 
 	g_rec_mutex_lock(&freq_data_lock);
-	meas_write_header(fp, ",");
-	meas_write_data(fp, ",");
+	freqplots_csv_header(fp, 0);
+	for (idx = 0; idx < calc_data.steps_total; idx++)
+		freqplots_csv_step(fp, idx, 0);
 	g_rec_mutex_unlock(&freq_data_lock);
 
 	fclose(fp);
@@ -416,66 +524,20 @@ Save_RadPattern_Gnuplot_Data( char *filename )
 void Save_RadPattern_CSV(char *filename)
 {
 	FILE *fp = NULL;
+	int calc_idx;
 
 	if (!Open_File(&fp, filename, "w"))
 		return;
 
-	fprintf(fp, "mhz,phi,theta,gain_total,gain_horiz,gain_vert,gain_rhcp,gain_lhcp\n");
-
 	setlocale(LC_NUMERIC, "C");
-	// Distance of rdpattern point nearest to xyz origin
-	// Convert radiation pattern values to points in 3 d space in x, y, z axis
-
-	double theta, phi, r;
-
-    /* theta and phi step in rads */
-    double dth = (double)fpat.dth * (double)TORAD;
-    double dph = (double)fpat.dph * (double)TORAD;
-
-	int calc_idx, idx, nph, nth, pol;
 
 	g_rec_mutex_lock(&freq_data_lock);
-	if (isFlagSet(ENABLE_RDPAT) && (calc_data.freq_step >= 0))
+	radpattern_csv_header(fp, 0);
+	if (calc_data.freq_step >= 0)
 	{
 		for (calc_idx = 0; calc_idx < calc_data.steps_total; calc_idx++)
-		{
-			// Step phi angle
-			idx = 0;
-			phi = (double)fpat.phis * (double)TORAD; // In rads
-
-			for (nph = 0; nph < fpat.nph; nph++)
-			{
-				theta = (double) fpat.thets * (double) TORAD;	// In rads
-
-				// Step theta angle
-				for (nth = 0; nth < fpat.nth; nth++)
-				{
-					// Distance of pattern point from the xyz origin
-					r = rad_pattern[calc_idx].gtot[idx];
-
-					// mhz,phi,theta
-					fprintf(fp, "%.6f,%.17g,%.17g,",
-						save.freq[calc_idx],
-						phi * TODEG,
-						theta * TODEG);
-
-					// POL_TOTAL, POL_HORIZ, POL_VERT, POL_RHCP, POL_LHCP
-					for (pol = 0; pol < NUM_POL; pol++)
-						fprintf(fp, "%.17g%s", 
-							r + Polarization_Factor(pol, calc_idx, idx),
-							(pol == NUM_POL-1 ? "\n" : ",")
-							);
-
-					// Step theta in rads
-					theta += dth;
-					idx++;
-				} // for( nth = 0; nth < fpat.nth; nth++ )
-
-				// Step phi in rads
-				phi += dph;
-			} // for( nph = 0; nph < fpat.nph; nph++ )
-		}
-	} // if( isFlagSet(ENABLE_RDPAT) && (calc_data.freq_step >= 0) )
+			radpattern_csv_step(fp, calc_idx, 0);
+	}
 	g_rec_mutex_unlock(&freq_data_lock);
 
 	setlocale(LC_NUMERIC, orig_numeric_locale);
@@ -600,34 +662,44 @@ void Save_Currents_CSV(char *filename)
 		"charge_real,charge_imag,charge_mag,"     // Charge in Coulombs
 		"x1,y1,z1,x2,y2,z2\n");
 
-	int idx;
+	/* mhz,seg,tag, then 12 values, with delimiters */
+	char line[3 * FMT_G17_LEN + 12 * (FMT_G17_LEN + 1) + 1];
+	char *o;
+	double vals[12];
+	int idx, v;
 	double wavelength = data.wlam;
 	double charge_scale = 1.0E-6 / calc_data.freq_mhz;
 
 	for (idx = 0; idx < data.n; idx++)
 	{
-		fprintf(fp, "%.6f,%d,%d,"
-			"%.17g,%.17g,%.17g,"  // Current (A)
-			"%.17g,%.17g,%.17g,"  // Charge (C)
-			"%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
-			calc_data.freq_mhz,
-			idx+1, data.segments[idx].itag,
-
-			// Currents
-			creal(cf->cur[idx]) * wavelength,
-			cimag(cf->cur[idx]) * wavelength,
-			cabs(cf->cur[idx]) * wavelength,
-
-			// Charges
-			cf->bir[idx] * charge_scale,
-			cf->bii[idx] * charge_scale,
-			cabs(cmplx(cf->bir[idx], cf->bii[idx])) * charge_scale,
-
-			// Segment endpoints
-			data.segments[idx].x1, data.segments[idx].y1,
-			data.segments[idx].z1,
-			data.segments[idx].x2, data.segments[idx].y2,
-			data.segments[idx].z2);
+		// Currents
+		vals[0] = creal(cf->cur[idx]) * wavelength;
+		vals[1] = cimag(cf->cur[idx]) * wavelength;
+		vals[2] = cabs(cf->cur[idx]) * wavelength;
+
+		// Charges
+		vals[3] = cf->bir[idx] * charge_scale;
+		vals[4] = cf->bii[idx] * charge_scale;
+		vals[5] = cabs(cmplx(cf->bir[idx], cf->bii[idx])) * charge_scale;
+
+		// Segment endpoints
+		vals[6]  = data.segments[idx].x1;
+		vals[7]  = data.segments[idx].y1;
+		vals[8]  = data.segments[idx].z1;
+		vals[9]  = data.segments[idx].x2;
+		vals[10] = data.segments[idx].y2;
+		vals[11] = data.segments[idx].z2;
+
+		o = line + snprintf(line, 3 * FMT_G17_LEN, "%.6f,%d,%d",
+			calc_data.freq_mhz, idx+1, data.segments[idx].itag);
+		for (v = 0; v < 12; v++)
+		{
+			*o++ = ',';
+			o += fmt_g17(o, vals[v]);
+		}
+		*o++ = '\n';
+
+		fwrite(line, 1, o - line, fp);
 	}
 
 	setlocale(LC_NUMERIC, orig_numeric_locale);
@@ -712,3 +784,139 @@ void Save_Patch_Currents_CSV(char *filename)
 	setlocale(LC_NUMERIC, orig_numeric_locale);
 	fclose(fp);
 }
+
+/*-----------------------------------------------------------------------*/
+
+/* Writes n values to a .npy file, FALSE on a short write */
+static gboolean npy_put(FILE *fp, const void *p, size_t size, size_t n)
+{
+	return fwrite(p, size, n, fp) == n;
+}
+
+/* TRUE if step fstep has a solved radiation pattern */
+static gboolean rdpat_npy_step(int fstep)
+{
+	return isFlagSet(ENABLE_RDPAT)
+		&& save.fstep != NULL && save.fstep[fstep]
+		&& RDPAT_FSTEP_AVAILABLE(fstep);
+}
+
+/* Save_RadPattern_NPY()
+ *
+ * Saves the radiation pattern of every solved step as a .npy array of one
+ * record per step: mhz, then gtot, tilt, axrt and sens as (nph, nth)
+ * sub-arrays in the phi-major order of the rad_pattern buffers
+ */
+void Save_RadPattern_NPY(char *filename)
+{
+	FILE *fp = NULL;
+	char descr[NPY_DESCR_LEN] = "";
+	char int_type[8];
+	int dims[2] = { fpat.nph, fpat.nth };
+	size_t nrec = (size_t)fpat.nph * (size_t)fpat.nth;
+	gboolean ok = TRUE;
+	long rows = 0;
+	int fstep;
+
+	snprintf(int_type, sizeof(int_type), "i%d", (int)sizeof(int));
+	if (npy_descr_field(descr, "mhz", "f8", NULL, 0) < 0
+		|| npy_descr_field(descr, "gtot", "f8", dims, 2) < 0
+		|| npy_descr_field(descr, "tilt", "f8", dims, 2) < 0
+		|| npy_descr_field(descr, "axrt", "f8", dims, 2) < 0
+		|| npy_descr_field(descr, "sens", int_type, dims, 2) < 0)
+	{
+		BUG("Save_RadPattern_NPY: dtype descriptor overflow\n");
+		return;
+	}
+
+	if (!Open_File(&fp, filename, "w"))
+		return;
+
+	g_rec_mutex_lock(&freq_data_lock);
+
+	/* The header carries the row count, so count the solved steps first */
+	for (fstep = 0; fstep < calc_data.steps_total; fstep++)
+		if (rdpat_npy_step(fstep))
+			rows++;
+
+	ok = (npy_write_header(fp, descr, rows) >= 0);
+
+	/* Each buffer goes out in one write, so a record is a few large
+	 * sequential writes however fine the pattern grid */
+	for (fstep = 0; ok && fstep < calc_data.steps_total; fstep++)
+	{
+		rad_pattern_t *rp;
+
+		if (!rdpat_npy_step(fstep))
+			continue;
+
+		rp = &rad_pattern[fstep];
+		ok = npy_put(fp, &save.freq[fstep], sizeof(double), 1)
+			&& npy_put(fp, rp->gtot, sizeof(double), nrec)
+			&& npy_put(fp, rp->tilt, sizeof(double), nrec)
+			&& npy_put(fp, rp->axrt, sizeof(double), nrec)
+			&& npy_put(fp, rp->sens, sizeof(int), nrec);
+	}
+
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	if (fclose(fp) != 0)
+		ok = FALSE;
+	if (!ok)
+		pr_err("Save_RadPattern_NPY: %s: %s\n", filename, strerror(errno));
+}
+
+/*-----------------------------------------------------------------------*/
+
+/* Save_Currents_NPY()
+ *
+ * Saves the currents of every solved step as a .npy array of one record
+ * per step: mhz, then cur, the n wire segment amplitudes per wavelength
+ * followed by the x, y and z components of each of the m patches
+ */
+void Save_Currents_NPY(char *filename)
+{
+	FILE *fp = NULL;
+	char descr[NPY_DESCR_LEN] = "";
+	int dims[1] = { data.np3m };
+	gboolean ok = TRUE;
+	long rows = 0;
+	int fstep;
+
+	if (npy_descr_field(descr, "mhz", "f8", NULL, 0) < 0
+		|| npy_descr_field(descr, "cur", "c16", dims, 1) < 0)
+	{
+		BUG("Save_Currents_NPY: dtype descriptor overflow\n");
+		return;
+	}
+
+	if (!Open_File(&fp, filename, "w"))
+		return;
+
+	g_rec_mutex_lock(&freq_data_lock);
+
+	for (fstep = 0; fstep < calc_data.steps_total; fstep++)
+		if (CRNT_FSTEP_AVAILABLE(fstep))
+			rows++;
+
+	if (rows == 0)
+		pr_warn("Save_Currents_NPY: no current data; enable \"Currents\" or \"Charges\"\n");
+
+	ok = (npy_write_header(fp, descr, rows) >= 0);
+
+	for (fstep = 0; ok && fstep < calc_data.steps_total; fstep++)
+	{
+		if (!CRNT_FSTEP_AVAILABLE(fstep))
+			continue;
+
+		ok = npy_put(fp, &save.freq[fstep], sizeof(double), 1)
+			&& npy_put(fp, crnt_fstep[fstep].cur, sizeof(complex double), data.np3m);
+	}
+
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	if (fclose(fp) != 0)
+		ok = FALSE;
+	if (!ok)
+		pr_err("Save_Currents_NPY: %s: %s\n", filename, strerror(errno));
+}
@@ -22,5 +22,28 @@
 
 #include "common.h"
 
+/* Writer of a file holding every step of a sweep, one step at a time.
+ *
+ * @header: writes the lines ahead of the first step
+ * @step:   writes the rows of one frequency step
+ * @arg:    passed to both, selecting a variant of the file
+ * @needs_impedance: the rows derive from the feedpoint impedance
+ *
+ * Both run under freq_data_lock in the C numeric locale.
+ */
+typedef struct
+{
+	void (*header)(FILE *fp, int arg);
+	void (*step)(FILE *fp, int fstep, int arg);
+	int arg;
+	int needs_impedance;
+} sweep_writer_t;
+
+extern const sweep_writer_t sweep_writer_csv;
+extern const sweep_writer_t sweep_writer_s1p;
+extern const sweep_writer_t sweep_writer_s2p_max_gain;
+extern const sweep_writer_t sweep_writer_s2p_viewer_gain;
+extern const sweep_writer_t sweep_writer_rdpat;
+
 #endif
 
@@ -58,7 +58,20 @@
 // For use if you need to pr_debug based on line number in readgm()
 static int readgm_line_count = 0;
 
+/* .sy override text staged by Set_Input_Overrides(), or NULL */
+static const char *input_sy_text = NULL;
+
+/* Geometry section of the last successful parse.  The next parse keeps the
+ * segments, patches and connection data it built when the same card lines
+ * come back and no field among them reads a symbol whose value changed. */
+static GPtrArray  *geom_cards   = NULL;  /* Card lines as read, GE last */
+static GHashTable *geom_symbols = NULL;  /* Symbol values after the section */
+
+/* Card lines read by readgm() while datagn() builds the geometry */
+static GPtrArray  *geom_record  = NULL;
+
 /* Forward declarations for internal helper functions */
+static void geometry_cache_free(void);
 static gboolean parse_sy_card(const char *line_content);
 static gboolean validate_card_characters(const char *line_buf, int start_idx, int len, const char *card_type);
 static gboolean parse_field_with_expression(const char **line_ptr, char **endptr, double *result,
@@ -118,6 +131,8 @@ input_data_free( void )
 
   mem_array_free( &smat.ssx );
 
+  geometry_cache_free();
+
 } /* input_data_free() */
 
 /*------------------------------------------------------------------------*/
@@ -756,7 +771,7 @@ datagn( void )
         {
           if( !verify_segments() )
           {
-            if( isFlagClear(SUPPRESS_INTERMEDIATE_REDRAWS) )
+            if( isFlagClear(SUPPRESS_INTERMEDIATE_REDRAWS | HEADLESS_EVAL) )
             {
               Notice( GTK_BUTTONS_OK, _("Probable invalid segment geometry.\n"),
                     _("Invalid segment geometry.\n"
@@ -1034,6 +1049,388 @@ datagn( void )
 
 /*-----------------------------------------------------------------------*/
 
+/* Set_Input_Overrides()
+ *
+ * Stages .sy override text for the next Read_Geometry() in place of the
+ * companion .sy file; NULL restores the file.  The caller keeps the text
+ * alive until the parse returns.
+ */
+  void
+Set_Input_Overrides( const char *text )
+{
+  input_sy_text = text;
+
+} /* Set_Input_Overrides() */
+
+/*-----------------------------------------------------------------------*/
+
+/* input_load_overrides()
+ *
+ * Loads symbol overrides staged in memory, else from the .sy file
+ */
+  static void
+input_load_overrides( void )
+{
+  char sy_path[FILENAME_LEN];
+
+  if( input_sy_text != NULL )
+    sy_load_overrides_text( input_sy_text );
+  else if( build_companion_path(rc_config.input_file, ".sy",
+        sy_path, sizeof(sy_path)) )
+  {
+    sy_load_overrides(sy_path);
+  }
+
+} /* input_load_overrides() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_cache_free()
+ *
+ * Forgets the geometry section of the last parse, so the next
+ * Read_Geometry() builds the geometry from its cards
+ */
+  static void
+geometry_cache_free( void )
+{
+  if( geom_cards != NULL )
+    g_ptr_array_free( geom_cards, TRUE );
+  geom_cards = NULL;
+
+  if( geom_symbols != NULL )
+    g_hash_table_destroy( geom_symbols );
+  geom_symbols = NULL;
+
+} /* geometry_cache_free() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_card_text()
+ *
+ * Copies a geometry card line as readgm() sees it: mnemonic in upper
+ * case, inline comment dropped
+ */
+  static void
+geometry_card_text( char *card, const char *line, size_t size )
+{
+  Strlcpy( card, line, size );
+  if( (card[0] > 0x60) && (card[0] < 0x79) )
+    card[0] = (char)toupper( (int)card[0] );
+  if( (card[0] != '\0') && (card[1] > 0x60) && (card[1] < 0x79) )
+    card[1] = (char)toupper( (int)card[1] );
+  strip_card_comment( card );
+
+} /* geometry_card_text() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_symbol_snapshot()
+ *
+ * sy_foreach() callback: records the value each symbol reads as
+ */
+  static void
+geometry_symbol_snapshot( const gchar *name, gdouble value,
+    gboolean is_calculated, const gchar *expression,
+    gdouble min_value, gdouble max_value,
+    gdouble override_value, gboolean override_active,
+    gboolean opt_active, gpointer user_data )
+{
+  gdouble *val = g_new( gdouble, 1 );
+
+  *val = override_active ? override_value : value;
+  g_hash_table_insert( (GHashTable *)user_data, g_strdup(name), val );
+
+} /* geometry_symbol_snapshot() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_card_reads()
+ *
+ * Reports whether any field of a geometry card line depends on one of
+ * the symbols named in changed
+ */
+  static gboolean
+geometry_card_reads( const char *line, GPtrArray *changed )
+{
+  char card[LINE_LEN + 1];
+  char *field, *save_ptr;
+  guint idx;
+
+  geometry_card_text( card, line, sizeof(card) );
+  if( (strlen(card) <= 2) || (strncmp(card, "SY", 2) == 0) )
+    return( FALSE );
+
+  /* Same field delimiters as parse_field_with_expression() */
+  for( field = strtok_r( card + 2, " \t,\r\n", &save_ptr );
+      field != NULL;
+      field = strtok_r( NULL, " \t,\r\n", &save_ptr ) )
+  {
+    if( !sy_is_expression(field) )
+      continue;
+
+    for( idx = 0; idx < changed->len; idx++ )
+      if( sy_depends(field, g_ptr_array_index(changed, idx)) )
+        return( TRUE );
+  }
+
+  return( FALSE );
+} /* geometry_card_reads() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_unchanged()
+ *
+ * Reads the geometry section ahead and compares it with the cards of the
+ * last successful parse.  On a line-for-line match the section's SY cards
+ * are defined, and the symbols whose value differs from the last parse
+ * are checked against every field through the symbol dependency graph.
+ * Returns TRUE, with input_fp past the GE card, when the geometry the
+ * section builds is the one already held.  Otherwise rewinds input_fp and
+ * reloads a fresh symbol table for the full parse.
+ */
+  static gboolean
+geometry_unchanged( void )
+{
+  char line[LINE_LEN + 1];
+  char card[LINE_LEN + 1];
+  GHashTable *symbols;
+  GHashTableIter iter;
+  GPtrArray *changed;
+  gpointer key, value;
+  gdouble *prev;
+  gboolean same;
+  long start;
+  guint idx;
+
+  if( (geom_cards == NULL) || (input_fp == NULL) )
+    return( FALSE );
+
+  start = ftell( input_fp );
+  if( start < 0 )
+    return( FALSE );
+
+  /* Errors surface from the full parse that follows a mismatch */
+  sy_errors_begin();
+  same = TRUE;
+  for( idx = 0; same && (idx < geom_cards->len); idx++ )
+  {
+    same = (Load_Line(line, input_fp) != EOF) &&
+      (strcmp(line, g_ptr_array_index(geom_cards, idx)) == 0);
+
+    geometry_card_text( card, line, sizeof(card) );
+    if( same && (strncmp(card, "SY", 2) == 0) )
+      same = parse_sy_card( card + 2 );
+  }
+  sy_errors_discard();
+
+  changed = g_ptr_array_new_with_free_func( g_free );
+  if( same )
+  {
+    symbols = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+    sy_foreach( geometry_symbol_snapshot, symbols );
+
+    /* Symbols added, dropped or given a new value since the last parse */
+    g_hash_table_iter_init( &iter, symbols );
+    while( g_hash_table_iter_next(&iter, &key, &value) )
+    {
+      prev = g_hash_table_lookup( geom_symbols, key );
+      if( (prev == NULL) ||
+          !((*prev == *(gdouble *)value) || (isnan(*prev) && isnan(*(gdouble *)value))) )
+        g_ptr_array_add( changed, g_strdup(key) );
+    }
+
+    g_hash_table_iter_init( &iter, geom_symbols );
+    while( g_hash_table_iter_next(&iter, &key, &value) )
+      if( !g_hash_table_contains(symbols, key) )
+        g_ptr_array_add( changed, g_strdup(key) );
+
+    for( idx = 0; same && (changed->len > 0) && (idx < geom_cards->len); idx++ )
+      same = !geometry_card_reads( g_ptr_array_index(geom_cards, idx), changed );
+
+    /* Later reuse compares against the values this geometry was built from
+     * only where they were read; keep the rest current */
+    if( same )
+    {
+      g_hash_table_destroy( geom_symbols );
+      geom_symbols = symbols;
+    }
+    else
+      g_hash_table_destroy( symbols );
+  }
+
+  if( !same )
+  {
+    pr_debug("Read_Geometry: geometry changed, rebuilding (%u symbols changed)\n",
+        changed->len);
+    g_ptr_array_free( changed, TRUE );
+
+    if( fseek(input_fp, start, SEEK_SET) != 0 )
+    {
+      pr_err("Read_Geometry: cannot rewind input: %s\n", strerror(errno));
+      return( FALSE );
+    }
+
+    sy_init();
+    input_load_overrides();
+    return( FALSE );
+  }
+
+  pr_debug("Read_Geometry: geometry unchanged, keeping %d segments and %d patches\n",
+      data.n, data.m);
+  g_ptr_array_free( changed, TRUE );
+  readgm_line_count = (int)geom_cards->len;
+
+  return( TRUE );
+} /* geometry_unchanged() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_restore_unscaled()
+ *
+ * Puts back the segment and patch fields Frequency_Scale_Geometry()
+ * rewrites in wavelengths, from the copies in metres Read_Geometry()
+ * saved, so a reused geometry reads as a freshly parsed one until the
+ * next sweep scales it again.
+ */
+  static void
+geometry_restore_unscaled( void )
+{
+  int idx, j;
+
+  for( idx = 0; idx < data.n; idx++ )
+  {
+    data.segments[idx].x  = save.xtemp[idx];
+    data.segments[idx].y  = save.ytemp[idx];
+    data.segments[idx].z  = save.ztemp[idx];
+    data.segments[idx].si = save.sitemp[idx];
+    data.segments[idx].bi = save.bitemp[idx];
+  }
+
+  for( idx = 0; idx < data.m; idx++ )
+  {
+    j = idx + data.n;
+    data.patches[idx].px  = save.xtemp[j];
+    data.patches[idx].py  = save.ytemp[j];
+    data.patches[idx].pz  = save.ztemp[j];
+    data.patches[idx].pbi = save.bitemp[j];
+  }
+} /* geometry_restore_unscaled() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_section_key()
+ *
+ * Reads the geometry section ahead to its GE card, defining its SY cards
+ * as it goes, and hashes the card lines with the value every symbol then
+ * reads as.  The lines are kept in lines.  Returns FALSE when the input
+ * ends before a GE card or an SY card does not parse.
+ */
+  static gboolean
+geometry_section_key( guint8 *key, GPtrArray *lines )
+{
+  static const char tag[] = "xnec2c geometry 1";
+  char line[LINE_LEN + 1];
+  char card[LINE_LEN + 1];
+  GHashTable *symbols;
+  GList *names, *node;
+  GChecksum *sum;
+  gsize len = MODEL_CACHE_KEY_LEN;
+  guint32 size;
+  gboolean ge = FALSE;
+
+  while( !ge && (Load_Line(line, input_fp) != EOF) )
+  {
+    g_ptr_array_add( lines, g_strdup(line) );
+
+    geometry_card_text( card, line, sizeof(card) );
+    if( (strncmp(card, "SY", 2) == 0) && !parse_sy_card(card + 2) )
+      return( FALSE );
+    ge = (strncmp(card, "GE", 2) == 0);
+  }
+
+  if( !ge )
+    return( FALSE );
+
+  sum = g_checksum_new( G_CHECKSUM_SHA256 );
+  g_checksum_update( sum, (const guchar *)tag, sizeof(tag) );
+
+  /* Length-prefixed, so no two sections hash the same bytes */
+  for( guint idx = 0; idx < lines->len; idx++ )
+  {
+    const char *text = g_ptr_array_index( lines, idx );
+
+    size = (guint32)strlen( text );
+    g_checksum_update( sum, (const guchar *)&size, sizeof(size) );
+    g_checksum_update( sum, (const guchar *)text, size );
+  }
+
+  /* Symbol values, overrides applied, in name order */
+  symbols = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+  sy_foreach( geometry_symbol_snapshot, symbols );
+  names = g_list_sort( g_hash_table_get_keys(symbols), (GCompareFunc)strcmp );
+  for( node = names; node != NULL; node = node->next )
+  {
+    g_checksum_update( sum, (const guchar *)node->data, strlen(node->data) + 1 );
+    g_checksum_update( sum, g_hash_table_lookup(symbols, node->data), sizeof(gdouble) );
+  }
+  g_list_free( names );
+  g_hash_table_destroy( symbols );
+
+  g_checksum_get_digest( sum, key, &len );
+  g_checksum_free( sum );
+
+  return( TRUE );
+} /* geometry_section_key() */
+
+/*-----------------------------------------------------------------------*/
+
+/* geometry_model_cache_load()
+ *
+ * Keys the geometry section and loads the binary model cache at path when
+ * it was written for that key.  On a hit input_fp is past the GE card and
+ * geom_record holds the section's lines.  Otherwise input_fp is rewound
+ * and a fresh symbol table loaded for the full parse; *keyed tells whether
+ * key holds the section's key for model_cache_save().
+ */
+  static gboolean
+geometry_model_cache_load( const char *path, guint8 *key, gboolean *keyed )
+{
+  GPtrArray *lines;
+  long start;
+
+  *keyed = FALSE;
+  start = ftell( input_fp );
+  if( start < 0 )
+    return( FALSE );
+
+  /* Errors surface from the full parse that follows a miss */
+  lines = g_ptr_array_new_with_free_func( g_free );
+  sy_errors_begin();
+  *keyed = geometry_section_key( key, lines );
+  sy_errors_discard();
+
+  if( *keyed && model_cache_load(path, key) )
+  {
+    geom_record = lines;
+    readgm_line_count = (int)lines->len;
+    return( TRUE );
+  }
+  g_ptr_array_free( lines, TRUE );
+
+  if( fseek(input_fp, start, SEEK_SET) != 0 )
+  {
+    pr_err("Read_Geometry: cannot rewind input: %s\n", strerror(errno));
+    *keyed = FALSE;
+    return( FALSE );
+  }
+
+  sy_init();
+  input_load_overrides();
+  return( FALSE );
+} /* geometry_model_cache_load() */
+
+/*-----------------------------------------------------------------------*/
+
 /* Read_Geometry()
  *
  * Reads geometry data from input file
@@ -1041,6 +1438,9 @@ datagn( void )
   gboolean
 Read_Geometry( void )
 {
+  char cache_path[FILENAME_LEN];
+  guint8 cache_key[MODEL_CACHE_KEY_LEN];
+  gboolean cached, keyed;
   int idx;
 
   /* Initialize symbol table for SY card support */
@@ -1051,34 +1451,67 @@ Read_Geometry( void )
     return( FALSE );
   }
 
-  /* Load symbol overrides from .sy file if it exists */
+  /* Load symbol overrides staged in memory, else from the .sy file */
+  input_load_overrides();
+
+  /* Moved here from Read_Commands() */
+  matpar.imat=0;
+
+  /* An edit or optimizer step that leaves the geometry section as it was
+   * keeps the segments, connection data and buffers of the last parse */
+  if( geometry_unchanged() )
   {
-    char sy_path[FILENAME_LEN];
+    /* An in-process sweep left the segments in wavelengths, which
+     * Read_Commands() would take for metres */
+    geometry_restore_unscaled();
 
-    if( build_companion_path(rc_config.input_file, ".sy",
-          sy_path, sizeof(sy_path)) )
-    {
-      sy_load_overrides(sy_path);
-    }
+    if( isFlagClear(HEADLESS_EVAL) )
+      sy_overrides_refresh();
+
+    return( TRUE );
   }
 
-  /* Moved here from Read_Commands() */
-  matpar.imat=0;
+  geometry_cache_free();
   data.n = data.m = 0;
 
-  /* Accumulate expression errors during geometry parsing
-   * so all problems are reported in one dialog */
-  sy_errors_begin();
+  /* A cold load of a deck whose geometry section and symbol values
+   * match the binary model cache beside it skips the parse */
+  cached = keyed = FALSE;
+  if( rc_config.model_cache && (input_fp != NULL) &&
+      (rc_config.input_file[0] != '\0') &&
+      (snprintf(cache_path, sizeof(cache_path), "%s.bin",
+                rc_config.input_file) < (int)sizeof(cache_path)) )
+    cached = geometry_model_cache_load( cache_path, cache_key, &keyed );
 
-  if( !datagn() )
+  if( cached )
   {
+    if( !CHILD )
+      Init_Struct_Drawing();
+  }
+  else
+  {
+    /* Accumulate expression errors during geometry parsing
+     * so all problems are reported in one dialog */
+    sy_errors_begin();
+
+    geom_record = g_ptr_array_new_with_free_func( g_free );
+    if( !datagn() )
+    {
+      g_ptr_array_free( geom_record, TRUE );
+      geom_record = NULL;
+      sy_errors_end();
+      /* Keep symbol table alive so editors can still display
+       * expression text; sy_init() will reset it on next load */
+      return( FALSE );
+    }
+
     sy_errors_end();
-    /* Keep symbol table alive so editors can still display
-     * expression text; sy_init() will reset it on next load */
-    return( FALSE );
+
+    /* Optimizer evaluations only vary the deck the user loaded */
+    if( keyed && !CHILD && isFlagClear(HEADLESS_EVAL) )
+      model_cache_save( cache_path, cache_key );
   }
 
-  sy_errors_end();
   mem_array_realloc(&save.xtemp, data.npm);
   mem_array_realloc(&save.ytemp, data.npm);
   mem_array_realloc(&save.ztemp, data.npm);
@@ -1113,8 +1546,15 @@ Read_Geometry( void )
       save.bitemp[j] = data.patches[idx].pbi;
     }
 
+  /* Keep the cards and the symbol values they were built from */
+  geom_cards = geom_record;
+  geom_record = NULL;
+  geom_symbols = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+  sy_foreach( geometry_symbol_snapshot, geom_symbols );
+
   /* Refresh SY overrides window if visible */
-  sy_overrides_refresh();
+  if( isFlagClear(HEADLESS_EVAL) )
+    sy_overrides_refresh();
 
   return( TRUE );
 } /* Read_Geometry() */
@@ -1805,7 +2245,7 @@ Read_Commands( void )
         calc_data.zo = (double)itmp1;
 
         /* Set the Zo spinbutton value */
-        if( freqplots_window_builder )
+        if( freqplots_window_builder && isFlagClear(HEADLESS_EVAL) )
         {
           GtkWidget *spin = Builder_Get_Object(
               freqplots_window_builder, "freqplots_zo_spinbutton" );
@@ -2185,6 +2625,10 @@ readgm( char *gm, int *i1, int *i2, double *x1,
   // For use if you need to pr_debug based on line number.
   readgm_line_count++;
 
+  /* Keep the section's lines for the next parse to compare against */
+  if( (geom_record != NULL) && (eof != EOF) )
+    g_ptr_array_add( geom_record, g_strdup(line_buf) );
+
   /* Capitalize first two characters (mnemonics) */
   if( (line_buf[0] > 0x60) && (line_buf[0] < 0x79) )
     line_buf[0] = (char)toupper( (int)line_buf[0] );
@@ -0,0 +1,383 @@
+#include "shared.h"
+
+/* Low-rank update of the interaction matrix factors.  cmset() adds the
+ * load of wire segment j to row j of the matrix alone, so two fills of
+ * one model that differ only in the loads of k segments differ by a
+ * rank-k update A + U V', U holding the k unit rows and V' the change of
+ * each row.  Each frequency keeps the LU factors of one base fill, and a
+ * fill that differs from its base only in loads reuses them through the
+ * Sherman-Morrison-Woodbury identity
+ *
+ *   (A + U V')^-1 = A^-1 - A^-1 U (I + V' A^-1 U)^-1 V' A^-1
+ *
+ * Setting up the correction costs k solves against the base, O(N^2 k),
+ * where the fill and factor cost O(N^3); each later solve adds O(N k).
+ * Past N/LU_UPDATE_RANK_DIV changed segments the full refill is cheaper.
+ *
+ * A base is identified by a hash of every other input of the fill:
+ * frequency, segment and patch geometry, connectivity, ground and kernel.
+ * A moved segment changes every row and column it couples to, so any
+ * change of these refills.  A base's factors are copied the second time
+ * its hash is seen at a frequency, so sweeping a model that never repeats
+ * keeps no copies.  Models with symmetry factor one block per mode and
+ * always refill.  The cache is per process: a forked worker keeps the
+ * bases of the steps it solves, within an equal share of the budget.
+ * The update is off unless --lu-update asks for it. */
+
+/* Byte budget of the kept factors, shared by all the workers of a sweep */
+#define LU_UPDATE_CACHE_BYTES   ((size_t)256 << 20)
+
+/* A correction of more than neq / LU_UPDATE_RANK_DIV segments refills */
+#define LU_UPDATE_RANK_DIV      8
+
+#define LU_UPDATE_SIG_LEN       32
+
+typedef struct
+{
+  double          freq_mhz;   /* Key */
+  guint8          sig[LU_UPDATE_SIG_LEN]; /* Hash of the fill less loads */
+  int             neq;
+  complex double *lu;         /* Base factors, neq^2, NULL until kept */
+  int            *ip;         /* Base pivots, neq */
+  complex double *zbase;      /* Base loads, one per wire segment */
+  size_t          bytes;
+} lu_update_entry_t;
+
+static lu_update_entry_t *lu_update_cache = NULL;
+static int                lu_update_count = 0;
+static size_t             lu_update_bytes = 0;
+
+/* Hash of the fill in progress, from lu_update_restore() for
+ * lu_update_keep() */
+static guint8   lu_update_sig[LU_UPDATE_SIG_LEN];
+static gboolean lu_update_sig_valid = FALSE;
+
+/* Correction of the factors now in cm; k == 0 when there is none */
+static struct
+{
+  int             k, neq;
+  complex double *w;      /* A^-1 U, neq x k */
+  complex double *vt;     /* V', row r at vt[r*neq] */
+  complex double *cap;    /* I + V' A^-1 U, factored, k x k */
+  int            *cap_ip;
+  complex double *t;      /* Scratch, k */
+} lu_corr;
+
+/*-----------------------------------------------------------------------*/
+
+/* Returns the load of wire segment idx as cmset() applies it */
+  static inline complex double
+lu_update_load( int idx )
+{
+  if( zload.nload == 0 || zload.zarray == NULL )
+    return( CPLX_00 );
+
+  return( zload.zarray[idx] );
+}
+
+/* This process's share of LU_UPDATE_CACHE_BYTES */
+  static inline size_t
+lu_update_budget( void )
+{
+  return( LU_UPDATE_CACHE_BYTES / (size_t)MAX(calc_data.num_jobs, 1) );
+}
+
+/* Whether the current matrix is one block the update can apply to */
+  static gboolean
+lu_update_eligible( void )
+{
+  return( (netcx.neq == netcx.npeq) &&
+      (matpar.icase == 1) && (cm != NULL) && (save.ip != NULL) );
+}
+
+/* Hashes every input of the fill except the loads */
+  static void
+lu_update_hash( guint8 *sig )
+{
+  GChecksum *sum = g_checksum_new( G_CHECKSUM_SHA256 );
+  gsize len = LU_UPDATE_SIG_LEN;
+
+  int ihdr[] = { netcx.neq, netcx.npeq, data.n, data.m, data.ipsym,
+    calc_data.iexk, gnd.ksymp, gnd.iperf, gnd.nradl };
+  double dhdr[] = { calc_data.freq_mhz, calc_data.rkh,
+    gnd.t2, gnd.cl, gnd.ch, gnd.scrwl, gnd.scrwr };
+  complex double chdr[] = { gnd.zrati, gnd.zrati2, gnd.t1, gnd.frati,
+    ggrid.epscf };
+
+  g_checksum_update( sum, (const guchar *)ihdr, sizeof(ihdr) );
+  g_checksum_update( sum, (const guchar *)dhdr, sizeof(dhdr) );
+  g_checksum_update( sum, (const guchar *)chdr, sizeof(chdr) );
+
+  if( data.n != 0 )
+  {
+    g_checksum_update( sum, (const guchar *)data.obs,
+        (gssize)data.n * (gssize)sizeof(wire_obs_t) );
+    g_checksum_update( sum, (const guchar *)data.con,
+        (gssize)data.n * (gssize)sizeof(wire_con_t) );
+  }
+
+  if( data.m != 0 )
+    g_checksum_update( sum, (const guchar *)data.patches,
+        (gssize)data.m * (gssize)sizeof(surface_patch_t) );
+
+  g_checksum_get_digest( sum, sig, &len );
+  g_checksum_free( sum );
+}
+
+/* Returns the entry of the current frequency, or NULL */
+  static lu_update_entry_t *
+lu_update_find( void )
+{
+  for( int idx = 0; idx < lu_update_count; idx++ )
+    if( FREQ_EQ(lu_update_cache[idx].freq_mhz, calc_data.freq_mhz) )
+      return &lu_update_cache[idx];
+
+  return NULL;
+}
+
+/* Releases an entry's factors, leaving its key and hash */
+  static void
+lu_update_entry_drop( lu_update_entry_t *entry )
+{
+  lu_update_bytes -= entry->bytes;
+  mem_array_free( &entry->lu );
+  mem_array_free( &entry->ip );
+  mem_array_free( &entry->zbase );
+  entry->bytes = 0;
+}
+
+/* Builds the correction from the base factors now in cm for the k
+ * segments whose load differs from @zbase.  Returns FALSE if the
+ * capacitance matrix I + V' A^-1 U is singular. */
+  static gboolean
+lu_update_correct( const complex double *zbase, int k )
+{
+  int neq = netcx.neq, row = 0;
+
+  mem_array_realloc( &lu_corr.w, (size_t)neq * k );
+  mem_array_realloc( &lu_corr.vt, (size_t)neq * k );
+  mem_array_realloc( &lu_corr.cap, (size_t)k * k );
+  mem_array_realloc( &lu_corr.cap_ip, k );
+  mem_array_realloc( &lu_corr.t, k );
+  mem_array_zero( lu_corr.w );
+  mem_array_zero( lu_corr.vt );
+
+  /* U is the unit row of each changed segment; its row of V' is the
+   * change of the load term cmset() adds along the segment's basis */
+  for( int j = 0; j < data.n; j++ )
+  {
+    complex double dz = lu_update_load( j ) - zbase[j];
+
+    if( dz == CPLX_00 )
+      continue;
+
+    trio( j + 1 );
+    lu_corr.w[j + row * neq] = CPLX_10;
+    for( int i = 0; i < segj.jsno; i++ )
+      lu_corr.vt[row * neq + segj.jco[i] - 1] -=
+        ( segj.ax[i] + segj.cx[i] ) * dz;
+    row++;
+  }
+
+  /* W = A^-1 U */
+  for( int col = 0; col < k; col++ )
+    solve( neq, cm, save.ip, &lu_corr.w[col * neq], neq );
+
+  /* I + V' W, stored transposed as factr() expects */
+  for( int r = 0; r < k; r++ )
+    for( int col = 0; col < k; col++ )
+    {
+      complex double sum = (r == col) ? CPLX_10 : CPLX_00;
+
+      for( int i = 0; i < neq; i++ )
+        sum += lu_corr.vt[r * neq + i] * lu_corr.w[i + col * neq];
+      lu_corr.cap[col + r * k] = sum;
+    }
+
+  if( factr(k, lu_corr.cap, lu_corr.cap_ip, k) != 0 )
+    return( FALSE );
+
+  lu_corr.k   = k;
+  lu_corr.neq = neq;
+  return( TRUE );
+}
+
+/*-----------------------------------------------------------------------*/
+
+/**
+ * lu_update_restore - reuse the kept factors of the current frequency
+ *
+ * Called by Set_Interaction_Matrix() in place of the fill and factor.
+ * When the frequency's base fill matches the current model in all but the
+ * loads of a few segments, copies its factors into cm and save.ip and
+ * arms the correction lu_update_apply() adds to each solve.
+ *
+ * Return: TRUE if cm holds usable factors, FALSE if the caller must fill
+ * and factor, then call lu_update_keep().
+ */
+  gboolean
+lu_update_restore( void )
+{
+  lu_update_entry_t *entry;
+  int neq = netcx.neq, k = 0;
+
+  lu_corr.k = 0;
+  lu_update_sig_valid = FALSE;
+  if( !rc_config.lu_update || !lu_update_eligible() )
+    return( FALSE );
+
+  lu_update_hash( lu_update_sig );
+  lu_update_sig_valid = TRUE;
+
+  entry = lu_update_find();
+  if( (entry == NULL) || (entry->lu == NULL) || (entry->neq != neq) ||
+      memcmp(entry->sig, lu_update_sig, LU_UPDATE_SIG_LEN) != 0 )
+    return( FALSE );
+
+  for( int j = 0; j < data.n; j++ )
+    if( lu_update_load(j) != entry->zbase[j] )
+      k++;
+
+  if( k > neq / LU_UPDATE_RANK_DIV )
+    return( FALSE );
+
+  memcpy( cm, entry->lu, (size_t)neq * neq * sizeof(complex double) );
+  memcpy( save.ip, entry->ip, (size_t)neq * sizeof(int) );
+
+  if( (k > 0) && !lu_update_correct(entry->zbase, k) )
+    return( FALSE );
+
+  /* cmset() leaves the kernel selection for the field routines */
+  dataj.rkh  = calc_data.rkh;
+  dataj.iexk = calc_data.iexk;
+
+  return( TRUE );
+}
+
+/**
+ * lu_update_keep - record the factors just computed as the frequency's base
+ *
+ * Called after a full fill and factor.  The first fill of a model at a
+ * frequency records its hash; a later one with the same hash copies the
+ * factors, within the cache's byte budget.
+ */
+  void
+lu_update_keep( void )
+{
+  lu_update_entry_t *entry;
+  int neq = netcx.neq;
+  size_t bytes;
+
+  if( !lu_update_sig_valid )
+    return;
+  lu_update_sig_valid = FALSE;
+
+  entry = lu_update_find();
+  if( entry == NULL )
+  {
+    mem_array_reserve( &lu_update_cache, lu_update_count + 1, 16 );
+    entry = &lu_update_cache[lu_update_count++];
+    memset( entry, 0, sizeof(*entry) );
+    entry->freq_mhz = calc_data.freq_mhz;
+    memcpy( entry->sig, lu_update_sig, LU_UPDATE_SIG_LEN );
+    return;
+  }
+
+  if( memcmp(entry->sig, lu_update_sig, LU_UPDATE_SIG_LEN) != 0 )
+  {
+    if( entry->lu != NULL )
+      lu_update_entry_drop( entry );
+    memcpy( entry->sig, lu_update_sig, LU_UPDATE_SIG_LEN );
+    return;
+  }
+
+  /* Hash seen twice: keep the factors, replacing an older base */
+  bytes = (size_t)neq * neq * sizeof(complex double) +
+    (size_t)neq * sizeof(int) + (size_t)data.n * sizeof(complex double);
+  if( (entry->lu == NULL) || (entry->neq != neq) )
+  {
+    if( entry->lu != NULL )
+      lu_update_entry_drop( entry );
+    if( lu_update_bytes + bytes > lu_update_budget() )
+      return;
+
+    mem_array_alloc( &entry->lu, (size_t)neq * neq );
+    mem_array_alloc( &entry->ip, neq );
+    mem_array_alloc( &entry->zbase, data.n > 0 ? data.n : 1 );
+    entry->neq   = neq;
+    entry->bytes = bytes;
+    lu_update_bytes += bytes;
+  }
+
+  memcpy( entry->lu, cm, (size_t)neq * neq * sizeof(complex double) );
+  memcpy( entry->ip, save.ip, (size_t)neq * sizeof(int) );
+  for( int j = 0; j < data.n; j++ )
+    entry->zbase[j] = lu_update_load( j );
+}
+
+/**
+ * lu_update_apply - correct solutions against restored base factors
+ * @a: matrix the right hand sides were solved against
+ * @b: solutions of the base matrix, overwritten with those of the current
+ * @neq: length of each solution
+ * @nrh: number of solutions
+ *
+ * Called by solves() after the mode solves; does nothing unless
+ * lu_update_restore() armed a correction for @a.
+ */
+  void
+lu_update_apply( const complex double *a, complex double *b, int neq, int nrh )
+{
+  int k = lu_corr.k;
+
+  if( (k == 0) || (a != cm) || (neq != lu_corr.neq) )
+    return;
+
+  for( int ic = 0; ic < nrh; ic++ )
+  {
+    complex double *y = &b[ic * neq];
+
+    /* y - W (I + V' W)^-1 V' y */
+    for( int r = 0; r < k; r++ )
+    {
+      complex double sum = CPLX_00;
+
+      for( int i = 0; i < neq; i++ )
+        sum += lu_corr.vt[r * neq + i] * y[i];
+      lu_corr.t[r] = sum;
+    }
+
+    solve( k, lu_corr.cap, lu_corr.cap_ip, lu_corr.t, k );
+
+    for( int col = 0; col < k; col++ )
+    {
+      const complex double *w = &lu_corr.w[col * neq];
+      complex double tc = lu_corr.t[col];
+
+      for( int i = 0; i < neq; i++ )
+        y[i] -= w[i] * tc;
+    }
+  }
+}
+
+/**
+ * lu_update_free - release every kept base and the correction
+ */
+  void
+lu_update_free( void )
+{
+  for( int idx = 0; idx < lu_update_count; idx++ )
+    if( lu_update_cache[idx].lu != NULL )
+      lu_update_entry_drop( &lu_update_cache[idx] );
+
+  mem_array_free( &lu_update_cache );
+  lu_update_count = 0;
+  lu_update_sig_valid = FALSE;
+
+  mem_array_free( &lu_corr.w );
+  mem_array_free( &lu_corr.vt );
+  mem_array_free( &lu_corr.cap );
+  mem_array_free( &lu_corr.cap_ip );
+  mem_array_free( &lu_corr.t );
+  lu_corr.k = 0;
+}
@@ -20,6 +20,7 @@
 #include "main.h"
 #include "args.h"
 #include "validation_dump.h"
+#include "touchstone.h"
 #include "shared.h"
 #include "gdk_scroll.h"
 #include "mathlib.h"
@@ -34,6 +35,7 @@
 #include "config_hooks.h"
 #include "themes/theme.h"
 #include "color/color_palette.h"
+#include "optimizers/opt_study.h"
 
 /* Forward declaration — full sy_overrides.h conflicts with openblas via gsl */
 extern void sy_overrides_close_if_empty(void);
@@ -57,6 +59,17 @@ static gint opt_start_optimizer_thread(void)
 	return FALSE;
 }
 
+/* Start the --study run once the deck is loaded; a study that cannot
+ * start has nothing to wait for */
+static void opt_start_study(void)
+{
+	if (opt_study_start(rc_config.filename_study) != 0)
+	{
+		pr_crit("parameter study %s did not start\n", rc_config.filename_study);
+		xnec2c_quit(NULL);
+	}
+}
+
 /*------------------------------------------------------------------------*/
 
 char *orig_numeric_locale = NULL;
@@ -105,6 +118,7 @@ main (int argc, char *argv[])
    * only fatal once the GUI is actually needed; see the check before
    * create_main_window() below. */
   gboolean gtk_ok = gtk_init_check( &argc, &argv );
+  ui_thread_init();
 
   /* Create a default config if needed, abort on error */
   if( !Create_Default_Config() ) exit( -1 );
@@ -135,6 +149,13 @@ main (int argc, char *argv[])
 	  exit(1);
   }
 
+  if (rc_config.filename_study != NULL &&
+      (rc_config.batch_mode || isFlagSet(SUPPRESS_INTERMEDIATE_REDRAWS)))
+  {
+	  pr_crit("--study cannot be combined with --batch or --optimize.\n");
+	  exit(1);
+  }
+
   /* The radiation-pattern PNG is written only on batch teardown; a target set
    * without --batch is a false contract, so abort once all arguments are
    * parsed, honoring --batch regardless of its position. */
@@ -144,6 +165,24 @@ main (int argc, char *argv[])
     exit(1);
   }
 
+  /* The sensitivity run follows the batch sweep; see batch_capture_and_quit */
+  if( rc_config.filename_sensitivity != NULL && !rc_config.batch_mode )
+  {
+    pr_crit("--write-sensitivity requires --batch\n");
+    exit(1);
+  }
+
+  if( rc_config.network_deembed && rc_config.filename_network == NULL )
+  {
+    pr_crit("--network-deembed requires --network\n");
+    exit(1);
+  }
+
+  /* A network named on the command line that does not read is fatal */
+  if( rc_config.filename_network != NULL &&
+      !touchstone_network_load(rc_config.filename_network) )
+    exit(1);
+
   /* Initialize the external math libraries */
   init_mathlib();
 
@@ -180,6 +219,12 @@ main (int argc, char *argv[])
 	  exit(1);
   }
 
+  if (strlen(rc_config.input_file) == 0 && rc_config.filename_study != NULL)
+  {
+	  pr_crit("--study requires an input file\n");
+	  exit(1);
+  }
+
   /* The GUI requires a display; informational options (--help,
    * --version) have already run and exited above, so anything reaching
    * here needs GTK initialized.  Fail cleanly before forking workers or
@@ -386,6 +431,10 @@ main (int argc, char *argv[])
   if (isFlagSet(SUPPRESS_INTERMEDIATE_REDRAWS))
 	  g_idle_add_once((GSourceOnceFunc)opt_start_optimizer_thread, NULL);
 
+  /* Queued behind Open_Input_File, so the study finds the model loaded */
+  if (rc_config.filename_study != NULL)
+	  g_idle_add_once((GSourceOnceFunc)opt_start_study, NULL);
+
   gtk_main ();
 
   /* Release every mem-tracked owner by name, then emit the report. */
@@ -567,6 +616,9 @@ Open_Input_File( gpointer arg )
    * idempotent — it checks pth_freq_loop internally and no-ops safely. */
   Stop_Frequency_Loop();
 
+  /* Pre-solved results belong to the deck being replaced */
+  freq_spec_cache_clear();
+
   /* Close open files if any */
   Close_File( &input_fp );
 
@@ -589,6 +641,9 @@ Open_Input_File( gpointer arg )
   /* Read input file, record failures */
   ok = Read_Comments() && Read_Geometry() && Read_Commands();
 
+  /* Key the sweep archive to the deck text and symbol values just read */
+  sweep_archive_model( ok ? input_fp : NULL );
+
   /* Zero validity flags and invalidate the result set under lock so draw
    * and save handlers cannot observe stale fstep=1 paired with
    * freshly-allocated garbage rad_pattern from Alloc_Rdpattern_Buffers
@@ -824,6 +879,115 @@ Open_Input_File( gpointer arg )
   return( FALSE );
 } /* Open_Input_File() */
 
+/*-----------------------------------------------------------------------*/
+
+/* Reparse_Input_Deck()
+ *
+ * Re-reads the model from a deck and .sy override text held in memory and
+ * hands both to the child processes.  This is the data half of
+ * Open_Input_File() alone: no file is opened, no widget is touched and no
+ * sweep is started, so the optimizer can call it from its own thread with
+ * HEADLESS_EVAL set between sweeps it runs itself.  input_fp reads @deck
+ * for the parse alone and is left closed, as after a failed load.
+ *
+ * The parse reaches the UI in five places, each gated on HEADLESS_EVAL:
+ * the frequency plot table freed below, the invalid-geometry Notice() in
+ * datagn(), the two Read_Geometry() sy_overrides_refresh() calls, and the
+ * Z0 spin button in Read_Commands().
+ * Stop() reports to the console under the flag.  notice_run() and
+ * sy_overrides_refresh() BUG() and back off if one is reached off the GTK
+ * thread anyway.
+ */
+  gboolean
+Reparse_Input_Deck( const char *deck, size_t len, const char *sy_text )
+{
+  gboolean ok, children_ok = TRUE;
+
+  /* Off the GTK thread, only the gated path above is safe */
+  if( !ui_thread_is_self() && isFlagClear(HEADLESS_EVAL) )
+  {
+    BUG("Reparse_Input_Deck: called off the GTK thread without HEADLESS_EVAL\n");
+    return( FALSE );
+  }
+
+  if( isFlagSet(INPUT_PENDING) )
+    return( FALSE );
+
+  /* Same guard as Open_Input_File(): draws and sweep starts stay off the
+   * model while it is rebuilt */
+  SetFlag( INPUT_PENDING );
+  g_rec_mutex_lock(&freq_data_lock);
+
+  calc_data.FR_cards    = 0;
+  calc_data.steps_total = 0;
+  calc_data.freq_step   = -1;
+
+  /* The plot table is GTK view state; off the GTK thread it is left for
+   * fr_plots_init() to fit to the new cards at the next draw */
+  if( isFlagClear(HEADLESS_EVAL) )
+    mem_array_free(&freqplots_main_view()->fr_plots);
+
+  Close_File( &input_fp );
+  input_fp = fmemopen( (void *)deck, len, "r" );
+  if( input_fp == NULL )
+  {
+    pr_err("Reparse_Input_Deck: fmemopen failed: %s\n", strerror(errno));
+    g_rec_mutex_unlock(&freq_data_lock);
+    ClearFlag( INPUT_PENDING );
+    return( FALSE );
+  }
+
+  Set_Input_Overrides( sy_text );
+  ok = Read_Comments() && Read_Geometry() && Read_Commands();
+  Set_Input_Overrides( NULL );
+  Close_File( &input_fp );
+
+  /* A candidate is not the deck on disk; its sweeps stay off the archive */
+  sweep_archive_model( NULL );
+
+  freq_sweep_results_clear();
+  if( ok && save.fstep != NULL )
+    for( int i = 0; i <= calc_data.steps_total; i++ )
+      save.fstep[i] = 0;
+
+  if( ok && FORKED )
+  {
+    fork_deck_t dk = {
+      .deck_len = len,
+      .sy_len   = (sy_text != NULL) ? strlen(sy_text) : 0,
+      .deck     = (char *)deck,
+      .sy       = (char *)sy_text,
+    };
+
+    for( int idx = 0; idx < num_child_procs; idx++ )
+      fork_send_deck( idx, &dk );
+
+    /* The children parse at once; a child that did not would solve
+     * the previous model, so the caller fails the candidate */
+    for( int idx = 0; idx < num_child_procs; idx++ )
+      if( fork_recv_deck(idx) != 1 )
+      {
+        pr_err("Reparse_Input_Deck: child %d failed to parse the deck\n", idx);
+        children_ok = FALSE;
+      }
+  }
+
+  if( ok )
+  {
+    rc_config.freq_apply = 1;
+    Frequency_Scale_Geometry();
+  }
+
+  g_rec_mutex_unlock(&freq_data_lock);
+
+  /* Pre-solved results belong to the previous candidate */
+  freq_spec_cache_clear();
+
+  ClearFlag( INPUT_PENDING );
+
+  return( ok && children_ok );
+} /* Reparse_Input_Deck() */
+
 /*------------------------------------------------------------------------*/
 
 static void sig_handler( int signal )
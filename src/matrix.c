@@ -165,14 +165,14 @@ cmws( int j, int i1, int i2, complex double *cmx,
   complex double etk, ets, etc;
 
   j--;
-  dataj.s= data.segments[j].si;
-  dataj.b= data.segments[j].bi;
-  dataj.xj= data.segments[j].x;
-  dataj.yj= data.segments[j].y;
-  dataj.zj= data.segments[j].z;
-  dataj.cabj= data.segments[j].cab;
-  dataj.sabj= data.segments[j].sab;
-  dataj.salpj= data.segments[j].salp;
+  dataj.s= data.obs[j].si;
+  dataj.b= data.obs[j].bi;
+  dataj.xj= data.obs[j].x;
+  dataj.yj= data.obs[j].y;
+  dataj.zj= data.obs[j].z;
+  dataj.cabj= data.obs[j].cab;
+  dataj.sabj= data.obs[j].sab;
+  dataj.salpj= data.obs[j].salp;
 
   /* observation loop */
   ipr= -1;
@@ -282,38 +282,38 @@ cmww( int j, int i1, int i2, complex double *cmx,
   /* set source segment parameters */
   jx = j;
   j--;
-  dataj.s= data.segments[j].si;
-  dataj.b= data.segments[j].bi;
-  dataj.xj= data.segments[j].x;
-  dataj.yj= data.segments[j].y;
-  dataj.zj= data.segments[j].z;
-  dataj.cabj= data.segments[j].cab;
-  dataj.sabj= data.segments[j].sab;
-  dataj.salpj= data.segments[j].salp;
+  dataj.s= data.obs[j].si;
+  dataj.b= data.obs[j].bi;
+  dataj.xj= data.obs[j].x;
+  dataj.yj= data.obs[j].y;
+  dataj.zj= data.obs[j].z;
+  dataj.cabj= data.obs[j].cab;
+  dataj.sabj= data.obs[j].sab;
+  dataj.salpj= data.obs[j].salp;
 
   /* decide whether ext. t.w. approx. can be used */
   if( dataj.iexk != 0)
   {
-    ipr = data.segments[j].icon1;
+    ipr = data.con[j].icon1;
     if (ipr > PCHCON) dataj.ind1 = 0;
     else if( ipr < 0 )
     {
       ipr= -ipr;
       iprx= ipr-1;
 
-      if( -data.segments[iprx].icon1 != jx )
+      if( -data.con[iprx].icon1 != jx )
         dataj.ind1=2;
       else
       {
-        xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                 data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+        xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                 data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
         if( (xi < 0.999999) ||
-            (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+            (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
           dataj.ind1=2;
         else
           dataj.ind1=0;
 
-      } /* if( -data.segments[iprx].icon1 != jx ) */
+      } /* if( -data.con[iprx].icon1 != jx ) */
 
     } /* if( ipr < 0 ) */
     else
@@ -325,19 +325,19 @@ cmww( int j, int i1, int i2, complex double *cmx,
       {
         if( ipr != jx )
         {
-          if(data.segments[iprx].icon2 != jx )
+          if(data.con[iprx].icon2 != jx )
             dataj.ind1=2;
           else
           {
-            xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                     data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+            xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                     data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
             if( (xi < 0.999999) ||
-                (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+                (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
               dataj.ind1=2;
             else
               dataj.ind1=0;
 
-          } /* if( data.segments[iprx].icon2 != jx ) */
+          } /* if( data.con[iprx].icon2 != jx ) */
 
         } /* if( ipr != jx ) */
         else if( (dataj.cabj* dataj.cabj +
@@ -350,25 +350,25 @@ cmww( int j, int i1, int i2, complex double *cmx,
 
     } /* if( ipr < 0 ) */
 
-    ipr = data.segments[j].icon2;
+    ipr = data.con[j].icon2;
     if (ipr > PCHCON) dataj.ind2 = 2;
     else if( ipr < 0 )
     {
       ipr= -ipr;
       iprx = ipr-1;
-      if( -data.segments[iprx].icon2 != jx )
+      if( -data.con[iprx].icon2 != jx )
         dataj.ind2=2;
       else
       {
-        xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                 data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+        xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                 data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
         if( (xi < 0.99999) ||
-            (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+            (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
           dataj.ind2=2;
         else
           dataj.ind2=0;
 
-      } /* if( -data.segments[iprx].icon2 != jx ) */
+      } /* if( -data.con[iprx].icon2 != jx ) */
 
     } /* if( ipr < 0 ) */
     else
@@ -380,19 +380,19 @@ cmww( int j, int i1, int i2, complex double *cmx,
       {
         if( ipr != jx )
         {
-          if(data.segments[iprx].icon1 != jx )
+          if(data.con[iprx].icon1 != jx )
             dataj.ind2=2;
           else
           {
-            xi= fabs( dataj.cabj* data.segments[iprx].cab + dataj.sabj*
-                     data.segments[iprx].sab + dataj.salpj* data.segments[iprx].salp);
+            xi= fabs( dataj.cabj* data.obs[iprx].cab + dataj.sabj*
+                     data.obs[iprx].sab + dataj.salpj* data.obs[iprx].salp);
             if( (xi < 0.999999) ||
-                (fabs(data.segments[iprx].bi/dataj.b-1.0) > 1.0e-6) )
+                (fabs(data.obs[iprx].bi/dataj.b-1.0) > 1.0e-6) )
               dataj.ind2=2;
             else
               dataj.ind2=0;
 
-          } /* if( data.segments[iprx].icon1 != jx ) */
+          } /* if( data.con[iprx].icon1 != jx ) */
 
         } /* if( ipr != jx ) */
         else if( (dataj.cabj* dataj.cabj +
@@ -407,19 +407,21 @@ cmww( int j, int i1, int i2, complex double *cmx,
 
   } /* if( dataj.iexk != 0) */
 
-  /* observation loop */
+  /* observation loop; reads the packed record, one cache line each */
   ipr=-1;
   for( i = i1-1; i < i2; i++ )
   {
+    const wire_obs_t *ob = &data.obs[i];
+
     ipr++;
     ij= i-j;
-    xi= data.segments[i].x;
-    yi= data.segments[i].y;
-    zi= data.segments[i].z;
-    ai= data.segments[i].bi;
-    cabi= data.segments[i].cab;
-    sabi= data.segments[i].sab;
-    salpi= data.segments[i].salp;
+    xi= ob->x;
+    yi= ob->y;
+    zi= ob->z;
+    ai= ob->bi;
+    cabi= ob->cab;
+    sabi= ob->sab;
+    salpi= ob->salp;
 
     efld( xi, yi, zi, ai, ij);
 
@@ -487,6 +489,7 @@ cmset( int nrow, complex double *cmx, double rkhx, int iexkx )
   int mp2, neq, npeq, it, i, j, i1, i2, in2, im1;
   int im2, ist, ij, ipr, jss, jm1, jm2, jst, k, ka, kk;
   complex double zaj, deter, *scm = NULL;
+  mem_arena_mark_t mark;
 
   mp2=2* data.mp;
   npeq= data.np+ mp2;
@@ -586,7 +589,8 @@ cmset( int nrow, complex double *cmx, double rkhx, int iexkx )
 
   if( matpar.icase == 1)
     return;
-  mem_array_alloc(&scm, data.np2m);
+  mark = mem_arena_mark();
+  mem_arena_array(&scm, data.np2m);
 
   /* combine elements for symmetry modes */
   for( i = 0; i < it; i++ )
@@ -623,8 +627,7 @@ cmset( int nrow, complex double *cmx, double rkhx, int iexkx )
 
   } /* for( i = 0; i < it; i++ ) */
 
-  mem_array_free(&scm);
-
+  mem_arena_rewind(mark);
   return;
 }
 
@@ -641,6 +644,7 @@ matrix_data_free( void )
 {
   mem_array_free( &cm );
   mem_array_free( &emel );
+  lu_update_free();
 
   /* Close the library the solver bound, now that computation has stopped. */
   mathlib_shutdown();
@@ -671,23 +675,23 @@ cmsw( int j1, int j2, int i1, int i2, complex double *cmx,
     for( i = i1-1; i < i2; i++ )
     {
       k++;
-      xi= data.segments[i].x;
-      yi= data.segments[i].y;
-      zi= data.segments[i].z;
-      cabi= data.segments[i].cab;
-      sabi= data.segments[i].sab;
-      salpi= data.segments[i].salp;
+      xi= data.obs[i].x;
+      yi= data.obs[i].y;
+      zi= data.obs[i].z;
+      cabi= data.obs[i].cab;
+      sabi= data.obs[i].sab;
+      salpi= data.obs[i].salp;
       ipch=0;
 
-      if(data.segments[i].icon1 >= PCHCON)
+      if(data.con[i].icon1 >= PCHCON)
       {
-        ipch= data.segments[i].icon1-PCHCON;
+        ipch= data.con[i].icon1-PCHCON;
         fsign=-1.0;
       }
 
-      if(data.segments[i].icon2 >= PCHCON)
+      if(data.con[i].icon2 >= PCHCON)
       {
-        ipch= data.segments[i].icon2-PCHCON;
+        ipch= data.con[i].icon2-PCHCON;
         fsign=1.0;
       }
 
@@ -719,7 +723,7 @@ cmsw( int j1, int j2, int i1, int i2, complex double *cmx,
             {
               pcint( xi, yi, zi, cabi, sabi, salpi, emel);
 
-              pyl= M_PI* data.segments[i].si * fsign;
+              pyl= M_PI* data.obs[i].si * fsign;
               pxl= sin( pyl);
               pyl= cos( pyl);
               dataj.exc= emel[8]* fsign;
@@ -818,7 +822,7 @@ etmns( double p1, double p2, double p3, double p4,
       for( i = 0; i < vsorc.nsant; i++ )
       {
         is= vsorc.isant[i]-1;
-        e[is]= -vsorc.vsant[i]/(data.segments[is].si * data.wlam);
+        e[is]= -vsorc.vsant[i]/(data.obs[is].si * data.wlam);
       }
     }
 
@@ -877,9 +881,9 @@ etmns( double p1, double p2, double p3, double p4,
       {
         for( i = 0; i < data.n; i++ )
         {
-          arg= -M_2PI*( wx* data.segments[i].x + wy* data.segments[i].y + wz* data.segments[i].z);
-          e[i]=-( pxl* data.segments[i].cab + pyl* data.segments[i].sab + pzl*
-                 data.segments[i].salp)* cmplx( cos( arg), sin( arg));
+          arg= -M_2PI*( wx* data.obs[i].x + wy* data.obs[i].y + wz* data.obs[i].z);
+          e[i]=-( pxl* data.obs[i].cab + pyl* data.obs[i].sab + pzl*
+                 data.obs[i].salp)* cmplx( cos( arg), sin( arg));
         }
 
         if( gnd.ksymp != 1)
@@ -891,9 +895,9 @@ etmns( double p1, double p2, double p3, double p4,
 
           for( i = 0; i < data.n; i++ )
           {
-            arg= -M_2PI*( wx* data.segments[i].x + wy* data.segments[i].y - wz* data.segments[i].z);
-            e[i]= e[i]-( cx* data.segments[i].cab + cy* data.segments[i].sab +
-                        cz* data.segments[i].salp)* cmplx(cos( arg), sin( arg));
+            arg= -M_2PI*( wx* data.obs[i].x + wy* data.obs[i].y - wz* data.obs[i].z);
+            e[i]= e[i]-( cx* data.obs[i].cab + cy* data.obs[i].sab +
+                        cz* data.obs[i].salp)* cmplx(cos( arg), sin( arg));
           }
 
         } /* if( gnd.ksymp != 1) */
@@ -961,9 +965,9 @@ etmns( double p1, double p2, double p3, double p4,
 
       for( i = 0; i < data.n; i++ )
       {
-        arg= -M_2PI*( wx* data.segments[i].x + wy* data.segments[i].y + wz* data.segments[i].z);
-        e[i]=-( cx* data.segments[i].cab + cy* data.segments[i].sab +
-               cz * data.segments[i].salp)* cmplx( cos( arg), sin( arg));
+        arg= -M_2PI*( wx* data.obs[i].x + wy* data.obs[i].y + wz* data.obs[i].z);
+        e[i]=-( cx* data.obs[i].cab + cy* data.obs[i].sab +
+               cz * data.obs[i].salp)* cmplx( cos( arg), sin( arg));
       }
 
       if( gnd.ksymp != 1)
@@ -975,9 +979,9 @@ etmns( double p1, double p2, double p3, double p4,
 
         for( i = 0; i < data.n; i++ )
         {
-          arg= -M_2PI*( wx* data.segments[i].x + wy* data.segments[i].y - wz* data.segments[i].z);
-          e[i]= e[i]-( cx* data.segments[i].cab + cy* data.segments[i].sab +
-                      cz* data.segments[i].salp)* cmplx(cos( arg), sin( arg));
+          arg= -M_2PI*( wx* data.obs[i].x + wy* data.obs[i].y - wz* data.obs[i].z);
+          e[i]= e[i]-( cx* data.obs[i].cab + cy* data.obs[i].sab +
+                      cz* data.obs[i].salp)* cmplx(cos( arg), sin( arg));
         }
 
       } /* if( gnd.ksymp != 1) */
@@ -1060,9 +1064,9 @@ etmns( double p1, double p2, double p3, double p4,
     }
     else
     {
-      pxl= data.segments[i].x - p1;
-      pyl= data.segments[i].y - p2;
-      pzl= data.segments[i].z - p3;
+      pxl= data.obs[i].x - p1;
+      pyl= data.obs[i].y - p2;
+      pzl= data.obs[i].z - p3;
     }
 
     rs= pxl* pxl+ pyl* pyl+ pzl* pzl;
@@ -1120,8 +1124,8 @@ etmns( double p1, double p2, double p3, double p4,
       cx= ezh* wx+ erh* qx;
       cy= ezh* wy+ erh* qy;
       cz= ezh* wz+ erh* qz;
-      e[i]=-( cx* data.segments[i].cab +
-             cy* data.segments[i].sab + cz* data.segments[i].salp);
+      e[i]=-( cx* data.obs[i].cab +
+             cy* data.obs[i].sab + cz* data.obs[i].salp);
     }
     else
     {
@@ -1157,7 +1161,8 @@ int factr_gauss_elim( int n, complex double *a, int *ip, int ndim)
   int r, rm1, rp1, pj, pr, iflg, k, j, jp1, i;
   double dmax, elmag;
   complex double arj, *scm = NULL;
-  mem_array_alloc(&scm, data.np2m);
+  mem_arena_mark_t mark = mem_arena_mark();
+  mem_arena_array(&scm, data.np2m);
 
   // Notice: Un-transposition of the matrix for Gauss elimination 
   // was previously performed in this function from the original NEC2
@@ -1242,8 +1247,7 @@ int factr_gauss_elim( int n, complex double *a, int *ip, int ndim)
 
   } /* for( r=0; r < n; r++ ) */
 
-  mem_array_free(&scm);
-
+  mem_arena_rewind(mark);
   return 0;
 }
 
@@ -1386,7 +1390,8 @@ int solve_gauss_elim( int n, complex double *a, int *ip,
 {
   int i, ip1, j, k, pia;
   complex double sum, *scm = NULL;
-  mem_array_alloc(&scm, data.np2m);
+  mem_arena_mark_t mark = mem_arena_mark();
+  mem_arena_array(&scm, data.np2m);
 
   /* forward substitution */
   for( i = 0; i < n; i++ )
@@ -1415,8 +1420,7 @@ int solve_gauss_elim( int n, complex double *a, int *ip,
     b[i]=( scm[i]- sum)/ a[i+i*ndim];
   }
 
-  mem_array_free(&scm);
-
+  mem_arena_rewind(mark);
   return 0;
 }
 
@@ -1451,13 +1455,15 @@ solves( complex double *a, int *ip,
   int npeq, nrow, ic, i, kk, ia, ib, j, k;
   double fnop, fnorm;
   complex double  sum, *scm = NULL;
+  mem_arena_mark_t mark;
 
   npeq= np+ 2*mp;
   smat.nop = neq/npeq;
   fnop= smat.nop;
   fnorm=1.0/ fnop;
   nrow= neq;
-  mem_array_alloc(&scm, data.np2m);
+  mark = mem_arena_mark();
+  mem_arena_array(&scm, data.np2m);
 
   if( smat.nop != 1)
   {
@@ -1545,7 +1551,9 @@ solves( complex double *a, int *ip,
 
   if( smat.nop == 1)
   {
-    mem_array_free(&scm);
+    /* Factors restored from a base with other loads */
+    lu_update_apply( a, b, neq, nrh );
+    mem_arena_rewind(mark);
     return;
   }
 
@@ -1616,8 +1624,7 @@ solves( complex double *a, int *ip,
 
   } /* for( ic = 0; ic < nrh; ic++ ) */
 
-  mem_array_free(&scm);
-
+  mem_arena_rewind(mark);
   return;
 }
 
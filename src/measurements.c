@@ -1,5 +1,7 @@
 #include "common.h"
 #include "shared.h"
+#include "fmt_double.h"
+#include "touchstone.h"
 
 #define clog10(z) (clog(z) / log(10))
 
@@ -557,32 +559,44 @@ static void _meas_calc(measurement_t *m, int idx, int port)
 
 	int have_impedance = meas_has_impedance(idx);
 
+	/* Single-port consumers read the caller-selected excitation port. */
+	impedance_data_t *imp = have_impedance ? &impedance_data[idx] : NULL;
+	double complex z_load = 0;
+	double network_gain = NAN;
+	int network = FALSE;
+
+	/* A loaded Touchstone network moves the feedpoint impedance to its
+	 * other port; steps outside its frequencies have no impedance. */
 	if (have_impedance)
 	{
-		/* Single-port consumers read the caller-selected excitation port. */
-		impedance_data_t *imp = &impedance_data[idx];
+		z_load = imp->zreal[port] + I*imp->zimag[port];
+		network = touchstone_network_apply(m->mhz, &z_load, calc_data.zo, &network_gain);
+		if (network && isnan(creal(z_load)))
+			have_impedance = FALSE;
+	}
 
+	if (have_impedance)
+	{
 		double Zr, Zi, Zo = calc_data.zo;
 
-		double zrpro2 = imp->zreal[port] + calc_data.zo;
+		double zrpro2 = creal(z_load) + calc_data.zo;
 		zrpro2 *= zrpro2;
 
-		double zrmro2 = imp->zreal[port] - calc_data.zo;
+		double zrmro2 = creal(z_load) - calc_data.zo;
 		zrmro2 *= zrmro2;
 
-		double zimag2 = imp->zimag[port] * imp->zimag[port];
+		double zimag2 = cimag(z_load) * cimag(z_load);
 		double gamma = sqrt( (zrmro2 + zimag2) / (zrpro2 + zimag2) );
 
-		double complex z_load = imp->zreal[port] + I*imp->zimag[port];
 		double complex cgamma = (z_load-Zo) / (z_load+Zo);
 
 		double complex cs11 = 20*clog10( cgamma );
 
-		Zr = m->zreal = imp->zreal[port];
-		Zi = m->zimag = imp->zimag[port];
+		Zr = m->zreal = creal(z_load);
+		Zi = m->zimag = cimag(z_load);
 
-		m->zmag = imp->zmagn[port];
-		m->zphase = imp->zphase[port];
+		m->zmag = network ? cabs(z_load) : imp->zmagn[port];
+		m->zphase = network ? cang(z_load) : imp->zphase[port];
 
 		m->vswr = (1 + gamma) / (1 - gamma);
 		m->s11 = 20*log10( gamma );
@@ -592,14 +606,20 @@ static void _meas_calc(measurement_t *m, int idx, int port)
 		m->s11_imag = cimag(cs11);
 		m->s11_ang = cang(cgamma);
 
-		net_gain_adjust = 10.0 * log10( 4.0 * Zr * Zo / (pow(Zr + Zo, 2.0) + pow( Zi, 2.0 )) );
+		/* Through a cascaded network the delivered power is its
+		 * transducer gain rather than the mismatch at its input */
+		if (!isnan(network_gain))
+			net_gain_adjust = network_gain;
+		else
+			net_gain_adjust = 10.0 * log10( 4.0 * Zr * Zo / (pow(Zr + Zo, 2.0) + pow( Zi, 2.0 )) );
 	}
 
 	// Everything below here is dependent on the radiation pattern
 	// having been calculated, so fields will remain invalid (-1).
 	// The rad_pattern outer array is always allocated; ENABLE_RDPAT is
 	// the authoritative signal that its per-fstep gain sub-buffers exist.
-	if (isFlagClear(ENABLE_RDPAT))
+	// A sweep that skipped the pattern left them as an earlier sweep did.
+	if (isFlagClear(ENABLE_RDPAT) || (calc_data.solve_skip & SOLVE_SKIP_RDPAT))
 		return;
 
 	/* Validate pol before indexing into NUM_POL-sized arrays */
@@ -840,7 +860,8 @@ void meas_calc(measurement_t *m, int idx, int port)
 // Format a string with values from the measurement.
 //         m: The measurement provided by meas_calc()
 //    format: The format string. For example "{mhz} {vswr}" becomes "1.8 2.0"
-//            Format is %.17g, so you need about 19 chars per formatted value.
+//            Format is %.17g in the C locale (see fmt_g17()), so you need
+//            about 25 chars per formatted value.
 //            Available format specifiers are above in meas_names[].
 //
 //        out: The output buffer, eg: char out[MEAS_COUNT*25];
@@ -849,7 +870,8 @@ void meas_format(measurement_t *m, const char *format, char *out, int outlen)
 {
 	char *o;
 	const char *p, *name;
-	setlocale(LC_NUMERIC, "C");
+	char num[FMT_G17_LEN];
+	int len;
 
 	o = out;
 	name = NULL;
@@ -874,7 +896,11 @@ void meas_format(measurement_t *m, const char *format, char *out, int outlen)
 
 			if (idx != MEAS_COUNT)
 			{
-				o += snprintf(o, outlen-(o-out)-1, "%.17g", m->a[idx]);
+				len = fmt_g17(num, m->a[idx]);
+				if (len > outlen-(o-out)-1)
+					len = outlen-(o-out)-1;
+				memcpy(o, num, len);
+				o += len;
 				*o = 0;
 				name = NULL;
 			}
@@ -887,8 +913,6 @@ void meas_format(measurement_t *m, const char *format, char *out, int outlen)
 			*o = 0;
 		}
 	}
-
-	setlocale(LC_NUMERIC, orig_numeric_locale);
 }
 
 int meas_write_format(measurement_t *m, const char *format, FILE *fp)
@@ -906,9 +930,9 @@ int meas_write_format(measurement_t *m, const char *format, FILE *fp)
 			count++;
 	}
 
-	// mreq length is 20*count of formatted strings to get all the floating point digits
-	// plus the total number of chars in `format` should be more than enough.
-	mreq = 20*count+len;
+	// mreq length is FMT_G17_LEN*count of formatted strings to get all the floating
+	// point digits plus the total number of chars in `format` is enough.
+	mreq = FMT_G17_LEN*count+len;
 	mem_alloc(&s, mreq);
 
 	meas_format(m, format, s, mreq-1);
@@ -917,26 +941,74 @@ int meas_write_format(measurement_t *m, const char *format, FILE *fp)
 	return ret;
 }
 
-// Print headers:
-// Enclose the headerin the strings left and right.  For example, if 
-// left and right are both "\"" then it will quote the header name.
-void meas_write_header_enc(FILE *fp, char *delim, char *left, char *right)
+// Print the names of the measurement columns in cols, or of every
+// measurement when cols is NULL, then end the line.
+static void meas_write_names(FILE *fp, const int *cols, int num_cols,
+	char *delim, char *left, char *right)
 {
 	int i;
 
 	if (left == NULL) left = "";
 	if (right == NULL) right = "";
 
-	// Print names
-	for (i = 0; i < MEAS_COUNT; i++)
+	for (i = 0; i < num_cols; i++)
 	{
-		fprintf(fp, "%s%s%s", left, meas_names[i], right);
-		if (i < MEAS_COUNT-1)
+		fprintf(fp, "%s%s%s", left, meas_names[cols ? cols[i] : i], right);
+		if (i < num_cols-1)
 			fputs(delim, fp);
 	}
 	fprintf(fp, "\n");
 }
 
+// Print the measurement columns in cols of one step, or every column
+// when cols is NULL, then end the line.  The row is built in memory and
+// written with one call; values are %.17g in the C locale (fmt_g17()).
+static void meas_write_values(FILE *fp, const measurement_t *meas,
+	const int *cols, int num_cols, char *delim, char *left, char *right)
+{
+	char *line = NULL;
+	char *o;
+	size_t ll, rl, dl;
+	int i;
+
+	if (left == NULL) left = "";
+	if (right == NULL) right = "";
+
+	ll = strlen(left);
+	rl = strlen(right);
+	dl = strlen(delim);
+
+	mem_alloc(&line, num_cols * (FMT_G17_LEN + ll + rl + dl) + 2);
+	o = line;
+
+	for (i = 0; i < num_cols; i++)
+	{
+		memcpy(o, left, ll);
+		o += ll;
+		o += fmt_g17(o, meas->a[cols ? cols[i] : i]);
+		memcpy(o, right, rl);
+		o += rl;
+
+		if (i < num_cols-1)
+		{
+			memcpy(o, delim, dl);
+			o += dl;
+		}
+	}
+	*o++ = '\n';
+
+	fwrite(line, 1, o - line, fp);
+	mem_free(&line);
+}
+
+// Print headers:
+// Enclose the headerin the strings left and right.  For example, if 
+// left and right are both "\"" then it will quote the header name.
+void meas_write_header_enc(FILE *fp, char *delim, char *left, char *right)
+{
+	meas_write_names(fp, NULL, MEAS_COUNT, delim, left, right);
+}
+
 void meas_write_header(FILE *fp, char *delim)
 {
 	meas_write_header_enc(fp, delim, "", "");
@@ -949,25 +1021,13 @@ void meas_write_header(FILE *fp, char *delim)
 void meas_write_data_enc(FILE *fp, char *delim, char *left, char *right)
 {
 	measurement_t meas;
-	int i, idx;
-	setlocale(LC_NUMERIC, "C");
-
-	if (left == NULL) left = "";
-	if (right == NULL) right = "";
+	int idx;
 
 	for (idx = 0; idx < calc_data.steps_total; idx++)
 	{
 		meas_calc(&meas, idx, calc_data.ex_port);
-		for (i = 0; i < MEAS_COUNT; i++)
-		{
-			fprintf(fp, "%s%.17g%s", left, meas.a[i], right);
-			if (i < MEAS_COUNT-1)
-				fputs(delim, fp);
-		}
-		fprintf(fp, "\n");
+		meas_write_values(fp, &meas, NULL, MEAS_COUNT, delim, left, right);
 	}
-
-	setlocale(LC_NUMERIC, orig_numeric_locale);
 }
 
 void meas_write_data(FILE *fp, char *delim)
@@ -975,3 +1035,20 @@ void meas_write_data(FILE *fp, char *delim)
 	meas_write_data_enc(fp, delim, "", "");
 }
 
+// Print the header of a selection of measurement columns, as
+// meas_write_header() does for all of them.  cols holds measurement
+// indexes in column order.
+void meas_write_header_cols(FILE *fp, char *delim, const int *cols, int num_cols)
+{
+	meas_write_names(fp, cols, num_cols, delim, "", "");
+}
+
+// Print a selection of columns of one measurement as a row in the format
+// of meas_write_data(), for measurements not taken from the current
+// sweep or written one step at a time.
+void meas_write_row(FILE *fp, char *delim, const measurement_t *meas,
+	const int *cols, int num_cols)
+{
+	meas_write_values(fp, meas, cols, num_cols, delim, "", "");
+}
+
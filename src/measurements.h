@@ -295,4 +295,8 @@ void meas_write_data(FILE *fp, char *delim);
 void meas_write_header_enc(FILE *fp, char *delim, char *left, char *right);
 void meas_write_data_enc(FILE *fp, char *delim, char *left, char *right);
 
+void meas_write_header_cols(FILE *fp, char *delim, const int *cols, int num_cols);
+void meas_write_row(FILE *fp, char *delim, const measurement_t *meas,
+	const int *cols, int num_cols);
+
 #endif
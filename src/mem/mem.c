@@ -8,6 +8,23 @@
 _Static_assert(sizeof(mem_obj_t) <= MEM_HEADER_SIZE,
 	"mem_obj_t exceeds MEM_HEADER_SIZE");
 
+/* Blocks taken from posix_memalign, fresh and relocated; read as a
+ * difference across a span of work by mem_block_allocs() callers */
+static _Atomic uint64_t mem_block_count = 0;
+
+/**
+ * mem_block_allocs() - managed blocks allocated since startup
+ *
+ * Counts every posix_memalign the allocator performs, whether a fresh birth
+ * or a grow-beyond relocation; New_Frequency() reports the per-step delta.
+ *
+ * Return: the running block count
+ */
+uint64_t mem_block_allocs(void)
+{
+	return mem_block_count;
+}
+
 /**
  * _mem_validate_fail() - report corrupted mem_obj_t header via BUG
  * @ptr: user-facing pointer that failed validation
@@ -32,8 +49,8 @@ void _mem_validate_fail(void *ptr, void *base)
  *            NULL for a fresh allocation with no data to preserve.
  * @birth_src: birth-identity predecessor supplying serial, birth site, and
  *             backtrace ownership; non-NULL only on a grow-beyond relocation.
- *             NULL records @site and, when reporting is enabled, mints a
- *             fresh serial and captures a backtrace.
+ *             NULL records @site and, when the tracking tier selects the
+ *             block, mints a fresh serial and captures a backtrace.
  * @req: requested user-data size in bytes
  * @prev_used: bytes of old data to preserve (0 for fresh allocation)
  *
@@ -46,8 +63,10 @@ void _mem_validate_fail(void *ptr, void *base)
 static inline mem_obj_t *mem_obj_alloc(const mem_obj_t *data_src,
 	const mem_obj_t *birth_src, size_t req, size_t prev_used, const char *site)
 {
+	enum mem_track_tier tier = mem_track_tier();
 	void *base = NULL;
 	mem_obj_t *m;
+	bool track;
 	int rc;
 
 	/* Minimum 1-byte user region so m->ptr stays within the allocation */
@@ -58,6 +77,8 @@ static inline mem_obj_t *mem_obj_alloc(const mem_obj_t *data_src,
 	if (unlikely(rc != 0 || base == NULL))
 		return NULL;
 
+	mem_block_count++;
+
 	m = (mem_obj_t *)base;
 	m->size = req;
 	m->used = req;
@@ -68,17 +89,30 @@ static inline mem_obj_t *mem_obj_alloc(const mem_obj_t *data_src,
 	 * minting a fresh identity. A fresh allocation passes neither and starts at
 	 * the scalar/byte default while the array layer stamps width at birth. */
 	m->array_elem_size = (data_src != NULL) ? data_src->array_elem_size : 0;
+	/* Tracking decision, made once per block: the full tier tracks every
+	 * block; the sampling tier tracks a relocation exactly when its
+	 * predecessor was tracked, so a sampled block stays in the registry across
+	 * growth, and tracks one fresh block per sample period. */
+	if (likely(tier == MEM_TRACK_OFF))
+		track = false;
+	else if (tier == MEM_TRACK_FULL)
+		track = true;
+	else if (birth_src != NULL)
+		track = birth_src->registered;
+	else
+		track = mem_track_sample_tick(rc_config.mem_sample_period);
+
 	/* Birth identity: a grow-beyond block inherits its predecessor's serial,
 	 * site, and backtrace; a fresh block records the caller site and, only
-	 * while reporting is enabled, mints a serial and captures a backtrace.
-	 * When reporting is disabled a fresh block keeps serial 0 and a NULL
-	 * backtrace, which the free path null-checks before releasing. Each field
-	 * is written once so the registry link below adds no further identity. */
+	 * when tracked, mints a serial and captures a backtrace. An untracked
+	 * fresh block keeps serial 0 and a NULL backtrace, which the free path
+	 * null-checks before releasing. Each field is written once so the
+	 * registry link below adds no further identity. */
 	m->birth_site = (birth_src != NULL) ? birth_src->birth_site : site;
 	m->serial = (birth_src != NULL) ? birth_src->serial
-		: (unlikely(rc_config.mem_report_enabled) ? mem_track_next_serial() : 0);
+		: (unlikely(track) ? mem_track_next_serial() : 0);
 	m->backtrace = (birth_src != NULL) ? birth_src->backtrace
-		: (unlikely(rc_config.mem_report_enabled) ? _get_backtrace() : NULL);
+		: (unlikely(track) ? _get_backtrace() : NULL);
 	m->ptr = (char *)base + MEM_HEADER_SIZE;
 
 	/* Preserve old data when reallocating */
@@ -95,7 +129,7 @@ static inline mem_obj_t *mem_obj_alloc(const mem_obj_t *data_src,
 
 	// Initialize membership before the registry links reported blocks.
 	m->registered = false;
-	if (unlikely(rc_config.mem_report_enabled))
+	if (unlikely(track))
 		mem_track_register(m);
 
 	return m;
@@ -110,7 +144,8 @@ static inline mem_obj_t *mem_obj_alloc(const mem_obj_t *data_src,
  */
 static inline void mem_obj_free(mem_obj_t *m)
 {
-	mem_track_unregister(m);
+	if (unlikely(m->registered))
+		mem_track_unregister(m);
 	free(m->backtrace);
 	free(m);
 }
@@ -114,6 +114,7 @@ static inline void *_mem_realloc_fast(void **ptr, size_t req, char *str)
 #define mem_alloc(ptr, size)   _mem_realloc_fast((void **)(ptr), (size), __LOCATION__)
 #define mem_realloc(ptr, size) _mem_realloc_fast((void **)(ptr), (size), __LOCATION__)
 
+uint64_t mem_block_allocs(void);
 void mem_backtrace(void *ptr);
 void mem_obj_dump(void *ptr);
 void _mem_free(void **ptr, char *site);
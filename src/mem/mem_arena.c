@@ -0,0 +1,165 @@
+#include <pthread.h>
+
+#include "common.h"
+#include "console.h"
+#include "mem_arena.h"
+
+/* Primary block, carved front to back; rewound by mem_arena_reset() */
+static char   *arena_base = NULL;
+static size_t  arena_off  = 0;
+
+/* Overflow blocks taken when a step outgrows the primary block, the bytes
+ * live across all blocks, and the most that were live at once this step */
+static char  **arena_overflow = NULL;
+static size_t  arena_step_bytes = 0;
+static size_t  arena_peak_bytes = 0;
+static int     arena_spilled = FALSE;
+
+/* Slices handed out since the last reset */
+static int     arena_step_allocs = 0;
+
+/* Thread holding live slices; any other thread carving now is a bug */
+static pthread_t arena_owner;
+
+/* Round a request up to the alignment every slice keeps */
+static inline size_t arena_round(size_t req)
+{
+	return (req + MEM_ALIGNMENT - 1) & ~(size_t)(MEM_ALIGNMENT - 1);
+}
+
+/**
+ * _mem_arena_alloc() - carve a zeroed, aligned slice for the current step
+ * @elem_size: width of one element
+ * @n: element count
+ * @site: caller location, attributed to an overflow block
+ *
+ * Return: pointer to n * elem_size zeroed bytes, valid until the next reset
+ */
+void *_mem_arena_alloc(size_t elem_size, size_t n, char *site)
+{
+	size_t req = arena_round((n > 0 ? n : 1) * elem_size);
+	char *slice;
+
+	if (arena_step_bytes == 0)
+		arena_owner = pthread_self();
+	else
+		BUG_ON(!pthread_equal(arena_owner, pthread_self()),
+			"mem_arena: %s carves on a second thread\n", site);
+
+	arena_step_allocs++;
+	arena_step_bytes += req;
+	if (arena_step_bytes > arena_peak_bytes)
+		arena_peak_bytes = arena_step_bytes;
+
+	if (arena_base != NULL && arena_off + req <= (size_t)mem_array_count(arena_base))
+	{
+		slice = arena_base + arena_off;
+		arena_off += req;
+		memset(slice, 0, req);
+		return slice;
+	}
+
+	/* Outgrown: a dedicated block for this slice, folded into the primary
+	 * block at the next reset.  _mem_array_alloc zeroes it. */
+	slice = NULL;
+	_mem_array_alloc((void **)&slice, sizeof(char), req, site);
+
+	int count = mem_array_count(arena_overflow);
+	mem_array_realloc(&arena_overflow, count + 1);
+	arena_overflow[count] = slice;
+	arena_spilled = TRUE;
+
+	return slice;
+}
+
+/**
+ * mem_arena_mark() - note the arena's fill before taking call-local scratch
+ *
+ * Return: a mark for mem_arena_rewind()
+ */
+mem_arena_mark_t mem_arena_mark(void)
+{
+	mem_arena_mark_t mark = {
+		.off = arena_off,
+		.bytes = arena_step_bytes,
+		.overflow = mem_array_count(arena_overflow),
+	};
+
+	return mark;
+}
+
+/**
+ * mem_arena_rewind() - drop every slice taken since @mark
+ * @mark: value of mem_arena_mark() taken by the same caller
+ *
+ * Marks nest: a callee rewinds to its own mark before the caller rewinds to
+ * an earlier one, so scratch taken by a solve repeated within a step is
+ * reused rather than stacked.  Overflow blocks taken since @mark are
+ * released now; the step's high-water mark still sizes the primary block at
+ * the next reset.
+ */
+void mem_arena_rewind(mem_arena_mark_t mark)
+{
+	int count = mem_array_count(arena_overflow);
+
+	for (int i = mark.overflow; i < count; i++)
+		mem_array_free(&arena_overflow[i]);
+
+	if (mark.overflow == 0)
+		mem_array_free(&arena_overflow);
+	else if (mark.overflow < count)
+		mem_array_realloc(&arena_overflow, mark.overflow);
+
+	arena_off = mark.off;
+	arena_step_bytes = mark.bytes;
+}
+
+/**
+ * mem_arena_reset() - rewind the arena at the end of a frequency step
+ *
+ * Every slice handed out since the previous reset becomes invalid.  When the
+ * step spilled into overflow blocks, they are released and the primary block
+ * grows to the step's total so the next step of the same model fits.
+ */
+void mem_arena_reset(void)
+{
+	int count = mem_array_count(arena_overflow);
+
+	for (int i = 0; i < count; i++)
+		mem_array_free(&arena_overflow[i]);
+	mem_array_free(&arena_overflow);
+
+	if (arena_spilled)
+	{
+		/* Old contents are dead; free rather than copy them across */
+		mem_array_free(&arena_base);
+		mem_array_alloc(&arena_base, arena_peak_bytes);
+	}
+
+	arena_off = 0;
+	arena_step_bytes = 0;
+	arena_peak_bytes = 0;
+	arena_spilled = FALSE;
+	arena_step_allocs = 0;
+}
+
+/**
+ * mem_arena_release() - return every arena block to the managed allocator
+ *
+ * Called at teardown so the arena does not surface in the exit report.
+ */
+void mem_arena_release(void)
+{
+	mem_arena_reset();
+	mem_array_free(&arena_base);
+}
+
+/**
+ * mem_arena_step_allocs() - slices handed out since the last reset
+ *
+ * Return: the count of scratch requests the arena absorbed this step
+ */
+int mem_arena_step_allocs(void)
+{
+	return arena_step_allocs;
+}
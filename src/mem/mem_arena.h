@@ -0,0 +1,55 @@
+#ifndef MEM_ARENA_H
+#define MEM_ARENA_H
+
+#include <stddef.h>
+
+#include "mem.h"
+
+/* Bump allocator for scratch whose lifetime ends with the frequency step
+ * that takes it.  Solver scratch (pivot rows, symmetry transforms, network
+ * work arrays) is sized by the model and requested afresh on every step;
+ * through the managed allocator each request costs a posix_memalign and,
+ * under --mem-report, a registry link.  The arena carves those requests
+ * from one managed block instead, so the registry sees the block once, and
+ * New_Frequency() rewinds it when the step ends.
+ *
+ * Slices are zeroed and MEM_ALIGNMENT-aligned like a fresh managed array,
+ * but carry no header: they are never passed to a mem_* verb and never
+ * freed individually.  A step that outgrows the block takes overflow
+ * blocks; the rewind folds them into one block sized for the high-water
+ * mark, so a steady sweep takes no managed allocation per step.  Scratch
+ * that dies with its call sits between mem_arena_mark() and
+ * mem_arena_rewind(), so a solve repeated within one step reuses its bytes.
+ *
+ * The arena is single-threaded and takes no lock.  It belongs to whichever
+ * thread runs New_Frequency(), which holds freq_data_lock from its first
+ * slice to the reset, so the arena is empty whenever it changes hands.  A
+ * slice carved on a second thread while another holds live slices is a
+ * BUG(). */
+typedef struct
+{
+	size_t off;
+	size_t bytes;
+	int    overflow;
+} mem_arena_mark_t;
+
+void *_mem_arena_alloc(size_t elem_size, size_t n, char *site);
+mem_arena_mark_t mem_arena_mark(void);
+void mem_arena_rewind(mem_arena_mark_t mark);
+void mem_arena_reset(void);
+void mem_arena_release(void);
+int mem_arena_step_allocs(void);
+
+/**
+ * mem_arena_array() - take step-lifetime scratch for @n elements of *@pp
+ * @pp: address of the caller's typed pointer
+ * @n: element count
+ *
+ * The slice stays valid until the next mem_arena_reset(); drop the pointer
+ * rather than freeing it.
+ */
+#define mem_arena_array(pp, n) \
+	((void)MEM_ARRAY_TYPED(pp), \
+	 *(pp) = _mem_arena_alloc(sizeof(**(pp)), (n), __LOCATION__))
+
+#endif /* MEM_ARENA_H */
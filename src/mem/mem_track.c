@@ -13,6 +13,7 @@
  * registry mutex so a birth stamp never contends with a link or unlink. */
 static mem_obj_t *mem_reg_head;
 static _Atomic uint64_t mem_serial_seq;
+static _Atomic uint64_t mem_sample_seq;
 static pthread_mutex_t mem_track_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* Report-time snapshot record. mem_report copies the live registry into a
@@ -89,6 +90,20 @@ uint64_t mem_track_next_serial(void)
 	return atomic_fetch_add(&mem_serial_seq, 1) + 1;
 }
 
+/**
+ * mem_track_sample_tick() - decide whether a fresh block joins the sample
+ * @period: sampling period, one tracked block per @period fresh blocks
+ *
+ * Counts fresh births on a lock-free counter shared by every allocating
+ * thread, so the sampled share holds at 1/@period whatever the interleaving.
+ *
+ * Return: true for the first birth of each period
+ */
+bool mem_track_sample_tick(int period)
+{
+	return atomic_fetch_add(&mem_sample_seq, 1) % (uint64_t)period == 0;
+}
+
 /**
  * mem_report_dup_frames() - deep-copy a backtrace frame array for the snapshot
  * @frames: NULL-terminated birth backtrace owned by a live block, or NULL
@@ -130,7 +145,8 @@ static char **mem_report_dup_frames(char *const *frames)
  * aggregate line per first-seen birth site, grouping later records by
  * birth_site pointer equality and summing survivor count, bytes, and the
  * serial span; a totals line follows with live block, byte, and distinct-site
- * counts. Pass two emits one line per survivor and, when the survivor carries
+ * counts, scaled into an estimate when the sampling tier filled the registry.
+ * Pass two emits one line per survivor and, when the survivor carries
  * a birth backtrace, one line per call-path frame. The forked compute child
  * runs this identical path.
  */
@@ -213,6 +229,16 @@ void mem_report(const char *tag)
 	pr_info("mem-report %s: live_blocks=%llu live_bytes=%llu distinct_sites=%llu\n",
 		tag, count, live_bytes, distinct_sites);
 
+	/* A sampled registry holds about one block in period; scale the totals
+	 * so the estimate reads against a full report of the same run. */
+	if (mem_track_tier() == MEM_TRACK_SAMPLE)
+	{
+		unsigned long long period = (unsigned long long)rc_config.mem_sample_period;
+
+		pr_info("mem-report %s: sampled 1/%llu est_live_blocks=%llu est_live_bytes=%llu\n",
+			tag, period, count * period, live_bytes * period);
+	}
+
 	/* Pass two: one line per survivor, then its captured birth call path. */
 	for (unsigned long long i = 0; i < count; i++)
 	{
@@ -1,6 +1,7 @@
 #ifndef MEM_TRACK_H
 #define MEM_TRACK_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "mem.h"
@@ -13,6 +14,41 @@
 void mem_track_register(mem_obj_t *m);
 void mem_track_unregister(mem_obj_t *m);
 uint64_t mem_track_next_serial(void);
+bool mem_track_sample_tick(int period);
 void mem_report(const char *tag);
 
+/* Tracking tiers, cheapest first.  OFF leaves the allocation path with one
+ * predictable branch; SAMPLE registers one fresh block in every
+ * rc_config.mem_sample_period (--mem-sample) so a long production run can
+ * still attribute its live set by site at a fraction of the cost; FULL
+ * (--mem-report) registers every block and captures every backtrace.  A
+ * build configured with --disable-mem-track defines MEM_TRACK_DISABLE and
+ * pins the tier to OFF, so the compiler drops the tracking paths outright.
+ * Includers see rc_config through common.h, included first. */
+enum mem_track_tier
+{
+	MEM_TRACK_OFF,
+	MEM_TRACK_SAMPLE,
+	MEM_TRACK_FULL
+};
+
+/**
+ * mem_track_tier() - tracking tier selected for this run
+ *
+ * Return: MEM_TRACK_FULL under --mem-report, MEM_TRACK_SAMPLE under
+ * --mem-sample, else MEM_TRACK_OFF
+ */
+static inline enum mem_track_tier mem_track_tier(void)
+{
+#ifdef MEM_TRACK_DISABLE
+	return MEM_TRACK_OFF;
+#else
+	if (unlikely(rc_config.mem_report_enabled))
+		return MEM_TRACK_FULL;
+	if (unlikely(rc_config.mem_sample_period > 0))
+		return MEM_TRACK_SAMPLE;
+	return MEM_TRACK_OFF;
+#endif
+}
+
 #endif /* MEM_TRACK_H */
@@ -0,0 +1,242 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  The official website and doumentation for xnec2c is available here:
+ *    https://www.xnec2c.org/
+ */
+
+#include "shared.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Binary model cache (--model-cache).  The geometry section of a deck
+ * expands into the segment and patch arrays through readgm(), expression
+ * evaluation, reflc(), move(), patch() and conect(); on a large generated
+ * deck that dominates the load.  After a full parse the expanded arrays
+ * and the connection state are written beside the deck as model.nec.bin,
+ * under a key the caller derives from the geometry cards and the symbol
+ * values they read (.sy overrides included).  A later load whose key
+ * matches maps the file and copies the arrays out of it instead of
+ * parsing the section.
+ *
+ * The arrays are copied rather than used in place because the solver
+ * grows data.segments and the segj buffers through the managed allocator.
+ * The file is native-endian with the struct layout of the build that
+ * wrote it; a file from another build or host misses and is rewritten. */
+
+#define MODEL_CACHE_MAGIC    "XNECBIN"
+#define MODEL_CACHE_VERSION  1
+#define MODEL_CACHE_ORDER    0x01020304u
+
+typedef struct
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t order;        /* MODEL_CACHE_ORDER as written */
+  uint32_t seg_size;     /* sizeof(wire_segment_t) */
+  uint32_t patch_size;   /* sizeof(surface_patch_t) */
+  guint8   key[MODEL_CACHE_KEY_LEN];
+  int32_t  n, np, m, mp, ipsym;
+  int32_t  gpflag;       /* ITG of the GE card */
+  int32_t  maxcon;       /* segj buffer length from conect() */
+  int32_t  reserved;
+} model_cache_header_t;
+
+/*-----------------------------------------------------------------------*/
+
+/* Fills the header of the geometry now in data */
+  static void
+model_cache_header( model_cache_header_t *hdr, const guint8 *key )
+{
+  memset( hdr, 0, sizeof(*hdr) );
+  memcpy( hdr->magic, MODEL_CACHE_MAGIC, sizeof(MODEL_CACHE_MAGIC) );
+  hdr->version    = MODEL_CACHE_VERSION;
+  hdr->order      = MODEL_CACHE_ORDER;
+  hdr->seg_size   = sizeof(wire_segment_t);
+  hdr->patch_size = sizeof(surface_patch_t);
+  memcpy( hdr->key, key, MODEL_CACHE_KEY_LEN );
+  hdr->n      = data.n;
+  hdr->np     = data.np;
+  hdr->m      = data.m;
+  hdr->mp     = data.mp;
+  hdr->ipsym  = data.ipsym;
+  hdr->gpflag = gnd.gpflag;
+  hdr->maxcon = segj.maxcon;
+}
+
+/* Returns the payload bytes after a header, or 0 if its counts are not
+ * ones conect() leaves */
+  static size_t
+model_cache_payload( const model_cache_header_t *hdr )
+{
+  if( (hdr->n < 0) || (hdr->m < 0) || (hdr->n + hdr->m <= 0) ||
+      (hdr->np < 0) || (hdr->np > hdr->n) ||
+      (hdr->mp < 0) || (hdr->mp > hdr->m) ||
+      (hdr->maxcon < 0) || ((hdr->n > 0) && (hdr->maxcon == 0)) )
+    return( 0 );
+
+  return( (size_t)hdr->n * sizeof(wire_segment_t) +
+      (size_t)hdr->m * sizeof(surface_patch_t) );
+}
+
+/*-----------------------------------------------------------------------*/
+
+/* model_cache_load()
+ *
+ * Maps the cache file at path and, when it was written for key by this
+ * build, copies its segments, patches and connection state into data,
+ * segj and gnd as datagn() leaves them at the GE card.  Returns FALSE,
+ * leaving the geometry untouched, on a missing, stale or damaged file.
+ */
+  gboolean
+model_cache_load( const char *path, const guint8 *key )
+{
+  const model_cache_header_t *hdr;
+  const unsigned char *map;
+  struct stat st;
+  size_t payload;
+  int fd;
+
+  fd = open( path, O_RDONLY );
+  if( fd < 0 )
+    return( FALSE );
+
+  if( (fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(*hdr)) )
+  {
+    close( fd );
+    return( FALSE );
+  }
+
+  map = mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+  if( map == MAP_FAILED )
+  {
+    pr_warn("model_cache_load: cannot map %s: %s\n", path, strerror(errno));
+    return( FALSE );
+  }
+
+  hdr = (const model_cache_header_t *)map;
+  payload = model_cache_payload( hdr );
+
+  /* Written for another deck, by another build, or cut short */
+  if( (memcmp(hdr->magic, MODEL_CACHE_MAGIC, sizeof(MODEL_CACHE_MAGIC)) != 0) ||
+      (hdr->version != MODEL_CACHE_VERSION) ||
+      (hdr->order != MODEL_CACHE_ORDER) ||
+      (hdr->seg_size != sizeof(wire_segment_t)) ||
+      (hdr->patch_size != sizeof(surface_patch_t)) ||
+      (memcmp(hdr->key, key, MODEL_CACHE_KEY_LEN) != 0) ||
+      (payload == 0) ||
+      ((size_t)st.st_size != sizeof(*hdr) + payload) )
+  {
+    pr_debug("model_cache_load: %s does not match the deck\n", path);
+    munmap( (void *)map, (size_t)st.st_size );
+    return( FALSE );
+  }
+
+  data.n     = hdr->n;
+  data.np    = hdr->np;
+  data.m     = hdr->m;
+  data.mp    = hdr->mp;
+  data.ipsym = hdr->ipsym;
+  gnd.gpflag = hdr->gpflag;
+
+  /* Sized as conect() and patch() leave them */
+  if( data.n > 0 )
+  {
+    mem_array_realloc( &data.segments, data.n + data.m );
+    memcpy( data.segments, map + sizeof(*hdr),
+        (size_t)data.n * sizeof(wire_segment_t) );
+
+    segj.maxcon = hdr->maxcon;
+    mem_array_realloc( &segj.jco, segj.maxcon );
+    mem_array_realloc( &segj.ax, segj.maxcon );
+    mem_array_realloc( &segj.bx, segj.maxcon );
+    mem_array_realloc( &segj.cx, segj.maxcon );
+  }
+
+  if( data.m > 0 )
+  {
+    mem_array_realloc( &data.patches, data.m );
+    memcpy( data.patches,
+        map + sizeof(*hdr) + (size_t)data.n * sizeof(wire_segment_t),
+        (size_t)data.m * sizeof(surface_patch_t) );
+  }
+
+  data.npm  = data.n + data.m;
+  data.np2m = data.n + 2 * data.m;
+  data.np3m = data.n + 3 * data.m;
+
+  munmap( (void *)map, (size_t)st.st_size );
+
+  pr_info("Read_Geometry: %d segments and %d patches from %s\n",
+      data.n, data.m, path);
+
+  return( TRUE );
+} /* model_cache_load() */
+
+/*-----------------------------------------------------------------------*/
+
+/* model_cache_save()
+ *
+ * Writes the geometry now in data to the cache file at path under key.
+ * The file is written beside path and renamed over it, so a reader never
+ * maps a partial file.  Failure only costs the next load its shortcut.
+ */
+  void
+model_cache_save( const char *path, const guint8 *key )
+{
+  model_cache_header_t hdr;
+  char tmp[FILENAME_LEN + 8];
+  FILE *fp;
+  gboolean ok;
+
+  model_cache_header( &hdr, key );
+  if( model_cache_payload(&hdr) == 0 )
+    return;
+
+  snprintf( tmp, sizeof(tmp), "%s.tmp", path );
+  fp = fopen( tmp, "wb" );
+  if( fp == NULL )
+  {
+    pr_warn("model_cache_save: cannot open %s: %s\n", tmp, strerror(errno));
+    return;
+  }
+
+  ok = (fwrite(&hdr, sizeof(hdr), 1, fp) == 1);
+  if( ok && (data.n > 0) )
+    ok = (fwrite(data.segments, sizeof(wire_segment_t), (size_t)data.n, fp) ==
+        (size_t)data.n);
+  if( ok && (data.m > 0) )
+    ok = (fwrite(data.patches, sizeof(surface_patch_t), (size_t)data.m, fp) ==
+        (size_t)data.m);
+
+  if( fclose(fp) != 0 )
+    ok = FALSE;
+
+  if( !ok || (rename(tmp, path) != 0) )
+  {
+    pr_warn("model_cache_save: cannot write %s: %s\n", path, strerror(errno));
+    remove( tmp );
+    return;
+  }
+
+  pr_debug("model_cache_save: %d segments and %d patches to %s\n",
+      data.n, data.m, path);
+
+} /* model_cache_save() */
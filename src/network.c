@@ -59,6 +59,7 @@ netwk( complex double *cmx, int *ip, complex double *einc )
   double pwr;
   complex double *vsrc = NULL, *rhs = NULL, *cmn = NULL;
   complex double *rhnt = NULL, *rhnx = NULL, ymit, vlt, cux;
+  mem_arena_mark_t mark;
 
   netcx.pin=0.0;
   netcx.pnls=0.0;
@@ -72,21 +73,23 @@ netwk( complex double *cmx, int *ip, complex double *einc )
   neqt= netcx.neq+ netcx.neq2;
   ndimn = j = (2*netcx.nonet + vsorc.nsant);
 
-  /* Allocate network buffers */
+  /* Network scratch lives for this pass; the solves below rewind their
+   * own, and every exit rewinds to this mark */
+  mark = mem_arena_mark();
   if( netcx.nonet > 0 )
   {
-    mem_array_alloc(&rhs, data.np3m);
-    mem_array_alloc(&rhnt, j);
-    mem_array_alloc(&rhnx, j);
-    mem_array_alloc(&cmn, (size_t)j * j);
-    mem_array_alloc(&ntsca, j);
-    mem_array_alloc(&nteqa, j);
-    mem_array_alloc(&ipnt, j);
-    mem_array_alloc(&vsrc, vsorc.nsant);
+    mem_arena_array(&rhs, data.np3m);
+    mem_arena_array(&rhnt, j);
+    mem_arena_array(&rhnx, j);
+    mem_arena_array(&cmn, (size_t)j * j);
+    mem_arena_array(&ntsca, j);
+    mem_arena_array(&nteqa, j);
+    mem_arena_array(&ipnt, j);
+    mem_arena_array(&vsrc, vsorc.nsant);
   }
   else if( netcx.masym != 0)
   {
-    mem_array_alloc(&ipnt, j);
+    mem_arena_array(&ipnt, j);
   }
 
 
@@ -515,15 +518,7 @@ netwk( complex double *cmx, int *ip, complex double *einc )
 
   if( (vsorc.nsant+vsorc.nvqd) == 0)
   {
-    /* Free network buffers */
-    mem_array_free(&ipnt);
-    mem_array_free(&nteqa);
-    mem_array_free(&ntsca);
-    mem_array_free(&vsrc);
-    mem_array_free(&rhs);
-    mem_array_free(&cmn);
-    mem_array_free(&rhnt);
-    mem_array_free(&rhnx);
+    mem_arena_rewind(mark);
     return;
   }
 
@@ -588,16 +583,7 @@ netwk( complex double *cmx, int *ip, complex double *einc )
       netcx.zped_port[vsorc.nsant + i] = netcx.zped;
     } /* for( i = 0; i < vsorc.nvqd; i++ ) */
 
-  /* Free network buffers */
-  mem_array_free(&ipnt);
-  mem_array_free(&nteqa);
-  mem_array_free(&ntsca);
-  mem_array_free(&vsrc);
-  mem_array_free(&rhs);
-  mem_array_free(&cmn);
-  mem_array_free(&rhnt);
-  mem_array_free(&rhnx);
-
+  mem_arena_rewind(mark);
   return;
 }
 
@@ -0,0 +1,126 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  The official website and doumentation for xnec2c is available here:
+ *    https://www.xnec2c.org/
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "npy.h"
+
+/* A .npy file is the magic "\x93NUMPY", a version, the little-endian
+ * length of the header that follows, and the header: a Python dict
+ * literal giving the dtype, memory order and shape of the array, padded
+ * with spaces and ended by a newline.  The raw array follows it.  Each
+ * array written here is one record per frequency step, whose fields are
+ * the frequency and the per-step buffers as sub-arrays, so one file holds
+ * a whole sweep and numpy maps each field as a (steps, ...) view. */
+
+#define NPY_MAGIC       "\x93NUMPY"
+#define NPY_MAGIC_LEN   6
+
+/* Magic, version and the 16-bit header length */
+#define NPY_PREAMBLE    (NPY_MAGIC_LEN + 2 + 2)
+
+int npy_descr_field(char *descr, const char *name, const char *type,
+	const int *dims, int ndims)
+{
+	size_t len = strlen(descr);
+	size_t left = NPY_DESCR_LEN - len;
+	char *o = descr + len;
+	int n, i;
+
+	n = snprintf(o, left, "%s('%s', '%c%s'", (len > 0) ? ", " : "",
+		name, NPY_ENDIAN, type);
+	if (n < 0 || (size_t)n >= left)
+		goto overflow;
+	o += n;
+	left -= n;
+
+	if (dims != NULL && ndims > 0)
+	{
+		n = snprintf(o, left, ", (");
+		if (n < 0 || (size_t)n >= left)
+			goto overflow;
+		o += n;
+		left -= n;
+
+		/* A one-element tuple keeps its comma */
+		for (i = 0; i < ndims; i++)
+		{
+			n = snprintf(o, left, "%d%s", dims[i],
+				(ndims == 1) ? "," : (i < ndims - 1) ? ", " : "");
+			if (n < 0 || (size_t)n >= left)
+				goto overflow;
+			o += n;
+			left -= n;
+		}
+
+		n = snprintf(o, left, ")");
+		if (n < 0 || (size_t)n >= left)
+			goto overflow;
+		o += n;
+		left -= n;
+	}
+
+	n = snprintf(o, left, ")");
+	if (n < 0 || (size_t)n >= left)
+		goto overflow;
+
+	return 0;
+
+overflow:
+	descr[len] = '\0';
+	return -1;
+}
+
+/*-----------------------------------------------------------------------*/
+
+long npy_write_header(FILE *fp, const char *descr, long rows)
+{
+	char header[NPY_DESCR_LEN + 128];
+	unsigned char preamble[NPY_PREAMBLE];
+	int len, total;
+
+	len = snprintf(header, sizeof(header),
+		"{'descr': [%s], 'fortran_order': False, 'shape': (%ld,), }",
+		descr, rows);
+	if (len < 0 || (size_t)len >= sizeof(header))
+		return -1;
+
+	/* Pad with spaces so the data starts aligned, the newline last */
+	total = NPY_PREAMBLE + len + 1;
+	total = (total + NPY_ALIGN - 1) / NPY_ALIGN * NPY_ALIGN;
+	if ((size_t)(total - NPY_PREAMBLE) > sizeof(header) || total - NPY_PREAMBLE > UINT16_MAX)
+		return -1;
+
+	memset(header + len, ' ', total - NPY_PREAMBLE - len - 1);
+	header[total - NPY_PREAMBLE - 1] = '\n';
+
+	memcpy(preamble, NPY_MAGIC, NPY_MAGIC_LEN);
+	preamble[NPY_MAGIC_LEN]     = 1;   /* version 1.0 */
+	preamble[NPY_MAGIC_LEN + 1] = 0;
+	preamble[NPY_MAGIC_LEN + 2] = (unsigned char)((total - NPY_PREAMBLE) & 0xff);
+	preamble[NPY_MAGIC_LEN + 3] = (unsigned char)((total - NPY_PREAMBLE) >> 8);
+
+	if (fwrite(preamble, 1, NPY_PREAMBLE, fp) != NPY_PREAMBLE
+		|| fwrite(header, 1, total - NPY_PREAMBLE, fp) != (size_t)(total - NPY_PREAMBLE))
+		return -1;
+
+	return total;
+}
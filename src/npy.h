@@ -0,0 +1,64 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  The official website and doumentation for xnec2c is available here:
+ *    https://www.xnec2c.org/
+ */
+
+#ifndef NPY_H
+#define NPY_H   1
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* Byte order character of numpy type strings for this host */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define NPY_ENDIAN      '>'
+#else
+#define NPY_ENDIAN      '<'
+#endif
+
+/* Length of a descriptor that holds a handful of fields */
+#define NPY_DESCR_LEN   512
+
+/* The data of every file starts on this boundary */
+#define NPY_ALIGN       64
+
+/* npy_descr_field - append one field to the fields of a record
+ * @descr: fields so far, NPY_DESCR_LEN bytes, "" to start
+ * @name:  field name
+ * @type:  type code without byte order: "f8", "c16", "i4" ...
+ * @dims:  sub-array dimensions, or NULL for a scalar field
+ * @ndims: count of @dims
+ *
+ * Builds the fields of the list form numpy takes for a record, such as
+ * "('mhz', '<f8'), ('gtot', '<f8', (37, 73))".  Returns 0, or -1 if they
+ * would not fit.
+ */
+int npy_descr_field(char *descr, const char *name, const char *type,
+	const int *dims, int ndims);
+
+/* npy_write_header - write the header of a one-dimensional .npy file
+ * @fp:    file, positioned at its start
+ * @descr: fields of the record, see npy_descr_field()
+ * @rows:  length of the array
+ *
+ * Writes a version 1.0 header padded so the records that follow start on
+ * an NPY_ALIGN boundary, which np.load(path, mmap_mode='r') maps as is.
+ * Returns the header length, or -1 on error.
+ */
+long npy_write_header(FILE *fp, const char *descr, long rows);
+
+#endif
@@ -2,7 +2,7 @@
  *  Optimizer configuration file I/O.
  *
  *  Persists optimizer panel state (algorithm, convergence parameters,
- *  simplex/PSO settings, fitness goals) to a GKeyFile-format .opt
+ *  simplex/PSO/Bayesian/CMA-ES settings, fitness goals) to a GKeyFile-format .opt
  *  file alongside the .nec model file.
  *
  *  Per-symbol optimizer state (opt checkbox, min/max bounds) is
@@ -30,6 +30,8 @@ static gboolean loading = FALSE;
 #define GRP_OPTIMIZER    "optimizer"
 #define GRP_SIMPLEX      "simplex"
 #define GRP_PSO          "pso"
+#define GRP_BAYES        "bayes"
+#define GRP_CMAES        "cmaes"
 #define GRP_GOAL_PREFIX  "goal "
 
 #define KEY_ALGORITHM    "algorithm"
@@ -48,6 +50,14 @@ static gboolean loading = FALSE;
 #define KEY_SOCIAL       "social"
 #define KEY_SEARCH_SIZE  "search_size"
 
+#define KEY_INITIAL      "initial_samples"
+#define KEY_BATCH        "batch_size"
+#define KEY_XI           "xi"
+
+#define KEY_POPULATION   "population"
+#define KEY_STEP         "step_size"
+#define KEY_MIN_STEP     "min_step"
+
 #define KEY_ENABLED      "enabled"
 #define KEY_METRIC       "metric"
 #define KEY_DIRECTION    "direction"
@@ -60,6 +70,8 @@ static gboolean loading = FALSE;
 
 #define ALGO_SIMPLEX     "simplex"
 #define ALGO_PSO         "pso"
+#define ALGO_BAYES       "bayes"
+#define ALGO_CMAES       "cmaes"
 
 /*------------------------------------------------------------------------*/
 
@@ -201,7 +213,24 @@ static void save_optimizer_group(GKeyFile *kf)
 	const gchar *algo_name;
 
 	algo_idx = gtk_combo_box_get_active(GTK_COMBO_BOX(algo_combo));
-	algo_name = (algo_idx == 0) ? ALGO_SIMPLEX : ALGO_PSO;
+	switch (algo_idx)
+	{
+		case 0:
+			algo_name = ALGO_SIMPLEX;
+			break;
+
+		case 2:
+			algo_name = ALGO_BAYES;
+			break;
+
+		case 3:
+			algo_name = ALGO_CMAES;
+			break;
+
+		default:
+			algo_name = ALGO_PSO;
+			break;
+	}
 
 	g_key_file_set_string(kf, GRP_OPTIMIZER, KEY_ALGORITHM, algo_name);
 	save_int_entry(kf, GRP_OPTIMIZER, KEY_MAX_ITER, max_iter_entry);
@@ -254,6 +283,33 @@ static void save_pso_group(GKeyFile *kf)
 
 /*------------------------------------------------------------------------*/
 
+/**
+ * save_bayes_group - write [bayes] section
+ */
+static void save_bayes_group(GKeyFile *kf)
+{
+	save_int_entry(kf, GRP_BAYES, KEY_INITIAL, bayes_initial_entry);
+	save_int_entry(kf, GRP_BAYES, KEY_BATCH, bayes_batch_entry);
+	g_key_file_set_double(kf, GRP_BAYES, KEY_XI,
+		get_entry_double(bayes_xi_entry));
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * save_cmaes_group - write [cmaes] section
+ */
+static void save_cmaes_group(GKeyFile *kf)
+{
+	save_int_entry(kf, GRP_CMAES, KEY_POPULATION, cmaes_population_entry);
+	g_key_file_set_double(kf, GRP_CMAES, KEY_STEP,
+		get_entry_double(cmaes_step_entry));
+	g_key_file_set_double(kf, GRP_CMAES, KEY_MIN_STEP,
+		get_entry_double(cmaes_min_step_entry));
+}
+
+/*------------------------------------------------------------------------*/
+
 /**
  * save_goal_groups - write [goal N] sections from goal_row_list
  */
@@ -334,6 +390,8 @@ gboolean opt_file_save(void)
 	save_optimizer_group(kf);
 	save_simplex_group(kf);
 	save_pso_group(kf);
+	save_bayes_group(kf);
+	save_cmaes_group(kf);
 	save_goal_groups(kf);
 
 	ok = g_key_file_save_to_file(kf, path, &err);
@@ -411,6 +469,14 @@ static void load_optimizer_group(GKeyFile *kf)
 		{
 			gtk_combo_box_set_active(GTK_COMBO_BOX(algo_combo), 1);
 		}
+		else if (g_strcmp0(algo, ALGO_BAYES) == 0)
+		{
+			gtk_combo_box_set_active(GTK_COMBO_BOX(algo_combo), 2);
+		}
+		else if (g_strcmp0(algo, ALGO_CMAES) == 0)
+		{
+			gtk_combo_box_set_active(GTK_COMBO_BOX(algo_combo), 3);
+		}
 		else
 		{
 			gtk_combo_box_set_active(GTK_COMBO_BOX(algo_combo), 0);
@@ -491,6 +557,40 @@ static void load_pso_group(GKeyFile *kf)
 
 /*------------------------------------------------------------------------*/
 
+/**
+ * load_bayes_group - read [bayes] section into UI widgets
+ */
+static void load_bayes_group(GKeyFile *kf)
+{
+	if (!g_key_file_has_group(kf, GRP_BAYES))
+	{
+		return;
+	}
+
+	load_int_entry(kf, GRP_BAYES, KEY_INITIAL, bayes_initial_entry);
+	load_int_entry(kf, GRP_BAYES, KEY_BATCH, bayes_batch_entry);
+	load_double_entry(kf, GRP_BAYES, KEY_XI, bayes_xi_entry);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * load_cmaes_group - read [cmaes] section into UI widgets
+ */
+static void load_cmaes_group(GKeyFile *kf)
+{
+	if (!g_key_file_has_group(kf, GRP_CMAES))
+	{
+		return;
+	}
+
+	load_int_entry(kf, GRP_CMAES, KEY_POPULATION, cmaes_population_entry);
+	load_double_entry(kf, GRP_CMAES, KEY_STEP, cmaes_step_entry);
+	load_double_entry(kf, GRP_CMAES, KEY_MIN_STEP, cmaes_min_step_entry);
+}
+
+/*------------------------------------------------------------------------*/
+
 /**
  * load_goal_groups - read [goal N] sections and rebuild goal rows
  */
@@ -661,6 +761,8 @@ gboolean opt_file_load(void)
 	load_optimizer_group(kf);
 	load_simplex_group(kf);
 	load_pso_group(kf);
+	load_bayes_group(kf);
+	load_cmaes_group(kf);
 	load_goal_groups(kf);
 
 	loading = FALSE;
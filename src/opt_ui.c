@@ -39,6 +39,20 @@ GtkWidget *pso_me_weight_entry    = NULL;
 GtkWidget *pso_them_weight_entry  = NULL;
 GtkWidget *pso_search_size_entry  = NULL;
 
+/* Bayesian-specific */
+GtkWidget *bayes_label            = NULL;
+GtkWidget *bayes_box              = NULL;
+GtkWidget *bayes_initial_entry    = NULL;
+GtkWidget *bayes_batch_entry      = NULL;
+GtkWidget *bayes_xi_entry         = NULL;
+
+/* CMA-ES-specific */
+GtkWidget *cmaes_label            = NULL;
+GtkWidget *cmaes_box              = NULL;
+GtkWidget *cmaes_population_entry = NULL;
+GtkWidget *cmaes_step_entry       = NULL;
+GtkWidget *cmaes_min_step_entry   = NULL;
+
 /* Common convergence */
 GtkWidget *stagnant_count_entry   = NULL;
 GtkWidget *stagnant_tol_entry     = NULL;
@@ -47,6 +61,7 @@ GtkWidget *max_iter_entry         = NULL;
 /* Buttons and status */
 GtkWidget *start_button           = NULL;
 GtkWidget *cancel_button          = NULL;
+GtkWidget *sensitivity_button     = NULL;
 GtkWidget *status_label           = NULL;
 
 /* Formula display */
@@ -83,11 +98,22 @@ static const struct
 	{ &pso_me_weight_entry,    "opt_pso_me_weight_entry"    },
 	{ &pso_them_weight_entry,  "opt_pso_them_weight_entry"  },
 	{ &pso_search_size_entry,  "opt_pso_search_size_entry"  },
+	{ &bayes_label,            "opt_bayes_label"            },
+	{ &bayes_box,              "opt_bayes_box"              },
+	{ &bayes_initial_entry,    "opt_bayes_initial_entry"    },
+	{ &bayes_batch_entry,      "opt_bayes_batch_entry"      },
+	{ &bayes_xi_entry,         "opt_bayes_xi_entry"         },
+	{ &cmaes_label,            "opt_cmaes_label"            },
+	{ &cmaes_box,              "opt_cmaes_box"              },
+	{ &cmaes_population_entry, "opt_cmaes_population_entry" },
+	{ &cmaes_step_entry,       "opt_cmaes_step_entry"       },
+	{ &cmaes_min_step_entry,   "opt_cmaes_min_step_entry"   },
 	{ &stagnant_count_entry,   "opt_stagnant_count_entry"   },
 	{ &stagnant_tol_entry,     "opt_stagnant_tol_entry"     },
 	{ &max_iter_entry,         "opt_max_iter_entry"         },
 	{ &start_button,           "opt_start_button"           },
 	{ &cancel_button,          "opt_cancel_button"          },
+	{ &sensitivity_button,     "opt_sensitivity_button"     },
 	{ &status_label,           "opt_status_label"           },
 	{ &formula_help_button,    "opt_formula_help_button"    },
 };
@@ -200,6 +226,8 @@ void opt_ui_init(GtkBuilder *builder)
 		G_CALLBACK(on_opt_start_clicked), NULL);
 	g_signal_connect(cancel_button, "clicked",
 		G_CALLBACK(on_opt_cancel_clicked), NULL);
+	g_signal_connect(sensitivity_button, "clicked",
+		G_CALLBACK(on_opt_sensitivity_clicked), NULL);
 	g_signal_connect(formula_help_button, "clicked",
 		G_CALLBACK(on_opt_formula_help_clicked), NULL);
 	g_signal_connect(pso_particles_entry, "focus-out-event",
@@ -225,6 +253,12 @@ void opt_ui_init(GtkBuilder *builder)
 			{ &pso_me_weight_entry,    opt_file_connect_entry },
 			{ &pso_them_weight_entry,  opt_file_connect_entry },
 			{ &pso_search_size_entry,  opt_file_connect_entry },
+			{ &bayes_initial_entry,    opt_file_connect_entry },
+			{ &bayes_batch_entry,      opt_file_connect_entry },
+			{ &bayes_xi_entry,         opt_file_connect_entry },
+			{ &cmaes_population_entry, opt_file_connect_entry },
+			{ &cmaes_step_entry,       opt_file_connect_entry },
+			{ &cmaes_min_step_entry,   opt_file_connect_entry },
 		};
 		size_t s;
 
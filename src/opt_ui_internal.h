@@ -63,11 +63,22 @@ extern GtkWidget *pso_inertia_entry;
 extern GtkWidget *pso_me_weight_entry;
 extern GtkWidget *pso_them_weight_entry;
 extern GtkWidget *pso_search_size_entry;
+extern GtkWidget *bayes_label;
+extern GtkWidget *bayes_box;
+extern GtkWidget *bayes_initial_entry;
+extern GtkWidget *bayes_batch_entry;
+extern GtkWidget *bayes_xi_entry;
+extern GtkWidget *cmaes_label;
+extern GtkWidget *cmaes_box;
+extern GtkWidget *cmaes_population_entry;
+extern GtkWidget *cmaes_step_entry;
+extern GtkWidget *cmaes_min_step_entry;
 extern GtkWidget *stagnant_count_entry;
 extern GtkWidget *stagnant_tol_entry;
 extern GtkWidget *max_iter_entry;
 extern GtkWidget *start_button;
 extern GtkWidget *cancel_button;
+extern GtkWidget *sensitivity_button;
 extern GtkWidget *status_label;
 extern GtkWidget *formula_help_button;
 extern GtkWidget *totals_formula_label;
@@ -106,6 +117,7 @@ void on_opt_formula_help_clicked(GtkButton *button, gpointer user_data);
 /* Session signal callbacks — opt_ui_session.c */
 void on_opt_start_clicked(GtkButton *button, gpointer user_data);
 void on_opt_cancel_clicked(GtkButton *button, gpointer user_data);
+void on_opt_sensitivity_clicked(GtkButton *button, gpointer user_data);
 void on_algo_changed(GtkComboBox *combo, gpointer user_data);
 gboolean on_pso_particles_focus_out(GtkWidget *widget,
 	GdkEventFocus *event, gpointer user_data);
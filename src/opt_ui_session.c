@@ -10,9 +10,12 @@
  */
 
 #include "opt_ui_internal.h"
+#include "optimizers/opt_sensitivity.h"
 #include "optimizers/opt_session.h"
 #include "optimizers/simplex.h"
 #include "optimizers/particleswarm.h"
+#include "optimizers/bayesopt.h"
+#include "optimizers/cmaes.h"
 #include "sy_overrides.h"
 #include "shared.h"
 
@@ -59,6 +62,7 @@ static void opt_finished(gpointer _u)
 	/* Optimization finished: update UI */
 	gtk_widget_set_sensitive(start_button, TRUE);
 	gtk_widget_set_sensitive(cancel_button, FALSE);
+	gtk_widget_set_sensitive(sensitivity_button, TRUE);
 	sy_overrides_set_apply_enabled(TRUE);
 	gtk_widget_set_sensitive(GTK_WIDGET(mainwin_frequency), TRUE);
 	if( isFlagSet(DRAW_ENABLED) && rdpattern_frequency != NULL )
@@ -121,7 +125,7 @@ void on_opt_start_clicked(GtkButton *button, gpointer user_data)
 	(void)button;
 	(void)user_data;
 
-	if (opt_is_running())
+	if (opt_is_running() || opt_sensitivity_running())
 	{
 		return;
 	}
@@ -203,9 +207,25 @@ void on_opt_start_clicked(GtkButton *button, gpointer user_data)
 	/* Persist all current overrides to .sy before starting */
 	sy_overrides_save_state();
 
-	/* Read algorithm */
-	algo = (gtk_combo_box_get_active(GTK_COMBO_BOX(algo_combo)) == 0)
-		? OPT_SIMPLEX : OPT_PSO;
+	/* Read algorithm; combo index follows the optimizer_algo enum */
+	switch (gtk_combo_box_get_active(GTK_COMBO_BOX(algo_combo)))
+	{
+		case 0:
+			algo = OPT_SIMPLEX;
+			break;
+
+		case 2:
+			algo = OPT_BAYES;
+			break;
+
+		case 3:
+			algo = OPT_CMAES;
+			break;
+
+		default:
+			algo = OPT_PSO;
+			break;
+	}
 
 	/* Populate upstream config structs directly */
 	memset(&algo_params, 0, sizeof(algo_params));
@@ -223,6 +243,64 @@ void on_opt_start_clicked(GtkButton *button, gpointer user_data)
 			parse_ssize_list(ssize_entry, ssize_arr, 32);
 		algo_params.simplex.ssize = ssize_arr;
 	}
+	else if (algo == OPT_BAYES)
+	{
+		double initial;
+		double batch;
+
+		bayes_config_init(&algo_params.bayes_cfg);
+
+		initial = get_entry_double(bayes_initial_entry);
+		batch = get_entry_double(bayes_batch_entry);
+
+		algo_params.bayes_cfg.initial_samples =
+			isnan(initial) ? 0 : (int)initial;
+		algo_params.bayes_cfg.batch_size =
+			isnan(batch) ? 0 : (int)batch;
+
+		/* Auto batch: one candidate per worker process */
+		if (algo_params.bayes_cfg.batch_size <= 0)
+		{
+			algo_params.bayes_cfg.batch_size =
+				FORKED ? calc_data.num_jobs : 1;
+		}
+
+		if (!isnan(get_entry_double(bayes_xi_entry)))
+		{
+			algo_params.bayes_cfg.xi = get_entry_double(bayes_xi_entry);
+		}
+	}
+	else if (algo == OPT_CMAES)
+	{
+		double population;
+		double step;
+		double min_step;
+
+		cmaes_config_init(&algo_params.cmaes_cfg);
+
+		population = get_entry_double(cmaes_population_entry);
+		step = get_entry_double(cmaes_step_entry);
+		min_step = get_entry_double(cmaes_min_step_entry);
+
+		algo_params.cmaes_cfg.lambda =
+			isnan(population) ? 0 : (int)population;
+
+		/* Auto population still keeps every worker busy each generation */
+		if (algo_params.cmaes_cfg.lambda <= 0 && FORKED)
+		{
+			algo_params.cmaes_cfg.min_lambda = calc_data.num_jobs;
+		}
+
+		if (!isnan(step) && step > 0.0)
+		{
+			algo_params.cmaes_cfg.sigma = step;
+		}
+
+		if (!isnan(min_step) && min_step > 0.0)
+		{
+			algo_params.cmaes_cfg.min_sigma = min_step;
+		}
+	}
 	else
 	{
 		double num_particles;
@@ -280,6 +358,7 @@ void on_opt_start_clicked(GtkButton *button, gpointer user_data)
 	{
 		gtk_widget_set_sensitive(start_button, FALSE);
 		gtk_widget_set_sensitive(cancel_button, TRUE);
+		gtk_widget_set_sensitive(sensitivity_button, FALSE);
 		sy_overrides_set_apply_enabled(FALSE);
 		gtk_widget_set_sensitive(GTK_WIDGET(mainwin_frequency), FALSE);
 		if( isFlagSet(DRAW_ENABLED) && rdpattern_frequency != NULL )
@@ -414,7 +493,7 @@ gboolean on_pso_particles_focus_out(GtkWidget *widget,
 /*------------------------------------------------------------------------*/
 
 /**
- * on_algo_changed - toggle simplex/PSO parameter visibility
+ * on_algo_changed - show the parameters of the selected algorithm
  */
 void on_algo_changed(GtkComboBox *combo, gpointer user_data)
 {
@@ -424,18 +503,34 @@ void on_algo_changed(GtkComboBox *combo, gpointer user_data)
 
 	active = gtk_combo_box_get_active(combo);
 
-	/* Combo box index maps to optimizer_algo enum: 0=OPT_SIMPLEX, 1=OPT_PSO */
+	/* Combo box index maps to optimizer_algo enum:
+	 * 0=OPT_SIMPLEX, 1=OPT_PSO, 2=OPT_BAYES, 3=OPT_CMAES */
+	gtk_widget_hide(simplex_label);
+	gtk_widget_hide(simplex_box);
+	gtk_widget_hide(pso_label);
+	gtk_widget_hide(pso_box);
+	gtk_widget_hide(bayes_label);
+	gtk_widget_hide(bayes_box);
+	gtk_widget_hide(cmaes_label);
+	gtk_widget_hide(cmaes_box);
+
 	if (active == 0)
 	{
 		gtk_widget_show(simplex_label);
 		gtk_widget_show_all(simplex_box);
-		gtk_widget_hide(pso_label);
-		gtk_widget_hide(pso_box);
+	}
+	else if (active == 2)
+	{
+		gtk_widget_show(bayes_label);
+		gtk_widget_show(bayes_box);
+	}
+	else if (active == 3)
+	{
+		gtk_widget_show(cmaes_label);
+		gtk_widget_show(cmaes_box);
 	}
 	else
 	{
-		gtk_widget_hide(simplex_label);
-		gtk_widget_hide(simplex_box);
 		gtk_widget_show(pso_label);
 		gtk_widget_show(pso_box);
 	}
@@ -453,3 +548,224 @@ void on_opt_cancel_clicked(GtkButton *button, gpointer user_data)
 
 	opt_cancel();
 }
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * sensitivity_nearest_step - step of a Jacobian closest to a frequency
+ * @s: Jacobian with at least one step
+ * @mhz: frequency
+ */
+static int sensitivity_nearest_step(const opt_sensitivity_t *s, double mhz)
+{
+	int best = 0;
+
+	for (int i = 1; i < s->num_steps; i++)
+	{
+		if (fabs(s->base[i].mhz - mhz) < fabs(s->base[best].mhz - mhz))
+		{
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * sensitivity_done - opt_sensitivity_start() completion handler
+ * @s: the Jacobian, or NULL when the run failed
+ * @data: measurement columns of the run (owned)
+ *
+ * Shows, for each goal measurement at the selected frequency, the var
+ * that moves it most across its range; the CSV holds the rest.
+ */
+static void sensitivity_done(opt_sensitivity_t *s, gpointer data)
+{
+	GArray *cols = data;
+	GString *msg;
+	int step;
+
+	if (xnec2c_quit_if_pending() || start_button == NULL)
+	{
+		opt_sensitivity_free(s);
+		g_array_free(cols, TRUE);
+		return;
+	}
+
+	gtk_widget_set_sensitive(start_button, TRUE);
+	gtk_widget_set_sensitive(sensitivity_button, TRUE);
+
+	if (s == NULL || s->num_steps == 0)
+	{
+		gtk_label_set_text(GTK_LABEL(status_label),
+			"Sensitivity failed; check the terminal for details.");
+		opt_sensitivity_free(s);
+		g_array_free(cols, TRUE);
+		return;
+	}
+
+	step = sensitivity_nearest_step(s, calc_data.fmhz_save);
+	msg = g_string_new(NULL);
+	g_string_printf(msg, "Sensitivity at %.4g MHz:", s->base[step].mhz);
+
+	for (guint c = 0; c < cols->len; c++)
+	{
+		int f = g_array_index(cols, int, c);
+		const double *row = opt_sensitivity_at(s, step, f);
+		double most = 0.0;
+		int var = -1;
+
+		/* h is a fixed fraction of the range, so J * h compares vars
+		 * of different units by their effect across the range */
+		for (int d = 0; d < s->num_vars; d++)
+		{
+			double effect = fabs(row[d] * s->h[d]);
+
+			if (isfinite(effect) && effect > most)
+			{
+				most = effect;
+				var = d;
+			}
+		}
+
+		if (var >= 0)
+		{
+			g_string_append_printf(msg, "  %s: %s (%+.3g)",
+				meas_names[f], s->names[var],
+				row[var] * s->h[var] / OPT_SENS_REL_STEP);
+		}
+	}
+
+	gtk_label_set_text(GTK_LABEL(status_label), msg->str);
+
+	g_string_free(msg, TRUE);
+	opt_sensitivity_free(s);
+	g_array_free(cols, TRUE);
+}
+
+/**
+ * sensitivity_save - file chooser callback: start the run into a CSV
+ * @filename: CSV output
+ *
+ * The measurements are those of the enabled goals, or every one when no
+ * goal is enabled.
+ */
+static void sensitivity_save(char *filename)
+{
+	fitness_config_t fit_cfg;
+	simple_var_t *vars;
+	GArray *cols;
+	const char **names = NULL;
+	double *x = NULL;
+	double *min = NULL;
+	double *max = NULL;
+	int num_vars;
+	int ret;
+
+	num_vars = sy_overrides_get_opt_vars(&vars);
+	if (num_vars == 0)
+	{
+		return;
+	}
+
+	mem_array_alloc(&names, num_vars);
+	mem_array_alloc(&x, num_vars);
+	mem_array_alloc(&min, num_vars);
+	mem_array_alloc(&max, num_vars);
+
+	for (int d = 0; d < num_vars; d++)
+	{
+		names[d] = vars[d].name;
+		x[d] = gsl_vector_get(vars[d].values, 0);
+		min[d] = gsl_vector_get(vars[d].min, 0);
+		max[d] = gsl_vector_get(vars[d].max, 0);
+	}
+
+	/* One column per distinct goal measurement */
+	opt_ui_get_fitness_config(&fit_cfg);
+	cols = g_array_new(FALSE, FALSE, sizeof(int));
+	for (int g = 0; g < fit_cfg.num_obj; g++)
+	{
+		int f = fit_cfg.obj[g].meas_index;
+		gboolean seen = FALSE;
+
+		for (guint c = 0; c < cols->len; c++)
+		{
+			seen |= g_array_index(cols, int, c) == f;
+		}
+
+		if (fit_cfg.obj[g].enabled && !seen)
+		{
+			g_array_append_val(cols, f);
+		}
+	}
+	fitness_config_free(&fit_cfg);
+
+	if (cols->len == 0)
+	{
+		for (int f = MEAS_ZREAL; f < MEAS_COUNT; f++)
+		{
+			g_array_append_val(cols, f);
+		}
+	}
+
+	ret = opt_sensitivity_start(names, x, min, max, num_vars,
+		(int *)cols->data, cols->len, filename, sensitivity_done, cols);
+
+	sy_overrides_free_opt_vars(vars, num_vars);
+	mem_array_free(&names);
+	mem_array_free(&x);
+	mem_array_free(&min);
+	mem_array_free(&max);
+
+	if (ret != 0)
+	{
+		g_array_free(cols, TRUE);
+		Notice(GTK_BUTTONS_OK, "Sensitivity",
+			"Sensitivity failed to start.\n"
+			"Check the terminal for details.");
+		return;
+	}
+
+	gtk_widget_set_sensitive(start_button, FALSE);
+	gtk_widget_set_sensitive(sensitivity_button, FALSE);
+	gtk_label_set_text(GTK_LABEL(status_label), "Sensitivity: solving...");
+}
+
+/**
+ * on_opt_sensitivity_clicked - Sensitivity button handler
+ *
+ * Asks where to write the Jacobian CSV; the run starts from the file
+ * chooser's callback.
+ */
+void on_opt_sensitivity_clicked(GtkButton *button, gpointer user_data)
+{
+	simple_var_t *vars;
+	int num_vars;
+	char newfn[PATH_MAX];
+
+	(void)button;
+	(void)user_data;
+
+	if (opt_is_running() || opt_sensitivity_running())
+	{
+		return;
+	}
+
+	num_vars = sy_overrides_get_opt_vars(&vars);
+	if (num_vars == 0)
+	{
+		Notice(GTK_BUTTONS_OK, "Sensitivity",
+			"No variables are flagged for optimization.\n"
+			"Check the Opt column for the variables to perturb.");
+		return;
+	}
+	sy_overrides_free_opt_vars(vars, num_vars);
+
+	mem_new(&filechooser_callback);
+	filechooser_callback->callback = sensitivity_save;
+	filechooser_callback->extension = ".csv";
+	file_chooser = Open_Filechooser(GTK_FILE_CHOOSER_ACTION_SAVE,
+		"*.csv", NULL, get_nec_filename_stem(newfn, "-sensitivity.csv", PATH_MAX),
+		rc_config.working_dir);
+}
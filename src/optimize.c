@@ -18,6 +18,9 @@
  */
 
 #include "shared.h"
+#include "gnuplot.h"
+
+#include <unistd.h>
 
 /*------------------------------------------------------------------------*/
 
@@ -29,29 +32,53 @@ typedef struct
 	char *suffix;
 	char *debug_name;
 	void (*save_fn)(char *);
+	const sweep_writer_t *stream;   // Step writer for streaming, or NULL
 } optimizer_save_entry_t;
 
 static optimizer_save_entry_t save_entries[] =
 {
 	{ &rc_config.opt_write_csv, &rc_config.filename_csv,
-	  ".csv", NULL, Save_FreqPlots_CSV },
+	  ".csv", NULL, Save_FreqPlots_CSV, &sweep_writer_csv },
 	{ &rc_config.opt_write_s1p, &rc_config.filename_s1p,
-	  ".s1p", NULL, Save_FreqPlots_S1P },
+	  ".s1p", NULL, Save_FreqPlots_S1P, &sweep_writer_s1p },
 	{ &rc_config.opt_write_s2p_max_gain, &rc_config.filename_s2p_max_gain,
-	  "-maxgain.s2p", NULL, Save_FreqPlots_S2P_Max_Gain },
+	  "-maxgain.s2p", NULL, Save_FreqPlots_S2P_Max_Gain, &sweep_writer_s2p_max_gain },
 	{ &rc_config.opt_write_s2p_viewer_gain, &rc_config.filename_s2p_viewer_gain,
-	  "-viewergain.s2p", NULL, Save_FreqPlots_S2P_Viewer_Gain },
+	  "-viewergain.s2p", NULL, Save_FreqPlots_S2P_Viewer_Gain, &sweep_writer_s2p_viewer_gain },
 	{ &rc_config.opt_write_rdpat, &rc_config.filename_rdpat,
-	  "-radpattern.csv", "rdpat", Save_RadPattern_CSV },
+	  "-radpattern.csv", "rdpat", Save_RadPattern_CSV, &sweep_writer_rdpat },
 	{ &rc_config.opt_write_currents, &rc_config.filename_currents,
-	  "-currents.csv", "currents", Save_Currents_CSV },
+	  "-currents.csv", "currents", Save_Currents_CSV, NULL },
 	{ &rc_config.opt_write_gnuplot_structure, &rc_config.filename_gnuplot_structure,
-	  "-structure.gplot", "gnuplot structure", Save_Struct_Gnuplot_Data },
+	  "-structure.gplot", "gnuplot structure", Save_Struct_Gnuplot_Data, NULL },
 	{ &rc_config.opt_write_patch_currents, &rc_config.filename_patch_currents,
-	  "-patch-currents.csv", "patch currents", Save_Patch_Currents_CSV },
-	{ NULL, NULL, NULL, NULL, NULL }
+	  "-patch-currents.csv", "patch currents", Save_Patch_Currents_CSV, NULL },
+	{ NULL, &rc_config.filename_rdpat_npy,
+	  NULL, "rdpat npy", Save_RadPattern_NPY, NULL },
+	{ NULL, &rc_config.filename_currents_npy,
+	  NULL, "currents npy", Save_Currents_NPY, NULL },
+	{ NULL, NULL, NULL, NULL, NULL, NULL }
 };
 
+/* A sweep file written as the sweep runs: rows are appended to <path>.tmp
+ * in step order as the steps complete, and the file is synced and renamed
+ * over path once the sweep is written out.  Guarded by freq_data_lock. */
+typedef struct
+{
+	const sweep_writer_t *writer;
+	FILE *fp;
+	char path[FILENAME_LEN];
+	char tmp[FILENAME_LEN + 8];
+} optimizer_stream_t;
+
+/* Two targets per entry: the menu checkbox path and the CLI path */
+static optimizer_stream_t streams[2 * G_N_ELEMENTS(save_entries)];
+static int stream_count = 0;
+
+/* Next step to write, and the step count of the sweep being streamed */
+static int stream_next = 0;
+static int stream_steps = 0;
+
 int opt_have_files_to_save(void)
 {
 	for (optimizer_save_entry_t *e = save_entries; e->save_fn != NULL; e++)
@@ -62,6 +89,191 @@ int opt_have_files_to_save(void)
 	return 0;
 }
 
+/*------------------------------------------------------------------------*/
+
+/* Opens the stream of one target and writes its header.  A target whose
+ * path is already streamed, the checkbox and CLI paths naming one file,
+ * keeps the one stream. */
+static void optimizer_stream_open(const sweep_writer_t *writer, const char *path)
+{
+	optimizer_stream_t *st = &streams[stream_count];
+
+	for (int i = 0; i < stream_count; i++)
+	{
+		if (strcmp(streams[i].path, path) == 0)
+			return;
+	}
+
+	st->writer = writer;
+	g_strlcpy(st->path, path, sizeof(st->path));
+	snprintf(st->tmp, sizeof(st->tmp), "%s.tmp", path);
+
+	st->fp = fopen(st->tmp, "w");
+	if (st->fp == NULL)
+	{
+		pr_warn("optimizer_stream_open: %s: %s\n", st->tmp, strerror(errno));
+		return;
+	}
+
+	writer->header(st->fp, writer->arg);
+	fflush(st->fp);
+	stream_count++;
+}
+
+/* Syncs a complete stream and renames it over its target.  Returns FALSE,
+ * having removed the temporary file, on error. */
+static gboolean optimizer_stream_commit(optimizer_stream_t *st)
+{
+	gboolean ok;
+
+	ok = (fflush(st->fp) == 0) && (fsync(fileno(st->fp)) == 0);
+	if (fclose(st->fp) != 0)
+		ok = FALSE;
+	st->fp = NULL;
+
+	if (!ok || rename(st->tmp, st->path) != 0)
+	{
+		pr_err("optimizer_stream_commit: %s: %s\n", st->path, strerror(errno));
+		remove(st->tmp);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* optimizer_stream_abort()
+ *
+ * Closes the streams of the last sweep and removes their temporary files
+ */
+void optimizer_stream_abort(void)
+{
+	g_rec_mutex_lock(&freq_data_lock);
+
+	for (int i = 0; i < stream_count; i++)
+	{
+		if (streams[i].fp == NULL)
+			continue;
+
+		fclose(streams[i].fp);
+		streams[i].fp = NULL;
+		remove(streams[i].tmp);
+	}
+	stream_count = 0;
+	stream_next = 0;
+	stream_steps = 0;
+
+	g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/* optimizer_stream_begin()
+ *
+ * Opens a stream for every sweep file the optimizer writes at the end of
+ * this sweep, so its rows are written as the steps complete instead of all
+ * at once after the last.  Headless evaluations write only the best
+ * candidate's files, after the fact, and reduced sweeps leave fields
+ * unsolved, so neither streams.
+ */
+void optimizer_stream_begin(void)
+{
+	char filename[FILENAME_LEN];
+	locale_t c_locale, prev_locale;
+
+	optimizer_stream_abort();
+
+	if (isFlagSet(HEADLESS_EVAL) ||
+		!(rc_config.batch_mode || isFlagSet(SUPPRESS_INTERMEDIATE_REDRAWS)) ||
+		!opt_have_files_to_save())
+		return;
+
+	g_rec_mutex_lock(&freq_data_lock);
+
+	if (calc_data.solve_skip != 0 || calc_data.steps_total < 1)
+	{
+		g_rec_mutex_unlock(&freq_data_lock);
+		return;
+	}
+
+	c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+	prev_locale = uselocale(c_locale);
+
+	for (optimizer_save_entry_t *e = save_entries; e->save_fn != NULL; e++)
+	{
+		// S-parameters need a feedpoint; Save_* reports why not at the end
+		if (e->stream == NULL || (e->stream->needs_impedance && !meas_has_impedance(0)))
+			continue;
+
+		if (e->opt_flag && *e->opt_flag)
+			optimizer_stream_open(e->stream,
+				str_append(filename, rc_config.input_file, e->suffix, sizeof(filename)));
+
+		if (e->filename && *e->filename)
+			optimizer_stream_open(e->stream, *e->filename);
+	}
+
+	uselocale(prev_locale);
+	freelocale(c_locale);
+
+	stream_steps = calc_data.steps_total;
+
+	g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/* optimizer_stream_steps()
+ *
+ * Appends the rows of the steps completed since the last call, in step
+ * order: a step solved ahead of an earlier one waits for it.  Flushed after
+ * each step so a reader tailing the file sees whole rows.
+ */
+void optimizer_stream_steps(void)
+{
+	locale_t c_locale, prev_locale;
+
+	g_rec_mutex_lock(&freq_data_lock);
+
+	if (stream_count == 0 || stream_steps != calc_data.steps_total ||
+		stream_next >= stream_steps || !save.fstep[stream_next])
+	{
+		g_rec_mutex_unlock(&freq_data_lock);
+		return;
+	}
+
+	c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+	prev_locale = uselocale(c_locale);
+
+	for (; stream_next < stream_steps && save.fstep[stream_next]; stream_next++)
+	{
+		for (int i = 0; i < stream_count; i++)
+		{
+			if (streams[i].fp == NULL)
+				continue;
+
+			streams[i].writer->step(streams[i].fp, stream_next, streams[i].writer->arg);
+			fflush(streams[i].fp);
+		}
+	}
+
+	uselocale(prev_locale);
+	freelocale(c_locale);
+
+	g_rec_mutex_unlock(&freq_data_lock);
+}
+
+/* Commits the stream of path if the sweep streamed it whole.  Returns
+ * FALSE when the file is still to be written. */
+static gboolean optimizer_stream_finish(const char *path)
+{
+	if (stream_steps != calc_data.steps_total || stream_next < stream_steps)
+		return FALSE;
+
+	for (int i = 0; i < stream_count; i++)
+	{
+		if (streams[i].fp != NULL && strcmp(streams[i].path, path) == 0)
+			return optimizer_stream_commit(&streams[i]);
+	}
+
+	return FALSE;
+}
+
 /* Writes out frequency-dependent
  * data for the external Optimizer */
 void
@@ -74,14 +286,20 @@ _Write_Optimizer_Data(void)
 	{
 		// Menu checkbox path: auto-generate filename from input_file
 		if (e->opt_flag && *e->opt_flag)
-			e->save_fn(str_append(filename, rc_config.input_file, e->suffix, n));
+		{
+			str_append(filename, rc_config.input_file, e->suffix, n);
+			if (!optimizer_stream_finish(filename))
+				e->save_fn(filename);
+		}
 
-		// CLI path: use user-specified filename
-		if (e->filename && *e->filename)
+		// CLI path: use user-specified filename, unless it was just written
+		if (e->filename && *e->filename &&
+			!(e->opt_flag && *e->opt_flag && strcmp(filename, *e->filename) == 0))
 		{
 			if (e->debug_name)
 				pr_debug("saving %s: %s\n", e->debug_name, *e->filename);
-			e->save_fn(*e->filename);
+			if (!optimizer_stream_finish(*e->filename))
+				e->save_fn(*e->filename);
 		}
 	}
 } // Write_Optimizer_Data()
@@ -0,0 +1,417 @@
+/*
+ *  Bayesian optimization - public API and main loop.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "bayesopt_internal.h"
+#include "optimizer_bounds.h"
+#include "../mem/mem.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static void _evaluate(bayes_t *b, int first, int n);
+static void _init(bayes_t *b);
+static void _log(const bayes_t *b);
+
+/**
+ * bayes_config_init - fill config with safe defaults
+ * @config: pointer to config struct to initialize
+ *
+ * Sets all fields to sensible defaults.  Caller must still set
+ * fit_func, the bounds, and either dimensions or initial_guess before
+ * calling bayes_new().
+ */
+void bayes_config_init(bayes_config_t *config)
+{
+	memset(config, 0, sizeof(*config));
+	config->pos_min = NULL;
+	config->pos_max = NULL;
+	config->xi = 0.01;
+	config->noise = 1e-6;
+	config->exit_fit = NAN;
+}
+
+/**
+ * bayes_new - create a new Bayesian optimizer
+ * @config: configuration (copied internally)
+ *
+ * Validates configuration, applies computed defaults, and allocates
+ * the sample table for the whole evaluation budget.  Returns NULL with
+ * a message to stderr on error.
+ */
+bayes_t *bayes_new(const bayes_config_t *config)
+{
+	if (!config->fit_func)
+	{
+		fprintf(stderr, "bayes_new: fit_func is required\n");
+		return NULL;
+	}
+
+	if (config->dimensions <= 0 && !config->initial_guess)
+	{
+		fprintf(stderr, "bayes_new: dimensions or initial_guess required\n");
+		return NULL;
+	}
+
+	int d = config->dimensions;
+	if (d <= 0 && config->initial_guess)
+	{
+		d = (int)config->initial_guess->size;
+	}
+
+	/* The surrogate lives in the unit cube, so every bound must be finite */
+	if (!config->pos_min || !config->pos_max)
+	{
+		fprintf(stderr, "bayes_new: pos_min and pos_max are required\n");
+		return NULL;
+	}
+
+	if (optimizer_validate_bounds(config->pos_min, config->pos_max,
+		d, 0, "bayes_new") != 0)
+	{
+		return NULL;
+	}
+
+	for (int i = 0; i < d; i++)
+	{
+		if (!isfinite(gsl_vector_get(config->pos_min, i))
+			|| !isfinite(gsl_vector_get(config->pos_max, i)))
+		{
+			fprintf(stderr, "bayes_new: bound %d is not finite\n", i);
+			return NULL;
+		}
+	}
+
+	bayes_t *b = NULL;
+	mem_new(&b);
+	if (!b)
+	{
+		return NULL;
+	}
+
+	b->config = *config;
+
+	/* Prevent bayes_free from freeing caller's pointers before deep-copy */
+	b->config.initial_guess = NULL;
+	b->config.pos_min = NULL;
+	b->config.pos_max = NULL;
+
+	b->config.dimensions = d;
+
+	if (config->initial_guess)
+	{
+		b->config.initial_guess = gsl_vector_alloc(config->initial_guess->size);
+		gsl_vector_memcpy(b->config.initial_guess, config->initial_guess);
+	}
+
+	optimizer_deep_copy_bounds(&b->config.pos_min, &b->config.pos_max,
+		config->pos_min, config->pos_max);
+
+	/* Computed defaults */
+	if (b->config.iterations <= 0)
+	{
+		b->config.iterations = 100;
+	}
+	if (b->config.initial_samples <= 0)
+	{
+		b->config.initial_samples = 2 * d + 1;
+	}
+	if (b->config.initial_samples > b->config.iterations)
+	{
+		b->config.initial_samples = b->config.iterations;
+	}
+	if (b->config.batch_size <= 0)
+	{
+		b->config.batch_size = 1;
+	}
+	if (b->config.candidates <= 0)
+	{
+		b->config.candidates = 256 * d;
+	}
+	if (!(b->config.noise > 0.0))
+	{
+		b->config.noise = 1e-6;
+	}
+
+	/* A final batch may run past the budget by the believer rows */
+	b->capacity = b->config.iterations + b->config.batch_size;
+
+	b->u = gsl_matrix_calloc(b->capacity, d);
+	b->y = gsl_vector_alloc(b->capacity);
+	gsl_vector_set_all(b->y, INFINITY);
+
+	b->model.chol = gsl_matrix_calloc(b->capacity, b->capacity);
+	b->model.alpha = gsl_vector_calloc(b->capacity);
+	b->model.z = gsl_vector_calloc(b->capacity);
+	b->model.kvec = gsl_vector_calloc(b->capacity);
+
+	b->best_best_pos = gsl_vector_alloc(d);
+	mem_array_alloc(&b->cand, d);
+	b->rng = gsl_rng_alloc(gsl_rng_mt19937);
+	gsl_rng_set(b->rng, b->config.seed != 0
+		? b->config.seed : (unsigned long)time(NULL));
+
+	b->best_best = INFINITY;
+
+	return b;
+}
+
+/**
+ * _evaluate - score rows [first, first + n) of the sample table
+ * @b: optimizer
+ * @first: first row
+ * @n: rows
+ *
+ * The rows are mapped to bound coordinates and handed over as one batch,
+ * so a batch-capable caller can fan them out to its workers.
+ */
+static void _evaluate(bayes_t *b, int first, int n)
+{
+	int d = b->config.dimensions;
+	gsl_matrix *pos = gsl_matrix_alloc(d, n);
+	gsl_vector *fit = gsl_vector_alloc(n);
+
+	for (int k = 0; k < n; k++)
+	{
+		gsl_vector_view col = gsl_matrix_column(pos, k);
+		bayes_unit_to_pos(b, gsl_matrix_const_ptr(b->u, first + k, 0),
+			&col.vector);
+	}
+
+	if (b->config.fit_func_batch)
+	{
+		b->config.fit_func_batch(pos, fit, b->config.fit_func_ctx);
+	}
+	else
+	{
+		for (int k = 0; k < n; k++)
+		{
+			gsl_vector_const_view col = gsl_matrix_const_column(pos, k);
+			gsl_vector_set(fit, k,
+				b->config.fit_func(&col.vector, b->config.fit_func_ctx));
+		}
+	}
+
+	for (int k = 0; k < n; k++)
+	{
+		double f = gsl_vector_get(fit, k);
+
+		if (isnan(f))
+		{
+			f = INFINITY;
+		}
+
+		gsl_vector_set(b->y, first + k, f);
+		b->iter_count++;
+
+		if (f < b->best_best)
+		{
+			gsl_vector_const_view col = gsl_matrix_const_column(pos, k);
+
+			b->best_best = f;
+			gsl_vector_memcpy(b->best_best_pos, &col.vector);
+		}
+	}
+
+	b->count = first + n;
+
+	gsl_matrix_free(pos);
+	gsl_vector_free(fit);
+}
+
+/**
+ * _init - evaluate the initial design
+ * @b: optimizer
+ *
+ * A Latin hypercube spreads the first samples so the surrogate sees the
+ * whole box before expected improvement takes over.  The initial guess,
+ * clamped into the bounds, replaces the first design point.
+ */
+static void _init(bayes_t *b)
+{
+	int n = b->config.initial_samples;
+	gsl_matrix_view design = gsl_matrix_submatrix(b->u, 0, 0, n,
+		b->config.dimensions);
+
+	bayes_latin_hypercube(b, &design.matrix, n);
+
+	if (b->config.initial_guess)
+	{
+		for (int d = 0; d < b->config.dimensions; d++)
+		{
+			double lo = gsl_vector_get(b->config.pos_min, d);
+			double hi = gsl_vector_get(b->config.pos_max, d);
+			double v = gsl_vector_get(b->config.initial_guess, d);
+			double u = hi > lo ? (v - lo) / (hi - lo) : 0.5;
+
+			gsl_matrix_set(b->u, 0, d, fmin(fmax(u, 0.0), 1.0));
+		}
+	}
+
+	_evaluate(b, 0, n);
+	b->initialized = 1;
+}
+
+/** Report the current best through log_func, if set */
+static void _log(const bayes_t *b)
+{
+	if (b->config.log_func)
+	{
+		b->config.log_func(bayes_get_best_pos(b), bayes_get_best_fit(b),
+			b->config.log_func_ctx);
+	}
+}
+
+/**
+ * bayes_optimize - run the optimization
+ * @b: optimizer handle
+ *
+ * Evaluates the initial design, then each step refits the surrogate and
+ * evaluates the batch_size points of greatest expected improvement until
+ * the evaluation budget is spent.  Within a batch, each proposal is
+ * entered into the model at its predicted mean (the "kriging believer")
+ * so that the next proposal looks elsewhere.  May be called repeatedly;
+ * a later call continues only if the budget was not yet reached.
+ */
+double bayes_optimize(bayes_t *b)
+{
+	int d = b->config.dimensions;
+
+	if (!b->initialized)
+	{
+		_init(b);
+		_log(b);
+	}
+
+	while (b->count < b->config.iterations)
+	{
+		if (b->config.cancel_flag != NULL && *b->config.cancel_flag)
+		{
+			break;
+		}
+
+		if (!isnan(b->config.exit_fit) && b->best_best <= b->config.exit_fit)
+		{
+			break;
+		}
+
+		int q = b->config.batch_size;
+		if (q > b->config.iterations - b->count)
+		{
+			q = b->config.iterations - b->count;
+		}
+
+		if (bayes_model_fit(b, b->count, 1) != 0)
+		{
+			/* Nothing finite to model yet: widen the design instead */
+			gsl_matrix_view more = gsl_matrix_submatrix(b->u, b->count, 0, q, d);
+			bayes_latin_hypercube(b, &more.matrix, q);
+		}
+		else
+		{
+			for (int k = 0; k < q; k++)
+			{
+				double *row = gsl_matrix_ptr(b->u, b->count + k, 0);
+
+				bayes_propose(b, row);
+
+				if (k + 1 < q)
+				{
+					double mu, var;
+
+					bayes_model_predict(b, row, &mu, &var);
+					gsl_vector_set(b->y, b->count + k,
+						b->model.y_mean + mu * b->model.y_std);
+					bayes_model_fit(b, b->count + k + 1, 0);
+				}
+			}
+		}
+
+		_evaluate(b, b->count, q);
+		_log(b);
+	}
+
+	return bayes_get_best_fit(b);
+}
+
+/** bayes_get_best_pos - return best position found */
+const gsl_vector *bayes_get_best_pos(const bayes_t *b)
+{
+	return b->best_best_pos;
+}
+
+/** bayes_get_best_fit - return best fitness value found */
+double bayes_get_best_fit(const bayes_t *b)
+{
+	return b->best_best;
+}
+
+/** bayes_get_iteration_count - return total fitness evaluations performed */
+int bayes_get_iteration_count(const bayes_t *b)
+{
+	return b->iter_count;
+}
+
+/**
+ * bayes_free - release all resources
+ * @b: optimizer handle (may be NULL)
+ */
+void bayes_free(bayes_t *b)
+{
+	if (!b)
+	{
+		return;
+	}
+
+	gsl_matrix_free(b->u);
+	gsl_vector_free(b->y);
+
+	gsl_matrix_free(b->model.chol);
+	gsl_vector_free(b->model.alpha);
+	gsl_vector_free(b->model.z);
+	gsl_vector_free(b->model.kvec);
+
+	gsl_vector_free(b->best_best_pos);
+	mem_array_free(&b->cand);
+
+	if (b->config.pos_min)
+	{
+		gsl_vector_free(b->config.pos_min);
+	}
+
+	if (b->config.pos_max)
+	{
+		gsl_vector_free(b->config.pos_max);
+	}
+
+	if (b->config.initial_guess)
+	{
+		gsl_vector_free(b->config.initial_guess);
+	}
+
+	if (b->rng)
+	{
+		gsl_rng_free(b->rng);
+	}
+
+	mem_free(&b);
+}
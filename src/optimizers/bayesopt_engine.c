@@ -0,0 +1,548 @@
+/*
+ *  Bayesian optimization - Gaussian-process surrogate and acquisition.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "bayesopt_internal.h"
+#include "../mem/mem.h"
+
+#include <gsl/gsl_randist.h>
+
+#include <math.h>
+#include <string.h>
+
+/** Length scales tried by the likelihood search, as fractions of the
+ *  unit-cube diagonal */
+static const double bayes_scale_grid[] =
+{
+	0.02, 0.05, 0.1, 0.2, 0.3, 0.5, 0.75, 1.0
+};
+
+/** Diagonal jitter growth steps before a fit gives up */
+#define BAYES_JITTER_TRIES 8
+
+/** Pattern-search halvings that polish the winning candidate */
+#define BAYES_POLISH_ROUNDS 8
+
+/* ---- Linear algebra on the leading n x n block ---- */
+
+/**
+ * _cholesky - factor the lower triangle of the leading block in place
+ * @a: symmetric matrix, lower triangle filled
+ * @n: block size
+ *
+ * Returns the sum of log diagonal entries (half the log determinant),
+ * or NAN if the block is not positive definite.
+ */
+static double _cholesky(gsl_matrix *a, int n)
+{
+	double half_logdet = 0.0;
+
+	for (int j = 0; j < n; j++)
+	{
+		double d = gsl_matrix_get(a, j, j);
+
+		for (int k = 0; k < j; k++)
+		{
+			double l = gsl_matrix_get(a, j, k);
+			d -= l * l;
+		}
+
+		if (!(d > 0.0))
+		{
+			return NAN;
+		}
+
+		d = sqrt(d);
+		gsl_matrix_set(a, j, j, d);
+		half_logdet += log(d);
+
+		for (int i = j + 1; i < n; i++)
+		{
+			double s = gsl_matrix_get(a, i, j);
+
+			for (int k = 0; k < j; k++)
+			{
+				s -= gsl_matrix_get(a, i, k) * gsl_matrix_get(a, j, k);
+			}
+			gsl_matrix_set(a, i, j, s / d);
+		}
+	}
+
+	return half_logdet;
+}
+
+/**
+ * _solve_lower - solve L x = rhs by forward substitution
+ * @l: lower Cholesky factor
+ * @n: block size
+ * @rhs: right-hand side [n]
+ * @out: solution [n], may alias rhs
+ */
+static void _solve_lower(const gsl_matrix *l, int n, const double *rhs,
+	double *out)
+{
+	for (int i = 0; i < n; i++)
+	{
+		double s = rhs[i];
+
+		for (int k = 0; k < i; k++)
+		{
+			s -= gsl_matrix_get(l, i, k) * out[k];
+		}
+		out[i] = s / gsl_matrix_get(l, i, i);
+	}
+}
+
+/**
+ * _solve_upper_t - solve L^T x = rhs by back substitution
+ * @l: lower Cholesky factor
+ * @n: block size
+ * @rhs: right-hand side [n]
+ * @out: solution [n], may alias rhs
+ */
+static void _solve_upper_t(const gsl_matrix *l, int n, const double *rhs,
+	double *out)
+{
+	for (int i = n - 1; i >= 0; i--)
+	{
+		double s = rhs[i];
+
+		for (int k = i + 1; k < n; k++)
+		{
+			s -= gsl_matrix_get(l, k, i) * out[k];
+		}
+		out[i] = s / gsl_matrix_get(l, i, i);
+	}
+}
+
+/* ---- Kernel ---- */
+
+/**
+ * _kernel - Matern 5/2 correlation between two unit-cube points
+ * @b: optimizer
+ * @u: first point [dimensions]
+ * @v: second point [dimensions]
+ * @ls: length scale
+ */
+static double _kernel(const bayes_t *b, const double *u, const double *v,
+	double ls)
+{
+	double d2 = 0.0;
+
+	for (int i = 0; i < b->config.dimensions; i++)
+	{
+		double t = u[i] - v[i];
+		d2 += t * t;
+	}
+
+	double s = sqrt(5.0 * d2) / ls;
+
+	return (1.0 + s + s * s / 3.0) * exp(-s);
+}
+
+/**
+ * _factor - build and factor the correlation matrix of the first n samples
+ * @b: optimizer
+ * @n: samples
+ * @ls: length scale
+ * @jitter: diagonal jitter
+ *
+ * Returns half the log determinant, or NAN if the factor failed.
+ */
+static double _factor(bayes_t *b, int n, double ls, double jitter)
+{
+	gsl_matrix *k = b->model.chol;
+
+	for (int i = 0; i < n; i++)
+	{
+		const double *ui = gsl_matrix_const_ptr(b->u, i, 0);
+
+		for (int j = 0; j < i; j++)
+		{
+			gsl_matrix_set(k, i, j,
+				_kernel(b, ui, gsl_matrix_const_ptr(b->u, j, 0), ls));
+		}
+		gsl_matrix_set(k, i, i, 1.0 + jitter);
+	}
+
+	return _cholesky(k, n);
+}
+
+/**
+ * _factor_jittered - factor, growing the jitter until the factor holds
+ * @b: optimizer
+ * @n: samples
+ * @ls: length scale
+ *
+ * Coincident samples make the correlation matrix singular; the jitter
+ * that finally succeeded is kept for prediction.
+ *
+ * Returns half the log determinant, or NAN if every attempt failed.
+ */
+static double _factor_jittered(bayes_t *b, int n, double ls)
+{
+	double jitter = b->config.noise;
+
+	for (int t = 0; t < BAYES_JITTER_TRIES; t++)
+	{
+		double hl = _factor(b, n, ls, jitter);
+
+		if (!isnan(hl))
+		{
+			return hl;
+		}
+		jitter *= 10.0;
+	}
+
+	return NAN;
+}
+
+/* ---- Surrogate ---- */
+
+/**
+ * bayes_model_fit - fit the surrogate to the first n samples
+ * @b: optimizer
+ * @n: samples to fit, including any believer points
+ * @select_scale: nonzero to rechoose the length scale
+ *
+ * Fitness is standardized first.  A failed evaluation (infinite fitness)
+ * is modelled as the worst finite one, which steers the acquisition away
+ * from it without an infinite target.  The length scale maximizes the
+ * marginal likelihood with the process variance concentrated out.
+ */
+int bayes_model_fit(bayes_t *b, int n, int select_scale)
+{
+	bayes_model_t *m = &b->model;
+	double worst = -INFINITY;
+	double sum = 0.0;
+	double sq = 0.0;
+	int finite = 0;
+	int dims = b->config.dimensions;
+	double *z = m->z->data;
+	double *alpha = m->alpha->data;
+
+	for (int i = 0; i < n; i++)
+	{
+		double y = gsl_vector_get(b->y, i);
+
+		if (isfinite(y))
+		{
+			finite++;
+			sum += y;
+			if (y > worst)
+			{
+				worst = y;
+			}
+		}
+	}
+
+	if (finite == 0)
+	{
+		return -1;
+	}
+
+	m->y_mean = sum / finite;
+	for (int i = 0; i < n; i++)
+	{
+		double y = gsl_vector_get(b->y, i);
+
+		if (isfinite(y))
+		{
+			sq += (y - m->y_mean) * (y - m->y_mean);
+		}
+	}
+
+	m->y_std = sqrt(sq / finite);
+	if (!(m->y_std > 0.0))
+	{
+		m->y_std = 1.0;
+	}
+
+	m->z_best = INFINITY;
+	for (int i = 0; i < n; i++)
+	{
+		double y = gsl_vector_get(b->y, i);
+
+		z[i] = ((isfinite(y) ? y : worst) - m->y_mean) / m->y_std;
+		if (z[i] < m->z_best)
+		{
+			m->z_best = z[i];
+		}
+	}
+
+	if (select_scale || m->length_scale <= 0.0)
+	{
+		double best_ll = -INFINITY;
+		double best_ls = 0.2 * sqrt((double)dims);
+
+		for (size_t g = 0; g < sizeof(bayes_scale_grid) / sizeof(bayes_scale_grid[0]); g++)
+		{
+			double ls = bayes_scale_grid[g] * sqrt((double)dims);
+			double hl = _factor_jittered(b, n, ls);
+
+			if (isnan(hl))
+			{
+				continue;
+			}
+
+			_solve_lower(m->chol, n, z, alpha);
+			_solve_upper_t(m->chol, n, alpha, alpha);
+
+			double quad = 0.0;
+			for (int i = 0; i < n; i++)
+			{
+				quad += z[i] * alpha[i];
+			}
+
+			double ll = -0.5 * n * log(fmax(quad / n, 1e-300)) - hl;
+			if (ll > best_ll)
+			{
+				best_ll = ll;
+				best_ls = ls;
+			}
+		}
+
+		m->length_scale = best_ls;
+	}
+
+	if (isnan(_factor_jittered(b, n, m->length_scale)))
+	{
+		return -1;
+	}
+
+	_solve_lower(m->chol, n, z, alpha);
+	_solve_upper_t(m->chol, n, alpha, alpha);
+
+	double quad = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		quad += z[i] * alpha[i];
+	}
+
+	m->sigma2 = fmax(quad / n, 1e-12);
+	m->n = n;
+
+	return 0;
+}
+
+/**
+ * bayes_model_predict - posterior mean and variance at a point
+ * @b: optimizer with a fitted model
+ * @u: unit-cube point [dimensions]
+ * @mu: output, standardized mean
+ * @var: output, standardized variance
+ */
+void bayes_model_predict(const bayes_t *b, const double *u,
+	double *mu, double *var)
+{
+	const bayes_model_t *m = &b->model;
+	double *k = m->kvec->data;
+	double mean = 0.0;
+	double vv = 0.0;
+
+	for (int i = 0; i < m->n; i++)
+	{
+		k[i] = _kernel(b, gsl_matrix_const_ptr(b->u, i, 0), u,
+			m->length_scale);
+		mean += k[i] * gsl_vector_get(m->alpha, i);
+	}
+
+	_solve_lower(m->chol, m->n, k, k);
+	for (int i = 0; i < m->n; i++)
+	{
+		vv += k[i] * k[i];
+	}
+
+	*mu = mean;
+	*var = m->sigma2 * fmax(1.0 - vv, 1e-12);
+}
+
+/**
+ * bayes_expected_improvement - expected improvement at a point
+ * @b: optimizer with a fitted model
+ * @u: unit-cube point [dimensions]
+ *
+ * Minimization form: the expected amount by which fitness at u falls
+ * below the fitted best less the xi margin.
+ */
+double bayes_expected_improvement(const bayes_t *b, const double *u)
+{
+	double mu, var;
+
+	bayes_model_predict(b, u, &mu, &var);
+
+	double s = sqrt(var);
+	double imp = b->model.z_best - mu - b->config.xi;
+
+	if (s < 1e-12)
+	{
+		return fmax(imp, 0.0);
+	}
+
+	double t = imp / s;
+
+	return imp * 0.5 * erfc(-t / M_SQRT2)
+		+ s * exp(-0.5 * t * t) / sqrt(2.0 * M_PI);
+}
+
+/**
+ * _incumbent - row of the best standardized fitness in the fit
+ * @b: optimizer with a fitted model
+ */
+static int _incumbent(const bayes_t *b)
+{
+	int best = 0;
+
+	for (int i = 1; i < b->model.n; i++)
+	{
+		if (gsl_vector_get(b->model.z, i) < gsl_vector_get(b->model.z, best))
+		{
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * bayes_propose - choose the next point to evaluate
+ * @b: optimizer with a fitted model
+ * @u_out: output, unit-cube point [dimensions]
+ *
+ * Scores config.candidates points, rotating between uniform draws over
+ * the cube and wide and narrow Gaussian draws around the incumbent, then
+ * polishes the winner with a coordinate pattern search on expected
+ * improvement.
+ */
+void bayes_propose(bayes_t *b, double *u_out)
+{
+	int dims = b->config.dimensions;
+	const double *inc = gsl_matrix_const_ptr(b->u, _incumbent(b), 0);
+	double sd = fmax(0.5 * b->model.length_scale / sqrt((double)dims), 1e-3);
+	double best_ei = -1.0;
+	double *cand = b->cand;
+
+	for (int c = 0; c < b->config.candidates; c++)
+	{
+		/* Rotate between the whole cube, the incumbent's neighbourhood
+		 * and a tight cluster that refines it */
+		for (int d = 0; d < dims; d++)
+		{
+			double v;
+
+			switch (c % 3)
+			{
+				case 0:
+					v = gsl_rng_uniform(b->rng);
+					break;
+
+				case 1:
+					v = inc[d] + gsl_ran_gaussian(b->rng, sd);
+					break;
+
+				default:
+					v = inc[d] + gsl_ran_gaussian(b->rng, 0.1 * sd);
+					break;
+			}
+
+			cand[d] = fmin(fmax(v, 0.0), 1.0);
+		}
+
+		double ei = bayes_expected_improvement(b, cand);
+		if (ei > best_ei)
+		{
+			best_ei = ei;
+			memcpy(u_out, cand, dims * sizeof(double));
+		}
+	}
+
+	/* Polish: move one coordinate at a time while EI improves */
+	double step = sd;
+	for (int round = 0; round < BAYES_POLISH_ROUNDS; round++, step *= 0.5)
+	{
+		for (int d = 0; d < dims; d++)
+		{
+			for (int sign = -1; sign <= 1; sign += 2)
+			{
+				memcpy(cand, u_out, dims * sizeof(double));
+				cand[d] = fmin(fmax(cand[d] + sign * step, 0.0), 1.0);
+
+				double ei = bayes_expected_improvement(b, cand);
+				if (ei > best_ei)
+				{
+					best_ei = ei;
+					u_out[d] = cand[d];
+				}
+			}
+		}
+	}
+}
+
+/* ---- Design and coordinates ---- */
+
+/**
+ * bayes_latin_hypercube - stratified random design in the unit cube
+ * @b: optimizer
+ * @design: output rows [n x dimensions]
+ * @n: points
+ *
+ * Every dimension is cut into n strata and each point takes a distinct
+ * stratum per dimension, so the design covers every axis evenly however
+ * few points it has.
+ */
+void bayes_latin_hypercube(bayes_t *b, gsl_matrix *design, int n)
+{
+	size_t *perm = NULL;
+
+	mem_array_alloc(&perm, n);
+
+	for (int d = 0; d < b->config.dimensions; d++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			perm[i] = (size_t)i;
+		}
+		gsl_ran_shuffle(b->rng, perm, n, sizeof(size_t));
+
+		for (int i = 0; i < n; i++)
+		{
+			gsl_matrix_set(design, i, d,
+				(perm[i] + gsl_rng_uniform(b->rng)) / n);
+		}
+	}
+
+	mem_array_free(&perm);
+}
+
+/**
+ * bayes_unit_to_pos - map a unit-cube point to bound coordinates
+ * @b: optimizer
+ * @u: unit-cube point [dimensions]
+ * @pos: output [dimensions]
+ */
+void bayes_unit_to_pos(const bayes_t *b, const double *u, gsl_vector *pos)
+{
+	for (int d = 0; d < b->config.dimensions; d++)
+	{
+		double lo = gsl_vector_get(b->config.pos_min, d);
+		double hi = gsl_vector_get(b->config.pos_max, d);
+
+		gsl_vector_set(pos, d, lo + u[d] * (hi - lo));
+	}
+}
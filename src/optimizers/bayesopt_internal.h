@@ -0,0 +1,99 @@
+/*
+ *  Bayesian optimization - internal definitions.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef BAYESOPT_INTERNAL_H
+#define BAYESOPT_INTERNAL_H 1
+
+#include "bayesopt.h"
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_rng.h>
+
+/**
+ * Gaussian-process surrogate over the samples, fitted in the unit cube
+ * to standardized fitness.  The kernel is an isotropic Matern 5/2 whose
+ * length scale is chosen by concentrated marginal likelihood.
+ */
+typedef struct
+{
+	int n;                     /**< Samples the fit covers */
+	double length_scale;       /**< Kernel length scale in unit-cube units */
+	double sigma2;             /**< Process variance of standardized fitness */
+	double y_mean;             /**< Fitness standardization offset */
+	double y_std;              /**< Fitness standardization scale */
+	double z_best;             /**< Best standardized fitness in the fit */
+
+	gsl_matrix *chol;          /**< Lower Cholesky factor [capacity x capacity] */
+	gsl_vector *alpha;         /**< K^-1 z [capacity] */
+	gsl_vector *z;             /**< Standardized fitness [capacity] */
+	gsl_vector *kvec;          /**< Prediction scratch [capacity] */
+} bayes_model_t;
+
+/** Full optimizer state, opaque to public API callers */
+struct bayes_s
+{
+	bayes_config_t config;
+
+	/* Samples: positions in the unit cube, one row each, and the raw
+	 * fitness of each.  Rows past count hold believer points while a
+	 * batch is being proposed. */
+	gsl_matrix *u;             /**< [capacity x dimensions] */
+	gsl_vector *y;             /**< [capacity] */
+	int count;                 /**< Evaluated samples */
+	int capacity;
+
+	bayes_model_t model;
+
+	double best_best;          /**< Best fitness, INFINITY when unset */
+	gsl_vector *best_best_pos; /**< Position of best, bound coordinates [dimensions] */
+	double *cand;              /**< Proposal scratch, unit cube [dimensions] */
+
+	int iter_count;            /**< Fitness evaluations performed */
+	gsl_rng *rng;
+	int initialized;
+};
+
+/** Fill rows [0, n) of design with a Latin hypercube in the unit cube */
+void bayes_latin_hypercube(bayes_t *b, gsl_matrix *design, int n);
+
+/**
+ * Fit the surrogate to the first n samples.  Selects the length scale
+ * when select_scale is nonzero, else keeps the current one.
+ * Returns 0 on success, -1 if no sample has finite fitness.
+ */
+int bayes_model_fit(bayes_t *b, int n, int select_scale);
+
+/** Predict standardized mean and variance at unit-cube point u */
+void bayes_model_predict(const bayes_t *b, const double *u,
+	double *mu, double *var);
+
+/** Expected improvement below the fitted best at unit-cube point u */
+double bayes_expected_improvement(const bayes_t *b, const double *u);
+
+/**
+ * Choose the unit-cube point maximizing expected improvement among
+ * random and incumbent-local candidates, into u_out [dimensions].
+ */
+void bayes_propose(bayes_t *b, double *u_out);
+
+/** Map a unit-cube point to bound coordinates */
+void bayes_unit_to_pos(const bayes_t *b, const double *u, gsl_vector *pos);
+
+#endif
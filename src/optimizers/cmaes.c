@@ -0,0 +1,392 @@
+/*
+ *  CMA-ES - public API and main loop.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "cmaes_internal.h"
+#include "optimizer_bounds.h"
+#include "../mem/mem.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static void _init_strategy(cmaes_t *c);
+static void _reset_covariance(cmaes_t *c);
+
+/**
+ * cmaes_config_init - fill config with safe defaults
+ * @config: pointer to config struct to initialize
+ *
+ * Sets all fields to sensible defaults.  Caller must still set
+ * fit_func, the bounds, and either dimensions or initial_guess before
+ * calling cmaes_new().
+ */
+void cmaes_config_init(cmaes_config_t *config)
+{
+	memset(config, 0, sizeof(*config));
+	config->pos_min = NULL;
+	config->pos_max = NULL;
+	config->sigma = 0.3;
+	config->min_sigma = 1e-9;
+	config->exit_fit = NAN;
+}
+
+/**
+ * cmaes_new - create a new CMA-ES optimizer
+ * @config: configuration (copied internally)
+ *
+ * Validates configuration, applies computed defaults, and allocates
+ * the optimizer.  Returns NULL with a message to stderr on error.
+ */
+cmaes_t *cmaes_new(const cmaes_config_t *config)
+{
+	if (!config->fit_func)
+	{
+		fprintf(stderr, "cmaes_new: fit_func is required\n");
+		return NULL;
+	}
+
+	if (config->dimensions <= 0 && !config->initial_guess)
+	{
+		fprintf(stderr, "cmaes_new: dimensions or initial_guess required\n");
+		return NULL;
+	}
+
+	int d = config->dimensions;
+	if (d <= 0 && config->initial_guess)
+	{
+		d = (int)config->initial_guess->size;
+	}
+
+	/* The search runs in the unit cube, so every bound must be finite */
+	if (!config->pos_min || !config->pos_max)
+	{
+		fprintf(stderr, "cmaes_new: pos_min and pos_max are required\n");
+		return NULL;
+	}
+
+	if (optimizer_validate_bounds(config->pos_min, config->pos_max,
+		d, 0, "cmaes_new") != 0)
+	{
+		return NULL;
+	}
+
+	for (int i = 0; i < d; i++)
+	{
+		if (!isfinite(gsl_vector_get(config->pos_min, i))
+			|| !isfinite(gsl_vector_get(config->pos_max, i)))
+		{
+			fprintf(stderr, "cmaes_new: bound %d is not finite\n", i);
+			return NULL;
+		}
+	}
+
+	cmaes_t *c = NULL;
+	mem_new(&c);
+	if (!c)
+	{
+		return NULL;
+	}
+
+	c->config = *config;
+
+	/* Prevent cmaes_free from freeing caller's pointers before deep-copy */
+	c->config.initial_guess = NULL;
+	c->config.pos_min = NULL;
+	c->config.pos_max = NULL;
+
+	c->config.dimensions = d;
+
+	if (config->initial_guess)
+	{
+		c->config.initial_guess = gsl_vector_alloc(config->initial_guess->size);
+		gsl_vector_memcpy(c->config.initial_guess, config->initial_guess);
+	}
+
+	optimizer_deep_copy_bounds(&c->config.pos_min, &c->config.pos_max,
+		config->pos_min, config->pos_max);
+
+	/* Computed defaults */
+	if (c->config.iterations <= 0)
+	{
+		c->config.iterations = 1000;
+	}
+	if (c->config.lambda <= 0)
+	{
+		c->config.lambda = 4 + (int)(3.0 * log((double)d));
+
+		if (c->config.lambda < c->config.min_lambda)
+		{
+			c->config.lambda = c->config.min_lambda;
+		}
+	}
+	if (c->config.lambda < 2)
+	{
+		c->config.lambda = 2;
+	}
+	if (c->config.mu <= 0 || c->config.mu > c->config.lambda)
+	{
+		c->config.mu = c->config.lambda / 2;
+	}
+	if (!(c->config.sigma > 0.0))
+	{
+		c->config.sigma = 0.3;
+	}
+
+	int lambda = c->config.lambda;
+
+	mem_array_alloc(&c->weights, c->config.mu);
+	mem_array_alloc(&c->order, lambda);
+
+	c->mean = gsl_vector_alloc(d);
+	c->pc = gsl_vector_calloc(d);
+	c->ps = gsl_vector_calloc(d);
+	c->cov = gsl_matrix_alloc(d, d);
+	c->b = gsl_matrix_alloc(d, d);
+	c->d = gsl_vector_alloc(d);
+	c->eigen_ws = gsl_eigen_symmv_alloc(d);
+	c->eigen_tmp = gsl_matrix_alloc(d, d);
+
+	c->arx = gsl_matrix_alloc(d, lambda);
+	c->pos = gsl_matrix_alloc(d, lambda);
+	c->fit = gsl_vector_alloc(lambda);
+	c->xold = gsl_vector_alloc(d);
+	c->tmp = gsl_vector_alloc(d);
+
+	c->best_best_pos = gsl_vector_alloc(d);
+	c->rng = gsl_rng_alloc(gsl_rng_mt19937);
+	gsl_rng_set(c->rng, c->config.seed != 0
+		? c->config.seed : (unsigned long)time(NULL));
+
+	_init_strategy(c);
+
+	/* Start at the guess, clamped into the bounds, else the center */
+	for (int i = 0; i < d; i++)
+	{
+		double u = 0.5;
+
+		if (c->config.initial_guess)
+		{
+			double lo = gsl_vector_get(c->config.pos_min, i);
+			double hi = gsl_vector_get(c->config.pos_max, i);
+
+			u = (gsl_vector_get(c->config.initial_guess, i) - lo) / (hi - lo);
+		}
+		gsl_vector_set(c->mean, i, fmin(fmax(u, 0.0), 1.0));
+	}
+
+	c->sigma = c->config.sigma;
+	_reset_covariance(c);
+
+	c->best_best = INFINITY;
+
+	return c;
+}
+
+/**
+ * _init_strategy - compute the fixed strategy parameters
+ * @c: optimizer
+ *
+ * Default learning rates and log-linear recombination weights from
+ * Hansen's tutorial, which need no tuning for a given dimension count.
+ */
+static void _init_strategy(cmaes_t *c)
+{
+	double n = c->config.dimensions;
+	int mu = c->config.mu;
+	double sum = 0.0;
+	double sum2 = 0.0;
+
+	for (int k = 0; k < mu; k++)
+	{
+		c->weights[k] = log(mu + 0.5) - log(k + 1.0);
+		sum += c->weights[k];
+	}
+
+	for (int k = 0; k < mu; k++)
+	{
+		c->weights[k] /= sum;
+		sum2 += c->weights[k] * c->weights[k];
+	}
+
+	c->mueff = 1.0 / sum2;
+	c->cc = (4.0 + c->mueff / n) / (n + 4.0 + 2.0 * c->mueff / n);
+	c->cs = (c->mueff + 2.0) / (n + c->mueff + 5.0);
+	c->c1 = 2.0 / ((n + 1.3) * (n + 1.3) + c->mueff);
+	c->cmu = fmin(1.0 - c->c1, 2.0 * (c->mueff - 2.0 + 1.0 / c->mueff)
+		/ ((n + 2.0) * (n + 2.0) + c->mueff));
+	c->damps = 1.0 + 2.0 * fmax(0.0, sqrt((c->mueff - 1.0) / (n + 1.0)) - 1.0)
+		+ c->cs;
+	c->chi_n = sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+}
+
+/** Reset covariance to the identity and clear both evolution paths */
+static void _reset_covariance(cmaes_t *c)
+{
+	gsl_matrix_set_identity(c->cov);
+	gsl_matrix_set_identity(c->b);
+	gsl_vector_set_all(c->d, 1.0);
+	gsl_vector_set_zero(c->pc);
+	gsl_vector_set_zero(c->ps);
+}
+
+/**
+ * _max_step - largest standard deviation of the sampling distribution
+ * @c: optimizer
+ */
+static double _max_step(const cmaes_t *c)
+{
+	double max_d = 0.0;
+
+	for (int i = 0; i < c->config.dimensions; i++)
+	{
+		max_d = fmax(max_d, gsl_vector_get(c->d, i));
+	}
+
+	return c->sigma * max_d;
+}
+
+/**
+ * cmaes_optimize - run the optimization
+ * @c: optimizer handle
+ *
+ * Each generation samples lambda points, evaluates them as one batch,
+ * and adapts the distribution.  Stops at the generation limit, on
+ * cancellation, when exit_fit is reached, or when the distribution has
+ * shrunk below min_sigma of the range.  May be called repeatedly to
+ * continue from where the last run stopped.
+ */
+double cmaes_optimize(cmaes_t *c)
+{
+	for (int gen = 0; gen < c->config.iterations; gen++)
+	{
+		if (c->config.cancel_flag != NULL && *c->config.cancel_flag)
+		{
+			break;
+		}
+
+		cmaes_sample(c);
+		cmaes_evaluate(c);
+		cmaes_update(c);
+		c->iter_count++;
+
+		if (cmaes_decompose(c) != 0)
+		{
+			/* Covariance collapsed: restart its shape, keep mean and sigma */
+			_reset_covariance(c);
+		}
+
+		if (c->config.log_func)
+		{
+			c->config.log_func(cmaes_get_best_pos(c), cmaes_get_best_fit(c),
+				_max_step(c), c->config.log_func_ctx);
+		}
+
+		if (!isnan(c->config.exit_fit) && c->best_best <= c->config.exit_fit)
+		{
+			break;
+		}
+
+		if (_max_step(c) < c->config.min_sigma)
+		{
+			break;
+		}
+	}
+
+	return cmaes_get_best_fit(c);
+}
+
+/** cmaes_get_best_pos - return best position found */
+const gsl_vector *cmaes_get_best_pos(const cmaes_t *c)
+{
+	return c->best_best_pos;
+}
+
+/** cmaes_get_best_fit - return best fitness value found */
+double cmaes_get_best_fit(const cmaes_t *c)
+{
+	return c->best_best;
+}
+
+/** cmaes_get_iteration_count - return total generations performed */
+int cmaes_get_iteration_count(const cmaes_t *c)
+{
+	return c->iter_count;
+}
+
+/** cmaes_get_population - return the samples of the last generation */
+const gsl_matrix *cmaes_get_population(const cmaes_t *c)
+{
+	return c->pos;
+}
+
+/**
+ * cmaes_free - release all resources
+ * @c: optimizer handle (may be NULL)
+ */
+void cmaes_free(cmaes_t *c)
+{
+	if (!c)
+	{
+		return;
+	}
+
+	gsl_vector_free(c->mean);
+	gsl_vector_free(c->pc);
+	gsl_vector_free(c->ps);
+	gsl_matrix_free(c->cov);
+	gsl_matrix_free(c->b);
+	gsl_vector_free(c->d);
+	gsl_eigen_symmv_free(c->eigen_ws);
+	gsl_matrix_free(c->eigen_tmp);
+
+	gsl_matrix_free(c->arx);
+	gsl_matrix_free(c->pos);
+	gsl_vector_free(c->fit);
+	gsl_vector_free(c->xold);
+	gsl_vector_free(c->tmp);
+
+	gsl_vector_free(c->best_best_pos);
+
+	if (c->config.pos_min)
+	{
+		gsl_vector_free(c->config.pos_min);
+	}
+
+	if (c->config.pos_max)
+	{
+		gsl_vector_free(c->config.pos_max);
+	}
+
+	if (c->config.initial_guess)
+	{
+		gsl_vector_free(c->config.initial_guess);
+	}
+
+	if (c->rng)
+	{
+		gsl_rng_free(c->rng);
+	}
+
+	mem_array_free(&c->weights);
+	mem_array_free(&c->order);
+	mem_free(&c);
+}
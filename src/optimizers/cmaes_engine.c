@@ -0,0 +1,290 @@
+/*
+ *  CMA-ES - sampling, ranking and distribution update.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "cmaes_internal.h"
+
+#include <gsl/gsl_randist.h>
+
+#include <math.h>
+
+/**
+ * cmaes_sample - draw the generation
+ * @c: optimizer
+ *
+ * Each sample is mean + sigma * B * diag(d) * z with z ~ N(0, I), clamped
+ * into the unit cube.  The clamped sample is the one ranked and fed back
+ * to the update, so the distribution learns the box as it does the
+ * fitness.  All random numbers are drawn before any evaluation, so batch
+ * and serial evaluation see the same generation.
+ */
+void cmaes_sample(cmaes_t *c)
+{
+	int n = c->config.dimensions;
+
+	for (int k = 0; k < c->config.lambda; k++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			gsl_vector_set(c->tmp, i,
+				gsl_vector_get(c->d, i) * gsl_ran_gaussian(c->rng, 1.0));
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			double y = 0.0;
+
+			for (int j = 0; j < n; j++)
+			{
+				y += gsl_matrix_get(c->b, i, j) * gsl_vector_get(c->tmp, j);
+			}
+
+			double x = gsl_vector_get(c->mean, i) + c->sigma * y;
+			x = fmin(fmax(x, 0.0), 1.0);
+
+			double lo = gsl_vector_get(c->config.pos_min, i);
+			double hi = gsl_vector_get(c->config.pos_max, i);
+
+			gsl_matrix_set(c->arx, i, k, x);
+			gsl_matrix_set(c->pos, i, k, lo + x * (hi - lo));
+		}
+	}
+}
+
+/**
+ * cmaes_evaluate - score the generation
+ * @c: optimizer
+ *
+ * Hands all lambda samples to fit_func_batch when set, so a parallel
+ * caller can spread them over its workers, else calls fit_func per
+ * sample.  Tracks the best position seen.
+ */
+void cmaes_evaluate(cmaes_t *c)
+{
+	if (c->config.fit_func_batch)
+	{
+		c->config.fit_func_batch(c->pos, c->fit, c->config.fit_func_ctx);
+	}
+	else
+	{
+		for (int k = 0; k < c->config.lambda; k++)
+		{
+			gsl_vector_const_view col = gsl_matrix_const_column(c->pos, k);
+			gsl_vector_set(c->fit, k,
+				c->config.fit_func(&col.vector, c->config.fit_func_ctx));
+		}
+	}
+
+	for (int k = 0; k < c->config.lambda; k++)
+	{
+		double f = gsl_vector_get(c->fit, k);
+
+		if (isnan(f))
+		{
+			f = INFINITY;
+			gsl_vector_set(c->fit, k, f);
+		}
+
+		if (f < c->best_best)
+		{
+			gsl_vector_const_view col = gsl_matrix_const_column(c->pos, k);
+
+			c->best_best = f;
+			gsl_vector_memcpy(c->best_best_pos, &col.vector);
+		}
+	}
+}
+
+/**
+ * _rank - sort sample indices by ascending fitness
+ * @c: optimizer
+ *
+ * Insertion sort: lambda is small and the sort must be stable so that
+ * ties rank the same way on every run.
+ */
+static void _rank(cmaes_t *c)
+{
+	int lambda = c->config.lambda;
+
+	for (int k = 0; k < lambda; k++)
+	{
+		c->order[k] = k;
+	}
+
+	for (int k = 1; k < lambda; k++)
+	{
+		int idx = c->order[k];
+		double f = gsl_vector_get(c->fit, idx);
+		int j = k - 1;
+
+		while (j >= 0 && gsl_vector_get(c->fit, c->order[j]) > f)
+		{
+			c->order[j + 1] = c->order[j];
+			j--;
+		}
+		c->order[j + 1] = idx;
+	}
+}
+
+/**
+ * cmaes_update - adapt the distribution to the ranked generation
+ * @c: optimizer
+ *
+ * Weighted recombination of the mu best samples moves the mean; the
+ * evolution paths accumulate successive steps; the covariance takes a
+ * rank-one update from pc and a rank-mu update from the selected steps;
+ * sigma grows or shrinks as ps is longer or shorter than a random walk.
+ */
+void cmaes_update(cmaes_t *c)
+{
+	int n = c->config.dimensions;
+	int mu = c->config.mu;
+
+	_rank(c);
+
+	gsl_vector_memcpy(c->xold, c->mean);
+
+	for (int i = 0; i < n; i++)
+	{
+		double m = 0.0;
+
+		for (int k = 0; k < mu; k++)
+		{
+			m += c->weights[k] * gsl_matrix_get(c->arx, i, c->order[k]);
+		}
+		gsl_vector_set(c->mean, i, m);
+	}
+
+	/* tmp = B^T y_w / d, then C^-1/2 y_w = B tmp */
+	for (int j = 0; j < n; j++)
+	{
+		double s = 0.0;
+
+		for (int i = 0; i < n; i++)
+		{
+			double yw = (gsl_vector_get(c->mean, i)
+				- gsl_vector_get(c->xold, i)) / c->sigma;
+
+			s += gsl_matrix_get(c->b, i, j) * yw;
+		}
+		gsl_vector_set(c->tmp, j, s / gsl_vector_get(c->d, j));
+	}
+
+	double ps_scale = sqrt(c->cs * (2.0 - c->cs) * c->mueff);
+	double ps_norm2 = 0.0;
+
+	for (int i = 0; i < n; i++)
+	{
+		double s = 0.0;
+
+		for (int j = 0; j < n; j++)
+		{
+			s += gsl_matrix_get(c->b, i, j) * gsl_vector_get(c->tmp, j);
+		}
+
+		double ps = (1.0 - c->cs) * gsl_vector_get(c->ps, i) + ps_scale * s;
+		gsl_vector_set(c->ps, i, ps);
+		ps_norm2 += ps * ps;
+	}
+
+	double ps_norm = sqrt(ps_norm2);
+	int gen = c->iter_count + 1;
+	int hsig = ps_norm / sqrt(1.0 - pow(1.0 - c->cs, 2.0 * gen)) / c->chi_n
+		< 1.4 + 2.0 / (n + 1.0);
+
+	double pc_scale = hsig * sqrt(c->cc * (2.0 - c->cc) * c->mueff);
+
+	for (int i = 0; i < n; i++)
+	{
+		double yw = (gsl_vector_get(c->mean, i)
+			- gsl_vector_get(c->xold, i)) / c->sigma;
+
+		gsl_vector_set(c->pc, i,
+			(1.0 - c->cc) * gsl_vector_get(c->pc, i) + pc_scale * yw);
+	}
+
+	double keep = 1.0 - c->c1 - c->cmu;
+	double lost = (1 - hsig) * c->cc * (2.0 - c->cc);
+
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j <= i; j++)
+		{
+			double rank_mu = 0.0;
+
+			for (int k = 0; k < mu; k++)
+			{
+				int idx = c->order[k];
+				double ai = (gsl_matrix_get(c->arx, i, idx)
+					- gsl_vector_get(c->xold, i)) / c->sigma;
+				double aj = (gsl_matrix_get(c->arx, j, idx)
+					- gsl_vector_get(c->xold, j)) / c->sigma;
+
+				rank_mu += c->weights[k] * ai * aj;
+			}
+
+			double cij = gsl_matrix_get(c->cov, i, j);
+			double rank_one = gsl_vector_get(c->pc, i) * gsl_vector_get(c->pc, j)
+				+ lost * cij;
+
+			cij = keep * cij + c->c1 * rank_one + c->cmu * rank_mu;
+			gsl_matrix_set(c->cov, i, j, cij);
+			gsl_matrix_set(c->cov, j, i, cij);
+		}
+	}
+
+	/* A step the size of the whole cube already samples everything */
+	c->sigma *= exp((c->cs / c->damps) * (ps_norm / c->chi_n - 1.0));
+	c->sigma = fmin(c->sigma, 1.0);
+}
+
+/**
+ * cmaes_decompose - eigendecompose the covariance
+ * @c: optimizer
+ *
+ * Fills b with the eigenvectors and d with the square roots of the
+ * eigenvalues.  Round-off can push a tiny eigenvalue negative; those are
+ * floored at a small fraction of the largest so sampling stays defined.
+ */
+int cmaes_decompose(cmaes_t *c)
+{
+	int n = c->config.dimensions;
+	double max_ev = 0.0;
+
+	gsl_matrix_memcpy(c->eigen_tmp, c->cov);
+	gsl_eigen_symmv(c->eigen_tmp, c->d, c->b, c->eigen_ws);
+
+	for (int i = 0; i < n; i++)
+	{
+		max_ev = fmax(max_ev, gsl_vector_get(c->d, i));
+	}
+
+	if (!(max_ev > 0.0) || !isfinite(max_ev))
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		double ev = fmax(gsl_vector_get(c->d, i), 1e-14 * max_ev);
+		gsl_vector_set(c->d, i, sqrt(ev));
+	}
+
+	return 0;
+}
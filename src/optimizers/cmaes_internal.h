@@ -0,0 +1,88 @@
+/*
+ *  CMA-ES - internal definitions.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef CMAES_INTERNAL_H
+#define CMAES_INTERNAL_H 1
+
+#include "cmaes.h"
+
+#include <gsl/gsl_eigen.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_rng.h>
+
+/**
+ * Full optimizer state, opaque to public API callers.  The search runs
+ * in the unit cube of the bounds, so sigma and the covariance are in
+ * fractions of each range.
+ */
+struct cmaes_s
+{
+	cmaes_config_t config;
+
+	/* Strategy parameters, fixed at construction */
+	double *weights;           /**< Recombination weights [mu] */
+	double mueff;              /**< Variance-effective selection mass */
+	double cc, cs;             /**< Path cumulation constants */
+	double c1, cmu;            /**< Rank-one and rank-mu learning rates */
+	double damps;              /**< Step-size damping */
+	double chi_n;              /**< Expected norm of an N(0,I) sample */
+
+	/* Distribution state */
+	gsl_vector *mean;          /**< [dimensions] */
+	double sigma;
+	gsl_vector *pc;            /**< Covariance evolution path [dimensions] */
+	gsl_vector *ps;            /**< Step-size evolution path [dimensions] */
+	gsl_matrix *cov;           /**< Covariance C [dimensions x dimensions] */
+	gsl_matrix *b;             /**< Eigenvectors of C, one per column */
+	gsl_vector *d;             /**< Square roots of the eigenvalues of C */
+	gsl_eigen_symmv_workspace *eigen_ws;
+	gsl_matrix *eigen_tmp;     /**< Scratch copy of C destroyed by the solver */
+
+	/* Current generation */
+	gsl_matrix *arx;           /**< Samples in the unit cube [dimensions x lambda] */
+	gsl_matrix *pos;           /**< Samples in bound coordinates [dimensions x lambda] */
+	gsl_vector *fit;           /**< [lambda] */
+	int *order;                /**< Sample indices sorted by fitness [lambda] */
+	gsl_vector *xold;          /**< Mean before the update [dimensions] */
+	gsl_vector *tmp;           /**< Scratch [dimensions] */
+
+	double best_best;          /**< Best fitness, INFINITY when unset */
+	gsl_vector *best_best_pos; /**< Position of best, bound coordinates [dimensions] */
+
+	int iter_count;            /**< Generations performed */
+	gsl_rng *rng;
+};
+
+/** Draw lambda samples around the mean into arx and pos */
+void cmaes_sample(cmaes_t *c);
+
+/** Evaluate the generation into fit, converting NaN to INFINITY */
+void cmaes_evaluate(cmaes_t *c);
+
+/** Rank the generation and update mean, paths, covariance and sigma */
+void cmaes_update(cmaes_t *c);
+
+/**
+ * Refresh b and d from the covariance.
+ * Returns 0 on success, -1 if the covariance has collapsed.
+ */
+int cmaes_decompose(cmaes_t *c);
+
+#endif
@@ -0,0 +1,530 @@
+/*
+ *  Optimizer evaluation cache - hash table and file I/O.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#include "opt_cache.h"
+#include "../console.h"
+#include "../mem/mem.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/** File signature, followed by a byte-order word */
+#define OPT_CACHE_MAGIC      "XNOPTC1"
+#define OPT_CACHE_ORDER      0x01020304u
+#define OPT_CACHE_TAG_LEN    128
+
+/** Slot table size for the first entry; always a power of two */
+#define OPT_CACHE_MIN_SLOTS  64
+
+struct opt_cache_s
+{
+	int    dims;
+	size_t payload_size;
+	double tolerance;
+
+	/* Entries in insertion order: quantized keys [capacity * dims],
+	 * fitness, payloads [capacity * payload_size], and key hashes so
+	 * a rehash never rereads the keys */
+	double        *keys;
+	double        *values;
+	unsigned char *payloads;
+	uint64_t      *hashes;
+	int count;
+	int capacity;
+
+	/* Open-addressed slot table of entry index + 1, 0 = empty.  Kept at
+	 * most half full so linear probes stay short. */
+	int *slots;
+	int  num_slots;
+};
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * _quantize - canonical form of one key value
+ * @c: cache
+ * @v: raw value
+ *
+ * Rounds to the tolerance, and folds -0 into 0 and every NaN into one,
+ * so values that compare equal also hash equal.
+ */
+static double _quantize(const opt_cache_t *c, double v)
+{
+	if (isnan(v))
+	{
+		return NAN;
+	}
+
+	if (c->tolerance > 0.0 && isfinite(v))
+	{
+		v = nearbyint(v / c->tolerance) * c->tolerance;
+	}
+
+	return v == 0.0 ? 0.0 : v;
+}
+
+/**
+ * _mix - fold one 64-bit word into a running hash
+ *
+ * The splitmix64 finalizer; every input bit reaches every output bit,
+ * so neighbouring positions land in unrelated slots.
+ */
+static uint64_t _mix(uint64_t h, uint64_t w)
+{
+	h ^= w + 0x9e3779b97f4a7c15ULL;
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	return h ^ (h >> 31);
+}
+
+/**
+ * _make_key - quantize a key vector and hash it
+ * @c: cache
+ * @key: position vector
+ * @out: output, dims quantized values
+ *
+ * Returns the hash of @out.
+ */
+static uint64_t _make_key(const opt_cache_t *c, const gsl_vector *key,
+	double *out)
+{
+	uint64_t h = (uint64_t)c->dims;
+
+	for (int d = 0; d < c->dims; d++)
+	{
+		uint64_t bits;
+
+		out[d] = _quantize(c, gsl_vector_get(key, d));
+		memcpy(&bits, &out[d], sizeof(bits));
+		h = _mix(h, bits);
+	}
+
+	return h;
+}
+
+/**
+ * _find - probe for a quantized key
+ * @c: cache
+ * @qkey: quantized key
+ * @hash: its hash
+ * @slot: output, the slot holding the key or the empty slot ending the probe
+ *
+ * Returns the entry index, or -1 if absent.
+ */
+static int _find(const opt_cache_t *c, const double *qkey, uint64_t hash,
+	int *slot)
+{
+	int mask = c->num_slots - 1;
+	int i = (int)(hash & (uint64_t)mask);
+
+	while (c->slots[i] != 0)
+	{
+		int e = c->slots[i] - 1;
+
+		if (c->hashes[e] == hash
+			&& memcmp(&c->keys[(size_t)e * c->dims], qkey,
+				(size_t)c->dims * sizeof(double)) == 0)
+		{
+			*slot = i;
+			return e;
+		}
+
+		i = (i + 1) & mask;
+	}
+
+	*slot = i;
+	return -1;
+}
+
+/**
+ * _rehash - resize the slot table and reinsert every entry
+ * @c: cache
+ * @num_slots: new size, a power of two above twice the entry count
+ */
+static void _rehash(opt_cache_t *c, int num_slots)
+{
+	int mask = num_slots - 1;
+
+	mem_array_free(&c->slots);
+	mem_array_alloc(&c->slots, num_slots);
+	mem_array_zero(c->slots);
+	c->num_slots = num_slots;
+
+	for (int e = 0; e < c->count; e++)
+	{
+		int i = (int)(c->hashes[e] & (uint64_t)mask);
+
+		while (c->slots[i] != 0)
+		{
+			i = (i + 1) & mask;
+		}
+
+		c->slots[i] = e + 1;
+	}
+}
+
+/**
+ * _grow - make room for one more entry
+ * @c: cache
+ */
+static void _grow(opt_cache_t *c)
+{
+	if (c->count == c->capacity)
+	{
+		int cap = c->capacity > 0 ? c->capacity * 2 : OPT_CACHE_MIN_SLOTS / 2;
+
+		mem_array_realloc(&c->keys, (size_t)cap * (c->dims > 0 ? c->dims : 1));
+		mem_array_realloc(&c->values, cap);
+		mem_array_realloc(&c->hashes, cap);
+		if (c->payload_size > 0)
+		{
+			mem_array_realloc(&c->payloads, (size_t)cap * c->payload_size);
+		}
+		c->capacity = cap;
+	}
+
+	if (2 * (c->count + 1) > c->num_slots)
+	{
+		_rehash(c, c->num_slots > 0 ? c->num_slots * 2 : OPT_CACHE_MIN_SLOTS);
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_cache_new - create an empty cache
+ */
+opt_cache_t *opt_cache_new(int dims, size_t payload_size, double tolerance)
+{
+	if (dims < 0 || !(tolerance >= 0.0) || !isfinite(tolerance))
+	{
+		pr_warn("opt_cache_new: invalid dims %d or tolerance %g\n",
+			dims, tolerance);
+		return NULL;
+	}
+
+	opt_cache_t *c = NULL;
+	mem_new(&c);
+	if (!c)
+	{
+		return NULL;
+	}
+
+	memset(c, 0, sizeof(*c));
+	c->dims = dims;
+	c->payload_size = payload_size;
+	c->tolerance = tolerance;
+
+	return c;
+}
+
+/**
+ * opt_cache_free - release a cache
+ */
+void opt_cache_free(opt_cache_t *c)
+{
+	if (!c)
+	{
+		return;
+	}
+
+	mem_array_free(&c->keys);
+	mem_array_free(&c->values);
+	mem_array_free(&c->hashes);
+	mem_array_free(&c->payloads);
+	mem_array_free(&c->slots);
+	mem_free(&c);
+}
+
+/**
+ * opt_cache_clear - drop every entry, keeping the allocation
+ */
+void opt_cache_clear(opt_cache_t *c)
+{
+	c->count = 0;
+
+	if (c->slots)
+	{
+		mem_array_zero(c->slots);
+	}
+}
+
+/**
+ * opt_cache_count - number of entries stored
+ */
+int opt_cache_count(const opt_cache_t *c)
+{
+	return c ? c->count : 0;
+}
+
+/**
+ * opt_cache_lookup - find the entry for a key
+ */
+int opt_cache_lookup(const opt_cache_t *c, const gsl_vector *key,
+	double *value, const void **payload)
+{
+	if (!c || c->count == 0 || (int)key->size != c->dims)
+	{
+		return 0;
+	}
+
+	double qkey[c->dims > 0 ? c->dims : 1];
+	uint64_t hash = _make_key(c, key, qkey);
+	int slot;
+	int e = _find(c, qkey, hash, &slot);
+
+	if (e < 0)
+	{
+		return 0;
+	}
+
+	if (value)
+	{
+		*value = c->values[e];
+	}
+
+	if (payload)
+	{
+		*payload = c->payload_size > 0
+			? &c->payloads[(size_t)e * c->payload_size] : NULL;
+	}
+
+	return 1;
+}
+
+/**
+ * opt_cache_store - add or replace the entry for a key
+ */
+int opt_cache_store(opt_cache_t *c, const gsl_vector *key, double value,
+	const void *payload)
+{
+	if ((int)key->size != c->dims)
+	{
+		return -1;
+	}
+
+	double qkey[c->dims > 0 ? c->dims : 1];
+	uint64_t hash = _make_key(c, key, qkey);
+	int slot = 0;
+	int e = c->num_slots > 0 ? _find(c, qkey, hash, &slot) : -1;
+
+	if (e < 0)
+	{
+		_grow(c);
+
+		/* The table may have been rebuilt; probe again for the slot */
+		_find(c, qkey, hash, &slot);
+
+		e = c->count++;
+		memcpy(&c->keys[(size_t)e * c->dims], qkey,
+			(size_t)c->dims * sizeof(double));
+		c->hashes[e] = hash;
+		c->slots[slot] = e + 1;
+	}
+
+	c->values[e] = value;
+
+	if (c->payload_size > 0)
+	{
+		unsigned char *dst = &c->payloads[(size_t)e * c->payload_size];
+
+		if (payload)
+		{
+			memcpy(dst, payload, c->payload_size);
+		}
+		else
+		{
+			memset(dst, 0, c->payload_size);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * opt_cache_same_key - compare two keys as the cache would
+ */
+int opt_cache_same_key(const opt_cache_t *c, const gsl_vector *a,
+	const gsl_vector *b)
+{
+	if ((int)a->size != c->dims || (int)b->size != c->dims)
+	{
+		return 0;
+	}
+
+	for (int d = 0; d < c->dims; d++)
+	{
+		double qa = _quantize(c, gsl_vector_get(a, d));
+		double qb = _quantize(c, gsl_vector_get(b, d));
+
+		if (memcmp(&qa, &qb, sizeof(double)) != 0)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*------------------------------------------------------------------------*/
+
+/** On-disk header; entries follow as key, fitness, payload */
+typedef struct
+{
+	char     magic[8];
+	uint32_t order;
+	int32_t  dims;
+	uint64_t payload_size;
+	int64_t  count;
+	char     tag[OPT_CACHE_TAG_LEN];
+} opt_cache_header_t;
+
+/**
+ * opt_cache_save - write every entry to a file
+ *
+ * Writes a temporary file beside @path and renames it over @path, so an
+ * interrupted save leaves the previous cache intact.
+ */
+int opt_cache_save(const opt_cache_t *c, const char *path, const char *tag)
+{
+	opt_cache_header_t hdr;
+	char *tmp = NULL;
+	size_t len = strlen(path) + 5;
+	FILE *fp;
+	int ok = 1;
+
+	if (strlen(tag) >= OPT_CACHE_TAG_LEN)
+	{
+		pr_warn("opt_cache_save: tag too long\n");
+		return -1;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, OPT_CACHE_MAGIC, sizeof(OPT_CACHE_MAGIC));
+	hdr.order = OPT_CACHE_ORDER;
+	hdr.dims = c->dims;
+	hdr.payload_size = c->payload_size;
+	hdr.count = c->count;
+	strcpy(hdr.tag, tag);
+
+	mem_alloc(&tmp, len);
+	snprintf(tmp, len, "%s.tmp", path);
+
+	fp = fopen(tmp, "wb");
+	if (!fp)
+	{
+		pr_warn("opt_cache_save: cannot open %s: %s\n", tmp, strerror(errno));
+		mem_free(&tmp);
+		return -1;
+	}
+
+	ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+
+	for (int e = 0; ok && e < c->count; e++)
+	{
+		ok = fwrite(&c->keys[(size_t)e * c->dims], sizeof(double),
+				(size_t)c->dims, fp) == (size_t)c->dims
+			&& fwrite(&c->values[e], sizeof(double), 1, fp) == 1
+			&& (c->payload_size == 0
+				|| fwrite(&c->payloads[(size_t)e * c->payload_size],
+					c->payload_size, 1, fp) == 1);
+	}
+
+	if (fclose(fp) != 0)
+	{
+		ok = 0;
+	}
+
+	if (!ok || rename(tmp, path) != 0)
+	{
+		pr_warn("opt_cache_save: cannot write %s: %s\n", path, strerror(errno));
+		remove(tmp);
+		mem_free(&tmp);
+		return -1;
+	}
+
+	mem_free(&tmp);
+	return 0;
+}
+
+/**
+ * opt_cache_load - merge the entries of a file saved by opt_cache_save
+ */
+int opt_cache_load(opt_cache_t *c, const char *path, const char *tag)
+{
+	opt_cache_header_t hdr;
+	unsigned char *payload = NULL;
+	gsl_vector *key;
+	FILE *fp;
+	int merged = 0;
+
+	fp = fopen(path, "rb");
+	if (!fp)
+	{
+		return 0;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1
+		|| memcmp(hdr.magic, OPT_CACHE_MAGIC, sizeof(OPT_CACHE_MAGIC)) != 0
+		|| hdr.order != OPT_CACHE_ORDER)
+	{
+		pr_warn("opt_cache_load: %s is not an optimizer cache\n", path);
+		fclose(fp);
+		return -1;
+	}
+
+	hdr.tag[OPT_CACHE_TAG_LEN - 1] = '\0';
+
+	/* Saved for another model, or by a build with another layout */
+	if (strcmp(hdr.tag, tag) != 0 || hdr.dims != c->dims
+		|| hdr.payload_size != c->payload_size || hdr.count < 0)
+	{
+		fclose(fp);
+		return 0;
+	}
+
+	key = gsl_vector_alloc(c->dims > 0 ? c->dims : 1);
+	key->size = c->dims;
+
+	if (c->payload_size > 0)
+	{
+		mem_array_alloc(&payload, c->payload_size);
+	}
+
+	for (int64_t e = 0; e < hdr.count; e++)
+	{
+		double value;
+
+		if (fread(key->data, sizeof(double), (size_t)c->dims, fp)
+				!= (size_t)c->dims
+			|| fread(&value, sizeof(double), 1, fp) != 1
+			|| (c->payload_size > 0
+				&& fread(payload, c->payload_size, 1, fp) != 1))
+		{
+			pr_warn("opt_cache_load: %s is truncated after %d entries\n",
+				path, merged);
+			merged = -1;
+			break;
+		}
+
+		opt_cache_store(c, key, value, payload);
+		merged++;
+	}
+
+	mem_array_free(&payload);
+	gsl_vector_free(key);
+	fclose(fp);
+
+	return merged;
+}
@@ -0,0 +1,118 @@
+/*
+ *  Optimizer evaluation cache.
+ *
+ *  Hash table from a position vector to the fitness it scored and an
+ *  optional fixed-size payload, such as the measurements the fitness was
+ *  computed from.  Keys are hashed on the bits of their values, each
+ *  optionally quantized to a tolerance first, and probed by open
+ *  addressing, so a lookup costs one hash of the key whatever the number
+ *  of entries.  A cache can be saved to and merged from a file tagged by
+ *  the caller, so a later run of the same model reuses it.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#ifndef OPT_CACHE_H
+#define OPT_CACHE_H 1
+
+#include <stddef.h>
+
+#include <gsl/gsl_vector.h>
+
+/** Opaque evaluation cache handle */
+typedef struct opt_cache_s opt_cache_t;
+
+/**
+ * opt_cache_new - create an empty cache
+ * @dims: key length; a key of any other length never matches
+ * @payload_size: bytes stored with each entry (0 = fitness only)
+ * @tolerance: quantization step for key values (0 = exact bits)
+ *
+ * With a tolerance, each key value is rounded to the nearest multiple
+ * of it, so positions closer than the tolerance share an entry.
+ * Returns NULL on invalid arguments.
+ */
+opt_cache_t *opt_cache_new(int dims, size_t payload_size, double tolerance);
+
+/**
+ * opt_cache_free - release a cache
+ * @c: cache (may be NULL)
+ */
+void opt_cache_free(opt_cache_t *c);
+
+/**
+ * opt_cache_clear - drop every entry, keeping the allocation
+ * @c: cache
+ */
+void opt_cache_clear(opt_cache_t *c);
+
+/**
+ * opt_cache_count - number of entries stored
+ * @c: cache (may be NULL)
+ */
+int opt_cache_count(const opt_cache_t *c);
+
+/**
+ * opt_cache_lookup - find the entry for a key
+ * @c: cache (may be NULL)
+ * @key: position vector, any stride
+ * @value: output, cached fitness (may be NULL)
+ * @payload: output, the entry's payload, valid until the next store
+ *           (may be NULL)
+ *
+ * Returns 1 on a hit, 0 on a miss.
+ */
+int opt_cache_lookup(const opt_cache_t *c, const gsl_vector *key,
+	double *value, const void **payload);
+
+/**
+ * opt_cache_store - add or replace the entry for a key
+ * @c: cache
+ * @key: position vector, any stride
+ * @value: fitness
+ * @payload: payload_size bytes to copy (NULL stores zeros)
+ *
+ * Returns 0 on success, -1 if the key length does not match.
+ */
+int opt_cache_store(opt_cache_t *c, const gsl_vector *key, double value,
+	const void *payload);
+
+/**
+ * opt_cache_same_key - compare two keys as the cache would
+ * @c: cache
+ * @a: first key
+ * @b: second key
+ *
+ * Returns 1 if @a and @b share an entry, 0 otherwise.
+ */
+int opt_cache_same_key(const opt_cache_t *c, const gsl_vector *a,
+	const gsl_vector *b);
+
+/**
+ * opt_cache_save - write every entry to a file
+ * @c: cache
+ * @path: output file, replaced atomically
+ * @tag: caller identity of the entries, e.g. a model hash (max 127 chars)
+ *
+ * Returns 0 on success, -1 on error (message via pr_warn).
+ */
+int opt_cache_save(const opt_cache_t *c, const char *path, const char *tag);
+
+/**
+ * opt_cache_load - merge the entries of a file saved by opt_cache_save
+ * @c: cache
+ * @path: input file
+ * @tag: identity the file must carry
+ *
+ * A missing file, another tag, or another key length or payload size
+ * merges nothing.  Keys are quantized to this cache's tolerance.
+ * Returns the number of entries merged, or -1 on a read error.
+ */
+int opt_cache_load(opt_cache_t *c, const char *path, const char *tag);
+
+#endif
@@ -547,6 +547,28 @@ static double reduce_values(const double *values, int n,
 
 /*------------------------------------------------------------------------*/
 
+/**
+ * objective_reads_step - test whether an objective reads a frequency step
+ * @obj: objective
+ * @mhz: the step's frequency
+ *
+ * A disabled or zero-weight objective reads no step.
+ */
+static int objective_reads_step(const fitness_objective_t *obj, double mhz)
+{
+	double mhz_lo = isnan(obj->mhz_min) ? -INFINITY : obj->mhz_min;
+	double mhz_hi = isnan(obj->mhz_max) ? INFINITY : obj->mhz_max;
+
+	if (!obj->enabled || obj->weight == 0.0)
+	{
+		return 0;
+	}
+
+	return mhz >= mhz_lo && mhz <= mhz_hi;
+}
+
+/*------------------------------------------------------------------------*/
+
 /**
  * fitness_compute_objective - evaluate one objective's weighted contribution
  */
@@ -558,8 +580,6 @@ double fitness_compute_objective(const fitness_objective_t *obj,
 	int step_count;
 	double raw;
 	double reduced;
-	double mhz_lo;
-	double mhz_hi;
 
 	if (!obj->enabled)
 	{
@@ -571,15 +591,11 @@ double fitness_compute_objective(const fitness_objective_t *obj,
 		return 0.0;
 	}
 
-	/* Determine MHz range for this objective */
-	mhz_lo = isnan(obj->mhz_min) ? -INFINITY : obj->mhz_min;
-	mhz_hi = isnan(obj->mhz_max) ? INFINITY : obj->mhz_max;
-
 	/* Collect and transform values within freq range */
 	step_count = 0;
 	for (i = 0; i < num_steps; i++)
 	{
-		if (freq_mhz[i] < mhz_lo || freq_mhz[i] > mhz_hi)
+		if (!objective_reads_step(obj, freq_mhz[i]))
 		{
 			continue;
 		}
@@ -634,3 +650,86 @@ double fitness_compute(const fitness_config_t *cfg,
 
 	return total;
 }
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * fitness_needed_steps - mark the frequency steps the objectives read
+ */
+int fitness_needed_steps(const fitness_config_t *cfg,
+	const double *freq_mhz, int num_steps, char *need)
+{
+	int count = 0;
+	int i;
+	int m;
+
+	for (i = 0; i < num_steps; i++)
+	{
+		need[i] = 0;
+
+		for (m = 0; m < cfg->num_obj; m++)
+		{
+			if (objective_reads_step(&cfg->obj[m], freq_mhz[i]))
+			{
+				need[i] = 1;
+				count++;
+				break;
+			}
+		}
+	}
+
+	return count;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * fitness_needs_pattern - test whether an objective reads a pattern field
+ */
+int fitness_needs_pattern(const fitness_config_t *cfg)
+{
+	int m;
+
+	for (m = 0; m < cfg->num_obj; m++)
+	{
+		const fitness_objective_t *obj = &cfg->obj[m];
+
+		/* meas_calc() fills the fields from MEAS_GAIN_MAX on from the
+		 * radiation pattern, the ones before from the impedance */
+		if (obj->enabled && obj->weight != 0.0
+			&& obj->meas_index >= MEAS_GAIN_MAX)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * fitness_covered - test that a sweep holds every value the objectives read
+ */
+int fitness_covered(const fitness_config_t *cfg,
+	const measurement_t *meas, int num_steps, const double *freq_mhz)
+{
+	int i;
+	int m;
+
+	for (m = 0; m < cfg->num_obj; m++)
+	{
+		const fitness_objective_t *obj = &cfg->obj[m];
+
+		for (i = 0; i < num_steps; i++)
+		{
+			if (objective_reads_step(obj, freq_mhz[i])
+				&& isnan(meas[i].a[obj->meas_index]))
+			{
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
@@ -199,6 +199,41 @@ double fitness_compute_objective(const fitness_objective_t *obj,
 double fitness_compute(const fitness_config_t *cfg,
 	const measurement_t *meas, int num_steps, const double *freq_mhz);
 
+/**
+ * fitness_needed_steps - mark the frequency steps the objectives read
+ * @cfg: fitness configuration
+ * @freq_mhz: array of frequency values in MHz, one per step
+ * @num_steps: length of freq_mhz and need
+ * @need: output, 1 for a step an enabled objective reads, 0 otherwise
+ *
+ * Returns the number of steps marked.
+ */
+int fitness_needed_steps(const fitness_config_t *cfg,
+	const double *freq_mhz, int num_steps, char *need);
+
+/**
+ * fitness_needs_pattern - test whether an objective reads a pattern field
+ * @cfg: fitness configuration
+ *
+ * Returns 1 if an enabled objective reads a gain, direction or noise
+ * temperature field, which meas_calc() derives from the radiation pattern.
+ */
+int fitness_needs_pattern(const fitness_config_t *cfg);
+
+/**
+ * fitness_covered - test that a sweep holds every value the objectives read
+ * @cfg: fitness configuration
+ * @meas: array of measurement_t, one per frequency step
+ * @num_steps: length of meas array
+ * @freq_mhz: array of frequency values in MHz, one per step
+ *
+ * A reduced sweep leaves the values it did not solve as NAN.  Returns 1
+ * when no enabled objective reads one of them, so fitness_compute() on
+ * @meas equals the fitness of a full sweep, 0 otherwise.
+ */
+int fitness_covered(const fitness_config_t *cfg,
+	const measurement_t *meas, int num_steps, const double *freq_mhz);
+
 /**
  * fitness_transform - apply direction formula to a single value
  * @direction: MINIMIZE, MAXIMIZE, or DEVIATE
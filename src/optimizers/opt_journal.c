@@ -0,0 +1,754 @@
+/*
+ *  Optimizer evaluation journal - record format and file I/O.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#include "opt_journal.h"
+#include "../console.h"
+#include "../mem/mem.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+/** File signature, followed by a byte-order word */
+#define OPT_JOURNAL_MAGIC    "XNOPTJ1"
+#define OPT_JOURNAL_ORDER    0x01020304u
+
+/** Record framing: type and payload length before, checksum after */
+#define OPT_JOURNAL_FRAME    (2 * sizeof(uint32_t))
+#define OPT_JOURNAL_TRAILER  sizeof(uint32_t)
+
+/** Fixed fields at the start of each payload */
+#define OPT_JOURNAL_EVAL_FIXED   (2 * sizeof(double) + 2 * sizeof(int32_t))
+#define OPT_JOURNAL_STATE_FIXED  (2 * sizeof(double) + 6 * sizeof(int32_t))
+#define OPT_JOURNAL_END_FIXED    sizeof(double)
+
+typedef struct
+{
+	char     magic[8];
+	uint32_t order;
+	int32_t  algorithm;
+	int32_t  seed;
+	int32_t  dims;
+	uint64_t meas_size;
+	char     tag[OPT_JOURNAL_TAG_LEN];
+} opt_journal_header_t;
+
+struct opt_journal_s
+{
+	FILE  *fp;
+	int    dims;
+	size_t meas_size;
+
+	/* Wall clock at run time zero; a resumed run moves it back by the
+	 * run time already journaled */
+	double t0;
+
+	/* Replay position: the next record to read and the one last read */
+	int    replaying;
+	off_t  next;
+	off_t  last;
+
+	/* Read and write scratch, grown on demand */
+	unsigned char *rbuf;
+	size_t rbuf_size;
+	unsigned char *wbuf;
+	size_t wbuf_size;
+};
+
+/*------------------------------------------------------------------------*/
+
+/** _now - wall clock in seconds */
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * _check - FNV-1a of a record's type, length and payload
+ */
+static uint32_t _check(uint32_t type, uint32_t len, const unsigned char *p)
+{
+	uint32_t h = 2166136261u;
+	uint32_t words[2] = { type, len };
+	const unsigned char *w = (const unsigned char *)words;
+	size_t i;
+
+	for (i = 0; i < sizeof(words); i++)
+	{
+		h = (h ^ w[i]) * 16777619u;
+	}
+
+	for (i = 0; i < len; i++)
+	{
+		h = (h ^ p[i]) * 16777619u;
+	}
+
+	return h;
+}
+
+/**
+ * _grow - make a scratch buffer hold at least @len bytes
+ */
+static unsigned char *_grow(unsigned char **buf, size_t *size, size_t len)
+{
+	if (len > *size)
+	{
+		mem_realloc(buf, len);
+		*size = len;
+	}
+
+	return *buf;
+}
+
+/**
+ * _payload_len - length a record's fixed fields say its payload has
+ * @type: record type
+ * @fixed: the fixed fields
+ * @dims: position length of the journal
+ * @meas_size: measurement bytes per step of the journal
+ *
+ * Returns 0 for an unknown type or fields out of range.
+ */
+static uint64_t _payload_len(uint32_t type, const unsigned char *fixed,
+	int dims, size_t meas_size)
+{
+	int32_t v[6];
+
+	switch (type)
+	{
+		case OPT_JOURNAL_EVAL:
+			memcpy(v, fixed + 2 * sizeof(double), sizeof(int32_t));
+			if (v[0] < 0)
+			{
+				return 0;
+			}
+			return OPT_JOURNAL_EVAL_FIXED + (uint64_t)dims * sizeof(double)
+				+ (uint64_t)v[0] * (sizeof(double) + meas_size);
+
+		case OPT_JOURNAL_STATE:
+			memcpy(v, fixed + 2 * sizeof(double), sizeof(v));
+			if (v[2] < 0 || v[3] < 0)
+			{
+				return 0;
+			}
+			return OPT_JOURNAL_STATE_FIXED
+				+ (uint64_t)v[2] * v[3] * sizeof(double) * (v[4] ? 2 : 1);
+
+		case OPT_JOURNAL_END:
+			return OPT_JOURNAL_END_FIXED;
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * _fixed_len - bytes of fixed fields of a record type, 0 if unknown
+ */
+static size_t _fixed_len(uint32_t type)
+{
+	switch (type)
+	{
+		case OPT_JOURNAL_EVAL:
+			return OPT_JOURNAL_EVAL_FIXED;
+		case OPT_JOURNAL_STATE:
+			return OPT_JOURNAL_STATE_FIXED;
+		case OPT_JOURNAL_END:
+			return OPT_JOURNAL_END_FIXED;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * _parse - fill a record from its payload
+ * @rec: output record
+ * @type: record type
+ * @p: payload, whose length _payload_len() has checked
+ * @whole: nonzero if @p holds the whole payload, not just the fixed fields
+ * @dims: position length of the journal
+ */
+static void _parse(opt_journal_rec_t *rec, uint32_t type,
+	const unsigned char *p, int whole, int dims)
+{
+	int32_t v[6];
+
+	memset(rec, 0, sizeof(*rec));
+	rec->type = type;
+	memcpy(&rec->time, p, sizeof(double));
+
+	if (type == OPT_JOURNAL_EVAL)
+	{
+		memcpy(&rec->fitness, p + sizeof(double), sizeof(double));
+		memcpy(v, p + 2 * sizeof(double), sizeof(int32_t));
+		rec->steps = v[0];
+
+		if (whole)
+		{
+			p += OPT_JOURNAL_EVAL_FIXED;
+			rec->key = (const double *)p;
+			rec->freq = rec->key + dims;
+			rec->meas = rec->freq + rec->steps;
+		}
+	}
+	else if (type == OPT_JOURNAL_STATE)
+	{
+		memcpy(&rec->best, p + sizeof(double), sizeof(double));
+		memcpy(v, p + 2 * sizeof(double), sizeof(v));
+		rec->pass = v[0];
+		rec->iter = v[1];
+		rec->rows = v[2];
+		rec->cols = v[3];
+
+		if (whole)
+		{
+			rec->pos = (const double *)(p + OPT_JOURNAL_STATE_FIXED);
+			rec->vel = v[4] ? rec->pos + (size_t)rec->rows * rec->cols : NULL;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * _read_header - read and check the header of a journal
+ * @fp: stream at offset 0
+ * @hdr: output header
+ *
+ * Returns 1 for a journal, 0 otherwise.
+ */
+static int _read_header(FILE *fp, opt_journal_header_t *hdr)
+{
+	if (fread(hdr, sizeof(*hdr), 1, fp) != 1
+		|| memcmp(hdr->magic, OPT_JOURNAL_MAGIC, sizeof(OPT_JOURNAL_MAGIC)) != 0
+		|| hdr->order != OPT_JOURNAL_ORDER || hdr->dims < 0)
+	{
+		return 0;
+	}
+
+	hdr->tag[OPT_JOURNAL_TAG_LEN - 1] = '\0';
+	return 1;
+}
+
+/**
+ * _walk - visit the fixed fields of each record after the header
+ * @fp: stream just past the header
+ * @hdr: its header
+ * @visit: visitor (may be NULL)
+ * @ctx: passed to @visit
+ * @end: output, offset past the last whole record
+ *
+ * Stops at a record that is torn, of an unknown type or whose length
+ * disagrees with its fields.  Returns the number of records visited.
+ */
+static int _walk(FILE *fp, const opt_journal_header_t *hdr,
+	opt_journal_visit_t visit, void *ctx, off_t *end)
+{
+	unsigned char fixed[OPT_JOURNAL_STATE_FIXED];
+	opt_journal_rec_t rec;
+	struct stat st;
+	off_t pos = sizeof(*hdr);
+	int count = 0;
+
+	*end = pos;
+
+	if (fstat(fileno(fp), &st) != 0)
+	{
+		return 0;
+	}
+
+	for (;;)
+	{
+		uint32_t frame[2];
+		size_t flen;
+		uint64_t len;
+
+		if (fseeko(fp, pos, SEEK_SET) != 0
+			|| fread(frame, sizeof(frame), 1, fp) != 1)
+		{
+			break;
+		}
+
+		flen = _fixed_len(frame[0]);
+		if (flen == 0 || frame[1] < flen || fread(fixed, flen, 1, fp) != 1)
+		{
+			break;
+		}
+
+		len = _payload_len(frame[0], fixed, hdr->dims, hdr->meas_size);
+		if (len != frame[1]
+			|| pos + (off_t)(OPT_JOURNAL_FRAME + len + OPT_JOURNAL_TRAILER)
+				> st.st_size)
+		{
+			break;
+		}
+
+		pos += OPT_JOURNAL_FRAME + len + OPT_JOURNAL_TRAILER;
+		*end = pos;
+		count++;
+
+		if (visit)
+		{
+			_parse(&rec, frame[0], fixed, 0, hdr->dims);
+			if (visit(&rec, ctx))
+			{
+				break;
+			}
+		}
+	}
+
+	return count;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * _truncate - drop every record from an offset on
+ */
+static void _truncate(opt_journal_t *j, off_t pos)
+{
+	fflush(j->fp);
+	if (ftruncate(fileno(j->fp), pos) != 0)
+	{
+		pr_warn("opt_journal: cannot truncate: %s\n", strerror(errno));
+	}
+
+	j->replaying = 0;
+}
+
+/**
+ * _append - write one record at the end of the file and flush it
+ * @j: journal
+ * @type: record type
+ * @len: payload length, in j->wbuf
+ */
+static int _append(opt_journal_t *j, uint32_t type, size_t len)
+{
+	uint32_t frame[2] = { type, (uint32_t)len };
+	uint32_t check = _check(type, (uint32_t)len, j->wbuf);
+
+	if (j->replaying)
+	{
+		_truncate(j, j->next);
+	}
+
+	if (fseeko(j->fp, 0, SEEK_END) != 0
+		|| fwrite(frame, sizeof(frame), 1, j->fp) != 1
+		|| fwrite(j->wbuf, len, 1, j->fp) != 1
+		|| fwrite(&check, sizeof(check), 1, j->fp) != 1
+		|| fflush(j->fp) != 0)
+	{
+		pr_warn("opt_journal: cannot write: %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+/** Facts _open_visit() gathers about a journal to resume */
+typedef struct
+{
+	double time;
+	int    ended;
+} open_scan_t;
+
+static int _open_visit(const opt_journal_rec_t *rec, void *ctx)
+{
+	open_scan_t *s = ctx;
+
+	s->time = rec->time;
+	s->ended |= rec->type == OPT_JOURNAL_END;
+
+	return 0;
+}
+
+/**
+ * opt_journal_open - resume or start the journal of a run
+ */
+opt_journal_t *opt_journal_open(const char *path, opt_journal_info_t *info)
+{
+	opt_journal_header_t hdr;
+	opt_journal_t *j = NULL;
+	open_scan_t scan = { 0.0, 0 };
+	double now = _now();
+	off_t end;
+	FILE *fp;
+
+	if (strlen(info->tag) >= OPT_JOURNAL_TAG_LEN || info->dims < 0)
+	{
+		pr_warn("opt_journal_open: bad identity\n");
+		return NULL;
+	}
+
+	fp = fopen(path, "r+b");
+	if (fp && _read_header(fp, &hdr)
+		&& strcmp(hdr.tag, info->tag) == 0
+		&& hdr.algorithm == info->algorithm
+		&& hdr.dims == info->dims
+		&& hdr.meas_size == info->meas_size)
+	{
+		int count = _walk(fp, &hdr, _open_visit, &scan, &end);
+
+		if (!scan.ended)
+		{
+			mem_new(&j);
+			j->fp = fp;
+			j->dims = info->dims;
+			j->meas_size = info->meas_size;
+			j->t0 = now - scan.time;
+			j->next = sizeof(hdr);
+			j->last = j->next;
+
+			/* A torn record from a crash mid-write */
+			_truncate(j, end);
+			j->replaying = count > 0;
+
+			info->seed = hdr.seed;
+
+			pr_notice("opt_journal: resuming %s, %d records, seed %d\n",
+				path, count, hdr.seed);
+
+			return j;
+		}
+	}
+
+	if (fp)
+	{
+		fclose(fp);
+	}
+
+	fp = fopen(path, "w+b");
+	if (!fp)
+	{
+		pr_warn("opt_journal_open: cannot open %s: %s\n", path, strerror(errno));
+		return NULL;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, OPT_JOURNAL_MAGIC, sizeof(OPT_JOURNAL_MAGIC));
+	hdr.order = OPT_JOURNAL_ORDER;
+	hdr.algorithm = info->algorithm;
+	hdr.seed = info->seed;
+	hdr.dims = info->dims;
+	hdr.meas_size = info->meas_size;
+	strcpy(hdr.tag, info->tag);
+
+	if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1 || fflush(fp) != 0)
+	{
+		pr_warn("opt_journal_open: cannot write %s: %s\n", path, strerror(errno));
+		fclose(fp);
+		return NULL;
+	}
+
+	mem_new(&j);
+	j->fp = fp;
+	j->dims = info->dims;
+	j->meas_size = info->meas_size;
+	j->t0 = now;
+	j->next = sizeof(hdr);
+	j->last = j->next;
+
+	return j;
+}
+
+/**
+ * opt_journal_close - flush and release a journal
+ */
+void opt_journal_close(opt_journal_t *j)
+{
+	if (!j)
+	{
+		return;
+	}
+
+	if (fclose(j->fp) != 0)
+	{
+		pr_warn("opt_journal_close: %s\n", strerror(errno));
+	}
+
+	mem_free(&j->rbuf);
+	mem_free(&j->wbuf);
+	mem_free(&j);
+}
+
+/**
+ * opt_journal_replaying - whether records remain to replay
+ */
+int opt_journal_replaying(const opt_journal_t *j)
+{
+	return j && j->replaying;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_next - read the next record to replay
+ */
+int opt_journal_next(opt_journal_t *j, opt_journal_rec_t *rec)
+{
+	uint32_t frame[2];
+	uint32_t check;
+	unsigned char *p;
+
+	if (!j->replaying)
+	{
+		return 0;
+	}
+
+	if (fseeko(j->fp, j->next, SEEK_SET) != 0
+		|| fread(frame, sizeof(frame), 1, j->fp) != 1)
+	{
+		j->replaying = 0;
+		return 0;
+	}
+
+	/* The walk at open checked the lengths; the checksum covers the rest */
+	p = _grow(&j->rbuf, &j->rbuf_size, frame[1]);
+
+	if (fread(p, frame[1], 1, j->fp) != 1
+		|| fread(&check, sizeof(check), 1, j->fp) != 1
+		|| check != _check(frame[0], frame[1], p))
+	{
+		pr_warn("opt_journal: damaged record, replay ends here\n");
+		_truncate(j, j->next);
+		return 0;
+	}
+
+	_parse(rec, frame[0], p, 1, j->dims);
+
+	j->last = j->next;
+	j->next += OPT_JOURNAL_FRAME + frame[1] + OPT_JOURNAL_TRAILER;
+
+	return 1;
+}
+
+/**
+ * opt_journal_diverge - end the replay at the record last read
+ */
+void opt_journal_diverge(opt_journal_t *j)
+{
+	if (j->replaying)
+	{
+		_truncate(j, j->last);
+		j->next = j->last;
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_append_eval - add an evaluation
+ */
+int opt_journal_append_eval(opt_journal_t *j, const gsl_vector *key,
+	double fitness, const double *freq, const void *meas, int steps)
+{
+	size_t len = OPT_JOURNAL_EVAL_FIXED + j->dims * sizeof(double)
+		+ (size_t)steps * (sizeof(double) + j->meas_size);
+	double t = _now() - j->t0;
+	int32_t v[2] = { steps, 0 };
+	unsigned char *p;
+
+	if ((int)key->size != j->dims || steps < 0)
+	{
+		return -1;
+	}
+
+	p = _grow(&j->wbuf, &j->wbuf_size, len);
+
+	memcpy(p, &t, sizeof(double));
+	memcpy(p + sizeof(double), &fitness, sizeof(double));
+	memcpy(p + 2 * sizeof(double), v, sizeof(v));
+	p += OPT_JOURNAL_EVAL_FIXED;
+
+	for (int i = 0; i < j->dims; i++)
+	{
+		double k = gsl_vector_get(key, i);
+
+		memcpy(p, &k, sizeof(double));
+		p += sizeof(double);
+	}
+
+	memcpy(p, freq, steps * sizeof(double));
+	memcpy(p + steps * sizeof(double), meas, steps * j->meas_size);
+
+	return _append(j, OPT_JOURNAL_EVAL, len);
+}
+
+/**
+ * opt_journal_append_state - add a backend snapshot
+ */
+int opt_journal_append_state(opt_journal_t *j, int pass, int iter,
+	double best, const gsl_matrix *pos, const gsl_matrix *vel)
+{
+	int rows = pos ? (int)pos->size1 : 0;
+	int cols = pos ? (int)pos->size2 : 0;
+	int has_vel = vel && (int)vel->size1 == rows && (int)vel->size2 == cols;
+	size_t cells = (size_t)rows * cols;
+	size_t len = OPT_JOURNAL_STATE_FIXED
+		+ cells * sizeof(double) * (has_vel ? 2 : 1);
+	double t = _now() - j->t0;
+	int32_t v[6] = { pass, iter, rows, cols, has_vel, 0 };
+	unsigned char *p;
+
+	p = _grow(&j->wbuf, &j->wbuf_size, len);
+
+	memcpy(p, &t, sizeof(double));
+	memcpy(p + sizeof(double), &best, sizeof(double));
+	memcpy(p + 2 * sizeof(double), v, sizeof(v));
+	p += OPT_JOURNAL_STATE_FIXED;
+
+	/* Row by row: a matrix view may have tda > size2 */
+	for (int r = 0; r < rows; r++)
+	{
+		memcpy(p, gsl_matrix_const_ptr(pos, r, 0), cols * sizeof(double));
+		p += cols * sizeof(double);
+	}
+
+	for (int r = 0; has_vel && r < rows; r++)
+	{
+		memcpy(p, gsl_matrix_const_ptr(vel, r, 0), cols * sizeof(double));
+		p += cols * sizeof(double);
+	}
+
+	return _append(j, OPT_JOURNAL_STATE, len);
+}
+
+/**
+ * opt_journal_append_end - mark the run completed
+ */
+int opt_journal_append_end(opt_journal_t *j)
+{
+	double t = _now() - j->t0;
+
+	memcpy(_grow(&j->wbuf, &j->wbuf_size, sizeof(double)), &t, sizeof(double));
+
+	return _append(j, OPT_JOURNAL_END, OPT_JOURNAL_END_FIXED);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_scan - walk the records of a journal without replaying it
+ */
+int opt_journal_scan(const char *path, opt_journal_visit_t visit, void *ctx)
+{
+	opt_journal_header_t hdr;
+	off_t end;
+	FILE *fp;
+	int count;
+
+	fp = fopen(path, "rb");
+	if (!fp)
+	{
+		return -1;
+	}
+
+	if (!_read_header(fp, &hdr))
+	{
+		fclose(fp);
+		return -1;
+	}
+
+	count = _walk(fp, &hdr, visit, ctx, &end);
+	fclose(fp);
+
+	return count;
+}
+
+/** Running state of opt_journal_write_convergence() */
+typedef struct
+{
+	FILE  *out;
+	int    evals;
+	double best;
+} convergence_t;
+
+static int _convergence_eval(const opt_journal_rec_t *rec, void *ctx)
+{
+	convergence_t *c = ctx;
+
+	if (rec->type == OPT_JOURNAL_EVAL)
+	{
+		c->evals++;
+		if (rec->fitness < c->best)
+		{
+			c->best = rec->fitness;
+		}
+
+		fprintf(c->out, "%d %.6f %.9g %.9g\n",
+			c->evals, rec->time, rec->fitness, c->best);
+	}
+
+	return 0;
+}
+
+static int _convergence_state(const opt_journal_rec_t *rec, void *ctx)
+{
+	convergence_t *c = ctx;
+
+	if (rec->type == OPT_JOURNAL_STATE)
+	{
+		fprintf(c->out, "%d %.6f %d %.9g\n",
+			rec->iter, rec->time, rec->pass, rec->best);
+	}
+	else if (rec->type == OPT_JOURNAL_END)
+	{
+		fprintf(c->out, "# completed at %.6f s\n", rec->time);
+	}
+
+	return 0;
+}
+
+/**
+ * opt_journal_write_convergence - print the fitness history of a journal
+ */
+int opt_journal_write_convergence(const char *path, FILE *out)
+{
+	opt_journal_header_t hdr;
+	convergence_t c = { out, 0, INFINITY };
+	FILE *fp;
+
+	fp = fopen(path, "rb");
+	if (!fp)
+	{
+		pr_warn("opt_journal: cannot open %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	if (!_read_header(fp, &hdr))
+	{
+		pr_warn("opt_journal: %s is not an optimizer journal\n", path);
+		fclose(fp);
+		return -1;
+	}
+	fclose(fp);
+
+	fprintf(out, "# %s: algorithm %d, seed %d, %d dimensions\n",
+		path, hdr.algorithm, hdr.seed, hdr.dims);
+	fprintf(out, "# model %s\n", hdr.tag);
+	fprintf(out, "# eval seconds fitness best\n");
+	opt_journal_scan(path, _convergence_eval, &c);
+
+	fprintf(out, "\n\n# evals seconds pass best\n");
+	opt_journal_scan(path, _convergence_state, &c);
+
+	return 0;
+}
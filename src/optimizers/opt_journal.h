@@ -0,0 +1,194 @@
+/*
+ *  Optimizer evaluation journal.
+ *
+ *  Append-only file of every evaluation of a run, in the order the
+ *  optimizer asked for them: the position, the per-step measurements it
+ *  was scored from, its fitness and the run time.  Between evaluations,
+ *  each log call adds a snapshot of the backend state (simplex vertices,
+ *  particle positions and velocities, or the CMA-ES generation).  Records
+ *  are checksummed and flushed as they are written, so a crash loses at
+ *  most the record being written.
+ *
+ *  A run that stopped before its end record resumes exactly: with the
+ *  journaled seed the optimizer asks for the same positions again, and
+ *  the journal answers them from its records until it runs out or the
+ *  run departs from it.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#ifndef OPT_JOURNAL_H
+#define OPT_JOURNAL_H 1
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+/** Longest identity a journal carries, with its terminator */
+#define OPT_JOURNAL_TAG_LEN 128
+
+/** Record types */
+enum opt_journal_type
+{
+	OPT_JOURNAL_EVAL = 1,      /**< One evaluation */
+	OPT_JOURNAL_STATE,         /**< Backend snapshot at a log call */
+	OPT_JOURNAL_END            /**< The run completed */
+};
+
+/** Opaque journal handle */
+typedef struct opt_journal_s opt_journal_t;
+
+/**
+ * Identity of a run.  A journal resumes only a run of the same identity.
+ */
+typedef struct
+{
+	const char *tag;           /**< Caller identity, e.g. a model hash */
+	int    algorithm;          /**< Optimizer backend */
+	int    seed;               /**< Random seed; replaced by the journal's on resume */
+	int    dims;               /**< Position length */
+	size_t meas_size;          /**< Bytes of measurements per step */
+} opt_journal_info_t;
+
+/**
+ * One record.  Pointers refer to the journal's read buffer and are valid
+ * until the next read; opt_journal_scan() leaves them NULL.
+ */
+typedef struct
+{
+	int    type;               /**< enum opt_journal_type */
+	double time;               /**< Run time in seconds, resumes included */
+
+	/* OPT_JOURNAL_EVAL */
+	double fitness;            /**< Fitness the run scored */
+	int    steps;              /**< Frequency steps measured */
+	const double *key;         /**< Position [dims] */
+	const double *freq;        /**< Frequencies [steps] */
+	const void   *meas;        /**< Measurements [steps * meas_size bytes] */
+
+	/* OPT_JOURNAL_STATE */
+	double best;               /**< Best fitness so far */
+	int    pass;               /**< Optimization pass */
+	int    iter;               /**< Evaluations so far */
+	int    rows;               /**< Population rows (position length) */
+	int    cols;               /**< Population columns (points) */
+	const double *pos;         /**< Population, row-major [rows * cols] */
+	const double *vel;         /**< Velocities, same layout (NULL = none) */
+} opt_journal_rec_t;
+
+/** Visitor for opt_journal_scan(); return nonzero to stop */
+typedef int (*opt_journal_visit_t)(const opt_journal_rec_t *rec, void *ctx);
+
+/**
+ * opt_journal_open - resume or start the journal of a run
+ * @path: journal file
+ * @info: identity of the run; info->seed is replaced when resuming
+ *
+ * A journal of the same identity without an end record is resumed: the
+ * handle replays its records through opt_journal_next(), and a torn last
+ * record is dropped.  Any other file is replaced by an empty journal.
+ * Returns NULL on error (message via pr_warn).
+ */
+opt_journal_t *opt_journal_open(const char *path, opt_journal_info_t *info);
+
+/**
+ * opt_journal_close - flush and release a journal
+ * @j: journal (may be NULL)
+ */
+void opt_journal_close(opt_journal_t *j);
+
+/**
+ * opt_journal_replaying - whether records remain to replay
+ * @j: journal (may be NULL)
+ */
+int opt_journal_replaying(const opt_journal_t *j);
+
+/**
+ * opt_journal_next - read the next record to replay
+ * @j: journal
+ * @rec: output record
+ *
+ * Returns 1 with @rec filled, or 0 when the replay has ended, at the end
+ * of the file or at a record that fails its checksum, which is dropped.
+ */
+int opt_journal_next(opt_journal_t *j, opt_journal_rec_t *rec);
+
+/**
+ * opt_journal_diverge - end the replay at the record last read
+ * @j: journal
+ *
+ * For a run that departed from its journal: drops the record last read
+ * and all after it, so the run continues the file from there.
+ */
+void opt_journal_diverge(opt_journal_t *j);
+
+/**
+ * opt_journal_append_eval - add an evaluation
+ * @j: journal
+ * @key: position, dims values, any stride
+ * @fitness: its fitness
+ * @freq: frequencies [steps]
+ * @meas: measurements [steps * meas_size bytes]
+ * @steps: frequency steps
+ *
+ * Appending ends a replay that is still going and drops the records not
+ * yet read.  Returns 0 on success, -1 on error.
+ */
+int opt_journal_append_eval(opt_journal_t *j, const gsl_vector *key,
+	double fitness, const double *freq, const void *meas, int steps);
+
+/**
+ * opt_journal_append_state - add a backend snapshot
+ * @j: journal
+ * @pass: optimization pass
+ * @iter: evaluations so far
+ * @best: best fitness so far
+ * @pos: population, one point per column (NULL = none)
+ * @vel: velocities, same shape as @pos (NULL = none)
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int opt_journal_append_state(opt_journal_t *j, int pass, int iter,
+	double best, const gsl_matrix *pos, const gsl_matrix *vel);
+
+/**
+ * opt_journal_append_end - mark the run completed
+ * @j: journal
+ *
+ * The next opt_journal_open() of the file starts over.
+ * Returns 0 on success, -1 on error.
+ */
+int opt_journal_append_end(opt_journal_t *j);
+
+/**
+ * opt_journal_scan - walk the records of a journal without replaying it
+ * @path: journal file
+ * @visit: called with each record, payload pointers NULL
+ * @ctx: passed to @visit
+ *
+ * Reads the fixed fields of each record and seeks past the rest, so a
+ * journal of any size is walked in a moment.  Stops at a torn record.
+ * Returns the number of records visited, or -1 if @path is not a journal.
+ */
+int opt_journal_scan(const char *path, opt_journal_visit_t visit, void *ctx);
+
+/**
+ * opt_journal_write_convergence - print the fitness history of a journal
+ * @path: journal file
+ * @out: output stream
+ *
+ * Writes gnuplot data: index 0 holds a row per evaluation of its number,
+ * run time, fitness and best fitness so far; index 1 a row per snapshot
+ * of the evaluations so far, run time, pass and best fitness.
+ * Returns 0 on success, -1 if @path is not a journal.
+ */
+int opt_journal_write_convergence(const char *path, FILE *out);
+
+#endif
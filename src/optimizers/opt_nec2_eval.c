@@ -14,6 +14,7 @@
 #include "opt_nec2_eval.h"
 #include "../shared.h"
 #include "../sy_expr.h"
+#include "../touchstone.h"
 #include "../console.h"
 #include "../utils.h"
 
@@ -22,6 +23,17 @@ static GMutex eval_mutex;
 static GCond eval_cond;
 static gboolean eval_initialized = FALSE;
 
+/* Deck text the headless path reparses, read once per session; a failed
+ * read leaves every evaluation of the session on the reload path */
+static gchar *eval_deck = NULL;
+static gsize eval_deck_len = 0;
+static gboolean eval_deck_failed = FALSE;
+
+/* Work the headless evaluations are limited to; see nec2_eval_set_scope() */
+static char *eval_need = NULL;
+static int eval_need_len = 0;
+static int eval_skip = 0;
+
 /* Context passed to the GTK callback for override-and-reload */
 typedef struct
 {
@@ -58,6 +70,13 @@ void nec2_eval_cleanup(void)
 		return;
 	}
 
+	g_free(eval_deck);
+	eval_deck = NULL;
+	eval_deck_len = 0;
+	eval_deck_failed = FALSE;
+
+	nec2_eval_set_scope(NULL, 0, 0);
+
 	g_cond_clear(&eval_cond);
 	g_mutex_clear(&eval_mutex);
 	eval_initialized = FALSE;
@@ -268,3 +287,520 @@ int nec2_eval_get_freq(double *freq_out, int max_steps)
 
 	return count;
 }
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * eval_stop_sweep - GTK callback: retire a driver-owned sweep
+ * @user_data: unused
+ */
+static void eval_stop_sweep(gpointer user_data)
+{
+	(void)user_data;
+
+	Stop_Frequency_Loop();
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * eval_publish_best - GTK callback: draw the evaluation just collected
+ * @user_data: unused
+ */
+static void eval_publish_best(gpointer user_data)
+{
+	(void)user_data;
+
+	freq_loop_publish_best();
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * eval_deck_ready - snapshot the deck text for the headless path
+ *
+ * Batch mode takes the headless path too: a sweep run under HEADLESS_EVAL
+ * does not schedule the batch capture and quit.
+ *
+ * Returns TRUE when the deck text is held.
+ */
+static gboolean eval_deck_ready(void)
+{
+	GError *err = NULL;
+
+	if (eval_deck != NULL)
+	{
+		return TRUE;
+	}
+
+	if (eval_deck_failed)
+	{
+		return FALSE;
+	}
+
+	if (!g_file_get_contents(rc_config.input_file, &eval_deck,
+		&eval_deck_len, &err))
+	{
+		pr_warn("nec2_eval: cannot read %s, evaluating by reload: %s\n",
+			rc_config.input_file, err->message);
+		g_error_free(err);
+		eval_deck_failed = TRUE;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * nec2_eval_set_scope - limit the headless evaluations to the work needed
+ */
+void nec2_eval_set_scope(const char *need, int num_steps, int skip)
+{
+	g_free(eval_need);
+	eval_need = NULL;
+	eval_need_len = 0;
+	eval_skip = skip;
+
+	if (need != NULL && num_steps > 0)
+	{
+		eval_need = g_malloc(num_steps);
+		memcpy(eval_need, need, num_steps);
+		eval_need_len = num_steps;
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * eval_scope_need - step flags of the scope for the model held now
+ *
+ * A deck whose step count moved away from the scope's is swept whole.
+ *
+ * Returns the flags, or NULL when every step is needed.
+ */
+static const char *eval_scope_need(void)
+{
+	if (eval_need == NULL || eval_need_len != calc_data.steps_total)
+	{
+		return NULL;
+	}
+
+	return eval_need;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * eval_mark_unsolved - set what a reduced sweep left out of a step to NAN
+ * @m: the step's measurements
+ * @step: sweep step index
+ * @need: step flags the sweep ran under (NULL = all)
+ * @skip: SOLVE_SKIP_* parts the sweep ran under
+ *
+ * NAN rather than meas_calc()'s -1, which the fitness reads as a value
+ * that cannot be computed and skips; see fitness_covered().
+ */
+static void eval_mark_unsolved(measurement_t *m, int step,
+	const char *need, int skip)
+{
+	int i;
+
+	if (need != NULL && !need[step])
+	{
+		for (i = 0; i < MEAS_COUNT; i++)
+		{
+			m->a[i] = NAN;
+		}
+		m->mhz = save.freq[step];
+		return;
+	}
+
+	/* meas_calc() computes the fields from MEAS_GAIN_MAX on from the
+	 * pattern alone */
+	if (skip & SOLVE_SKIP_RDPAT)
+	{
+		for (i = MEAS_GAIN_MAX; i < MEAS_COUNT; i++)
+		{
+			m->a[i] = NAN;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * eval_direct - evaluate in process under a given scope
+ * @vars: simple_var_t array with current optimizer values
+ * @num_vars: length of vars array
+ * @meas_out: output array, max_steps entries
+ * @max_steps: capacity of meas_out array
+ * @scoped: TRUE to honor nec2_eval_set_scope()
+ */
+static int eval_direct(const simple_var_t *vars, int num_vars,
+	measurement_t *meas_out, int max_steps, gboolean scoped)
+{
+	const char *need = NULL;
+	int skip = 0;
+	gchar *sy_text;
+	gboolean ok;
+	int count = 0;
+	int i;
+
+	if (!eval_initialized)
+	{
+		pr_err("nec2_eval_direct: not initialized\n");
+		return -1;
+	}
+
+	if (!eval_deck_ready())
+	{
+		return nec2_eval_run(vars, num_vars, meas_out, max_steps);
+	}
+
+	/* HEADLESS_EVAL refuses driver sweep starts from here on; a green-line
+	 * sweep the operator started since the last candidate is retired on
+	 * the GTK thread, the one place Stop_Frequency_Loop may flush events */
+	SetFlag( SY_OPTIMIZER_ACTIVE | HEADLESS_EVAL );
+
+	if (freq_sweep_active())
+	{
+		g_idle_add_once_sync(eval_stop_sweep, NULL);
+	}
+
+	/* The overrides ride into the reparse as .sy text in place of the
+	 * companion file, which stays untouched until the final reload */
+	g_rec_mutex_lock(&freq_data_lock);
+	apply_vars_as_overrides(vars, num_vars);
+	sy_text = sy_overrides_text();
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	ok = Reparse_Input_Deck(eval_deck, eval_deck_len, sy_text);
+	g_free(sy_text);
+
+	/* The reparse settled the step count the scope is checked against */
+	if (scoped)
+	{
+		need = eval_scope_need();
+		skip = eval_skip;
+	}
+
+	if (ok && freq_loop_run_reduced(need, skip))
+	{
+		g_rec_mutex_lock(&freq_data_lock);
+
+		count = (calc_data.steps_total < max_steps)
+			? calc_data.steps_total : max_steps;
+
+		for (i = 0; i < count; i++)
+		{
+			if (need == NULL || need[i])
+			{
+				meas_calc(&meas_out[i], i, calc_data.ex_port);
+			}
+			eval_mark_unsolved(&meas_out[i], i, need, skip);
+		}
+
+		g_rec_mutex_unlock(&freq_data_lock);
+	}
+
+	ClearFlag( SY_OPTIMIZER_ACTIVE | HEADLESS_EVAL );
+
+	return ok ? count : -1;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * nec2_eval_direct - evaluate antenna in process, without a GTK reload
+ */
+int nec2_eval_direct(const simple_var_t *vars, int num_vars,
+	measurement_t *meas_out, int max_steps)
+{
+	return eval_direct(vars, num_vars, meas_out, max_steps, TRUE);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * nec2_eval_direct_full - evaluate in process, every step in whole
+ */
+int nec2_eval_direct_full(const simple_var_t *vars, int num_vars,
+	measurement_t *meas_out, int max_steps)
+{
+	return eval_direct(vars, num_vars, meas_out, max_steps, FALSE);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * nec2_eval_publish - show the last evaluation in the UI
+ */
+void nec2_eval_publish(void)
+{
+	if (eval_deck == NULL)
+	{
+		return;
+	}
+
+	g_idle_add_once_sync(eval_publish_best, NULL);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * nec2_eval_batch - evaluate several variable sets, one per worker
+ */
+int nec2_eval_batch(simple_var_t *const *vars, int num_sets, int num_vars,
+	measurement_t *meas_out, int max_steps, char *failed)
+{
+	gchar **sy_texts = NULL;
+	gchar *sy_restore;
+	const char *need;
+	int count = -1;
+	int i;
+	int k;
+
+	if (!eval_initialized)
+	{
+		pr_err("nec2_eval_batch: not initialized\n");
+		return -1;
+	}
+
+	/* One candidate, or one process, gains nothing from the fan-out */
+	if (num_sets < 2 || !FORKED || !eval_deck_ready())
+	{
+		for (k = 0; k < num_sets; k++)
+		{
+			int steps = nec2_eval_direct(vars[k], num_vars,
+				&meas_out[k * max_steps], max_steps);
+
+			if (failed != NULL)
+			{
+				failed[k] = (steps < 0);
+			}
+
+			if (steps >= 0)
+			{
+				count = steps;
+			}
+			else if (failed == NULL)
+			{
+				return -1;
+			}
+		}
+
+		return count;
+	}
+
+	SetFlag( SY_OPTIMIZER_ACTIVE | HEADLESS_EVAL );
+
+	if (freq_sweep_active())
+	{
+		g_idle_add_once_sync(eval_stop_sweep, NULL);
+	}
+
+	/* The last nec2_eval_direct() parsed the deck under the overrides
+	 * standing now; serializing each candidate moves them along */
+	g_rec_mutex_lock(&freq_data_lock);
+	sy_restore = sy_overrides_text();
+
+	sy_texts = g_new0(gchar *, num_sets + 1);
+	for (k = 0; k < num_sets; k++)
+	{
+		apply_vars_as_overrides(vars[k], num_vars);
+		sy_texts[k] = sy_overrides_text();
+	}
+
+	/* The children are handed back sy_restore; keep this process's table
+	 * on it too rather than on the last candidate */
+	sy_load_overrides_text(sy_restore);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	need = eval_scope_need();
+	count = freq_loop_measure_batch(eval_deck, eval_deck_len,
+		sy_texts, num_sets, sy_restore, need, eval_skip,
+		meas_out, max_steps, failed);
+
+	for (k = 0; k < num_sets && count > 0; k++)
+	{
+		if (failed != NULL && failed[k])
+		{
+			continue;
+		}
+
+		for (i = 0; i < count; i++)
+		{
+			eval_mark_unsolved(&meas_out[k * max_steps + i], i,
+				need, eval_skip);
+		}
+	}
+
+	g_strfreev(sy_texts);
+	g_free(sy_restore);
+
+	ClearFlag( SY_OPTIMIZER_ACTIVE | HEADLESS_EVAL );
+
+	return count;
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Symbols collected for the fingerprint by eval_fingerprint_symbol */
+typedef struct
+{
+	const simple_var_t *vars;
+	int num_vars;
+	GPtrArray *lines;
+} eval_fingerprint_ctx_t;
+
+/**
+ * eval_is_var_symbol - test whether a symbol is set from an optimizer var
+ * @name: symbol name
+ * @vars: optimizer variables
+ * @num_vars: length of vars
+ *
+ * Multi-element vars set name_0, name_1, ...; see apply_vars_as_overrides.
+ */
+static gboolean eval_is_var_symbol(const gchar *name,
+	const simple_var_t *vars, int num_vars)
+{
+	int i;
+
+	for (i = 0; i < num_vars; i++)
+	{
+		size_t len = strlen(vars[i].name);
+		const gchar *index = name + len;
+
+		/* The symbol table holds names upper-cased */
+		if (g_ascii_strncasecmp(name, vars[i].name, len) != 0)
+		{
+			continue;
+		}
+
+		if (*index == '\0')
+		{
+			return TRUE;
+		}
+
+		if (index[0] == '_' && index[1] != '\0'
+			&& strspn(index + 1, "0123456789") == strlen(index + 1))
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ * eval_fingerprint_symbol - sy_foreach callback: collect one fixed symbol
+ */
+static void eval_fingerprint_symbol(const gchar *name, gdouble value,
+	gboolean is_calculated, const gchar *expression,
+	gdouble min_value, gdouble max_value,
+	gdouble override_value, gboolean override_active,
+	gboolean opt_active, gpointer user_data)
+{
+	eval_fingerprint_ctx_t *ctx = user_data;
+
+	(void)expression;
+	(void)min_value;
+	(void)max_value;
+	(void)override_value;
+	(void)override_active;
+	(void)opt_active;
+
+	/* Calculated symbols follow from the deck and the other symbols */
+	if (is_calculated || eval_is_var_symbol(name, ctx->vars, ctx->num_vars))
+	{
+		return;
+	}
+
+	g_ptr_array_add(ctx->lines, g_strdup_printf("%s=%.17g\n", name, value));
+}
+
+/**
+ * eval_compare_lines - g_ptr_array_sort comparator for strings
+ */
+static gint eval_compare_lines(gconstpointer a, gconstpointer b)
+{
+	return strcmp(*(const gchar *const *)a, *(const gchar *const *)b);
+}
+
+/**
+ * nec2_eval_fingerprint - identify what an evaluation depends on besides vars
+ */
+gchar *nec2_eval_fingerprint(const simple_var_t *vars, int num_vars)
+{
+	eval_fingerprint_ctx_t ctx;
+	GChecksum *sum;
+	GError *err = NULL;
+	gchar *deck = NULL;
+	gsize deck_len = 0;
+	gchar *network;
+	gchar *text;
+	guint i;
+
+	if (!g_file_get_contents(rc_config.input_file, &deck, &deck_len, &err))
+	{
+		pr_warn("nec2_eval: cannot read %s: %s\n",
+			rc_config.input_file, err->message);
+		g_error_free(err);
+		return NULL;
+	}
+
+	sum = g_checksum_new(G_CHECKSUM_SHA256);
+	g_checksum_update(sum, (const guchar *)deck, deck_len);
+	g_free(deck);
+
+	ctx.vars = vars;
+	ctx.num_vars = num_vars;
+	ctx.lines = g_ptr_array_new_with_free_func(g_free);
+
+	/* Settings meas_calc() reads besides the solution, the network it
+	 * moves the feedpoint through, and the record layout, so a rebuilt
+	 * measurement_t never reads stale bytes */
+	g_rec_mutex_lock(&freq_data_lock);
+	network = touchstone_network_digest();
+	g_ptr_array_add(ctx.lines, g_strdup_printf(
+		"\x01zo=%.17g pol=%d port=%d gain=%d sky=%d earth=%d interp=%d "
+		"elev=%.17g tsky=%.17g tearth=%.17g net=%s deembed=%d size=%zu\n",
+		calc_data.zo, calc_data.pol_type, calc_data.ex_port,
+		rc_config.gain_style, rc_config.ant_temp_sky,
+		rc_config.ant_temp_earth, rc_config.ant_temp_interp,
+		rc_config.ant_temp_elevation, rc_config.ant_temp_custom_t_sky,
+		rc_config.ant_temp_custom_t_earth, network ? network : "none",
+		network ? rc_config.network_deembed : 0, sizeof(measurement_t)));
+	g_free(network);
+
+	for (i = 0; i < (guint)num_vars; i++)
+	{
+		gchar *upper = g_ascii_strup(vars[i].name, -1);
+
+		g_ptr_array_add(ctx.lines, g_strdup_printf("\x02%s[%zu]\n",
+			upper, vars[i].values->size));
+		g_free(upper);
+	}
+
+	sy_foreach(eval_fingerprint_symbol, &ctx);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	/* sy_foreach walks a hash table, and the vars may arrive in any order */
+	g_ptr_array_sort(ctx.lines, eval_compare_lines);
+
+	for (i = 0; i < ctx.lines->len; i++)
+	{
+		const gchar *line = g_ptr_array_index(ctx.lines, i);
+
+		g_checksum_update(sum, (const guchar *)line, strlen(line));
+	}
+
+	text = g_strdup(g_checksum_get_string(sum));
+
+	g_ptr_array_free(ctx.lines, TRUE);
+	g_checksum_free(sum);
+
+	return text;
+}
@@ -57,6 +57,89 @@ void nec2_eval_signal(void);
 int nec2_eval_run(const simple_var_t *vars, int num_vars,
 	measurement_t *meas_out, int max_steps);
 
+/**
+ * nec2_eval_direct - evaluate antenna in process, without a GTK reload
+ * @vars: simple_var_t array with current optimizer values
+ * @num_vars: length of vars array
+ * @meas_out: output array, caller-allocated, sized for calc_data.steps_total
+ * @max_steps: capacity of meas_out array
+ *
+ * Applies SY overrides from vars to the symbol table, reparses the deck
+ * from a copy held in memory with the overrides as in-memory .sy text,
+ * and runs the sweep on the calling thread.  Nothing is written to disk,
+ * the GTK main loop is not entered and the UI is not updated; see
+ * nec2_eval_publish().  Falls back to nec2_eval_run() when the deck cannot
+ * be held.  Only the work nec2_eval_set_scope() names is done; what it
+ * leaves out reads as NAN in meas_out.
+ *
+ * Returns the number of frequency steps evaluated, or -1 on error.
+ */
+int nec2_eval_direct(const simple_var_t *vars, int num_vars,
+	measurement_t *meas_out, int max_steps);
+
+/**
+ * nec2_eval_direct_full - evaluate in process, every step in whole
+ * @vars: simple_var_t array with current optimizer values
+ * @num_vars: length of vars array
+ * @meas_out: output array, caller-allocated, sized for calc_data.steps_total
+ * @max_steps: capacity of meas_out array
+ *
+ * As nec2_eval_direct(), outside the scope, for a candidate about to be
+ * published.
+ *
+ * Returns the number of frequency steps evaluated, or -1 on error.
+ */
+int nec2_eval_direct_full(const simple_var_t *vars, int num_vars,
+	measurement_t *meas_out, int max_steps);
+
+/**
+ * nec2_eval_set_scope - limit the headless evaluations to the work needed
+ * @need: per-step flags, copied; NULL evaluates every step
+ * @num_steps: length of @need; a model of another step count ignores it
+ * @skip: SOLVE_SKIP_* parts of each step to leave out
+ *
+ * Applies to nec2_eval_direct() and nec2_eval_batch() until replaced or
+ * nec2_eval_cleanup().  The steps are matched by index, so the scope
+ * assumes the frequency cards do not move with the optimized symbols.
+ */
+void nec2_eval_set_scope(const char *need, int num_steps, int skip);
+
+/**
+ * nec2_eval_batch - evaluate several variable sets, one per worker
+ * @vars: num_sets simple_var_t arrays, one per candidate
+ * @num_sets: number of candidates
+ * @num_vars: length of each vars array
+ * @meas_out: output, caller-allocated, num_sets rows of max_steps
+ * @max_steps: row width of meas_out
+ * @failed: output, num_sets flags set for the candidates that failed to
+ *          parse or lost their worker; NULL fails the call on any of them
+ *
+ * Serializes each candidate's overrides as .sy text and hands the whole
+ * set to the forked workers, each of which parses the held deck under one
+ * candidate and sweeps it; see freq_loop_measure_batch().  Row k of
+ * meas_out belongs to vars[k] whatever order the workers finish in.  The
+ * model this process holds, and so the UI, is left as it was.  Falls back
+ * to nec2_eval_direct() per candidate when unforked, for a single
+ * candidate, or when the deck cannot be held.  Honors the scope as
+ * nec2_eval_direct() does.
+ *
+ * Returns the number of frequency steps evaluated per candidate, or -1 on
+ * error.  With @failed, a failed candidate alone is flagged, as
+ * nec2_eval_direct() would fail it alone, and the rows of the others stand.
+ */
+int nec2_eval_batch(simple_var_t *const *vars, int num_sets, int num_vars,
+	measurement_t *meas_out, int max_steps, char *failed);
+
+/**
+ * nec2_eval_publish - show the last evaluation in the UI
+ *
+ * Draws the results nec2_eval_direct() just collected and writes the
+ * optimizer output files, synchronously on the GTK main thread.  Called
+ * for a candidate that improves on the best.  No-op after an evaluation
+ * that fell back to nec2_eval_run(), which updates the UI itself.
+ */
+void nec2_eval_publish(void);
+
 /**
  * nec2_eval_get_freq - get frequency array after evaluation
  * @freq_out: output array, caller-allocated, sized for max_steps
@@ -67,4 +150,20 @@ int nec2_eval_run(const simple_var_t *vars, int num_vars,
  */
 int nec2_eval_get_freq(double *freq_out, int max_steps);
 
+/**
+ * nec2_eval_fingerprint - identify what an evaluation depends on besides vars
+ * @vars: the optimizer variables, whose values are excluded
+ * @num_vars: length of vars array
+ *
+ * Hashes the deck file, every SY symbol value not set from @vars, the
+ * var names, the settings meas_calc() reads and the Touchstone network
+ * loaded, if any, with its direction.  Two runs with equal fingerprints
+ * produce equal measurements for equal var values, so cached
+ * measurements may stand in for a sweep.
+ *
+ * Returns a newly allocated hex digest (g_free), or NULL if the deck
+ * cannot be read.
+ */
+gchar *nec2_eval_fingerprint(const simple_var_t *vars, int num_vars);
+
 #endif
@@ -0,0 +1,177 @@
+/*
+ *  Sensitivity - perturbation steps, Jacobian and CSV output.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#include "opt_sensitivity.h"
+#include "../fmt_double.h"
+#include "../mem/mem.h"
+
+#include <math.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_step - perturbation of one var
+ */
+double opt_sensitivity_step(double x, double min, double max)
+{
+	if (isfinite(min) && isfinite(max) && max > min)
+	{
+		return OPT_SENS_REL_STEP * (max - min);
+	}
+
+	if (x != 0.0 && isfinite(x))
+	{
+		return OPT_SENS_REL_STEP * fabs(x);
+	}
+
+	return OPT_SENS_REL_STEP;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_new - allocate a Jacobian
+ */
+opt_sensitivity_t *opt_sensitivity_new(const char *const *names,
+	const double *x, const double *h, int num_vars, int num_steps)
+{
+	opt_sensitivity_t *s = NULL;
+	size_t n = (size_t)num_steps * MEAS_COUNT * num_vars;
+
+	mem_new(&s);
+	s->num_vars = num_vars;
+	s->num_steps = num_steps;
+
+	mem_array_alloc(&s->names, num_vars);
+	mem_array_alloc(&s->x, num_vars);
+	mem_array_alloc(&s->h, num_vars);
+	mem_array_alloc(&s->base, num_steps > 0 ? num_steps : 1);
+	mem_array_alloc(&s->jac, n > 0 ? n : 1);
+
+	for (int d = 0; d < num_vars; d++)
+	{
+		s->names[d] = g_strdup(names[d]);
+		s->x[d] = x[d];
+		s->h[d] = h[d];
+	}
+
+	for (size_t i = 0; i < n; i++)
+	{
+		s->jac[i] = NAN;
+	}
+
+	return s;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_free - release a Jacobian
+ */
+void opt_sensitivity_free(opt_sensitivity_t *s)
+{
+	if (s == NULL)
+	{
+		return;
+	}
+
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		g_free(s->names[d]);
+	}
+	mem_array_free(&s->names);
+	mem_array_free(&s->x);
+	mem_array_free(&s->h);
+	mem_array_free(&s->base);
+	mem_array_free(&s->jac);
+	mem_free(&s);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_at - derivatives of one measurement at one step
+ */
+double *opt_sensitivity_at(const opt_sensitivity_t *s, int step, int field)
+{
+	return &s->jac[((size_t)step * MEAS_COUNT + field) * s->num_vars];
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_compute - fill the Jacobian from the perturbed measurements
+ */
+void opt_sensitivity_compute(opt_sensitivity_t *s,
+	const measurement_t *sets, int stride)
+{
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		const measurement_t *up = &sets[(size_t)(2 * d) * stride];
+		const measurement_t *down = &sets[(size_t)(2 * d + 1) * stride];
+
+		for (int i = 0; i < s->num_steps; i++)
+		{
+			for (int f = 0; f < MEAS_COUNT; f++)
+			{
+				/* NAN either side carries through */
+				opt_sensitivity_at(s, i, f)[d] =
+					(up[i].a[f] - down[i].a[f]) / (2.0 * s->h[d]);
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_write_csv - write a Jacobian as CSV
+ */
+int opt_sensitivity_write_csv(const opt_sensitivity_t *s, FILE *fp,
+	const int *cols, int num_cols)
+{
+	char num[FMT_G17_LEN];
+
+	if (cols == NULL)
+	{
+		num_cols = MEAS_COUNT - 1;
+	}
+
+	fputs("mhz,measurement,value", fp);
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		fprintf(fp, ",d_%s", s->names[d]);
+	}
+	fputc('\n', fp);
+
+	for (int i = 0; i < s->num_steps; i++)
+	{
+		for (int c = 0; c < num_cols; c++)
+		{
+			int f = cols ? cols[c] : c + 1;
+			const double *row = opt_sensitivity_at(s, i, f);
+
+			fmt_g17(num, s->base[i].mhz);
+			fprintf(fp, "%s,%s,", num, meas_names[f]);
+			fmt_g17(num, s->base[i].a[f]);
+			fputs(num, fp);
+			for (int d = 0; d < s->num_vars; d++)
+			{
+				fmt_g17(num, row[d]);
+				fprintf(fp, ",%s", num);
+			}
+			fputc('\n', fp);
+		}
+	}
+
+	return ferror(fp) ? -1 : 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *  Sensitivity of the measurements to the SY variables.
+ *
+ *  Each variable is moved a small step either side of its value and the
+ *  perturbed models are solved together through the worker pool, alongside
+ *  the base model.  Central differences of the measurements then give, for
+ *  every frequency step, the Jacobian of the measurement_t fields with
+ *  respect to the variables.
+ *
+ *  The CSV holds one row per frequency step and measurement:
+ *
+ *    mhz,measurement,value,d_LEN,d_GAP
+ *    14.0,vswr,1.42,-3.1,0.27
+ *
+ *  where value is the base model's and each d_ column the partial
+ *  derivative of the measurement with respect to that variable.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#ifndef OPT_SENSITIVITY_H
+#define OPT_SENSITIVITY_H 1
+
+#include <stdio.h>
+
+#include <glib.h>
+
+#include "../measurements.h"
+
+/** Perturbation as a fraction of the var range, or of the value without one */
+#define OPT_SENS_REL_STEP  1e-3
+
+/** A Jacobian of the measurements at one set of var values */
+typedef struct
+{
+	int     num_vars;
+	int     num_steps;         /**< Frequency steps measured */
+	gchar **names;             /**< Var names [num_vars] */
+	double *x;                 /**< Base values [num_vars] */
+	double *h;                 /**< Perturbation of each var [num_vars] */
+	measurement_t *base;       /**< Base measurements [num_steps] */
+	double *jac;               /**< d meas / d var [num_steps][MEAS_COUNT][num_vars] */
+} opt_sensitivity_t;
+
+/** Completion handler of opt_sensitivity_start(); s is NULL on failure */
+typedef void (*opt_sensitivity_done_t)(opt_sensitivity_t *s, gpointer data);
+
+/**
+ * opt_sensitivity_step - perturbation of one var
+ * @x: value
+ * @min: lower bound
+ * @max: upper bound
+ *
+ * OPT_SENS_REL_STEP of the range when there is one, else of |x|, else
+ * OPT_SENS_REL_STEP itself.
+ */
+double opt_sensitivity_step(double x, double min, double max);
+
+/**
+ * opt_sensitivity_new - allocate a Jacobian
+ * @names: var names, copied [num_vars]
+ * @x: base values [num_vars]
+ * @h: perturbations [num_vars]
+ * @num_vars: vars
+ * @num_steps: frequency steps
+ */
+opt_sensitivity_t *opt_sensitivity_new(const char *const *names,
+	const double *x, const double *h, int num_vars, int num_steps);
+
+/**
+ * opt_sensitivity_free - release a Jacobian
+ * @s: Jacobian (may be NULL)
+ */
+void opt_sensitivity_free(opt_sensitivity_t *s);
+
+/**
+ * opt_sensitivity_at - derivatives of one measurement at one step
+ * @s: Jacobian
+ * @step: frequency step
+ * @field: MEASUREMENT_INDEXES entry
+ *
+ * Returns the num_vars partial derivatives, in var order.
+ */
+double *opt_sensitivity_at(const opt_sensitivity_t *s, int step, int field);
+
+/**
+ * opt_sensitivity_compute - fill the Jacobian from the perturbed measurements
+ * @s: Jacobian, with h set
+ * @sets: measurements of each perturbed model, set 2 * d moving var d up by
+ *        h[d] and set 2 * d + 1 down by it; each set @stride steps apart
+ * @stride: entries between sets, at least num_steps
+ *
+ * A field either side leaves unmeasured (NAN) has a NAN derivative.
+ */
+void opt_sensitivity_compute(opt_sensitivity_t *s,
+	const measurement_t *sets, int stride);
+
+/**
+ * opt_sensitivity_write_csv - write a Jacobian as CSV
+ * @s: Jacobian
+ * @fp: output
+ * @cols: measurement columns to write (NULL = all but mhz)
+ * @num_cols: length of cols
+ *
+ * Returns 0, or -1 on a write error.
+ */
+int opt_sensitivity_write_csv(const opt_sensitivity_t *s, FILE *fp,
+	const int *cols, int num_cols);
+
+/**
+ * opt_sensitivity_start - compute the Jacobian at the current var values
+ * @names: var names [num_vars]
+ * @x: values [num_vars]
+ * @min: lower bounds [num_vars]
+ * @max: upper bounds [num_vars]
+ * @num_vars: vars
+ * @cols: measurements needed (NULL = all); the pattern is solved only when
+ *        one of them reads it
+ * @num_cols: length of cols
+ * @path: CSV output of those measurements (NULL = none)
+ * @done: called on the GTK thread with the result, which it owns
+ * @data: passed to done
+ *
+ * The 2 * num_vars perturbed models and the base model are evaluated as
+ * one batch on a worker thread, which also writes the CSV.  Returns 0 when
+ * the run started, -1 when another evaluation is in progress, the output
+ * cannot be opened or the thread cannot start.
+ */
+int opt_sensitivity_start(const char *const *names, const double *x,
+	const double *min, const double *max, int num_vars,
+	const int *cols, int num_cols, const char *path,
+	opt_sensitivity_done_t done, gpointer data);
+
+/**
+ * opt_sensitivity_start_file - compute the Jacobian of the Opt-flagged vars
+ * @path: CSV output
+ *
+ * For batch mode: takes the SY symbols flagged for optimization with their
+ * current values and ranges, writes every measurement, then quits xnec2c.
+ * Returns 0 when the run started, -1 on error (nothing to quit for).
+ */
+int opt_sensitivity_start_file(const char *path);
+
+/**
+ * opt_sensitivity_running - whether a sensitivity run is in progress
+ */
+gboolean opt_sensitivity_running(void);
+
+/**
+ * opt_sensitivity_shutdown - join a sensitivity run
+ *
+ * Exit-path teardown, safe when none ran.  The batch in flight completes;
+ * its result is dropped.
+ */
+void opt_sensitivity_shutdown(void);
+
+#endif
@@ -0,0 +1,426 @@
+/*
+ *  Sensitivity - evaluation thread.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#include <errno.h>
+#include <locale.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "opt_sensitivity.h"
+#include "../shared.h"
+#include "../sy_expr.h"
+#include "opt_nec2_eval.h"
+#include "opt_session.h"
+#include "opt_study.h"
+
+/* A sensitivity run in progress */
+typedef struct
+{
+	opt_sensitivity_t *sens;   /* Result; NULL until the batch lands */
+	gchar    **names;          /* Var names [num_vars] */
+	double    *x;              /* Base values */
+	double    *h;              /* Perturbations */
+	int        num_vars;
+	int       *cols;           /* Measurements written (NULL = all) */
+	int        num_cols;
+	int        skip;           /* SOLVE_SKIP_* parts no measurement reads */
+	FILE      *fp;             /* CSV output, or NULL */
+	gchar     *path;
+	opt_sensitivity_done_t done;
+	gpointer   data;
+	pthread_t  thread;
+} sens_run_t;
+
+/* The run of this process; at most one at a time */
+static sens_run_t *active_run = NULL;
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * sens_run_free - release a run whose thread is not running
+ * @run: run (may be NULL)
+ */
+static void sens_run_free(sens_run_t *run)
+{
+	if (run == NULL)
+	{
+		return;
+	}
+
+	if (run->fp != NULL)
+	{
+		fclose(run->fp);
+	}
+	g_strfreev(run->names);
+	mem_array_free(&run->x);
+	mem_array_free(&run->h);
+	mem_array_free(&run->cols);
+	opt_sensitivity_free(run->sens);
+	g_free(run->path);
+	mem_free(&run);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * sens_evaluate - solve the perturbed models and the base model
+ * @run: run
+ *
+ * Set 2 * d moves var d up by h[d], set 2 * d + 1 down; the base model is
+ * the last set, so the overrides nec2_eval_batch() leaves standing are the
+ * base values.  Every worker that took a set keeps the Sommerfeld grids of
+ * its steps, so the sets after its first find them computed.
+ *
+ * Returns FALSE when the batch failed.
+ */
+static gboolean sens_evaluate(sens_run_t *run)
+{
+	int nv = run->num_vars;
+	int num_sets = 2 * nv + 1;
+	simple_var_t *sets = NULL;
+	simple_var_t **ptrs = NULL;
+	measurement_t *meas = NULL;
+	int width;
+	int steps;
+
+	g_rec_mutex_lock(&freq_data_lock);
+	width = MIN(MAX(calc_data.steps_total, 1), OPT_MAX_FREQ_STEPS);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	mem_array_alloc(&sets, (size_t)num_sets * nv);
+	mem_array_alloc(&ptrs, num_sets);
+	mem_array_alloc(&meas, (size_t)num_sets * width);
+
+	for (int k = 0; k < num_sets; k++)
+	{
+		ptrs[k] = &sets[k * nv];
+		for (int d = 0; d < nv; d++)
+		{
+			double v = run->x[d];
+
+			if (k / 2 == d && k < 2 * nv)
+			{
+				v += (k % 2 == 0) ? run->h[d] : -run->h[d];
+			}
+
+			memset(&sets[k * nv + d], 0, sizeof(simple_var_t));
+			sets[k * nv + d].name = run->names[d];
+			sets[k * nv + d].values = gsl_vector_alloc(1);
+			gsl_vector_set(sets[k * nv + d].values, 0, v);
+		}
+	}
+
+	nec2_eval_init();
+	nec2_eval_set_scope(NULL, 0, run->skip);
+	steps = nec2_eval_batch(ptrs, num_sets, nv, meas, width, NULL);
+	nec2_eval_cleanup();
+
+	if (steps >= 0)
+	{
+		run->sens = opt_sensitivity_new((const char *const *)run->names,
+			run->x, run->h, nv, steps);
+		memcpy(run->sens->base, &meas[(size_t)(num_sets - 1) * width],
+			steps * sizeof(measurement_t));
+		opt_sensitivity_compute(run->sens, meas, width);
+	}
+
+	for (int k = 0; k < num_sets * nv; k++)
+	{
+		gsl_vector_free(sets[k].values);
+	}
+	mem_array_free(&sets);
+	mem_array_free(&ptrs);
+	mem_array_free(&meas);
+
+	return steps >= 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * sens_finish - GTK callback: hand the result to the run's owner
+ * @user_data: unused
+ */
+static void sens_finish(gpointer user_data)
+{
+	sens_run_t *run = active_run;
+	opt_sensitivity_t *sens;
+
+	(void)user_data;
+
+	/* opt_sensitivity_shutdown() took the run first */
+	if (run == NULL)
+	{
+		return;
+	}
+
+	pthread_join(run->thread, NULL);
+	active_run = NULL;
+
+	sens = run->sens;
+	run->sens = NULL;
+	if (run->done != NULL)
+	{
+		run->done(sens, run->data);
+	}
+	else
+	{
+		opt_sensitivity_free(sens);
+	}
+
+	sens_run_free(run);
+}
+
+/**
+ * sens_thread_func - evaluate, then write the CSV
+ * @arg: the run
+ *
+ * The numeric locale is set for this thread only, so the GUI keeps its own.
+ */
+static void *sens_thread_func(void *arg)
+{
+	sens_run_t *run = arg;
+	locale_t c_locale;
+	locale_t prev_locale;
+	int ret;
+
+	pr_notice("opt_sensitivity: %d vars, %d models%s\n", run->num_vars,
+		2 * run->num_vars + 1,
+		(run->skip & SOLVE_SKIP_RDPAT) ? ", without the pattern" : "");
+
+	if (!sens_evaluate(run))
+	{
+		pr_err("opt_sensitivity: the perturbed models failed to evaluate\n");
+	}
+	else if (run->fp != NULL)
+	{
+		c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+		prev_locale = uselocale(c_locale);
+
+		ret = opt_sensitivity_write_csv(run->sens, run->fp,
+			run->cols, run->num_cols);
+		if (fclose(run->fp) != 0 || ret != 0)
+		{
+			pr_err("opt_sensitivity: %s: %s\n", run->path, g_strerror(errno));
+		}
+		else
+		{
+			pr_notice("opt_sensitivity: %d steps written to %s\n",
+				run->sens->num_steps, run->path);
+		}
+		run->fp = NULL;
+
+		uselocale(prev_locale);
+		freelocale(c_locale);
+	}
+
+	g_idle_add_once(sens_finish, NULL);
+
+	return NULL;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_start - compute the Jacobian at the current var values
+ */
+int opt_sensitivity_start(const char *const *names, const double *x,
+	const double *min, const double *max, int num_vars,
+	const int *cols, int num_cols, const char *path,
+	opt_sensitivity_done_t done, gpointer data)
+{
+	sens_run_t *run = NULL;
+	int ret;
+
+	if (active_run != NULL || opt_is_running() || opt_study_running())
+	{
+		pr_err("opt_sensitivity_start: another evaluation is in progress\n");
+		return -1;
+	}
+
+	if (num_vars < 1)
+	{
+		pr_err("opt_sensitivity_start: no vars\n");
+		return -1;
+	}
+
+	mem_new(&run);
+	run->num_vars = num_vars;
+	run->names = g_new0(gchar *, num_vars + 1);
+	mem_array_alloc(&run->x, num_vars);
+	mem_array_alloc(&run->h, num_vars);
+
+	for (int d = 0; d < num_vars; d++)
+	{
+		run->names[d] = g_strdup(names[d]);
+		run->x[d] = x[d];
+		run->h[d] = opt_sensitivity_step(x[d], min[d], max[d]);
+	}
+
+	/* The near field is never read; the pattern only for the gains */
+	run->skip = SOLVE_SKIP_NEAREH;
+	if (cols != NULL)
+	{
+		mem_array_alloc(&run->cols, num_cols);
+		memcpy(run->cols, cols, num_cols * sizeof(int));
+		run->num_cols = num_cols;
+		run->skip |= SOLVE_SKIP_RDPAT;
+
+		for (int c = 0; c < num_cols; c++)
+		{
+			if (cols[c] >= MEAS_GAIN_MAX)
+			{
+				run->skip &= ~SOLVE_SKIP_RDPAT;
+			}
+		}
+	}
+
+	if (path != NULL)
+	{
+		run->path = g_strdup(path);
+		run->fp = fopen(path, "w");
+		if (run->fp == NULL)
+		{
+			pr_err("opt_sensitivity: %s: %s\n", path, g_strerror(errno));
+			sens_run_free(run);
+			return -1;
+		}
+	}
+
+	run->done = done;
+	run->data = data;
+
+	ret = pthread_create(&run->thread, NULL, sens_thread_func, run);
+	if (ret != 0)
+	{
+		pr_err("opt_sensitivity_start: pthread_create failed: %d\n", ret);
+		sens_run_free(run);
+		return -1;
+	}
+
+	active_run = run;
+
+	return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Opt-flagged symbols gathered by sens_collect_symbol */
+typedef struct
+{
+	GPtrArray *names;
+	GArray    *x;
+	GArray    *min;
+	GArray    *max;
+} sens_symbols_ctx_t;
+
+/**
+ * sens_collect_symbol - sy_foreach callback: keep a symbol flagged Opt
+ */
+static void sens_collect_symbol(const gchar *name, gdouble value,
+	gboolean is_calculated, const gchar *expression,
+	gdouble min_value, gdouble max_value,
+	gdouble override_value, gboolean override_active,
+	gboolean opt_active, gpointer user_data)
+{
+	sens_symbols_ctx_t *ctx = user_data;
+	double x = override_active ? override_value : value;
+
+	(void)expression;
+
+	if (is_calculated || !opt_active)
+	{
+		return;
+	}
+
+	g_ptr_array_add(ctx->names, g_strdup(name));
+	g_array_append_val(ctx->x, x);
+	g_array_append_val(ctx->min, min_value);
+	g_array_append_val(ctx->max, max_value);
+}
+
+/**
+ * sens_file_done - batch completion: the CSV is written, quit
+ */
+static void sens_file_done(opt_sensitivity_t *s, gpointer data)
+{
+	(void)data;
+
+	opt_sensitivity_free(s);
+	xnec2c_quit(NULL);
+}
+
+/**
+ * opt_sensitivity_start_file - compute the Jacobian of the Opt-flagged vars
+ */
+int opt_sensitivity_start_file(const char *path)
+{
+	sens_symbols_ctx_t ctx;
+	int ret = -1;
+
+	ctx.names = g_ptr_array_new_with_free_func(g_free);
+	ctx.x = g_array_new(FALSE, FALSE, sizeof(double));
+	ctx.min = g_array_new(FALSE, FALSE, sizeof(double));
+	ctx.max = g_array_new(FALSE, FALSE, sizeof(double));
+
+	g_rec_mutex_lock(&freq_data_lock);
+	sy_foreach(sens_collect_symbol, &ctx);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	if (ctx.names->len == 0)
+	{
+		pr_err("opt_sensitivity: %s has no SY symbols flagged for "
+			"optimization\n", rc_config.input_file);
+	}
+	else
+	{
+		ret = opt_sensitivity_start((const char *const *)ctx.names->pdata,
+			(double *)ctx.x->data, (double *)ctx.min->data,
+			(double *)ctx.max->data, ctx.names->len, NULL, 0, path,
+			sens_file_done, NULL);
+	}
+
+	g_ptr_array_free(ctx.names, TRUE);
+	g_array_free(ctx.x, TRUE);
+	g_array_free(ctx.min, TRUE);
+	g_array_free(ctx.max, TRUE);
+
+	return ret;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_running - whether a sensitivity run is in progress
+ */
+gboolean opt_sensitivity_running(void)
+{
+	return active_run != NULL;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_sensitivity_shutdown - join a sensitivity run
+ */
+void opt_sensitivity_shutdown(void)
+{
+	sens_run_t *run = active_run;
+
+	if (run == NULL)
+	{
+		return;
+	}
+
+	active_run = NULL;
+	pthread_join(run->thread, NULL);
+	sens_run_free(run);
+}
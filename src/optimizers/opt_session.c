@@ -16,11 +16,617 @@
 
 #include "opt_session.h"
 #include "../shared.h"
+#include "../utils.h"
 #include "opt_nec2_eval.h"
 
 /* Active optimizer session (one at a time) */
 static opt_session_t *active_session = NULL;
 
+/* Measurements of every swept position, kept across sessions while the
+ * model fingerprint holds, so a rerun with other goals sweeps only the
+ * positions it has not seen.  Touched by the optimizer thread only. */
+static opt_cache_t *meas_cache = NULL;
+static gchar *meas_cache_tag = NULL;
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_snapshot_best - keep an evaluation that improves on the best snapshot
+ * @session: active session
+ * @meas: the evaluation's measurements
+ * @freq: the evaluation's frequencies
+ * @steps: number of frequency steps in @meas
+ * @fitness: the evaluation's fitness
+ *
+ * Uses best_snap_fitness rather than best_fitness, which is only updated
+ * by the log callback once per iteration and would allow worse evals to
+ * overwrite.
+ *
+ * Returns TRUE when the snapshot was replaced.
+ */
+static gboolean opt_snapshot_best(opt_session_t *session,
+	const measurement_t *meas, const double *freq, int steps,
+	double fitness)
+{
+	if (!(fitness < session->best_snap_fitness))
+	{
+		return FALSE;
+	}
+
+	g_mutex_lock(&session->best_lock);
+	memcpy(session->best_meas, meas, steps * sizeof(measurement_t));
+	memcpy(session->best_freq, freq, steps * sizeof(double));
+	session->best_num_steps = steps;
+	session->best_snap_fitness = fitness;
+	session->has_best_meas = TRUE;
+	g_mutex_unlock(&session->best_lock);
+
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_meas_cache_path - path of the measurement cache beside the deck
+ * @buf: output buffer, FILENAME_LEN bytes
+ */
+static gboolean opt_meas_cache_path(char *buf)
+{
+	return build_companion_path(rc_config.input_file, ".optcache",
+		buf, FILENAME_LEN);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_var_key_init - set up the position keys of the session
+ * @session: session being started
+ * @vars: variable set
+ * @num_vars: length of vars array
+ */
+static void opt_var_key_init(opt_session_t *session,
+	const simple_var_t *vars, int num_vars)
+{
+	int dims = 0;
+	int i;
+
+	for (i = 0; i < num_vars; i++)
+	{
+		dims += vars[i].values->size;
+	}
+
+	if (dims < 1)
+	{
+		return;
+	}
+
+	/* Insertion sort: a handful of vars */
+	mem_array_alloc(&session->var_order, num_vars);
+	for (i = 0; i < num_vars; i++)
+	{
+		int j = i;
+
+		while (j > 0 && g_ascii_strcasecmp(
+			vars[session->var_order[j - 1]].name, vars[i].name) > 0)
+		{
+			session->var_order[j] = session->var_order[j - 1];
+			j--;
+		}
+		session->var_order[j] = i;
+	}
+
+	session->var_key = gsl_vector_alloc(dims);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_var_key - pack a variable set into the session position key
+ * @session: active session with keys set up
+ * @vars: variable set
+ *
+ * Returns session->var_key.
+ */
+static const gsl_vector *opt_var_key(opt_session_t *session,
+	const simple_var_t *vars)
+{
+	size_t pos = 0;
+	int i;
+
+	for (i = 0; i < session->simple_cfg.num_vars; i++)
+	{
+		const gsl_vector *v = vars[session->var_order[i]].values;
+		size_t j;
+
+		for (j = 0; j < v->size; j++)
+		{
+			gsl_vector_set(session->var_key, pos++, gsl_vector_get(v, j));
+		}
+	}
+
+	return session->var_key;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_meas_cache_open - attach the session to the measurement cache
+ * @session: active session
+ *
+ * Keeps the cache of the previous session when the model fingerprint is
+ * unchanged and otherwise starts over from the .optcache file, if any.
+ * Leaves the session uncached when the fingerprint could not be taken.
+ */
+static void opt_meas_cache_open(opt_session_t *session)
+{
+	char path[FILENAME_LEN];
+	size_t payload_size;
+	int loaded;
+
+	session->meas_opened = TRUE;
+
+	if (session->simple_cfg.nocache || session->fingerprint == NULL
+		|| session->var_key == NULL)
+	{
+		return;
+	}
+
+	g_rec_mutex_lock(&freq_data_lock);
+	session->meas_width = MIN(calc_data.steps_total, OPT_MAX_FREQ_STEPS);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	if (session->meas_width < 1)
+	{
+		return;
+	}
+
+	/* Step count, then frequencies, then measurements */
+	payload_size = (1 + session->meas_width) * sizeof(double)
+		+ session->meas_width * sizeof(measurement_t);
+
+	if (meas_cache == NULL
+		|| g_strcmp0(session->fingerprint, meas_cache_tag) != 0)
+	{
+		opt_cache_free(meas_cache);
+		g_free(meas_cache_tag);
+		meas_cache = opt_cache_new(session->var_key->size, payload_size, 0.0);
+		meas_cache_tag = g_strdup(session->fingerprint);
+
+		if (meas_cache != NULL && opt_meas_cache_path(path))
+		{
+			loaded = opt_cache_load(meas_cache, path, meas_cache_tag);
+			if (loaded > 0)
+			{
+				pr_notice("opt: %d cached sweeps from %s\n", loaded, path);
+			}
+		}
+	}
+
+	if (meas_cache == NULL)
+	{
+		return;
+	}
+
+	session->meas_limit = MAX(1, OPT_MEAS_CACHE_MAX_BYTES / (int)payload_size);
+	mem_alloc(&session->meas_payload, payload_size);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_meas_cache_lookup - fetch the sweep of a variable set from the cache
+ * @session: active session
+ * @vars: variable set
+ * @meas_out: receives the measurements, meas_width entries
+ * @freq_out: receives the frequencies, meas_width entries
+ *
+ * Returns the number of steps, or 0 on a miss.
+ */
+static int opt_meas_cache_lookup(opt_session_t *session,
+	const simple_var_t *vars, measurement_t *meas_out, double *freq_out)
+{
+	const char *payload;
+	double steps;
+	int width = session->meas_width;
+
+	if (session->meas_payload == NULL
+		|| !opt_cache_lookup(meas_cache, opt_var_key(session, vars),
+			NULL, (const void **)&payload))
+	{
+		return 0;
+	}
+
+	memcpy(&steps, payload, sizeof(double));
+	memcpy(freq_out, payload + sizeof(double), width * sizeof(double));
+	memcpy(meas_out, payload + (1 + width) * sizeof(double),
+		width * sizeof(measurement_t));
+
+	/* A sweep reduced for other goals may lack what these read */
+	if (!fitness_covered(&session->fitness_cfg, meas_out, (int)steps,
+		freq_out))
+	{
+		return 0;
+	}
+
+	session->meas_hits++;
+
+	return (int)steps;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_meas_cache_store - keep the sweep of a variable set
+ * @session: active session
+ * @vars: variable set
+ * @meas: its measurements
+ * @freq: its frequencies
+ * @steps: valid entries in @meas and @freq, at most meas_width
+ * @fitness: its fitness under the current goals
+ */
+static void opt_meas_cache_store(opt_session_t *session,
+	const simple_var_t *vars, const measurement_t *meas,
+	const double *freq, int steps, double fitness)
+{
+	char *payload = session->meas_payload;
+	double steps_d = steps;
+	int width = session->meas_width;
+
+	if (payload == NULL || steps > width
+		|| opt_cache_count(meas_cache) >= session->meas_limit)
+	{
+		return;
+	}
+
+	memset(payload, 0, (1 + width) * sizeof(double)
+		+ width * sizeof(measurement_t));
+	memcpy(payload, &steps_d, sizeof(double));
+	memcpy(payload + sizeof(double), freq, steps * sizeof(double));
+	memcpy(payload + (1 + width) * sizeof(double), meas,
+		steps * sizeof(measurement_t));
+
+	opt_cache_store(meas_cache, opt_var_key(session, vars),
+		fitness, payload);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_path - path of the evaluation journal beside the deck
+ * @buf: output buffer, FILENAME_LEN bytes
+ */
+static gboolean opt_journal_path(char *buf)
+{
+	return build_companion_path(rc_config.input_file, ".optjournal",
+		buf, FILENAME_LEN);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_start - open the journal, resuming a stopped run
+ * @session: session being started, before simple_new()
+ * @vars: variable set; its values are set to the start of a resumed run
+ *
+ * A run of the same model and algorithm that did not complete resumes
+ * with its seed and from its own starting values, as the values written
+ * when it stopped have replaced those it started from.  When the goals
+ * score its first evaluation differently, the journal starts over.
+ */
+static void opt_journal_start(opt_session_t *session, simple_var_t *vars)
+{
+	opt_journal_rec_t *rec = &session->journal_first;
+	opt_journal_info_t info;
+	char path[FILENAME_LEN];
+	size_t pos = 0;
+	int i;
+
+	if (session->fingerprint == NULL || session->var_key == NULL
+		|| !opt_journal_path(path))
+	{
+		return;
+	}
+
+	info.tag = session->fingerprint;
+	info.algorithm = session->simple_cfg.algorithm;
+	info.seed = MAX(1, (int)(time(NULL) % 1000000000));
+	info.dims = session->var_key->size;
+	info.meas_size = sizeof(measurement_t);
+
+	session->journal = opt_journal_open(path, &info);
+	if (session->journal == NULL)
+	{
+		return;
+	}
+
+	/* The seed replays the random draws of the run being resumed */
+	session->simple_cfg.srand_seed = info.seed;
+
+	if (!opt_journal_replaying(session->journal))
+	{
+		return;
+	}
+
+	if (!opt_journal_next(session->journal, rec)
+		|| rec->type != OPT_JOURNAL_EVAL
+		|| rec->steps > OPT_MAX_FREQ_STEPS
+		|| (rec->steps > 0 && fitness_compute(&session->fitness_cfg,
+			rec->meas, rec->steps, rec->freq) != rec->fitness))
+	{
+		pr_notice("opt: starting %s over\n", path);
+		opt_journal_diverge(session->journal);
+		return;
+	}
+
+	for (i = 0; i < session->simple_cfg.num_vars; i++)
+	{
+		gsl_vector *v = vars[session->var_order[i]].values;
+		size_t j;
+
+		for (j = 0; j < v->size; j++)
+		{
+			gsl_vector_set(v, j, rec->key[pos++]);
+		}
+	}
+
+	session->journal_held = TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_replay_end - continue the run live from here on
+ * @session: active session whose journal was replaying
+ */
+static void opt_journal_replay_end(opt_session_t *session)
+{
+	opt_journal_diverge(session->journal);
+
+	pr_notice("opt: resumed after %d evaluations from the journal\n",
+		session->journal_replayed);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_replay - serve an evaluation of a resumed run
+ * @session: active session
+ * @vars: variable set the optimizer asks for
+ * @meas_out: receives the measurements, @width entries
+ * @freq_out: receives the frequencies, @width entries
+ * @width: capacity of @meas_out and @freq_out
+ * @steps_out: receives the number of steps, 0 for a failed evaluation
+ * @fitness_out: receives the fitness under the current goals
+ *
+ * With the journal's seed, the run asks for the journal's positions in
+ * order.  A record of another position, or one the goals score another
+ * way, means the run has departed from the journal; it goes on live.
+ *
+ * Returns TRUE when served from the journal.
+ */
+static gboolean opt_journal_replay(opt_session_t *session,
+	const simple_var_t *vars, measurement_t *meas_out, double *freq_out,
+	int width, int *steps_out, double *fitness_out)
+{
+	opt_journal_rec_t rec;
+	const gsl_vector *key;
+	gboolean same;
+	size_t i;
+
+	if (!opt_journal_replaying(session->journal))
+	{
+		return FALSE;
+	}
+
+	if (session->journal_held)
+	{
+		rec = session->journal_first;
+		session->journal_held = FALSE;
+	}
+	else if (!opt_journal_next(session->journal, &rec))
+	{
+		opt_journal_replay_end(session);
+		return FALSE;
+	}
+
+	key = opt_var_key(session, vars);
+	same = rec.type == OPT_JOURNAL_EVAL && rec.steps <= width;
+
+	for (i = 0; same && i < key->size; i++)
+	{
+		same = gsl_vector_get(key, i) == rec.key[i];
+	}
+
+	if (same && rec.steps > 0)
+	{
+		memcpy(meas_out, rec.meas, rec.steps * sizeof(measurement_t));
+		memcpy(freq_out, rec.freq, rec.steps * sizeof(double));
+
+		same = fitness_compute(&session->fitness_cfg, meas_out, rec.steps,
+			freq_out) == rec.fitness;
+	}
+
+	if (!same)
+	{
+		opt_journal_replay_end(session);
+		return FALSE;
+	}
+
+	session->journal_replayed++;
+	*steps_out = rec.steps;
+	*fitness_out = rec.fitness;
+
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_record - journal an evaluation the run did not replay
+ * @session: active session
+ * @vars: variable set
+ * @meas: its measurements
+ * @freq: its frequencies
+ * @steps: valid entries in @meas and @freq, 0 for a failed evaluation
+ * @fitness: its fitness
+ */
+static void opt_journal_record(opt_session_t *session,
+	const simple_var_t *vars, const measurement_t *meas,
+	const double *freq, int steps, double fitness)
+{
+	if (session->journal != NULL)
+	{
+		opt_journal_append_eval(session->journal, opt_var_key(session, vars),
+			fitness, freq, meas, steps);
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_same_state - compare a snapshot with the backend state
+ * @rec: journaled snapshot
+ * @state: log state of the run
+ */
+static gboolean opt_journal_same_state(const opt_journal_rec_t *rec,
+	const simple_log_state_t *state)
+{
+	const gsl_matrix *pos = state->population;
+	const gsl_matrix *vel = state->velocity;
+	size_t r;
+
+	if (rec->type != OPT_JOURNAL_STATE
+		|| rec->pass != state->optimization_pass
+		|| rec->iter != state->iter_count
+		|| rec->best != state->best_minima
+		|| rec->rows != (pos ? (int)pos->size1 : 0)
+		|| rec->cols != (pos ? (int)pos->size2 : 0)
+		|| (rec->vel == NULL) != (vel == NULL))
+	{
+		return FALSE;
+	}
+
+	for (r = 0; pos != NULL && r < pos->size1; r++)
+	{
+		if (memcmp(rec->pos + r * pos->size2, gsl_matrix_const_ptr(pos, r, 0),
+				pos->size2 * sizeof(double)) != 0
+			|| (vel != NULL && memcmp(rec->vel + r * vel->size2,
+				gsl_matrix_const_ptr(vel, r, 0),
+				vel->size2 * sizeof(double)) != 0))
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_journal_snapshot - journal the backend state at a log call
+ * @session: active session with a journal
+ * @state: log state of the run
+ *
+ * A resumed run checks its state against the journal's snapshot instead,
+ * which confirms that the replay reproduced the stopped run.
+ */
+static void opt_journal_snapshot(opt_session_t *session,
+	const simple_log_state_t *state)
+{
+	opt_journal_rec_t rec;
+
+	if (opt_journal_replaying(session->journal))
+	{
+		if (opt_journal_next(session->journal, &rec)
+			&& opt_journal_same_state(&rec, state))
+		{
+			return;
+		}
+
+		opt_journal_replay_end(session);
+	}
+
+	opt_journal_append_state(session->journal, state->optimization_pass,
+		state->iter_count, state->best_minima, state->population,
+		state->velocity);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_eval_scope_init - limit the evaluations to what the goals read
+ * @session: active session, whose freq holds a full sweep's frequencies
+ * @steps: number of steps in that sweep
+ *
+ * Steps outside every objective's MHz range are not solved, nor the far
+ * field when no objective reads a pattern field, nor ever the near field,
+ * which no measurement reads.  The pattern cannot be cut to fewer
+ * directions: the maximum gain, front-to-back ratio and noise temperature
+ * each search or integrate the whole RP grid.
+ */
+static void opt_eval_scope_init(opt_session_t *session, int steps)
+{
+	char need[OPT_MAX_FREQ_STEPS];
+	int skip = SOLVE_SKIP_NEAREH;
+	int count;
+
+	session->scope_set = TRUE;
+
+	count = fitness_needed_steps(&session->fitness_cfg, session->freq,
+		steps, need);
+
+	if (!fitness_needs_pattern(&session->fitness_cfg))
+	{
+		skip |= SOLVE_SKIP_RDPAT;
+	}
+
+	nec2_eval_set_scope(need, steps, skip);
+	session->scope_reduced = TRUE;
+
+	pr_notice("opt: sweeping %d of %d steps%s\n", count, steps,
+		(skip & SOLVE_SKIP_RDPAT) ? ", without the pattern" : "");
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_publish_best - show a candidate that improves on the best
+ * @session: active session
+ * @vars: the candidate
+ * @num_vars: length of vars array
+ * @fitness: its fitness
+ *
+ * The candidate was scored from a reduced sweep or the cache, neither of
+ * which the model holds, so it is swept again in whole for the snapshot
+ * and the UI.  Its fitness is unchanged by the steps and fields added.
+ */
+static void opt_publish_best(opt_session_t *session,
+	const simple_var_t *vars, int num_vars, double fitness)
+{
+	int steps;
+
+	steps = nec2_eval_direct_full(vars, num_vars,
+		session->meas, OPT_MAX_FREQ_STEPS);
+
+	if (steps <= 0)
+	{
+		return;
+	}
+
+	session->num_steps = steps;
+	nec2_eval_get_freq(session->freq, OPT_MAX_FREQ_STEPS);
+
+	opt_meas_cache_store(session, vars, session->meas, session->freq,
+		steps, fitness);
+
+	if (opt_snapshot_best(session, session->meas, session->freq, steps,
+		fitness))
+	{
+		nec2_eval_publish();
+	}
+}
+
 /*------------------------------------------------------------------------*/
 
 /**
@@ -29,20 +635,67 @@ static opt_session_t *active_session = NULL;
  * @num_vars: length of vars array
  * @ctx: opaque pointer to opt_session_t
  *
- * Runs a synchronous NEC2 evaluation and computes fitness.
+ * Runs a synchronous NEC2 evaluation, or takes its sweep from the journal
+ * of a resumed run or the measurement cache, and computes fitness.  The
+ * first evaluation sweeps in whole and sets the scope of the rest.  The
+ * UI is refreshed only for an evaluation that improves on the best; see
+ * opt_publish_best().
  */
 static double opt_fitness_callback(const simple_var_t *vars, int num_vars,
 	void *ctx)
 {
 	opt_session_t *session = (opt_session_t *)ctx;
+	gboolean whole = !session->scope_reduced;
 	int steps;
 	double fitness;
 
-	steps = nec2_eval_run(vars, num_vars,
+	if (!session->meas_opened)
+	{
+		opt_meas_cache_open(session);
+	}
+
+	if (opt_journal_replay(session, vars, session->meas, session->freq,
+		OPT_MAX_FREQ_STEPS, &steps, &fitness))
+	{
+		if (steps > 0)
+		{
+			session->num_steps = steps;
+		}
+
+		if (fitness < session->best_snap_fitness)
+		{
+			opt_publish_best(session, vars, num_vars, fitness);
+		}
+
+		return fitness;
+	}
+
+	steps = opt_meas_cache_lookup(session, vars,
+		session->meas, session->freq);
+
+	if (steps > 0)
+	{
+		session->num_steps = steps;
+		fitness = fitness_compute(&session->fitness_cfg,
+			session->meas, steps, session->freq);
+
+		opt_journal_record(session, vars, session->meas, session->freq,
+			steps, fitness);
+
+		if (fitness < session->best_snap_fitness)
+		{
+			opt_publish_best(session, vars, num_vars, fitness);
+		}
+
+		return fitness;
+	}
+
+	steps = nec2_eval_direct(vars, num_vars,
 		session->meas, OPT_MAX_FREQ_STEPS);
 
 	if (steps <= 0)
 	{
+		opt_journal_record(session, vars, NULL, NULL, 0, INFINITY);
 		return INFINITY;
 	}
 
@@ -52,21 +705,27 @@ static double opt_fitness_callback(const simple_var_t *vars, int num_vars,
 	fitness = fitness_compute(&session->fitness_cfg,
 		session->meas, steps, session->freq);
 
-	/* Snapshot measurements when this evaluation improves on the
-	 * best snapshot seen so far.  Uses best_snap_fitness rather
-	 * than best_fitness which is only updated by the log callback
-	 * once per iteration and would allow worse evals to overwrite. */
-	if (fitness < session->best_snap_fitness)
+	opt_meas_cache_store(session, vars, session->meas, session->freq,
+		steps, fitness);
+	opt_journal_record(session, vars, session->meas, session->freq,
+		steps, fitness);
+
+	if (!session->scope_set)
 	{
-		g_mutex_lock(&session->best_lock);
-		memcpy(session->best_meas, session->meas,
-			steps * sizeof(measurement_t));
-		memcpy(session->best_freq, session->freq,
-			steps * sizeof(double));
-		session->best_num_steps = steps;
-		session->best_snap_fitness = fitness;
-		session->has_best_meas = TRUE;
-		g_mutex_unlock(&session->best_lock);
+		opt_eval_scope_init(session, steps);
+	}
+
+	if (!whole)
+	{
+		if (fitness < session->best_snap_fitness)
+		{
+			opt_publish_best(session, vars, num_vars, fitness);
+		}
+	}
+	else if (opt_snapshot_best(session, session->meas, session->freq,
+		steps, fitness))
+	{
+		nec2_eval_publish();
 	}
 
 	return fitness;
@@ -74,6 +733,176 @@ static double opt_fitness_callback(const simple_var_t *vars, int num_vars,
 
 /*------------------------------------------------------------------------*/
 
+/**
+ * opt_fitness_batch_callback - batch fitness function for the particle swarm
+ * @vars: num_sets variable sets, one per candidate
+ * @num_sets: number of candidates
+ * @num_vars: length of each set
+ * @results: output fitness, one per candidate
+ * @ctx: opaque pointer to opt_session_t
+ *
+ * Takes the candidates the journal of a resumed run or the measurement
+ * cache holds from them and evaluates the rest at once, one per worker,
+ * then scores them in index order so the best snapshot does not depend on
+ * which worker finished first.  The batch leaves the UI model alone, so
+ * the candidate that improves most on the best is evaluated once more in
+ * process and published.
+ */
+static void opt_fitness_batch_callback(simple_var_t *const *vars,
+	int num_sets, int num_vars, double *results, void *ctx)
+{
+	opt_session_t *session = (opt_session_t *)ctx;
+	measurement_t *meas = NULL;
+	double *freq = NULL;
+	int *rows = NULL;
+	int *row_steps = NULL;
+	simple_var_t **miss_vars = NULL;
+	int num_miss = 0;
+	int num_replayed = 0;
+	int width;
+	int steps = 0;
+	int best = -1;
+	double best_fit;
+	int k;
+
+	if (!session->meas_opened)
+	{
+		opt_meas_cache_open(session);
+	}
+
+	/* Rows are sized to the loaded sweep, not to OPT_MAX_FREQ_STEPS */
+	g_rec_mutex_lock(&freq_data_lock);
+	width = MIN(calc_data.steps_total, OPT_MAX_FREQ_STEPS);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	if (width < 1)
+	{
+		width = OPT_MAX_FREQ_STEPS;
+	}
+
+	/* Rows hold the candidates in order; the misses are packed to the
+	 * front for the batch and moved to their rows after it */
+	mem_array_alloc(&meas, (size_t)num_sets * width);
+	mem_array_alloc(&freq, (size_t)num_sets * width);
+	mem_array_alloc(&rows, num_sets);
+	mem_array_alloc(&row_steps, num_sets);
+	mem_array_alloc(&miss_vars, num_sets);
+
+	for (k = 0; k < num_sets; k++)
+	{
+		/* The replay ends at most once, so it serves a leading run */
+		if (k == num_replayed && opt_journal_replay(session, vars[k],
+			&meas[k * width], &freq[k * width], width, &row_steps[k],
+			&results[k]))
+		{
+			num_replayed++;
+			continue;
+		}
+
+		row_steps[k] = opt_meas_cache_lookup(session, vars[k],
+			&meas[k * width], &freq[k * width]);
+
+		if (row_steps[k] <= 0)
+		{
+			rows[num_miss] = k;
+			miss_vars[num_miss++] = vars[k];
+		}
+	}
+
+	if (num_miss > 0)
+	{
+		measurement_t *miss_meas = NULL;
+		char *miss_failed = NULL;
+		int m;
+
+		mem_array_alloc(&miss_meas, (size_t)num_miss * width);
+		mem_array_alloc(&miss_failed, num_miss);
+
+		/* A candidate that fails scores INFINITY alone, as it would
+		 * through opt_fitness_callback() */
+		steps = nec2_eval_batch(miss_vars, num_miss, num_vars,
+			miss_meas, width, miss_failed);
+
+		if (steps > 0)
+		{
+			nec2_eval_get_freq(session->freq, OPT_MAX_FREQ_STEPS);
+		}
+
+		for (m = 0; m < num_miss; m++)
+		{
+			k = rows[m];
+			row_steps[k] = (steps > 0 && miss_failed[m]) ? -1 : steps;
+
+			if (row_steps[k] > 0)
+			{
+				memcpy(&meas[k * width], &miss_meas[m * width],
+					steps * sizeof(measurement_t));
+				memcpy(&freq[k * width], session->freq,
+					steps * sizeof(double));
+			}
+		}
+
+		mem_array_free(&miss_meas);
+		mem_array_free(&miss_failed);
+	}
+
+	best_fit = session->best_snap_fitness;
+
+	for (k = 0; k < num_sets; k++)
+	{
+		if (row_steps[k] <= 0)
+		{
+			results[k] = INFINITY;
+			continue;
+		}
+
+		session->num_steps = row_steps[k];
+		results[k] = fitness_compute(&session->fitness_cfg,
+			&meas[k * width], row_steps[k], &freq[k * width]);
+
+		if (results[k] < best_fit)
+		{
+			best_fit = results[k];
+			best = k;
+		}
+	}
+
+	for (k = 0; k < num_miss; k++)
+	{
+		int row = rows[k];
+
+		if (row_steps[row] > 0)
+		{
+			opt_meas_cache_store(session, vars[row], &meas[row * width],
+				&freq[row * width], row_steps[row], results[row]);
+		}
+	}
+
+	for (k = num_replayed; k < num_sets; k++)
+	{
+		opt_journal_record(session, vars[k], &meas[k * width],
+			&freq[k * width], MAX(row_steps[k], 0), results[k]);
+	}
+
+	mem_array_free(&meas);
+	mem_array_free(&freq);
+	mem_array_free(&rows);
+	mem_array_free(&row_steps);
+	mem_array_free(&miss_vars);
+
+	if (steps > 0 && !session->scope_set)
+	{
+		opt_eval_scope_init(session, steps);
+	}
+
+	if (best >= 0)
+	{
+		opt_publish_best(session, vars[best], num_vars, results[best]);
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
 /**
  * opt_log_callback - log function called by simple optimizer each iteration
  * @vars: current variable values
@@ -93,6 +922,15 @@ static void opt_log_callback(const simple_var_t *vars, int num_vars,
 	session->last_log = *state;
 	session->has_log = TRUE;
 
+	/* The backend owns these and may free them after the call */
+	session->last_log.population = NULL;
+	session->last_log.velocity = NULL;
+
+	if (session->journal != NULL)
+	{
+		opt_journal_snapshot(session, state);
+	}
+
 	pr_notice("opt: pass %d/%d iter %d fitness %.6g best %.6g ssize %.4g "
 		"stagnant %d cache %d/%d\n",
 		state->optimization_pass, state->num_passes,
@@ -120,7 +958,33 @@ static void *opt_thread_func(void *arg)
 	pr_notice("opt: optimization complete, best fitness: %.6g\n",
 		session->best_fitness);
 
-	/* Final evaluation with best result to update xnec2c display */
+	/* A cancelled run stays open to resume on the next start */
+	if (session->journal != NULL)
+	{
+		if (!session->cancelled)
+		{
+			opt_journal_append_end(session->journal);
+		}
+
+		opt_journal_close(session->journal);
+		session->journal = NULL;
+	}
+
+	if (session->meas_payload != NULL)
+	{
+		char path[FILENAME_LEN];
+
+		pr_notice("opt: %d of the sweeps reused from the measurement cache\n",
+			session->meas_hits);
+
+		if (opt_meas_cache_path(path))
+		{
+			opt_cache_save(meas_cache, path, meas_cache_tag);
+		}
+	}
+
+	/* Final evaluation with best result through the reload path, which
+	 * persists the overrides to .sy and updates the full display */
 	{
 		int num_result_vars;
 		const simple_var_t *result_vars;
@@ -154,8 +1018,9 @@ static void *opt_thread_func(void *arg)
  * opt_session_free - join the worker thread and release the active session
  *
  * Single source for tearing down active_session: waits for the worker to
- * exit, releases the optimizer, fitness config, simplex step sizes, and the
- * mutex, then frees and clears the session pointer.
+ * exit, releases the optimizer, fitness config, simplex step sizes, keys,
+ * cache scratch, and the mutex, then frees and clears the session pointer.
+ * The measurement cache itself outlives the session.
  */
 static void opt_session_free(void)
 {
@@ -171,6 +1036,13 @@ static void opt_session_free(void)
 	{
 		mem_array_free(&active_session->simple_cfg.opts.simplex.ssize);
 	}
+	g_free(active_session->fingerprint);
+	mem_array_free(&active_session->var_order);
+	mem_free(&active_session->meas_payload);
+	if (active_session->var_key != NULL)
+	{
+		gsl_vector_free(active_session->var_key);
+	}
 	g_mutex_clear(&active_session->best_lock);
 	mem_free(&active_session);
 }
@@ -223,10 +1095,16 @@ int opt_start(simple_var_t *vars, int num_vars,
 	session->simple_cfg.stagnant_minima_count = stagnant_count;
 	session->simple_cfg.stagnant_minima_tolerance = stagnant_tol;
 	session->simple_cfg.fit_func = opt_fitness_callback;
+	session->simple_cfg.fit_func_batch = opt_fitness_batch_callback;
 	session->simple_cfg.fit_func_ctx = session;
 	session->simple_cfg.log_func = opt_log_callback;
 	session->simple_cfg.log_func_ctx = session;
 
+	/* Keys and journal need the model, which is loaded by now */
+	session->fingerprint = nec2_eval_fingerprint(vars, num_vars);
+	opt_var_key_init(session, vars, num_vars);
+	opt_journal_start(session, vars);
+
 	/* Copy upstream config structs directly from caller */
 	if (algo == OPT_SIMPLEX)
 	{
@@ -247,6 +1125,14 @@ int opt_start(simple_var_t *vars, int num_vars,
 				algo_params->simplex.num_ssize;
 		}
 	}
+	else if (algo == OPT_BAYES)
+	{
+		session->simple_cfg.opts.bayes_cfg = algo_params->bayes_cfg;
+	}
+	else if (algo == OPT_CMAES)
+	{
+		session->simple_cfg.opts.cmaes_cfg = algo_params->cmaes_cfg;
+	}
 	else
 	{
 		session->simple_cfg.opts.pso_cfg = algo_params->pso_cfg;
@@ -278,6 +1164,13 @@ cleanup:
 	{
 		mem_array_free(&session->simple_cfg.opts.simplex.ssize);
 	}
+	opt_journal_close(session->journal);
+	g_free(session->fingerprint);
+	mem_array_free(&session->var_order);
+	if (session->var_key != NULL)
+	{
+		gsl_vector_free(session->var_key);
+	}
 	mem_free(&session);
 	return -1;
 }
@@ -294,6 +1187,7 @@ void opt_cancel(void)
 		return;
 	}
 
+	active_session->cancelled = TRUE;
 	simple_cancel(active_session->simple);
 }
 
@@ -303,17 +1197,21 @@ void opt_cancel(void)
  * opt_shutdown - cancel the running optimizer, join its thread, free session
  *
  * Exit-path teardown: signals the worker to stop, blocks until it has exited,
- * then releases the session.  Idempotent and safe when no optimizer ever ran.
+ * then releases the session and the measurement cache.  Idempotent and safe
+ * when no optimizer ever ran.
  */
 void opt_shutdown(void)
 {
-	if (active_session == NULL)
+	if (active_session != NULL)
 	{
-		return;
+		opt_cancel();
+		opt_session_free();
 	}
 
-	opt_cancel();
-	opt_session_free();
+	opt_cache_free(meas_cache);
+	meas_cache = NULL;
+	g_free(meas_cache_tag);
+	meas_cache_tag = NULL;
 }
 
 /*------------------------------------------------------------------------*/
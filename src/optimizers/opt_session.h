@@ -16,19 +16,24 @@
 #define OPT_SESSION_H    1
 
 #include "../common.h"
+#include "opt_cache.h"
 #include "opt_fitness.h"
+#include "opt_journal.h"
 #include "opt_simple.h"
 
 /** Maximum frequency steps supported by the optimizer session */
 #define OPT_MAX_FREQ_STEPS 2048
 
+/** Memory bound of the measurement cache; entries past it are not kept */
+#define OPT_MEAS_CACHE_MAX_BYTES (256 << 20)
+
 /**
  * Algorithm-specific parameters for opt_start.
  *
  * Union layout matches simple_config_t.opts so the caller populates
  * upstream config structs directly — no field-by-field duplication.
- * Call simplex_config_init() or pso_config_init() on the appropriate
- * member, then override fields as needed.
+ * Call simplex_config_init(), pso_config_init(), bayes_config_init() or
+ * cmaes_config_init() on the appropriate member, then override fields as needed.
  */
 typedef union
 {
@@ -40,6 +45,8 @@ typedef union
 	} simplex;
 
 	pso_config_t pso_cfg;      /**< PSO backend config */
+	bayes_config_t bayes_cfg;  /**< Bayesian backend config */
+	cmaes_config_t cmaes_cfg;  /**< CMA-ES backend config */
 } opt_algo_params_t;
 
 /**
@@ -69,6 +76,34 @@ typedef struct
 	GMutex           best_lock;                  /**< Guards best_meas/freq */
 	gboolean         has_best_meas;              /**< TRUE after first best */
 
+	/* Evaluations after the first solve only the steps and pattern the
+	 * objectives read; see nec2_eval_set_scope() */
+	gboolean         scope_set;                  /**< TRUE once scoped */
+	gboolean         scope_reduced;              /**< Sweeps may be partial */
+
+	/* Position keys of the measurement cache and the journal: the var
+	 * values concatenated in name order, so a reordered .opt file still
+	 * finds its entries.  The fingerprint identifies the model. */
+	gchar           *fingerprint;                /**< Model hash, NULL if none */
+	int             *var_order;                  /**< Var indices by name */
+	gsl_vector      *var_key;                    /**< Key scratch */
+
+	/* Measurement cache, opened on the first evaluation */
+	gboolean         meas_opened;                /**< TRUE once opened */
+	int              meas_width;                 /**< Steps per cache entry */
+	int              meas_limit;                 /**< Entry count bound */
+	int              meas_hits;                  /**< Sweeps served from cache */
+	void            *meas_payload;               /**< Entry scratch, NULL = uncached */
+
+	/* Evaluation journal beside the deck; see opt_journal.h.  While a
+	 * stopped run is resumed, its evaluations are served from the journal
+	 * as from the cache, until the run departs from it. */
+	opt_journal_t   *journal;                    /**< NULL = not journaling */
+	opt_journal_rec_t journal_first;             /**< First record, read at start */
+	gboolean         journal_held;               /**< journal_first not yet served */
+	int              journal_replayed;           /**< Evaluations replayed */
+	gboolean         cancelled;                  /**< Stopped by opt_cancel() */
+
 	/* Generic completion notifier fired on the main thread via g_idle_add_once
 	 * after the worker clears running; set once at opt_start, immutable
 	 * thereafter, carries no quit meaning. */
@@ -77,11 +112,12 @@ typedef struct
 
 /**
  * opt_start - launch optimizer in background thread
- * @vars: simple_var_t array (deep-copied by simple_new)
+ * @vars: simple_var_t array (deep-copied by simple_new); its values are
+ *        set to the start of a run resumed from the journal
  * @num_vars: length of vars array
  * @fitness_cfg: fitness configuration (copied)
- * @algo: algorithm selector (OPT_SIMPLEX or OPT_PSO)
- * @algo_params: algorithm-specific parameters (simplex or PSO config)
+ * @algo: algorithm selector (OPT_SIMPLEX, OPT_PSO, OPT_BAYES or OPT_CMAES)
+ * @algo_params: algorithm-specific parameters (simplex, PSO, Bayesian or CMA-ES config)
  * @max_iter: maximum iterations per pass
  * @stagnant_count: stagnation iteration limit (0 = off)
  * @stagnant_tol: stagnation tolerance
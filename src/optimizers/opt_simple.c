@@ -137,6 +137,8 @@ static optimizer_t *_build_pso_optimizer(simple_t *s, gsl_vector *initial)
 	cfg.exit_plateau   = 0;
 	cfg.fit_func       = simple_fitness_trampoline;
 	cfg.fit_func_ctx   = s;
+	cfg.fit_func_batch = s->fit_func_batch ? simple_fitness_batch_trampoline : NULL;
+	cfg.seed           = (unsigned long)s->srand_seed;
 	cfg.log_func       = simple_pso_log_trampoline;
 	cfg.log_func_ctx   = s;
 	cfg.cancel_flag    = &s->cancel;
@@ -150,6 +152,81 @@ static optimizer_t *_build_pso_optimizer(simple_t *s, gsl_vector *initial)
 	return opt;
 }
 
+/**
+ * _build_bayes_optimizer - create Bayesian backend for one pass
+ * @s: session handle
+ * @initial: initial guess vector (owned by caller)
+ *
+ * Builds bayes_config_t, installs trampolines, returns optimizer_t.
+ * max_iter is the evaluation budget, so each pass spends at most that
+ * many NEC2 runs.
+ */
+static optimizer_t *_build_bayes_optimizer(simple_t *s, gsl_vector *initial)
+{
+	gsl_vector *bmin, *bmax;
+	simple_compute_packed_bounds(s, &bmin, &bmax);
+
+	bayes_config_t cfg = s->algo_opts.bayes_cfg;
+	cfg.dimensions     = s->total_dims;
+	cfg.initial_guess  = initial;
+	cfg.iterations     = s->max_iter;
+	cfg.pos_min        = bmin;
+	cfg.pos_max        = bmax;
+	cfg.exit_fit       = s->exit_fit;
+	cfg.fit_func       = simple_fitness_trampoline;
+	cfg.fit_func_ctx   = s;
+	cfg.fit_func_batch = s->fit_func_batch ? simple_fitness_batch_trampoline : NULL;
+	cfg.seed           = (unsigned long)s->srand_seed;
+	cfg.log_func       = simple_bayes_log_trampoline;
+	cfg.log_func_ctx   = s;
+	cfg.cancel_flag    = &s->cancel;
+
+	optimizer_t *opt = optimizer_new_bayes(&cfg);
+
+	/* Backend deep-copies bounds; free our temporaries */
+	gsl_vector_free(bmin);
+	gsl_vector_free(bmax);
+
+	return opt;
+}
+
+/**
+ * _build_cmaes_optimizer - create CMA-ES backend for one pass
+ * @s: session handle
+ * @initial: initial guess vector (owned by caller)
+ *
+ * Builds cmaes_config_t, installs trampolines, returns optimizer_t.
+ * max_iter counts generations of lambda evaluations each.
+ */
+static optimizer_t *_build_cmaes_optimizer(simple_t *s, gsl_vector *initial)
+{
+	gsl_vector *bmin, *bmax;
+	simple_compute_packed_bounds(s, &bmin, &bmax);
+
+	cmaes_config_t cfg = s->algo_opts.cmaes_cfg;
+	cfg.dimensions     = s->total_dims;
+	cfg.initial_guess  = initial;
+	cfg.iterations     = s->max_iter;
+	cfg.pos_min        = bmin;
+	cfg.pos_max        = bmax;
+	cfg.exit_fit       = s->exit_fit;
+	cfg.fit_func       = simple_fitness_trampoline;
+	cfg.fit_func_ctx   = s;
+	cfg.fit_func_batch = s->fit_func_batch ? simple_fitness_batch_trampoline : NULL;
+	cfg.seed           = (unsigned long)s->srand_seed;
+	cfg.log_func       = simple_cmaes_log_trampoline;
+	cfg.log_func_ctx   = s;
+	cfg.cancel_flag    = &s->cancel;
+
+	optimizer_t *opt = optimizer_new_cmaes(&cfg);
+
+	/* Backend deep-copies bounds; free our temporaries */
+	gsl_vector_free(bmin);
+	gsl_vector_free(bmax);
+
+	return opt;
+}
+
 /**
  * _optimize_single_pass - run one optimization pass
  * @s: session handle
@@ -200,6 +277,14 @@ static void _optimize_single_pass(simple_t *s)
 			opt = _build_pso_optimizer(s, initial);
 			break;
 
+		case OPT_BAYES:
+			opt = _build_bayes_optimizer(s, initial);
+			break;
+
+		case OPT_CMAES:
+			opt = _build_cmaes_optimizer(s, initial);
+			break;
+
 		default:
 			fprintf(stderr, "simple: unknown algorithm %d\n", s->algorithm);
 			gsl_vector_free(initial);
@@ -215,7 +300,9 @@ static void _optimize_single_pass(simple_t *s)
 	}
 
 	/* Run optimization */
+	s->opt = opt;
 	optimizer_optimize(opt);
+	s->opt = NULL;
 
 	optimizer_free(opt);
 }
@@ -293,6 +380,14 @@ void simple_config_init(simple_config_t *cfg, enum optimizer_algo algo)
 			pso_config_init(&cfg->opts.pso_cfg);
 			break;
 
+		case OPT_BAYES:
+			bayes_config_init(&cfg->opts.bayes_cfg);
+			break;
+
+		case OPT_CMAES:
+			cmaes_config_init(&cfg->opts.cmaes_cfg);
+			break;
+
 		default:
 			pr_err("simple_config_init: unknown algorithm %d\n", algo);
 			break;
@@ -320,6 +415,13 @@ simple_t *simple_new(const simple_config_t *cfg)
 		return NULL;
 	}
 
+	if (!(cfg->cache_tolerance >= 0.0) || !isfinite(cfg->cache_tolerance))
+	{
+		fprintf(stderr, "simple_new: cache_tolerance = %g must be >= 0\n",
+			cfg->cache_tolerance);
+		return NULL;
+	}
+
 	/* Validate each var */
 	for (int i = 0; i < cfg->num_vars; i++)
 	{
@@ -357,13 +459,15 @@ simple_t *simple_new(const simple_config_t *cfg)
 	s->max_iter  = cfg->max_iter > 0 ? cfg->max_iter : 1000;
 	s->exit_fit  = cfg->exit_fit;
 	s->nocache   = cfg->nocache;
+	s->cache_tolerance = cfg->cache_tolerance;
 	s->stagnant_minima_count     = cfg->stagnant_minima_count;
 	s->stagnant_minima_tolerance = cfg->stagnant_minima_tolerance;
 
-	s->fit_func     = cfg->fit_func;
-	s->fit_func_ctx = cfg->fit_func_ctx;
-	s->log_func     = cfg->log_func;
-	s->log_func_ctx = cfg->log_func_ctx;
+	s->fit_func       = cfg->fit_func;
+	s->fit_func_ctx   = cfg->fit_func_ctx;
+	s->fit_func_batch = cfg->fit_func_batch;
+	s->log_func       = cfg->log_func;
+	s->log_func_ctx   = cfg->log_func_ctx;
 
 	/* Seed random number generator */
 	if (cfg->srand_seed != 0)
@@ -434,6 +538,28 @@ simple_t *simple_new(const simple_config_t *cfg)
 			break;
 		}
 
+		case OPT_BAYES:
+		{
+			s->algo_opts.bayes_cfg = cfg->opts.bayes_cfg;
+
+			if (s->stagnant_minima_tolerance == 0.0)
+			{
+				s->stagnant_minima_tolerance = 1e-6;
+			}
+			break;
+		}
+
+		case OPT_CMAES:
+		{
+			s->algo_opts.cmaes_cfg = cfg->opts.cmaes_cfg;
+
+			if (s->stagnant_minima_tolerance == 0.0)
+			{
+				s->stagnant_minima_tolerance = 1e-6;
+			}
+			break;
+		}
+
 		default:
 			fprintf(stderr, "simple_new: unknown algorithm %d\n", s->algorithm);
 			simple_free(s);
@@ -497,7 +623,7 @@ double simple_optimize(simple_t *s)
 		s->best_vec = NULL;
 	}
 
-	simple_cache_clear(&s->cache);
+	simple_cache_reset(s);
 
 	/* Multi-pass loop */
 	int num_passes = (s->algorithm == OPT_SIMPLEX)
@@ -568,6 +694,7 @@ void simple_set_vars(simple_t *s, const simple_var_t *vars, int num_vars)
 	}
 	mem_array_free(&s->vars);
 	_free_work_vars(s);
+	simple_batch_vars_free(s);
 
 	/* Deep-copy new vars */
 	s->num_vars = num_vars;
@@ -641,6 +768,7 @@ void simple_free(simple_t *s)
 
 	/* Work vars */
 	_free_work_vars(s);
+	simple_batch_vars_free(s);
 
 	/* Best vars */
 	if (s->best_vars)
@@ -679,7 +807,7 @@ void simple_free(simple_t *s)
 	mem_array_free(&s->sorted_var_indices);
 
 	/* Cache */
-	simple_cache_clear(&s->cache);
+	opt_cache_free(s->cache);
 
 	mem_free(&s);
 }
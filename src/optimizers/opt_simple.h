@@ -65,6 +65,8 @@ typedef struct
 	int    prev_minima_count;   /**< Consecutive stagnant iterations */
 	int    cache_hits;          /**< Cache hit count */
 	int    cache_misses;        /**< Cache miss count */
+	const gsl_matrix *population; /**< Backend points, one per column (NULL = none) */
+	const gsl_matrix *velocity;   /**< PSO velocities, same layout (NULL = none) */
 } simple_log_state_t;
 
 /**
@@ -76,6 +78,17 @@ typedef struct
 typedef double (*simple_fit_func_t)(const simple_var_t *vars, int num_vars,
 	void *ctx);
 
+/**
+ * Batch fitness callback.
+ *
+ * Receives num_sets sets of unpacked named vars, vars[k] being an array
+ * of num_vars, and writes one scalar to be minimized per set into
+ * results[k].  Sets are independent and may be evaluated concurrently;
+ * results are matched to sets by index alone.
+ */
+typedef void (*simple_fit_batch_func_t)(simple_var_t *const *vars,
+	int num_sets, int num_vars, double *results, void *ctx);
+
 /**
  * Log callback.
  *
@@ -100,18 +113,21 @@ typedef struct
 	double exit_fit;            /**< Stop if fitness <= this (NAN = disabled) */
 	int    srand_seed;          /**< Random seed (0 = auto-generate) */
 	int    nocache;             /**< Nonzero to disable result caching */
+	double cache_tolerance;     /**< Cache key quantization in packed units (0 = exact) */
 
 	int    stagnant_minima_count;    /**< Cancel after this many stagnant iters (0 = off) */
 	double stagnant_minima_tolerance; /**< Threshold for stagnation (0 = use tolerance) */
 
 	simple_fit_func_t fit_func; /**< Required: fitness function */
 	void *fit_func_ctx;         /**< Opaque context for fit_func */
+	simple_fit_batch_func_t fit_func_batch; /**< Optional: population fitness (PSO, Bayesian, CMA-ES), ctx is fit_func_ctx */
 
 	simple_log_func_t log_func; /**< Optional: log callback */
 	void *log_func_ctx;         /**< Opaque context for log_func */
 
 	/** Algorithm-specific backend configs.
-	 * User calls simplex_config_init() or pso_config_init() on the
+	 * User calls simplex_config_init(), pso_config_init(),
+	 * bayes_config_init() or cmaes_config_init() on the
 	 * appropriate field before setting values.  simple_new() deep-copies
 	 * the config and overwrites computed fields (dimensions, bounds, etc). */
 	union
@@ -124,6 +140,8 @@ typedef struct
 		} simplex;
 
 		pso_config_t pso_cfg;  /**< Backend config (call pso_config_init first) */
+		bayes_config_t bayes_cfg; /**< Backend config (call bayes_config_init first) */
+		cmaes_config_t cmaes_cfg; /**< Backend config (call cmaes_config_init first) */
 	} opts;
 } simple_config_t;
 
@@ -21,49 +21,22 @@
 /* ---- Cache ---- */
 
 /**
- * _cache_build_key - build cache key string from packed position vector
- * @vec: optimizer position vector in packed coordinate space
+ * simple_cache_reset - start an empty cache for the current packing
+ * @s: session handle
  *
- * Format: "v0,v1,v2,..." with full IEEE 754 precision (%.17g).
  * Keyed on the packed vector directly to avoid perturb_scale round-trip
- * drift and to enable cache lookup before unpacking.
- * Returns a managed string; caller frees.
+ * drift and to enable cache lookup before unpacking.  The key length
+ * follows total_dims, so the cache is rebuilt rather than cleared.
  */
-static char *_cache_build_key(const gsl_vector *vec)
+void simple_cache_reset(simple_t *s)
 {
-	/* Each %.17g value is at most 25 chars; add comma delimiter */
-	int dims = (int)vec->size;
-	int bufsize = dims * 26 + 1;
-	char *key = NULL;
-	mem_alloc(&key, bufsize);
-	int pos = 0;
-
-	for (int d = 0; d < dims; d++)
-	{
-		if (d > 0)
-		{
-			pos += snprintf(key + pos, bufsize - pos, ",");
-		}
-		pos += snprintf(key + pos, bufsize - pos, "%.17g",
-			gsl_vector_get(vec, d));
-	}
+	opt_cache_free(s->cache);
+	s->cache = NULL;
 
-	return key;
-}
-
-/**
- * simple_cache_clear - free all entries in cache
- * @cache: cache to clear
- */
-void simple_cache_clear(simple_cache_t *cache)
-{
-	for (int i = 0; i < cache->count; i++)
+	if (!s->nocache)
 	{
-		mem_free(&cache->entries[i].key);
+		s->cache = opt_cache_new(s->total_dims, 0, s->cache_tolerance);
 	}
-
-	mem_array_free(&cache->entries);
-	cache->count = 0;
 }
 
 /**
@@ -76,30 +49,18 @@ void simple_cache_clear(simple_cache_t *cache)
  */
 double simple_cache_lookup(simple_t *s, const gsl_vector *vec, int *found)
 {
-	*found = 0;
+	double value;
+
+	*found = opt_cache_lookup(s->cache, vec, &value, NULL);
 
-	if (s->nocache)
+	if (!*found)
 	{
 		s->cache_misses++;
 		return NAN;
 	}
 
-	char *key = _cache_build_key(vec);
-
-	for (int i = 0; i < s->cache.count; i++)
-	{
-		if (strcmp(s->cache.entries[i].key, key) == 0)
-		{
-			mem_free(&key);
-			s->cache_hits++;
-			*found = 1;
-			return s->cache.entries[i].value;
-		}
-	}
-
-	mem_free(&key);
-	s->cache_misses++;
-	return NAN;
+	s->cache_hits++;
+	return value;
 }
 
 /**
@@ -110,16 +71,10 @@ double simple_cache_lookup(simple_t *s, const gsl_vector *vec, int *found)
  */
 void simple_cache_store(simple_t *s, const gsl_vector *vec, double value)
 {
-	if (s->nocache)
+	if (s->cache)
 	{
-		return;
+		opt_cache_store(s->cache, vec, value, NULL);
 	}
-
-	mem_array_reserve(&s->cache.entries, s->cache.count + 1, 64);
-
-	s->cache.entries[s->cache.count].key   = _cache_build_key(vec);
-	s->cache.entries[s->cache.count].value = value;
-	s->cache.count++;
 }
 
 /* ---- Timing ---- */
@@ -136,6 +91,48 @@ static double _get_time(void)
 
 /* ---- Fitness trampoline ---- */
 
+/**
+ * _track_best - record a result that improves on the cross-pass best
+ * @s: session handle
+ * @pos: packed position the result was scored at
+ * @vars: unpacked vars the result was scored with
+ * @result: fitness
+ */
+static void _track_best(simple_t *s, const gsl_vector *pos,
+	const simple_var_t *vars, double result)
+{
+	if (!(result < s->best_minima))
+	{
+		return;
+	}
+
+	s->best_minima = result;
+	s->best_pass = s->optimization_pass;
+
+	/* Deep-copy current position vector */
+	if (!s->best_vec)
+	{
+		s->best_vec = gsl_vector_alloc(pos->size);
+	}
+	gsl_vector_memcpy(s->best_vec, pos);
+
+	/* Deep-copy vars as best_vars */
+	if (s->best_vars)
+	{
+		for (int i = 0; i < s->num_vars; i++)
+		{
+			simple_var_free_contents(&s->best_vars[i]);
+		}
+		mem_array_free(&s->best_vars);
+	}
+
+	mem_array_alloc(&s->best_vars, s->num_vars);
+	for (int i = 0; i < s->num_vars; i++)
+	{
+		simple_var_deep_copy(&s->best_vars[i], &vars[i]);
+	}
+}
+
 /**
  * simple_fitness_trampoline - adapter between backend and user fitness
  * @pos: position vector from optimizer backend (packed coordinate space)
@@ -183,38 +180,180 @@ double simple_fitness_trampoline(const gsl_vector *pos, void *ctx)
 	}
 
 	simple_cache_store(s, pos, result);
+	_track_best(s, pos, s->work_vars, result);
+
+	return result;
+}
+
+/* ---- Batch fitness trampoline ---- */
+
+/**
+ * _batch_vars_reserve - grow the batch work var sets to at least n
+ * @s: session handle
+ * @n: sets required
+ *
+ * Each set is a deep copy of work_vars; only its values are rewritten
+ * per evaluation.
+ */
+static void _batch_vars_reserve(simple_t *s, int n)
+{
+	if (n <= s->num_batch_vars)
+	{
+		return;
+	}
+
+	mem_array_realloc(&s->batch_vars, n);
+
+	for (int k = s->num_batch_vars; k < n; k++)
+	{
+		s->batch_vars[k] = NULL;
+		mem_array_alloc(&s->batch_vars[k], s->num_vars);
+		for (int i = 0; i < s->num_vars; i++)
+		{
+			simple_var_deep_copy(&s->batch_vars[k][i], &s->work_vars[i]);
+		}
+	}
+
+	s->num_batch_vars = n;
+}
+
+/**
+ * simple_batch_vars_free - free the batch work var sets
+ * @s: session handle
+ */
+void simple_batch_vars_free(simple_t *s)
+{
+	for (int k = 0; k < s->num_batch_vars; k++)
+	{
+		for (int i = 0; i < s->num_vars; i++)
+		{
+			simple_var_free_contents(&s->batch_vars[k][i]);
+		}
+		mem_array_free(&s->batch_vars[k]);
+	}
+
+	mem_array_free(&s->batch_vars);
+	s->num_batch_vars = 0;
+}
+
+/**
+ * simple_fitness_batch_trampoline - adapter between PSO and batch fitness
+ * @pos: positions from backend, one per column (packed coordinate space)
+ * @fit: output fitness, one per column
+ * @ctx: simple_t* pointer
+ *
+ * Walks the columns in order exactly as repeated calls to
+ * simple_fitness_trampoline() would: iteration count, cache lookup, and
+ * a column repeating an earlier miss of the same batch counts as the
+ * cache hit it would have been.  The remaining misses are unpacked into
+ * their own var sets and evaluated in one fit_func_batch call.  Cache
+ * stores and best tracking then run in column order, so the outcome does
+ * not depend on the order the user's evaluations complete in.
+ */
+void simple_fitness_batch_trampoline(const gsl_matrix *pos, gsl_vector *fit,
+	void *ctx)
+{
+	simple_t *s = ctx;
+	int n = (int)pos->size2;
+	int *source = NULL;   /* Column whose evaluation supplies this one, -1 = cached */
+	int *set_of = NULL;   /* Batch set holding a miss, by column */
+	double *results = NULL;
+	int num_sets = 0;
 
-	/* Track cross-pass best */
-	if (result < s->best_minima)
+	if (s->cancel)
 	{
-		s->best_minima = result;
-		s->best_pass = s->optimization_pass;
+		gsl_vector_set_all(fit, INFINITY);
+		return;
+	}
 
-		/* Deep-copy current position vector */
-		if (!s->best_vec)
+	mem_array_alloc(&source, n);
+	mem_array_alloc(&set_of, n);
+
+	for (int c = 0; c < n; c++)
+	{
+		gsl_vector_const_view col = gsl_matrix_const_column(pos, c);
+		int found;
+		double cached;
+
+		s->iter_count++;
+		set_of[c] = -1;
+
+		cached = simple_cache_lookup(s, &col.vector, &found);
+		if (found)
 		{
-			s->best_vec = gsl_vector_alloc(pos->size);
+			source[c] = -1;
+			gsl_vector_set(fit, c, cached);
+			continue;
 		}
-		gsl_vector_memcpy(s->best_vec, pos);
 
-		/* Deep-copy work_vars as best_vars */
-		if (s->best_vars)
+		/* Repeat of an earlier miss in this batch */
+		source[c] = c;
+		for (int e = 0; e < c && s->cache; e++)
 		{
-			for (int i = 0; i < s->num_vars; i++)
+			gsl_vector_const_view prev = gsl_matrix_const_column(pos, e);
+
+			if (source[e] == e
+				&& opt_cache_same_key(s->cache, &prev.vector, &col.vector))
 			{
-				simple_var_free_contents(&s->best_vars[i]);
+				source[c] = e;
+				s->cache_misses--;
+				s->cache_hits++;
+				break;
 			}
-			mem_array_free(&s->best_vars);
 		}
 
-		mem_array_alloc(&s->best_vars, s->num_vars);
+		if (source[c] != c)
+		{
+			continue;
+		}
+
+		_batch_vars_reserve(s, num_sets + 1);
+		simple_unpack_vec(s, &col.vector);
 		for (int i = 0; i < s->num_vars; i++)
 		{
-			simple_var_deep_copy(&s->best_vars[i], &s->work_vars[i]);
+			gsl_vector_memcpy(s->batch_vars[num_sets][i].values,
+				s->work_vars[i].values);
 		}
+		set_of[c] = num_sets++;
 	}
 
-	return result;
+	if (num_sets > 0)
+	{
+		mem_array_alloc(&results, num_sets);
+		s->fit_func_batch(s->batch_vars, num_sets, s->num_vars,
+			results, s->fit_func_ctx);
+	}
+
+	for (int c = 0; c < n; c++)
+	{
+		if (source[c] == -1)
+		{
+			continue;
+		}
+
+		if (source[c] != c)
+		{
+			gsl_vector_set(fit, c, gsl_vector_get(fit, source[c]));
+			continue;
+		}
+
+		gsl_vector_const_view col = gsl_matrix_const_column(pos, c);
+		double result = results[set_of[c]];
+
+		/* NaN safety: treat as worst possible */
+		if (isnan(result))
+		{
+			result = INFINITY;
+		}
+
+		gsl_vector_set(fit, c, result);
+		simple_cache_store(s, &col.vector, result);
+		_track_best(s, &col.vector, s->batch_vars[set_of[c]], result);
+	}
+
+	mem_array_free(&results);
+	mem_array_free(&set_of);
+	mem_array_free(&source);
 }
 
 /* ---- Log trampolines ---- */
@@ -222,7 +361,7 @@ double simple_fitness_trampoline(const gsl_vector *pos, void *ctx)
 /**
  * _log_common - shared log logic for both backends
  * @s: session handle
- * @ssize: simplex size (INFINITY for PSO)
+ * @ssize: simplex size or CMA-ES step (INFINITY for PSO and Bayesian)
  *
  * Updates stagnation tracking, timing, calls user log callback.
  */
@@ -287,6 +426,12 @@ static void _log_common(simple_t *s, double ssize)
 	state.cache_hits         = s->cache_hits;
 	state.cache_misses       = s->cache_misses;
 
+	if (s->opt)
+	{
+		state.population = optimizer_get_population(s->opt);
+		state.velocity   = optimizer_get_velocity(s->opt);
+	}
+
 	/* Pass work_vars (current iteration values) to user */
 	s->log_func(s->work_vars, s->num_vars, &state, s->log_func_ctx);
 }
@@ -320,3 +465,35 @@ void simple_pso_log_trampoline(const gsl_vector *pos, double fit, void *ctx)
 	/* PSO has no simplex-size equivalent */
 	_log_common(ctx, INFINITY);
 }
+
+/**
+ * simple_bayes_log_trampoline - log adapter for Bayesian backend
+ * @pos: best position (unused by simple layer)
+ * @fit: best fitness (unused by simple layer)
+ * @ctx: simple_t* pointer
+ */
+void simple_bayes_log_trampoline(const gsl_vector *pos, double fit, void *ctx)
+{
+	(void)pos;
+	(void)fit;
+
+	/* Nor does the Bayesian optimizer */
+	_log_common(ctx, INFINITY);
+}
+
+/**
+ * simple_cmaes_log_trampoline - log adapter for CMA-ES backend
+ * @pos: best position (unused by simple layer)
+ * @fit: best fitness (unused by simple layer)
+ * @sigma: largest sampling deviation, fraction of the bounds range
+ * @ctx: simple_t* pointer
+ */
+void simple_cmaes_log_trampoline(const gsl_vector *pos, double fit,
+	double sigma, void *ctx)
+{
+	(void)pos;
+	(void)fit;
+
+	/* The step size plays the part of the simplex size */
+	_log_common(ctx, sigma);
+}
@@ -16,20 +16,7 @@
 #define OPT_SIMPLE_INTERNAL_H 1
 
 #include "opt_simple.h"
-
-/** One cached trial: parameter-vector key and the fitness it scored */
-typedef struct
-{
-	char   *key;
-	double  value;
-} simple_cache_entry_t;
-
-/** Result cache: managed array of (key, value) entries */
-typedef struct
-{
-	simple_cache_entry_t *entries;
-	int                   count;
-} simple_cache_t;
+#include "opt_cache.h"
 
 /** Full session state, opaque to public API callers */
 struct simple_s
@@ -43,11 +30,13 @@ struct simple_s
 	double exit_fit;
 	int    srand_seed;
 	int    nocache;
+	double cache_tolerance;
 	int    stagnant_minima_count;
 	double stagnant_minima_tolerance;
 
 	simple_fit_func_t fit_func;
 	void *fit_func_ctx;
+	simple_fit_batch_func_t fit_func_batch;
 	simple_log_func_t log_func;
 	void *log_func_ctx;
 
@@ -63,6 +52,8 @@ struct simple_s
 		} simplex;
 
 		pso_config_t pso_cfg;     /**< Pre-initialized with defaults + user overrides */
+		bayes_config_t bayes_cfg; /**< Pre-initialized with defaults + user overrides */
+		cmaes_config_t cmaes_cfg; /**< Pre-initialized with defaults + user overrides */
 	} algo_opts;
 
 	/* Index map: gsl_vector dim -> (var_idx, elem_idx) */
@@ -76,6 +67,11 @@ struct simple_s
 	/* Work vars: pre-allocated, reused in fitness trampoline */
 	simple_var_t *work_vars;
 
+	/* Batch work vars: one set per population member, grown on demand
+	 * by the batch trampoline */
+	simple_var_t **batch_vars;
+	int num_batch_vars;
+
 	/* Cross-pass best tracking */
 	double best_minima;
 	gsl_vector *best_vec;
@@ -91,8 +87,8 @@ struct simple_s
 	int log_count;
 	int iter_count;
 
-	/* Cache */
-	simple_cache_t cache;
+	/* Fitness by packed position, rebuilt by each simple_optimize() */
+	opt_cache_t *cache;
 	int cache_hits;
 	int cache_misses;
 
@@ -107,6 +103,9 @@ struct simple_s
 	/* Latest ssize from backend log trampoline */
 	double current_ssize;
 
+	/* Backend of the running pass, NULL between passes */
+	optimizer_t *opt;
+
 	/* Result vars (populated after optimize, round_result applied) */
 	simple_var_t *result_vars;
 	int num_result_vars;
@@ -204,10 +203,10 @@ void simple_compute_packed_bounds(const simple_t *s,
 /* ---- opt_simple_engine.c ---- */
 
 /**
- * simple_cache_clear - free all cached entries
- * @cache: cache to clear
+ * simple_cache_reset - start an empty cache for the current packing
+ * @s: session handle
  */
-void simple_cache_clear(simple_cache_t *cache);
+void simple_cache_reset(simple_t *s);
 
 /**
  * simple_cache_lookup - look up cached fitness for packed position
@@ -215,8 +214,8 @@ void simple_cache_clear(simple_cache_t *cache);
  * @vec: packed position vector from optimizer backend
  * @found: output, set to 1 if found
  *
- * Builds key from packed vector with full precision. Returns cached value
- * if found, avoiding the need to unpack on cache hits.
+ * Hashes the packed vector, quantized to cache_tolerance.  Returns the
+ * cached value if found, avoiding the need to unpack on cache hits.
  */
 double simple_cache_lookup(simple_t *s, const gsl_vector *vec, int *found);
 
@@ -237,6 +236,24 @@ void simple_cache_store(simple_t *s, const gsl_vector *vec, double value);
  */
 double simple_fitness_trampoline(const gsl_vector *pos, void *ctx);
 
+/**
+ * simple_fitness_batch_trampoline - batch fitness callback installed in PSO
+ * @pos: positions from backend, one per column
+ * @fit: output fitness, one per column
+ * @ctx: simple_t* pointer
+ *
+ * Same contract as simple_fitness_trampoline() applied to each column in
+ * order; the cache misses are handed to the user's fit_func_batch at once.
+ */
+void simple_fitness_batch_trampoline(const gsl_matrix *pos, gsl_vector *fit,
+	void *ctx);
+
+/**
+ * simple_batch_vars_free - free the batch work var sets
+ * @s: session handle
+ */
+void simple_batch_vars_free(simple_t *s);
+
 /**
  * simple_simplex_log_trampoline - log callback for simplex backend
  * @simplex: current simplex matrix
@@ -255,4 +272,22 @@ void simple_simplex_log_trampoline(const gsl_matrix *simplex,
  */
 void simple_pso_log_trampoline(const gsl_vector *pos, double fit, void *ctx);
 
+/**
+ * simple_bayes_log_trampoline - log callback for Bayesian backend
+ * @pos: current best position
+ * @fit: current best fitness
+ * @ctx: simple_t* pointer
+ */
+void simple_bayes_log_trampoline(const gsl_vector *pos, double fit, void *ctx);
+
+/**
+ * simple_cmaes_log_trampoline - log callback for CMA-ES backend
+ * @pos: current best position
+ * @fit: current best fitness
+ * @sigma: current step size, fraction of the bounds range
+ * @ctx: simple_t* pointer
+ */
+void simple_cmaes_log_trampoline(const gsl_vector *pos, double fit,
+	double sigma, void *ctx);
+
 #endif
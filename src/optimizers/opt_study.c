@@ -0,0 +1,399 @@
+/*
+ *  Parameter study - spec parsing and point design.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#include "opt_study.h"
+#include "../console.h"
+#include "../mem/mem.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#include <gsl/gsl_randist.h>
+#include <gsl/gsl_rng.h>
+
+/* GKeyFile group and key names */
+#define GRP_STUDY        "study"
+#define GRP_VAR_PREFIX   "var "
+
+#define KEY_DESIGN       "design"
+#define KEY_POINTS       "points"
+#define KEY_SEED         "seed"
+#define KEY_MEASUREMENTS "measurements"
+#define KEY_OUTPUT       "output"
+#define KEY_MIN          "min"
+#define KEY_MAX          "max"
+#define KEY_LEVELS       "levels"
+
+static const char *design_names[OPT_STUDY_DESIGN_COUNT] = {
+	"grid",
+	"lhs"
+};
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * study_int - read an optional integer key
+ * @kf: spec
+ * @grp: group
+ * @key: key
+ * @dflt: value when the key is absent
+ * @out: output
+ *
+ * Returns FALSE when the key is present but not an integer.
+ */
+static gboolean study_int(GKeyFile *kf, const char *grp, const char *key,
+	int dflt, int *out)
+{
+	GError *err = NULL;
+
+	*out = dflt;
+	if (!g_key_file_has_key(kf, grp, key, NULL))
+	{
+		return TRUE;
+	}
+
+	*out = g_key_file_get_integer(kf, grp, key, &err);
+	if (err != NULL)
+	{
+		pr_err("opt_study: [%s] %s: %s\n", grp, key, err->message);
+		g_error_free(err);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * study_double - read a required floating point key
+ * @kf: spec
+ * @grp: group
+ * @key: key
+ * @out: output
+ *
+ * Returns FALSE when the key is absent or not a number.
+ */
+static gboolean study_double(GKeyFile *kf, const char *grp, const char *key,
+	double *out)
+{
+	GError *err = NULL;
+
+	*out = g_key_file_get_double(kf, grp, key, &err);
+	if (err != NULL)
+	{
+		pr_err("opt_study: [%s] %s: %s\n", grp, key, err->message);
+		g_error_free(err);
+		return FALSE;
+	}
+
+	if (!isfinite(*out))
+	{
+		pr_err("opt_study: [%s] %s is not finite\n", grp, key);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * study_load_vars - read the [var NAME] groups
+ * @s: study
+ * @kf: spec
+ *
+ * Returns FALSE on a malformed group or when there are none.
+ */
+static gboolean study_load_vars(opt_study_t *s, GKeyFile *kf)
+{
+	gchar **groups;
+	gsize num_groups;
+	gboolean ok = TRUE;
+
+	groups = g_key_file_get_groups(kf, &num_groups);
+	mem_array_alloc(&s->vars, num_groups > 0 ? num_groups : 1);
+
+	for (gsize i = 0; ok && i < num_groups; i++)
+	{
+		opt_study_var_t *v = &s->vars[s->num_vars];
+		const char *name;
+
+		if (!g_str_has_prefix(groups[i], GRP_VAR_PREFIX))
+		{
+			continue;
+		}
+
+		name = groups[i] + strlen(GRP_VAR_PREFIX);
+		if (*name == '\0')
+		{
+			pr_err("opt_study: [%s] has no symbol name\n", groups[i]);
+			ok = FALSE;
+			break;
+		}
+
+		v->name = g_strdup(name);
+		s->num_vars++;
+
+		ok = study_double(kf, groups[i], KEY_MIN, &v->min)
+			&& study_double(kf, groups[i], KEY_MAX, &v->max)
+			&& study_int(kf, groups[i], KEY_LEVELS, 2, &v->levels);
+
+		if (ok && v->max < v->min)
+		{
+			pr_err("opt_study: [%s] max is below min\n", groups[i]);
+			ok = FALSE;
+		}
+
+		if (ok && v->levels < 1)
+		{
+			pr_err("opt_study: [%s] levels must be at least 1\n", groups[i]);
+			ok = FALSE;
+		}
+	}
+
+	g_strfreev(groups);
+
+	if (ok && s->num_vars == 0)
+	{
+		pr_err("opt_study: no [" GRP_VAR_PREFIX "NAME] groups\n");
+		ok = FALSE;
+	}
+
+	return ok;
+}
+
+/**
+ * study_grid_points - number of points of the full grid
+ * @s: study
+ *
+ * Returns -1 when the grid does not fit an int.
+ */
+static int study_grid_points(const opt_study_t *s)
+{
+	long long n = 1;
+
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		n *= s->vars[d].levels;
+		if (n > INT_MAX)
+		{
+			return -1;
+		}
+	}
+
+	return (int)n;
+}
+
+/**
+ * study_latin_hypercube - stratified random design in the unit cube
+ * @s: study, with num_points and seed set
+ *
+ * Every var is cut into num_points strata and each point takes a distinct
+ * stratum per var; see bayes_latin_hypercube().
+ */
+static void study_latin_hypercube(opt_study_t *s)
+{
+	int n = s->num_points;
+	size_t *perm = NULL;
+	gsl_rng *rng;
+
+	rng = gsl_rng_alloc(gsl_rng_mt19937);
+	gsl_rng_set(rng, s->seed);
+
+	mem_array_alloc(&perm, n);
+	mem_array_alloc(&s->unit, (size_t)n * s->num_vars);
+
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			perm[i] = (size_t)i;
+		}
+		gsl_ran_shuffle(rng, perm, n, sizeof(size_t));
+
+		for (int i = 0; i < n; i++)
+		{
+			s->unit[(size_t)i * s->num_vars + d] =
+				(perm[i] + gsl_rng_uniform(rng)) / n;
+		}
+	}
+
+	mem_array_free(&perm);
+	gsl_rng_free(rng);
+}
+
+/**
+ * study_default_output - the spec path with its extension made .csv
+ * @path: spec file
+ */
+static gchar *study_default_output(const char *path)
+{
+	const char *dot = strrchr(path, '.');
+	const char *slash = strrchr(path, '/');
+
+	if (dot == NULL || (slash != NULL && dot < slash))
+	{
+		return g_strconcat(path, ".csv", NULL);
+	}
+
+	return g_strdup_printf("%.*s.csv", (int)(dot - path), path);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_load - read a study spec and lay out its design
+ */
+opt_study_t *opt_study_load(const char *path)
+{
+	opt_study_t *s = NULL;
+	GKeyFile *kf;
+	GError *err = NULL;
+	gchar *str;
+	gboolean ok;
+
+	kf = g_key_file_new();
+	if (!g_key_file_load_from_file(kf, path, G_KEY_FILE_NONE, &err))
+	{
+		pr_err("opt_study: %s: %s\n", path, err->message);
+		g_error_free(err);
+		g_key_file_free(kf);
+		return NULL;
+	}
+
+	mem_new(&s);
+
+	/* Design name → enum */
+	str = g_key_file_get_string(kf, GRP_STUDY, KEY_DESIGN, NULL);
+	s->design = OPT_STUDY_GRID;
+	ok = TRUE;
+	if (str != NULL)
+	{
+		int idx;
+
+		for (idx = 0; idx < OPT_STUDY_DESIGN_COUNT; idx++)
+		{
+			if (g_strcmp0(design_names[idx], g_strstrip(str)) == 0)
+			{
+				break;
+			}
+		}
+
+		if (idx == OPT_STUDY_DESIGN_COUNT)
+		{
+			pr_err("opt_study: unknown design '%s'\n", str);
+			ok = FALSE;
+		}
+		s->design = idx;
+		g_free(str);
+	}
+
+	ok = ok && study_load_vars(s, kf)
+		&& study_int(kf, GRP_STUDY, KEY_SEED, 1, &s->seed);
+
+	if (ok && s->design == OPT_STUDY_GRID)
+	{
+		s->num_points = study_grid_points(s);
+		if (s->num_points < 0)
+		{
+			pr_err("opt_study: the grid has too many points\n");
+			ok = FALSE;
+		}
+	}
+	else if (ok)
+	{
+		ok = study_int(kf, GRP_STUDY, KEY_POINTS, 0, &s->num_points);
+		if (ok && s->num_points < 1)
+		{
+			pr_err("opt_study: an lhs design needs points >= 1\n");
+			ok = FALSE;
+		}
+	}
+
+	if (ok)
+	{
+		s->measurements = g_key_file_get_string_list(kf, GRP_STUDY,
+			KEY_MEASUREMENTS, NULL, NULL);
+
+		s->output = g_key_file_get_string(kf, GRP_STUDY, KEY_OUTPUT, NULL);
+		if (s->output == NULL)
+		{
+			s->output = study_default_output(path);
+		}
+		s->binary = g_str_has_suffix(s->output, ".bin");
+	}
+
+	if (ok && s->design == OPT_STUDY_LHS)
+	{
+		study_latin_hypercube(s);
+	}
+
+	g_key_file_free(kf);
+
+	if (!ok)
+	{
+		opt_study_free(s);
+		return NULL;
+	}
+
+	return s;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_free - release a study
+ */
+void opt_study_free(opt_study_t *s)
+{
+	if (s == NULL)
+	{
+		return;
+	}
+
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		g_free(s->vars[d].name);
+	}
+	mem_array_free(&s->vars);
+	mem_array_free(&s->unit);
+	g_strfreev(s->measurements);
+	g_free(s->output);
+	mem_free(&s);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_point - values of one point of the design
+ */
+void opt_study_point(const opt_study_t *s, int k, double *x)
+{
+	for (int d = s->num_vars - 1; d >= 0; d--)
+	{
+		const opt_study_var_t *v = &s->vars[d];
+		double u;
+
+		if (s->design == OPT_STUDY_LHS)
+		{
+			u = s->unit[(size_t)k * s->num_vars + d];
+		}
+		else
+		{
+			u = v->levels > 1
+				? (double)(k % v->levels) / (v->levels - 1) : 0.0;
+			k /= v->levels;
+		}
+
+		/* The last level lands on max exactly */
+		x[d] = u >= 1.0 ? v->max : v->min + (v->max - v->min) * u;
+	}
+}
@@ -0,0 +1,126 @@
+/*
+ *  Parameter study: evaluate a design of SY variable values.
+ *
+ *  A study spec names the SY variables to vary and their ranges, and lays
+ *  them out as a full grid or as a Latin hypercube.  Every point of the
+ *  design is evaluated in this process through the worker pool, and each
+ *  streams out a row per frequency step of the variable values and the
+ *  chosen measurements, as CSV or as binary.
+ *
+ *  The spec is a GKeyFile, like the .opt file:
+ *
+ *    [study]
+ *    design=grid                 grid or lhs
+ *    points=200                  lhs: number of points
+ *    seed=1                      lhs: random seed (default 1)
+ *    measurements=mhz;vswr       columns to write (default all)
+ *    output=study.csv            .bin writes binary (default <spec>.csv)
+ *
+ *    [var LEN]
+ *    min=1.0
+ *    max=2.0
+ *    levels=11                   grid: values from min to max (default 2)
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#ifndef OPT_STUDY_H
+#define OPT_STUDY_H 1
+
+#include <glib.h>
+
+/** Layouts of the study points */
+enum opt_study_design
+{
+	OPT_STUDY_GRID,            /**< Every combination of the var levels */
+	OPT_STUDY_LHS,             /**< Latin hypercube of a number of points */
+
+	OPT_STUDY_DESIGN_COUNT
+};
+
+/** One varied SY symbol */
+typedef struct
+{
+	gchar *name;               /**< SY symbol name */
+	double min;                /**< First value */
+	double max;                /**< Last value, >= min */
+	int    levels;             /**< Grid values, min and max included */
+} opt_study_var_t;
+
+/** A parsed study spec and its design */
+typedef struct
+{
+	enum opt_study_design design;
+	int    seed;               /**< LHS seed */
+	int    num_points;         /**< Points in the design */
+
+	opt_study_var_t *vars;     /**< Varied symbols, in spec order */
+	int    num_vars;
+
+	gchar **measurements;      /**< Measurement names (NULL = all) */
+	gchar  *output;            /**< Output file */
+	gboolean binary;           /**< Write binary rather than CSV */
+
+	double *unit;              /**< LHS points in the unit cube [num_points * num_vars] */
+} opt_study_t;
+
+/**
+ * opt_study_load - read a study spec and lay out its design
+ * @path: spec file
+ *
+ * Returns the study, or NULL on error (message via pr_err).
+ */
+opt_study_t *opt_study_load(const char *path);
+
+/**
+ * opt_study_free - release a study
+ * @s: study (may be NULL)
+ */
+void opt_study_free(opt_study_t *s);
+
+/**
+ * opt_study_point - values of one point of the design
+ * @s: study
+ * @k: point index, 0 to num_points - 1
+ * @x: output [num_vars], in the order of s->vars
+ *
+ * Grid points run through the levels of the last var fastest, as nested
+ * loops in spec order would.
+ */
+void opt_study_point(const opt_study_t *s, int k, double *x);
+
+/**
+ * opt_study_start - run a parameter study of the loaded model
+ * @path: spec file
+ *
+ * Evaluates the points of the spec on a worker thread, streaming rows to
+ * its output as each batch of points completes, then quits xnec2c.
+ * Returns 0 when the study started, -1 on error.
+ */
+int opt_study_start(const char *path);
+
+/**
+ * opt_study_running - whether a study is in progress
+ */
+gboolean opt_study_running(void);
+
+/**
+ * opt_study_cancel - stop a study after the points in progress
+ *
+ * The rows written so far are kept, and the study still quits xnec2c.
+ */
+void opt_study_cancel(void);
+
+/**
+ * opt_study_shutdown - cancel a study and join its thread
+ *
+ * Exit-path teardown, safe when no study ran.
+ */
+void opt_study_shutdown(void);
+
+#endif
@@ -0,0 +1,519 @@
+/*
+ *  Parameter study - evaluation thread and row output.
+ *
+ *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ */
+
+#include <errno.h>
+#include <locale.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "opt_study.h"
+#include "../shared.h"
+#include "../sy_expr.h"
+#include "opt_nec2_eval.h"
+#include "opt_session.h"
+
+/** Binary output signature, followed by a byte-order word */
+#define OPT_STUDY_MAGIC      "XNSTDY1"
+#define OPT_STUDY_ORDER      0x01020304u
+
+/** Points handed to the workers at once, per worker */
+#define OPT_STUDY_BATCH_PER_JOB  4
+
+/* A study in progress */
+typedef struct
+{
+	opt_study_t *study;
+	FILE      *fp;
+	int       *cols;           /* Measurement columns (NULL = all) */
+	int        num_cols;
+	int        skip;           /* SOLVE_SKIP_* parts no column reads */
+	int        rows;           /* Rows written */
+	double    *row;            /* Binary row scratch */
+	pthread_t  thread;
+	gint       running;
+	gint       cancelled;
+} study_run_t;
+
+/* The study of this process; at most one runs */
+static study_run_t *active_run = NULL;
+
+/*------------------------------------------------------------------------*/
+
+/* Symbols sought by study_find_symbol */
+typedef struct
+{
+	const opt_study_t *study;
+	gboolean *found;
+} study_symbols_ctx_t;
+
+/**
+ * study_find_symbol - sy_foreach callback: mark the vars a symbol names
+ */
+static void study_find_symbol(const gchar *name, gdouble value,
+	gboolean is_calculated, const gchar *expression,
+	gdouble min_value, gdouble max_value,
+	gdouble override_value, gboolean override_active,
+	gboolean opt_active, gpointer user_data)
+{
+	study_symbols_ctx_t *ctx = user_data;
+
+	(void)value;
+	(void)expression;
+	(void)min_value;
+	(void)max_value;
+	(void)override_value;
+	(void)override_active;
+	(void)opt_active;
+
+	/* A calculated symbol takes no override */
+	if (is_calculated)
+	{
+		return;
+	}
+
+	/* The symbol table holds names upper-cased */
+	for (int d = 0; d < ctx->study->num_vars; d++)
+	{
+		if (g_ascii_strcasecmp(name, ctx->study->vars[d].name) == 0)
+		{
+			ctx->found[d] = TRUE;
+		}
+	}
+}
+
+/**
+ * study_check_symbols - check that every var names an SY symbol of the model
+ * @s: study
+ *
+ * Returns FALSE, naming the first var that does not, on a mismatch.
+ */
+static gboolean study_check_symbols(const opt_study_t *s)
+{
+	study_symbols_ctx_t ctx = { s, NULL };
+	gboolean ok = TRUE;
+
+	mem_array_alloc(&ctx.found, s->num_vars);
+	for (int d = 0; d < s->num_vars; d++)
+	{
+		ctx.found[d] = FALSE;
+	}
+
+	g_rec_mutex_lock(&freq_data_lock);
+	sy_foreach(study_find_symbol, &ctx);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	for (int d = 0; ok && d < s->num_vars; d++)
+	{
+		if (!ctx.found[d])
+		{
+			pr_err("opt_study: '%s' is not an SY symbol of %s\n",
+				s->vars[d].name, rc_config.input_file);
+			ok = FALSE;
+		}
+	}
+
+	mem_array_free(&ctx.found);
+
+	return ok;
+}
+
+/**
+ * study_resolve_columns - look up the measurement names of the study
+ * @run: study run
+ *
+ * Also works out the parts of each step no column reads: the near field
+ * always, and the far field unless a gain or pattern column is chosen.
+ *
+ * Returns FALSE on an unknown name.
+ */
+static gboolean study_resolve_columns(study_run_t *run)
+{
+	gchar **names = run->study->measurements;
+	int n = names ? (int)g_strv_length(names) : 0;
+
+	run->skip = SOLVE_SKIP_NEAREH;
+
+	if (n == 0)
+	{
+		run->num_cols = MEAS_COUNT;
+		return TRUE;
+	}
+
+	mem_array_alloc(&run->cols, n);
+	run->num_cols = n;
+	run->skip |= SOLVE_SKIP_RDPAT;
+
+	for (int c = 0; c < n; c++)
+	{
+		int i;
+
+		for (i = 0; i < MEAS_COUNT; i++)
+		{
+			if (g_strcmp0(meas_names[i], g_strstrip(names[c])) == 0)
+			{
+				break;
+			}
+		}
+
+		if (i == MEAS_COUNT)
+		{
+			pr_err("opt_study: unknown measurement '%s'\n", names[c]);
+			return FALSE;
+		}
+
+		run->cols[c] = i;
+
+		/* meas_calc() computes the fields from MEAS_GAIN_MAX on from
+		 * the pattern */
+		if (i >= MEAS_GAIN_MAX)
+		{
+			run->skip &= ~SOLVE_SKIP_RDPAT;
+		}
+	}
+
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * study_write_header - write the column names
+ * @run: study run, output open
+ *
+ * The columns are the point index, the vars, then the measurements.  The
+ * binary header is the signature, a byte-order word, the column count and
+ * each column name NUL-terminated; rows of that many doubles follow.
+ *
+ * Returns FALSE on a write error.
+ */
+static gboolean study_write_header(study_run_t *run)
+{
+	const opt_study_t *s = run->study;
+	FILE *fp = run->fp;
+
+	if (!s->binary)
+	{
+		fputs("point,", fp);
+		for (int d = 0; d < s->num_vars; d++)
+		{
+			fprintf(fp, "%s,", s->vars[d].name);
+		}
+		meas_write_header_cols(fp, ",", run->cols, run->num_cols);
+	}
+	else
+	{
+		char magic[8] = OPT_STUDY_MAGIC;
+		uint32_t order = OPT_STUDY_ORDER;
+		int32_t columns = 1 + s->num_vars + run->num_cols;
+
+		fwrite(magic, sizeof(magic), 1, fp);
+		fwrite(&order, sizeof(order), 1, fp);
+		fwrite(&columns, sizeof(columns), 1, fp);
+
+		fwrite("point", 6, 1, fp);
+		for (int d = 0; d < s->num_vars; d++)
+		{
+			fwrite(s->vars[d].name, strlen(s->vars[d].name) + 1, 1, fp);
+		}
+		for (int c = 0; c < run->num_cols; c++)
+		{
+			const char *name = meas_names[run->cols ? run->cols[c] : c];
+
+			fwrite(name, strlen(name) + 1, 1, fp);
+		}
+	}
+
+	return !ferror(fp);
+}
+
+/**
+ * study_write_point - write the rows of one evaluated point
+ * @run: study run
+ * @k: point index
+ * @x: the point's var values
+ * @meas: its measurements [steps]
+ * @steps: frequency steps measured
+ */
+static void study_write_point(study_run_t *run, int k, const double *x,
+	const measurement_t *meas, int steps)
+{
+	const opt_study_t *s = run->study;
+	double *row = run->row;
+
+	for (int i = 0; i < steps; i++)
+	{
+		if (!s->binary)
+		{
+			fprintf(run->fp, "%d,", k);
+			for (int d = 0; d < s->num_vars; d++)
+			{
+				fprintf(run->fp, "%.17g,", x[d]);
+			}
+			meas_write_row(run->fp, ",", &meas[i], run->cols, run->num_cols);
+		}
+		else
+		{
+			row[0] = k;
+			memcpy(&row[1], x, s->num_vars * sizeof(double));
+			for (int c = 0; c < run->num_cols; c++)
+			{
+				row[1 + s->num_vars + c] =
+					meas[i].a[run->cols ? run->cols[c] : c];
+			}
+			fwrite(row, sizeof(double), 1 + s->num_vars + run->num_cols,
+				run->fp);
+		}
+
+		run->rows++;
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * study_thread_func - evaluate the study points batch by batch
+ * @arg: the study run
+ *
+ * Each batch holds a few points per worker, so the workers stay busy while
+ * the rows of a finished batch stream out.  The numeric locale is set for
+ * this thread only, so the GUI keeps its own.
+ */
+static void *study_thread_func(void *arg)
+{
+	study_run_t *run = arg;
+	const opt_study_t *s = run->study;
+	int batch = OPT_STUDY_BATCH_PER_JOB * MAX(calc_data.num_jobs, 1);
+	int nv = s->num_vars;
+	simple_var_t *sets = NULL;
+	simple_var_t **ptrs = NULL;
+	measurement_t *meas = NULL;
+	double *x = NULL;
+	locale_t c_locale;
+	locale_t prev_locale;
+	int width;
+	int done = 0;
+
+	c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+	prev_locale = uselocale(c_locale);
+
+	g_rec_mutex_lock(&freq_data_lock);
+	width = MIN(MAX(calc_data.steps_total, 1), OPT_MAX_FREQ_STEPS);
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	batch = MIN(batch, s->num_points);
+	mem_array_alloc(&sets, (size_t)batch * nv);
+	mem_array_alloc(&ptrs, batch);
+	mem_array_alloc(&meas, (size_t)batch * width);
+	mem_array_alloc(&x, (size_t)batch * nv);
+
+	for (int k = 0; k < batch; k++)
+	{
+		ptrs[k] = &sets[k * nv];
+		for (int d = 0; d < nv; d++)
+		{
+			memset(&sets[k * nv + d], 0, sizeof(simple_var_t));
+			sets[k * nv + d].name = s->vars[d].name;
+			sets[k * nv + d].values = gsl_vector_alloc(1);
+		}
+	}
+
+	nec2_eval_init();
+	nec2_eval_set_scope(NULL, 0, run->skip);
+
+	pr_notice("opt_study: %d points of %d vars to %s%s\n", s->num_points, nv,
+		s->output, (run->skip & SOLVE_SKIP_RDPAT) ? ", without the pattern" : "");
+
+	while (done < s->num_points && !g_atomic_int_get(&run->cancelled))
+	{
+		int n = MIN(batch, s->num_points - done);
+		int steps;
+
+		for (int k = 0; k < n; k++)
+		{
+			opt_study_point(s, done + k, &x[k * nv]);
+			for (int d = 0; d < nv; d++)
+			{
+				gsl_vector_set(sets[k * nv + d].values, 0, x[k * nv + d]);
+			}
+		}
+
+		steps = nec2_eval_batch(ptrs, n, nv, meas, width, NULL);
+		if (steps < 0)
+		{
+			pr_err("opt_study: points %d to %d failed to evaluate\n",
+				done, done + n - 1);
+			break;
+		}
+
+		for (int k = 0; k < n; k++)
+		{
+			study_write_point(run, done + k, &x[k * nv],
+				&meas[k * width], steps);
+		}
+		fflush(run->fp);
+
+		done += n;
+		pr_info("opt_study: %d of %d points\n", done, s->num_points);
+	}
+
+	nec2_eval_cleanup();
+
+	pr_notice("opt_study: %d of %d points, %d rows written to %s\n",
+		done, s->num_points, run->rows, s->output);
+
+	for (int k = 0; k < batch * nv; k++)
+	{
+		gsl_vector_free(sets[k].values);
+	}
+	mem_array_free(&sets);
+	mem_array_free(&ptrs);
+	mem_array_free(&meas);
+	mem_array_free(&x);
+
+	uselocale(prev_locale);
+	freelocale(c_locale);
+
+	if (fclose(run->fp) != 0)
+	{
+		pr_err("opt_study: %s: %s\n", s->output, g_strerror(errno));
+	}
+	run->fp = NULL;
+
+	/* A study ends the session whether it completed or was cancelled;
+	 * a pending interactive quit completes here too */
+	g_atomic_int_set(&run->running, FALSE);
+	g_idle_add_once((GSourceOnceFunc)xnec2c_quit, NULL);
+
+	return NULL;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * study_run_free - release a study run whose thread is not running
+ * @run: study run (may be NULL)
+ */
+static void study_run_free(study_run_t *run)
+{
+	if (run == NULL)
+	{
+		return;
+	}
+
+	if (run->fp != NULL)
+	{
+		fclose(run->fp);
+	}
+	opt_study_free(run->study);
+	mem_array_free(&run->cols);
+	mem_array_free(&run->row);
+	mem_free(&run);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_start - run a parameter study of the loaded model
+ */
+int opt_study_start(const char *path)
+{
+	study_run_t *run = NULL;
+	int ret;
+
+	if (active_run != NULL)
+	{
+		pr_err("opt_study_start: a study already ran\n");
+		return -1;
+	}
+
+	mem_new(&run);
+	run->study = opt_study_load(path);
+	if (run->study == NULL
+		|| !study_check_symbols(run->study)
+		|| !study_resolve_columns(run))
+	{
+		study_run_free(run);
+		return -1;
+	}
+
+	mem_array_alloc(&run->row, 1 + run->study->num_vars + run->num_cols);
+
+	run->fp = fopen(run->study->output, run->study->binary ? "wb" : "w");
+	if (run->fp == NULL)
+	{
+		pr_err("opt_study: %s: %s\n", run->study->output, g_strerror(errno));
+		study_run_free(run);
+		return -1;
+	}
+
+	if (!study_write_header(run))
+	{
+		pr_err("opt_study: %s: write failed\n", run->study->output);
+		study_run_free(run);
+		return -1;
+	}
+
+	g_atomic_int_set(&run->running, TRUE);
+
+	ret = pthread_create(&run->thread, NULL, study_thread_func, run);
+	if (ret != 0)
+	{
+		pr_err("opt_study_start: pthread_create failed: %d\n", ret);
+		study_run_free(run);
+		return -1;
+	}
+
+	active_run = run;
+
+	return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_running - whether a study is in progress
+ */
+gboolean opt_study_running(void)
+{
+	return active_run != NULL && g_atomic_int_get(&active_run->running);
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_cancel - stop a study after the points in progress
+ */
+void opt_study_cancel(void)
+{
+	if (active_run != NULL)
+	{
+		g_atomic_int_set(&active_run->cancelled, TRUE);
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * opt_study_shutdown - cancel a study and join its thread
+ */
+void opt_study_shutdown(void)
+{
+	if (active_run == NULL)
+	{
+		return;
+	}
+
+	opt_study_cancel();
+	pthread_join(active_run->thread, NULL);
+	study_run_free(active_run);
+	active_run = NULL;
+}
@@ -19,6 +19,7 @@ typedef double             (*opt_optimize_fn)(void *);
 typedef const gsl_vector * (*opt_get_pos_fn)(const void *);
 typedef double             (*opt_get_fit_fn)(const void *);
 typedef int                (*opt_get_iter_fn)(const void *);
+typedef const gsl_matrix * (*opt_get_mat_fn)(const void *);
 typedef void               (*opt_free_fn)(void *);
 
 /** Full dispatch state */
@@ -31,6 +32,8 @@ struct optimizer_s
 	opt_get_pos_fn  get_best_pos;
 	opt_get_fit_fn  get_best_fit;
 	opt_get_iter_fn get_iteration_count;
+	opt_get_mat_fn  get_population;  /**< NULL when the backend has none */
+	opt_get_mat_fn  get_velocity;    /**< NULL when the backend has none */
 	opt_free_fn     free_fn;
 };
 
@@ -40,14 +43,30 @@ static double _simplex_optimize(void *p)        { return simplex_optimize(p); }
 static const gsl_vector *_simplex_get_pos(const void *p)  { return simplex_get_best_pos(p); }
 static double _simplex_get_fit(const void *p)   { return simplex_get_best_fit(p); }
 static int    _simplex_get_iter(const void *p)  { return simplex_get_iteration_count(p); }
+static const gsl_matrix *_simplex_get_popul(const void *p) { return simplex_get_vertices(p); }
 static void   _simplex_free(void *p)            { simplex_free(p); }
 
 static double _pso_optimize(void *p)            { return pso_optimize(p); }
 static const gsl_vector *_pso_get_pos(const void *p)      { return pso_get_best_pos(p); }
 static double _pso_get_fit(const void *p)       { return pso_get_best_fit(p); }
 static int    _pso_get_iter(const void *p)      { return pso_get_iteration_count(p); }
+static const gsl_matrix *_pso_get_popul(const void *p)     { return pso_get_positions(p); }
+static const gsl_matrix *_pso_get_vel(const void *p)       { return pso_get_velocities(p); }
 static void   _pso_free(void *p)                { pso_free(p); }
 
+static double _bayes_optimize(void *p)          { return bayes_optimize(p); }
+static const gsl_vector *_bayes_get_pos(const void *p)    { return bayes_get_best_pos(p); }
+static double _bayes_get_fit(const void *p)     { return bayes_get_best_fit(p); }
+static int    _bayes_get_iter(const void *p)    { return bayes_get_iteration_count(p); }
+static void   _bayes_free(void *p)              { bayes_free(p); }
+
+static double _cmaes_optimize(void *p)          { return cmaes_optimize(p); }
+static const gsl_vector *_cmaes_get_pos(const void *p)    { return cmaes_get_best_pos(p); }
+static double _cmaes_get_fit(const void *p)     { return cmaes_get_best_fit(p); }
+static int    _cmaes_get_iter(const void *p)    { return cmaes_get_iteration_count(p); }
+static const gsl_matrix *_cmaes_get_popul(const void *p)   { return cmaes_get_population(p); }
+static void   _cmaes_free(void *p)              { cmaes_free(p); }
+
 /**
  * optimizer_new_simplex - create dispatch handle wrapping simplex backend
  * @cfg: simplex configuration
@@ -74,6 +93,7 @@ optimizer_t *optimizer_new_simplex(const simplex_config_t *cfg)
 	o->get_best_pos        = _simplex_get_pos;
 	o->get_best_fit        = _simplex_get_fit;
 	o->get_iteration_count = _simplex_get_iter;
+	o->get_population      = _simplex_get_popul;
 	o->free_fn             = _simplex_free;
 
 	return o;
@@ -105,11 +125,76 @@ optimizer_t *optimizer_new_pso(const pso_config_t *cfg)
 	o->get_best_pos        = _pso_get_pos;
 	o->get_best_fit        = _pso_get_fit;
 	o->get_iteration_count = _pso_get_iter;
+	o->get_population      = _pso_get_popul;
+	o->get_velocity        = _pso_get_vel;
 	o->free_fn             = _pso_free;
 
 	return o;
 }
 
+/**
+ * optimizer_new_bayes - create dispatch handle wrapping Bayesian backend
+ * @cfg: Bayesian configuration
+ */
+optimizer_t *optimizer_new_bayes(const bayes_config_t *cfg)
+{
+	bayes_t *b = bayes_new(cfg);
+	if (!b)
+	{
+		return NULL;
+	}
+
+	optimizer_t *o = NULL;
+	mem_new(&o);
+	if (!o)
+	{
+		bayes_free(b);
+		return NULL;
+	}
+
+	o->algo = OPT_BAYES;
+	o->impl = b;
+	o->optimize            = _bayes_optimize;
+	o->get_best_pos        = _bayes_get_pos;
+	o->get_best_fit        = _bayes_get_fit;
+	o->get_iteration_count = _bayes_get_iter;
+	o->free_fn             = _bayes_free;
+
+	return o;
+}
+
+/**
+ * optimizer_new_cmaes - create dispatch handle wrapping CMA-ES backend
+ * @cfg: CMA-ES configuration
+ */
+optimizer_t *optimizer_new_cmaes(const cmaes_config_t *cfg)
+{
+	cmaes_t *c = cmaes_new(cfg);
+	if (!c)
+	{
+		return NULL;
+	}
+
+	optimizer_t *o = NULL;
+	mem_new(&o);
+	if (!o)
+	{
+		cmaes_free(c);
+		return NULL;
+	}
+
+	o->algo = OPT_CMAES;
+	o->impl = c;
+	o->optimize            = _cmaes_optimize;
+	o->get_best_pos        = _cmaes_get_pos;
+	o->get_best_fit        = _cmaes_get_fit;
+	o->get_iteration_count = _cmaes_get_iter;
+	o->get_population      = _cmaes_get_popul;
+	o->free_fn             = _cmaes_free;
+
+	return o;
+}
+
 /** optimizer_optimize - delegate to backend */
 double optimizer_optimize(optimizer_t *o)
 {
@@ -134,6 +219,18 @@ int optimizer_get_iteration_count(const optimizer_t *o)
 	return o->get_iteration_count(o->impl);
 }
 
+/** optimizer_get_population - delegate to backend, NULL if it has none */
+const gsl_matrix *optimizer_get_population(const optimizer_t *o)
+{
+	return o->get_population ? o->get_population(o->impl) : NULL;
+}
+
+/** optimizer_get_velocity - delegate to backend, NULL if it has none */
+const gsl_matrix *optimizer_get_velocity(const optimizer_t *o)
+{
+	return o->get_velocity ? o->get_velocity(o->impl) : NULL;
+}
+
 /**
  * optimizer_free - release dispatch handle and underlying backend
  * @o: handle (NULL safe)
@@ -1,7 +1,7 @@
 /*
  *  Unified optimizer dispatch layer.
  *
- *  Wraps simplex_t and pso_t behind a common vtable so callers
+ *  Wraps simplex_t, pso_t, bayes_t and cmaes_t behind a common vtable so callers
  *  can switch algorithms without changing call sites.
  *
  *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
@@ -15,16 +15,21 @@
 #ifndef OPTIMIZER_H
 #define OPTIMIZER_H 1
 
+#include <gsl/gsl_matrix.h>
 #include <gsl/gsl_vector.h>
 
 #include "simplex.h"
 #include "particleswarm.h"
+#include "bayesopt.h"
+#include "cmaes.h"
 
 /** Algorithm selector */
 enum optimizer_algo
 {
 	OPT_SIMPLEX,
-	OPT_PSO
+	OPT_PSO,
+	OPT_BAYES,
+	OPT_CMAES
 };
 
 /** Opaque optimizer handle */
@@ -46,6 +51,22 @@ optimizer_t *optimizer_new_simplex(const simplex_config_t *cfg);
  */
 optimizer_t *optimizer_new_pso(const pso_config_t *cfg);
 
+/**
+ * optimizer_new_bayes - wrap a Bayesian backend
+ * @cfg: Bayesian configuration (deep-copied by bayes_new)
+ *
+ * Returns NULL if bayes_new rejects the config.
+ */
+optimizer_t *optimizer_new_bayes(const bayes_config_t *cfg);
+
+/**
+ * optimizer_new_cmaes - wrap a CMA-ES backend
+ * @cfg: CMA-ES configuration (deep-copied by cmaes_new)
+ *
+ * Returns NULL if cmaes_new rejects the config.
+ */
+optimizer_t *optimizer_new_cmaes(const cmaes_config_t *cfg);
+
 /**
  * optimizer_optimize - run the optimization loop
  * @o: optimizer handle
@@ -74,6 +95,24 @@ double optimizer_get_best_fit(const optimizer_t *o);
  */
 int optimizer_get_iteration_count(const optimizer_t *o);
 
+/**
+ * optimizer_get_population - return the backend's working points
+ * @o: optimizer handle
+ *
+ * Simplex vertices, particle positions or the last CMA-ES generation,
+ * one point per column.  NULL for the Bayesian backend, whose state is
+ * its evaluation history.  Owned by the backend; do not free.
+ */
+const gsl_matrix *optimizer_get_population(const optimizer_t *o);
+
+/**
+ * optimizer_get_velocity - return the particle velocities
+ * @o: optimizer handle
+ *
+ * Same layout as optimizer_get_population(); NULL unless PSO.
+ */
+const gsl_matrix *optimizer_get_velocity(const optimizer_t *o);
+
 /**
  * optimizer_free - release optimizer and underlying backend
  * @o: optimizer handle (NULL safe)
@@ -158,7 +158,8 @@ pso_t *pso_new(const pso_config_t *config)
 
 	pso->best_best_pos = gsl_vector_alloc(d);
 	pso->rng = gsl_rng_alloc(gsl_rng_mt19937);
-	gsl_rng_set(pso->rng, (unsigned long)time(NULL));
+	gsl_rng_set(pso->rng, pso->config.seed != 0
+		? pso->config.seed : (unsigned long)time(NULL));
 
 	/* Plateau circular buffer */
 	if (pso->config.exit_plateau)
@@ -328,6 +329,18 @@ int pso_get_iteration_count(const pso_t *pso)
 	return pso->iter_count;
 }
 
+/** pso_get_positions - return particle positions, NULL before pso_init */
+const gsl_matrix *pso_get_positions(const pso_t *pso)
+{
+	return pso->prtcls ? pso->prtcls->curr_pos : NULL;
+}
+
+/** pso_get_velocities - return particle velocities, NULL before pso_init */
+const gsl_matrix *pso_get_velocities(const pso_t *pso)
+{
+	return pso->prtcls ? pso->prtcls->velocity : NULL;
+}
+
 /**
  * pso_free - release all resources
  * @pso: optimizer handle (may be NULL)
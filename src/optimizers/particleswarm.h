@@ -22,6 +22,7 @@
 #ifndef PARTICLESWARM_H
 #define PARTICLESWARM_H 1
 
+#include <gsl/gsl_matrix.h>
 #include <gsl/gsl_vector.h>
 
 /** Default particles-per-dimension when num_particles is zero */
@@ -38,6 +39,14 @@ enum pso_log_flags
 /** Fitness function: returns scalar fitness for a position vector */
 typedef double (*pso_fit_func_t)(const gsl_vector *pos, void *ctx);
 
+/**
+ * Batch fitness function: fills fit[i] for each column i of pos
+ * [dimensions x n].  Columns are independent, so the callee may evaluate
+ * them concurrently; results are matched to columns by index alone.
+ */
+typedef void (*pso_fit_batch_func_t)(const gsl_matrix *pos, gsl_vector *fit,
+	void *ctx);
+
 /** Log callback: called after each iteration with current best */
 typedef void (*pso_log_func_t)(const gsl_vector *pos, double fit, void *ctx);
 
@@ -76,6 +85,9 @@ typedef struct
 
 	pso_fit_func_t fit_func;   /**< Required: fitness evaluation function */
 	void *fit_func_ctx;        /**< Opaque context passed to fit_func */
+	pso_fit_batch_func_t fit_func_batch; /**< Optional: evaluates a population at once, ctx is fit_func_ctx */
+
+	unsigned long seed;        /**< RNG seed (0 = seed from the clock) */
 
 	pso_log_func_t log_func;   /**< Optional: called each iteration with best state */
 	void *log_func_ctx;        /**< Opaque context passed to log_func */
@@ -107,6 +119,12 @@ double pso_get_best_fit(const pso_t *pso);
 /** Return total iterations performed across all optimize() calls. */
 int pso_get_iteration_count(const pso_t *pso);
 
+/** Return particle positions [dimensions x num_particles] (owned by pso_t). */
+const gsl_matrix *pso_get_positions(const pso_t *pso);
+
+/** Return particle velocities [dimensions x num_particles] (owned by pso_t). */
+const gsl_matrix *pso_get_velocities(const pso_t *pso);
+
 /** Free optimizer and all associated memory. */
 void pso_free(pso_t *pso);
 
@@ -50,6 +50,39 @@ double pso_calc_fit(const pso_t *pso, const gsl_vector *pos)
 	return f;
 }
 
+/**
+ * pso_calc_fit_batch - evaluate a population, converting NaN to INFINITY
+ * @pso: optimizer
+ * @pos: positions, one per column [dimensions x n]
+ * @fit: output fitness [n]
+ *
+ * Every caller fixes its positions, and draws all of its random numbers,
+ * before evaluating, so a batch evaluation yields the same fitness vector
+ * as evaluating the columns one at a time, in any completion order.
+ */
+void pso_calc_fit_batch(const pso_t *pso, const gsl_matrix *pos, gsl_vector *fit)
+{
+	if (pso->config.fit_func_batch)
+	{
+		pso->config.fit_func_batch(pos, fit, pso->config.fit_func_ctx);
+
+		for (size_t i = 0; i < fit->size; i++)
+		{
+			if (isnan(gsl_vector_get(fit, i)))
+			{
+				gsl_vector_set(fit, i, INFINITY);
+			}
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < pos->size2; i++)
+	{
+		gsl_vector_const_view col = gsl_matrix_const_column(pos, i);
+		gsl_vector_set(fit, i, pso_calc_fit(pso, &col.vector));
+	}
+}
+
 /**
  * pso_get_best_neighbour - find neighbor with lowest bestFit
  * @pso: optimizer
@@ -84,6 +117,7 @@ int pso_get_best_neighbour(const pso_t *pso, int me)
  *
  * For each particle: nextPos = currPos + velocity, then clip to bounds
  * and zero the velocity component for any dimension that hit a wall.
+ * The whole population is then evaluated as one batch.
  */
 void pso_calc_next_pos(pso_t *pso)
 {
@@ -115,10 +149,9 @@ void pso_calc_next_pos(pso_t *pso)
 			}
 			gsl_matrix_set(p->next_pos, d, i, pos);
 		}
-
-		gsl_vector_const_view col = gsl_matrix_const_column(p->next_pos, i);
-		gsl_vector_set(p->next_fit, i, pso_calc_fit(pso, &col.vector));
 	}
+
+	pso_calc_fit_batch(pso, p->next_pos, p->next_fit);
 }
 
 /**
@@ -127,13 +160,17 @@ void pso_calc_next_pos(pso_t *pso)
  * @mask: vector of length numParticles; 1.0 = reinitialize, 0.0 = skip
  *
  * Sets bestPos, currPos, velocity, and evaluates currFit and bestFit
- * for each active particle.  Increments stall counters.
+ * for each active particle.  Increments stall counters.  Positions are
+ * drawn for every active particle first; the fitness evaluations then run
+ * as one batch in the order the particles would have evaluated them.
  */
 void pso_init_particles(pso_t *pso, const gsl_vector *mask)
 {
 	int dims = pso->config.dimensions;
 	int np = pso->config.num_particles;
 	pso_particles_t *p = pso->prtcls;
+	int first = (pso->iter_count == 0);
+	int count = 0;
 
 	for (int i = 0; i < np; i++)
 	{
@@ -214,18 +251,59 @@ void pso_init_particles(pso_t *pso, const gsl_vector *mask)
 			gsl_matrix_set(p->velocity, d, i, vel);
 		}
 
-		/* Evaluate fitness */
+		/* currFit, and bestFit on first init; stall reinit preserves it */
+		count += first ? 2 : 1;
+	}
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	/* Gather the positions to evaluate: currPos, then bestPos on first
+	 * init, particle by particle */
+	gsl_matrix *batch_pos = gsl_matrix_alloc(dims, count);
+	gsl_vector *batch_fit = gsl_vector_alloc(count);
+	int col = 0;
+
+	for (int i = 0; i < np; i++)
+	{
+		if (gsl_vector_get(mask, i) < 0.5)
+		{
+			continue;
+		}
+
 		gsl_vector_const_view curr_col = gsl_matrix_const_column(p->curr_pos, i);
-		gsl_vector_set(p->curr_fit, i, pso_calc_fit(pso, &curr_col.vector));
+		gsl_matrix_set_col(batch_pos, col++, &curr_col.vector);
 
-		/* Only evaluate bestFit on first init; stall reinit preserves it */
-		if (pso->iter_count == 0)
+		if (first)
 		{
 			gsl_vector_const_view best_col = gsl_matrix_const_column(p->best_pos, i);
-			gsl_vector_set(p->best_fit, i, pso_calc_fit(pso, &best_col.vector));
+			gsl_matrix_set_col(batch_pos, col++, &best_col.vector);
+		}
+	}
+
+	pso_calc_fit_batch(pso, batch_pos, batch_fit);
+
+	/* Scatter the results back in the same order */
+	col = 0;
+	for (int i = 0; i < np; i++)
+	{
+		if (gsl_vector_get(mask, i) < 0.5)
+		{
+			continue;
+		}
+
+		gsl_vector_set(p->curr_fit, i, gsl_vector_get(batch_fit, col++));
+
+		if (first)
+		{
+			gsl_vector_set(p->best_fit, i, gsl_vector_get(batch_fit, col++));
 		}
 	}
 
+	gsl_matrix_free(batch_pos);
+	gsl_vector_free(batch_fit);
 }
 
 /**
@@ -68,6 +68,10 @@ void pso_update_velocities(pso_t *pso, int iter);
 /** Evaluate fitness for one position, converting NaN to INFINITY */
 double pso_calc_fit(const pso_t *pso, const gsl_vector *pos);
 
+/** Evaluate fitness for each column of pos into fit, converting NaN to
+ *  INFINITY.  Uses fit_func_batch when set, else fit_func column by column. */
+void pso_calc_fit_batch(const pso_t *pso, const gsl_matrix *pos, gsl_vector *fit);
+
 /** Return index of best-fit neighbor for particle me */
 int pso_get_best_neighbour(const pso_t *pso, int me);
 
@@ -455,6 +455,18 @@ int simplex_get_iteration_count(const simplex_t *s)
 	return s->iter_count;
 }
 
+/**
+ * simplex_get_vertices - return the current simplex
+ * @s: optimizer handle
+ *
+ * Returns the vertices [dims x (dims+1)], one per column (owned by
+ * simplex_t, do not free).
+ */
+const gsl_matrix *simplex_get_vertices(const simplex_t *s)
+{
+	return s->simp;
+}
+
 /**
  * simplex_free - release all resources
  * @s: optimizer handle (may be NULL)
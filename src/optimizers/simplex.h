@@ -95,6 +95,9 @@ double simplex_get_simplex_size(const simplex_t *s);
 /** Return total iterations performed across all optimize() calls. */
 int simplex_get_iteration_count(const simplex_t *s);
 
+/** Return the simplex vertices, one per column (owned by simplex_t). */
+const gsl_matrix *simplex_get_vertices(const simplex_t *s);
+
 /** Free optimizer and all associated memory. */
 void simplex_free(simplex_t *s);
 
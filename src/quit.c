@@ -42,6 +42,10 @@
  *      fires its generic completion notifier; opt_finished (opt_ui_session.c),
  *      the registered on_complete handler, resolves the pending quit via
  *      xnec2c_quit_if_pending() -> xnec2c_quit().
+ *    study   -> opt_study_cancel(); return.  A parameter study (--study)
+ *      always quits when its thread ends, so it completes the quit itself.
+ *    sensitivity -> return.  Its one batch cannot be cut short; the
+ *      completion handler resolves the pending quit as opt_finished does.
  *    idle    -> Stop_Frequency_Loop(); xnec2c_quit(NULL) at once.
  *
  *  Worker completion is event-based, never polled.  The worker fires
@@ -61,6 +65,8 @@
 
 #include "shared.h"
 #include "optimizers/opt_session.h"
+#include "optimizers/opt_sensitivity.h"
+#include "optimizers/opt_study.h"
 
 /*-----------------------------------------------------------------------*/
 
@@ -121,6 +127,17 @@ xnec2c_request_quit( void )
     return;
   }
 
+  /* A parameter study quits by itself once its points in flight land */
+  if( opt_study_running() )
+  {
+    opt_study_cancel();
+    return;
+  }
+
+  /* A sensitivity run resolves the quit once its batch lands */
+  if( opt_sensitivity_running() )
+    return;
+
   Stop_Frequency_Loop();
   xnec2c_quit( NULL );
 
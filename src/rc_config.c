@@ -833,6 +833,9 @@ rc_config_vars_t rc_config_vars[] = {
 		.widgets = CONFIG_WIDGET_TREE( .post_apply = hook_theme_change,
 			.groups = CONFIG_WIDGET_GROUPS( NULL ) ) },
 
+	{ .desc = "Speculative Pre-solve Steps", .format = "%d",
+		.vars = { &rc_config.freq_spec_steps }, .def = { { .i = 8 } } },
+
 };
 
 
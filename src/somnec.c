@@ -73,6 +73,21 @@ static complex double *t01 = NULL, *t10 = NULL, *t20 = NULL;
 static complex double *q1 = NULL, *q2 = NULL, *ans1 = NULL, *ans2 = NULL;
 static complex double *sum = NULL, *ans = NULL;
 
+/* Grids already computed, keyed by the complex dielectric constant.  The
+ * grid depends on nothing else, so a sweep repeated over the same ground
+ * (an optimizer candidate, a perturbed model of a sensitivity run) finds
+ * every step's grid here rather than integrating it again.  Entries are
+ * replaced round-robin once the table fills. */
+#define SOMNEC_CACHE_SIZE  128
+#define SOMNEC_AR1_SIZE    (11 * 10 * 4)
+#define SOMNEC_AR2_SIZE    (17 * 5 * 4)
+#define SOMNEC_AR3_SIZE    (9 * 8 * 4)
+#define SOMNEC_GRID_SIZE   (SOMNEC_AR1_SIZE + SOMNEC_AR2_SIZE + SOMNEC_AR3_SIZE)
+
+static complex double  grid_cache_epscf[SOMNEC_CACHE_SIZE];
+static complex double *grid_cache = NULL;
+static int grid_cache_used = 0, grid_cache_next = 0;
+
 /* ggrid_free()
  *
  * Releases the Sommerfeld interpolation-grid tables built by somnec().
@@ -89,6 +104,8 @@ ggrid_free( void )
   mem_array_free( &ggrid.dya );
   mem_array_free( &ggrid.xsa );
   mem_array_free( &ggrid.ysa );
+  mem_array_free( &grid_cache );
+  grid_cache_used = grid_cache_next = 0;
 
 } /* ggrid_free() */
 
@@ -955,6 +972,66 @@ evlua( complex double *erv, complex double *ezv,
 
 /*-----------------------------------------------------------------------*/
 
+/* grid_cache_find()
+ *
+ * Copies the cached grid computed for ggrid.epscf into ggrid.ar1..ar3.
+ * Returns TRUE on a hit.
+ */
+  static gboolean
+grid_cache_find( void )
+{
+  int idx;
+  complex double *grid;
+
+  for( idx = 0; idx < grid_cache_used; idx++ )
+  {
+    if( grid_cache_epscf[idx] != ggrid.epscf )
+      continue;
+
+    grid = &grid_cache[idx * SOMNEC_GRID_SIZE];
+    memcpy( ggrid.ar1, grid, SOMNEC_AR1_SIZE * sizeof(complex double) );
+    grid += SOMNEC_AR1_SIZE;
+    memcpy( ggrid.ar2, grid, SOMNEC_AR2_SIZE * sizeof(complex double) );
+    grid += SOMNEC_AR2_SIZE;
+    memcpy( ggrid.ar3, grid, SOMNEC_AR3_SIZE * sizeof(complex double) );
+
+    return( TRUE );
+  }
+
+  return( FALSE );
+
+} /* grid_cache_find() */
+
+/* grid_cache_store()
+ *
+ * Keeps the grid just computed for ggrid.epscf.
+ */
+  static void
+grid_cache_store( void )
+{
+  int idx;
+  complex double *grid;
+
+  if( grid_cache == NULL )
+    mem_array_alloc( &grid_cache, SOMNEC_CACHE_SIZE * SOMNEC_GRID_SIZE );
+
+  idx = grid_cache_next;
+  grid_cache_next = (grid_cache_next + 1) % SOMNEC_CACHE_SIZE;
+  if( grid_cache_used < SOMNEC_CACHE_SIZE )
+    grid_cache_used++;
+
+  grid_cache_epscf[idx] = ggrid.epscf;
+  grid = &grid_cache[idx * SOMNEC_GRID_SIZE];
+  memcpy( grid, ggrid.ar1, SOMNEC_AR1_SIZE * sizeof(complex double) );
+  grid += SOMNEC_AR1_SIZE;
+  memcpy( grid, ggrid.ar2, SOMNEC_AR2_SIZE * sizeof(complex double) );
+  grid += SOMNEC_AR2_SIZE;
+  memcpy( grid, ggrid.ar3, SOMNEC_AR3_SIZE * sizeof(complex double) );
+
+} /* grid_cache_store() */
+
+/*-----------------------------------------------------------------------*/
+
 /* This is the "main" of somnec */
   void
 somnec( double epr, double sig, double fmhz )
@@ -968,9 +1045,9 @@ somnec( double epr, double sig, double fmhz )
   if( first_call )
   {
     first_call = FALSE;
-    mem_array_alloc(&ggrid.ar1, 11 * 10 * 4);
-    mem_array_alloc(&ggrid.ar2, 17 * 5 * 4);
-    mem_array_alloc(&ggrid.ar3, 9 * 8 * 4);
+    mem_array_alloc(&ggrid.ar1, SOMNEC_AR1_SIZE);
+    mem_array_alloc(&ggrid.ar2, SOMNEC_AR2_SIZE);
+    mem_array_alloc(&ggrid.ar3, SOMNEC_AR3_SIZE);
 
     int nrec = 3;
     mem_array_alloc(&ggrid.nxa, nrec);
@@ -1015,6 +1092,9 @@ somnec( double epr, double sig, double fmhz )
   }
   else ggrid.epscf=cmplx(epr,sig);
 
+  if( grid_cache_find() )
+    return;
+
   ck2=M_2PI;
   ck2sq=ck2*ck2;
 
@@ -1135,6 +1215,8 @@ somnec( double epr, double sig, double fmhz )
     ggrid.ar1[0+ith*11+330]=eph;
   }
 
+  grid_cache_store();
+
   return;
 }
 
@@ -0,0 +1,475 @@
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  The official website and doumentation for xnec2c is available here:
+ *    https://www.xnec2c.org/
+ */
+
+#include "shared.h"
+#include "sy_expr.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* Persistent sweep results (--sweep-archive).  Every step a sweep solves
+ * is appended to <input-file-name>.sweep as one record: its frequency and
+ * the step's transfer blob (see Pack_Freq_Blob()), which holds all of the
+ * step's currents, impedances, pattern, near field and structure colors.
+ * When a sweep starts, the archive is mapped and every step whose
+ * frequency it holds is copied out of the mapping into its slot instead of
+ * being solved, so reopening a model that was swept before shows the
+ * sweep at once.  Only the pages of the records a sweep reads are faulted
+ * in, and a green-line selection the archive holds is answered the same way.
+ *
+ *   header:  magic, version, byte order, key, blob length
+ *   record:  frequency, blob length, blob        (repeated, appended)
+ *
+ * The key hashes the deck text as parsed and every symbol value with its
+ * override, which sweep_archive_model() records after each load, together
+ * with the blob length, which follows the pattern and near-field flags.
+ * An archive written under another key is emptied and restarted, so one
+ * file follows the deck it sits beside.  A record cut short by a crash is
+ * ignored, and the next append overwrites it.
+ *
+ * Archive state is guarded by freq_data_lock.  Optimizer evaluations and
+ * reduced sweeps neither read nor write the archive. */
+
+#define SWEEP_ARCHIVE_MAGIC    "XNECSWP"
+#define SWEEP_ARCHIVE_VERSION  1
+#define SWEEP_ARCHIVE_ORDER    0x01020304u
+#define SWEEP_ARCHIVE_KEY_LEN  32
+
+typedef struct
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t order;        /* SWEEP_ARCHIVE_ORDER as written */
+  guint8   key[SWEEP_ARCHIVE_KEY_LEN];
+  uint64_t blob_len;     /* Freq_Data_Size() of every record */
+  uint64_t reserved;
+} sweep_archive_header_t;
+
+typedef struct
+{
+  double   freq_mhz;
+  uint64_t blob_len;
+} sweep_archive_record_t;
+
+/* A record of the open archive, kept in frequency order */
+typedef struct
+{
+  double freq_mhz;
+  off_t  off;            /* Offset of the record's blob */
+} sweep_archive_entry_t;
+
+static struct
+{
+  /* Model of the last load; valid only after a file load */
+  guint8   model[SWEEP_ARCHIVE_KEY_LEN];
+  gboolean model_valid;
+
+  /* The archive of the current sweep; fd < 0 when none is open */
+  int      fd;
+  char     path[FILENAME_LEN + 8];
+  size_t   blob_len;
+  off_t    end;          /* Append offset */
+
+  const unsigned char *map;    /* Records present at sweep start */
+  size_t   map_len;
+
+  sweep_archive_entry_t *entries;
+  int      count;
+
+  char    *blob;         /* Scratch of blob_len bytes */
+} arch = { .fd = -1 };
+
+/*-----------------------------------------------------------------------*/
+
+/* Index of the first entry at or above fmhz, less FREQ_EPSILON_MHZ */
+  static int
+sweep_archive_lower( double fmhz )
+{
+  int lo = 0, hi = arch.count;
+
+  while( lo < hi )
+  {
+    int mid = (lo + hi) / 2;
+
+    if( arch.entries[mid].freq_mhz < fmhz - FREQ_EPSILON_MHZ )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return( lo );
+}
+
+/* Returns the entry of fmhz, or NULL */
+  static sweep_archive_entry_t *
+sweep_archive_find( double fmhz )
+{
+  int idx = sweep_archive_lower( fmhz );
+
+  if( (idx < arch.count) && FREQ_EQ(arch.entries[idx].freq_mhz, fmhz) )
+    return( &arch.entries[idx] );
+
+  return( NULL );
+}
+
+/* Adds a record to the index in frequency order */
+  static void
+sweep_archive_index( double fmhz, off_t off )
+{
+  int idx = sweep_archive_lower( fmhz );
+
+  mem_array_reserve( &arch.entries, arch.count + 1, 64 );
+  memmove( &arch.entries[idx + 1], &arch.entries[idx],
+      (size_t)(arch.count - idx) * sizeof(sweep_archive_entry_t) );
+  arch.entries[idx].freq_mhz = fmhz;
+  arch.entries[idx].off      = off;
+  arch.count++;
+}
+
+/*-----------------------------------------------------------------------*/
+
+/* Closes the archive of the last sweep, keeping the model key */
+  static void
+sweep_archive_release( void )
+{
+  if( arch.map != NULL )
+    munmap( (void *)arch.map, arch.map_len );
+  arch.map     = NULL;
+  arch.map_len = 0;
+
+  if( arch.fd >= 0 )
+    close( arch.fd );
+  arch.fd = -1;
+
+  mem_array_free( &arch.entries );
+  arch.count = 0;
+  mem_free( &arch.blob );
+}
+
+/* Empties the archive and writes its header.  Returns FALSE on error. */
+  static gboolean
+sweep_archive_restart( const guint8 *key )
+{
+  sweep_archive_header_t hdr;
+
+  memset( &hdr, 0, sizeof(hdr) );
+  memcpy( hdr.magic, SWEEP_ARCHIVE_MAGIC, sizeof(SWEEP_ARCHIVE_MAGIC) );
+  hdr.version  = SWEEP_ARCHIVE_VERSION;
+  hdr.order    = SWEEP_ARCHIVE_ORDER;
+  hdr.blob_len = arch.blob_len;
+  memcpy( hdr.key, key, SWEEP_ARCHIVE_KEY_LEN );
+
+  if( (ftruncate(arch.fd, 0) != 0) ||
+      (pwrite(arch.fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) )
+    return( FALSE );
+
+  arch.end = sizeof(hdr);
+  return( TRUE );
+}
+
+/* Maps an archive written under key and indexes its whole records.
+ * Returns FALSE when the file is empty or written under another key. */
+  static gboolean
+sweep_archive_map( const guint8 *key, off_t size )
+{
+  const sweep_archive_header_t *hdr;
+  const sweep_archive_record_t *rec;
+  size_t rec_len = sizeof(*rec) + arch.blob_len;
+  off_t off;
+
+  if( size < (off_t)sizeof(*hdr) )
+    return( FALSE );
+
+  arch.map = mmap( NULL, (size_t)size, PROT_READ, MAP_SHARED, arch.fd, 0 );
+  if( arch.map == MAP_FAILED )
+  {
+    arch.map = NULL;
+    return( FALSE );
+  }
+  arch.map_len = (size_t)size;
+
+  hdr = (const sweep_archive_header_t *)arch.map;
+  if( (memcmp(hdr->magic, SWEEP_ARCHIVE_MAGIC, sizeof(SWEEP_ARCHIVE_MAGIC)) != 0) ||
+      (hdr->version != SWEEP_ARCHIVE_VERSION) ||
+      (hdr->order != SWEEP_ARCHIVE_ORDER) ||
+      (hdr->blob_len != arch.blob_len) ||
+      (memcmp(hdr->key, key, SWEEP_ARCHIVE_KEY_LEN) != 0) )
+  {
+    munmap( (void *)arch.map, arch.map_len );
+    arch.map = NULL;
+    arch.map_len = 0;
+    return( FALSE );
+  }
+
+  for( off = sizeof(*hdr); off + (off_t)rec_len <= size; off += (off_t)rec_len )
+  {
+    rec = (const sweep_archive_record_t *)(arch.map + off);
+    if( rec->blob_len != arch.blob_len )
+      break;
+
+    if( sweep_archive_find(rec->freq_mhz) == NULL )
+      sweep_archive_index( rec->freq_mhz, off + (off_t)sizeof(*rec) );
+  }
+
+  /* Appends go after the last whole record, over one cut short */
+  arch.end = off;
+
+  return( TRUE );
+}
+
+/*-----------------------------------------------------------------------*/
+
+/* Collects "name=value" for every symbol as the model reads it */
+  static void
+sweep_archive_symbol( const gchar *name, gdouble value,
+    gboolean is_calculated, const gchar *expression,
+    gdouble min_value, gdouble max_value,
+    gdouble override_value, gboolean override_active,
+    gboolean opt_active, gpointer user_data )
+{
+  g_ptr_array_add( (GPtrArray *)user_data, g_strdup_printf("%s=%a", name,
+        override_active ? override_value : value) );
+}
+
+/* Orders the "name=value" strings of two symbols */
+  static gint
+sweep_archive_symcmp( gconstpointer a, gconstpointer b )
+{
+  return( strcmp(*(const char *const *)a, *(const char *const *)b) );
+}
+
+/* sweep_archive_model()
+ *
+ * Records the key of the model just parsed from fp: the deck text and the
+ * value of every symbol.  The position of fp is kept.  A NULL fp forgets
+ * the model, so no sweep uses the archive until the next file load.
+ */
+  void
+sweep_archive_model( FILE *fp )
+{
+  GChecksum *sum;
+  GPtrArray *symbols;
+  char buf[4096];
+  gsize len = SWEEP_ARCHIVE_KEY_LEN;
+  size_t got;
+  long pos;
+
+  g_rec_mutex_lock( &freq_data_lock );
+  arch.model_valid = FALSE;
+
+  if( (fp == NULL) || !rc_config.sweep_archive || ((pos = ftell(fp)) < 0) ||
+      (fseek(fp, 0, SEEK_SET) != 0) )
+  {
+    g_rec_mutex_unlock( &freq_data_lock );
+    return;
+  }
+
+  sum = g_checksum_new( G_CHECKSUM_SHA256 );
+  while( (got = fread(buf, 1, sizeof(buf), fp)) > 0 )
+    g_checksum_update( sum, (const guchar *)buf, (gssize)got );
+  arch.model_valid = !ferror( fp );
+  clearerr( fp );
+  fseek( fp, pos, SEEK_SET );
+
+  /* Symbol values in name order, overrides applied */
+  symbols = g_ptr_array_new_with_free_func( g_free );
+  sy_foreach( sweep_archive_symbol, symbols );
+  g_ptr_array_sort( symbols, sweep_archive_symcmp );
+  for( guint idx = 0; idx < symbols->len; idx++ )
+  {
+    const char *sym = g_ptr_array_index( symbols, idx );
+
+    g_checksum_update( sum, (const guchar *)sym, (gssize)strlen(sym) + 1 );
+  }
+  g_ptr_array_free( symbols, TRUE );
+
+  g_checksum_get_digest( sum, arch.model, &len );
+  g_checksum_free( sum );
+
+  g_rec_mutex_unlock( &freq_data_lock );
+
+} /* sweep_archive_model() */
+
+/*-----------------------------------------------------------------------*/
+
+/* sweep_archive_begin()
+ *
+ * Opens and maps the archive for the sweep about to start, emptying it
+ * when it was written for another model or step layout.  Does nothing
+ * unless a file load recorded the model and the sweep solves whole steps.
+ */
+  void
+sweep_archive_begin( void )
+{
+  GChecksum *sum;
+  struct stat st;
+  guint8 key[SWEEP_ARCHIVE_KEY_LEN];
+  gsize len = sizeof(key);
+  uint64_t blob_len;
+
+  g_rec_mutex_lock( &freq_data_lock );
+  sweep_archive_release();
+
+  if( !arch.model_valid || isFlagSet(HEADLESS_EVAL) ||
+      (calc_data.solve_skip != 0) ||
+      (snprintf(arch.path, sizeof(arch.path), "%s.sweep",
+                rc_config.input_file) >= (int)sizeof(arch.path)) )
+  {
+    g_rec_mutex_unlock( &freq_data_lock );
+    return;
+  }
+
+  arch.blob_len = Freq_Data_Size();
+  blob_len = arch.blob_len;
+
+  sum = g_checksum_new( G_CHECKSUM_SHA256 );
+  g_checksum_update( sum, arch.model, sizeof(arch.model) );
+  g_checksum_update( sum, (const guchar *)&blob_len, sizeof(blob_len) );
+  g_checksum_get_digest( sum, key, &len );
+  g_checksum_free( sum );
+
+  arch.fd = open( arch.path, O_RDWR | O_CREAT, 0644 );
+  if( (arch.fd < 0) || (fstat(arch.fd, &st) != 0) ||
+      (!sweep_archive_map(key, st.st_size) && !sweep_archive_restart(key)) )
+  {
+    pr_warn("sweep archive: cannot open %s: %s\n", arch.path, strerror(errno));
+    sweep_archive_release();
+    g_rec_mutex_unlock( &freq_data_lock );
+    return;
+  }
+
+  mem_alloc( &arch.blob, arch.blob_len );
+  pr_info("sweep archive: %d steps in %s\n", arch.count, arch.path);
+
+  g_rec_mutex_unlock( &freq_data_lock );
+
+} /* sweep_archive_begin() */
+
+/*-----------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------*/
+
+/* sweep_archive_restore()
+ *
+ * Unpacks the archived step at fmhz into slot fstep and marks it valid.
+ * Returns FALSE, leaving the slot alone, when the archive lacks fmhz.
+ */
+  gboolean
+sweep_archive_restore( double fmhz, int fstep )
+{
+  sweep_archive_entry_t *entry;
+  const char *blob;
+
+  g_rec_mutex_lock( &freq_data_lock );
+
+  entry = (arch.fd >= 0) ? sweep_archive_find( fmhz ) : NULL;
+  if( (entry == NULL) || (Freq_Data_Size() != arch.blob_len) )
+  {
+    g_rec_mutex_unlock( &freq_data_lock );
+    return( FALSE );
+  }
+
+  /* Records appended since the sweep began are past the mapping */
+  if( entry->off + (off_t)arch.blob_len <= (off_t)arch.map_len )
+    blob = (const char *)arch.map + entry->off;
+  else if( pread(arch.fd, arch.blob, arch.blob_len, entry->off) ==
+      (ssize_t)arch.blob_len )
+    blob = arch.blob;
+  else
+  {
+    g_rec_mutex_unlock( &freq_data_lock );
+    return( FALSE );
+  }
+
+  Put_Freq_Blob( blob, fstep );
+  save.freq[fstep]  = fmhz;
+  save.fstep[fstep] = 1;
+
+  g_rec_mutex_unlock( &freq_data_lock );
+  return( TRUE );
+
+} /* sweep_archive_restore() */
+
+/*-----------------------------------------------------------------------*/
+
+/* sweep_archive_append()
+ *
+ * Appends the solved step in slot fstep to the archive, unless it holds
+ * the step's frequency already.  A write error closes the archive for the
+ * rest of the sweep.
+ */
+  void
+sweep_archive_append( int fstep )
+{
+  sweep_archive_record_t rec;
+  struct iovec iov[2];
+
+  g_rec_mutex_lock( &freq_data_lock );
+
+  if( (arch.fd < 0) || (sweep_archive_find(save.freq[fstep]) != NULL) ||
+      (Freq_Data_Size() != arch.blob_len) )
+  {
+    g_rec_mutex_unlock( &freq_data_lock );
+    return;
+  }
+
+  memset( &rec, 0, sizeof(rec) );
+  rec.freq_mhz = save.freq[fstep];
+  rec.blob_len = arch.blob_len;
+  Pack_Freq_Blob( fstep, arch.blob );
+
+  iov[0].iov_base = &rec;
+  iov[0].iov_len  = sizeof(rec);
+  iov[1].iov_base = arch.blob;
+  iov[1].iov_len  = arch.blob_len;
+
+  if( pwritev(arch.fd, iov, 2, arch.end) != (ssize_t)(sizeof(rec) + arch.blob_len) )
+  {
+    pr_warn("sweep archive: cannot write %s: %s\n", arch.path, strerror(errno));
+    sweep_archive_release();
+    g_rec_mutex_unlock( &freq_data_lock );
+    return;
+  }
+
+  sweep_archive_index( rec.freq_mhz, arch.end + (off_t)sizeof(rec) );
+  arch.end += (off_t)(sizeof(rec) + arch.blob_len);
+
+  g_rec_mutex_unlock( &freq_data_lock );
+
+} /* sweep_archive_append() */
+
+/*-----------------------------------------------------------------------*/
+
+/* sweep_archive_close()
+ *
+ * Unmaps and closes the archive and forgets the model
+ */
+  void
+sweep_archive_close( void )
+{
+  g_rec_mutex_lock( &freq_data_lock );
+  sweep_archive_release();
+  arch.model_valid = FALSE;
+  g_rec_mutex_unlock( &freq_data_lock );
+
+} /* sweep_archive_close() */
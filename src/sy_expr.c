@@ -21,6 +21,7 @@
 #include "shared.h"
 #include <stdio.h>
 #include <math.h>
+#include <float.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdarg.h>
@@ -437,6 +438,84 @@ sy_lookup_function(const gchar *name)
   return NULL;
 }
 
+/* Compiled expression instruction kinds */
+typedef enum
+{
+  SY_INSN_NUMBER = 0,
+  SY_INSN_SYMBOL,
+  SY_INSN_OPERATOR,
+  SY_INSN_FUNCTION
+} sy_insn_type_t;
+
+/* Bytecode instruction: a literal, a symbol slot, an operator or a function */
+typedef struct
+{
+  sy_insn_type_t type;
+  union
+  {
+    gdouble number;
+    guint slot;
+    const sy_operator_t *op;
+    const sy_function_t *func;
+  } arg;
+} sy_insn_t;
+
+/* Compiled expression
+ * Built once per expression text and kept in program_cache, so a deck
+ * reloaded for every optimizer candidate skips the tokenizer and the
+ * Shunting-yard pass for every field it has seen before
+ *
+ * code:       Instructions in RPN order
+ * len:        Instruction count
+ * reads:      Distinct symbol slots read: the symbol-to-field and
+ *             symbol-to-symbol edges of the dependency graph
+ * depth:      Largest operand stack depth reached
+ * refs:       References held by program_cache and by calculated symbols
+ */
+typedef struct
+{
+  sy_insn_t *code;
+  guint len;
+  guint *reads;
+  guint num_reads;
+  guint depth;
+  gint refs;
+} sy_program_t;
+
+/* Symbol slot
+ * Interned once per symbol name and kept across sy_init(), so compiled
+ * expressions stay valid while the table is rebuilt on every reload
+ *
+ * name:        Normalized symbol name
+ * val:         Entry in symbol_table, NULL while the symbol is undefined
+ * prog:        Compiled expression of a calculated symbol, NULL if terminal
+ * dependents:  Slots of the calculated symbols whose expression reads this one
+ * mark:        Visit stamp of the last dependency graph walk
+ */
+typedef struct
+{
+  gchar *name;
+  sy_value_t *val;
+  sy_program_t *prog;
+  GArray *dependents;
+  guint mark;
+} sy_slot_t;
+
+/* Interned symbol slots, found by name through slot_index */
+static GPtrArray *slots = NULL;
+static GHashTable *slot_index = NULL;
+static guint slot_mark = 0;
+
+/* Compiled expressions keyed by their source text */
+static GHashTable *program_cache = NULL;
+
+/* Entries kept before program_cache is flushed; editing a field evaluates
+ * every partial expression typed into it */
+#define SY_PROGRAM_CACHE_MAX  4096
+
+/* Operand stack depth held on the C stack while running a program */
+#define SY_STACK_LOCAL        32
+
 /* Tokenize expression string into array of tokens
  * Recognizes: numbers, identifiers, operators, parentheses, commas
  * Numbers support scientific notation (e.g., 1.5E-3)
@@ -752,239 +831,430 @@ sy_get_value(const sy_value_t *val)
   return val->override_active ? val->override_value : val->value;
 }
 
-/* Evaluate RPN expression from queue
- * Uses value stack to process numbers, operators, and functions
- * Looks up symbols from symbol table and constants from constant table
+/* Intern a normalized symbol name
+ * Returns the slot index, creating the slot on first use
  */
-static gboolean
-sy_evaluate_rpn(GQueue *rpn, gdouble *result)
+static guint
+sy_slot_intern(const gchar *upper_name)
+{
+  gpointer found;
+  sy_slot_t *slot;
+
+  if( slots == NULL )
+  {
+    slots = g_ptr_array_new();
+    slot_index = g_hash_table_new(g_str_hash, g_str_equal);
+  }
+
+  if( g_hash_table_lookup_extended(slot_index, upper_name, NULL, &found) )
+    return GPOINTER_TO_UINT(found);
+
+  slot = g_new0(sy_slot_t, 1);
+  slot->name = g_strdup(upper_name);
+  slot->dependents = g_array_new(FALSE, FALSE, sizeof(guint));
+  g_ptr_array_add(slots, slot);
+  g_hash_table_insert(slot_index, slot->name, GUINT_TO_POINTER(slots->len - 1));
+
+  return slots->len - 1;
+}
+
+/* Get slot by index */
+static inline sy_slot_t *
+sy_slot(guint index)
+{
+  return (sy_slot_t *)g_ptr_array_index(slots, index);
+}
+
+/* Insert a symbol_table entry and point its slot at it
+ * Takes ownership of upper_name and val, as g_hash_table_insert() does
+ */
+static void
+sy_table_insert(gchar *upper_name, sy_value_t *val)
+{
+  sy_slot(sy_slot_intern(upper_name))->val = val;
+  g_hash_table_insert(symbol_table, upper_name, val);
+}
+
+/* Drop a reference to a compiled expression */
+static void
+sy_program_unref(gpointer data)
+{
+  sy_program_t *prog = (sy_program_t *)data;
+
+  if( prog == NULL || --prog->refs > 0 )
+    return;
+
+  g_free(prog->code);
+  g_free(prog->reads);
+  g_free(prog);
+}
+
+/* Record a symbol slot read by a compiled expression, once */
+static void
+sy_program_add_read(sy_program_t *prog, guint slot)
+{
+  guint i;
+
+  for( i = 0; i < prog->num_reads; i++ )
+  {
+    if( prog->reads[i] == slot )
+      return;
+  }
+
+  prog->reads[prog->num_reads++] = slot;
+}
+
+/* Compile an RPN queue into bytecode
+ * Consumes the tokens of the queue; the caller frees the queue itself
+ * Predefined constants fold into numbers and symbols resolve to slots,
+ * so running the program needs no name lookups
+ * Returns NULL on error
+ */
+static sy_program_t *
+sy_compile_rpn(GQueue *rpn)
 {
-  GQueue *stack;
+  sy_program_t *prog;
   sy_token_t *token;
-  gdouble *val1;
-  gdouble *val2;
-  gdouble *res;
-  gdouble tmp;
-  const sy_function_t *func;
+  sy_insn_t *insn;
   gchar upper_name[32];
-
-  stack = g_queue_new();
+  gboolean failed;
+  gint depth;
+  guint len;
+
+  len = MAX(g_queue_get_length(rpn), 1);
+  prog = g_new0(sy_program_t, 1);
+  prog->code = g_new(sy_insn_t, len);
+  prog->reads = g_new(guint, len);
+  prog->refs = 1;
+  failed = FALSE;
+  depth = 0;
 
   while( !g_queue_is_empty(rpn) )
   {
     token = (sy_token_t *)g_queue_pop_head(rpn);
+    insn = &prog->code[prog->len];
 
     if( token->type == SY_TOKEN_NUMBER )
     {
-      res = g_new(gdouble, 1);
-      *res = token->value.number;
-      g_queue_push_head(stack, res);
-      g_free(token);
-      continue;
+      insn->type = SY_INSN_NUMBER;
+      insn->arg.number = token->value.number;
+      depth++;
     }
-
-    if( token->type == SY_TOKEN_SYMBOL )
+    else if( token->type == SY_TOKEN_SYMBOL )
     {
       sy_normalize_name(token->value.name, upper_name, sizeof(upper_name));
 
-      if( sy_lookup_constant(upper_name, &tmp) )
+      if( sy_lookup_constant(upper_name, &insn->arg.number) )
+        insn->type = SY_INSN_NUMBER;
+      else
       {
-        res = g_new(gdouble, 1);
-        *res = tmp;
-        g_queue_push_head(stack, res);
+        insn->type = SY_INSN_SYMBOL;
+        insn->arg.slot = sy_slot_intern(upper_name);
+        sy_program_add_read(prog, insn->arg.slot);
       }
-      else
+      depth++;
+    }
+    else if( token->type == SY_TOKEN_OPERATOR )
+    {
+      insn->type = SY_INSN_OPERATOR;
+      insn->arg.op = sy_lookup_operator(token->value.op);
+      if( insn->arg.op == NULL )
       {
-        if( symbol_table == NULL )
-        {
-          /* NULL table is an environmental state, not a per-expression
-           * error; return silently so callers handle FALSE */
-          g_free(token);
-          g_queue_free_full(stack, g_free);
-          return FALSE;
-        }
-        else
-        {
-          sy_value_t *val_struct;
-
-          val_struct = (sy_value_t *)g_hash_table_lookup(symbol_table, upper_name);
-          if( val_struct == NULL )
-          {
-            gchar err_msg[128];
-            snprintf(err_msg, sizeof(err_msg), _("Undefined symbol: %s"), upper_name);
-            sy_error_record("%s", err_msg);
-            g_free(token);
-            g_queue_free_full(stack, g_free);
-            return FALSE;
-          }
-          else
-          {
-            res = g_new(gdouble, 1);
-            *res = sy_get_value(val_struct);
-            g_queue_push_head(stack, res);
-          }
-        }
+        sy_error_record(_("Unknown operator"));
+        failed = TRUE;
+        break;
       }
-
-      g_free(token);
-      continue;
+      depth--;
     }
-
-    if( token->type == SY_TOKEN_OPERATOR )
+    else if( token->type == SY_TOKEN_FUNCTION )
     {
-      const sy_operator_t *op_entry;
-
-      if( g_queue_is_empty(stack) )
+      insn->type = SY_INSN_FUNCTION;
+      insn->arg.func = sy_lookup_function(token->value.name);
+      if( insn->arg.func == NULL )
       {
-        sy_error_record(_("Expression error: missing operand"));
-        g_free(token);
-        g_queue_free_full(stack, g_free);
-        return FALSE;
+        gchar err_msg[128];
+        snprintf(err_msg, sizeof(err_msg), _("Unknown function: %s"), token->value.name);
+        sy_error_record("%s", err_msg);
+        failed = TRUE;
+        break;
       }
-
-      val2 = (gdouble *)g_queue_pop_head(stack);
-
-      if( g_queue_is_empty(stack) )
+      else if( insn->arg.func->arity != 1 && insn->arg.func->arity != 2 )
       {
-        sy_error_record(_("Expression error: missing operand"));
-        g_free(token);
-        g_free(val2);
-        g_queue_free_full(stack, g_free);
-        return FALSE;
+        sy_error_record(_("Function error: invalid arity"));
+        failed = TRUE;
+        break;
       }
+      depth -= insn->arg.func->arity - 1;
+    }
+    else
+    {
+      /* Totality enforcement: handle unexpected token types in RPN queue
+       * Parentheses and commas should never appear in RPN output
+       */
+      sy_error_record(_("Expression error: unexpected token type in RPN"));
+      failed = TRUE;
+      break;
+    }
 
-      val1 = (gdouble *)g_queue_pop_head(stack);
+    g_free(token);
+    prog->len++;
+    prog->depth = MAX(prog->depth, (guint)MAX(depth, 0));
+  }
 
-      op_entry = sy_lookup_operator(token->value.op);
-      if( op_entry == NULL )
-      {
-        sy_error_record(_("Unknown operator"));
-        g_free(token);
-        g_free(val1);
-        g_free(val2);
-        g_queue_free_full(stack, g_free);
-        return FALSE;
-      }
+  if( failed )
+  {
+    /* Stopped on an error: the failing token is still ours */
+    g_free(token);
+    while( !g_queue_is_empty(rpn) )
+      g_free(g_queue_pop_head(rpn));
+    sy_program_unref(prog);
+    return NULL;
+  }
 
-      res = g_new(gdouble, 1);
+  return prog;
+}
 
-      if( token->value.op == '/' && *val2 == 0.0 )
-      {
-        sy_error_record(_("Division by zero"));
-        g_free(token);
-        g_free(val1);
-        g_free(val2);
-        g_free(res);
-        g_queue_free_full(stack, g_free);
-        return FALSE;
-      }
+/* Look up the compiled form of an expression, compiling it on first use
+ * The program is owned by program_cache; take a reference to keep it
+ * Failed compilations are not cached, so their errors are reported on
+ * every evaluation as before
+ * Returns NULL on error
+ */
+static sy_program_t *
+sy_program_get(const gchar *expr)
+{
+  sy_program_t *prog;
+  GArray *tokens;
+  GQueue *rpn;
+
+  if( program_cache == NULL )
+  {
+    program_cache = g_hash_table_new_full(
+      g_str_hash,
+      g_str_equal,
+      g_free,
+      sy_program_unref);
+  }
 
-      *res = op_entry->eval(*val1, *val2);
-      g_free(val1);
-      g_free(val2);
-      g_queue_push_head(stack, res);
+  prog = (sy_program_t *)g_hash_table_lookup(program_cache, expr);
+  if( prog != NULL )
+    return prog;
 
-      g_free(token);
-      continue;
+  tokens = sy_tokenize(expr);
+  if( tokens == NULL )
+    return NULL;
+
+  rpn = sy_infix_to_rpn(tokens);
+  g_array_free(tokens, TRUE);
+  if( rpn == NULL )
+    return NULL;
+
+  prog = sy_compile_rpn(rpn);
+  g_queue_free(rpn);
+  if( prog == NULL )
+    return NULL;
+
+  if( g_hash_table_size(program_cache) >= SY_PROGRAM_CACHE_MAX )
+    g_hash_table_remove_all(program_cache);
+
+  g_hash_table_insert(program_cache, g_strdup(expr), prog);
+  return prog;
+}
+
+/* Run a compiled expression
+ * Symbols read their current value, with any active override
+ */
+static gboolean
+sy_program_run(const sy_program_t *prog, gdouble *result)
+{
+  gdouble local[SY_STACK_LOCAL];
+  gdouble *stack;
+  const sy_insn_t *insn;
+  const sy_slot_t *slot;
+  gboolean success;
+  guint top;
+  guint i;
+
+  if( prog->depth <= SY_STACK_LOCAL )
+    stack = local;
+  else
+    stack = g_new(gdouble, prog->depth);
+
+  success = FALSE;
+  top = 0;
+
+  for( i = 0; i < prog->len; i++ )
+  {
+    insn = &prog->code[i];
+
+    if( insn->type == SY_INSN_NUMBER )
+    {
+      stack[top++] = insn->arg.number;
     }
-    else if( token->type == SY_TOKEN_FUNCTION )
+    else if( insn->type == SY_INSN_SYMBOL )
     {
-      func = sy_lookup_function(token->value.name);
-      if( func == NULL )
+      /* NULL table is an environmental state, not a per-expression
+       * error; return silently so callers handle FALSE */
+      if( symbol_table == NULL )
+        break;
+
+      slot = sy_slot(insn->arg.slot);
+      if( slot->val == NULL )
       {
         gchar err_msg[128];
-        snprintf(err_msg, sizeof(err_msg), _("Unknown function: %s"), token->value.name);
+        snprintf(err_msg, sizeof(err_msg), _("Undefined symbol: %s"), slot->name);
         sy_error_record("%s", err_msg);
-        g_free(token);
-        g_queue_free_full(stack, g_free);
-        return FALSE;
+        break;
       }
-      else
+
+      stack[top++] = sy_get_value(slot->val);
+    }
+    else if( insn->type == SY_INSN_OPERATOR )
+    {
+      if( top < 2 )
       {
-        if( func->arity == 1 )
-        {
-          if( g_queue_is_empty(stack) )
-          {
-            sy_error_record(_("Function error: missing argument"));
-            g_free(token);
-            g_queue_free_full(stack, g_free);
-            return FALSE;
-          }
-          else
-          {
-            val1 = (gdouble *)g_queue_pop_head(stack);
-            res = g_new(gdouble, 1);
-            *res = func->func1(*val1);
-            g_free(val1);
-            g_queue_push_head(stack, res);
-          }
-        }
-        else if( func->arity == 2 )
-        {
-          if( g_queue_is_empty(stack) )
-          {
-            sy_error_record(_("Function error: missing argument"));
-            g_free(token);
-            g_queue_free_full(stack, g_free);
-            return FALSE;
-          }
-          else
-            val2 = (gdouble *)g_queue_pop_head(stack);
+        sy_error_record(_("Expression error: missing operand"));
+        break;
+      }
 
-          if( g_queue_is_empty(stack) )
-          {
-            sy_error_record(_("Function error: missing argument"));
-            g_free(token);
-            g_free(val2);
-            g_queue_free_full(stack, g_free);
-            return FALSE;
-          }
-          else
-            val1 = (gdouble *)g_queue_pop_head(stack);
+      if( insn->arg.op->op == '/' && stack[top - 1] == 0.0 )
+      {
+        sy_error_record(_("Division by zero"));
+        break;
+      }
 
-          res = g_new(gdouble, 1);
-          *res = func->func2(*val1, *val2);
-          g_free(val1);
-          g_free(val2);
-          g_queue_push_head(stack, res);
-        }
-        else
-        {
-          sy_error_record(_("Function error: invalid arity"));
-          g_free(token);
-          g_queue_free_full(stack, g_free);
-          return FALSE;
-        }
+      stack[top - 2] = insn->arg.op->eval(stack[top - 2], stack[top - 1]);
+      top--;
+    }
+    else
+    {
+      if( top < (guint)insn->arg.func->arity )
+      {
+        sy_error_record(_("Function error: missing argument"));
+        break;
       }
 
-      g_free(token);
-      continue;
+      if( insn->arg.func->arity == 1 )
+        stack[top - 1] = insn->arg.func->func1(stack[top - 1]);
+      else
+      {
+        stack[top - 2] = insn->arg.func->func2(stack[top - 2], stack[top - 1]);
+        top--;
+      }
     }
+  }
 
-    /* Totality enforcement: handle unexpected token types in RPN queue
-     * Parentheses and commas should never appear in RPN output
-     */
-    sy_error_record(_("Expression error: unexpected token type in RPN"));
-    g_free(token);
-    g_queue_free_full(stack, g_free);
-    return FALSE;
+  if( i == prog->len )
+  {
+    if( top != 1 )
+      sy_error_record(_("Expression error: invalid result"));
+    else
+    {
+      *result = stack[0];
+      success = TRUE;
+    }
   }
 
-  if( g_queue_get_length(stack) != 1 )
+  if( stack != local )
+    g_free(stack);
+
+  return success;
+}
+
+/* Attach the compiled expression of a calculated symbol to its slot
+ * prog: NULL for a terminal symbol
+ * Adds the symbol to the dependents of every slot the expression reads
+ */
+static void
+sy_slot_set_program(const gchar *upper_name, sy_program_t *prog)
+{
+  sy_slot_t *slot;
+  GArray *deps;
+  guint index;
+  guint i, j;
+
+  index = sy_slot_intern(upper_name);
+  slot = sy_slot(index);
+
+  if( prog != NULL )
+    prog->refs++;
+
+  sy_program_unref(slot->prog);
+  slot->prog = prog;
+
+  if( prog == NULL )
+    return;
+
+  for( i = 0; i < prog->num_reads; i++ )
   {
-    sy_error_record(_("Expression error: invalid result"));
-    g_queue_free_full(stack, g_free);
-    return FALSE;
+    deps = sy_slot(prog->reads[i])->dependents;
+
+    for( j = 0; j < deps->len; j++ )
+    {
+      if( g_array_index(deps, guint, j) == index )
+        break;
+    }
+
+    if( j == deps->len )
+      g_array_append_val(deps, index);
   }
-  else
+}
+
+/* Walk the dependency graph from a slot
+ * Appends the slot and every calculated symbol reading it, directly or
+ * through other calculated symbols, in post-order: each slot follows all
+ * of its dependents, so the reversed order is safe to re-evaluate in.
+ * Visited slots carry the current slot_mark; bump it before each walk.
+ */
+static void
+sy_slot_visit(guint index, GArray *order)
+{
+  sy_slot_t *slot;
+  guint i;
+
+  slot = sy_slot(index);
+  if( slot->mark == slot_mark )
+    return;
+
+  slot->mark = slot_mark;
+
+  for( i = 0; i < slot->dependents->len; i++ )
+    sy_slot_visit(g_array_index(slot->dependents, guint, i), order);
+
+  g_array_append_val(order, index);
+}
+
+/* Re-evaluate the calculated symbols that depend on a changed symbol
+ * Symbols the change does not reach keep their values untouched.  Errors
+ * are dropped here; the next reload reports them against the deck.
+ */
+static void
+sy_propagate(guint index)
+{
+  GArray *order;
+  sy_slot_t *slot;
+  gdouble value;
+  gint i;
+
+  order = g_array_new(FALSE, FALSE, sizeof(guint));
+  slot_mark++;
+  sy_slot_visit(index, order);
+
+  /* The changed symbol itself comes last */
+  sy_errors_begin();
+  for( i = (gint)order->len - 2; i >= 0; i-- )
   {
-    val1 = (gdouble *)g_queue_pop_head(stack);
-    *result = *val1;
-    g_free(val1);
+    slot = sy_slot(g_array_index(order, guint, i));
+
+    if( slot->val != NULL && slot->val->is_calculated && slot->prog != NULL &&
+        sy_program_run(slot->prog, &value) )
+    {
+      slot->val->value = value;
+    }
   }
+  sy_errors_discard();
 
-  g_queue_free(stack);
-  return TRUE;
+  g_array_free(order, TRUE);
 }
 
 /* Public interface implementations */
@@ -1033,11 +1303,56 @@ sy_init(void)
 void
 sy_cleanup(void)
 {
+  sy_slot_t *slot;
+  guint i;
+
   if( symbol_table != NULL )
   {
     g_hash_table_destroy(symbol_table);
     symbol_table = NULL;
   }
+
+  /* Slots and compiled expressions outlive the table; only the
+   * definitions and their dependency edges go with it */
+  for( i = 0; slots != NULL && i < slots->len; i++ )
+  {
+    slot = sy_slot(i);
+    slot->val = NULL;
+    sy_program_unref(slot->prog);
+    slot->prog = NULL;
+    g_array_set_size(slot->dependents, 0);
+  }
+}
+
+void
+sy_release(void)
+{
+  sy_slot_t *slot;
+  guint i;
+
+  sy_cleanup();
+
+  if( program_cache != NULL )
+  {
+    g_hash_table_destroy(program_cache);
+    program_cache = NULL;
+  }
+
+  if( slots != NULL )
+  {
+    for( i = 0; i < slots->len; i++ )
+    {
+      slot = sy_slot(i);
+      g_array_free(slot->dependents, TRUE);
+      g_free(slot->name);
+      g_free(slot);
+    }
+
+    g_ptr_array_free(slots, TRUE);
+    g_hash_table_destroy(slot_index);
+    slots = NULL;
+    slot_index = NULL;
+  }
 }
 
 gboolean
@@ -1046,6 +1361,7 @@ sy_define(const gchar *name, const gchar *value_or_expr)
   gchar *upper_name;
   gchar temp_name[64];
   sy_value_t *val_ptr;
+  sy_program_t *prog;
   gdouble value;
   gboolean is_expr;
 
@@ -1057,11 +1373,13 @@ sy_define(const gchar *name, const gchar *value_or_expr)
 
   if( is_expr )
   {
-    if( !sy_evaluate(value_or_expr, &value) )
+    prog = sy_program_get(value_or_expr);
+    if( prog == NULL || !sy_program_run(prog, &value) )
       return FALSE;
   }
   else
   {
+    prog = NULL;
     value = Strtod((gchar *)value_or_expr, NULL);
   }
 
@@ -1086,6 +1404,7 @@ sy_define(const gchar *name, const gchar *value_or_expr)
     if( isnan(val_ptr->max_value) )
       val_ptr->max_value = value * 2.0;
 
+    sy_slot_set_program(temp_name, prog);
     return TRUE;
   }
 
@@ -1107,16 +1426,15 @@ sy_define(const gchar *name, const gchar *value_or_expr)
   val_ptr->override_active = FALSE;
   val_ptr->opt_active = FALSE;
 
-  g_hash_table_insert(symbol_table, upper_name, val_ptr);
+  sy_table_insert(upper_name, val_ptr);
+  sy_slot_set_program(temp_name, prog);
   return TRUE;
 }
 
 gboolean
 sy_evaluate(const gchar *expr, gdouble *result)
 {
-  GArray *tokens;
-  GQueue *rpn;
-  gboolean success;
+  sy_program_t *prog;
 
   if( expr == NULL || result == NULL )
   {
@@ -1125,26 +1443,53 @@ sy_evaluate(const gchar *expr, gdouble *result)
   }
   else
   {
-    tokens = sy_tokenize(expr);
-    if( tokens == NULL )
+    prog = sy_program_get(expr);
+    if( prog == NULL )
       return FALSE;
     else
-    {
-      rpn = sy_infix_to_rpn(tokens);
-      g_array_free(tokens, TRUE);
-
-      if( rpn == NULL )
-        return FALSE;
-      else
-      {
-        success = sy_evaluate_rpn(rpn, result);
-        g_queue_free_full(rpn, g_free);
-        return success;
-      }
-    }
+      return sy_program_run(prog, result);
   }
 }
 
+gboolean
+sy_depends(const gchar *expr, const gchar *name)
+{
+  sy_program_t *prog;
+  GArray *order;
+  gchar upper_name[32];
+  gpointer found;
+  gboolean reads;
+  guint i;
+
+  if( expr == NULL || name == NULL || !sy_is_expression(expr) )
+    return FALSE;
+
+  /* A field that does not compile depends on nothing; its error is
+   * reported where it is evaluated */
+  sy_errors_begin();
+  prog = sy_program_get(expr);
+  sy_errors_discard();
+
+  if( prog == NULL )
+    return FALSE;
+
+  sy_normalize_name(name, upper_name, sizeof(upper_name));
+  if( slot_index == NULL ||
+      !g_hash_table_lookup_extended(slot_index, upper_name, NULL, &found) )
+    return FALSE;
+
+  order = g_array_new(FALSE, FALSE, sizeof(guint));
+  slot_mark++;
+  sy_slot_visit(GPOINTER_TO_UINT(found), order);
+  g_array_free(order, TRUE);
+
+  reads = FALSE;
+  for( i = 0; i < prog->num_reads && !reads; i++ )
+    reads = (sy_slot(prog->reads[i])->mark == slot_mark);
+
+  return reads;
+}
+
 gboolean
 sy_is_expression(const gchar *field)
 {
@@ -1198,16 +1543,16 @@ sy_is_expression(const gchar *field)
   }
 }
 
-/* sy_load_overrides()
+/* sy_load_overrides_fp()
  *
- * Load symbol override values from .sy file
+ * Parse .sy override lines from an open stream
  * Format: VARNAME: min_value=X max_value=Y override_value=Z override_active=N
  * Creates partial sy_value_t entries with value=NAN for later sy_define() merge
+ * Returns: number of entries loaded
  */
-gboolean
-sy_load_overrides(const gchar *filename)
+static int
+sy_load_overrides_fp(FILE *fp)
 {
-  FILE *fp;
   char line[512];
   char name[64];
   char upper_name[64];
@@ -1216,19 +1561,6 @@ sy_load_overrides(const gchar *filename)
   gchar *key_name;
   int count = 0;
 
-  if( filename == NULL )
-    return FALSE;
-
-  fp = fopen(filename, "r");
-  if( fp == NULL )
-    return FALSE;
-
-  if( symbol_table == NULL )
-  {
-    fclose(fp);
-    return FALSE;
-  }
-
   while( fgets(line, sizeof(line), fp) != NULL )
   {
     /* Skip empty lines and comments */
@@ -1326,10 +1658,31 @@ sy_load_overrides(const gchar *filename)
     }
 
     key_name = g_strdup(upper_name);
-    g_hash_table_insert(symbol_table, key_name, val_ptr);
+    sy_table_insert(key_name, val_ptr);
     count++;
   }
 
+  return count;
+}
+
+/* sy_load_overrides()
+ *
+ * Load symbol override values from .sy file
+ */
+gboolean
+sy_load_overrides(const gchar *filename)
+{
+  FILE *fp;
+  int count;
+
+  if( filename == NULL || symbol_table == NULL )
+    return FALSE;
+
+  fp = fopen(filename, "r");
+  if( fp == NULL )
+    return FALSE;
+
+  count = sy_load_overrides_fp(fp);
   fclose(fp);
 
   if( count > 0 )
@@ -1338,6 +1691,34 @@ sy_load_overrides(const gchar *filename)
   return (count > 0);
 }
 
+/* sy_load_overrides_text()
+ *
+ * Load symbol override values from .sy text held in memory, as produced
+ * by sy_overrides_text().  Used by the headless optimizer evaluation,
+ * which reparses the deck once per candidate without writing the file.
+ */
+gboolean
+sy_load_overrides_text(const gchar *text)
+{
+  FILE *fp;
+  int count;
+
+  if( text == NULL || symbol_table == NULL || *text == '\0' )
+    return FALSE;
+
+  fp = fmemopen((void *)text, strlen(text), "r");
+  if( fp == NULL )
+  {
+    pr_err("sy_load_overrides_text: fmemopen failed: %s\n", strerror(errno));
+    return FALSE;
+  }
+
+  count = sy_load_overrides_fp(fp);
+  fclose(fp);
+
+  return (count > 0);
+}
+
 /* Helper struct for sy_foreach iteration */
 typedef struct
 {
@@ -1378,6 +1759,7 @@ sy_set_override(const gchar *name, gdouble override_value, gboolean active)
 {
   gchar upper_name[64];
   sy_value_t *val;
+  gdouble previous;
 
   if( symbol_table == NULL || name == NULL )
     return FALSE;
@@ -1388,8 +1770,14 @@ sy_set_override(const gchar *name, gdouble override_value, gboolean active)
   if( val == NULL )
     return FALSE;
 
+  previous = sy_get_value(val);
   val->override_value = override_value;
   val->override_active = active;
+
+  /* Only the calculated symbols downstream of this one see the change */
+  if( sy_get_value(val) != previous )
+    sy_propagate(sy_slot_intern(upper_name));
+
   return TRUE;
 }
 
@@ -1436,14 +1824,58 @@ sy_set_opt(const gchar *name, gboolean active)
   return TRUE;
 }
 
-gboolean
-sy_save_overrides(const gchar *filename)
+/* sy_overrides_format()
+ *
+ * Append one .sy line per symbol to text, numbers at the given number of
+ * significant digits.  Returns: number of lines appended
+ */
+static int
+sy_overrides_format(GString *text, int digits)
 {
-  FILE *fp;
   GHashTableIter iter;
   gpointer key, value;
   int count = 0;
 
+  g_hash_table_iter_init(&iter, symbol_table);
+  while( g_hash_table_iter_next(&iter, &key, &value) )
+  {
+    const gchar *name = (const gchar *)key;
+    sy_value_t *val = (sy_value_t *)value;
+
+    g_string_append_printf(text,
+        "%s: min_value=%.*g max_value=%.*g override_value=%.*g override_active=%d opt_active=%d\n",
+        name, digits, val->min_value, digits, val->max_value,
+        digits, val->override_value, val->override_active ? 1 : 0,
+        val->opt_active ? 1 : 0);
+    count++;
+  }
+
+  return count;
+}
+
+gchar *
+sy_overrides_text(void)
+{
+  GString *text;
+
+  if( symbol_table == NULL )
+    return NULL;
+
+  /* Round-trip precision: an optimizer step below the 6 digits of the
+   * file format must still reach the reparsed geometry */
+  text = g_string_new(NULL);
+  sy_overrides_format(text, DBL_DECIMAL_DIG);
+
+  return g_string_free(text, FALSE);
+}
+
+gboolean
+sy_save_overrides(const gchar *filename)
+{
+  FILE *fp;
+  GString *text;
+  int count;
+
   if( filename == NULL || symbol_table == NULL )
     return FALSE;
 
@@ -1455,21 +1887,12 @@ sy_save_overrides(const gchar *filename)
     return FALSE;
   }
 
-  fprintf(fp, "# Symbol overrides file\n");
-  fprintf(fp, "# Format: VARNAME: min_value=X max_value=Y override_value=Z override_active=N opt_active=N\n\n");
+  text = g_string_new("# Symbol overrides file\n"
+      "# Format: VARNAME: min_value=X max_value=Y override_value=Z override_active=N opt_active=N\n\n");
+  count = sy_overrides_format(text, 6);
 
-  g_hash_table_iter_init(&iter, symbol_table);
-  while( g_hash_table_iter_next(&iter, &key, &value) )
-  {
-    const gchar *name = (const gchar *)key;
-    sy_value_t *val = (sy_value_t *)value;
-
-    fprintf(fp, "%s: min_value=%g max_value=%g override_value=%g override_active=%d opt_active=%d\n",
-        name, val->min_value, val->max_value,
-        val->override_value, val->override_active ? 1 : 0,
-        val->opt_active ? 1 : 0);
-    count++;
-  }
+  fputs(text->str, fp);
+  g_string_free(text, TRUE);
 
   fclose(fp);
   pr_info("Saved %d symbol overrides to %s\n", count, filename);
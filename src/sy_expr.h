@@ -33,9 +33,14 @@ gboolean sy_get_bounds(const gchar *name, gdouble *min, gdouble *max);
 /* Initialize symbol table and expression evaluator */
 gboolean sy_init(void);
 
-/* Cleanup symbol table and free resources */
+/* Cleanup symbol table and free resources
+ * Compiled expressions are kept for the next sy_init()
+ */
 void sy_cleanup(void);
 
+/* Cleanup symbol table and free the compiled expression cache */
+void sy_release(void);
+
 /* Define or update a symbol with given value or expression
  * name: symbol name (will be normalized to uppercase for case-insensitive lookup)
  * value_or_expr: numeric string or expression to evaluate and store
@@ -50,6 +55,15 @@ gboolean sy_define(const gchar *name, const gchar *value_or_expr);
  */
 gboolean sy_evaluate(const gchar *expr, gdouble *result);
 
+/* Check whether an expression depends on a symbol
+ * expr: expression string, compiled on first use like sy_evaluate()
+ * name: symbol name
+ * Returns: TRUE if expr reads name directly or through the calculated
+ * symbols defined so far, FALSE otherwise or if expr does not compile
+ * Changing name leaves the value of any other expression unchanged
+ */
+gboolean sy_depends(const gchar *expr, const gchar *name);
+
 /* Check if a field contains an expression rather than a plain number
  * field: string to check
  * Returns: TRUE if field contains expression syntax, FALSE if plain number
@@ -64,6 +78,12 @@ gboolean sy_is_expression(const gchar *field);
  */
 gboolean sy_load_overrides(const gchar *filename);
 
+/* Load symbol overrides from .sy text held in memory
+ * text: NUL-terminated lines in the .sy file format
+ * Returns: TRUE if any override loaded, FALSE if none
+ */
+gboolean sy_load_overrides_text(const gchar *text);
+
 /* Callback function type for sy_foreach iteration */
 typedef void (*sy_foreach_func)(const gchar *name, gdouble value,
     gboolean is_calculated, const gchar *expression,
@@ -82,6 +102,7 @@ void sy_foreach(sy_foreach_func func, gpointer user_data);
  * name: symbol name
  * override_value: new override value
  * active: whether override is active
+ * Re-evaluates the calculated symbols that depend on name
  * Returns: TRUE on success, FALSE if symbol not found
  */
 gboolean sy_set_override(const gchar *name, gdouble override_value, gboolean active);
@@ -107,6 +128,11 @@ gboolean sy_set_opt(const gchar *name, gboolean active);
  */
 gboolean sy_save_overrides(const gchar *filename);
 
+/* Serialize symbol overrides in the .sy file format, at full precision
+ * Returns: newly allocated text for g_free(), NULL if no symbol table
+ */
+gchar *sy_overrides_text(void);
+
 /* Get count of symbols in symbol table */
 guint sy_get_count(void);
 
@@ -1198,6 +1198,12 @@ sy_overrides_refresh(void)
   if( sy_overrides_window == NULL )
     return;
 
+  if( !ui_thread_is_self() )
+  {
+    BUG("sy_overrides_refresh: called off the GTK thread\n");
+    return;
+  }
+
   clear_rows();
 
   collect_array = g_ptr_array_new();
@@ -17,6 +17,7 @@
  *    https://www.xnec2c.org/
  */
 
+#include "shared.h"
 #include "touchstone.h"
 
 /* Both .s2p variants carry the same nine columns and differ only in the
@@ -67,3 +68,367 @@ const touchstone_layout_t touchstone_layouts[TOUCHSTONE_COUNT] = {
 		.format  = TOUCHSTONE_S2P_FORMAT("gain_viewer_net"),
 	},
 };
+
+/*-----------------------------------------------------------------------*/
+
+/* Number formats of the option line */
+typedef enum
+{
+	TS_FMT_MA,
+	TS_FMT_DB,
+	TS_FMT_RI,
+} touchstone_fmt_t;
+
+/* Frequency and the four complex parameters of one .s2p data row */
+#define TS_ROW_LEN      (1 + 2 * TS_NPARAM)
+
+/* The network applied to the measurements, or NULL.
+ * Swapped under freq_data_lock, which meas_calc() holds. */
+static touchstone_network_t *network_active = NULL;
+
+/* Parses the option line "# <unit> <param> <format> R <z0>" */
+static gboolean touchstone_options(const char *path, char *line,
+	double *unit, touchstone_fmt_t *fmt, double *z0)
+{
+	char *save = NULL;
+	char *tok;
+
+	for (tok = strtok_r(line + 1, " \t\r\n", &save); tok != NULL;
+		tok = strtok_r(NULL, " \t\r\n", &save))
+	{
+		if (g_ascii_strcasecmp(tok, "HZ") == 0)
+			*unit = 1.0;
+		else if (g_ascii_strcasecmp(tok, "KHZ") == 0)
+			*unit = 1.0e3;
+		else if (g_ascii_strcasecmp(tok, "MHZ") == 0)
+			*unit = 1.0e6;
+		else if (g_ascii_strcasecmp(tok, "GHZ") == 0)
+			*unit = 1.0e9;
+		else if (g_ascii_strcasecmp(tok, "MA") == 0)
+			*fmt = TS_FMT_MA;
+		else if (g_ascii_strcasecmp(tok, "DB") == 0)
+			*fmt = TS_FMT_DB;
+		else if (g_ascii_strcasecmp(tok, "RI") == 0)
+			*fmt = TS_FMT_RI;
+		else if (g_ascii_strcasecmp(tok, "S") == 0)
+			continue;
+		else if (g_ascii_strcasecmp(tok, "R") == 0)
+		{
+			tok = strtok_r(NULL, " \t\r\n", &save);
+			if (tok == NULL || (*z0 = g_ascii_strtod(tok, NULL)) <= 0.0)
+			{
+				pr_err("%s: bad reference resistance on the option line\n", path);
+				return FALSE;
+			}
+		}
+		else
+		{
+			pr_err("%s: unsupported option \"%s\"; only S-parameters are read\n",
+				path, tok);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* One complex parameter from its pair of columns */
+static complex double touchstone_value(touchstone_fmt_t fmt, double a, double b)
+{
+	switch (fmt)
+	{
+		case TS_FMT_RI:
+			return a + I * b;
+		case TS_FMT_DB:
+			return pow(10.0, a / 20.0) * cexp(I * b * (double)TORAD);
+		case TS_FMT_MA:
+		default:
+			return a * cexp(I * b * (double)TORAD);
+	}
+}
+
+gboolean touchstone_read(const char *path, touchstone_network_t *net)
+{
+	FILE *fp;
+	char *line = NULL;
+	size_t line_len = 0;
+	double row[TS_ROW_LEN];
+	double unit = 1.0e9;
+	double z0 = 50.0;
+	touchstone_fmt_t fmt = TS_FMT_MA;
+	gboolean two_port, order_12_21 = FALSE;
+	gboolean ok = TRUE, done = FALSE;
+	int ncol = 0;
+
+	memset(net, 0, sizeof(*net));
+
+	fp = fopen(path, "r");
+	if (fp == NULL)
+	{
+		pr_err("%s: %s\n", path, strerror(errno));
+		return FALSE;
+	}
+
+	/* Version 1 files carry their port count in the extension */
+	{
+		char *lower = g_ascii_strdown(path, -1);
+		two_port = g_str_has_suffix(lower, ".s2p");
+		g_free(lower);
+	}
+
+	while (ok && !done && getline(&line, &line_len, fp) >= 0)
+	{
+		char *p = strchr(line, '!');
+		char *end;
+
+		if (p != NULL)
+			*p = '\0';
+
+		p = line;
+		while (g_ascii_isspace(*p))
+			p++;
+
+		if (*p == '#')
+		{
+			ok = touchstone_options(path, p, &unit, &fmt, &z0);
+			continue;
+		}
+
+		/* Version 2 keywords */
+		if (*p == '[')
+		{
+			if (g_ascii_strncasecmp(p, "[Number of Ports]", 17) == 0)
+				two_port = (atoi(p + 17) == 2);
+			else if (g_ascii_strncasecmp(p, "[Two-Port Data Order]", 21) == 0)
+				order_12_21 = (strstr(p + 21, "12_21") != NULL);
+			else if (g_ascii_strncasecmp(p, "[Reference]", 11) == 0)
+			{
+				double r = g_ascii_strtod(p + 11, &end);
+				if (end != p + 11 && r > 0.0)
+					z0 = r;
+			}
+			else if (g_ascii_strncasecmp(p, "[Noise Data]", 12) == 0
+				|| g_ascii_strncasecmp(p, "[End]", 5) == 0)
+				done = TRUE;
+			continue;
+		}
+
+		/* A row may continue over several lines */
+		for (;;)
+		{
+			double v = g_ascii_strtod(p, &end);
+
+			if (end == p)
+				break;
+
+			/* Noise parameters start at a frequency not above the last */
+			if (ncol == 0 && net->count > 0 && v * unit <= net->hz[net->count - 1])
+			{
+				done = TRUE;
+				break;
+			}
+
+			p = end;
+			row[ncol++] = v;
+
+			if (ncol < TS_ROW_LEN)
+				continue;
+			ncol = 0;
+
+			mem_array_reserve(&net->hz, net->count + 1, 64);
+			mem_array_reserve(&net->s, TS_NPARAM * (net->count + 1), 4 * 64);
+
+			complex double *s = &net->s[TS_NPARAM * net->count];
+			net->hz[net->count] = row[0] * unit;
+			for (int i = 0; i < TS_NPARAM; i++)
+				s[i] = touchstone_value(fmt, row[1 + 2 * i], row[2 + 2 * i]);
+
+			if (order_12_21)
+			{
+				complex double s12 = s[TS_S21];
+				s[TS_S21] = s[TS_S12];
+				s[TS_S12] = s12;
+			}
+
+			net->count++;
+		}
+
+		while (g_ascii_isspace(*p))
+			p++;
+		if (!done && *p != '\0')
+		{
+			pr_err("%s: unexpected \"%s\"\n", path, p);
+			ok = FALSE;
+		}
+	}
+
+	free(line);
+	fclose(fp);
+
+	if (ok && !two_port)
+	{
+		pr_err("%s: not a two-port (.s2p) Touchstone file\n", path);
+		ok = FALSE;
+	}
+	else if (ok && ncol != 0 && !done)
+	{
+		pr_err("%s: last data row is incomplete\n", path);
+		ok = FALSE;
+	}
+	else if (ok && net->count == 0)
+	{
+		pr_err("%s: no network data\n", path);
+		ok = FALSE;
+	}
+
+	if (!ok)
+	{
+		touchstone_network_free(net);
+		return FALSE;
+	}
+
+	net->z0 = z0;
+	net->path = mem_strdup(path);
+
+	return TRUE;
+}
+
+void touchstone_network_free(touchstone_network_t *net)
+{
+	mem_array_free(&net->hz);
+	mem_array_free(&net->s);
+	mem_free(&net->path);
+	net->count = 0;
+}
+
+gboolean touchstone_interp(const touchstone_network_t *net, double hz,
+	complex double s[TS_NPARAM])
+{
+	int lo = 0, hi = net->count - 1;
+	double t;
+
+	if (net->count == 0 || hz < net->hz[0] || hz > net->hz[hi])
+		return FALSE;
+
+	/* Bisect to the pair of points around hz */
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2;
+
+		if (net->hz[mid] <= hz)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	t = (hi == lo) ? 0.0 : (hz - net->hz[lo]) / (net->hz[hi] - net->hz[lo]);
+	for (int i = 0; i < TS_NPARAM; i++)
+		s[i] = net->s[TS_NPARAM * lo + i] * (1.0 - t) + net->s[TS_NPARAM * hi + i] * t;
+
+	return TRUE;
+}
+
+/*-----------------------------------------------------------------------*/
+
+gboolean touchstone_network_load(const char *path)
+{
+	touchstone_network_t *net = NULL;
+	touchstone_network_t *old;
+
+	if (path != NULL)
+	{
+		mem_new(&net);
+		if (!touchstone_read(path, net))
+		{
+			mem_free(&net);
+			return FALSE;
+		}
+
+		pr_notice("network %s: %d points, %.6g to %.6g MHz, R %g\n",
+			path, net->count, net->hz[0] / 1.0e6,
+			net->hz[net->count - 1] / 1.0e6, net->z0);
+	}
+
+	g_rec_mutex_lock(&freq_data_lock);
+	old = network_active;
+	network_active = net;
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	if (old != NULL)
+	{
+		touchstone_network_free(old);
+		mem_free(&old);
+	}
+
+	return TRUE;
+}
+
+gboolean touchstone_network_apply(double mhz, complex double *z, double zo,
+	double *gain_db)
+{
+	complex double s[TS_NPARAM];
+	complex double gl, gs, gin;
+	double z0;
+
+	*gain_db = NAN;
+
+	if (network_active == NULL)
+		return FALSE;
+
+	if (!touchstone_interp(network_active, mhz * 1.0e6, s))
+	{
+		*z = NAN;
+		return TRUE;
+	}
+
+	z0 = network_active->z0;
+	gl = (*z - z0) / (*z + z0);
+
+	if (rc_config.network_deembed)
+	{
+		/* Invert the input reflection of the network for its load */
+		complex double d = gl - s[TS_S11];
+
+		gl = d / (s[TS_S12] * s[TS_S21] + s[TS_S22] * d);
+		*z = z0 * (1.0 + gl) / (1.0 - gl);
+		return TRUE;
+	}
+
+	gin = s[TS_S11] + s[TS_S12] * s[TS_S21] * gl / (1.0 - s[TS_S22] * gl);
+	*z = z0 * (1.0 + gin) / (1.0 - gin);
+
+	/* Transducer gain of the network between the source and the feedpoint */
+	gs = (zo - z0) / (zo + z0);
+	*gain_db = 10.0 * log10(
+		cabs(s[TS_S21]) * cabs(s[TS_S21])
+		* (1.0 - cabs(gs) * cabs(gs)) * (1.0 - cabs(gl) * cabs(gl))
+		/ pow(cabs((1.0 - s[TS_S11] * gs) * (1.0 - s[TS_S22] * gl)
+			- s[TS_S12] * s[TS_S21] * gs * gl), 2.0));
+
+	return TRUE;
+}
+
+gchar *touchstone_network_digest(void)
+{
+	GChecksum *sum;
+	gchar *text = NULL;
+
+	g_rec_mutex_lock(&freq_data_lock);
+
+	if (network_active != NULL)
+	{
+		sum = g_checksum_new(G_CHECKSUM_SHA256);
+		g_checksum_update(sum, (const guchar *)&network_active->z0,
+			sizeof(network_active->z0));
+		g_checksum_update(sum, (const guchar *)network_active->hz,
+			(gsize)network_active->count * sizeof(double));
+		g_checksum_update(sum, (const guchar *)network_active->s,
+			(gsize)network_active->count * TS_NPARAM * sizeof(complex double));
+		text = g_strdup(g_checksum_get_string(sum));
+		g_checksum_free(sum);
+	}
+
+	g_rec_mutex_unlock(&freq_data_lock);
+
+	return text;
+}
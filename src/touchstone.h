@@ -20,6 +20,9 @@
 #ifndef TOUCHSTONE_H
 #define TOUCHSTONE_H    1
 
+#include <complex.h>
+#include <glib.h>
+
 /* Touchstone file variants offered by the frequency plots save dialog. */
 typedef enum
 {
@@ -43,4 +46,91 @@ typedef struct
 
 extern const touchstone_layout_t touchstone_layouts[TOUCHSTONE_COUNT];
 
+/* S-parameters of a two-port read from a Touchstone .s2p file.
+ *
+ * @count: frequency points
+ * @hz:    ascending point frequencies in Hz
+ * @s:     four per point, in file order: S11, S21, S12, S22
+ * @z0:    reference resistance of the file's option line
+ * @path:  file the network was read from
+ */
+typedef struct
+{
+	int count;
+	double *hz;
+	complex double *s;
+	double z0;
+	char *path;
+} touchstone_network_t;
+
+/* Port 1 of the network faces the transmitter and port 2 the feedpoint. */
+enum
+{
+	TS_S11,
+	TS_S21,
+	TS_S12,
+	TS_S22,
+	TS_NPARAM
+};
+
+/* touchstone_read - read the S-parameters of a .s2p file
+ * @path: Touchstone 1.x or 2.0 two-port file
+ * @net:  filled on success; release with touchstone_network_free()
+ *
+ * Accepts Hz/kHz/MHz/GHz, RI/MA/DB and any reference resistance.  Noise
+ * parameters after the network data are ignored.  Returns FALSE, having
+ * logged why, if the file cannot be read or is not a two-port.
+ */
+gboolean touchstone_read(const char *path, touchstone_network_t *net);
+
+/* touchstone_network_free - release what touchstone_read() allocated */
+void touchstone_network_free(touchstone_network_t *net);
+
+/* touchstone_interp - S-parameters of a network at one frequency
+ * @net: network
+ * @hz:  frequency
+ * @s:   TS_NPARAM values, interpolated linearly in real and imaginary
+ *       parts between the two nearest points
+ *
+ * Returns FALSE if @hz lies outside the points of the file.
+ */
+gboolean touchstone_interp(const touchstone_network_t *net, double hz,
+	complex double s[TS_NPARAM]);
+
+/* touchstone_network_load - make a .s2p file the active network
+ * @path: file to read, or NULL to remove the active network
+ *
+ * The active network is applied by touchstone_network_apply() when the
+ * measurements of a step are computed, so loading, swapping or removing
+ * it changes every plot and export without solving the model again.
+ * Returns FALSE, keeping the previous network, if @path does not read.
+ */
+gboolean touchstone_network_load(const char *path);
+
+/* touchstone_network_apply - move a feedpoint impedance through the network
+ * @mhz:     frequency of the step
+ * @z:       in: the feedpoint impedance, out: the impedance at the
+ *           reference plane the network moves it to
+ * @zo:      system impedance of the source
+ * @gain_db: out: power gain from a source of impedance @zo to the
+ *           feedpoint, in dB, or NAN when de-embedding
+ *
+ * Cascading, the network is inserted between the source and the
+ * feedpoint, so @z becomes the impedance at its port 1.  De-embedding
+ * (rc_config.network_deembed), the model is taken to include the network
+ * between its feedpoint and the antenna, so @z becomes the impedance at
+ * port 2.  Returns FALSE, leaving @z alone, when no network is active and
+ * sets @z to NAN when the step lies outside the network's frequencies.
+ */
+gboolean touchstone_network_apply(double mhz, complex double *z, double zo,
+	double *gain_db);
+
+/* touchstone_network_digest - identify the active network
+ *
+ * Returns a SHA-256 of the active network's points and reference
+ * impedance, for a cache of results the network changes, or NULL when
+ * no network is active.  The caller frees the string with g_free().
+ */
+gchar *touchstone_network_digest(void);
+
 #endif
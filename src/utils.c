@@ -29,6 +29,35 @@
 #include "shared.h"
 
 
+/*------------------------------------------------------------------------*/
+
+/* The thread that runs gtk_main(), recorded by ui_thread_init() */
+static GThread *ui_thread = NULL;
+
+/**
+ * ui_thread_init() - record the calling thread as the GTK thread
+ *
+ * Called once from main() before any other thread starts.
+ */
+void ui_thread_init(void)
+{
+	ui_thread = g_thread_self();
+}
+
+/**
+ * ui_thread_is_self() - whether the caller may touch widgets
+ *
+ * The optimizer reparses candidates and runs their sweeps on its own thread
+ * under HEADLESS_EVAL; every widget and dialog call on that path is gated
+ * on the flag, and the UI entry points check this to catch one that is not.
+ *
+ * Return: TRUE on the GTK thread, or before ui_thread_init()
+ */
+gboolean ui_thread_is_self(void)
+{
+	return (ui_thread == NULL || g_thread_self() == ui_thread);
+}
+
 /*------------------------------------------------------------------------*/
 
 /* Bounds of the notice message body: the column count the text wraps at and
@@ -256,6 +285,14 @@ static int notice_run(GtkButtonsType buttons, const char *title,
 	else
 		g_rec_mutex_unlock(&freq_data_lock);
 
+	/* A dialog off the GTK thread would race the main loop; report the
+	 * path that reached it and fall back to the terminal */
+	if (!ui_thread_is_self())
+	{
+		BUG("notice raised off the GTK thread: %s\n", title);
+		locked = 1;
+	}
+
 	if (locked || rc_config.batch_mode)
 	{
 		pr_err("\n=== Notice: %s ===\n%s\n\n", title, message);
@@ -416,8 +453,9 @@ Stop( int err, const char *format, ... )
 
   pr_err("Stop: %s\n", mesg);
 
-  /* For child processes */
-  if( CHILD )
+  /* For child processes, and the optimizer's off-thread reparse which
+   * must not raise a dialog */
+  if( CHILD || isFlagSet(HEADLESS_EVAL) )
   {
     if( err )
     {
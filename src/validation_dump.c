@@ -1,7 +1,12 @@
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <locale.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "mathlib.h"
 #include "measurements.h"
@@ -9,16 +14,26 @@
 #include "prerender/prerender_color.h"
 #include "chroma/chroma_nearfield.h"
 #include "shared.h"
+#include "touchstone.h"
 #include "validation_dump.h"
 
 /* Directory set by validation_dump_set_dir(); NULL disables all output. */
 static char *validation_dir = NULL;
 
+/* Tree set by validation_dump_set_reference() whose sections.sha256 decides
+ * which CSV files need writing; NULL writes them all. */
+static char *validation_ref = NULL;
+
 void validation_dump_set_dir(char *dir)
 {
 	validation_dir = dir;
 }
 
+void validation_dump_set_reference(char *dir)
+{
+	validation_ref = dir;
+}
+
 void validation_dump_force_config(void)
 {
 	mathlib_t *lib;
@@ -67,6 +82,15 @@ void validation_dump_force_config(void)
 	calc_data.pol_type = POL_TOTAL;
 	pr_notice("validation: forced polarization to total for reproducibility\n");
 
+	/* Drop any --network two-port: it rewrites every impedance-derived
+	 * measurement column, and the reference data describe the bare model. */
+	if (rc_config.filename_network != NULL)
+	{
+		touchstone_network_load(NULL);
+		rc_config.network_deembed = 0;
+		pr_notice("validation: removed the Touchstone network for reproducibility\n");
+	}
+
 	/* Pin the structure viewer to its default orientation, matching the reset
 	 * button (set_view_preset for the default preset).  Viewer_Gain() and
 	 * Viewer_Noise_Value() resolve the viewing direction from structure_view's
@@ -79,21 +103,6 @@ void validation_dump_force_config(void)
 	pr_notice("validation: reset structure viewer to default orientation for reproducibility\n");
 }
 
-/*
- * dump_each - open a file under validation_dir, call dumper, close
- */
-static void dump_each(const char *name, void (*dumper)(FILE *))
-{
-	char path[4096];
-	FILE *fp = NULL;
-
-	snprintf(path, sizeof(path), "%s/%s", validation_dir, name);
-	if (!Open_File(&fp, path, "w"))
-		return;
-	dumper(fp);
-	fclose(fp);
-}
-
 /* measurements.csv
  * meas_write_header/meas_write_data already iterate all fsteps */
 static void dump_measurements(FILE *fp)
@@ -591,6 +600,456 @@ static void dump_geom_topology(FILE *fp)
 }
 
 
+/*-----------------------------------------------------------------------
+ * Section hashes
+ *
+ * A section is one array the CSV files are printed from, hashed as the raw
+ * binary the solver left in memory.  Two trees whose sections.sha256 match
+ * print identical text, so comparing builds is a diff of that file, and
+ * --validation-reference writes only the CSV files whose sections differ.
+ * Structs that carry padding or pointers are hashed field by field.
+ *----------------------------------------------------------------------*/
+
+#define HASH(sum, ptr, len) \
+	g_checksum_update((sum), (const guchar *)(ptr), (gssize)(len))
+
+static int step_saved(int fs)
+{
+	return save.fstep[fs];
+}
+
+static int step_rdpat(int fs)
+{
+	return save.fstep[fs] && isFlagSet(ENABLE_RDPAT);
+}
+
+static int step_crnt(int fs)
+{
+	return CRNT_FSTEP_AVAILABLE(fs);
+}
+
+static int step_nf(int fs)
+{
+	return NF_FSTEP_AVAILABLE(fs);
+}
+
+/* Hash @count elements of one per-step buffer member of each step @avail
+ * accepts, each preceded by its step index */
+#define HASH_STEP_MEMBER(fn, array, member, count, avail) \
+static void fn(GChecksum *sum) \
+{ \
+	if (array == NULL) \
+		return; \
+	for (int fs = 0; fs < calc_data.steps_total; fs++) \
+	{ \
+		if (!avail(fs)) \
+			continue; \
+		HASH(sum, &fs, sizeof(fs)); \
+		HASH(sum, array[fs].member, \
+			(size_t)(count) * sizeof(*array[fs].member)); \
+	} \
+}
+
+HASH_STEP_MEMBER(hash_rdpat_gtot, rad_pattern, gtot, fpat.nph * fpat.nth, step_rdpat)
+HASH_STEP_MEMBER(hash_rdpat_tilt, rad_pattern, tilt, fpat.nph * fpat.nth, step_rdpat)
+HASH_STEP_MEMBER(hash_rdpat_axrt, rad_pattern, axrt, fpat.nph * fpat.nth, step_rdpat)
+HASH_STEP_MEMBER(hash_rdpat_sens, rad_pattern, sens, fpat.nph * fpat.nth, step_rdpat)
+
+HASH_STEP_MEMBER(hash_crnt_air, crnt_fstep, air, data.n, step_crnt)
+HASH_STEP_MEMBER(hash_crnt_aii, crnt_fstep, aii, data.n, step_crnt)
+HASH_STEP_MEMBER(hash_crnt_bir, crnt_fstep, bir, data.n, step_crnt)
+HASH_STEP_MEMBER(hash_crnt_bii, crnt_fstep, bii, data.n, step_crnt)
+HASH_STEP_MEMBER(hash_crnt_cir, crnt_fstep, cir, data.n, step_crnt)
+HASH_STEP_MEMBER(hash_crnt_cii, crnt_fstep, cii, data.n, step_crnt)
+HASH_STEP_MEMBER(hash_crnt_cur, crnt_fstep, cur, data.np3m, step_crnt)
+
+HASH_STEP_MEMBER(hash_zreal,  impedance_data, zreal,  Num_Feedpoint_Ports(), step_saved)
+HASH_STEP_MEMBER(hash_zimag,  impedance_data, zimag,  Num_Feedpoint_Ports(), step_saved)
+HASH_STEP_MEMBER(hash_zmagn,  impedance_data, zmagn,  Num_Feedpoint_Ports(), step_saved)
+HASH_STEP_MEMBER(hash_zphase, impedance_data, zphase, Num_Feedpoint_Ports(), step_saved)
+
+HASH_STEP_MEMBER(hash_nf_points, near_field_fstep, points,
+	fpat.nrx * fpat.nry * fpat.nrz, step_nf)
+
+/* Saved step indices and their frequencies, printed in every per-step row */
+static void hash_steps(GChecksum *sum)
+{
+	for (int fs = 0; fs < calc_data.steps_total; fs++)
+	{
+		if (!save.fstep[fs])
+			continue;
+		HASH(sum, &fs, sizeof(fs));
+		HASH(sum, &save.freq[fs], sizeof(save.freq[fs]));
+	}
+}
+
+/* Pattern and near-field grids and which fields were asked for */
+static void hash_grid(GChecksum *sum)
+{
+	int rdpat = isFlagSet(ENABLE_RDPAT) ? 1 : 0;
+	int grid[] = { fpat.nth, fpat.nph, fpat.nrx, fpat.nry, fpat.nrz,
+		fpat.nfeh, rdpat };
+	double angles[] = { fpat.thets, fpat.phis, fpat.dth, fpat.dph };
+
+	HASH(sum, grid, sizeof(grid));
+	HASH(sum, angles, sizeof(angles));
+}
+
+static void hash_segments(GChecksum *sum)
+{
+	for (int i = 0; i < data.n; i++)
+	{
+		wire_segment_t *seg = &data.segments[i];
+		double ends[] = { seg->x1, seg->y1, seg->z1, seg->x2, seg->y2, seg->z2 };
+
+		HASH(sum, ends, sizeof(ends));
+		HASH(sum, &seg->itag, sizeof(seg->itag));
+	}
+}
+
+/* Patch tangents and the unscaled centers and areas of the patches */
+static void hash_patches(GChecksum *sum)
+{
+	for (int i = 0; i < data.m; i++)
+	{
+		surface_patch_t *p = &data.patches[i];
+		int gi = data.n + i;
+		double v[] = { p->t1x, p->t1y, p->t1z, p->t2x, p->t2y, p->t2z,
+			save.xtemp[gi], save.ytemp[gi], save.ztemp[gi], save.bitemp[gi] };
+
+		HASH(sum, v, sizeof(v));
+	}
+}
+
+static void hash_feedpoints(GChecksum *sum)
+{
+	for (int p = 0; p < Num_Feedpoint_Ports(); p++)
+	{
+		int seg = Feedpoint_Port_Seg(p);
+		int tag = Feedpoint_Port_Tag(p);
+		complex double V = Feedpoint_Port_Voltage(p);
+
+		HASH(sum, &seg, sizeof(seg));
+		HASH(sum, &tag, sizeof(tag));
+		HASH(sum, &V, sizeof(V));
+	}
+}
+
+static void hash_noise_temp(GChecksum *sum)
+{
+	if (noise_temp == NULL)
+		return;
+
+	for (int fs = 0; fs < calc_data.steps_total; fs++)
+	{
+		if (!save.fstep[fs])
+			continue;
+		HASH(sum, &fs, sizeof(fs));
+		HASH(sum, &noise_temp[fs], sizeof(noise_temp_t));
+	}
+}
+
+static void hash_struct_colors(GChecksum *sum)
+{
+	if (struct_colors == NULL)
+		return;
+
+	for (int fs = 0; fs < calc_data.steps_total; fs++)
+	{
+		if (!save.fstep[fs])
+			continue;
+
+		struct_colors_t *sc = &struct_colors[fs];
+		float ranges[] = { sc->wire_crnt_cmin, sc->wire_crnt_cmax,
+			sc->wire_chrg_cmin, sc->wire_chrg_cmax,
+			sc->patch_crnt_cmin, sc->patch_crnt_cmax };
+
+		HASH(sum, &fs, sizeof(fs));
+		HASH(sum, ranges, sizeof(ranges));
+		if (sc->patch_flow_data != NULL)
+			HASH(sum, sc->patch_flow_data, (size_t)data.m * sizeof(*sc->patch_flow_data));
+	}
+}
+
+static void hash_geom_aggregate(GChecksum *sum)
+{
+	double v[] = { geom_pre.scene_radius, geom_pre.excitation_cx,
+		geom_pre.excitation_cy, geom_pre.excitation_cz, geom_pre.nf_dr_norm };
+
+	HASH(sum, v, sizeof(v));
+	if (geom_pre.patch_corners != NULL)
+		HASH(sum, geom_pre.patch_corners, (size_t)data.m * sizeof(patch_corners_t));
+	if (geom_pre.patch_tangent_frame != NULL)
+		HASH(sum, geom_pre.patch_tangent_frame,
+			(size_t)data.m * sizeof(patch_tangent_frame_t));
+}
+
+static void hash_geom_trig(GChecksum *sum)
+{
+	if (geom_pre.sin_theta != NULL)
+	{
+		HASH(sum, geom_pre.sin_theta,   (size_t)fpat.nth * sizeof(double));
+		HASH(sum, geom_pre.cos_theta,   (size_t)fpat.nth * sizeof(double));
+		HASH(sum, geom_pre.solid_angle, (size_t)fpat.nth * sizeof(double));
+	}
+	if (geom_pre.sin_phi != NULL)
+	{
+		HASH(sum, geom_pre.sin_phi, (size_t)fpat.nph * sizeof(double));
+		HASH(sum, geom_pre.cos_phi, (size_t)fpat.nph * sizeof(double));
+	}
+}
+
+static void hash_geom_topology(GChecksum *sum)
+{
+	HASH(sum, &geom_pre.n_theta_edges, sizeof(geom_pre.n_theta_edges));
+	HASH(sum, &geom_pre.n_phi_edges, sizeof(geom_pre.n_phi_edges));
+	if (geom_pre.n_theta_edges > 0)
+		HASH(sum, geom_pre.theta_topo, (size_t)geom_pre.n_theta_edges * sizeof(ff_edge_topo_t));
+	if (geom_pre.n_phi_edges > 0)
+		HASH(sum, geom_pre.phi_topo, (size_t)geom_pre.n_phi_edges * sizeof(ff_edge_topo_t));
+}
+
+typedef struct
+{
+	const char *name;
+	void (*hash)(GChecksum *);
+} dump_section_t;
+
+static const dump_section_t dump_sections[] =
+{
+	{ "steps",                  hash_steps },
+	{ "grid",                   hash_grid },
+	{ "segments",               hash_segments },
+	{ "patches",                hash_patches },
+	{ "feedpoints",             hash_feedpoints },
+	{ "rad_pattern.gtot",       hash_rdpat_gtot },
+	{ "rad_pattern.tilt",       hash_rdpat_tilt },
+	{ "rad_pattern.axrt",       hash_rdpat_axrt },
+	{ "rad_pattern.sens",       hash_rdpat_sens },
+	{ "crnt.air",               hash_crnt_air },
+	{ "crnt.aii",               hash_crnt_aii },
+	{ "crnt.bir",               hash_crnt_bir },
+	{ "crnt.bii",               hash_crnt_bii },
+	{ "crnt.cir",               hash_crnt_cir },
+	{ "crnt.cii",               hash_crnt_cii },
+	{ "crnt.cur",               hash_crnt_cur },
+	{ "impedance.zreal",        hash_zreal },
+	{ "impedance.zimag",        hash_zimag },
+	{ "impedance.zmagn",        hash_zmagn },
+	{ "impedance.zphase",       hash_zphase },
+	{ "near_field.points",      hash_nf_points },
+	{ "noise_temp",             hash_noise_temp },
+	{ "struct_colors",          hash_struct_colors },
+	{ "geom_pre.aggregate",     hash_geom_aggregate },
+	{ "geom_pre.trig",          hash_geom_trig },
+	{ "geom_pre.topology",      hash_geom_topology },
+};
+
+#define NUM_DUMP_SECTIONS   (sizeof(dump_sections) / sizeof(dump_sections[0]))
+
+/*-----------------------------------------------------------------------
+ * Files
+ *----------------------------------------------------------------------*/
+
+/* One CSV file of the tree.  @sections lists, comma-separated, every
+ * section its text is printed from; a file printed through code that
+ * derives its values at dump time, rather than from the arrays alone, has
+ * none and is always written.  @worker marks the dumpers that only read
+ * the published arrays and can run on a thread of their own: the
+ * measurements go through meas_calc(), which takes freq_data_lock itself,
+ * and nf_pre through the chroma projection cache, so both stay on the
+ * calling thread. */
+typedef struct
+{
+	const char *name;
+	void (*dumper)(FILE *);
+	const char *sections;
+	gboolean worker;
+} dump_file_t;
+
+static const dump_file_t dump_files[] =
+{
+	{ "measurements.csv",     dump_measurements,     NULL, FALSE },
+	{ "rdpat.csv",            dump_rdpat,
+		"steps,grid,rad_pattern.gtot,rad_pattern.tilt,rad_pattern.axrt,rad_pattern.sens",
+		TRUE },
+	{ "currents.csv",         dump_currents,
+		"steps,segments,crnt.air,crnt.aii,crnt.bir,crnt.bii,crnt.cir,crnt.cii,crnt.cur",
+		TRUE },
+	{ "patch_currents.csv",   dump_patch_currents,   "steps,patches,crnt.cur", TRUE },
+	{ "nearfield_points.csv", dump_nearfield_points, "steps,grid,near_field.points", TRUE },
+	{ "nf_pre.csv",           dump_nf_pre,           NULL, FALSE },
+	{ "struct_colors.csv",    dump_struct_colors,    "steps,struct_colors", TRUE },
+	{ "noise_temp.csv",       dump_noise_temp,       "steps,noise_temp", TRUE },
+	{ "impedance.csv",        dump_impedance,
+		"steps,feedpoints,segments,impedance.zreal,impedance.zimag,"
+		"impedance.zmagn,impedance.zphase",
+		TRUE },
+	{ "geom_aggregate.csv",   dump_geom_aggregate,   "geom_pre.aggregate", TRUE },
+	{ "geom_trig.csv",        dump_geom_trig,        "grid,geom_pre.trig", TRUE },
+	{ "geom_topology.csv",    dump_geom_topology,    "geom_pre.topology", TRUE },
+};
+
+#define NUM_DUMP_FILES      (sizeof(dump_files) / sizeof(dump_files[0]))
+
+/* A file being written: the stream a dumper prints to hashes each buffer
+ * on its way to the file, so the manifest costs no second read. */
+typedef struct
+{
+	const dump_file_t *file;
+	FILE *out;
+	FILE *fp;
+	GChecksum *sum;
+	pthread_t thread;
+	gboolean threaded;
+	gboolean failed;
+} dump_job_t;
+
+static ssize_t dump_job_write(void *cookie, const char *buf, size_t size)
+{
+	dump_job_t *job = cookie;
+
+	g_checksum_update(job->sum, (const guchar *)buf, (gssize)size);
+	if (fwrite(buf, 1, size, job->out) != size)
+	{
+		job->failed = TRUE;
+		return 0;
+	}
+
+	return (ssize_t)size;
+}
+
+static int dump_job_close(void *cookie)
+{
+	dump_job_t *job = cookie;
+
+	if (fclose(job->out) != 0)
+		job->failed = TRUE;
+
+	return job->failed ? EOF : 0;
+}
+
+static void *dump_job_run(void *arg)
+{
+	dump_job_t *job = arg;
+
+	job->file->dumper(job->fp);
+	if (fclose(job->fp) != 0)
+		job->failed = TRUE;
+
+	return NULL;
+}
+
+/*
+ * dump_job_open - open the file of @job under validation_dir for hashing
+ */
+static gboolean dump_job_open(dump_job_t *job)
+{
+	cookie_io_functions_t io = { .write = dump_job_write, .close = dump_job_close };
+	char path[4096];
+
+	snprintf(path, sizeof(path), "%s/%s", validation_dir, job->file->name);
+	if (!Open_File(&job->out, path, "w"))
+		return FALSE;
+
+	job->sum = g_checksum_new(G_CHECKSUM_SHA256);
+	job->fp = fopencookie(job, "w", io);
+	if (job->fp == NULL)
+	{
+		pr_err("validation: %s: %s\n", path, strerror(errno));
+		fclose(job->out);
+		g_checksum_free(job->sum);
+		job->sum = NULL;
+		return FALSE;
+	}
+
+	/* Dumpers print a row at a time; pass the file whole blocks */
+	setvbuf(job->fp, NULL, _IOFBF, 1 << 16);
+
+	return TRUE;
+}
+
+/*
+ * read_reference - load the section hashes of the reference tree
+ *
+ * Returns a table of section name to hex digest, or NULL if there is no
+ * reference or its sections.sha256 cannot be read.
+ */
+static GHashTable *read_reference(void)
+{
+	char path[4096], line[256], digest[65], name[128];
+	GHashTable *ref;
+	FILE *fp;
+
+	if (validation_ref == NULL)
+		return NULL;
+
+	snprintf(path, sizeof(path), "%s/sections.sha256", validation_ref);
+	fp = fopen(path, "r");
+	if (fp == NULL)
+	{
+		pr_warn("validation: %s: %s; writing every file\n", path, strerror(errno));
+		return NULL;
+	}
+
+	ref = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	while (fgets(line, sizeof(line), fp) != NULL)
+		if (sscanf(line, "%64s %127s", digest, name) == 2)
+			g_hash_table_insert(ref, g_strdup(name), g_strdup(digest));
+	fclose(fp);
+
+	return ref;
+}
+
+/* True when every section of @file has the digest it had in @ref */
+static gboolean sections_match(const dump_file_t *file, GHashTable *ref,
+	char digests[][65])
+{
+	gchar **names;
+	gboolean match = TRUE;
+
+	if (ref == NULL || file->sections == NULL)
+		return FALSE;
+
+	names = g_strsplit(file->sections, ",", -1);
+	for (int i = 0; names[i] != NULL && match; i++)
+	{
+		const char *want = g_hash_table_lookup(ref, names[i]);
+		size_t s;
+
+		for (s = 0; s < NUM_DUMP_SECTIONS; s++)
+			if (strcmp(dump_sections[s].name, names[i]) == 0)
+				break;
+
+		if (s == NUM_DUMP_SECTIONS)
+			BUG("validation: %s names unknown section %s\n", file->name, names[i]);
+
+		match = (s < NUM_DUMP_SECTIONS && want != NULL && strcmp(want, digests[s]) == 0);
+	}
+	g_strfreev(names);
+
+	return match;
+}
+
+/*
+ * write_sums - write "digest  name" lines in the sha256sum format
+ */
+static void write_sums(const char *file, const char **names, char digests[][65], size_t count)
+{
+	char path[4096];
+	FILE *fp = NULL;
+
+	snprintf(path, sizeof(path), "%s/%s", validation_dir, file);
+	if (!Open_File(&fp, path, "w"))
+		return;
+
+	for (size_t i = 0; i < count; i++)
+		if (names[i] != NULL)
+			fprintf(fp, "%s  %s\n", digests[i], names[i]);
+
+	fclose(fp);
+}
+
 void Save_Validation_Tree(void)
 {
 	if (validation_dir == NULL)
@@ -617,24 +1076,87 @@ void Save_Validation_Tree(void)
 
 	char *orig = setlocale(LC_NUMERIC, "C");
 
+	dump_job_t jobs[NUM_DUMP_FILES] = { { 0 } };
+	char sections[NUM_DUMP_SECTIONS][65];
+	char files[NUM_DUMP_FILES][65];
+	const char *section_names[NUM_DUMP_SECTIONS];
+	const char *file_names[NUM_DUMP_FILES] = { NULL };
+	GHashTable *ref = read_reference();
+	int skipped = 0;
+
 	g_rec_mutex_lock(&freq_data_lock);
 
-	dump_each("measurements.csv",     dump_measurements);
-	dump_each("rdpat.csv",            dump_rdpat);
-	dump_each("currents.csv",         dump_currents);
-	dump_each("patch_currents.csv",   dump_patch_currents);
-	dump_each("nearfield_points.csv", dump_nearfield_points);
-	dump_each("nf_pre.csv",           dump_nf_pre);
-	dump_each("struct_colors.csv",    dump_struct_colors);
-	dump_each("noise_temp.csv",       dump_noise_temp);
-	dump_each("impedance.csv",        dump_impedance);
-	dump_each("geom_aggregate.csv",   dump_geom_aggregate);
-	dump_each("geom_trig.csv",        dump_geom_trig);
-	dump_each("geom_topology.csv",    dump_geom_topology);
+	for (size_t s = 0; s < NUM_DUMP_SECTIONS; s++)
+	{
+		GChecksum *sum = g_checksum_new(G_CHECKSUM_SHA256);
+
+		dump_sections[s].hash(sum);
+		g_strlcpy(sections[s], g_checksum_get_string(sum), sizeof(sections[s]));
+		section_names[s] = dump_sections[s].name;
+		g_checksum_free(sum);
+	}
+
+	/* A file whose sections all match the reference would print the same
+	 * text; remove any stale copy so the tree holds only what differs */
+	for (size_t i = 0; i < NUM_DUMP_FILES; i++)
+	{
+		jobs[i].file = &dump_files[i];
+
+		if (sections_match(&dump_files[i], ref, sections))
+		{
+			char path[4096];
+
+			snprintf(path, sizeof(path), "%s/%s", validation_dir, dump_files[i].name);
+			unlink(path);
+			skipped++;
+			continue;
+		}
+
+		if (!dump_job_open(&jobs[i]))
+			continue;
+
+		/* freq_data_lock stays held here until every worker is joined, so
+		 * nothing the workers read can change under them */
+		if (dump_files[i].worker)
+			jobs[i].threaded =
+				(pthread_create(&jobs[i].thread, NULL, dump_job_run, &jobs[i]) == 0);
+	}
+
+	for (size_t i = 0; i < NUM_DUMP_FILES; i++)
+		if (jobs[i].fp != NULL && !jobs[i].threaded)
+			dump_job_run(&jobs[i]);
+
+	for (size_t i = 0; i < NUM_DUMP_FILES; i++)
+	{
+		if (jobs[i].threaded)
+			pthread_join(jobs[i].thread, NULL);
+
+		if (jobs[i].sum == NULL)
+			continue;
+
+		if (jobs[i].failed)
+			pr_err("validation: error writing %s/%s\n", validation_dir, jobs[i].file->name);
+		else
+		{
+			g_strlcpy(files[i], g_checksum_get_string(jobs[i].sum), sizeof(files[i]));
+			file_names[i] = jobs[i].file->name;
+		}
+		g_checksum_free(jobs[i].sum);
+	}
 
 	g_rec_mutex_unlock(&freq_data_lock);
 
 	setlocale(LC_NUMERIC, orig);
 
+	write_sums("sections.sha256", section_names, sections, NUM_DUMP_SECTIONS);
+	write_sums("manifest.sha256", file_names, files, NUM_DUMP_FILES);
+
+	if (ref != NULL)
+	{
+		g_hash_table_destroy(ref);
+		pr_notice("validation: %d of %d files match %s and were not written\n",
+			skipped, (int)NUM_DUMP_FILES, validation_ref);
+	}
+
 	pr_notice("validation tree written to: %s\n", validation_dir);
 }
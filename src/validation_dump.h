@@ -9,6 +9,14 @@
  */
 void validation_dump_set_dir(char *dir);
 
+/**
+ * validation_dump_set_reference - compare the dump against an earlier tree
+ * @dir: directory of a tree written by an earlier Save_Validation_Tree(),
+ *       whose sections.sha256 is read at dump time.  Pass NULL to write
+ *       every file.
+ */
+void validation_dump_set_reference(char *dir);
+
 /**
  * validation_dump_force_config - force deterministic config for reproducible dumps
  *
@@ -25,8 +33,13 @@ void validation_dump_force_config(void);
  * Save_Validation_Tree - write all NEC engine data structures to CSV files
  *
  * Writes one CSV file per structure type under the directory set by
- * validation_dump_set_dir().  No-ops if the directory was not set or
- * the result set is not published.  Gated by freq_data_lock.
+ * validation_dump_set_dir(), the files that only read the published arrays
+ * each on a thread of their own.  Alongside them it writes manifest.sha256,
+ * the SHA-256 of each CSV file, and sections.sha256, the SHA-256 of the
+ * binary arrays each file is printed from, both in the sha256sum format.
+ * With a reference set, a CSV file whose sections all match the reference
+ * is not written.  No-ops if the directory was not set or the result set
+ * is not published.  Gated by freq_data_lock.
  */
 void Save_Validation_Tree(void);
 
@@ -32,6 +32,7 @@
 #include "plot_freqdata.h"
 #include "rdpattern_ui.h"
 #include "structure_ui.h"
+#include "optimizers/opt_sensitivity.h"
 
 #define BATCH_RDPAT_DEFAULT_PX 800
 
@@ -67,6 +68,13 @@ extern void nec2_eval_signal(void);
 
 static pthread_t *pth_freq_loop = NULL;
 
+/* child_proc_t.assigned_step of a speculative solve: it answers no step
+ * slot and is collected into the speculative cache (freq_spec.c) */
+#define FREQ_SPEC_STEP  -2
+
+/* Upper bound on rc_config.freq_spec_steps */
+#define FREQ_SPEC_MAX_STEPS  64
+
 /* Left-overs from fortran code :-( */
 static double tmp1, tmp2, tmp3, tmp4, tmp5, tmp6;
 
@@ -130,8 +138,9 @@ void freq_step_update_ui( int new_step, gboolean force );
  *
  * Sets calc_data.freq_step to the matching sweep index when freq_mhz matches
  * a cached FR-card step.  If the extra slot already holds valid data for this
- * frequency, returns immediately.  Otherwise starts the frequency loop to
- * compute the extra slot via the child dispatch path.
+ * frequency, or the speculative cache holds it, returns immediately.
+ * Otherwise the caller starts the frequency loop to compute the extra slot
+ * via the child dispatch path.
  *
  * Returns: TRUE when cached data is available and the caller may redraw;
  *          FALSE when computation has been dispatched (redraws follow on
@@ -161,6 +170,18 @@ fetch_freq_data( void )
     return TRUE;
   }
 
+  /* A frequency pre-solved around an earlier selection, or archived by an
+   * earlier sweep, fills the extra slot without a dispatch.  Refused while
+   * a sweep runs, which may be writing the extra slot itself. */
+  if( !freq_sweep_active() &&
+      (freq_spec_cache_restore(calc_data.freq_mhz, calc_data.steps_total) ||
+       sweep_archive_restore(calc_data.freq_mhz, calc_data.steps_total)) )
+  {
+    freq_step_update_ui( calc_data.steps_total, TRUE );
+    g_rec_mutex_unlock(&freq_data_lock);
+    return TRUE;
+  }
+
   g_rec_mutex_unlock(&freq_data_lock);
   return FALSE;
 }
@@ -223,6 +244,10 @@ Frequency_Scale_Geometry(void)
       data.segments[idx].si = save.sitemp[idx]* fr;
       data.segments[idx].bi = save.bitemp[idx]* fr;
     }
+
+    /* Pack the observation records once per frequency so the fill loops
+     * stream one cache line per segment */
+    geometry_pack_segments();
   }
 
   if( data.m != 0)
@@ -356,10 +381,22 @@ Set_Interaction_Matrix( void )
   int iresrv = data.np2m * (data.np + 2 * data.mp);
   if( matpar.imat == 0)
     fblock( netcx.npeq, netcx.neq, iresrv, data.ipsym);
+  netcx.ntsol = 0;
+
+  /* Factors kept from an earlier fill differing only in loads */
+  if( lu_update_restore() )
+  {
+    freq_profile_mark( FREQ_PROF_FILL );
+    freq_profile_mark( FREQ_PROF_FACTOR );
+    return;
+  }
 
   cmset( netcx.neq, cm, calc_data.rkh, calc_data.iexk );
+  freq_profile_mark( FREQ_PROF_FILL );
+
   factrs( netcx.npeq, netcx.neq, cm, save.ip );
-  netcx.ntsol = 0;
+  lu_update_keep();
+  freq_profile_mark( FREQ_PROF_FACTOR );
 
 } /* Set_Interaction_Matrix() */
 
@@ -601,7 +638,8 @@ Power_Loss( void )
   static void
 Radiation_Pattern( void )
 {
-  if( (gnd.ifar != 1) && isFlagSet(ENABLE_RDPAT) )
+  if( (gnd.ifar != 1) && isFlagSet(ENABLE_RDPAT) &&
+      !(calc_data.solve_skip & SOLVE_SKIP_RDPAT) )
   {
     fpat.pinr= netcx.pin;
     fpat.pnlr= netcx.pnls;
@@ -627,7 +665,8 @@ Radiation_Pattern( void )
   void
 Near_Field_Pattern( void )
 {
-  if( isFlagClear(ENABLE_NEAREH) )
+  if( isFlagClear(ENABLE_NEAREH) ||
+      (calc_data.solve_skip & SOLVE_SKIP_NEAREH) )
     return;
 
   /* Step slots outlive a sweep and each pass writes only its own channel,
@@ -661,6 +700,8 @@ New_Frequency( void )
 {
   struct timespec start, end;
   double elapsed;
+  uint64_t blocks;
+  int arena_allocs;
 
   /* Excitation drives every solve below; an absent EX card leaves nothing
    * to solve for */
@@ -679,33 +720,43 @@ New_Frequency( void )
 
   // Only show this if you manually change frequencies:
   clock_gettime(CLOCK_MONOTONIC, &start);
+  blocks = mem_block_allocs();
+  freq_profile_step_begin();
 
   /* Frequency scaling of geometric parameters */
   Frequency_Scale_Geometry();
+  freq_profile_mark( FREQ_PROF_SCALE );
 
   /* Structure segment loading */
   Structure_Impedance_Loading();
+  freq_profile_mark( FREQ_PROF_LOAD );
 
   /* Calculate ground parameters */
   Ground_Parameters();
+  freq_profile_mark( FREQ_PROF_GROUND );
 
-  /* Fill and factor primary interaction matrix */
+  /* Fill and factor primary interaction matrix; marks its own stages */
   Set_Interaction_Matrix();
 
   /* Fill excitation part of matrix */
   Set_Excitation();
+  freq_profile_mark( FREQ_PROF_EXCITE );
 
   /* Matrix solving (netwk calls solves) */
   Set_Network_Data();
+  freq_profile_mark( FREQ_PROF_SOLVE );
 
   /* Calculate power loss */
   Power_Loss();
+  freq_profile_mark( FREQ_PROF_POWER );
 
   /* Calculate radiation pattern */
   Radiation_Pattern();
+  freq_profile_mark( FREQ_PROF_PATTERN );
 
   /* Near field calculation */
   Near_Field_Pattern();
+  freq_profile_mark( FREQ_PROF_NEAR );
 
   /* Per-fstep noise temperature table: frequency is fixed here, so all
    * sky/earth model × method combinations are deterministic and hoistable. */
@@ -714,6 +765,7 @@ New_Frequency( void )
   /* Child-deterministic per-fstep prerender: no user-mutable inputs enter
    * these functions. */
   struct_colors_fill_fstep( calc_data.freq_step );
+  freq_profile_mark( FREQ_PROF_PRERENDER );
 
   if( !CHILD )
   {
@@ -721,6 +773,15 @@ New_Frequency( void )
       save.fstep[calc_data.freq_step] = 1;
   }
 
+  /* Solver scratch dies with the step */
+  arena_allocs = mem_arena_step_allocs();
+  mem_arena_reset();
+
+  /* Managed blocks this step took from posix_memalign, against the scratch
+   * requests the arena absorbed without one */
+  blocks = mem_block_allocs() - blocks;
+  freq_profile_allocs( arena_allocs, blocks );
+
   g_rec_mutex_unlock(&freq_data_lock);
 
   // Calculate elapsed time
@@ -729,6 +790,8 @@ New_Frequency( void )
   elapsed = (end.tv_sec + (double)end.tv_nsec/1e9) - (start.tv_sec + (double)start.tv_nsec/1e9);
   pr_info("%.6f MHz: %f seconds. (%s)\n",
 			calc_data.freq_mhz, elapsed, current_mathlib->name);
+  pr_debug("%.6f MHz: %llu managed allocations, %d arena allocations\n",
+			calc_data.freq_mhz, (unsigned long long)blocks, arena_allocs);
 
 } /* New_Frequency()  */
 
@@ -746,6 +809,9 @@ typedef struct
   struct timespec  t0;           /* Wall-clock start time */
   child_proc_t   **idle_stack;   /* LIFO stack of idle child pointers */
   int              idle_top;     /* Index of top entry; -1 = empty */
+  unsigned         spec_generation; /* Cache generation at speculation start */
+  double           spec_quantum; /* Frequency spin button step, MHz; 0 = none */
+  gboolean         reduced;      /* Steps or step parts left out; see freq_loop_run_reduced() */
 } freq_loop_state_t;
 
 /* Per-sweep state; released by the idle driver or Stop_Frequency_Loop(). */
@@ -899,8 +965,10 @@ freq_step_refresh_ui( gboolean force )
 void
 freq_step_update_ui( int new_step, gboolean force )
 {
+  struct timespec start, end;
   char txt[16];
 
+  clock_gettime(CLOCK_MONOTONIC, &start);
   g_rec_mutex_lock(&freq_data_lock);
 
   if( save.freq == NULL || new_step < 0 || new_step > calc_data.steps_total )
@@ -934,6 +1002,10 @@ freq_step_update_ui( int new_step, gboolean force )
 
   freq_step_refresh_ui( force );
 
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  freq_profile_add( FREQ_PROF_PUBLISH, (end.tv_sec - start.tv_sec) +
+      (end.tv_nsec - start.tv_nsec) / 1e9 );
+
   g_rec_mutex_unlock(&freq_data_lock);
 }
 
@@ -1108,6 +1180,36 @@ freq_loop_derive_workers( int max_step )
   return workers;
 }
 
+/*
+ * freq_loop_send - send one frequency to a forked child
+ * @state: loop state; its FRQDATA payload carries the thread budget
+ * @child: child process descriptor, already marked with its assignment
+ * @freq:  frequency in MHz to compute
+ * @batch: TRUE for batch mathlib, FALSE for interactive mathlib
+ */
+static void
+freq_loop_send( freq_loop_state_t *state, child_proc_t *child,
+                double freq, gboolean batch )
+{
+  const char *mathlib_id = batch
+      ? rc_config.mathlib_batch_id
+      : current_mathlib->id;
+
+  if( batch )
+    mathlib_lock_intel_batch( mathlib_id );
+  else
+    mathlib_lock_intel_interactive( mathlib_id );
+
+  /* The budget travels with the library it configures, so the child holds
+   * both before it computes.  See FRQDATA in Child_Process().  The budget
+   * member is sweep-constant; only these two vary per dispatch. */
+  strncpy( state->frq.mathlib_id, mathlib_id, MATHLIB_ID_LEN - 1 );
+  state->frq.mathlib_id[MATHLIB_ID_LEN - 1] = '\0';
+  state->frq.freq_mhz = freq;
+
+  fork_send_frqdata( child->idx, &state->frq );
+}
+
 /*
  * freq_loop_dispatch - send one frequency step to a child or compute inline
  * @state: loop state; idle_stack updated for non-forked path
@@ -1135,23 +1237,7 @@ freq_loop_dispatch( freq_loop_state_t *state, child_proc_t *child,
 
   if( FORKED )
   {
-    const char *mathlib_id = batch
-        ? rc_config.mathlib_batch_id
-        : current_mathlib->id;
-
-    if( batch )
-      mathlib_lock_intel_batch( mathlib_id );
-    else
-      mathlib_lock_intel_interactive( mathlib_id );
-
-    /* The budget travels with the library it configures, so the child holds
-     * both before it computes.  See FRQDATA in Child_Process().  The budget
-     * member is sweep-constant; only these two vary per dispatch. */
-    strncpy( state->frq.mathlib_id, mathlib_id, MATHLIB_ID_LEN - 1 );
-    state->frq.mathlib_id[MATHLIB_ID_LEN - 1] = '\0';
-    state->frq.freq_mhz = freq;
-
-    fork_send_frqdata( child->idx, &state->frq );
+    freq_loop_send( state, child, freq, batch );
     return;
   }
 
@@ -1171,6 +1257,38 @@ freq_loop_dispatch( freq_loop_state_t *state, child_proc_t *child,
    * and push-back so the COMPUTE loop needs no forked/non-forked branch. */
 }
 
+/*
+ * freq_loop_collect_spec - collect a finished speculative solve
+ * @state: loop state; child pushed back to idle stack
+ * @child: child whose assigned_step is FREQ_SPEC_STEP
+ *
+ * Reads the child's result into a blob and hands it to the speculative
+ * cache, which refuses it if the model changed since dispatch.  Called
+ * under freq_data_lock.
+ *
+ * Returns FALSE if the pipe read fails; TRUE otherwise.
+ */
+static gboolean
+freq_loop_collect_spec( freq_loop_state_t *state, child_proc_t *child )
+{
+  size_t len  = Freq_Data_Size();
+  char  *blob = NULL;
+
+  mem_alloc( &blob, len );
+  if( !Get_Freq_Blob(child->idx, blob) )
+  {
+    mem_free( &blob );
+    return FALSE;
+  }
+
+  freq_spec_cache_store( child->assigned_freq, state->spec_generation,
+                         &blob, len );
+
+  child->assigned_step = -1;
+  idle_stack_push( state, child );
+  return TRUE;
+}
+
 /*
  * freq_loop_collect_pending - collect one round of finished forked children
  * @state: loop state; idle_stack updated in place
@@ -1219,7 +1337,9 @@ freq_loop_collect_pending( freq_loop_state_t *state )
       if( !freq_loop_validate_result( state, child_procs[idx] ) )
         continue;
 
+      freq_profile_commit( 0.0 );
       save.fstep[child_procs[idx]->assigned_step] = 1;
+      sweep_archive_append( child_procs[idx]->assigned_step );
       child_procs[idx]->assigned_step = -1;
       idle_stack_push( state, child_procs[idx] );
     }
@@ -1248,6 +1368,20 @@ freq_loop_collect_pending( freq_loop_state_t *state )
 
     int child_fstep = child_procs[idx]->assigned_step;
 
+    if( child_fstep == FREQ_SPEC_STEP )
+    {
+      if( freq_loop_collect_spec(state, child_procs[idx]) )
+        continue;
+
+      pr_err("Failed to read data from forked child\n");
+      freq_sweep_stop_request();
+      g_rec_mutex_unlock(&freq_data_lock);
+      return FALSE;
+    }
+
+    struct timespec xfer_start, xfer_end;
+
+    clock_gettime(CLOCK_MONOTONIC, &xfer_start);
     if( !Get_Freq_Data( idx, child_fstep ) )
     {
       pr_err("Failed to read data from forked child\n");
@@ -1255,11 +1389,16 @@ freq_loop_collect_pending( freq_loop_state_t *state )
       g_rec_mutex_unlock(&freq_data_lock);
       return FALSE;
     }
+    clock_gettime(CLOCK_MONOTONIC, &xfer_end);
 
     if( !freq_loop_validate_result( state, child_procs[idx] ) )
       continue;
 
+    freq_profile_commit(
+        (xfer_end.tv_sec - xfer_start.tv_sec) +
+        (xfer_end.tv_nsec - xfer_start.tv_nsec) / 1e9 );
     save.fstep[child_fstep] = 1;
+    sweep_archive_append( child_fstep );
     child_procs[idx]->assigned_step = -1;
     idle_stack_push( state, child_procs[idx] );
   }
@@ -1543,8 +1682,8 @@ fmhz_save_apply_selection(void)
  * @state: loop state (for elapsed-time calculation)
  *
  * Publishes the result set when the sweep covered every step, logs elapsed
- * time, wakes the optimizer, and queues final UI updates.  No locks held on
- * entry.
+ * time, wakes the optimizer, and queues final UI updates unless the sweep is
+ * a headless optimizer evaluation.  No locks held on entry.
  */
 static void
 freq_loop_finalize( freq_loop_state_t *state )
@@ -1552,8 +1691,9 @@ freq_loop_finalize( freq_loop_state_t *state )
   struct timespec end;
 
   /* Only a sweep free to dispatch the whole range may claim a full result
-   * set; a green-line start covers its own slot alone. */
-  if( state->scan_lo == 0 )
+   * set; a green-line start covers its own slot alone, and a reduced sweep
+   * what its caller reads. */
+  if( state->scan_lo == 0 && !state->reduced )
     freq_sweep_results_publish();
   else
   {
@@ -1572,9 +1712,17 @@ freq_loop_finalize( freq_loop_state_t *state )
     (FORKED ? get_mathlib_by_id(rc_config.mathlib_batch_id)->name
             : current_mathlib->name));
 
+  /* Per-stage timings under --profile and --profile-json */
+  freq_profile_report();
+
   /* Wake optimizer thread waiting on eval_cond */
   nec2_eval_signal();
 
+  /* A headless optimizer sweep publishes nothing to the UI; the optimizer
+   * refreshes it itself when a candidate improves on the best */
+  if( isFlagSet(HEADLESS_EVAL) )
+    return;
+
   /* Position the post-sweep selected frequency: an explicit --freq-select
    * target, else the green-line default (center when unavailable, lowest-VSWR
    * when stale).  When it applies, fmhz_save_apply_selection queues
@@ -1596,6 +1744,26 @@ freq_loop_finalize( freq_loop_state_t *state )
     g_idle_add_once((GSourceOnceFunc)Write_Optimizer_Data, NULL);
 }
 
+/**
+ * freq_loop_publish_best - show the results of a headless optimizer sweep
+ *
+ * Stands in for the UI half of freq_loop_finalize(), which headless sweeps
+ * skip.  The optimizer calls it synchronously on the GTK thread when a
+ * candidate improves on the best, so the step is drawn and the optimizer
+ * files are written before the next candidate reparses the model.
+ */
+void
+freq_loop_publish_best( void )
+{
+  int display = freq_loop_display_step();
+
+  if( display >= 0 )
+    freq_step_update_ui( display, TRUE );
+
+  if( opt_have_files_to_save() )
+    Write_Optimizer_Data();
+}
+
 /*-----------------------------------------------------------------------*/
 
 /**
@@ -1947,6 +2115,12 @@ batch_capture_and_quit(gpointer user_data)
   (void)user_data;
 
   batch_write_rdpat_pngs();
+
+  /* A --write-sensitivity run quits once its CSV is written */
+  if( rc_config.filename_sensitivity != NULL &&
+      opt_sensitivity_start_file(rc_config.filename_sensitivity) == 0 )
+    return;
+
   xnec2c_quit(NULL);
 
 } /* batch_capture_and_quit() */
@@ -2001,6 +2175,17 @@ Frequency_Loop( gpointer udata )
     state->next_scan    = state->scan_lo;
     state->max_step     = freq_populate_steps();
 
+    /* Steps an earlier sweep of this model archived are copied out of the
+     * archive rather than dispatched */
+    sweep_archive_begin();
+    g_rec_mutex_lock(&freq_data_lock);
+    for( idx = 0; idx <= state->max_step; idx++ )
+      if( save.fstep[idx] == 0 )
+        sweep_archive_restore( save.freq[idx], idx );
+    g_rec_mutex_unlock(&freq_data_lock);
+
+    optimizer_stream_begin();
+
     /* Steps are marked valid or invalid before the sweep starts, so the work
      * this sweep places, and the share of the processors each of its workers
      * receives, are known once the step extent is. */
@@ -2026,6 +2211,7 @@ Frequency_Loop( gpointer udata )
     if( calc_data.zpnorm > 0.0 ) calc_data.iped = 2;
 
     clock_gettime(CLOCK_MONOTONIC, &state->t0);
+    freq_profile_sweep_begin();
 
     return TRUE;
   }
@@ -2075,6 +2261,9 @@ Frequency_Loop( gpointer udata )
   if( !freq_loop_collect_pending(state) )
     return FALSE;
 
+  /* Rows of the steps now complete go out to the optimizer files */
+  optimizer_stream_steps();
+
   /* STOP: drain remaining children before exiting */
   if( freq_sweep_stopping() )
   {
@@ -2144,6 +2333,12 @@ freq_loop_begin( int scan_lo )
   state->scan_lo  = scan_lo;
   mem_array_alloc(&state->idle_stack, calc_data.num_jobs);
 
+  /* Every sweep solves whole steps unless freq_loop_run_reduced() says
+   * otherwise after this returns */
+  calc_data.solve_skip = 0;
+
+  freq_spec_reset();
+
   freqplots_update_fscale_extents();
 
   freq_sweep_run_begin();
@@ -2171,7 +2366,9 @@ freq_loop_complete( void )
       switch( rc_config.batch_mode )
       {
         case TRUE:
-          g_idle_add_once( (GSourceOnceFunc)batch_capture_and_quit, NULL );
+          /* The sweeps of a batch sensitivity run are not the batch sweep */
+          if( isFlagClear(HEADLESS_EVAL) )
+            g_idle_add_once( (GSourceOnceFunc)batch_capture_and_quit, NULL );
           break;
 
         case FALSE:
@@ -2200,13 +2397,82 @@ freq_loop_complete( void )
  * @state: sweep state owned by the caller
  *
  * Frequency_Loop() returns FALSE once the sweep is done or stopped.
+ *
+ * Return: TRUE when the sweep ran to completion, FALSE when it was stopped
  */
-static void
+static gboolean
 freq_loop_drive( freq_loop_state_t *state )
 {
+  gboolean stopped;
+
   while( Frequency_Loop(state) );
 
+  stopped = freq_sweep_stopping();
   freq_loop_complete();
+
+  return( !stopped );
+}
+
+/*-----------------------------------------------------------------------*/
+
+/**
+ * freq_loop_speculate - pre-solve frequencies around a green-line selection
+ * @state: the retired green-line sweep's state; its children are all idle
+ *
+ * Runs on the sweep thread after a green-line sweep has completed and been
+ * retired, so the UI already shows the selection and a new sweep may start
+ * at any time; Stop_Frequency_Loop() cancels via freq_spec_cancel() before
+ * joining this thread.  Dispatches the frequencies freq_spec_plan() chooses
+ * to the idle children and collects them into the speculative cache, so a
+ * nearby selection is answered by fetch_freq_data() without a solve.
+ * Children in flight at cancel are drained before returning.
+ */
+static void
+freq_loop_speculate( freq_loop_state_t *state )
+{
+  double freqs[FREQ_SPEC_MAX_STEPS];
+  int count, next = 0;
+
+  if( !FORKED || rc_config.batch_mode ||
+      isFlagSet(SUPPRESS_INTERMEDIATE_REDRAWS) ||
+      state->scan_lo != calc_data.steps_total ||
+      rc_config.freq_spec_steps < 1 || freq_spec_cancelled() )
+    return;
+
+  g_rec_mutex_lock(&freq_data_lock);
+  if( save.fstep == NULL || !save.fstep[calc_data.steps_total] )
+  {
+    g_rec_mutex_unlock(&freq_data_lock);
+    return;
+  }
+
+  count = freq_spec_plan( save.freq[calc_data.steps_total], state->spec_quantum,
+      freqs, MIN(rc_config.freq_spec_steps, FREQ_SPEC_MAX_STEPS) );
+  state->spec_generation = freq_spec_cache_generation();
+  g_rec_mutex_unlock(&freq_data_lock);
+
+  if( count < 1 )
+    return;
+
+  state->frq.threads = xnec2c_threads_per_worker( MIN(count, calc_data.num_jobs) );
+
+  do
+  {
+    while( next < count && !idle_stack_empty(state) && !freq_spec_cancelled() )
+    {
+      child_proc_t *child = idle_stack_pop( state );
+
+      child->assigned_step = FREQ_SPEC_STEP;
+      child->assigned_freq = freqs[next];
+      freq_loop_send( state, child, freqs[next++], FALSE );
+    }
+
+    if( children_dispatched() && !freq_loop_collect_pending(state) )
+      break;
+  } while( children_dispatched() ||
+           (next < count && !freq_spec_cancelled()) );
+
+  pr_info("speculative pre-solve: %d of %d frequencies dispatched\n", next, count);
 }
 
 void *Frequency_Loop_Thread(void *p)
@@ -2217,7 +2483,8 @@ void *Frequency_Loop_Thread(void *p)
 	if (rc_config.batch_mode)
 		calc_data.fmhz_save = 0.0;
 
-	freq_loop_drive( state );
+	if( freq_loop_drive(state) )
+		freq_loop_speculate( state );
 
 	return NULL;
 }
@@ -2276,7 +2543,9 @@ freq_loop_deck_ready( void )
 static gboolean
 freq_loop_start_internal( int scan_lo )
 {
-  if( !freq_loop_deck_ready() || freq_sweep_active())
+  /* The optimizer's headless sweeps own the children and the model */
+  if( !freq_loop_deck_ready() || freq_sweep_active() ||
+      isFlagSet(HEADLESS_EVAL) )
     return FALSE;
 
   /* Join previous thread if it exited naturally but was never joined.
@@ -2290,6 +2559,12 @@ freq_loop_start_internal( int scan_lo )
 
   floop_state = freq_loop_begin( scan_lo );
 
+  /* The spin button's arrow step is the spacing a user scrubs at, so the
+   * speculative frequencies are laid on it; read here on the GTK thread. */
+  if( mainwin_frequency != NULL )
+    gtk_spin_button_get_increments( mainwin_frequency,
+        &floop_state->spec_quantum, NULL );
+
   /* Intermediate-step draws use force=FALSE and are gated by
    * SUPPRESS_INTERMEDIATE_REDRAWS inside redraw_schedule(). */
 
@@ -2334,6 +2609,9 @@ freq_steps_invalidate_all( void )
     save.fstep[i] = 0;
   g_rec_mutex_unlock(&freq_data_lock);
 
+  /* A full restart follows a model change; pre-solved results predate it */
+  freq_spec_cache_clear();
+
   freq_sweep_results_clear();
 
   return TRUE;
@@ -2361,6 +2639,26 @@ Start_Frequency_Loop( void )
  */
 gboolean
 freq_loop_run_sync( void )
+{
+  return( freq_loop_run_reduced(NULL, 0) );
+}
+
+/**
+ * freq_loop_run_reduced - run part of a sweep to completion on the calling thread
+ * @need: per-step flags, steps_total entries; NULL solves every step
+ * @skip: SOLVE_SKIP_* parts to leave out of each step solved
+ *
+ * As freq_loop_run_sync(), for a caller that reads only some steps, or only
+ * the impedances of each.  Steps @need leaves out, and the green-line slot,
+ * are marked valid for the dispatcher only; once the sweep is over they are
+ * marked unsolved again, so plots and exports pass over them rather than
+ * read a stale or empty step.  calc_data.solve_skip keeps @skip until the
+ * next sweep begins, which meas_calc() consults.
+ *
+ * Return: TRUE when a sweep ran, FALSE when the deck carries no sweep
+ */
+gboolean
+freq_loop_run_reduced( const char *need, int skip )
 {
   freq_loop_state_t *state = NULL;
 
@@ -2378,12 +2676,302 @@ freq_loop_run_sync( void )
 
   state = freq_loop_begin( 0 );
 
+  if( need != NULL )
+  {
+    g_rec_mutex_lock(&freq_data_lock);
+    for( int i = 0; i < calc_data.steps_total; i++ )
+      if( !need[i] )
+        save.fstep[i] = 1;
+    save.fstep[calc_data.steps_total] = 1;
+    g_rec_mutex_unlock(&freq_data_lock);
+
+    state->reduced = TRUE;
+  }
+
+  /* Inline steps read calc_data, forked ones the FRQDATA payload */
+  calc_data.solve_skip = skip;
+  state->frq.skip      = skip;
+  if( skip != 0 )
+    state->reduced = TRUE;
+
   freq_loop_drive( state );
   freq_loop_state_free( &state );
 
+  /* Only the steps solved above carry results */
+  if( need != NULL )
+  {
+    g_rec_mutex_lock(&freq_data_lock);
+    for( int i = 0; i < calc_data.steps_total; i++ )
+      if( !need[i] )
+        save.fstep[i] = 0;
+    save.fstep[calc_data.steps_total] = 0;
+    g_rec_mutex_unlock(&freq_data_lock);
+  }
+
   return TRUE;
 }
 
+/*
+ * freq_loop_measure_send - start one candidate step on a forked child
+ * @frq:   MEASURE payload; its library and budget are batch-constant
+ * @child: child that owns the candidate
+ * @step:  sweep step to solve
+ */
+static void
+freq_loop_measure_send( fork_frqdata_t *frq, child_proc_t *child, int step )
+{
+  child->assigned_step = step;
+  child->assigned_freq = save.freq[step];
+
+  frq->freq_mhz = save.freq[step];
+  fork_send_measure( child->idx, frq );
+}
+
+/*
+ * freq_loop_measure_next - next step a measuring candidate solves
+ * @need:  per-step flags; NULL takes every step
+ * @step:  step after which to look
+ * @steps: steps in the sweep
+ *
+ * Return: the step index, or @steps when none is left
+ */
+static int
+freq_loop_measure_next( const char *need, int step, int steps )
+{
+  for( step++; step < steps; step++ )
+    if( need == NULL || need[step] )
+      break;
+
+  return( step );
+}
+
+/*
+ * freq_loop_measure_take - start the next candidate that parses on a child
+ * @idx:      child index
+ * @dk:       DECK payload; its deck text is batch-constant
+ * @sy_texts: .sy override text of each candidate
+ * @num:      number of candidates
+ * @next:     in/out, next candidate not yet taken
+ * @cand:     out, candidate child @idx holds
+ * @failed:   per-candidate flags, set for a candidate that did not parse
+ *
+ * A candidate whose deck the child cannot parse is failed alone and the
+ * child moves on to the next one, as nec2_eval_direct() fails it alone.
+ *
+ * Return: 1 when the child holds a candidate, 0 when none is left, -1
+ * when the child died
+ */
+static int
+freq_loop_measure_take( int idx, fork_deck_t *dk,
+                        char *const *sy_texts, int num,
+                        int *next, int *cand, char *failed )
+{
+  while( *next < num )
+  {
+    int status;
+
+    dk->sy     = sy_texts[*next];
+    dk->sy_len = strlen( sy_texts[*next] );
+    cand[idx]  = (*next)++;
+
+    fork_send_deck( idx, dk );
+    status = fork_recv_deck( idx );
+    if( status == 1 )
+      return( 1 );
+
+    pr_err("freq_loop_measure_batch: child %d failed candidate %d\n",
+           idx, cand[idx]);
+    failed[cand[idx]] = TRUE;
+    if( status < 0 )
+      return( -1 );
+  }
+
+  return( 0 );
+}
+
+/**
+ * freq_loop_measure_batch - sweep several override sets of one deck at once
+ * @deck: deck text, as passed to Reparse_Input_Deck()
+ * @deck_len: length of @deck
+ * @sy_texts: .sy override text of each candidate
+ * @num: number of candidates
+ * @sy_restore: override text of the deck this process holds
+ * @need: per-step flags; NULL measures every step
+ * @skip: SOLVE_SKIP_* parts to leave out of each step
+ * @meas: output, @num rows of @max_steps measurements
+ * @max_steps: row width of @meas
+ * @failed: output, @num flags set for the candidates that failed; may be
+ *          NULL, when any failure fails the batch
+ *
+ * Each forked child takes a whole candidate: it parses the deck under the
+ * candidate's overrides, then solves the sweep steps one at a time and
+ * answers each with its measurements rather than the step's field data.
+ * Candidates are independent, so as many run at once as there are workers,
+ * and each row lands by candidate index whatever order the workers finish
+ * in.  The steps are those of the deck this process holds, so a frequency
+ * card that varies with a symbol sweeps at this process's frequencies.
+ * Entries of the steps @need leaves out are not written.
+ *
+ * A candidate fails alone when its deck does not parse in the child or
+ * the child dies under it; a dead child takes no more candidates, and
+ * those no child is left to take fail too.  Rows of failed candidates are
+ * not complete.
+ *
+ * This process's model is not touched.  Every child still running is
+ * returned to it by a DECK carrying @sy_restore, so a later sweep finds
+ * parent and children agreeing.  Caller holds HEADLESS_EVAL with no sweep
+ * running.
+ *
+ * Return: steps measured per candidate, or -1 when not forked or, with
+ * @failed NULL, when a candidate failed
+ */
+int
+freq_loop_measure_batch( const char *deck, size_t deck_len,
+                         char *const *sy_texts, int num,
+                         const char *sy_restore,
+                         const char *need, int skip,
+                         measurement_t *meas, int max_steps,
+                         char *failed )
+{
+  fork_frqdata_t frq = { 0 };
+  fork_deck_t dk = {
+    .deck_len = deck_len,
+    .deck     = (char *)deck,
+  };
+  int *cand = NULL;
+  char *fail = NULL, *dead = NULL;
+  int workers, steps, first, next = 0;
+  gboolean ok = TRUE;
+
+  if( !FORKED || num < 1 || calc_data.steps_total < 1 )
+    return -1;
+
+  g_rec_mutex_lock(&freq_data_lock);
+  freq_populate_steps();
+  g_rec_mutex_unlock(&freq_data_lock);
+
+  steps   = MIN( calc_data.steps_total, max_steps );
+  workers = MIN( num, calc_data.num_jobs );
+  first   = freq_loop_measure_next( need, -1, steps );
+
+  if( failed != NULL )
+    memset( failed, 0, (size_t)num );
+
+  if( first >= steps )
+    return( steps );
+
+  /* Whole candidates are the unit of work, so the library runs batch */
+  strncpy( frq.mathlib_id, rc_config.mathlib_batch_id, MATHLIB_ID_LEN - 1 );
+  frq.threads = xnec2c_threads_per_worker( workers );
+  frq.skip    = skip;
+  mathlib_lock_intel_batch( frq.mathlib_id );
+
+  mem_array_alloc( &cand, workers );
+  mem_array_alloc( &dead, workers );
+  mem_array_alloc( &fail, num );
+  mem_array_zero( fail );
+
+  for( int idx = 0; idx < workers; idx++ )
+  {
+    int took = freq_loop_measure_take( idx, &dk, sy_texts, num,
+                                       &next, cand, fail );
+
+    dead[idx] = (took < 0);
+    if( took == 1 )
+      freq_loop_measure_send( &frq, child_procs[idx], first );
+  }
+
+  while( children_dispatched() )
+  {
+    fd_set read_fds;
+    int    n = 0, sel_ret;
+
+    FD_ZERO( &read_fds );
+    for( int idx = 0; idx < workers; idx++ )
+    {
+      if( child_procs[idx]->assigned_step == -1 )
+        continue;
+
+      FD_SET( child_procs[idx]->from_child[READ], &read_fds );
+      n = MAX( n, child_procs[idx]->from_child[READ] );
+    }
+
+    do
+    {
+      sel_ret = select( n + 1, &read_fds, NULL, NULL, NULL );
+    } while( sel_ret == -1 && errno == EINTR );
+
+    if( sel_ret == -1 )
+    {
+      perror( "select()" );
+      _exit(0);
+    }
+
+    for( int idx = 0; idx < workers; idx++ )
+    {
+      child_proc_t *child = child_procs[idx];
+      int step = child->assigned_step;
+      int took;
+
+      if( step == -1 || !FD_ISSET(child->from_child[READ], &read_fds) )
+        continue;
+
+      if( !fork_recv_measure(idx, &meas[cand[idx] * max_steps + step]) )
+      {
+        pr_err("Failed to read data from forked child\n");
+        child->assigned_step = -1;
+        fail[cand[idx]] = TRUE;
+        dead[idx] = TRUE;
+        continue;
+      }
+
+      int after = freq_loop_measure_next( need, step, steps );
+
+      if( after < steps )
+      {
+        freq_loop_measure_send( &frq, child, after );
+        continue;
+      }
+
+      child->assigned_step = -1;
+      took = freq_loop_measure_take( idx, &dk, sy_texts, num,
+                                     &next, cand, fail );
+      dead[idx] = (took < 0);
+      if( took == 1 )
+        freq_loop_measure_send( &frq, child, first );
+    }
+  }
+
+  /* Every child died before these were taken */
+  for( ; next < num; next++ )
+    fail[next] = TRUE;
+
+  /* Back to the deck this process holds, failed candidates or not: a
+   * child left on a candidate's overrides would solve every later sweep
+   * wrong.  A dead child has no pipe to write to. */
+  dk.sy     = (char *)sy_restore;
+  dk.sy_len = (sy_restore != NULL) ? strlen( sy_restore ) : 0;
+  for( int idx = 0; idx < workers; idx++ )
+    if( !dead[idx] )
+      fork_send_deck( idx, &dk );
+  for( int idx = 0; idx < workers; idx++ )
+    if( !dead[idx] && (fork_recv_deck(idx) != 1) )
+      pr_err("freq_loop_measure_batch: child %d failed to restore the deck\n", idx);
+
+  if( failed != NULL )
+    memcpy( failed, fail, (size_t)num );
+  else
+    for( int k = 0; k < num; k++ )
+      if( fail[k] )
+        ok = FALSE;
+
+  mem_array_free( &cand );
+  mem_array_free( &dead );
+  mem_array_free( &fail );
+
+  return( ok ? steps : -1 );
+}
+
 /**
  * Start_Frequency_Loop_Greenline - recompute only the green-line step
  *
@@ -2413,6 +3001,7 @@ Start_Frequency_Loop_Greenline( void )
 Stop_Frequency_Loop( void )
 {
   freq_sweep_stop_request();
+  freq_spec_cancel();
 
   if( !rc_config.disable_pthread_freqloop )
   {
@@ -0,0 +1,343 @@
+/*
+ * Bayesian Optimization Tests
+ *
+ * Validates the Gaussian-process optimizer against functions with known
+ * minima on small evaluation budgets, the point of a surrogate model:
+ *   1. Parabola (x+3)^2 - 5  →  min at x=-3, fit=-5
+ *   2. Sphere sum(x_i^2)     →  min at origin, fit=0
+ *   3. Rosenbrock 2D         →  min at (1,1), fit=0
+ * then batch proposal, the initial guess, early exit, and validation.
+ */
+
+#include <stdlib.h>
+
+#include "bayesopt.h"
+#include "optimizer_test_common.h"
+
+/** Counts evaluations, batches, and the largest batch seen */
+typedef struct
+{
+	int evals;
+	int batches;
+	int max_batch;
+} eval_count_t;
+
+static double fit_sphere_counted(const gsl_vector *pos, void *ctx)
+{
+	((eval_count_t *)ctx)->evals++;
+	return fit_sphere(pos, NULL);
+}
+
+static void fit_sphere_batch(const gsl_matrix *pos, gsl_vector *fit, void *ctx)
+{
+	eval_count_t *c = ctx;
+
+	c->batches++;
+	if ((int)pos->size2 > c->max_batch)
+	{
+		c->max_batch = (int)pos->size2;
+	}
+
+	for (size_t i = 0; i < pos->size2; i++)
+	{
+		gsl_vector_const_view col = gsl_matrix_const_column(pos, i);
+		gsl_vector_set(fit, i, fit_sphere_counted(&col.vector, ctx));
+	}
+}
+
+static void test_parabola(void)
+{
+	printf("Test: 1D parabola (x+3)^2 - 5 in 20 evaluations\n");
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+	cfg.fit_func = fit_parabola;
+	cfg.dimensions = 1;
+	cfg.iterations = 20;
+	cfg.seed = 1;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, 10.0);
+
+	bayes_t *b = bayes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!b)
+	{
+		printf("  FAIL: bayes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = bayes_optimize(b);
+	double x = gsl_vector_get(bayes_get_best_pos(b), 0);
+
+	assert_near("fit value", best_fit, -5.0, 0.05);
+	assert_near("x position", x, -3.0, 0.25);
+	assert_near("evaluations", bayes_get_iteration_count(b), 20, 0.5);
+
+	bayes_free(b);
+}
+
+static void test_sphere_3d(void)
+{
+	printf("Test: 3D sphere function in 60 evaluations\n");
+
+	eval_count_t count = { 0 };
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+	cfg.fit_func = fit_sphere_counted;
+	cfg.fit_func_ctx = &count;
+	cfg.dimensions = 3;
+	cfg.iterations = 60;
+	cfg.seed = 2;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 3, -50.0, 50.0);
+
+	bayes_t *b = bayes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!b)
+	{
+		printf("  FAIL: bayes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	/* Within 2% of the range per axis; PSO spends 1000 iterations of
+	 * 9 particles on the same function */
+	double best_fit = bayes_optimize(b);
+
+	assert_near("fit value", best_fit, 0.0, 5.0);
+	assert_near("fitness calls", count.evals, 60, 0.5);
+
+	bayes_free(b);
+}
+
+static void test_rosenbrock_2d(void)
+{
+	printf("Test: 2D Rosenbrock function in 100 evaluations\n");
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+	cfg.fit_func = fit_rosenbrock;
+	cfg.dimensions = 2;
+	cfg.iterations = 100;
+	cfg.seed = 3;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 2, -2.0, 2.0);
+
+	bayes_t *b = bayes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!b)
+	{
+		printf("  FAIL: bayes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = bayes_optimize(b);
+
+	assert_near("fit value", best_fit, 0.0, 0.5);
+
+	bayes_free(b);
+}
+
+static void test_batch(void)
+{
+	printf("Test: batch proposals fill each batch\n");
+
+	eval_count_t count = { 0 };
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+	cfg.fit_func = fit_sphere_counted;
+	cfg.fit_func_batch = fit_sphere_batch;
+	cfg.fit_func_ctx = &count;
+	cfg.dimensions = 2;
+	cfg.iterations = 42;
+	cfg.initial_samples = 5;
+	cfg.batch_size = 4;
+	cfg.seed = 4;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 2, -10.0, 10.0);
+
+	bayes_t *b = bayes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!b)
+	{
+		printf("  FAIL: bayes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = bayes_optimize(b);
+
+	/* Design batch, nine full batches, one short batch of the remainder */
+	assert_near("evaluations", count.evals, 42, 0.5);
+	assert_near("batches", count.batches, 11, 0.5);
+	assert_near("largest batch is the design", count.max_batch, 5, 0.5);
+	assert_near("fit value", best_fit, 0.0, 0.5);
+
+	bayes_free(b);
+}
+
+static void test_initial_guess(void)
+{
+	printf("Test: parabola with initial_guess at the solution\n");
+
+	gsl_vector *guess = gsl_vector_alloc(1);
+	gsl_vector_set(guess, 0, -3.0);
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+	cfg.fit_func = fit_parabola;
+	cfg.initial_guess = guess;
+	cfg.iterations = 5;
+	cfg.seed = 5;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, 10.0);
+
+	bayes_t *b = bayes_new(&cfg);
+	gsl_vector_free(guess);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+
+	if (!b)
+	{
+		printf("  FAIL: bayes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	/* The guess is the first design point, so it is never lost */
+	assert_near("fit value", bayes_optimize(b), -5.0, 1e-9);
+
+	bayes_free(b);
+}
+
+static void test_exit_fit(void)
+{
+	printf("Test: exit_fit early termination\n");
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+	cfg.fit_func = fit_parabola;
+	cfg.dimensions = 1;
+	cfg.iterations = 200;
+	cfg.exit_fit = -4.99;
+	cfg.seed = 6;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, 10.0);
+
+	bayes_t *b = bayes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!b)
+	{
+		printf("  FAIL: bayes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	bayes_optimize(b);
+	int iters = bayes_get_iteration_count(b);
+
+	test_count++;
+	if (iters < 200)
+	{
+		printf("  PASS: early exit after %d evaluations (< 200)\n", iters);
+	}
+	else
+	{
+		printf("  FAIL: did not exit early (ran all %d evaluations)\n", iters);
+		test_failures++;
+	}
+
+	test_count++;
+	if (bayes_get_best_fit(b) <= -4.99)
+	{
+		printf("  PASS: fit <= exit_fit\n");
+	}
+	else
+	{
+		printf("  FAIL: fit %.6f > exit_fit\n", bayes_get_best_fit(b));
+		test_failures++;
+	}
+
+	bayes_free(b);
+}
+
+static void test_config_validation(void)
+{
+	printf("Test: config validation\n");
+
+	bayes_config_t cfg;
+	bayes_config_init(&cfg);
+
+	/* No fit_func */
+	test_count++;
+	bayes_t *b = bayes_new(&cfg);
+	if (!b)
+	{
+		printf("  PASS: NULL fit_func rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: NULL fit_func accepted\n");
+		test_failures++;
+		bayes_free(b);
+	}
+
+	/* Bounds are required */
+	cfg.fit_func = fit_parabola;
+	cfg.dimensions = 1;
+	test_count++;
+	b = bayes_new(&cfg);
+	if (!b)
+	{
+		printf("  PASS: missing bounds rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: missing bounds accepted\n");
+		test_failures++;
+		bayes_free(b);
+	}
+
+	/* Infinite bounds cannot map to the unit cube */
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -INFINITY, 10.0);
+	test_count++;
+	b = bayes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!b)
+	{
+		printf("  PASS: infinite bound rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: infinite bound accepted\n");
+		test_failures++;
+		bayes_free(b);
+	}
+}
+
+int main(void)
+{
+	printf("=== Bayesian Optimization Test Suite ===\n\n");
+
+	test_parabola();
+	printf("\n");
+	test_sphere_3d();
+	printf("\n");
+	test_rosenbrock_2d();
+	printf("\n");
+	test_batch();
+	printf("\n");
+	test_initial_guess();
+	printf("\n");
+	test_exit_fit();
+	printf("\n");
+	test_config_validation();
+
+	printf("\n=== Results: %d tests, %d failures ===\n",
+		test_count, test_failures);
+
+	return test_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,437 @@
+/*
+ * CMA-ES Tests
+ *
+ * Validates CMA-ES against functions with known minima:
+ *   1. Parabola (x+3)^2 - 5  →  min at x=-3, fit=-5
+ *   2. Sphere sum(x_i^2)     →  min at origin, fit=0
+ *   3. Rosenbrock 2D         →  min at (1,1), fit=0
+ *   4. Rosenbrock 10D        →  min at (1,...,1), fit=0; the coupled
+ *                               case simplex and PSO struggle with
+ * then generation batching, early exit, and validation.
+ */
+
+#include <stdlib.h>
+
+#include "cmaes.h"
+#include "optimizer_test_common.h"
+
+/** Counts evaluations, batches, and batch sizes */
+typedef struct
+{
+	int evals;
+	int batches;
+	int min_batch;
+	int max_batch;
+} eval_count_t;
+
+static double fit_sphere_counted(const gsl_vector *pos, void *ctx)
+{
+	((eval_count_t *)ctx)->evals++;
+	return fit_sphere(pos, NULL);
+}
+
+static void fit_sphere_batch(const gsl_matrix *pos, gsl_vector *fit, void *ctx)
+{
+	eval_count_t *c = ctx;
+	int n = (int)pos->size2;
+
+	c->batches++;
+	if (c->min_batch == 0 || n < c->min_batch)
+	{
+		c->min_batch = n;
+	}
+	if (n > c->max_batch)
+	{
+		c->max_batch = n;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		gsl_vector_const_view col = gsl_matrix_const_column(pos, i);
+		gsl_vector_set(fit, i, fit_sphere_counted(&col.vector, ctx));
+	}
+}
+
+static void test_parabola(void)
+{
+	printf("Test: 1D parabola (x+3)^2 - 5\n");
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_parabola;
+	cfg.dimensions = 1;
+	cfg.iterations = 200;
+	cfg.seed = 1;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, 10.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = cmaes_optimize(c);
+	double x = gsl_vector_get(cmaes_get_best_pos(c), 0);
+
+	assert_near("fit value", best_fit, -5.0, 1e-6);
+	assert_near("x position", x, -3.0, 1e-3);
+
+	cmaes_free(c);
+}
+
+static void test_sphere_3d(void)
+{
+	printf("Test: 3D sphere function\n");
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_sphere;
+	cfg.dimensions = 3;
+	cfg.iterations = 300;
+	cfg.seed = 2;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 3, -50.0, 50.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = cmaes_optimize(c);
+	const gsl_vector *best_pos = cmaes_get_best_pos(c);
+
+	assert_near("fit value", best_fit, 0.0, 1e-6);
+	for (int i = 0; i < 3; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "x[%d] position", i);
+		assert_near(name, gsl_vector_get(best_pos, i), 0.0, 1e-3);
+	}
+
+	cmaes_free(c);
+}
+
+static void test_rosenbrock_2d(void)
+{
+	printf("Test: 2D Rosenbrock function\n");
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_rosenbrock;
+	cfg.dimensions = 2;
+	cfg.iterations = 1000;
+	cfg.seed = 3;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 2, -5.0, 10.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = cmaes_optimize(c);
+	const gsl_vector *best_pos = cmaes_get_best_pos(c);
+
+	assert_near("fit value", best_fit, 0.0, 1e-4);
+	assert_near("x[0] position", gsl_vector_get(best_pos, 0), 1.0, 0.01);
+	assert_near("x[1] position", gsl_vector_get(best_pos, 1), 1.0, 0.02);
+
+	cmaes_free(c);
+}
+
+static void test_rosenbrock_10d(void)
+{
+	printf("Test: 10D Rosenbrock function\n");
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_rosenbrock;
+	cfg.dimensions = 10;
+	cfg.iterations = 5000;
+	cfg.seed = 4;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 10, -2.0, 2.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = cmaes_optimize(c);
+
+	assert_near("fit value", best_fit, 0.0, 1e-3);
+	printf("  (%d generations)\n", cmaes_get_iteration_count(c));
+
+	cmaes_free(c);
+}
+
+static void test_batch(void)
+{
+	printf("Test: each generation is one batch of lambda\n");
+
+	eval_count_t count = { 0 };
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_sphere_counted;
+	cfg.fit_func_batch = fit_sphere_batch;
+	cfg.fit_func_ctx = &count;
+	cfg.dimensions = 4;
+	cfg.iterations = 25;
+	cfg.lambda = 12;
+	cfg.min_sigma = 0.0;
+	cfg.seed = 5;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 4, -10.0, 10.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	cmaes_optimize(c);
+
+	assert_near("batches", count.batches, 25, 0.5);
+	assert_near("evaluations", count.evals, 25 * 12, 0.5);
+	assert_near("smallest batch", count.min_batch, 12, 0.5);
+	assert_near("largest batch", count.max_batch, 12, 0.5);
+	assert_near("generations", cmaes_get_iteration_count(c), 25, 0.5);
+
+	cmaes_free(c);
+}
+
+static void test_min_lambda(void)
+{
+	printf("Test: automatic lambda raised to min_lambda\n");
+
+	eval_count_t count = { 0 };
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_sphere_counted;
+	cfg.fit_func_batch = fit_sphere_batch;
+	cfg.fit_func_ctx = &count;
+	cfg.dimensions = 2;
+	cfg.iterations = 3;
+	cfg.min_lambda = 16;
+	cfg.min_sigma = 0.0;
+	cfg.seed = 6;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 2, -10.0, 10.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	cmaes_optimize(c);
+
+	/* 4 + 3 ln 2 = 6 would leave workers idle */
+	assert_near("batch size", count.max_batch, 16, 0.5);
+	assert_near("evaluations", count.evals, 3 * 16, 0.5);
+
+	cmaes_free(c);
+}
+
+static void test_initial_guess(void)
+{
+	printf("Test: parabola with initial_guess and a narrow step\n");
+
+	gsl_vector *guess = gsl_vector_alloc(1);
+	gsl_vector_set(guess, 0, -2.5);
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_parabola;
+	cfg.initial_guess = guess;
+	cfg.sigma = 0.05;
+	cfg.iterations = 200;
+	cfg.seed = 6;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, 10.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	gsl_vector_free(guess);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	double best_fit = cmaes_optimize(c);
+
+	assert_near("fit value", best_fit, -5.0, 1e-6);
+	assert_near("x position", gsl_vector_get(cmaes_get_best_pos(c), 0),
+		-3.0, 1e-3);
+
+	cmaes_free(c);
+}
+
+static void test_exit_fit(void)
+{
+	printf("Test: exit_fit early termination\n");
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+	cfg.fit_func = fit_parabola;
+	cfg.dimensions = 1;
+	cfg.iterations = 5000;
+	cfg.exit_fit = -4.9;
+	cfg.min_sigma = 0.0;
+	cfg.seed = 7;
+
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, 10.0);
+
+	cmaes_t *c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  FAIL: cmaes_new returned NULL\n");
+		test_failures++;
+		return;
+	}
+
+	cmaes_optimize(c);
+	int iters = cmaes_get_iteration_count(c);
+
+	test_count++;
+	if (iters < 5000)
+	{
+		printf("  PASS: early exit at generation %d (< 5000)\n", iters);
+	}
+	else
+	{
+		printf("  FAIL: did not exit early (ran all %d generations)\n", iters);
+		test_failures++;
+	}
+
+	assert_near("fit <= exit_fit", cmaes_get_best_fit(c), -5.0, 0.1);
+
+	cmaes_free(c);
+}
+
+static void test_config_validation(void)
+{
+	printf("Test: config validation\n");
+
+	cmaes_config_t cfg;
+	cmaes_config_init(&cfg);
+
+	/* No fit_func */
+	test_count++;
+	cmaes_t *c = cmaes_new(&cfg);
+	if (!c)
+	{
+		printf("  PASS: NULL fit_func rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: NULL fit_func accepted\n");
+		test_failures++;
+		cmaes_free(c);
+	}
+
+	/* No dimensions and no initial_guess */
+	cfg.fit_func = fit_parabola;
+	cfg.dimensions = 0;
+	test_count++;
+	c = cmaes_new(&cfg);
+	if (!c)
+	{
+		printf("  PASS: zero dimensions without guess rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: zero dimensions without guess accepted\n");
+		test_failures++;
+		cmaes_free(c);
+	}
+
+	/* pos_max <= pos_min */
+	cfg.dimensions = 1;
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, 10.0, -10.0);
+	test_count++;
+	c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  PASS: pos_max <= pos_min rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: pos_max <= pos_min accepted\n");
+		test_failures++;
+		cmaes_free(c);
+	}
+
+	/* Infinite bounds cannot map to the unit cube */
+	test_alloc_uniform_bounds(&cfg.pos_min, &cfg.pos_max, 1, -10.0, INFINITY);
+	test_count++;
+	c = cmaes_new(&cfg);
+	test_free_bounds(&cfg.pos_min, &cfg.pos_max);
+	if (!c)
+	{
+		printf("  PASS: infinite bound rejected\n");
+	}
+	else
+	{
+		printf("  FAIL: infinite bound accepted\n");
+		test_failures++;
+		cmaes_free(c);
+	}
+}
+
+int main(void)
+{
+	printf("=== CMA-ES Test Suite ===\n\n");
+
+	test_parabola();
+	printf("\n");
+	test_sphere_3d();
+	printf("\n");
+	test_rosenbrock_2d();
+	printf("\n");
+	test_rosenbrock_10d();
+	printf("\n");
+	test_batch();
+	printf("\n");
+	test_min_lambda();
+	printf("\n");
+	test_initial_guess();
+	printf("\n");
+	test_exit_fit();
+	printf("\n");
+	test_config_validation();
+
+	printf("\n=== Results: %d tests, %d failures ===\n",
+		test_count, test_failures);
+
+	return test_failures > 0 ? 1 : 0;
+}
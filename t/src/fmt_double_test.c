@@ -0,0 +1,191 @@
+/*
+ *  Unit tests for fmt_g17(), the "%.17g" formatter of the sweep writers.
+ *
+ *  The CSV and Touchstone files must read the same whichever formatter
+ *  wrote them, so every value is checked against snprintf("%.17g") in the
+ *  C locale: the edge cases of the conversion (powers of ten and their
+ *  neighbours, values that round up to the next decade, the exponent
+ *  switch of %g, zero, infinities, NaN, subnormals), values shaped like
+ *  sweep results, and random bit patterns across the whole double range.
+ *  The output must also keep '.' when the process locale uses ','.
+ */
+
+#define _GNU_SOURCE
+
+#include <locale.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmt_double.h"
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define ASSERT_TRUE(cond, msg) \
+	do { \
+		tests_run++; \
+		if ((cond)) { \
+			tests_passed++; \
+		} \
+		else { \
+			tests_failed++; \
+			fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, (msg)); \
+		} \
+	} while (0)
+
+/* Mismatches of the current group; the first few are printed */
+static int mismatches;
+
+static void check_value(double v)
+{
+	char got[FMT_G17_LEN];
+	char want[FMT_G17_LEN];
+	int len;
+
+	len = fmt_g17(got, v);
+	snprintf(want, sizeof(want), "%.17g", v);
+
+	if (strcmp(got, want) != 0 || len != (int)strlen(want))
+	{
+		if (mismatches++ < 5)
+			fprintf(stderr, "  %a: \"%s\", snprintf \"%s\"\n", v, got, want);
+	}
+}
+
+/* xorshift64: reproducible bit patterns */
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void test_edges(void)
+{
+	static const double values[] = {
+		0.0, -0.0, 1.0, -1.0, 0.5, 2.5, 0.1, 0.2, 0.3, 14.1, 146.52,
+		1e16, 1e17, 1e22, 1e23, 1e32, 1e33, 1e-4, 1e-5, 1e-16, 1e-17,
+		9.9999999999999995e16, 99999999999999999.0, 123456789012345678.0,
+		9.999999999999999e-5, 0.00009999999999999999,
+		5e-324, 2.2250738585072014e-308, 1.7976931348623157e308,
+	};
+
+	mismatches = 0;
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+		check_value(values[i]);
+
+	check_value(INFINITY);
+	check_value(-INFINITY);
+	check_value(NAN);
+
+	/* Each power of ten and the doubles either side of it */
+	for (int k = -30; k <= 40; k++)
+	{
+		double p = pow(10, k);
+
+		check_value(p);
+		check_value(nextafter(p, 0));
+		check_value(nextafter(p, INFINITY));
+		check_value(-p);
+	}
+
+	ASSERT_TRUE(mismatches == 0, "edge cases match snprintf");
+}
+
+static void test_sweep_values(void)
+{
+	mismatches = 0;
+
+	/* Frequencies, impedances, gains and angles at millesimal steps */
+	for (int i = -2000000; i <= 2000000; i += 7)
+	{
+		double v = i / 1000.0;
+
+		check_value(v);
+		check_value(v * 1e-3);
+		check_value(v * 1e6);
+		check_value(nextafter(v, INFINITY));
+	}
+
+	ASSERT_TRUE(mismatches == 0, "sweep-shaped values match snprintf");
+}
+
+static void test_random(void)
+{
+	mismatches = 0;
+
+	/* Any bit pattern */
+	for (int i = 0; i < 2000000; i++)
+	{
+		uint64_t bits = rng_next();
+		double v;
+
+		memcpy(&v, &bits, sizeof(v));
+		check_value(v);
+	}
+
+	/* Full mantissas across the exact range and past both ends of it */
+	for (int i = 0; i < 2000000; i++)
+	{
+		double v = ldexp((double)(rng_next() >> 11), -53) *
+			pow(10, (int)(rng_next() % 60) - 25);
+
+		check_value((rng_next() & 1) ? -v : v);
+	}
+
+	ASSERT_TRUE(mismatches == 0, "random values match snprintf");
+}
+
+static void test_locale(void)
+{
+	char got[FMT_G17_LEN];
+	static const char *locales[] = { "de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", NULL };
+	int i;
+
+	for (i = 0; locales[i] != NULL; i++)
+	{
+		if (setlocale(LC_NUMERIC, locales[i]) != NULL)
+			break;
+	}
+
+	if (locales[i] == NULL)
+	{
+		printf("  (no comma-decimal locale installed; locale check skipped)\n");
+		return;
+	}
+
+	fmt_g17(got, 14.25);
+	ASSERT_TRUE(strcmp(got, "14.25") == 0, "exact path ignores the locale");
+
+	fmt_g17(got, 1.5e-300);
+	ASSERT_TRUE(strcmp(got, "1.5000000000000001e-300") == 0,
+		"snprintf fallback ignores the locale");
+
+	setlocale(LC_NUMERIC, "C");
+}
+
+/*------------------------------------------------------------------------*/
+
+int main(void)
+{
+	setlocale(LC_NUMERIC, "C");
+
+	test_edges();
+	test_sweep_values();
+	test_random();
+	test_locale();
+
+	printf("fmt_double_test: %d tests, %d passed, %d failed\n",
+		tests_run, tests_passed, tests_failed);
+
+	return tests_failed > 0 ? 1 : 0;
+}
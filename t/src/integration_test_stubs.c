@@ -67,39 +67,14 @@ New_Patch_Data(void)
 {
 }
 
-/* Stubs for prerender derivations triggered at end of command parsing;
- * the parsing test asserts raw geometry only, not prerender outputs. */
-void
-prerender_state_alloc(int steps_total)
-{
-  (void)steps_total;
-}
-
-void
-compute_nf_dr_norm(void)
-{
-}
-
-void
-compute_excitation_center(void)
-{
-}
-
+/* Stub for the geometry colors set at the end of command parsing; the
+ * prerender derivations beside it are linked, as the geometry reuse test
+ * reads the excitation center */
 void
 init_geometry_colors(void)
 {
 }
 
-void
-compute_trig_tables(void)
-{
-}
-
-void
-compute_ff_topology(void)
-{
-}
-
 /* Stub for polarization factor calculation */
 double
 Polarization_Factor(int pol_type, int fstep, int idx)
@@ -166,6 +141,13 @@ xnec2c_num_procs(void)
   return 1;
 }
 
+/* Stub for the per-worker thread budget */
+int
+xnec2c_threads_per_worker(int workers)
+{
+  return 1;
+}
+
 /* Stub for the OpenMP thread budget */
 void
 xnec2c_set_omp_threads(int threads)
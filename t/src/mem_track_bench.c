@@ -0,0 +1,90 @@
+/*
+ * Managed allocator tracking tier benchmark
+ *
+ * Times a churn of managed allocations, growths, and frees under each
+ * tracking tier and reports throughput per tier:
+ *   1. off     rc_config defaults; the production configuration
+ *   2. sample  --mem-sample 64; one fresh block in 64 tracked
+ *   3. full    --mem-report; every block tracked
+ *
+ * Not part of the suite: build and run it with "make bin/mem_track_bench"
+ * in t/.  What each tier registers is checked by mem_track_test.  The
+ * stubbed _get_backtrace() returns NULL, so the full tier here measures the
+ * registry alone; a real build adds backtrace capture.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common.h"
+#include "mem/mem_track.h"
+
+#define BENCH_LIVE      256
+#define BENCH_ROUNDS    2000
+#define BENCH_PERIOD    64
+
+/* Sizes spread across small scalars and solver-sized rows */
+static size_t bench_size(int i)
+{
+	return 16 + (size_t)(i * 37 % 4096);
+}
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * bench_tier - time the churn under one tier
+ * @label: tier name for output
+ * @report: value for rc_config.mem_report_enabled
+ * @period: value for rc_config.mem_sample_period
+ */
+static void bench_tier(const char *label, int report, int period)
+{
+	char *live[BENCH_LIVE] = { NULL };
+	unsigned long long ops = 0;
+	double t0, dt;
+
+	rc_config.mem_report_enabled = report;
+	rc_config.mem_sample_period = period;
+
+	printf("Tier: %s\n", label);
+
+	/* Churn: free, reallocate, and grow each slot in turn */
+	t0 = bench_now();
+	for (int r = 0; r < BENCH_ROUNDS; r++)
+	{
+		for (int i = 0; i < BENCH_LIVE; i++)
+		{
+			mem_free(&live[i]);
+			mem_alloc(&live[i], bench_size(r + i));
+			mem_realloc(&live[i], 2 * bench_size(r + i));
+			ops += 3;
+		}
+	}
+	dt = bench_now() - t0;
+
+	printf("  %llu ops in %.3f s, %.2f Mops/s\n", ops, dt, ops / dt / 1e6);
+
+	for (int i = 0; i < BENCH_LIVE; i++)
+		mem_free(&live[i]);
+}
+
+int main(void)
+{
+	printf("=== Managed allocator tracking tiers ===\n\n");
+
+	bench_tier("off", 0, 0);
+	bench_tier("sample", 0, BENCH_PERIOD);
+	bench_tier("full", 1, 0);
+
+	rc_config.mem_report_enabled = 0;
+	rc_config.mem_sample_period = 0;
+
+	return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Managed allocator tracking tier tests
+ *
+ * Churns managed allocations, growths, and frees under each tracking tier
+ * and checks what the tier registers:
+ *   1. off     rc_config defaults; registers nothing
+ *   2. sample  --mem-sample 64; about one fresh block in 64
+ *   3. full    --mem-report; every block
+ *
+ * A sampled block must also stay registered across a grow-beyond
+ * relocation.  Throughput is measured by mem_track_bench, which is not part
+ * of the suite.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "mem/mem_track.h"
+
+#define TRACK_LIVE      256
+#define TRACK_ROUNDS    4
+#define TRACK_PERIOD    64
+
+static int test_failures = 0;
+static int test_count = 0;
+
+/* Sizes spread across small scalars and solver-sized rows */
+static size_t track_size(int i)
+{
+	return 16 + (size_t)(i * 37 % 4096);
+}
+
+static int count_registered(char **live, int n)
+{
+	int count = 0;
+
+	for (int i = 0; i < n; i++)
+		if (live[i] != NULL && mem_obj_from_ptr(live[i])->registered)
+			count++;
+
+	return count;
+}
+
+static void check(const char *name, int ok)
+{
+	test_count++;
+	printf("  %s: %s\n", ok ? "PASS" : "FAIL", name);
+	if (!ok)
+		test_failures++;
+}
+
+/**
+ * check_tier - churn under one tier and check its registrations
+ * @label: tier name for output
+ * @report: value for rc_config.mem_report_enabled
+ * @period: value for rc_config.mem_sample_period
+ */
+static void check_tier(const char *label, int report, int period)
+{
+	char *live[TRACK_LIVE] = { NULL };
+	int registered;
+
+	rc_config.mem_report_enabled = report;
+	rc_config.mem_sample_period = period;
+
+	printf("Tier: %s\n", label);
+
+	/* Churn: free, reallocate, and grow each slot in turn */
+	for (int r = 0; r < TRACK_ROUNDS; r++)
+	{
+		for (int i = 0; i < TRACK_LIVE; i++)
+		{
+			mem_free(&live[i]);
+			mem_alloc(&live[i], track_size(r + i));
+			mem_realloc(&live[i], 2 * track_size(r + i));
+		}
+	}
+
+	registered = count_registered(live, TRACK_LIVE);
+	printf("  %d of %d live blocks registered\n", registered, TRACK_LIVE);
+
+	switch (mem_track_tier())
+	{
+	case MEM_TRACK_OFF:
+		check("off tier registers nothing", registered == 0);
+		break;
+
+	case MEM_TRACK_SAMPLE:
+		/* The tick is global, so the sampled share of the final slots is
+		 * 1/period to within one block per period boundary */
+		check("sample tier registers about 1 in period",
+			registered >= TRACK_LIVE / period - 1 &&
+			registered <= TRACK_LIVE / period + 1);
+		break;
+
+	case MEM_TRACK_FULL:
+		check("full tier registers every block", registered == TRACK_LIVE);
+		break;
+	}
+
+	for (int i = 0; i < TRACK_LIVE; i++)
+		mem_free(&live[i]);
+}
+
+/* A sampled block grown beyond its capacity keeps its registration */
+static void test_sample_relocation(void)
+{
+	char *p = NULL;
+	int tracked = 0;
+
+	printf("Test: sampled block survives relocation\n");
+
+	rc_config.mem_report_enabled = 0;
+	rc_config.mem_sample_period = 1;
+
+	mem_alloc(&p, 64);
+	tracked = mem_obj_from_ptr(p)->registered;
+	mem_realloc(&p, 1 << 20);
+	check("period 1 tracks the fresh block", tracked);
+	check("relocated block still registered", mem_obj_from_ptr(p)->registered);
+
+	mem_free(&p);
+	rc_config.mem_sample_period = 0;
+}
+
+int main(void)
+{
+	printf("=== Managed allocator tracking tiers ===\n\n");
+
+	check_tier("off", 0, 0);
+	check_tier("sample", 0, TRACK_PERIOD);
+	check_tier("full", 1, 0);
+	test_sample_relocation();
+
+	rc_config.mem_report_enabled = 0;
+	rc_config.mem_sample_period = 0;
+
+	printf("\n=== Results: %d/%d passed ===\n",
+		test_count - test_failures, test_count);
+
+	return test_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/*
+ *  Unit tests for the .npy writer of the binary pattern and current exports.
+ *
+ *  numpy reads a .npy header as a Python literal after a fixed preamble, so
+ *  the checks are on its bytes: the magic and version, the little-endian
+ *  header length, the descriptor of a record with scalar and sub-array
+ *  fields, the padding that starts the data on a 64-byte boundary and the
+ *  newline that ends the header.  A descriptor too long for its buffer
+ *  must be refused and left as it was.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "npy.h"
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define ASSERT_TRUE(cond, msg) \
+	do { \
+		tests_run++; \
+		if ((cond)) { \
+			tests_passed++; \
+		} \
+		else { \
+			tests_failed++; \
+			fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, (msg)); \
+		} \
+	} while (0)
+
+/*------------------------------------------------------------------------*/
+
+static void test_descr(void)
+{
+	char descr[NPY_DESCR_LEN] = "";
+	char want[128];
+	int dims2[2] = { 37, 73 };
+	int dims1[1] = { 12 };
+
+	ASSERT_TRUE(npy_descr_field(descr, "mhz", "f8", NULL, 0) == 0, "scalar field");
+	ASSERT_TRUE(npy_descr_field(descr, "gtot", "f8", dims2, 2) == 0, "2-d field");
+	ASSERT_TRUE(npy_descr_field(descr, "cur", "c16", dims1, 1) == 0, "1-d field");
+
+	snprintf(want, sizeof(want),
+		"('mhz', '%cf8'), ('gtot', '%cf8', (37, 73)), ('cur', '%cc16', (12,))",
+		NPY_ENDIAN, NPY_ENDIAN, NPY_ENDIAN);
+	ASSERT_TRUE(strcmp(descr, want) == 0, "descriptor text");
+}
+
+static void test_descr_overflow(void)
+{
+	char descr[NPY_DESCR_LEN] = "";
+	char name[64];
+	char before[NPY_DESCR_LEN];
+	int i, rc = 0;
+
+	/* Fill the buffer until a field no longer fits */
+	for (i = 0; i < NPY_DESCR_LEN && rc == 0; i++)
+	{
+		snprintf(name, sizeof(name), "field_%d", i);
+		strcpy(before, descr);
+		rc = npy_descr_field(descr, name, "f8", NULL, 0);
+	}
+
+	ASSERT_TRUE(rc == -1, "overflow is refused");
+	ASSERT_TRUE(strcmp(descr, before) == 0, "refused field leaves the descriptor");
+}
+
+static void test_header(void)
+{
+	char descr[NPY_DESCR_LEN] = "";
+	unsigned char buf[1024];
+	int dims[2] = { 4, 5 };
+	size_t len;
+	long total;
+	unsigned hlen;
+	FILE *fp;
+
+	npy_descr_field(descr, "mhz", "f8", NULL, 0);
+	npy_descr_field(descr, "sens", "i4", dims, 2);
+
+	fp = tmpfile();
+	ASSERT_TRUE(fp != NULL, "tmpfile");
+	if (fp == NULL)
+		return;
+
+	total = npy_write_header(fp, descr, 501);
+	rewind(fp);
+	len = fread(buf, 1, sizeof(buf), fp);
+	fclose(fp);
+
+	ASSERT_TRUE(total > 0 && (size_t)total == len, "returned length is the file length");
+	ASSERT_TRUE(total % NPY_ALIGN == 0, "data starts aligned");
+	ASSERT_TRUE(memcmp(buf, "\x93NUMPY\x01\x00", 8) == 0, "magic and version 1.0");
+
+	hlen = buf[8] | (buf[9] << 8);
+	ASSERT_TRUE(hlen + 10 == (unsigned)total, "header length field");
+	ASSERT_TRUE(buf[total - 1] == '\n', "header ends in a newline");
+	ASSERT_TRUE(buf[total - 2] == ' ', "header is padded with spaces");
+
+	buf[total - 1] = '\0';
+	ASSERT_TRUE(strstr((char *)buf + 10, "'descr': [('mhz', ") != NULL, "descr is a record");
+	ASSERT_TRUE(strstr((char *)buf + 10, "'fortran_order': False") != NULL, "C order");
+	ASSERT_TRUE(strstr((char *)buf + 10, "'shape': (501,)") != NULL, "shape is the row count");
+}
+
+/*------------------------------------------------------------------------*/
+
+int main(void)
+{
+	test_descr();
+	test_descr_overflow();
+	test_header();
+
+	printf("npy_test: %d tests, %d passed, %d failed\n",
+		tests_run, tests_passed, tests_failed);
+
+	return tests_failed > 0 ? 1 : 0;
+}
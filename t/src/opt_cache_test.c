@@ -0,0 +1,276 @@
+/*
+ * Optimizer Evaluation Cache Tests
+ *
+ * Validates the hashed evaluation cache:
+ *   1. Exact keys: hits, misses, -0 == 0, replacement
+ *   2. Quantization tolerance
+ *   3. Payloads
+ *   4. Growth past many rehashes
+ *   5. Strided keys (matrix columns, as the batch trampoline passes)
+ *   6. Save and load, including a foreign tag and layout
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gsl/gsl_matrix.h>
+
+#include "opt_cache.h"
+#include "optimizer_test_common.h"
+
+/**
+ * assert_true - check boolean condition
+ * @name: test description
+ * @cond: condition to verify
+ */
+static int assert_true(const char *name, int cond)
+{
+	test_count++;
+	if (cond)
+	{
+		printf("  PASS: %s\n", name);
+		return 1;
+	}
+
+	printf("  FAIL: %s\n", name);
+	test_failures++;
+	return 0;
+}
+
+/** Build a 2-vector */
+static gsl_vector *vec2(double a, double b)
+{
+	gsl_vector *v = gsl_vector_alloc(2);
+
+	gsl_vector_set(v, 0, a);
+	gsl_vector_set(v, 1, b);
+	return v;
+}
+
+static void test_exact(void)
+{
+	printf("Test: exact keys\n");
+
+	opt_cache_t *c = opt_cache_new(2, 0, 0.0);
+	gsl_vector *a = vec2(1.0, 2.0);
+	gsl_vector *b = vec2(1.0, 2.0 + 1e-15);
+	gsl_vector *z = vec2(-0.0, 2.0);
+	gsl_vector *pz = vec2(0.0, 2.0);
+	double v = NAN;
+
+	assert_true("empty cache misses", !opt_cache_lookup(c, a, &v, NULL));
+
+	opt_cache_store(c, a, 5.0, NULL);
+	assert_true("stored key hits", opt_cache_lookup(c, a, &v, NULL));
+	assert_near("stored value", v, 5.0, 1e-12);
+	assert_true("nearby key misses", !opt_cache_lookup(c, b, NULL, NULL));
+
+	opt_cache_store(c, z, 7.0, NULL);
+	assert_true("+0 finds -0", opt_cache_lookup(c, pz, &v, NULL));
+	assert_near("-0 value", v, 7.0, 1e-12);
+
+	opt_cache_store(c, a, 6.0, NULL);
+	opt_cache_lookup(c, a, &v, NULL);
+	assert_near("replaced value", v, 6.0, 1e-12);
+	assert_near("entries", opt_cache_count(c), 2, 0.5);
+
+	gsl_vector *one = gsl_vector_alloc(1);
+	gsl_vector_set(one, 0, 1.0);
+	assert_true("wrong length misses", !opt_cache_lookup(c, one, NULL, NULL));
+	assert_true("wrong length not stored", opt_cache_store(c, one, 1.0, NULL) != 0);
+	gsl_vector_free(one);
+
+	opt_cache_clear(c);
+	assert_true("cleared cache misses", !opt_cache_lookup(c, a, NULL, NULL));
+
+	gsl_vector_free(a);
+	gsl_vector_free(b);
+	gsl_vector_free(z);
+	gsl_vector_free(pz);
+	opt_cache_free(c);
+}
+
+static void test_tolerance(void)
+{
+	printf("Test: quantization tolerance\n");
+
+	opt_cache_t *c = opt_cache_new(2, 0, 0.01);
+	gsl_vector *a = vec2(1.000, 2.000);
+	gsl_vector *b = vec2(1.004, 1.997);
+	gsl_vector *d = vec2(1.012, 2.000);
+	double v = NAN;
+
+	opt_cache_store(c, a, 3.0, NULL);
+	assert_true("within tolerance hits", opt_cache_lookup(c, b, &v, NULL));
+	assert_near("shared value", v, 3.0, 1e-12);
+	assert_true("beyond tolerance misses", !opt_cache_lookup(c, d, NULL, NULL));
+	assert_true("same_key within tolerance", opt_cache_same_key(c, a, b));
+	assert_true("same_key beyond tolerance", !opt_cache_same_key(c, a, d));
+
+	gsl_vector_free(a);
+	gsl_vector_free(b);
+	gsl_vector_free(d);
+	opt_cache_free(c);
+}
+
+static void test_payload(void)
+{
+	printf("Test: payloads\n");
+
+	double in[3] = { 1.5, -2.5, 3.5 };
+	const void *out = NULL;
+	opt_cache_t *c = opt_cache_new(2, sizeof(in), 0.0);
+	gsl_vector *a = vec2(4.0, 5.0);
+	gsl_vector *b = vec2(6.0, 7.0);
+
+	opt_cache_store(c, a, 1.0, in);
+	opt_cache_store(c, b, 2.0, NULL);
+
+	assert_true("payload hit", opt_cache_lookup(c, a, NULL, &out));
+	assert_true("payload round trip", out && memcmp(out, in, sizeof(in)) == 0);
+
+	opt_cache_lookup(c, b, NULL, &out);
+	assert_near("NULL payload stores zeros", ((const double *)out)[2], 0.0, 1e-12);
+
+	gsl_vector_free(a);
+	gsl_vector_free(b);
+	opt_cache_free(c);
+}
+
+static void test_growth(void)
+{
+	printf("Test: 20000 entries across rehashes\n");
+
+	opt_cache_t *c = opt_cache_new(3, sizeof(int), 0.0);
+	gsl_vector *k = gsl_vector_alloc(3);
+	int bad = 0;
+
+	for (int i = 0; i < 20000; i++)
+	{
+		gsl_vector_set(k, 0, i * 0.001);
+		gsl_vector_set(k, 1, -i);
+		gsl_vector_set(k, 2, 42.0);
+		opt_cache_store(c, k, i, &i);
+	}
+
+	for (int i = 0; i < 20000; i++)
+	{
+		double v;
+		const void *p;
+
+		gsl_vector_set(k, 0, i * 0.001);
+		gsl_vector_set(k, 1, -i);
+		gsl_vector_set(k, 2, 42.0);
+
+		if (!opt_cache_lookup(c, k, &v, &p) || v != i || *(const int *)p != i)
+		{
+			bad++;
+		}
+	}
+
+	assert_near("entries", opt_cache_count(c), 20000, 0.5);
+	assert_near("entries not found intact", bad, 0, 0.5);
+
+	gsl_vector_set(k, 2, 43.0);
+	assert_true("absent key misses", !opt_cache_lookup(c, k, NULL, NULL));
+
+	gsl_vector_free(k);
+	opt_cache_free(c);
+}
+
+static void test_strided(void)
+{
+	printf("Test: strided keys\n");
+
+	opt_cache_t *c = opt_cache_new(2, 0, 0.0);
+	gsl_matrix *m = gsl_matrix_alloc(2, 3);
+	gsl_vector *a = vec2(8.0, 9.0);
+
+	gsl_matrix_set(m, 0, 1, 8.0);
+	gsl_matrix_set(m, 1, 1, 9.0);
+
+	gsl_vector_view col = gsl_matrix_column(m, 1);
+
+	opt_cache_store(c, &col.vector, 11.0, NULL);
+	assert_true("contiguous key finds column key",
+		opt_cache_lookup(c, a, NULL, NULL));
+	assert_true("same_key column vs contiguous",
+		opt_cache_same_key(c, &col.vector, a));
+
+	gsl_vector_free(a);
+	gsl_matrix_free(m);
+	opt_cache_free(c);
+}
+
+static void test_save_load(void)
+{
+	printf("Test: save and load\n");
+
+	char path[] = "/tmp/opt_cache_testXXXXXX";
+	int fd = mkstemp(path);
+	double in[2] = { 0.25, 0.75 };
+	const void *out = NULL;
+	double v = NAN;
+
+	if (fd < 0)
+	{
+		printf("  FAIL: mkstemp\n");
+		test_failures++;
+		return;
+	}
+	close(fd);
+
+	opt_cache_t *c = opt_cache_new(2, sizeof(in), 0.0);
+	gsl_vector *a = vec2(1.0, 1.0);
+	gsl_vector *b = vec2(2.0, 2.0);
+
+	opt_cache_store(c, a, 10.0, in);
+	opt_cache_store(c, b, 20.0, in);
+	assert_true("save", opt_cache_save(c, path, "model-a") == 0);
+
+	opt_cache_t *r = opt_cache_new(2, sizeof(in), 0.0);
+	assert_near("load merges both", opt_cache_load(r, path, "model-a"), 2, 0.5);
+	assert_true("loaded key hits", opt_cache_lookup(r, b, &v, &out));
+	assert_near("loaded value", v, 20.0, 1e-12);
+	assert_true("loaded payload", out && memcmp(out, in, sizeof(in)) == 0);
+	opt_cache_free(r);
+
+	r = opt_cache_new(2, sizeof(in), 0.0);
+	assert_near("other tag merges nothing", opt_cache_load(r, path, "model-b"), 0, 0.5);
+	opt_cache_free(r);
+
+	r = opt_cache_new(3, sizeof(in), 0.0);
+	assert_near("other dims merge nothing", opt_cache_load(r, path, "model-a"), 0, 0.5);
+	opt_cache_free(r);
+
+	remove(path);
+	r = opt_cache_new(2, sizeof(in), 0.0);
+	assert_near("missing file merges nothing", opt_cache_load(r, path, "model-a"), 0, 0.5);
+	opt_cache_free(r);
+
+	gsl_vector_free(a);
+	gsl_vector_free(b);
+	opt_cache_free(c);
+}
+
+int main(void)
+{
+	printf("=== Optimizer Cache Test Suite ===\n\n");
+
+	test_exact();
+	printf("\n");
+	test_tolerance();
+	printf("\n");
+	test_payload();
+	printf("\n");
+	test_growth();
+	printf("\n");
+	test_strided();
+	printf("\n");
+	test_save_load();
+
+	printf("\n=== Results: %d tests, %d failures ===\n",
+		test_count, test_failures);
+
+	return test_failures > 0 ? 1 : 0;
+}
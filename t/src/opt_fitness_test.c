@@ -2,8 +2,8 @@
  *  Unit tests for opt_fitness.c
  *
  *  Tests fitness_transform(), reduce_values (via fitness_compute),
- *  fitness_config dynamic operations, and full fitness_compute()
- *  with synthetic measurement_t arrays.
+ *  fitness_config dynamic operations, full fitness_compute() with
+ *  synthetic measurement_t arrays, and the reduced-sweep scope helpers.
  *
  *  Copyright (C) 2025 eWheeler, Inc. <https://www.linuxglobal.com/>
  */
@@ -706,6 +706,79 @@ static void test_duplicate_measurement(void)
 
 /*------------------------------------------------------------------------*/
 
+static void test_needed_steps(void)
+{
+	fitness_config_t cfg;
+	double freq[5] = { 140.0, 144.0, 146.0, 148.0, 152.0 };
+	char need[5];
+	int count;
+
+	/* VSWR over 144-146, gain disabled */
+	fitness_config_init(&cfg);
+	cfg.obj[1].enabled = 0;
+	cfg.obj[0].mhz_min = 144.0;
+	cfg.obj[0].mhz_max = 146.0;
+
+	count = fitness_needed_steps(&cfg, freq, 5, need);
+
+	ASSERT_NEAR(count, 2, 0.5, "two steps in range");
+	ASSERT_TRUE(!need[0] && need[1] && need[2] && !need[3] && !need[4],
+		"range bounds are inclusive");
+	ASSERT_TRUE(!fitness_needs_pattern(&cfg), "VSWR alone needs no pattern");
+
+	/* A zero-weight objective reads nothing */
+	cfg.obj[1].enabled = 1;
+	cfg.obj[1].weight = 0.0;
+	count = fitness_needed_steps(&cfg, freq, 5, need);
+	ASSERT_NEAR(count, 2, 0.5, "zero weight gain adds no steps");
+	ASSERT_TRUE(!fitness_needs_pattern(&cfg), "zero weight gain needs no pattern");
+
+	/* Gain over the whole sweep */
+	cfg.obj[1].weight = 1.0;
+	count = fitness_needed_steps(&cfg, freq, 5, need);
+	ASSERT_NEAR(count, 5, 0.5, "unbounded objective reads every step");
+	ASSERT_TRUE(fitness_needs_pattern(&cfg), "gain needs the pattern");
+
+	fitness_config_free(&cfg);
+}
+
+/*------------------------------------------------------------------------*/
+
+static void test_covered(void)
+{
+	fitness_config_t cfg;
+	measurement_t meas[3];
+	double freq[3] = { 144.0, 146.0, 148.0 };
+	double vswr_vals[3] = { 1.5, 1.2, NAN };
+
+	fitness_config_init(&cfg);
+	cfg.obj[1].enabled = 0;
+	cfg.obj[0].mhz_max = 146.0;
+
+	build_meas(3, MEAS_VSWR, vswr_vals, meas);
+
+	ASSERT_TRUE(fitness_covered(&cfg, meas, 3, freq),
+		"unsolved step outside the range is covered");
+
+	cfg.obj[0].mhz_max = NAN;
+	ASSERT_TRUE(!fitness_covered(&cfg, meas, 3, freq),
+		"unsolved step inside the range is not covered");
+
+	/* -1 marks a value meas_calc() cannot compute, not an unsolved one */
+	meas[2].vswr = -1.0;
+	ASSERT_TRUE(fitness_covered(&cfg, meas, 3, freq),
+		"invalid value is covered");
+
+	meas[1].gain_max = NAN;
+	cfg.obj[1].enabled = 1;
+	ASSERT_TRUE(!fitness_covered(&cfg, meas, 3, freq),
+		"unsolved pattern field is not covered");
+
+	fitness_config_free(&cfg);
+}
+
+/*------------------------------------------------------------------------*/
+
 int main(void)
 {
 	printf("opt_fitness_test: running tests\n");
@@ -726,6 +799,8 @@ int main(void)
 	test_defaults_table();
 	test_zero_weight_skipped();
 	test_duplicate_measurement();
+	test_needed_steps();
+	test_covered();
 
 	printf("\nopt_fitness_test: %d tests, %d passed, %d failed\n",
 		tests_run, tests_passed, tests_failed);
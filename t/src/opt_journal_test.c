@@ -0,0 +1,404 @@
+/*
+ * Optimizer Journal Tests
+ *
+ * Validates the evaluation journal:
+ *   1. Records round trip through a resume, seed included
+ *   2. Divergence drops the rest and the run continues the file
+ *   3. A torn last record is dropped, a damaged one ends the replay
+ *   4. An end record, another tag or another layout starts over
+ *   5. The scan and the convergence data skip the payloads
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gsl/gsl_matrix.h>
+
+#include "opt_journal.h"
+#include "optimizer_test_common.h"
+
+/** Measurement stand-in: any fixed-size record */
+typedef struct
+{
+	double a;
+	double b;
+	int    c;
+} meas_t;
+
+/**
+ * assert_true - check boolean condition
+ * @name: test description
+ * @cond: condition to verify
+ */
+static int assert_true(const char *name, int cond)
+{
+	test_count++;
+	if (cond)
+	{
+		printf("  PASS: %s\n", name);
+		return 1;
+	}
+
+	printf("  FAIL: %s\n", name);
+	test_failures++;
+	return 0;
+}
+
+/** Identity of the test runs */
+static opt_journal_info_t test_info(const char *tag, int seed)
+{
+	opt_journal_info_t info = { tag, 1, seed, 2, sizeof(meas_t) };
+
+	return info;
+}
+
+/** Evaluation i of a made-up run: key (i, -i), i+1 steps */
+static int append_eval(opt_journal_t *j, int i)
+{
+	gsl_vector *key = gsl_vector_alloc(2);
+	double freq[8];
+	meas_t meas[8];
+	int ret;
+
+	gsl_vector_set(key, 0, i);
+	gsl_vector_set(key, 1, -i);
+
+	for (int s = 0; s <= i; s++)
+	{
+		freq[s] = 14.0 + s;
+		meas[s].a = i * 10 + s;
+		meas[s].b = -s;
+		meas[s].c = i;
+	}
+
+	ret = opt_journal_append_eval(j, key, 100.0 - i, freq, meas, i + 1);
+	gsl_vector_free(key);
+
+	return ret;
+}
+
+/** Check that rec is evaluation i of append_eval() */
+static int is_eval(const opt_journal_rec_t *rec, int i)
+{
+	const meas_t *m = rec->meas;
+
+	return rec->type == OPT_JOURNAL_EVAL && rec->steps == i + 1
+		&& rec->fitness == 100.0 - i
+		&& rec->key[0] == i && rec->key[1] == -i
+		&& rec->freq[i] == 14.0 + i
+		&& m[i].a == i * 10 + i && m[i].c == i;
+}
+
+/** New journal of evals 0..n-1 and a snapshot after each, left open */
+static opt_journal_t *write_run(const char *path, int n, int seed)
+{
+	opt_journal_info_t info = test_info("model-a", seed);
+	opt_journal_t *j;
+	gsl_matrix *pos = gsl_matrix_alloc(2, 3);
+	gsl_matrix *vel = gsl_matrix_alloc(2, 3);
+
+	remove(path);
+	j = opt_journal_open(path, &info);
+
+	for (int i = 0; j && i < n; i++)
+	{
+		gsl_matrix_set_all(pos, i);
+		gsl_matrix_set_all(vel, -i);
+		append_eval(j, i);
+		opt_journal_append_state(j, 1, i + 1, 100.0 - i, pos, vel);
+	}
+
+	gsl_matrix_free(pos);
+	gsl_matrix_free(vel);
+
+	return j;
+}
+
+static void test_resume(const char *path)
+{
+	printf("Test: resume replays every record\n");
+
+	opt_journal_info_t info = test_info("model-a", 999);
+	opt_journal_rec_t rec;
+	opt_journal_t *j = write_run(path, 4, 1234);
+	int evals = 0;
+	int states = 0;
+	int ok = 1;
+
+	assert_true("fresh journal does not replay", !opt_journal_replaying(j));
+	opt_journal_close(j);
+
+	j = opt_journal_open(path, &info);
+	assert_true("resumes", opt_journal_replaying(j));
+	assert_near("journaled seed", info.seed, 1234, 0.5);
+
+	while (opt_journal_next(j, &rec))
+	{
+		if (rec.type == OPT_JOURNAL_EVAL)
+		{
+			ok &= is_eval(&rec, evals++);
+		}
+		else if (rec.type == OPT_JOURNAL_STATE)
+		{
+			ok &= rec.iter == states + 1 && rec.rows == 2 && rec.cols == 3
+				&& rec.pos[5] == states && rec.vel && rec.vel[0] == -states;
+			states++;
+		}
+	}
+
+	assert_near("evaluations replayed", evals, 4, 0.5);
+	assert_near("snapshots replayed", states, 4, 0.5);
+	assert_true("records intact", ok);
+	assert_true("replay ended", !opt_journal_replaying(j));
+
+	/* The run goes on past the journal */
+	append_eval(j, 4);
+	opt_journal_close(j);
+
+	j = opt_journal_open(path, &info);
+	for (evals = 0; opt_journal_next(j, &rec); )
+	{
+		evals += rec.type == OPT_JOURNAL_EVAL;
+	}
+	assert_near("appended after replay", evals, 5, 0.5);
+	opt_journal_close(j);
+}
+
+static void test_diverge(const char *path)
+{
+	printf("Test: divergence continues the file\n");
+
+	opt_journal_info_t info = test_info("model-a", 0);
+	opt_journal_rec_t rec;
+	opt_journal_t *j = write_run(path, 3, 7);
+	int evals = 0;
+
+	opt_journal_close(j);
+
+	/* Replay eval 0 and its snapshot, then depart at eval 1 */
+	j = opt_journal_open(path, &info);
+	opt_journal_next(j, &rec);
+	opt_journal_next(j, &rec);
+	opt_journal_next(j, &rec);
+	assert_true("third record is eval 1", is_eval(&rec, 1));
+
+	opt_journal_diverge(j);
+	assert_true("replay ended", !opt_journal_replaying(j));
+	append_eval(j, 5);
+	opt_journal_close(j);
+
+	j = opt_journal_open(path, &info);
+	while (opt_journal_next(j, &rec))
+	{
+		if (rec.type == OPT_JOURNAL_EVAL)
+		{
+			evals++;
+		}
+	}
+	assert_near("evaluations kept", evals, 2, 0.5);
+	assert_true("last is the new eval", is_eval(&rec, 5));
+	opt_journal_close(j);
+
+	/* Appending mid-replay drops the records not read */
+	j = opt_journal_open(path, &info);
+	opt_journal_next(j, &rec);
+	append_eval(j, 6);
+	opt_journal_close(j);
+
+	j = opt_journal_open(path, &info);
+	opt_journal_next(j, &rec);
+	opt_journal_next(j, &rec);
+	assert_true("append mid-replay follows the read record", is_eval(&rec, 6));
+	assert_true("nothing after it", !opt_journal_next(j, &rec));
+	opt_journal_close(j);
+}
+
+static void test_torn(const char *path)
+{
+	printf("Test: torn and damaged records\n");
+
+	opt_journal_info_t info = test_info("model-a", 0);
+	opt_journal_rec_t rec;
+	opt_journal_t *j = write_run(path, 3, 7);
+	int records = 0;
+	FILE *fp;
+	long size;
+
+	opt_journal_close(j);
+
+	/* A crash in the middle of the last snapshot */
+	fp = fopen(path, "r+b");
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fclose(fp);
+	assert_true("torn", truncate(path, size - 5) == 0);
+
+	assert_near("scan stops at the torn record",
+		opt_journal_scan(path, NULL, NULL), 5, 0.5);
+
+	j = opt_journal_open(path, &info);
+	while (opt_journal_next(j, &rec))
+	{
+		records++;
+	}
+	assert_near("torn record dropped", records, 5, 0.5);
+	opt_journal_close(j);
+
+	/* A flipped byte inside the second eval's measurements */
+	fp = fopen(path, "r+b");
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, size / 2, SEEK_SET);
+	fputc(0x5a ^ fgetc(fp), fp);
+	fclose(fp);
+
+	j = opt_journal_open(path, &info);
+	for (records = 0; opt_journal_next(j, &rec); )
+	{
+		records++;
+	}
+	assert_true("damaged record ends the replay", records < 5);
+	opt_journal_close(j);
+}
+
+static void test_start_over(const char *path)
+{
+	printf("Test: what starts over\n");
+
+	opt_journal_info_t info = test_info("model-a", 42);
+	opt_journal_t *j = write_run(path, 2, 7);
+
+	opt_journal_append_end(j);
+	opt_journal_close(j);
+
+	j = opt_journal_open(path, &info);
+	assert_true("completed run starts over", !opt_journal_replaying(j));
+	assert_near("own seed kept", info.seed, 42, 0.5);
+	opt_journal_close(j);
+	assert_near("file emptied", opt_journal_scan(path, NULL, NULL), 0, 0.5);
+
+	opt_journal_close(write_run(path, 2, 7));
+	info = test_info("model-b", 42);
+	j = opt_journal_open(path, &info);
+	assert_true("other tag starts over", !opt_journal_replaying(j));
+	opt_journal_close(j);
+
+	opt_journal_close(write_run(path, 2, 7));
+	info = test_info("model-a", 42);
+	info.dims = 3;
+	j = opt_journal_open(path, &info);
+	assert_true("other dims start over", !opt_journal_replaying(j));
+	opt_journal_close(j);
+
+	opt_journal_close(write_run(path, 2, 7));
+	info = test_info("model-a", 42);
+	info.algorithm = 2;
+	j = opt_journal_open(path, &info);
+	assert_true("other algorithm starts over", !opt_journal_replaying(j));
+	opt_journal_close(j);
+}
+
+/** Tallies the records opt_journal_scan() visits */
+typedef struct
+{
+	int evals;
+	int states;
+	int ends;
+	int payloads;
+	double best;
+} tally_t;
+
+static int tally(const opt_journal_rec_t *rec, void *ctx)
+{
+	tally_t *t = ctx;
+
+	t->evals += rec->type == OPT_JOURNAL_EVAL;
+	t->states += rec->type == OPT_JOURNAL_STATE;
+	t->ends += rec->type == OPT_JOURNAL_END;
+	t->payloads += rec->key != NULL || rec->pos != NULL;
+
+	if (rec->type == OPT_JOURNAL_EVAL && rec->fitness < t->best)
+	{
+		t->best = rec->fitness;
+	}
+
+	return 0;
+}
+
+static void test_scan(const char *path)
+{
+	printf("Test: scan and convergence data\n");
+
+	tally_t t = { 0, 0, 0, 0, INFINITY };
+	opt_journal_t *j = write_run(path, 6, 7);
+	char line[256];
+	int rows = 0;
+	int blocks = 0;
+	FILE *out;
+
+	opt_journal_append_end(j);
+	opt_journal_close(j);
+
+	assert_near("records", opt_journal_scan(path, tally, &t), 13, 0.5);
+	assert_near("evaluations", t.evals, 6, 0.5);
+	assert_near("snapshots", t.states, 6, 0.5);
+	assert_near("end", t.ends, 1, 0.5);
+	assert_near("payloads skipped", t.payloads, 0, 0.5);
+	assert_near("best fitness", t.best, 95.0, 1e-12);
+
+	out = tmpfile();
+	assert_true("convergence written",
+		opt_journal_write_convergence(path, out) == 0);
+	rewind(out);
+
+	while (fgets(line, sizeof(line), out))
+	{
+		if (line[0] == '\n')
+		{
+			blocks++;
+		}
+		else if (line[0] != '#')
+		{
+			rows++;
+		}
+	}
+	fclose(out);
+
+	assert_near("convergence rows", rows, 12, 0.5);
+	assert_near("index separator", blocks, 2, 0.5);
+
+	assert_near("scan of a non-journal", opt_journal_scan("/dev/null", NULL, NULL),
+		-1, 0.5);
+}
+
+int main(void)
+{
+	char path[] = "/tmp/opt_journal_testXXXXXX";
+	int fd = mkstemp(path);
+
+	printf("=== Optimizer Journal Test Suite ===\n\n");
+
+	if (fd < 0)
+	{
+		printf("  FAIL: mkstemp\n");
+		return 1;
+	}
+	close(fd);
+
+	test_resume(path);
+	printf("\n");
+	test_diverge(path);
+	printf("\n");
+	test_torn(path);
+	printf("\n");
+	test_start_over(path);
+	printf("\n");
+	test_scan(path);
+
+	remove(path);
+
+	printf("\n=== Results: %d tests, %d failures ===\n",
+		test_count, test_failures);
+
+	return test_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * Sensitivity Tests
+ *
+ * Validates the Jacobian of the measurements:
+ *   1. Perturbation steps follow the range, else the value
+ *   2. Central differences of known linear and quadratic responses
+ *   3. Unmeasured fields give NAN derivatives
+ *   4. The CSV has a row per step and measurement
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opt_sensitivity.h"
+#include "optimizer_test_common.h"
+
+/* measurements.c is not linked; the CSV only reads the names */
+const char *meas_names[MEAS_COUNT + 1] = {
+	"mhz", "zreal", "zimag", "zmag", "zphase", "vswr", "s11", "s11_real",
+	"s11_imag", "s11_ang", "gain_max", "gain_net", "gain_theta", "gain_phi",
+	"gain_viewer", "gain_viewer_net", "fb_ratio", "gain_dev_px",
+	"gain_dev_nx", "gain_dev_py", "gain_dev_ny", "gain_dev_pz",
+	"gain_dev_nz", "ant_temp", "ant_temp_tot", "gt", NULL
+};
+
+#define STEPS 3
+
+/**
+ * assert_true - check boolean condition
+ * @name: test description
+ * @cond: condition to verify
+ */
+static int assert_true(const char *name, int cond)
+{
+	test_count++;
+	if (cond)
+	{
+		printf("  PASS: %s\n", name);
+		return 1;
+	}
+
+	printf("  FAIL: %s\n", name);
+	test_failures++;
+	return 0;
+}
+
+/**
+ * model - made-up response of two vars at frequency step i
+ * @m: output
+ * @i: step
+ * @a: first var
+ * @b: second var
+ *
+ * vswr = 2a + 3b + i, zreal = a * a, zimag = 5 (flat), gain_max unmeasured.
+ */
+static void model(measurement_t *m, int i, double a, double b)
+{
+	for (int f = 0; f < MEAS_COUNT; f++)
+	{
+		m->a[f] = 0.0;
+	}
+
+	m->mhz = 14.0 + i;
+	m->vswr = 2 * a + 3 * b + i;
+	m->zreal = a * a;
+	m->zimag = 5.0;
+	m->gain_max = NAN;
+}
+
+/** Jacobian of model() at (a, b), sets laid out as the runner does */
+static opt_sensitivity_t *jacobian_at(double a, double b, const double *h)
+{
+	static const char *names[] = { "LEN", "GAP" };
+	double x[2] = { a, b };
+	measurement_t sets[5 * STEPS];
+	opt_sensitivity_t *s = opt_sensitivity_new(names, x, h, 2, STEPS);
+
+	for (int i = 0; i < STEPS; i++)
+	{
+		model(&sets[0 * STEPS + i], i, a + h[0], b);
+		model(&sets[1 * STEPS + i], i, a - h[0], b);
+		model(&sets[2 * STEPS + i], i, a, b + h[1]);
+		model(&sets[3 * STEPS + i], i, a, b - h[1]);
+		model(&sets[4 * STEPS + i], i, a, b);
+		s->base[i] = sets[4 * STEPS + i];
+	}
+
+	opt_sensitivity_compute(s, sets, STEPS);
+
+	return s;
+}
+
+static void test_step(void)
+{
+	printf("Test: perturbation steps\n");
+
+	assert_near("from the range", opt_sensitivity_step(5.0, 0.0, 2.0),
+		2.0 * OPT_SENS_REL_STEP, 1e-15);
+	assert_near("from the value without a range",
+		opt_sensitivity_step(-4.0, 1.0, 1.0), 4.0 * OPT_SENS_REL_STEP, 1e-15);
+	assert_near("from a reversed range's value",
+		opt_sensitivity_step(3.0, 2.0, 1.0), 3.0 * OPT_SENS_REL_STEP, 1e-15);
+	assert_near("at zero", opt_sensitivity_step(0.0, 0.0, 0.0),
+		OPT_SENS_REL_STEP, 1e-15);
+}
+
+static void test_jacobian(void)
+{
+	printf("Test: central differences\n");
+
+	double h[2] = { 0.01, 0.002 };
+	opt_sensitivity_t *s = jacobian_at(1.5, -0.5, h);
+	int linear = 1;
+
+	for (int i = 0; i < STEPS; i++)
+	{
+		const double *row = opt_sensitivity_at(s, i, MEAS_VSWR);
+
+		linear &= fabs(row[0] - 2.0) < 1e-9 && fabs(row[1] - 3.0) < 1e-9;
+	}
+
+	assert_true("linear response exact at every step", linear);
+	assert_near("quadratic response exact", opt_sensitivity_at(s, 1,
+		MEAS_ZREAL)[0], 3.0, 1e-9);
+	assert_near("other var has no effect", opt_sensitivity_at(s, 1,
+		MEAS_ZREAL)[1], 0.0, 1e-15);
+	assert_near("flat response", opt_sensitivity_at(s, 2, MEAS_ZIMAG)[0],
+		0.0, 1e-15);
+	assert_true("unmeasured field is NAN",
+		isnan(opt_sensitivity_at(s, 0, MEAS_GAIN_MAX)[0]));
+	assert_near("base kept", s->base[2].vswr, 2 * 1.5 - 1.5 + 2, 1e-12);
+
+	opt_sensitivity_free(s);
+}
+
+static void test_csv(void)
+{
+	printf("Test: CSV output\n");
+
+	double h[2] = { 0.01, 0.01 };
+	opt_sensitivity_t *s = jacobian_at(1.0, 1.0, h);
+	int cols[2] = { MEAS_VSWR, MEAS_ZREAL };
+	char line[256];
+	int rows = 0;
+	int vswr_rows = 0;
+	double dv[2] = { NAN, NAN };
+	FILE *fp = tmpfile();
+
+	assert_true("written", opt_sensitivity_write_csv(s, fp, cols, 2) == 0);
+	rewind(fp);
+
+	assert_true("header", fgets(line, sizeof(line), fp)
+		&& strcmp(line, "mhz,measurement,value,d_LEN,d_GAP\n") == 0);
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		rows++;
+		if (strncmp(line, "15,vswr,6,", 10) == 0)
+		{
+			vswr_rows++;
+			sscanf(line + 10, "%lf,%lf", &dv[0], &dv[1]);
+		}
+	}
+	fclose(fp);
+
+	assert_near("row per step and column", rows, STEPS * 2, 0.5);
+	assert_true("values", vswr_rows == 1);
+	assert_near("first derivative", dv[0], 2.0, 1e-9);
+	assert_near("second derivative", dv[1], 3.0, 1e-9);
+
+	fp = tmpfile();
+	opt_sensitivity_write_csv(s, fp, NULL, 0);
+	rewind(fp);
+	for (rows = -1; fgets(line, sizeof(line), fp); rows++);
+	fclose(fp);
+	assert_near("every measurement but mhz", rows, STEPS * (MEAS_COUNT - 1),
+		0.5);
+
+	opt_sensitivity_free(s);
+}
+
+int main(void)
+{
+	printf("=== Sensitivity Test Suite ===\n\n");
+
+	test_step();
+	printf("\n");
+	test_jacobian();
+	printf("\n");
+	test_csv();
+
+	printf("\n=== Results: %d tests, %d failures ===\n",
+		test_count, test_failures);
+
+	return test_failures > 0 ? 1 : 0;
+}
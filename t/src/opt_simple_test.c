@@ -16,6 +16,7 @@
  *  10.  Cache                        -> cache_hits > 0
  *  11.  Config validation            -> reject bad configs
  *  12.  set_vars / set_ssize         -> mutate and re-optimize
+ *  13.  PSO batch fitness            -> same run as per-particle fitness
  */
 
 #include <math.h>
@@ -124,6 +125,31 @@ static void cache_log(const simple_var_t *vars, int n,
 	last_cache_hits = state->cache_hits;
 }
 
+/* Batch form of fit_sphere for test_pso_batch; counts its calls */
+static int batch_calls = 0;
+
+static void fit_sphere_batch(simple_var_t *const *vars, int num_sets,
+	int n, double *results, void *ctx)
+{
+	batch_calls++;
+	for (int k = 0; k < num_sets; k++)
+	{
+		results[k] = fit_sphere(vars[k], n, ctx);
+	}
+}
+
+/* Captures the final log state for test_pso_batch */
+static simple_log_state_t last_log;
+
+static void state_log(const simple_var_t *vars, int n,
+	const simple_log_state_t *state, void *ctx)
+{
+	(void)vars;
+	(void)n;
+	(void)ctx;
+	last_log = *state;
+}
+
 /* ---- Tests ---- */
 
 static void test_parabola_simplex(void)
@@ -742,6 +768,248 @@ static void test_set_vars_and_ssize(void)
 	simple_free(s);
 }
 
+/**
+ * pso_batch_run - optimize the rounded sphere with a fixed seed
+ * @batch: hand the swarm to fit_sphere_batch instead of fit_sphere
+ * @pos: output, best x and y
+ * @state: output, final log state
+ *
+ * Returns the best fitness.
+ */
+static double pso_batch_run(int batch, double pos[2], simple_log_state_t *state)
+{
+	gsl_vector *xv = gsl_vector_alloc(2);
+	gsl_vector *xmin = gsl_vector_alloc(2);
+	gsl_vector *xmax = gsl_vector_alloc(2);
+	gsl_vector *re = gsl_vector_alloc(2);
+
+	gsl_vector_set_all(xv, 5.0);
+	gsl_vector_set_all(xmin, -10.0);
+	gsl_vector_set_all(xmax, 10.0);
+
+	/* Coarse rounding makes particles collide, within and across batches */
+	gsl_vector_set_all(re, 0.5);
+
+	simple_var_t vars[] =
+	{
+		{ .name = "x", .values = xv, .min = xmin, .max = xmax,
+		  .round_each = re }
+	};
+
+	simple_config_t cfg;
+	simple_config_init(&cfg, OPT_PSO);
+	cfg.vars = vars;
+	cfg.num_vars = 1;
+	cfg.max_iter = 200;
+	cfg.srand_seed = 4242;
+	cfg.fit_func = fit_sphere;
+	cfg.fit_func_batch = batch ? fit_sphere_batch : NULL;
+	cfg.log_func = state_log;
+
+	simple_t *s = simple_new(&cfg);
+	gsl_vector_free(xv);
+	gsl_vector_free(xmin);
+	gsl_vector_free(xmax);
+	gsl_vector_free(re);
+
+	if (!s)
+	{
+		return NAN;
+	}
+
+	double best = simple_optimize(s);
+
+	int nv;
+	const simple_var_t *result = simple_get_result(s, &nv);
+	pos[0] = gsl_vector_get(result[0].values, 0);
+	pos[1] = gsl_vector_get(result[0].values, 1);
+	*state = last_log;
+
+	simple_free(s);
+	return best;
+}
+
+static void test_pso_batch(void)
+{
+	printf("Test 13: PSO batch fitness matches per-particle fitness\n");
+
+	double serial_pos[2], batch_pos[2];
+	simple_log_state_t serial_state, batch_state;
+
+	batch_calls = 0;
+	double serial = pso_batch_run(0, serial_pos, &serial_state);
+	assert_true("serial run makes no batch calls", batch_calls == 0);
+
+	double batched = pso_batch_run(1, batch_pos, &batch_state);
+	assert_true("batch run uses fit_func_batch", batch_calls > 0);
+
+	assert_true("same best fitness", serial == batched);
+	assert_true("same best x", serial_pos[0] == batch_pos[0]);
+	assert_true("same best y", serial_pos[1] == batch_pos[1]);
+	assert_true("same iteration count",
+		serial_state.iter_count == batch_state.iter_count);
+	assert_true("same cache hits",
+		serial_state.cache_hits == batch_state.cache_hits);
+	assert_true("same cache misses",
+		serial_state.cache_misses == batch_state.cache_misses);
+	assert_near("converged", batched, 0.0, 1e-9);
+}
+
+static void test_parabola_bayes(void)
+{
+	printf("Test 14: parabola via Bayesian optimizer\n");
+
+	gsl_vector *xv = gsl_vector_alloc(1);
+	gsl_vector_set(xv, 0, 1.0);
+
+	gsl_vector *xmin = gsl_vector_alloc(1);
+	gsl_vector_set(xmin, 0, -10.0);
+	gsl_vector *xmax = gsl_vector_alloc(1);
+	gsl_vector_set(xmax, 0, 10.0);
+
+	simple_var_t vars[] =
+	{
+		{ .name = "x", .values = xv, .min = xmin, .max = xmax }
+	};
+
+	simple_config_t cfg;
+	simple_config_init(&cfg, OPT_BAYES);
+	cfg.vars = vars;
+	cfg.num_vars = 1;
+	cfg.max_iter = 25;
+	cfg.srand_seed = 7;
+	cfg.fit_func = fit_parabola;
+
+	simple_t *s = simple_new(&cfg);
+	gsl_vector_free(xv);
+	gsl_vector_free(xmin);
+	gsl_vector_free(xmax);
+
+	assert_true("simple_new succeeded", s != NULL);
+	if (!s)
+	{
+		return;
+	}
+
+	/* max_iter is the evaluation budget, far below PSO's 500 above */
+	double best = simple_optimize(s);
+	assert_near("fit value", best, -5.0, 0.1);
+
+	int nv;
+	const simple_var_t *result = simple_get_result(s, &nv);
+	assert_near("x position", gsl_vector_get(result[0].values, 0), -3.0, 0.35);
+
+	simple_free(s);
+}
+
+static void test_sphere_cmaes(void)
+{
+	printf("Test 15: sphere via CMA-ES with batch fitness\n");
+
+	gsl_vector *xv = gsl_vector_alloc(2);
+	gsl_vector *xmin = gsl_vector_alloc(2);
+	gsl_vector *xmax = gsl_vector_alloc(2);
+
+	gsl_vector_set_all(xv, 5.0);
+	gsl_vector_set_all(xmin, -10.0);
+	gsl_vector_set_all(xmax, 10.0);
+
+	simple_var_t vars[] =
+	{
+		{ .name = "x", .values = xv, .min = xmin, .max = xmax }
+	};
+
+	simple_config_t cfg;
+	simple_config_init(&cfg, OPT_CMAES);
+	cfg.vars = vars;
+	cfg.num_vars = 1;
+	cfg.max_iter = 200;
+	cfg.srand_seed = 11;
+	cfg.fit_func = fit_sphere;
+	cfg.fit_func_batch = fit_sphere_batch;
+
+	simple_t *s = simple_new(&cfg);
+	gsl_vector_free(xv);
+	gsl_vector_free(xmin);
+	gsl_vector_free(xmax);
+
+	assert_true("simple_new succeeded", s != NULL);
+	if (!s)
+	{
+		return;
+	}
+
+	/* One batch per generation */
+	batch_calls = 0;
+	double best = simple_optimize(s);
+	assert_true("generations use fit_func_batch", batch_calls > 0);
+	assert_near("fit value", best, 0.0, 1e-6);
+
+	int nv;
+	const simple_var_t *result = simple_get_result(s, &nv);
+	assert_near("x position", gsl_vector_get(result[0].values, 0), 0.0, 1e-3);
+	assert_near("y position", gsl_vector_get(result[0].values, 1), 0.0, 1e-3);
+
+	simple_free(s);
+}
+
+/**
+ * cache_tolerance_run - count cache hits of a simplex run on the parabola
+ * @tolerance: cache_tolerance to configure
+ *
+ * Returns the hit count, or -1 if simple_new rejected the config.
+ */
+static int cache_tolerance_run(double tolerance)
+{
+	gsl_vector *xv = gsl_vector_alloc(1);
+	gsl_vector_set(xv, 0, 10.0);
+
+	simple_var_t vars[] =
+	{
+		{ .name = "x", .values = xv }
+	};
+
+	simple_config_t cfg;
+	last_cache_hits = 0;
+
+	simple_config_init(&cfg, OPT_SIMPLEX);
+	cfg.vars = vars;
+	cfg.num_vars = 1;
+	cfg.max_iter = 200;
+	cfg.cache_tolerance = tolerance;
+	cfg.fit_func = fit_parabola;
+	cfg.log_func = cache_log;
+	cfg.opts.simplex.num_ssize = 1;
+	cfg.opts.simplex.ssize = (double[]){ 3.0 };
+
+	simple_t *s = simple_new(&cfg);
+	gsl_vector_free(xv);
+
+	if (!s)
+	{
+		return -1;
+	}
+
+	simple_optimize(s);
+	simple_free(s);
+
+	return last_cache_hits;
+}
+
+static void test_cache_tolerance(void)
+{
+	printf("Test 16: cache tolerance\n");
+
+	int exact = cache_tolerance_run(0.0);
+	int coarse = cache_tolerance_run(0.5);
+
+	/* Without rounding, only a quantized key lets the shrinking
+	 * simplex land on an earlier evaluation */
+	assert_true("exact run succeeded", exact >= 0);
+	assert_true("tolerance adds cache hits", coarse > exact);
+	assert_true("negative tolerance rejected", cache_tolerance_run(-1.0) == -1);
+}
+
 int main(void)
 {
 	printf("=== Simple Optimizer Test Suite ===\n\n");
@@ -769,6 +1037,14 @@ int main(void)
 	test_config_validation();
 	printf("\n");
 	test_set_vars_and_ssize();
+	printf("\n");
+	test_pso_batch();
+	printf("\n");
+	test_parabola_bayes();
+	printf("\n");
+	test_sphere_cmaes();
+	printf("\n");
+	test_cache_tolerance();
 
 	printf("\n=== Results: %d tests, %d failures ===\n",
 		test_count, test_failures);
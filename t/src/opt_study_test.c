@@ -0,0 +1,247 @@
+/*
+ * Parameter Study Tests
+ *
+ * Validates the study spec and its point design:
+ *   1. A grid runs through every combination, last var fastest
+ *   2. A Latin hypercube takes each stratum of each var once
+ *   3. Measurements and output take their defaults
+ *   4. Malformed specs are refused
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "opt_study.h"
+#include "optimizer_test_common.h"
+
+/**
+ * assert_true - check boolean condition
+ * @name: test description
+ * @cond: condition to verify
+ */
+static int assert_true(const char *name, int cond)
+{
+	test_count++;
+	if (cond)
+	{
+		printf("  PASS: %s\n", name);
+		return 1;
+	}
+
+	printf("  FAIL: %s\n", name);
+	test_failures++;
+	return 0;
+}
+
+/** Write a spec to path and load it */
+static opt_study_t *load_spec(const char *path, const char *text)
+{
+	FILE *fp = fopen(path, "w");
+
+	if (fp == NULL)
+	{
+		return NULL;
+	}
+	fputs(text, fp);
+	fclose(fp);
+
+	return opt_study_load(path);
+}
+
+static void test_grid(const char *path)
+{
+	printf("Test: grid design\n");
+
+	opt_study_t *s = load_spec(path,
+		"[study]\n"
+		"design=grid\n"
+		"\n"
+		"[var LEN]\n"
+		"min=1.0\n"
+		"max=2.0\n"
+		"levels=3\n"
+		"\n"
+		"[var GAP]\n"
+		"min=0.1\n"
+		"max=0.3\n");
+	double x[2];
+
+	if (!assert_true("grid loads", s != NULL))
+	{
+		return;
+	}
+
+	assert_near("vars", s->num_vars, 2, 0.5);
+	assert_near("points", s->num_points, 6, 0.5);
+	assert_near("default levels", s->vars[1].levels, 2, 0.5);
+
+	opt_study_point(s, 0, x);
+	assert_true("first point at min", x[0] == 1.0 && x[1] == 0.1);
+
+	opt_study_point(s, 1, x);
+	assert_true("last var runs fastest", x[0] == 1.0 && x[1] == 0.3);
+
+	opt_study_point(s, 2, x);
+	assert_near("middle level", x[0], 1.5, 1e-15);
+
+	opt_study_point(s, 5, x);
+	assert_true("last point at max", x[0] == 2.0 && x[1] == 0.3);
+
+	opt_study_free(s);
+
+	s = load_spec(path, "[var A]\nmin=4\nmax=9\nlevels=1\n");
+	assert_true("design defaults to grid", s && s->design == OPT_STUDY_GRID);
+	if (s != NULL)
+	{
+		opt_study_point(s, 0, x);
+		assert_near("single level is min", x[0], 4.0, 1e-15);
+		assert_near("single point", s->num_points, 1, 0.5);
+	}
+	opt_study_free(s);
+}
+
+static void test_lhs(const char *path)
+{
+	printf("Test: Latin hypercube design\n");
+
+	const char *spec =
+		"[study]\n"
+		"design=lhs\n"
+		"points=10\n"
+		"seed=7\n"
+		"\n"
+		"[var A]\n"
+		"min=-1\n"
+		"max=1\n"
+		"\n"
+		"[var B]\n"
+		"min=100\n"
+		"max=200\n";
+	opt_study_t *s = load_spec(path, spec);
+	opt_study_t *again;
+	int strata[2][10] = { { 0 } };
+	int once = 1;
+	int inside = 1;
+	int same = 1;
+	double x[2];
+	double y[2];
+
+	if (!assert_true("lhs loads", s != NULL))
+	{
+		return;
+	}
+
+	assert_near("points", s->num_points, 10, 0.5);
+
+	for (int k = 0; k < 10; k++)
+	{
+		opt_study_point(s, k, x);
+		inside &= x[0] >= -1 && x[0] <= 1 && x[1] >= 100 && x[1] <= 200;
+		strata[0][MIN((int)((x[0] + 1) / 2 * 10), 9)]++;
+		strata[1][MIN((int)((x[1] - 100) / 100 * 10), 9)]++;
+	}
+
+	for (int d = 0; d < 2; d++)
+	{
+		for (int i = 0; i < 10; i++)
+		{
+			once &= strata[d][i] == 1;
+		}
+	}
+
+	assert_true("points inside the ranges", inside);
+	assert_true("each stratum taken once", once);
+
+	again = load_spec(path, spec);
+	for (int k = 0; again && k < 10; k++)
+	{
+		opt_study_point(s, k, x);
+		opt_study_point(again, k, y);
+		same &= x[0] == y[0] && x[1] == y[1];
+	}
+	assert_true("same seed, same design", again && same);
+
+	opt_study_free(again);
+	opt_study_free(s);
+}
+
+static void test_defaults(const char *path)
+{
+	printf("Test: measurements and output\n");
+
+	char expect[256];
+	opt_study_t *s = load_spec(path, "[var A]\nmin=0\nmax=1\n");
+
+	snprintf(expect, sizeof(expect), "%s.csv", path);
+	assert_true("all measurements by default", s && s->measurements == NULL);
+	assert_true("output beside the spec", s && strcmp(s->output, expect) == 0);
+	assert_true("csv by default", s && !s->binary);
+	opt_study_free(s);
+
+	s = load_spec(path,
+		"[study]\n"
+		"measurements=mhz;vswr;gain_max\n"
+		"output=out.bin\n"
+		"[var A]\nmin=0\nmax=1\n");
+	assert_true("measurement list",
+		s && g_strv_length(s->measurements) == 3
+		&& strcmp(s->measurements[1], "vswr") == 0);
+	assert_true("binary by .bin", s && s->binary);
+	opt_study_free(s);
+}
+
+static void test_errors(const char *path)
+{
+	printf("Test: malformed specs\n");
+
+	assert_true("no vars",
+		load_spec(path, "[study]\ndesign=grid\n") == NULL);
+	assert_true("max below min",
+		load_spec(path, "[var A]\nmin=2\nmax=1\n") == NULL);
+	assert_true("missing max",
+		load_spec(path, "[var A]\nmin=2\n") == NULL);
+	assert_true("not a number",
+		load_spec(path, "[var A]\nmin=x\nmax=1\n") == NULL);
+	assert_true("zero levels",
+		load_spec(path, "[var A]\nmin=0\nmax=1\nlevels=0\n") == NULL);
+	assert_true("unknown design",
+		load_spec(path, "[study]\ndesign=sobol\n[var A]\nmin=0\nmax=1\n") == NULL);
+	assert_true("lhs without points",
+		load_spec(path, "[study]\ndesign=lhs\n[var A]\nmin=0\nmax=1\n") == NULL);
+	assert_true("grid too large",
+		load_spec(path,
+			"[var A]\nmin=0\nmax=1\nlevels=100000\n"
+			"[var B]\nmin=0\nmax=1\nlevels=100000\n") == NULL);
+	assert_true("missing file",
+		opt_study_load("/nonexistent/study.ini") == NULL);
+}
+
+int main(void)
+{
+	char path[] = "/tmp/opt_study_testXXXXXX";
+	int fd = mkstemp(path);
+
+	printf("=== Parameter Study Test Suite ===\n\n");
+
+	if (fd < 0)
+	{
+		printf("  FAIL: mkstemp\n");
+		return 1;
+	}
+	close(fd);
+
+	test_grid(path);
+	printf("\n");
+	test_lhs(path);
+	printf("\n");
+	test_defaults(path);
+	printf("\n");
+	test_errors(path);
+
+	remove(path);
+
+	printf("\n=== Results: %d tests, %d failures ===\n",
+		test_count, test_failures);
+
+	return test_failures > 0 ? 1 : 0;
+}
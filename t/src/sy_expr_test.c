@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <glib.h>
 
@@ -210,6 +211,99 @@ test_is_expression(void)
   printf("  PASS: All expression detection tests\n");
 }
 
+/* Test compiled expressions kept across symbol table reloads */
+static void
+test_compiled_reload(void)
+{
+  gdouble result;
+
+  printf("Testing compiled expressions across reloads...\n");
+
+  sy_init();
+  g_assert(sy_define("L", "2.0"));
+  g_assert(sy_evaluate("L*3+PI", &result));
+  assert_double_eq("first load", result, 6.0 + 3.14159265358979323846, 1e-9);
+
+  /* Same text, new table: the cached program reads the new definition */
+  sy_init();
+  g_assert(sy_define("L", "5.0"));
+  g_assert(sy_evaluate("L*3+PI", &result));
+  assert_double_eq("second load", result, 15.0 + 3.14159265358979323846, 1e-9);
+
+  sy_init();
+  g_assert(!sy_evaluate("L*3+PI", &result));
+  printf("  PASS: undefined after reload without L\n");
+
+  sy_cleanup();
+  g_assert(sy_evaluate("2*PI", &result));
+  assert_double_eq("constants without a table", result, 2.0 * 3.14159265358979323846, 1e-9);
+}
+
+/* Collect one symbol value through sy_foreach */
+static void
+find_value(const gchar *name, gdouble value, gboolean is_calculated,
+    const gchar *expression, gdouble min_value, gdouble max_value,
+    gdouble override_value, gboolean override_active, gboolean opt_active,
+    gpointer user_data)
+{
+  gdouble *want = (gdouble *)user_data;
+
+  if( strcmp(name, "WAVE") == 0 )
+    want[0] = value;
+  else if( strcmp(name, "HALF") == 0 )
+    want[1] = value;
+  else if( strcmp(name, "OTHER") == 0 )
+    want[2] = value;
+}
+
+/* Test dependency graph between symbols and fields */
+static void
+test_dependencies(void)
+{
+  gdouble values[3];
+  gdouble result;
+
+  printf("Testing symbol dependencies...\n");
+
+  sy_init();
+  g_assert(sy_define("F", "300"));
+  g_assert(sy_define("G", "7"));
+  g_assert(sy_define("WAVE", "300/F"));
+  g_assert(sy_define("HALF", "WAVE/2"));
+  g_assert(sy_define("OTHER", "G+1"));
+
+  g_assert(sy_depends("HALF*0.95", "F"));
+  g_assert(sy_depends("wave+1", "f"));
+  g_assert(sy_depends("HALF", "HALF"));
+  g_assert(!sy_depends("OTHER*2", "F"));
+  g_assert(!sy_depends("2*PI", "F"));
+  g_assert(!sy_depends("0.5", "F"));
+  g_assert(!sy_depends("(HALF", "F"));
+  printf("  PASS: field dependencies\n");
+
+  /* Overriding F re-evaluates WAVE and HALF only */
+  g_assert(sy_set_override("F", 150.0, TRUE));
+  sy_foreach(find_value, values);
+  assert_double_eq("WAVE follows F", values[0], 2.0, 1e-12);
+  assert_double_eq("HALF follows WAVE", values[1], 1.0, 1e-12);
+  assert_double_eq("OTHER untouched", values[2], 8.0, 1e-12);
+
+  g_assert(sy_evaluate("HALF*4", &result));
+  assert_double_eq("field sees the change", result, 4.0, 1e-12);
+
+  g_assert(sy_set_override("F", 150.0, FALSE));
+  sy_foreach(find_value, values);
+  assert_double_eq("HALF restored", values[1], 0.5, 1e-12);
+
+  /* A reload drops the edges with the definitions */
+  sy_init();
+  g_assert(sy_define("F", "300"));
+  g_assert(!sy_depends("HALF", "F"));
+  printf("  PASS: edges dropped on reload\n");
+
+  sy_release();
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -223,6 +317,8 @@ main(int argc, char *argv[])
   test_constants();
   test_symbols();
   test_is_expression();
+  test_compiled_reload();
+  test_dependencies();
 
   printf("\n=== Test Summary ===\n");
   if( test_failures == 0 )
@@ -1,7 +1,8 @@
 /*
  * SY Card Integration Test
  * Loads fixture files through actual xnec2c parsing functions
- * Verifies SY card support works end-to-end
+ * Verifies SY card support works end-to-end, and the reuse of parsed
+ * geometry and of factored matrices across re-parses
  */
 
 #include <stdio.h>
@@ -12,12 +13,15 @@
 #include <limits.h>
 #include <locale.h>
 #include <errno.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <sys/resource.h>
 
 #include "common.h"
 #include "shared.h"
 #include "sy_expr.h"
+#include "prerender/prerender_state.h"
+#include "mathlib.h"
 
 static const double TOLERANCE = 1e-6;
 
@@ -214,6 +218,448 @@ test_fixture(const fixture_expectation_t *exp)
   return ok;
 }
 
+/* Parse a fixture with .sy override text staged in memory */
+static gboolean
+parse_with_overrides(const char *filename, const char *sy_text)
+{
+  char full_path[PATH_MAX];
+  gboolean ok;
+
+  snprintf(full_path, sizeof(full_path), "%s/%s", fixture_base, filename);
+  Open_File(&input_fp, full_path, "r");
+  if( input_fp == NULL )
+    return FALSE;
+
+  Set_Input_Overrides(sy_text);
+  ok = Read_Comments() && Read_Geometry() && Read_Commands();
+  Set_Input_Overrides(NULL);
+  Close_File(&input_fp);
+
+  return ok;
+}
+
+/* Check that a re-parse keeps the geometry of the last parse while no
+ * geometry card reads a changed symbol, and rebuilds it once one does.
+ * A marker written into an end point, which no sweep scales, shows
+ * whether the segments were rebuilt. */
+static void
+test_geometry_reuse(void)
+{
+  const double marker = 123.0;
+  double x1;
+  int fail_count = 0;
+
+  printf("Testing: geometry reuse across re-parses\n");
+
+  if( !parse_with_overrides("sy_separate_cards.nec", NULL) )
+  {
+    printf("  FAIL: Parse error\n");
+    test_failures++;
+    return;
+  }
+
+  data.segments[0].x1 = marker;
+  if( !parse_with_overrides("sy_separate_cards.nec", NULL) ||
+      data.segments[0].x1 != marker )
+  {
+    printf("  FAIL: unchanged deck rebuilt its geometry\n");
+    fail_count++;
+  }
+
+  if( !parse_with_overrides("sy_separate_cards.nec",
+        "A: min_value=0 max_value=10 override_value=2 override_active=1\n") ||
+      data.segments[0].x1 == marker ||
+      fabs(data.segments[data.n - 1].z2 - 5.0) > TOLERANCE )
+  {
+    printf("  FAIL: override of a geometry symbol did not rebuild\n");
+    fail_count++;
+  }
+
+  if( !parse_with_overrides("sy_math_cmnd.nec", NULL) )
+  {
+    printf("  FAIL: Parse error\n");
+    test_failures++;
+    return;
+  }
+
+  x1 = data.segments[0].x1;
+  data.segments[0].x1 = marker;
+  if( !parse_with_overrides("sy_math_cmnd.nec",
+        "N_STEPS: min_value=1 max_value=20 override_value=5 override_active=1\n") ||
+      data.segments[0].x1 != marker )
+  {
+    printf("  FAIL: override of a command symbol rebuilt the geometry\n");
+    fail_count++;
+  }
+
+  /* Later parses of this deck may reuse the geometry */
+  data.segments[0].x1 = x1;
+
+  if( fail_count > 0 )
+    test_failures += fail_count;
+  else
+    printf("  PASS: Geometry reused and rebuilt as expected\n");
+}
+
+/* Scale the segments to wavelengths at freq_mhz as Frequency_Scale_Geometry()
+ * does for an in-process step, packed tables included */
+static void
+scale_geometry(double freq_mhz)
+{
+  double fr = freq_mhz / CVEL;
+  int idx;
+
+  calc_data.freq_mhz = freq_mhz;
+  data.wlam = CVEL / freq_mhz;
+
+  for( idx = 0; idx < data.n; idx++ )
+  {
+    wire_segment_t *sg = &data.segments[idx];
+
+    sg->x  = save.xtemp[idx] * fr;
+    sg->y  = save.ytemp[idx] * fr;
+    sg->z  = save.ztemp[idx] * fr;
+    sg->si = save.sitemp[idx] * fr;
+    sg->bi = save.bitemp[idx] * fr;
+  }
+
+  geometry_pack_segments();
+}
+
+/* Check that a re-parse after an in-process sweep, which leaves the
+ * segments scaled to wavelengths, reuses the geometry in metres: the
+ * excitation center and the segment data read as after the first parse */
+static void
+test_reuse_after_sweep(void)
+{
+  double cx, cy, cz, z, bi;
+  int fail_count = 0;
+
+  printf("Testing: geometry reuse after an in-process sweep\n");
+
+  if( !parse_with_overrides("excitation_offset.nec", NULL) )
+  {
+    printf("  FAIL: Parse error\n");
+    test_failures++;
+    return;
+  }
+
+  cx = geom_pre.excitation_cx;
+  cy = geom_pre.excitation_cy;
+  cz = geom_pre.excitation_cz;
+  z  = data.segments[5].z;
+  bi = data.segments[0].bi;
+  if( fabs(cx - 2.0) > TOLERANCE || fabs(cy) > TOLERANCE ||
+      fabs(cz - 3.5) > TOLERANCE )
+  {
+    printf("  FAIL: excitation center (%.9f, %.9f, %.9f), expected (2, 0, 3.5)\n",
+        cx, cy, cz);
+    fail_count++;
+  }
+
+  /* As a step at 14 MHz leaves them */
+  scale_geometry(14.0);
+
+  if( !parse_with_overrides("excitation_offset.nec", NULL) )
+  {
+    printf("  FAIL: Parse error\n");
+    test_failures++;
+    return;
+  }
+
+  if( fabs(geom_pre.excitation_cx - cx) > TOLERANCE ||
+      fabs(geom_pre.excitation_cy - cy) > TOLERANCE ||
+      fabs(geom_pre.excitation_cz - cz) > TOLERANCE )
+  {
+    printf("  FAIL: excitation center (%.9f, %.9f, %.9f) after reuse, expected (%.9f, %.9f, %.9f)\n",
+        geom_pre.excitation_cx, geom_pre.excitation_cy,
+        geom_pre.excitation_cz, cx, cy, cz);
+    fail_count++;
+  }
+
+  if( data.segments[5].z != z || data.segments[0].bi != bi )
+  {
+    printf("  FAIL: reused segments not restored to metres\n");
+    fail_count++;
+  }
+
+  if( fail_count > 0 )
+    test_failures += fail_count;
+  else
+    printf("  PASS: Reused geometry read in metres\n");
+}
+
+/* Solve the parsed deck at one frequency as New_Frequency() does, through
+ * the kept factors when lu_update_restore() takes them.  Returns the
+ * segment currents in cur, data.np3m long, and the feed impedance. */
+static gboolean
+solve_step(double freq_mhz, complex double *cur, complex double *zin)
+{
+  gboolean restored;
+
+  scale_geometry(freq_mhz);
+  if( zload.nload != 0 )
+    load(calc_data.ldtyp, calc_data.ldtag, calc_data.ldtagf,
+        calc_data.ldtagt, calc_data.zlr, calc_data.zli, calc_data.zlc);
+
+  /* Set_Interaction_Matrix() */
+  smat.nop = netcx.neq / netcx.npeq;
+  mem_array_realloc(&smat.ssx, smat.nop * smat.nop);
+  if( matpar.imat == 0 )
+    fblock(netcx.npeq, netcx.neq, data.np2m * (data.np + 2 * data.mp),
+        data.ipsym);
+  netcx.ntsol = 0;
+
+  restored = lu_update_restore();
+  if( !restored )
+  {
+    cmset(netcx.neq, cm, calc_data.rkh, calc_data.iexk);
+    factrs(netcx.npeq, netcx.neq, cm, save.ip);
+    lu_update_keep();
+  }
+
+  etmns(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, fpat.ixtyp, cur);
+  netwk(cm, save.ip, cur);
+  *zin = netcx.zped_port[0];
+
+  mem_arena_reset();
+
+  return( restored );
+}
+
+/* Largest difference of a and b relative to the largest magnitude in a */
+static double
+max_rel_diff(const complex double *a, const complex double *b, int n)
+{
+  double diff = 0.0, scale = 0.0;
+  int i;
+
+  for( i = 0; i < n; i++ )
+  {
+    diff  = fmax(diff, cabs(a[i] - b[i]));
+    scale = fmax(scale, cabs(a[i]));
+  }
+
+  return( scale > 0.0 ? diff / scale : diff );
+}
+
+/* Check the low-rank update of kept factors against a full refill: after
+ * the loads of four segments change, the currents and the feed impedance
+ * it gives must match those of a fresh fill and factorization.  The load
+ * term cmset() adds and the rows lu_update_correct() builds index the
+ * transposed matrix storage the same way only if these agree. */
+static void
+test_lu_update(void)
+{
+  static const char *loads =
+    "R: min_value=0 max_value=100 override_value=40 override_active=1\n"
+    "X: min_value=-500 max_value=500 override_value=-120 override_active=1\n";
+  const double freq = 14.2;
+  complex double *cur_ref = NULL, *cur_upd = NULL, z_ref, z_upd;
+  double dcur, dz;
+  int fail_count = 0;
+
+  printf("Testing: low-rank LU update against a full refill\n");
+
+  rc_config.lu_update = 1;
+  lu_update_free();
+
+  /* Two full solves of the base loads: the second keeps its factors */
+  if( !parse_with_overrides("lu_update_loads.nec", NULL) )
+  {
+    printf("  FAIL: Parse error\n");
+    test_failures++;
+    rc_config.lu_update = 0;
+    return;
+  }
+  mem_array_alloc(&cur_ref, data.np3m);
+  mem_array_alloc(&cur_upd, data.np3m);
+
+  /* cabc() leaves the interpolation coefficients in the step's slot */
+  calc_data.freq_step = 0;
+  mem_array_alloc(&crnt_fstep, 1);
+  mem_array_alloc(&crnt_fstep[0].air, data.npm);
+  mem_array_alloc(&crnt_fstep[0].aii, data.npm);
+  mem_array_alloc(&crnt_fstep[0].bir, data.npm);
+  mem_array_alloc(&crnt_fstep[0].bii, data.npm);
+  mem_array_alloc(&crnt_fstep[0].cir, data.npm);
+  mem_array_alloc(&crnt_fstep[0].cii, data.npm);
+
+  if( solve_step(freq, cur_upd, &z_upd) || solve_step(freq, cur_upd, &z_upd) )
+  {
+    printf("  FAIL: base loads solved through kept factors\n");
+    fail_count++;
+  }
+
+  /* Reference: the changed loads filled and factored in full */
+  rc_config.lu_update = 0;
+  if( !parse_with_overrides("lu_update_loads.nec", loads) ||
+      solve_step(freq, cur_ref, &z_ref) )
+  {
+    printf("  FAIL: reference solve\n");
+    fail_count++;
+  }
+
+  /* The same loads through the base factors and a rank-4 correction */
+  rc_config.lu_update = 1;
+  if( !parse_with_overrides("lu_update_loads.nec", loads) ||
+      !solve_step(freq, cur_upd, &z_upd) )
+  {
+    printf("  FAIL: changed loads not solved through the kept factors\n");
+    fail_count++;
+  }
+
+  dcur = max_rel_diff(cur_ref, cur_upd, netcx.neq);
+  dz = cabs(z_upd - z_ref) / cabs(z_ref);
+  if( !(dcur < 1e-9) || !(dz < 1e-9) )
+  {
+    printf("  FAIL: update differs from refill: currents %.3e, impedance %.3e "
+        "(%.9f%+.9fj against %.9f%+.9fj)\n", dcur, dz,
+        creal(z_upd), cimag(z_upd), creal(z_ref), cimag(z_ref));
+    fail_count++;
+  }
+
+  mem_array_free(&crnt_fstep[0].air);
+  mem_array_free(&crnt_fstep[0].aii);
+  mem_array_free(&crnt_fstep[0].bir);
+  mem_array_free(&crnt_fstep[0].bii);
+  mem_array_free(&crnt_fstep[0].cir);
+  mem_array_free(&crnt_fstep[0].cii);
+  mem_array_free(&crnt_fstep);
+  mem_array_free(&cur_ref);
+  mem_array_free(&cur_upd);
+  lu_update_free();
+  rc_config.lu_update = 0;
+
+  if( fail_count > 0 )
+    test_failures += fail_count;
+  else
+    printf("  PASS: Update matches the refill (currents %.1e, impedance %.1e)\n",
+        dcur, dz);
+}
+
+/* Parse a deck copied to path as a cold load: the geometry of the last
+ * parse is forgotten first, so only the model cache can skip the parse */
+static gboolean
+parse_cold(const char *path, const char *sy_text)
+{
+  gboolean ok;
+
+  input_data_free();
+  Open_File(&input_fp, (char *)path, "r");
+  if( input_fp == NULL )
+    return FALSE;
+
+  Set_Input_Overrides(sy_text);
+  ok = Read_Comments() && Read_Geometry() && Read_Commands();
+  Set_Input_Overrides(NULL);
+  Close_File(&input_fp);
+
+  return ok;
+}
+
+/* Inode of the cache file, 0 when there is none; a rewrite renames a new
+ * file over it */
+static ino_t
+cache_inode(const char *path)
+{
+  struct stat st;
+
+  return( stat(path, &st) == 0 ? st.st_ino : 0 );
+}
+
+/* Check that a cold load writes the binary model cache, that the next one
+ * loads the same geometry from it without rewriting it, and that a changed
+ * symbol value or a damaged file falls back to the full parse */
+static void
+test_model_cache(void)
+{
+  char dir[] = "/tmp/xnec2c_model_cacheXXXXXX";
+  char src[PATH_MAX], bin[PATH_MAX], cmd[3 * PATH_MAX];
+  double z2, bi;
+  int n, fail_count = 0;
+  ino_t ino;
+  FILE *fp;
+
+  printf("Testing: binary model cache\n");
+
+  if( mkdtemp(dir) == NULL )
+  {
+    printf("  FAIL: mkdtemp: %s\n", strerror(errno));
+    test_failures++;
+    return;
+  }
+
+  snprintf(src, sizeof(src), "%s/sy_separate_cards.nec", fixture_base);
+  snprintf(rc_config.input_file, sizeof(rc_config.input_file),
+      "%s/model.nec", dir);
+  snprintf(bin, sizeof(bin), "%s.bin", rc_config.input_file);
+  snprintf(cmd, sizeof(cmd), "cp '%s' '%s'", src, rc_config.input_file);
+  rc_config.model_cache = 1;
+
+  if( system(cmd) != 0 || !parse_cold(rc_config.input_file, NULL) )
+  {
+    printf("  FAIL: Parse error\n");
+    fail_count++;
+    goto out;
+  }
+
+  ino = cache_inode(bin);
+  n = data.n;
+  z2 = data.segments[n - 1].z2;
+  bi = data.segments[0].bi;
+  if( ino == 0 )
+  {
+    printf("  FAIL: no cache written beside the deck\n");
+    fail_count++;
+    goto out;
+  }
+
+  if( !parse_cold(rc_config.input_file, NULL) || cache_inode(bin) != ino ||
+      data.n != n || data.segments[n - 1].z2 != z2 ||
+      data.segments[0].bi != bi || data.npm != data.n + data.m )
+  {
+    printf("  FAIL: matching cache not loaded as written\n");
+    fail_count++;
+  }
+
+  if( !parse_cold(rc_config.input_file,
+        "A: min_value=0 max_value=10 override_value=2 override_active=1\n") ||
+      cache_inode(bin) == ino ||
+      fabs(data.segments[data.n - 1].z2 - 5.0) > TOLERANCE )
+  {
+    printf("  FAIL: override of a geometry symbol loaded a stale cache\n");
+    fail_count++;
+  }
+
+  /* Cut the file short: it must miss and be rewritten whole */
+  fp = fopen(bin, "r+");
+  if( fp == NULL || ftruncate(fileno(fp), 64) != 0 )
+    fail_count++;
+  if( fp != NULL )
+    fclose(fp);
+  ino = cache_inode(bin);
+  if( !parse_cold(rc_config.input_file, NULL) || cache_inode(bin) == ino ||
+      data.n != n || data.segments[n - 1].z2 != z2 )
+  {
+    printf("  FAIL: damaged cache not replaced by a full parse\n");
+    fail_count++;
+  }
+
+out:
+  rc_config.model_cache = 0;
+  rc_config.input_file[0] = '\0';
+  remove(bin);
+  snprintf(src, sizeof(src), "%s/model.nec", dir);
+  remove(src);
+  rmdir(dir);
+
+  if( fail_count > 0 )
+    test_failures += fail_count;
+  else
+    printf("  PASS: Cache written, loaded and refreshed as expected\n");
+}
+
 /* Cap the calling process address space at its current footprint plus a
  * fixed margin. A regression of the locale decimal-point bug appends to a
  * GArray without bound; this limit makes the allocator fail and the child
@@ -385,11 +831,19 @@ main(int argc, char *argv[])
     return 1;
   }
 
+  /* The solver checks factor through the selected library */
+  init_mathlib();
+
   for( i = 0; expectations[i].filename != NULL; i++ )
   {
     test_fixture(&expectations[i]);
   }
 
+  test_geometry_reuse();
+  test_reuse_after_sweep();
+  test_lu_update();
+  test_model_cache();
+
   printf("\n--- DE locale (memory-bounded) ---\n");
   if( !run_bounded(de_locale_body) )
     test_failures++;
@@ -13,6 +13,10 @@
  *  the power the feedpoint accepts, which is the available power reduced
  *  by the mismatch factor 1 - |S11|^2.
  *
+ *  The reader half checks .s2p parsing (option line, formats, wrapped rows,
+ *  trailing noise data) and that a loaded network moves the measured
+ *  feedpoint as the two-port cascade formulas predict.
+ *
  *  Copyright (C) 2026 eWheeler, Inc. <https://www.linuxglobal.com/>
  */
 
@@ -430,6 +434,187 @@ static void test_impedance_gate(void)
 
 /*------------------------------------------------------------------------*/
 
+/**
+ * write_network() - write a Touchstone file for the reader tests
+ * @suffix: file extension, which tells a version 1 reader the port count
+ * @text:   file contents
+ *
+ * Returns the path of the file, which the caller removes and frees.
+ */
+static char *write_network(const char *suffix, const char *text)
+{
+	char *path = NULL;
+	FILE *fp;
+	int fd;
+
+	if (asprintf(&path, "/tmp/touchstone_test_XXXXXX%s", suffix) < 0)
+		return NULL;
+
+	fd = mkstemps(path, (int)strlen(suffix));
+	if (fd < 0 || (fp = fdopen(fd, "w")) == NULL)
+	{
+		free(path);
+		return NULL;
+	}
+
+	fputs(text, fp);
+	fclose(fp);
+
+	return path;
+}
+
+/**
+ * test_network_read() - option line, formats, continuation and noise data
+ *
+ * A version 1 two-port row is the frequency and S11, S21, S12, S22 as
+ * pairs in the format of the option line; a row may wrap, and a frequency
+ * not above the last starts the noise parameters, which are skipped.
+ */
+static void test_network_read(void)
+{
+	touchstone_network_t net;
+	char *path;
+
+	path = write_network(".s2p",
+		"! thru and a 6 dB pad\n"
+		"# MHz S RI R 75\n"
+		"100  0 0  1 0  1 0  0 0\n"
+		"200  0.1 -0.2  0.5 0\n"
+		"     0.5 0  0 0.3   ! wrapped row\n"
+		"50   1.5 0.5 0 1 2\n");
+	ASSERT_TRUE(path != NULL, "network file written");
+	if (path == NULL)
+		return;
+
+	ASSERT_TRUE(touchstone_read(path, &net), "RI two-port reads");
+	ASSERT_TRUE(net.count == 2, "noise parameters are skipped");
+	ASSERT_NEAR(net.z0, 75.0, 0.0, "reference resistance");
+	ASSERT_NEAR(net.hz[1], 200e6, 0.0, "MHz frequency unit");
+	ASSERT_NEAR(creal(net.s[TS_NPARAM + TS_S11]), 0.1, 0.0, "wrapped row S11 real");
+	ASSERT_NEAR(cimag(net.s[TS_NPARAM + TS_S11]), -0.2, 0.0, "wrapped row S11 imag");
+	ASSERT_NEAR(cimag(net.s[TS_NPARAM + TS_S22]), 0.3, 0.0, "wrapped row S22");
+
+	{
+		complex double s[TS_NPARAM];
+
+		ASSERT_TRUE(touchstone_interp(&net, 150e6, s), "inside the points");
+		ASSERT_NEAR(creal(s[TS_S21]), 0.75, TOL, "S21 interpolated");
+		ASSERT_NEAR(cimag(s[TS_S11]), -0.1, TOL, "S11 interpolated");
+		ASSERT_TRUE(!touchstone_interp(&net, 99e6, s), "below the points");
+		ASSERT_TRUE(!touchstone_interp(&net, 201e6, s), "above the points");
+	}
+
+	touchstone_network_free(&net);
+	remove(path);
+	free(path);
+
+	/* dB and degrees, default GHz */
+	path = write_network(".S2P",
+		"# S DB\n"
+		"1.5  -6.0205999566 90  -3.0102999566 180  -3.0102999566 180  -100 0\n");
+	ASSERT_TRUE(path != NULL && touchstone_read(path, &net), "DB two-port reads");
+	if (path != NULL && net.count == 1)
+	{
+		ASSERT_NEAR(net.hz[0], 1.5e9, 0.0, "GHz is the default unit");
+		ASSERT_NEAR(net.z0, 50.0, 0.0, "50 ohms is the default reference");
+		ASSERT_NEAR(cimag(net.s[TS_S11]), 0.5, 1e-6, "dB magnitude, degrees");
+		ASSERT_NEAR(creal(net.s[TS_S21]), -M_SQRT1_2, 1e-6, "S21 at 180 degrees");
+		touchstone_network_free(&net);
+	}
+	if (path != NULL)
+	{
+		remove(path);
+		free(path);
+	}
+
+	/* A one-port is no network */
+	path = write_network(".s1p", "# MHz S RI\n100 0 0\n");
+	ASSERT_TRUE(path != NULL && !touchstone_read(path, &net), "one-port refused");
+	if (path != NULL)
+	{
+		remove(path);
+		free(path);
+	}
+}
+
+/**
+ * test_network_cascade() - the network moves the measured feedpoint
+ *
+ * A lossless quarter-wave line of the reference impedance (S21 = S12 = -j,
+ * S11 = S22 = 0) inverts the load about Z0: Zin = Z0^2 / Z, with |Gamma|
+ * and so VSWR unchanged and no loss in the net gain.  A matched 3 dB pad
+ * halves the reflection and the delivered power.  De-embedding the line
+ * recovers the feedpoint it moved, and steps outside the network's
+ * frequencies carry no impedance.
+ */
+static void test_network_cascade(void)
+{
+	const touchstone_case_t *tc = &cases[3];
+	double complex z = tc->zreal + I * tc->zimag;
+	double complex zin = 50.0 * 50.0 / z;
+	double complex g = (z - 50.0) / (z + 50.0);
+	measurement_t bare, m;
+	char *path;
+
+	setup_globals(tc);
+	meas_calc(&bare, 0, calc_data.ex_port);
+
+	path = write_network(".s2p",
+		"# MHz S RI R 50\n"
+		"100  0 0  0 -1  0 -1  0 0\n"
+		"200  0 0  0 -1  0 -1  0 0\n");
+	ASSERT_TRUE(path != NULL && touchstone_network_load(path), "quarter-wave line loads");
+
+	meas_calc(&m, 0, calc_data.ex_port);
+	ASSERT_NEAR(m.zreal, creal(zin), TOL, "line inverts the load, real");
+	ASSERT_NEAR(m.zimag, cimag(zin), TOL, "line inverts the load, imag");
+	ASSERT_NEAR(m.vswr, bare.vswr, TOL, "lossless line keeps the VSWR");
+	ASSERT_NEAR(m.gain_net, bare.gain_net, TOL, "lossless line keeps the net gain");
+
+	rc_config.network_deembed = 1;
+	impedance_data[0].zreal[0] = creal(zin);
+	impedance_data[0].zimag[0] = cimag(zin);
+	meas_calc(&m, 0, calc_data.ex_port);
+	ASSERT_NEAR(m.zreal, creal(z), TOL, "de-embedding recovers the load, real");
+	ASSERT_NEAR(m.zimag, cimag(z), TOL, "de-embedding recovers the load, imag");
+	rc_config.network_deembed = 0;
+	setup_globals(tc);
+
+	if (path != NULL)
+	{
+		remove(path);
+		free(path);
+	}
+
+	path = write_network(".s2p",
+		"# MHz S RI R 50\n"
+		"100  0 0  0.70710678118654752 0  0.70710678118654752 0  0 0\n"
+		"200  0 0  0.70710678118654752 0  0.70710678118654752 0  0 0\n");
+	ASSERT_TRUE(path != NULL && touchstone_network_load(path), "3 dB pad replaces the line");
+
+	meas_calc(&m, 0, calc_data.ex_port);
+	ASSERT_NEAR(m.s11, 20.0 * log10(0.5 * cabs(g)), TOL, "pad halves the reflection");
+	ASSERT_NEAR(m.gain_net, m.gain_max + 10.0 * log10(0.5 * (1.0 - cabs(g) * cabs(g))),
+		TOL, "net gain includes the pad loss and the feedpoint mismatch");
+
+	save.freq[0] = 300.0;
+	meas_calc(&m, 0, calc_data.ex_port);
+	ASSERT_TRUE(m.zreal == -1 && m.vswr == -1, "step outside the network has no impedance");
+	save.freq[0] = TEST_MHZ;
+
+	ASSERT_TRUE(touchstone_network_load(NULL), "network removed");
+	meas_calc(&m, 0, calc_data.ex_port);
+	ASSERT_NEAR(m.zreal, bare.zreal, 0.0, "removal restores the feedpoint");
+
+	if (path != NULL)
+	{
+		remove(path);
+		free(path);
+	}
+}
+
+/*------------------------------------------------------------------------*/
+
 int main(int argc, char *argv[])
 {
 	unsigned i;
@@ -439,6 +624,8 @@ int main(int argc, char *argv[])
 
 	test_layout_table();
 	test_impedance_gate();
+	test_network_read();
+	test_network_cascade();
 
 	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
 	{